@@ -0,0 +1,271 @@
+/*==============================================================================
+
+  Program: 3D Cjyx
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Cjyx includes
+#include "vtkCjyxApplicationLogic.h"
+#include "vtkCjyxTask.h"
+#include "vtkDMMLCoreTestingMacros.h"
+
+// DMML includes
+#include <vtkDMMLAbstractLogic.h>
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+struct TaskData
+{
+  int Id = 0;
+  std::atomic<int>* NumberOfCompletedTasks = nullptr;
+  // if set then the task does not return until the flag is set
+  std::atomic<bool>* Release = nullptr;
+  std::atomic<bool> Started{ false };
+  // IDs of tasks in the order they were executed
+  std::vector<int>* ExecutionOrder = nullptr;
+  std::mutex* ExecutionOrderMutex = nullptr;
+};
+
+//----------------------------------------------------------------------------
+class vtkTaskTestLogic : public vtkDMMLAbstractLogic
+{
+public:
+  static vtkTaskTestLogic* New();
+  vtkTypeMacro(vtkTaskTestLogic, vtkDMMLAbstractLogic);
+
+  void RunTask(void* clientData)
+  {
+    TaskData* data = reinterpret_cast<TaskData*>(clientData);
+    data->Started = true;
+    if (data->Release)
+      {
+      while (!(*data->Release))
+        {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+      }
+    else
+      {
+      // some work
+      volatile double sum = 0.0;
+      for (int i = 0; i < 100000; ++i)
+        {
+        sum = sum + i * 0.5;
+        }
+      }
+    if (data->ExecutionOrder)
+      {
+      std::lock_guard<std::mutex> lock(*data->ExecutionOrderMutex);
+      data->ExecutionOrder->push_back(data->Id);
+      }
+    if (data->NumberOfCompletedTasks)
+      {
+      (*data->NumberOfCompletedTasks)++;
+      }
+  }
+
+protected:
+  vtkTaskTestLogic() = default;
+  ~vtkTaskTestLogic() override = default;
+};
+vtkStandardNewMacro(vtkTaskTestLogic);
+
+//----------------------------------------------------------------------------
+bool ScheduleTestTask(vtkCjyxApplicationLogic* appLogic, vtkTaskTestLogic* logic, TaskData* data,
+  int type = vtkCjyxTask::Processing, int priority = 0, vtkSmartPointer<vtkCjyxTask>* scheduledTask = nullptr)
+{
+  vtkNew<vtkCjyxTask> task;
+  task->SetTaskFunction(logic, static_cast<vtkCjyxTask::TaskFunctionPointer>(&vtkTaskTestLogic::RunTask), data);
+  task->SetType(type);
+  task->SetPriority(priority);
+  if (scheduledTask)
+    {
+    *scheduledTask = task.GetPointer();
+    }
+  return appLogic->ScheduleTask(task);
+}
+
+//----------------------------------------------------------------------------
+// Releases blocked tasks and waits for the worker threads to finish when the test returns,
+// even if a check fails. Must be declared after all the task data that the tasks access.
+struct TaskReleaseGuard
+{
+  TaskReleaseGuard(vtkCjyxApplicationLogic* appLogic, std::initializer_list<std::atomic<bool>*> releaseFlags)
+    : AppLogic(appLogic)
+    , ReleaseFlags(releaseFlags)
+  {
+  }
+  ~TaskReleaseGuard()
+  {
+    for (std::atomic<bool>* releaseFlag : this->ReleaseFlags)
+      {
+      *releaseFlag = true;
+      }
+    this->AppLogic->TerminateProcessingThread();
+  }
+  vtkCjyxApplicationLogic* AppLogic;
+  std::vector<std::atomic<bool>*> ReleaseFlags;
+};
+
+//----------------------------------------------------------------------------
+bool WaitFor(std::function<bool()> condition, double timeoutSec = 30.0)
+{
+  double startTime = vtkTimerLog::GetUniversalTime();
+  while (!condition())
+    {
+    if (vtkTimerLog::GetUniversalTime() - startTime > timeoutSec)
+      {
+      return false;
+      }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int TestConcurrentTasks()
+{
+  const int numberOfTasks = 500;
+
+  vtkNew<vtkCjyxApplicationLogic> appLogic;
+  vtkNew<vtkTaskTestLogic> logic;
+  appLogic->SetNumberOfProcessingThreads(4);
+  appLogic->CreateProcessingThread();
+
+  std::atomic<bool> release(false);
+  std::atomic<bool> releaseAll(false);
+  std::atomic<int> numberOfCompletedTasks(0);
+  TaskData blockingTaskData;
+  std::vector<TaskData> tasksData(numberOfTasks);
+  std::vector<TaskData> busyTasksData(appLogic->GetNumberOfProcessingThreads());
+  TaskData networkingTaskData;
+  TaskReleaseGuard releaseGuard(appLogic, { &release, &releaseAll });
+
+  // A long-running task must not block the other tasks
+  blockingTaskData.Release = &release;
+  CHECK_BOOL(ScheduleTestTask(appLogic, logic, &blockingTaskData), true);
+  CHECK_BOOL(WaitFor([&] { return blockingTaskData.Started.load(); }), true);
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  for (int i = 0; i < numberOfTasks; ++i)
+    {
+    tasksData[i].Id = i;
+    tasksData[i].NumberOfCompletedTasks = &numberOfCompletedTasks;
+    CHECK_BOOL(ScheduleTestTask(appLogic, logic, &tasksData[i]), true);
+    }
+  CHECK_BOOL(WaitFor([&] { return numberOfCompletedTasks == numberOfTasks; }), true);
+  timer->StopTimer();
+  std::cout << numberOfTasks << " tasks completed in " << timer->GetElapsedTime() << "s using "
+    << appLogic->GetNumberOfProcessingThreads() << " threads ("
+    << numberOfTasks / timer->GetElapsedTime() << " tasks/s)" << std::endl;
+  CHECK_INT(static_cast<int>(appLogic->GetNumberOfQueuedTasks()), 0);
+
+  // Networking tasks are executed while all processing threads are busy
+  for (TaskData& busyTaskData : busyTasksData)
+    {
+    busyTaskData.Release = &releaseAll;
+    CHECK_BOOL(ScheduleTestTask(appLogic, logic, &busyTaskData), true);
+    }
+  networkingTaskData.NumberOfCompletedTasks = &numberOfCompletedTasks;
+  CHECK_BOOL(ScheduleTestTask(appLogic, logic, &networkingTaskData, vtkCjyxTask::Networking), true);
+  CHECK_BOOL(WaitFor([&] { return numberOfCompletedTasks == numberOfTasks + 1; }), true);
+
+  release = true;
+  releaseAll = true;
+  appLogic->TerminateProcessingThread();
+
+  // Tasks cannot be scheduled after the threads are terminated
+  TaskData lateTaskData;
+  CHECK_BOOL(ScheduleTestTask(appLogic, logic, &lateTaskData), false);
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestTaskPriorityAndCancel()
+{
+  vtkNew<vtkCjyxApplicationLogic> appLogic;
+  vtkNew<vtkTaskTestLogic> logic;
+  appLogic->SetNumberOfProcessingThreads(1);
+  appLogic->CreateProcessingThread();
+
+  std::atomic<bool> release(false);
+  std::atomic<int> numberOfCompletedTasks(0);
+  std::vector<int> executionOrder;
+  std::mutex executionOrderMutex;
+  TaskData blockingTaskData;
+  std::vector<TaskData> tasksData(11);
+  TaskReleaseGuard releaseGuard(appLogic, { &release });
+
+  // Keep the only processing thread busy while the tasks are scheduled
+  blockingTaskData.Release = &release;
+  CHECK_BOOL(ScheduleTestTask(appLogic, logic, &blockingTaskData), true);
+  CHECK_BOOL(WaitFor([&] { return blockingTaskData.Started.load(); }), true);
+
+  // Tasks 0-4: low priority, tasks 5-9: high priority, task 10: canceled
+  for (int i = 0; i < 11; ++i)
+    {
+    tasksData[i].Id = i;
+    tasksData[i].NumberOfCompletedTasks = &numberOfCompletedTasks;
+    tasksData[i].ExecutionOrder = &executionOrder;
+    tasksData[i].ExecutionOrderMutex = &executionOrderMutex;
+    vtkSmartPointer<vtkCjyxTask> task;
+    CHECK_BOOL(ScheduleTestTask(appLogic, logic, &tasksData[i], vtkCjyxTask::Processing, i < 5 ? 0 : 10, &task), true);
+    if (i == 10)
+      {
+      task->Cancel();
+      CHECK_BOOL(task->IsCanceled(), true);
+      }
+    }
+  CHECK_INT(static_cast<int>(appLogic->GetNumberOfQueuedTasks()), 11);
+
+  release = true;
+  CHECK_BOOL(WaitFor([&] { return appLogic->GetNumberOfQueuedTasks() == 0 && numberOfCompletedTasks == 10; }), true);
+  appLogic->TerminateProcessingThread();
+
+  // High priority tasks first, tasks of the same priority in the order of scheduling
+  const int expectedExecutionOrder[10] = { 5, 6, 7, 8, 9, 0, 1, 2, 3, 4 };
+  CHECK_INT(static_cast<int>(executionOrder.size()), 10);
+  for (int i = 0; i < 10; ++i)
+    {
+    CHECK_INT(executionOrder[i], expectedExecutionOrder[i]);
+    }
+  CHECK_BOOL(tasksData[10].Started.load(), false);
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int vtkCjyxApplicationLogicTasksTest(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  CHECK_EXIT_SUCCESS(TestConcurrentTasks());
+  CHECK_EXIT_SUCCESS(TestTaskPriorityAndCancel());
+  return EXIT_SUCCESS;
+}
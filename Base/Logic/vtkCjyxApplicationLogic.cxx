@@ -41,12 +41,53 @@
 # include <sys/resource.h>
 #endif
 
+#include <condition_variable>
 #include <queue>
+#include <thread>
 
 #include "vtkCjyxApplicationLogicRequests.h"
 
 //----------------------------------------------------------------------------
-class ProcessingTaskQueue : public std::queue<vtkSmartPointer<vtkCjyxTask> > {};
+// Scheduled tasks of each task type, ordered by priority.
+// Members must only be accessed while ProcessingTaskQueueLock is locked.
+class ProcessingTaskQueue
+{
+public:
+  struct ScheduledTask
+    {
+    vtkSmartPointer<vtkCjyxTask> Task;
+    int Priority;
+    unsigned long SequenceNumber;
+
+    // std::priority_queue returns the largest element first: higher priority
+    // first, then tasks in the order they were scheduled
+    bool operator<(const ScheduledTask& other) const
+      {
+      if (this->Priority != other.Priority)
+        {
+        return this->Priority < other.Priority;
+        }
+      return this->SequenceNumber > other.SequenceNumber;
+      }
+    };
+  typedef std::priority_queue<ScheduledTask> TaskQueueType;
+
+  TaskQueueType& GetTasks(int taskType)
+    {
+    // tasks of undefined type are executed as processing tasks
+    return (taskType == vtkCjyxTask::Networking ? this->NetworkingTasks : this->ProcessingTasks);
+    }
+
+  TaskQueueType ProcessingTasks;
+  TaskQueueType NetworkingTasks;
+  unsigned long NextSequenceNumber = 0;
+
+  // Threads exit when this flag is cleared
+  bool Active = false;
+
+  // Notified when a task is scheduled or the threads are terminated
+  std::condition_variable TaskScheduled;
+};
 class ModifiedQueue : public std::queue<vtkSmartPointer<vtkObject> > {};
 class ReadDataQueue : public std::queue<DataRequest*> {};
 class WriteDataQueue : public std::queue<DataRequest*> {};
@@ -58,7 +99,7 @@ vtkStandardNewMacro(vtkCjyxApplicationLogic);
 vtkCjyxApplicationLogic::vtkCjyxApplicationLogic()
 {
   this->ProcessingThreader = itk::PlatformMultiThreader::New();
-  this->ProcessingThreadId = -1;
+  this->NumberOfProcessingThreads = std::max(1, std::min(4, static_cast<int>(std::thread::hardware_concurrency())));
   this->ProcessingThreadActive = false;
 
   this->ModifiedQueueActive = false;
@@ -79,21 +120,9 @@ vtkCjyxApplicationLogic::vtkCjyxApplicationLogic()
 //----------------------------------------------------------------------------
 vtkCjyxApplicationLogic::~vtkCjyxApplicationLogic()
 {
-  // Note that TerminateThread does not kill a thread, it only waits
-  // for the thread to finish.  We need to signal the thread that we
-  // want to terminate
-  if (this->ProcessingThreadId != -1 && this->ProcessingThreader)
-    {
-    // Signal the processingThread that we are terminating.
-    this->ProcessingThreadActiveLock.lock();
-    this->ProcessingThreadActive = false;
-    this->ProcessingThreadActiveLock.unlock();
-
-    // Wait for the thread to finish and clean up the state of the threader
-    this->ProcessingThreader->TerminateThread( this->ProcessingThreadId );
-
-    this->ProcessingThreadId = -1;
-    }
+  // Signal the processing and networking threads that we are terminating
+  // and wait for them to finish
+  this->TerminateProcessingThread();
 
   delete this->InternalTaskQueue;
 
@@ -163,36 +192,34 @@ void vtkCjyxApplicationLogic::PrintSelf(ostream& os, vtkIndent indent)
 //----------------------------------------------------------------------------
 void vtkCjyxApplicationLogic::CreateProcessingThread()
 {
-  if (this->ProcessingThreadId == -1)
+  if (this->ProcessingThreadIDs.empty())
     {
     this->ProcessingThreadActiveLock.lock();
     this->ProcessingThreadActive = true;
     this->ProcessingThreadActiveLock.unlock();
 
-    this->ProcessingThreadId
-      = this->ProcessingThreader
-      ->SpawnThread(vtkCjyxApplicationLogic::ProcessingThreaderCallback,
-                    this);
+    this->ProcessingTaskQueueLock.lock();
+    this->InternalTaskQueue->Active = true;
+    this->ProcessingTaskQueueLock.unlock();
 
-    // Start four network threads (TODO: make the number of threads a setting)
-    this->NetworkingThreadIDs.push_back ( this->ProcessingThreader
-          ->SpawnThread(vtkCjyxApplicationLogic::NetworkingThreaderCallback,
-                    this) );
+    // Processing tasks (e.g., CLI modules) are run concurrently, so that
+    // a long-running task does not block the others.
+    for (int i = 0; i < this->NumberOfProcessingThreads; ++i)
+      {
+      this->ProcessingThreadIDs.push_back ( this->ProcessingThreader
+            ->SpawnThread(vtkCjyxApplicationLogic::ProcessingThreaderCallback,
+                      this) );
+      }
+
+    // Start one network thread
     /*
      * TODO: it looks like curl is not thread safe by default
      * - maybe there's a setting that cmcurl can have
      *   similar to the --enable-threading of the standard curl build
-     *
-    this->NetworkingThreadIDs.push_back ( this->ProcessingThreader
-          ->SpawnThread(vtkCjyxApplicationLogic::NetworkingThreaderCallback,
-                    this) );
+     */
     this->NetworkingThreadIDs.push_back ( this->ProcessingThreader
           ->SpawnThread(vtkCjyxApplicationLogic::NetworkingThreaderCallback,
                     this) );
-    this->NetworkingThreadIDs.push_back ( this->ProcessingThreader
-          ->SpawnThread(vtkCjyxApplicationLogic::NetworkingThreaderCallback,
-                    this) );
-    */
 
     // Setup the communication channel back to the main thread
     this->ModifiedQueueActiveLock.lock();
@@ -215,7 +242,7 @@ void vtkCjyxApplicationLogic::CreateProcessingThread()
 //----------------------------------------------------------------------------
 void vtkCjyxApplicationLogic::TerminateProcessingThread()
 {
-  if (this->ProcessingThreadId != -1)
+  if (!this->ProcessingThreadIDs.empty())
     {
     this->ModifiedQueueActiveLock.lock();
     this->ModifiedQueueActive = false;
@@ -233,10 +260,23 @@ void vtkCjyxApplicationLogic::TerminateProcessingThread()
     this->ProcessingThreadActive = false;
     this->ProcessingThreadActiveLock.unlock();
 
-    this->ProcessingThreader->TerminateThread( this->ProcessingThreadId );
-    this->ProcessingThreadId = -1;
+    // Wake up all idle threads so that they notice that they have to exit
+    this->ProcessingTaskQueueLock.lock();
+    this->InternalTaskQueue->Active = false;
+    this->ProcessingTaskQueueLock.unlock();
+    this->InternalTaskQueue->TaskScheduled.notify_all();
 
+    // Note that TerminateThread does not kill a thread, it only waits
+    // for the thread to finish (running tasks are completed).
     std::vector<int>::const_iterator idIterator;
+    idIterator = this->ProcessingThreadIDs.begin();
+    while (idIterator != this->ProcessingThreadIDs.end())
+      {
+      this->ProcessingThreader->TerminateThread( *idIterator );
+      ++idIterator;
+      }
+    this->ProcessingThreadIDs.clear();
+
     idIterator = this->NetworkingThreadIDs.begin();
     while (idIterator != this->NetworkingThreadIDs.end())
       {
@@ -270,48 +310,7 @@ vtkCjyxApplicationLogic::ProcessingThreaderCallback(void* arg)
 //----------------------------------------------------------------------------
 void vtkCjyxApplicationLogic::ProcessProcessingTasks()
 {
-  int active = true;
-  vtkSmartPointer<vtkCjyxTask> task = nullptr;
-
-  while (active)
-    {
-    // Check to see if we should be shutting down
-    this->ProcessingThreadActiveLock.lock();
-    active = this->ProcessingThreadActive;
-    this->ProcessingThreadActiveLock.unlock();
-
-    if (active)
-      {
-      // pull a task off the queue
-      this->ProcessingTaskQueueLock.lock();
-      if ((*this->InternalTaskQueue).size() > 0)
-        {
-        // std::cout << "Number of queued tasks: " << (*this->InternalTaskQueue).size() << std::endl;
-
-        // only handle processing tasks in this thread
-        task = (*this->InternalTaskQueue).front();
-        if ( task->GetType() == vtkCjyxTask::Processing )
-          {
-          (*this->InternalTaskQueue).pop();
-          }
-        else
-          {
-          task = nullptr;
-          }
-        }
-      this->ProcessingTaskQueueLock.unlock();
-
-      // process the task (should this be in a separate thread?)
-      if (task)
-        {
-        task->Execute();
-        task = nullptr;
-        }
-      }
-
-    // busy wait
-    itksys::SystemTools::Delay(100);
-    }
+  this->ProcessTasks(vtkCjyxTask::Processing);
 }
 
 itk::ITK_THREAD_RETURN_TYPE
@@ -335,45 +334,36 @@ vtkCjyxApplicationLogic::NetworkingThreaderCallback(void* arg)
 //----------------------------------------------------------------------------
 void vtkCjyxApplicationLogic::ProcessNetworkingTasks()
 {
-  int active = true;
-  vtkSmartPointer<vtkCjyxTask> task = nullptr;
+  this->ProcessTasks(vtkCjyxTask::Networking);
+}
 
-  while (active)
+//----------------------------------------------------------------------------
+void vtkCjyxApplicationLogic::ProcessTasks(int taskType)
+{
+  ProcessingTaskQueue::TaskQueueType& tasks = this->InternalTaskQueue->GetTasks(taskType);
+  while (true)
     {
-    // Check to see if we should be shutting down
-    this->ProcessingThreadActiveLock.lock();
-    active = this->ProcessingThreadActive;
-    this->ProcessingThreadActiveLock.unlock();
-
-    if (active)
+    vtkSmartPointer<vtkCjyxTask> task;
       {
-      // pull a task off the queue
-      this->ProcessingTaskQueueLock.lock();
-      if ((*this->InternalTaskQueue).size() > 0)
+      // wait for a task (or for shutting down)
+      std::unique_lock<std::mutex> lock(this->ProcessingTaskQueueLock);
+      this->InternalTaskQueue->TaskScheduled.wait(lock, [&]
         {
-        // std::cout << "Number of queued tasks: " << (*this->InternalTaskQueue).size() << std::endl;
-        task = (*this->InternalTaskQueue).front();
-        if ( task->GetType() == vtkCjyxTask::Networking )
-          {
-          (*this->InternalTaskQueue).pop();
-          }
-        else
-          {
-          task = nullptr;
-          }
-        }
-      this->ProcessingTaskQueueLock.unlock();
-
-      // process the task (should this be in a separate thread?)
-      if (task)
+        return !this->InternalTaskQueue->Active || !tasks.empty();
+        });
+      if (!this->InternalTaskQueue->Active)
         {
-        task->Execute();
-        task = nullptr;
+        return;
         }
+      task = tasks.top().Task;
+      tasks.pop();
       }
 
-    // busy wait
-    itksys::SystemTools::Delay(100);
+    // tasks that were canceled before they started are not executed
+    if (!task->IsCanceled())
+      {
+      task->Execute();
+      }
     }
 }
 
@@ -390,11 +380,26 @@ int vtkCjyxApplicationLogic::ScheduleTask( vtkCjyxTask *task )
     }
 
   this->ProcessingTaskQueueLock.lock();
-  (*this->InternalTaskQueue).push( task );
+  ProcessingTaskQueue::ScheduledTask scheduledTask;
+  scheduledTask.Task = task;
+  scheduledTask.Priority = task->GetPriority();
+  scheduledTask.SequenceNumber = this->InternalTaskQueue->NextSequenceNumber++;
+  this->InternalTaskQueue->GetTasks(task->GetType()).push( scheduledTask );
   this->ProcessingTaskQueueLock.unlock();
+
+  // wake up all threads as only those that handle this task type can execute it
+  this->InternalTaskQueue->TaskScheduled.notify_all();
   return true;
 }
 
+//----------------------------------------------------------------------------
+unsigned int vtkCjyxApplicationLogic::GetNumberOfQueuedTasks()
+{
+  std::lock_guard<std::mutex> lock(this->ProcessingTaskQueueLock);
+  return static_cast<unsigned int>(this->InternalTaskQueue->ProcessingTasks.size()
+    + this->InternalTaskQueue->NetworkingTasks.size());
+}
+
 //----------------------------------------------------------------------------
 vtkMTimeType vtkCjyxApplicationLogic::RequestModified(vtkObject *obj)
 {
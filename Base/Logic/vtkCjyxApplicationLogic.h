@@ -68,11 +68,22 @@ class VTK_CJYX_BASE_LOGIC_EXPORT vtkCjyxApplicationLogic
                           vtkDataIOManagerLogic *dataIOManagerLogic);
 
 
-  /// Create a thread for processing
+  /// Create the threads for processing and networking tasks
   void CreateProcessingThread();
 
-  /// Shutdown the processing thread
+  /// Shutdown the processing and networking threads.
+  /// Tasks that have not been started yet remain scheduled.
   void TerminateProcessingThread();
+
+  /// Number of threads that execute processing tasks concurrently.
+  /// Takes effect when CreateProcessingThread() is called.
+  /// Default is the number of CPU cores, up to 4.
+  vtkSetClampMacro(NumberOfProcessingThreads, int, 1, 32);
+  vtkGetMacro(NumberOfProcessingThreads, int);
+
+  /// Return the number of scheduled tasks that have not been started yet.
+  unsigned int GetNumberOfQueuedTasks();
+
   /// List of events potentially fired by the application logic
   enum RequestEvents
     {
@@ -86,9 +97,11 @@ class VTK_CJYX_BASE_LOGIC_EXPORT vtkCjyxApplicationLogic
       RequestProcessedEvent
     };
 
-  /// Schedule a task to run in the processing thread. Returns true if
-  /// task was successfully scheduled. ScheduleTask() is called from the
-  /// main thread to run something in the processing thread.
+  /// Schedule a task to run in a processing or networking thread,
+  /// depending on the task type. Returns true if task was successfully
+  /// scheduled. ScheduleTask() is called from the main thread to run
+  /// something in a background thread. Tasks are started in the order
+  /// of their priority, see vtkCjyxTask::SetPriority() and vtkCjyxTask::Cancel().
   int ScheduleTask( vtkCjyxTask* );
 
   /// Request a Modified call on an object.  This method allows a
@@ -233,12 +246,15 @@ protected:
    /// Callback used by a MultiThreader to start a networking thread
   static itk::ITK_THREAD_RETURN_TYPE NetworkingThreaderCallback( void * );
 
-  /// Task processing loop that is run in the processing thread
+  /// Task processing loop that is run in the processing threads
   void ProcessProcessingTasks();
 
   /// Networking Task processing loop that is run in a networking thread
   void ProcessNetworkingTasks();
 
+  /// Execute scheduled tasks of the specified type until the threads are terminated
+  void ProcessTasks(int taskType);
+
   /// Process a request to read data into a scene.  This method is
   /// called by ProcessReadData() in the application main thread
   /// because calls to load data will cause a Modified() on a node
@@ -266,7 +282,8 @@ private:
   std::mutex WriteDataQueueActiveLock;
   std::mutex WriteDataQueueLock;
   vtkTimeStamp RequestTimeStamp;
-  int ProcessingThreadId;
+  int NumberOfProcessingThreads;
+  std::vector<int> ProcessingThreadIDs;
   std::vector<int> NetworkingThreadIDs;
   int ProcessingThreadActive;
   int ModifiedQueueActive;
@@ -13,6 +13,8 @@ vtkCjyxTask::vtkCjyxTask()
   this->TaskFunction = nullptr;
   this->TaskClientData = nullptr;
   this->Type = vtkCjyxTask::Undefined;
+  this->Priority = 0;
+  this->Canceled = false;
 }
 //----------------------------------------------------------------------------
 vtkCjyxTask::~vtkCjyxTask() = default;
@@ -36,8 +38,24 @@ void vtkCjyxTask::Execute()
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkCjyxTask::Cancel()
+{
+  this->Canceled = true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkCjyxTask::IsCanceled()
+{
+  return this->Canceled;
+}
+
 //----------------------------------------------------------------------------
 void vtkCjyxTask::PrintSelf(ostream& os, vtkIndent indent)
 {
   Superclass::PrintSelf(os, indent);
+
+  os << indent << "Type: " << this->GetTypeAsString() << "\n";
+  os << indent << "Priority: " << this->Priority << "\n";
+  os << indent << "Canceled: " << (this->Canceled ? "true" : "false") << "\n";
 }
@@ -6,6 +6,9 @@
 #include "vtkDMMLAbstractLogic.h"
 #include "vtkCjyxBaseLogic.h"
 
+// STD includes
+#include <atomic>
+
 class VTK_CJYX_BASE_LOGIC_EXPORT vtkCjyxTask : public vtkObject
 {
 public:
@@ -48,6 +51,20 @@ public:
     return "Unknown";
   }
 
+  ///
+  /// Priority of the task. Scheduled tasks with higher priority are started
+  /// first, tasks with the same priority are started in the order they were
+  /// scheduled. Must be set before the task is scheduled. Default is 0.
+  vtkSetMacro (Priority, int);
+  vtkGetMacro (Priority, int);
+
+  ///
+  /// Request cancellation of the task. A scheduled task that has not been
+  /// started yet will not be executed. A running task function may call
+  /// IsCanceled() to stop early. These methods may be called from any thread.
+  void Cancel();
+  bool IsCanceled();
+
 protected:
   vtkCjyxTask();
   ~vtkCjyxTask() override;
@@ -60,6 +77,8 @@ private:
   void *TaskClientData;
 
   int Type;
+  int Priority;
+  std::atomic<bool> Canceled;
 
 };
 #endif
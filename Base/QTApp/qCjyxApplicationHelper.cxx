@@ -21,6 +21,7 @@
 #include "qCjyxApplicationHelper.h"
 
 // Qt includes
+#include <QDir>
 #include <QFont>
 #include <QLabel>
 #include <QSettings>
@@ -183,6 +184,10 @@ void qCjyxApplicationHelper::setupModuleFactoryManager(qCjyxModuleFactoryManager
 
     qCjyxCLIExecutableModuleFactory* cliExecutableFactory = new qCjyxCLIExecutableModuleFactory();
     cliExecutableFactory->setTempDirectory(tempDirectory);
+    // Descriptions retrieved by running CLI executables are reused across application sessions
+    cliExecutableFactory->setModuleDescriptionCacheDirectory(
+      QDir(app->cachePath()).filePath("CLIModuleDescriptions"));
+    cliExecutableFactory->setProfilingEnabled(options->startupProfiling());
     moduleFactoryManager->registerFactory(cliExecutableFactory, preferExecutableCLIs ? 1 : 0);
 
     if (!options->disableBuiltInModules() &&
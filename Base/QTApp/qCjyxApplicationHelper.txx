@@ -26,6 +26,7 @@
 #include <qCjyxApplication.h>
 
 // Qt includes
+#include <QElapsedTimer>
 #include <QSettings>
 #include <QSplashScreen>
 #include <QTimer>
@@ -71,6 +72,16 @@ void splashMessage(QScopedPointer<QSplashScreen>& splashScreen, const QString& m
   splashScreen->showMessage(message, Qt::AlignBottom | Qt::AlignHCenter);
 }
 
+//----------------------------------------------------------------------------
+void printStartupStepTime(QElapsedTimer& timer, const QString& stepName)
+{
+  if (!qCjyxApplication::application()->commandOptions()->startupProfiling())
+    {
+    return;
+    }
+  qDebug().noquote().nospace() << "Startup profiling: " << stepName << " " << timer.restart() << " ms";
+}
+
 } // end of anonymous namespace
 
 //----------------------------------------------------------------------------
@@ -152,15 +163,24 @@ int qCjyxApplicationHelper::postInitializeApplication(
     }
 
   // Register and instantiate modules
+  QElapsedTimer startupStepTimer;
+  startupStepTimer.start();
+  QString startupProfileFile = app.commandOptions()->startupProfileFile();
+  moduleFactoryManager->setProfilingEnabled(
+    app.commandOptions()->startupProfiling() || !startupProfileFile.isEmpty());
   splashMessage(splashScreen, "Registering modules...");
   moduleFactoryManager->registerModules();
+  printStartupStepTime(startupStepTimer, "registering modules");
   if (app.commandOptions()->verboseModuleDiscovery())
     {
     qDebug() << "Number of registered modules:"
              << moduleFactoryManager->registeredModuleNames().count();
     }
   splashMessage(splashScreen, "Instantiating modules...");
+  moduleFactoryManager->beginProfileEvent("Instantiate modules", "startup");
   moduleFactoryManager->instantiateModules();
+  moduleFactoryManager->endProfileEvent();
+  printStartupStepTime(startupStepTimer, "instantiating modules");
   if (app.commandOptions()->verboseModuleDiscovery())
     {
     qDebug() << "Number of instantiated modules:"
@@ -188,7 +208,10 @@ int qCjyxApplicationHelper::postInitializeApplication(
   splashMessage(splashScreen, "Initializing user interface...");
   if (enableMainWindow)
     {
+    moduleFactoryManager->beginProfileEvent("Create main window", "startup");
     window.reset(new CjyxMainWindowType);
+    moduleFactoryManager->endProfileEvent();
+    printStartupStepTime(startupStepTimer, "creating main window");
     }
   else if (app.commandOptions()->showPythonInteractor()
     && !app.commandOptions()->runPythonAndExit())
@@ -205,12 +228,24 @@ int qCjyxApplicationHelper::postInitializeApplication(
     }
 
   // Load all available modules
+  moduleFactoryManager->beginProfileEvent("Load modules", "startup");
   foreach(const QString& name, moduleFactoryManager->instantiatedModuleNames())
     {
     Q_ASSERT(!name.isNull());
     splashMessage(splashScreen, "Loading module \"" + name + "\"...");
     moduleFactoryManager->loadModule(name);
     }
+  moduleFactoryManager->endProfileEvent();
+  printStartupStepTime(startupStepTimer, "loading modules");
+  if (app.commandOptions()->startupProfiling())
+    {
+    qDebug().noquote() << moduleFactoryManager->profileSummary();
+    }
+  if (!startupProfileFile.isEmpty())
+    {
+    moduleFactoryManager->writeProfile(startupProfileFile);
+    }
+  moduleFactoryManager->setProfilingEnabled(false);
   if (app.commandOptions()->verboseModuleDiscovery())
     {
     qDebug() << "Number of loaded modules:" << moduleManager->modulesNames().count();
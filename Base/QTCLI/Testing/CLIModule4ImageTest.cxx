@@ -0,0 +1,96 @@
+/*=========================================================================
+  Program:   Cjyx
+=========================================================================*/
+
+#include "CLIModule4ImageTestCLP.h"
+
+// ITK includes
+#include <itkImage.h>
+#include <itkImageFileReader.h>
+#include <itkImageFileWriter.h>
+#include <itkImageRegionIterator.h>
+
+// STD includes
+#include <fstream>
+
+// Use an anonymous namespace to keep class types and function names
+// from colliding when module is used as shared object module.  Every
+// thing should be in an anonymous namespace except for the module
+// entry point, e.g. main()
+//
+
+namespace
+{
+
+bool outputFileName(const std::string& fileName, const std::string& outputFile)
+  {
+  if (outputFile.empty())
+    {
+    return true;
+    }
+  std::ofstream myfile(outputFile.c_str());
+  if (!myfile.is_open())
+    {
+    std::cerr << "Failed to open file:" << outputFile << std::endl;
+    return false;
+    }
+  myfile << fileName << "\n";
+  return true;
+  }
+
+} // end of anonymous namespace
+
+int main(int argc, char * argv[])
+{
+  PARSE_ARGS;
+
+  if (!outputFileName(InputVolume, InputFileNameFile))
+    {
+    return EXIT_FAILURE;
+    }
+
+  typedef itk::Image<float, 3> ImageType;
+  typedef itk::ImageFileReader<ImageType> ReaderType;
+  typedef itk::ImageFileWriter<ImageType> WriterType;
+
+  ImageType::Pointer image;
+  try
+    {
+    ReaderType::Pointer reader = ReaderType::New();
+    reader->SetFileName(InputVolume.c_str());
+    reader->Update();
+    image = reader->GetOutput();
+    }
+  catch (itk::ExceptionObject& exc)
+    {
+    std::cerr << "Failed to read " << InputVolume << ": " << exc << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if (Fail)
+    {
+    std::cerr << "Failure requested" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  itk::ImageRegionIterator<ImageType> it(image, image->GetLargestPossibleRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+    it.Set(it.Get() + 1.0f);
+    }
+
+  try
+    {
+    WriterType::Pointer writer = WriterType::New();
+    writer->SetFileName(OutputVolume.c_str());
+    writer->SetInput(image);
+    writer->Update();
+    }
+  catch (itk::ExceptionObject& exc)
+    {
+    std::cerr << "Failed to write " << OutputVolume << ": " << exc << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,118 @@
+/*==============================================================================
+
+  Program: 3D Cjyx
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+// Cjyx includes
+#include <qCjyxCLIModuleDescriptionCache.h>
+
+#include "vtkDMMLCoreTestingMacros.h"
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+bool writeFile(const QString& filePath, const QByteArray& content)
+{
+  QFile file(filePath);
+  if (!file.open(QIODevice::WriteOnly))
+    {
+    return false;
+    }
+  return file.write(content) == content.size();
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int qCjyxCLIModuleDescriptionCacheTest1(int, char * [] )
+{
+  QTemporaryDir tempDir;
+  CHECK_BOOL(tempDir.isValid(), true);
+  QDir dir(tempDir.path());
+
+  // The cache only uses the file properties of the executable, so a regular file is sufficient here
+  QString executablePath = dir.filePath("CLIModule4Test");
+  CHECK_BOOL(writeFile(executablePath, "version 1"), true);
+  QString xmlDescription = "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<executable></executable>\n";
+
+  // Descriptions are not stored if cache directory is not set
+  qCjyxCLIModuleDescriptionCache cache;
+  CHECK_BOOL(cache.setCachedDescription(executablePath, xmlDescription), false);
+  CHECK_BOOL(cache.cachedDescription(executablePath).isEmpty(), true);
+
+  // Store and retrieve description
+  QString cacheDirectory = dir.filePath("Cache");
+  cache.setCacheDirectory(cacheDirectory);
+  CHECK_STD_STRING(cache.cacheDirectory().toStdString(), cacheDirectory.toStdString());
+  CHECK_BOOL(cache.cachedDescription(executablePath).isEmpty(), true);
+  CHECK_BOOL(cache.setCachedDescription(executablePath, xmlDescription), true);
+  CHECK_STD_STRING(cache.cachedDescription(executablePath).toStdString(), xmlDescription.toStdString());
+
+  // Description is found by a new cache instance (for example, at next application startup)
+  {
+    qCjyxCLIModuleDescriptionCache otherCache;
+    otherCache.setCacheDirectory(cacheDirectory);
+    CHECK_STD_STRING(otherCache.cachedDescription(executablePath).toStdString(), xmlDescription.toStdString());
+    qCjyxCLIModuleDescriptionCache::Result result = otherCache.description(executablePath);
+    CHECK_STD_STRING(result.XmlDescription.toStdString(), xmlDescription.toStdString());
+    CHECK_BOOL(result.ErrorStrings.isEmpty(), true);
+  }
+
+  // Description is not used after the executable is modified
+  CHECK_BOOL(writeFile(executablePath, "version 2 (larger)"), true);
+  CHECK_BOOL(cache.cachedDescription(executablePath).isEmpty(), true);
+
+  // Outdated entries are removed when the new description is stored
+  QString xmlDescription2 = "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<executable><title>2</title></executable>\n";
+  CHECK_BOOL(cache.setCachedDescription(executablePath, xmlDescription2), true);
+  CHECK_STD_STRING(cache.cachedDescription(executablePath).toStdString(), xmlDescription2.toStdString());
+  CHECK_INT(QDir(cacheDirectory).entryList(QDir::Files).count(), 1);
+
+  // Executables that cannot be run report an error and are not stored in the cache
+  QString missingExecutablePath = dir.filePath("MissingCLIModule");
+  cache.setTimeout(1000);
+  CHECK_INT(cache.timeout(), 1000);
+  CHECK_INT(cache.updateDescriptions(QStringList() << missingExecutablePath << executablePath), 1);
+  qCjyxCLIModuleDescriptionCache::Result missingResult = cache.description(missingExecutablePath);
+  CHECK_BOOL(missingResult.XmlDescription.isEmpty(), true);
+  CHECK_BOOL(missingResult.ErrorStrings.isEmpty(), false);
+  CHECK_STD_STRING(cache.description(executablePath).XmlDescription.toStdString(), xmlDescription2.toStdString());
+  CHECK_INT(QDir(cacheDirectory).entryList(QDir::Files).count(), 1);
+
+#ifndef _WIN32
+  // Descriptions of executables that write to the standard error are not stored in the cache,
+  // as the standard output may be truncated
+  QString noisyExecutablePath = dir.filePath("NoisyCLIModule");
+  CHECK_BOOL(writeFile(noisyExecutablePath,
+    "#!/bin/sh\n"
+    "echo 'Warning: something went wrong' >&2\n"
+    "echo '<?xml version=\"1.0\" encoding=\"utf-8\"?>'\n"
+    "echo '<executable></executable>'\n"), true);
+  CHECK_BOOL(QFile::setPermissions(noisyExecutablePath,
+    QFile::permissions(noisyExecutablePath) | QFile::ExeOwner), true);
+  CHECK_INT(cache.updateDescriptions(QStringList() << noisyExecutablePath), 1);
+  qCjyxCLIModuleDescriptionCache::Result noisyResult = cache.description(noisyExecutablePath);
+  CHECK_BOOL(noisyResult.ErrorStrings.isEmpty(), false);
+  CHECK_BOOL(cache.cachedDescription(noisyExecutablePath).isEmpty(), true);
+  // The executable is run again
+  CHECK_INT(cache.updateDescriptions(QStringList() << noisyExecutablePath), 1);
+#endif
+
+  return EXIT_SUCCESS;
+}
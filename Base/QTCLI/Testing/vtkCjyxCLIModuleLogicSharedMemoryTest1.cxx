@@ -0,0 +1,258 @@
+/*==============================================================================
+
+  Program: 3D Cjyx
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Cjyx includes
+#include "vtkCjyxApplicationLogic.h"
+#include "vtkCjyxCLIModuleLogic.h"
+
+// DMML includes
+#include <vtkDMMLCommandLineModuleNode.h>
+#include <vtkDMMLCoreTestingMacros.h>
+#include <vtkDMMLScalarVolumeNode.h>
+#include <vtkDMMLScene.h>
+
+// DMMLIDImageIO includes
+#include <itkDMMLSharedMemoryImageIO.h>
+
+// ModuleDescriptionParser includes
+#include <ModuleDescription.h>
+#include <ModuleDescriptionParser.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+
+// ITK includes
+#include <itksys/SystemTools.hxx>
+
+// STD includes
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+vtkDMMLScalarVolumeNode* AddInputVolume(vtkDMMLScene* scene)
+{
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(7, 6, 5);
+  imageData->AllocateScalars(VTK_SHORT, 1);
+  short* voxels = static_cast<short*>(imageData->GetScalarPointer());
+  for (vtkIdType i = 0; i < imageData->GetNumberOfPoints(); ++i)
+    {
+    voxels[i] = static_cast<short>(i % 100 - 50);
+    }
+
+  vtkDMMLScalarVolumeNode* volumeNode = vtkDMMLScalarVolumeNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkDMMLScalarVolumeNode", "Input"));
+  volumeNode->SetAndObserveImageData(imageData);
+  // Non-trivial geometry to check that IJK to RAS is transferred correctly
+  double directions[3][3] = { { 0.0, -1.0, 0.0 }, { 1.0, 0.0, 0.0 }, { 0.0, 0.0, -1.0 } };
+  volumeNode->SetIJKToRASDirections(directions);
+  volumeNode->SetSpacing(0.5, 0.75, 1.25);
+  volumeNode->SetOrigin(10.0, -20.0, 30.0);
+  return volumeNode;
+}
+
+//----------------------------------------------------------------------------
+std::string ReadFirstLine(const std::string& fileName)
+{
+  std::ifstream file(fileName.c_str());
+  std::string line;
+  std::getline(file, line);
+  return line;
+}
+
+//----------------------------------------------------------------------------
+int CheckOutputVolume(vtkDMMLScalarVolumeNode* inputNode, vtkDMMLScalarVolumeNode* outputNode)
+{
+  CHECK_NOT_NULL(outputNode->GetImageData());
+  vtkImageData* input = inputNode->GetImageData();
+  vtkImageData* output = outputNode->GetImageData();
+  int inputDimensions[3] = { 0, 0, 0 };
+  int outputDimensions[3] = { 0, 0, 0 };
+  input->GetDimensions(inputDimensions);
+  output->GetDimensions(outputDimensions);
+  for (int i = 0; i < 3; ++i)
+    {
+    CHECK_INT(outputDimensions[i], inputDimensions[i]);
+    }
+
+  vtkNew<vtkMatrix4x4> inputIJKToRAS;
+  vtkNew<vtkMatrix4x4> outputIJKToRAS;
+  inputNode->GetIJKToRASMatrix(inputIJKToRAS);
+  outputNode->GetIJKToRASMatrix(outputIJKToRAS);
+  for (int row = 0; row < 4; ++row)
+    {
+    for (int column = 0; column < 4; ++column)
+      {
+      CHECK_DOUBLE_TOLERANCE(outputIJKToRAS->GetElement(row, column),
+        inputIJKToRAS->GetElement(row, column), 1e-6);
+      }
+    }
+
+  for (int k = 0; k < inputDimensions[2]; ++k)
+    {
+    for (int j = 0; j < inputDimensions[1]; ++j)
+      {
+      for (int i = 0; i < inputDimensions[0]; ++i)
+        {
+        CHECK_DOUBLE(output->GetScalarComponentAsDouble(i, j, k, 0),
+          input->GetScalarComponentAsDouble(i, j, k, 0) + 1.0);
+        }
+      }
+    }
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int RunModule(vtkCjyxCLIModuleLogic* logic, vtkDMMLScene* scene,
+  vtkDMMLScalarVolumeNode* inputNode, const std::string& inputFileNameFile,
+  bool fail, std::string& inputFileName)
+{
+  itksys::SystemTools::RemoveFile(inputFileNameFile);
+
+  vtkDMMLScalarVolumeNode* outputNode = vtkDMMLScalarVolumeNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkDMMLScalarVolumeNode", "Output"));
+  vtkDMMLCommandLineModuleNode* cliNode = logic->CreateNodeInScene();
+  CHECK_NOT_NULL(cliNode);
+  CHECK_BOOL(cliNode->SetParameterAsString("InputVolume", inputNode->GetID()), true);
+  CHECK_BOOL(cliNode->SetParameterAsString("OutputVolume", outputNode->GetID()), true);
+  CHECK_BOOL(cliNode->SetParameterAsString("InputFileNameFile", inputFileNameFile), true);
+  CHECK_BOOL(cliNode->SetParameterAsBool("Fail", fail), true);
+
+  logic->ApplyAndWait(cliNode, false);
+
+  inputFileName = ReadFirstLine(inputFileNameFile);
+  CHECK_BOOL(inputFileName.empty(), false);
+
+  // Shared memory segments are removed when execution ends, even if the module failed
+  if (inputFileName.find("cjyxshm:") == 0)
+    {
+    itk::DMMLSharedMemoryImageIO::Pointer sharedMemoryIO = itk::DMMLSharedMemoryImageIO::New();
+    CHECK_BOOL(sharedMemoryIO->CanReadFile(inputFileName.c_str()), false);
+    }
+
+  if (fail)
+    {
+    CHECK_INT(cliNode->GetStatus(), vtkDMMLCommandLineModuleNode::CompletedWithErrors);
+    CHECK_NULL(outputNode->GetImageData());
+    return EXIT_SUCCESS;
+    }
+
+  CHECK_INT(cliNode->GetStatus(), vtkDMMLCommandLineModuleNode::Completed);
+  CHECK_EXIT_SUCCESS(CheckOutputVolume(inputNode, outputNode));
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+bool EndsWith(const std::string& text, const std::string& suffix)
+{
+  return text.size() >= suffix.size()
+    && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkCjyxCLIModuleLogicSharedMemoryTest1(int argc, char * argv[])
+{
+  if (argc < 5)
+    {
+    std::cerr << "Line " << __LINE__ << " - Missing parameters !\n"
+              << "Usage: " << argv[0] << " /path/to/CLIModule4ImageTest /path/to/CLIModule4ImageTest.xml"
+              << " /path/to/ITKFactories /path/to/temp"
+              << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string executable = argv[1];
+  const std::string xmlFileName = argv[2];
+  const std::string factoriesDirectory = argv[3];
+  const std::string temporaryDirectory = argv[4];
+
+  std::ifstream xmlFile(xmlFileName.c_str());
+  std::stringstream xml;
+  xml << xmlFile.rdbuf();
+  ModuleDescription description;
+  ModuleDescriptionParser parser;
+  CHECK_INT(parser.Parse(xml.str(), description), 0);
+  description.SetType("CommandLineModule");
+  description.SetTarget(executable);
+  description.SetLocation(executable);
+
+  vtkNew<vtkDMMLScene> scene;
+  vtkNew<vtkCjyxApplicationLogic> appLogic;
+  appLogic->SetDMMLScene(scene);
+  appLogic->SetTemporaryPath(temporaryDirectory.c_str());
+
+  vtkNew<vtkCjyxCLIModuleLogic> logic;
+  logic->SetDMMLApplicationLogic(appLogic);
+  logic->SetDMMLScene(scene);
+  logic->SetDefaultModuleDescription(description);
+
+  vtkDMMLScalarVolumeNode* inputNode = AddInputVolume(scene);
+  const std::string inputFileNameFile = temporaryDirectory + "/vtkCjyxCLIModuleLogicSharedMemoryTest1.txt";
+  std::string inputFileName;
+
+  std::string originalAutoLoadPath;
+  bool hasOriginalAutoLoadPath = itksys::SystemTools::GetEnv("ITK_AUTOLOAD_PATH", originalAutoLoadPath);
+
+  // Temporary files are used by default
+  itksys::SystemTools::PutEnv("ITK_AUTOLOAD_PATH=" + factoriesDirectory);
+  CHECK_INT(logic->GetAllowSharedMemoryTransfer(), 0);
+  CHECK_EXIT_SUCCESS(RunModule(logic, scene, inputNode, inputFileNameFile, false, inputFileName));
+  CHECK_BOOL(EndsWith(inputFileName, ".nrrd"), true);
+
+  // Volumes are transferred through shared memory if it is allowed and the plugin is found
+  logic->SetAllowSharedMemoryTransfer(1);
+  CHECK_EXIT_SUCCESS(RunModule(logic, scene, inputNode, inputFileNameFile, false, inputFileName));
+  if (itk::DMMLSharedMemoryImageIO::IsSharedMemorySupported())
+    {
+    CHECK_BOOL(inputFileName.find("cjyxshm:/") == 0, true);
+    }
+  else
+    {
+    CHECK_BOOL(EndsWith(inputFileName, ".nrrd"), true);
+    }
+
+  // Shared memory segments are removed if the module fails
+  CHECK_EXIT_SUCCESS(RunModule(logic, scene, inputNode, inputFileNameFile, true, inputFileName));
+
+  // Temporary files are used if shared memory transfer is not allowed
+  logic->SetAllowSharedMemoryTransfer(0);
+  CHECK_EXIT_SUCCESS(RunModule(logic, scene, inputNode, inputFileNameFile, false, inputFileName));
+  CHECK_BOOL(EndsWith(inputFileName, ".nrrd"), true);
+  logic->SetAllowSharedMemoryTransfer(1);
+
+  // Temporary files are used if the module cannot load the shared memory plugin
+  itksys::SystemTools::PutEnv("ITK_AUTOLOAD_PATH=" + temporaryDirectory);
+  CHECK_EXIT_SUCCESS(RunModule(logic, scene, inputNode, inputFileNameFile, false, inputFileName));
+  CHECK_BOOL(EndsWith(inputFileName, ".nrrd"), true);
+
+  if (hasOriginalAutoLoadPath)
+    {
+    itksys::SystemTools::PutEnv("ITK_AUTOLOAD_PATH=" + originalAutoLoadPath);
+    }
+  else
+    {
+    itksys::SystemTools::UnPutEnv("ITK_AUTOLOAD_PATH");
+    }
+  itksys::SystemTools::RemoveFile(inputFileNameFile);
+
+  std::cout << "Success" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -19,12 +19,15 @@
 ==============================================================================*/
 
 // Qt includes
-#include <QProcess>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QSet>
 #include <QStandardPaths>
 
 // Cjyx includes
 #include "qCjyxCLIExecutableModuleFactory.h"
 #include "qCjyxCLIModule.h"
+#include "qCjyxCLIModuleDescriptionCache.h"
 #include "qCjyxCLIModuleFactoryHelper.h"
 #include "qCjyxUtils.h"
 #include <vtkCjyxCLIModuleLogic.h>
@@ -47,11 +50,19 @@ QString findPython()
 
 }
 
+//-----------------------------------------------------------------------------
+QString xmlModuleDescriptionFilePathForExecutable(const QString& executablePath)
+{
+  QFileInfo info = QFileInfo(executablePath);
+  return QDir(info.path()).filePath(info.baseName() + ".xml");
+}
+
 //-----------------------------------------------------------------------------
 qCjyxCLIExecutableModuleFactoryItem::qCjyxCLIExecutableModuleFactoryItem(
-  const QString& newTempDirectory)
+  const QString& newTempDirectory, qCjyxCLIExecutableModuleFactory* factory)
   : TempDirectory(newTempDirectory)
   , CLIModule(nullptr)
+  , Factory(factory)
 {
 }
 
@@ -64,8 +75,7 @@ bool qCjyxCLIExecutableModuleFactoryItem::load()
 //-----------------------------------------------------------------------------
 QString qCjyxCLIExecutableModuleFactoryItem::xmlModuleDescriptionFilePath()
 {
-  QFileInfo info = QFileInfo(this->path());
-  return QDir(info.path()).filePath(info.baseName() + ".xml");
+  return xmlModuleDescriptionFilePathForExecutable(this->path());
 }
 
 //-----------------------------------------------------------------------------
@@ -137,80 +147,27 @@ qCjyxAbstractCoreModule* qCjyxCLIExecutableModuleFactoryItem::instanciator()
 //-----------------------------------------------------------------------------
 QString qCjyxCLIExecutableModuleFactoryItem::runCLIWithXmlArgument()
 {
-  ctkScopedCurrentDir scopedCurrentDir(QFileInfo(this->path()).path());
-
-  int cliProcessTimeoutInMs = 5000;
-  QProcess cli;
-  QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
-  env.insert("ITK_AUTOLOAD_PATH", "");
-  cli.setProcessEnvironment(env);
-  cli.start(this->path(), QStringList(QString("--xml")));
-  bool res = cli.waitForFinished(cliProcessTimeoutInMs);
-  if (!res)
+  qCjyxCLIModuleDescriptionCache::Result result;
+  if (this->Factory)
     {
-    this->appendInstantiateErrorString(QString("CLI executable: %1").arg(this->path()));
-    QString errorString;
-    switch(cli.error())
-      {
-      case QProcess::FailedToStart:
-        errorString = QLatin1String(
-              "The process failed to start. Either the invoked program is missing, or "
-              "you may have insufficient permissions to invoke the program.");
-        break;
-      case QProcess::Crashed:
-        errorString = QLatin1String(
-              "The process crashed some time after starting successfully.");
-        break;
-      case QProcess::Timedout:
-        errorString = QString(
-              "The process timed out after %1 msecs.").arg(cliProcessTimeoutInMs);
-        break;
-      case QProcess::WriteError:
-        errorString = QLatin1String(
-              "An error occurred when attempting to read from the process. "
-              "For example, the process may not be running.");
-        break;
-      case QProcess::ReadError:
-        errorString = QLatin1String(
-              "An error occurred when attempting to read from the process. "
-              "For example, the process may not be running.");
-        break;
-      case QProcess::UnknownError:
-        errorString = QLatin1String(
-              "Failed to execute process. An unknown error occurred.");
-        break;
-      }
-    this->appendInstantiateErrorString(errorString);
-    return nullptr;
+    // Descriptions of all executables are retrieved at once, at the first request
+    this->Factory->updateModuleDescriptions();
+    result = this->Factory->moduleDescriptionCache()->description(this->path());
     }
-  QString errors = cli.readAllStandardError();
-  if (!errors.isEmpty())
+  else
     {
-    this->appendInstantiateErrorString(QString("CLI executable: %1").arg(this->path()));
-    this->appendInstantiateErrorString(errors);
-    // TODO: More investigation for the following behavior:
-    // on my machine (Ubuntu 10.04 with ITKv4), having standard error trims the
-    // standard output results. The following readAllStandardOutput() is then
-    // missing chars and makes the XML invalid. I'm not sure if it's just on my
-    // machine so there is a chance it succeeds to parse the XML description
-    // on other machines.
+    qCjyxCLIModuleDescriptionCache descriptionCache;
+    result = descriptionCache.description(this->path());
     }
-  QString xmlDescription = cli.readAllStandardOutput();
-  if (xmlDescription.isEmpty())
+  foreach(const QString& errorString, result.ErrorStrings)
     {
-    this->appendInstantiateErrorString(QString("CLI executable: %1").arg(this->path()));
-    this->appendInstantiateErrorString("Failed to retrieve Xml Description");
-    return QString();
+    this->appendInstantiateErrorString(errorString);
     }
-  if (!xmlDescription.startsWith("<?xml"))
+  foreach(const QString& warningString, result.WarningStrings)
     {
-    this->appendInstantiateWarningString(QString("CLI executable: %1").arg(this->path()));
-    this->appendInstantiateWarningString(QLatin1String("XML description doesn't start right away."));
-    this->appendInstantiateWarningString(QString("Output before '<?xml' is [%1]").arg(
-                                           xmlDescription.mid(0, xmlDescription.indexOf("<?xml"))));
-    xmlDescription.remove(0, xmlDescription.indexOf("<?xml"));
+    this->appendInstantiateWarningString(warningString);
     }
-  return xmlDescription;
+  return result.XmlDescription;
 }
 
 //-----------------------------------------------------------------------------
@@ -235,6 +192,10 @@ public:
 
 private:
   QString TempDirectory;
+  qCjyxCLIModuleDescriptionCache ModuleDescriptionCache;
+  /// Executables that have been considered in updateModuleDescriptions()
+  QSet<QString> ModuleDescriptionsUpdated;
+  bool ProfilingEnabled;
 };
 
 //-----------------------------------------------------------------------------
@@ -242,6 +203,7 @@ qCjyxCLIExecutableModuleFactoryPrivate::qCjyxCLIExecutableModuleFactoryPrivate(q
 :q_ptr(&object)
 {
   this->TempDirectory = QDir::tempPath();
+  this->ProfilingEnabled = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -285,7 +247,7 @@ ctkAbstractFactoryItem<qCjyxAbstractCoreModule>* qCjyxCLIExecutableModuleFactory
 ::createFactoryFileBasedItem()
 {
   Q_D(qCjyxCLIExecutableModuleFactory);
-  return new qCjyxCLIExecutableModuleFactoryItem(d->TempDirectory);
+  return new qCjyxCLIExecutableModuleFactoryItem(d->TempDirectory, this);
 }
 
 //-----------------------------------------------------------------------------
@@ -300,3 +262,73 @@ void qCjyxCLIExecutableModuleFactory::setTempDirectory(const QString& newTempDir
   Q_D(qCjyxCLIExecutableModuleFactory);
   d->TempDirectory = newTempDirectory;
 }
+
+//-----------------------------------------------------------------------------
+qCjyxCLIModuleDescriptionCache* qCjyxCLIExecutableModuleFactory::moduleDescriptionCache()
+{
+  Q_D(qCjyxCLIExecutableModuleFactory);
+  return &d->ModuleDescriptionCache;
+}
+
+//-----------------------------------------------------------------------------
+void qCjyxCLIExecutableModuleFactory::setModuleDescriptionCacheDirectory(const QString& directory)
+{
+  Q_D(qCjyxCLIExecutableModuleFactory);
+  d->ModuleDescriptionCache.setCacheDirectory(directory);
+}
+
+//-----------------------------------------------------------------------------
+QString qCjyxCLIExecutableModuleFactory::moduleDescriptionCacheDirectory()const
+{
+  Q_D(const qCjyxCLIExecutableModuleFactory);
+  return d->ModuleDescriptionCache.cacheDirectory();
+}
+
+//-----------------------------------------------------------------------------
+void qCjyxCLIExecutableModuleFactory::updateModuleDescriptions()
+{
+  Q_D(qCjyxCLIExecutableModuleFactory);
+  QStringList executablePaths;
+  foreach(const QString& key, this->itemKeys())
+    {
+    QString executablePath = this->path(key);
+    if (executablePath.isEmpty() || d->ModuleDescriptionsUpdated.contains(executablePath))
+      {
+      continue;
+      }
+    d->ModuleDescriptionsUpdated.insert(executablePath);
+    if (QFile::exists(xmlModuleDescriptionFilePathForExecutable(executablePath)))
+      {
+      // description is read from file
+      continue;
+      }
+    executablePaths << executablePath;
+    }
+  if (executablePaths.isEmpty())
+    {
+    return;
+    }
+  QElapsedTimer timer;
+  timer.start();
+  int numberOfExecutablesRun = d->ModuleDescriptionCache.updateDescriptions(executablePaths);
+  if (d->ProfilingEnabled)
+    {
+    qDebug().nospace() << "CLI module descriptions: " << executablePaths.count() - numberOfExecutablesRun
+      << " found in cache, " << numberOfExecutablesRun << " retrieved from executables in "
+      << timer.elapsed() << " ms";
+    }
+}
+
+//-----------------------------------------------------------------------------
+void qCjyxCLIExecutableModuleFactory::setProfilingEnabled(bool enabled)
+{
+  Q_D(qCjyxCLIExecutableModuleFactory);
+  d->ProfilingEnabled = enabled;
+}
+
+//-----------------------------------------------------------------------------
+bool qCjyxCLIExecutableModuleFactory::profilingEnabled()const
+{
+  Q_D(const qCjyxCLIExecutableModuleFactory);
+  return d->ProfilingEnabled;
+}
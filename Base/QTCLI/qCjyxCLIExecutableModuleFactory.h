@@ -24,7 +24,9 @@
 // Cjyx includes
 #include "qCjyxAbstractCoreModule.h"
 #include "qCjyxBaseQTCLIExport.h"
+class qCjyxCLIExecutableModuleFactory;
 class qCjyxCLIModule;
+class qCjyxCLIModuleDescriptionCache;
 
 // CTK includes
 #include <ctkPimpl.h>
@@ -35,7 +37,8 @@ class qCjyxCLIExecutableModuleFactoryItem
   : public ctkAbstractFactoryFileBasedItem<qCjyxAbstractCoreModule>
 {
 public:
-  qCjyxCLIExecutableModuleFactoryItem(const QString& newTempDirectory);
+  qCjyxCLIExecutableModuleFactoryItem(const QString& newTempDirectory,
+    qCjyxCLIExecutableModuleFactory* factory = nullptr);
   bool load() override;
   void uninstantiate() override;
 protected:
@@ -43,10 +46,13 @@ protected:
   QString xmlModuleDescriptionFilePath();
 
   qCjyxAbstractCoreModule* instanciator() override;
+  /// Return the description retrieved by running the executable with "--xml".
+  /// The factory's description cache is used if available.
   QString runCLIWithXmlArgument();
 private:
   QString TempDirectory;
   qCjyxCLIModule* CLIModule;
+  qCjyxCLIExecutableModuleFactory* Factory;
 };
 
 class qCjyxCLIExecutableModuleFactoryPrivate;
@@ -71,6 +77,26 @@ public:
 
   void setTempDirectory(const QString& newTempDirectory);
 
+  /// Cache of descriptions that are retrieved by running CLI executables with "--xml"
+  /// (executables that have no XML description file next to them).
+  qCjyxCLIModuleDescriptionCache* moduleDescriptionCache();
+
+  /// Directory where module descriptions are stored, so that they do not have to be
+  /// retrieved again from unchanged executables at next application startup.
+  /// Descriptions are not stored if empty (default).
+  void setModuleDescriptionCacheDirectory(const QString& directory);
+  QString moduleDescriptionCacheDirectory()const;
+
+  /// Retrieve descriptions of all registered executables that have no XML description
+  /// file and no valid entry in the description cache. Executables are run concurrently.
+  /// It is called automatically when the first module is instantiated.
+  void updateModuleDescriptions();
+
+  /// Print number of cached and retrieved module descriptions and time spent
+  /// with retrieving them. Disabled by default.
+  void setProfilingEnabled(bool enabled);
+  bool profilingEnabled()const;
+
 protected:
   bool isValidFile(const QFileInfo& file)const override;
 
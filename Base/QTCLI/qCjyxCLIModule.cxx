@@ -103,6 +103,12 @@ vtkDMMLAbstractLogic* qCjyxCLIModule::createLogic()
     logic->SetAllowInMemoryTransfer(0);
     }
 
+  // Shared memory transfer is only used by CLIs that support it
+  if (d->Desc.GetParameterValue("AllowSharedMemoryTransfer") == "true")
+    {
+    logic->SetAllowSharedMemoryTransfer(1);
+    }
+
   return logic;
 }
 
@@ -0,0 +1,353 @@
+/*==============================================================================
+
+  Program: 3D Cjyx
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QProcess>
+#include <QSaveFile>
+#include <QSharedPointer>
+#include <QTextStream>
+#include <QThread>
+#include <QVector>
+
+// Cjyx includes
+#include "qCjyxCLIModuleDescriptionCache.h"
+
+//-----------------------------------------------------------------------------
+class qCjyxCLIModuleDescriptionCachePrivate
+{
+public:
+  qCjyxCLIModuleDescriptionCachePrivate();
+
+  /// Name of the cache file that stores description of the executable.
+  /// Size and modification time of the executable are part of the name,
+  /// therefore the entry is not found after the executable is modified.
+  QString cacheFileName(const QFileInfo& executable)const;
+  /// Name prefix that is common in all cache files of the executable
+  QString cacheFileNamePrefix(const QFileInfo& executable)const;
+
+  QSharedPointer<QProcess> startExecutable(const QString& executablePath)const;
+  qCjyxCLIModuleDescriptionCache::Result finishExecutable(
+    QProcess* cli, const QString& executablePath)const;
+  /// Returns true if the description retrieved by running the executable can be stored in the cache.
+  bool isCacheable(const qCjyxCLIModuleDescriptionCache::Result& result)const;
+
+  QString CacheDirectory;
+  int Timeout;
+  int MaximumNumberOfProcesses;
+  QHash<QString, qCjyxCLIModuleDescriptionCache::Result> Results;
+};
+
+//-----------------------------------------------------------------------------
+qCjyxCLIModuleDescriptionCachePrivate::qCjyxCLIModuleDescriptionCachePrivate()
+{
+  this->Timeout = 5000;
+  this->MaximumNumberOfProcesses = qMax(QThread::idealThreadCount(), 1);
+}
+
+//-----------------------------------------------------------------------------
+QString qCjyxCLIModuleDescriptionCachePrivate::cacheFileNamePrefix(const QFileInfo& executable)const
+{
+  return QString(QCryptographicHash::hash(executable.absoluteFilePath().toUtf8(), QCryptographicHash::Sha1).toHex());
+}
+
+//-----------------------------------------------------------------------------
+QString qCjyxCLIModuleDescriptionCachePrivate::cacheFileName(const QFileInfo& executable)const
+{
+  return QString("%1-%2-%3.xml")
+    .arg(this->cacheFileNamePrefix(executable))
+    .arg(executable.size())
+    .arg(executable.lastModified().toMSecsSinceEpoch());
+}
+
+//-----------------------------------------------------------------------------
+QSharedPointer<QProcess> qCjyxCLIModuleDescriptionCachePrivate::startExecutable(const QString& executablePath)const
+{
+  QSharedPointer<QProcess> cli(new QProcess);
+  QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+  env.insert("ITK_AUTOLOAD_PATH", "");
+  cli->setProcessEnvironment(env);
+  cli->setWorkingDirectory(QFileInfo(executablePath).path());
+  cli->start(executablePath, QStringList(QString("--xml")));
+  return cli;
+}
+
+//-----------------------------------------------------------------------------
+qCjyxCLIModuleDescriptionCache::Result qCjyxCLIModuleDescriptionCachePrivate::finishExecutable(
+  QProcess* cli, const QString& executablePath)const
+{
+  qCjyxCLIModuleDescriptionCache::Result result;
+  bool res = cli->waitForFinished(this->Timeout);
+  if (!res)
+    {
+    result.ErrorStrings << QString("CLI executable: %1").arg(executablePath);
+    QString errorString;
+    switch(cli->error())
+      {
+      case QProcess::FailedToStart:
+        errorString = QLatin1String(
+              "The process failed to start. Either the invoked program is missing, or "
+              "you may have insufficient permissions to invoke the program.");
+        break;
+      case QProcess::Crashed:
+        errorString = QLatin1String(
+              "The process crashed some time after starting successfully.");
+        break;
+      case QProcess::Timedout:
+        errorString = QString(
+              "The process timed out after %1 msecs.").arg(this->Timeout);
+        break;
+      case QProcess::WriteError:
+        errorString = QLatin1String(
+              "An error occurred when attempting to read from the process. "
+              "For example, the process may not be running.");
+        break;
+      case QProcess::ReadError:
+        errorString = QLatin1String(
+              "An error occurred when attempting to read from the process. "
+              "For example, the process may not be running.");
+        break;
+      case QProcess::UnknownError:
+        errorString = QLatin1String(
+              "Failed to execute process. An unknown error occurred.");
+        break;
+      }
+    result.ErrorStrings << errorString;
+    cli->kill();
+    cli->waitForFinished();
+    return result;
+    }
+  QString errors = cli->readAllStandardError();
+  if (!errors.isEmpty())
+    {
+    result.ErrorStrings << QString("CLI executable: %1").arg(executablePath);
+    result.ErrorStrings << errors;
+    // TODO: More investigation for the following behavior:
+    // on my machine (Ubuntu 10.04 with ITKv4), having standard error trims the
+    // standard output results. The following readAllStandardOutput() is then
+    // missing chars and makes the XML invalid. I'm not sure if it's just on my
+    // machine so there is a chance it succeeds to parse the XML description
+    // on other machines.
+    }
+  QString xmlDescription = cli->readAllStandardOutput();
+  if (xmlDescription.isEmpty())
+    {
+    result.ErrorStrings << QString("CLI executable: %1").arg(executablePath);
+    result.ErrorStrings << QLatin1String("Failed to retrieve Xml Description");
+    return result;
+    }
+  if (!xmlDescription.startsWith("<?xml"))
+    {
+    result.WarningStrings << QString("CLI executable: %1").arg(executablePath);
+    result.WarningStrings << QLatin1String("XML description doesn't start right away.");
+    result.WarningStrings << QString("Output before '<?xml' is [%1]").arg(
+                               xmlDescription.mid(0, xmlDescription.indexOf("<?xml")));
+    xmlDescription.remove(0, xmlDescription.indexOf("<?xml"));
+    }
+  result.XmlDescription = xmlDescription;
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+bool qCjyxCLIModuleDescriptionCachePrivate::isCacheable(const qCjyxCLIModuleDescriptionCache::Result& result)const
+{
+  // Output on standard error may truncate the standard output (see finishExecutable),
+  // so the description is only stored if the executable reported no errors.
+  // Otherwise the executable is run again at next startup.
+  return !result.XmlDescription.isEmpty() && result.ErrorStrings.isEmpty();
+}
+
+//-----------------------------------------------------------------------------
+// qCjyxCLIModuleDescriptionCache
+
+//-----------------------------------------------------------------------------
+qCjyxCLIModuleDescriptionCache::qCjyxCLIModuleDescriptionCache()
+  : d_ptr(new qCjyxCLIModuleDescriptionCachePrivate)
+{
+}
+
+//-----------------------------------------------------------------------------
+qCjyxCLIModuleDescriptionCache::~qCjyxCLIModuleDescriptionCache() = default;
+
+//-----------------------------------------------------------------------------
+void qCjyxCLIModuleDescriptionCache::setCacheDirectory(const QString& directory)
+{
+  Q_D(qCjyxCLIModuleDescriptionCache);
+  d->CacheDirectory = directory;
+}
+
+//-----------------------------------------------------------------------------
+QString qCjyxCLIModuleDescriptionCache::cacheDirectory()const
+{
+  Q_D(const qCjyxCLIModuleDescriptionCache);
+  return d->CacheDirectory;
+}
+
+//-----------------------------------------------------------------------------
+void qCjyxCLIModuleDescriptionCache::setTimeout(int timeoutInMs)
+{
+  Q_D(qCjyxCLIModuleDescriptionCache);
+  d->Timeout = timeoutInMs;
+}
+
+//-----------------------------------------------------------------------------
+int qCjyxCLIModuleDescriptionCache::timeout()const
+{
+  Q_D(const qCjyxCLIModuleDescriptionCache);
+  return d->Timeout;
+}
+
+//-----------------------------------------------------------------------------
+void qCjyxCLIModuleDescriptionCache::setMaximumNumberOfProcesses(int count)
+{
+  Q_D(qCjyxCLIModuleDescriptionCache);
+  d->MaximumNumberOfProcesses = qMax(count, 1);
+}
+
+//-----------------------------------------------------------------------------
+int qCjyxCLIModuleDescriptionCache::maximumNumberOfProcesses()const
+{
+  Q_D(const qCjyxCLIModuleDescriptionCache);
+  return d->MaximumNumberOfProcesses;
+}
+
+//-----------------------------------------------------------------------------
+QString qCjyxCLIModuleDescriptionCache::cachedDescription(const QString& executablePath)const
+{
+  Q_D(const qCjyxCLIModuleDescriptionCache);
+  QFileInfo executable(executablePath);
+  if (d->CacheDirectory.isEmpty() || !executable.exists())
+    {
+    return QString();
+    }
+  QFile xmlFile(QDir(d->CacheDirectory).filePath(d->cacheFileName(executable)));
+  if (!xmlFile.open(QIODevice::ReadOnly))
+    {
+    return QString();
+    }
+  return QTextStream(&xmlFile).readAll();
+}
+
+//-----------------------------------------------------------------------------
+bool qCjyxCLIModuleDescriptionCache::setCachedDescription(const QString& executablePath, const QString& xmlDescription)
+{
+  Q_D(qCjyxCLIModuleDescriptionCache);
+  QFileInfo executable(executablePath);
+  if (d->CacheDirectory.isEmpty() || !executable.exists())
+    {
+    return false;
+    }
+  QDir cacheDir(d->CacheDirectory);
+  if (!cacheDir.exists() && !cacheDir.mkpath("."))
+    {
+    return false;
+    }
+  // Remove entries of previous versions of the executable
+  QString cacheFileName = d->cacheFileName(executable);
+  foreach(const QString& outdatedFileName,
+    cacheDir.entryList(QStringList() << d->cacheFileNamePrefix(executable) + "-*.xml", QDir::Files))
+    {
+    if (outdatedFileName != cacheFileName)
+      {
+      cacheDir.remove(outdatedFileName);
+      }
+    }
+  // Write to a temporary file first so that other application instances never read a partial description
+  QSaveFile xmlFile(cacheDir.filePath(cacheFileName));
+  if (!xmlFile.open(QIODevice::WriteOnly))
+    {
+    return false;
+    }
+  xmlFile.write(xmlDescription.toUtf8());
+  return xmlFile.commit();
+}
+
+//-----------------------------------------------------------------------------
+qCjyxCLIModuleDescriptionCache::Result qCjyxCLIModuleDescriptionCache::description(const QString& executablePath)
+{
+  Q_D(qCjyxCLIModuleDescriptionCache);
+  if (d->Results.contains(executablePath))
+    {
+    return d->Results.take(executablePath);
+    }
+  Result result;
+  result.XmlDescription = this->cachedDescription(executablePath);
+  if (!result.XmlDescription.isEmpty())
+    {
+    return result;
+    }
+  result = this->runExecutables(QStringList() << executablePath).value(executablePath);
+  if (d->isCacheable(result))
+    {
+    this->setCachedDescription(executablePath, result.XmlDescription);
+    }
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+int qCjyxCLIModuleDescriptionCache::updateDescriptions(const QStringList& executablePaths)
+{
+  Q_D(qCjyxCLIModuleDescriptionCache);
+  QStringList executablesToRun;
+  foreach(const QString& executablePath, executablePaths)
+    {
+    if (d->Results.contains(executablePath) || executablesToRun.contains(executablePath)
+      || !this->cachedDescription(executablePath).isEmpty())
+      {
+      continue;
+      }
+    executablesToRun << executablePath;
+    }
+  QHash<QString, Result> results = this->runExecutables(executablesToRun);
+  for (QHash<QString, Result>::const_iterator it = results.constBegin(); it != results.constEnd(); ++it)
+    {
+    if (d->isCacheable(it.value()))
+      {
+      this->setCachedDescription(it.key(), it.value().XmlDescription);
+      }
+    d->Results[it.key()] = it.value();
+    }
+  return executablesToRun.count();
+}
+
+//-----------------------------------------------------------------------------
+QHash<QString, qCjyxCLIModuleDescriptionCache::Result> qCjyxCLIModuleDescriptionCache::runExecutables(
+  const QStringList& executablePaths)const
+{
+  Q_D(const qCjyxCLIModuleDescriptionCache);
+  QHash<QString, Result> results;
+  // Processes are started in order and at most MaximumNumberOfProcesses are running at the same time.
+  // Output of each process is collected in the same order as processes are started.
+  QVector< QSharedPointer<QProcess> > processes(executablePaths.count());
+  int numberOfStartedProcesses = 0;
+  for (; numberOfStartedProcesses < qMin(d->MaximumNumberOfProcesses, executablePaths.count()); ++numberOfStartedProcesses)
+    {
+    processes[numberOfStartedProcesses] = d->startExecutable(executablePaths[numberOfStartedProcesses]);
+    }
+  for (int processIndex = 0; processIndex < executablePaths.count(); ++processIndex)
+    {
+    results[executablePaths[processIndex]] = d->finishExecutable(processes[processIndex].data(), executablePaths[processIndex]);
+    processes[processIndex].reset();
+    if (numberOfStartedProcesses < executablePaths.count())
+      {
+      processes[numberOfStartedProcesses] = d->startExecutable(executablePaths[numberOfStartedProcesses]);
+      ++numberOfStartedProcesses;
+      }
+    }
+  return results;
+}
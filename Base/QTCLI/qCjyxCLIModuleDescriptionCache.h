@@ -0,0 +1,100 @@
+/*==============================================================================
+
+  Program: 3D Cjyx
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __qCjyxCLIModuleDescriptionCache_h
+#define __qCjyxCLIModuleDescriptionCache_h
+
+// Qt includes
+#include <QHash>
+#include <QScopedPointer>
+#include <QStringList>
+
+// CTK includes
+#include <ctkPimpl.h>
+
+#include "qCjyxBaseQTCLIExport.h"
+
+class qCjyxCLIModuleDescriptionCachePrivate;
+
+/// \brief Persistent cache of XML descriptions of CLI executables.
+///
+/// The description of a CLI executable that has no XML file next to it is retrieved
+/// by running the executable with "--xml". Doing this for all CLI modules at each
+/// application startup takes several seconds, therefore retrieved descriptions are
+/// stored in a cache directory and reused at next startup.
+/// A cache entry is keyed by the executable path and it is only used if the size and
+/// last modification time of the executable have not changed.
+class Q_CJYX_BASE_QTCLI_EXPORT qCjyxCLIModuleDescriptionCache
+{
+public:
+  qCjyxCLIModuleDescriptionCache();
+  virtual ~qCjyxCLIModuleDescriptionCache();
+
+  /// Outcome of retrieving the description of an executable
+  struct Result
+    {
+    QString XmlDescription;
+    QStringList ErrorStrings;
+    QStringList WarningStrings;
+    };
+
+  /// Directory where descriptions are stored.
+  /// Descriptions are only kept in memory if empty (default).
+  void setCacheDirectory(const QString& directory);
+  QString cacheDirectory()const;
+
+  /// Maximum time (in milliseconds) an executable may run to return its description.
+  /// Default is 5000.
+  void setTimeout(int timeoutInMs);
+  int timeout()const;
+
+  /// Maximum number of executables that are run at the same time.
+  /// Default is the number of processor cores.
+  void setMaximumNumberOfProcesses(int count);
+  int maximumNumberOfProcesses()const;
+
+  /// Return the description of the executable that is stored in the cache.
+  /// Returns an empty string if there is no entry for the executable or if the
+  /// executable has been modified since the entry was stored.
+  QString cachedDescription(const QString& executablePath)const;
+
+  /// Store description of the executable in the cache.
+  /// Returns false if the description could not be written to the cache directory.
+  bool setCachedDescription(const QString& executablePath, const QString& xmlDescription);
+
+  /// Return the description of the executable: from the descriptions retrieved
+  /// by updateDescriptions(), from the cache, or by running the executable.
+  Result description(const QString& executablePath);
+
+  /// Run all executables that have no valid cache entry with "--xml" concurrently
+  /// and store the retrieved descriptions in the cache.
+  /// Descriptions of executables that reported errors are not stored in the cache.
+  /// Results are kept in memory until they are requested by description().
+  /// Returns the number of executables that had to be run.
+  int updateDescriptions(const QStringList& executablePaths);
+
+  /// Run executables with "--xml" concurrently and return the retrieved descriptions.
+  /// The cache is not used.
+  QHash<QString, Result> runExecutables(const QStringList& executablePaths)const;
+
+protected:
+  QScopedPointer<qCjyxCLIModuleDescriptionCachePrivate> d_ptr;
+
+private:
+  Q_DECLARE_PRIVATE(qCjyxCLIModuleDescriptionCache);
+  Q_DISABLE_COPY(qCjyxCLIModuleDescriptionCache);
+};
+
+#endif
@@ -29,9 +29,15 @@
 #include <vtkDMMLStorageNode.h>
 #include <vtkDMMLModelStorageNode.h>
 #include <vtkDMMLTransformNode.h>
+#include <vtkDMMLVolumeNode.h>
+
+// DMMLIDImageIO includes
+#include <itkDMMLIDImageIO.h>
+#include <itkDMMLSharedMemoryImageIO.h>
 
 // VTK includes
 #include <vtkCallbackCommand.h>
+#include <vtkImageData.h>
 #include <vtkIntArray.h>
 #include <vtkMultiThreader.h>
 #include <vtkNew.h>
@@ -75,6 +81,45 @@ struct DigitsToCharacters
     }
 };
 
+//----------------------------------------------------------------------------
+// Processing tasks may run CLI modules concurrently, on multiple threads
+// and from multiple module logics. These locks protect process-wide state
+// that ApplyTask temporarily modifies.
+
+// Protects the environment variables that are modified while a command line
+// module process is launched (the process inherits the environment at launch)
+static std::mutex CLIEnvironmentLock;
+
+// Serializes execution of shared object modules whose output is captured by
+// redirecting std::cout and std::cerr
+static std::mutex CLIModuleStreamsLock;
+
+//----------------------------------------------------------------------------
+// Remove the shared memory images of a list of temporary files when the
+// module execution ends. Unlike files, shared memory segments hold system
+// memory until they are removed, so they are removed even if the
+// execution is aborted or temporary files are kept.
+class SharedMemoryImageRemover
+{
+public:
+  SharedMemoryImageRemover(const std::set<std::string>& fileNames)
+    : FileNames(fileNames)
+  {
+  }
+  ~SharedMemoryImageRemover()
+  {
+    for (const std::string& fileName : this->FileNames)
+      {
+      if (itk::DMMLSharedMemoryImageIO::IsSharedMemoryFileName(fileName.c_str()))
+        {
+        itk::DMMLSharedMemoryImageIO::RemoveSharedMemory(fileName.c_str());
+        }
+      }
+  }
+private:
+  const std::set<std::string>& FileNames;
+};
+
 typedef std::pair<vtkCjyxCLIModuleLogic *, vtkDMMLCommandLineModuleNode *> LogicNodePair;
 class DMMLIDMap : public std::map<std::string, std::string> {};
 
@@ -195,10 +240,15 @@ public:
   ModuleDescription DefaultModuleDescription;
   int DeleteTemporaryFiles;
   int AllowInMemoryTransfer;
+  int AllowSharedMemoryTransfer;
 
   int RedirectModuleStreams;
 
+  /// Return a random alphanumeric string of the given length (thread-safe)
+  std::string GenerateRandomCode(int length);
+
   std::default_random_engine RandomGenerator;
+  std::mutex RandomGeneratorLock;
 
   std::mutex ProcessesKillLock;
   std::vector<itksysProcess*> Processes;
@@ -296,6 +346,23 @@ public:
   vtkSmartPointer<vtkCjyxCLIOneShotCallbackCallback>OneShotCallbackCallback;
 };
 
+//----------------------------------------------------------------------------
+std::string vtkCjyxCLIModuleLogic::vtkInternal::GenerateRandomCode(int length)
+{
+  static const char alphanum[] =
+      "0123456789"
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+      "abcdefghijklmnopqrstuvwxyz";
+
+  std::lock_guard<std::mutex> lock(this->RandomGeneratorLock);
+  std::string code;
+  for (int ii = 0; ii < length; ii++)
+    {
+    code += alphanum[this->RandomGenerator() % (sizeof(alphanum)-1)];
+    }
+  return code;
+}
+
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkCjyxCLIModuleLogic);
 
@@ -308,6 +375,7 @@ vtkCjyxCLIModuleLogic::vtkCjyxCLIModuleLogic()
 
   this->Internal->DeleteTemporaryFiles = 1;
   this->Internal->AllowInMemoryTransfer = 1;
+  this->Internal->AllowSharedMemoryTransfer = 0;
   this->Internal->RedirectModuleStreams = 1;
   this->Internal->RescheduleCallback =
     vtkSmartPointer<vtkCjyxCLIRescheduleCallback>::New();
@@ -411,6 +479,22 @@ int vtkCjyxCLIModuleLogic::GetAllowInMemoryTransfer() const
   return this->Internal->AllowInMemoryTransfer;
 }
 
+//----------------------------------------------------------------------------
+void vtkCjyxCLIModuleLogic::SetAllowSharedMemoryTransfer(int value)
+{
+  vtkDebugMacro(<< this->GetClassName() << " (" << this << "): setting AllowSharedMemoryTransfer to " << value);
+  if (this->Internal->AllowSharedMemoryTransfer != value)
+    {
+    this->Internal->AllowSharedMemoryTransfer = value;
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkCjyxCLIModuleLogic::GetAllowSharedMemoryTransfer() const
+{
+  return this->Internal->AllowSharedMemoryTransfer;
+}
+
 //----------------------------------------------------------------------------
 void vtkCjyxCLIModuleLogic::RedirectModuleStreamsOn()
 {
@@ -494,7 +578,8 @@ vtkCjyxCLIModuleLogic
                              const std::string& type,
                              const std::string& name,
                              const std::vector<std::string>& extensions,
-                             CommandLineModuleType commandType)
+                             CommandLineModuleType commandType,
+                             bool sharedMemoryTransfer)
 {
   std::string fname = name;
   std::string pid;
@@ -511,7 +596,13 @@ vtkCjyxCLIModuleLogic
   // in the process space of Cjyx.  The Python module can be given
   // DMML node ID's directly.
   //
-  // 3. If the consumer of the file cannot communicate directly with
+  // 3. If the consumer of the file is a command line module executable
+  // that can load the shared memory ImageIO plugin, then volumes are
+  // encoded as cjyxshm:/<pid>_<random code>, the name of a shared memory
+  // segment that contains the image and its geometry. The name is unique
+  // per module execution.
+  //
+  // 4. If the consumer of the file cannot communicate directly with
   // the DMML scene, then a real temporary filename is constructed.
   // The filename will point to the Temporary directory defined for
   // Cjyx. The filename will be unique to the process (multiple
@@ -551,6 +642,22 @@ vtkCjyxCLIModuleLogic
     }
   fname = temporaryDirectory + "/" + pid + "_" + fname;
 
+  if (tag == "image" && sharedMemoryTransfer && commandType == CommandLineModule
+      && type != "dynamic-contrast-enhanced")
+    {
+    // Only images without additional metadata (such as diffusion
+    // gradients) can be passed through shared memory
+    vtkDMMLNode* node = this->GetDMMLScene() ? this->GetDMMLScene()->GetNodeByID(name) : nullptr;
+    if (node && (!strcmp(node->GetClassName(), "vtkDMMLScalarVolumeNode")
+      || !strcmp(node->GetClassName(), "vtkDMMLLabelMapVolumeNode")
+      || !strcmp(node->GetClassName(), "vtkDMMLVectorVolumeNode")))
+      {
+      // Keep the name short, segment names are limited to 31 characters on macOS
+      return std::string(itk::DMMLSharedMemoryImageIO::GetScheme()) + "/" + pidString.str() + "_"
+        + this->Internal->GenerateRandomCode(10);
+      }
+    }
+
   if (tag == "image")
     {
     if ( commandType == CommandLineModule
@@ -913,6 +1020,26 @@ void vtkCjyxCLIModuleLogic::ApplyTask(void *clientdata)
 
   // vector of files to delete
   std::set<std::string> filesToDelete;
+  SharedMemoryImageRemover sharedMemoryImageRemover(filesToDelete);
+
+  // Volumes are passed to command line module executables through shared
+  // memory if the CLI can load the shared memory ImageIO plugin. CLIs run
+  // by an interpreter (e.g. Python CLIs) use temporary files.
+  std::string sharedMemoryAutoLoadPath;
+  bool sharedMemoryTransfer = false;
+  if (commandType == CommandLineModule
+      && this->GetAllowSharedMemoryTransfer() != 0
+      && itk::DMMLSharedMemoryImageIO::IsSharedMemorySupported()
+      && (node0->GetModuleDescription().GetLocation().empty()
+          || node0->GetModuleDescription().GetLocation() == node0->GetModuleDescription().GetTarget()))
+    {
+    std::string autoLoadPath;
+    itksys::SystemTools::GetEnv("ITK_AUTOLOAD_PATH", autoLoadPath);
+    sharedMemoryAutoLoadPath = this->GetSharedMemoryAutoLoadPath(autoLoadPath);
+    sharedMemoryTransfer = !sharedMemoryAutoLoadPath.empty();
+    }
+  // Temporary files used for input volumes that cannot be written into shared memory
+  DMMLIDToFileNameMap sharedMemoryFallbackFiles;
 
   // iterators for parameter groups
   std::vector<ModuleParameterGroup>::iterator pgbeginit
@@ -961,12 +1088,22 @@ void vtkCjyxCLIModuleLogic::ApplyTask(void *clientdata)
                                              (*pit).GetType(),
                                              id,
                                              (*pit).GetFileExtensions(),
-                                             commandType);
+                                             commandType,
+                                             sharedMemoryTransfer);
 
         filesToDelete.insert(fname);
         if ((*pit).GetChannel() == "input")
           {
           nodesToWrite[id] = fname;
+          if (itk::DMMLSharedMemoryImageIO::IsSharedMemoryFileName(fname.c_str()))
+            {
+            sharedMemoryFallbackFiles[id]
+              = this->ConstructTemporaryFileName((*pit).GetTag(),
+                                                 (*pit).GetType(),
+                                                 id,
+                                                 (*pit).GetFileExtensions(),
+                                                 commandType);
+            }
           }
         else if ((*pit).GetChannel() == "output")
           {
@@ -1072,6 +1209,22 @@ void vtkCjyxCLIModuleLogic::ApplyTask(void *clientdata)
       // Default case for CommandLineModule is to use a storage node
       out = defaultOut;
       }
+    if (itk::DMMLSharedMemoryImageIO::IsSharedMemoryFileName((*id2fn0).second.c_str()))
+      {
+      if (this->WriteSharedMemoryImage(nd, (*id2fn0).second))
+        {
+        out = nullptr;
+        }
+      else
+        {
+        // Shared memory cannot be used, fall back to a temporary file
+        std::string fallbackFileName = sharedMemoryFallbackFiles[(*id2fn0).first];
+        vtkWarningMacro("Failed to write " << (*id2fn0).first << " into shared memory, using temporary file "
+                        << fallbackFileName);
+        filesToDelete.insert(fallbackFileName);
+        nodesToWrite[(*id2fn0).first] = fallbackFileName;
+        }
+      }
     if ((commandType == SharedObjectModule) && defaultOut)
       {
       //std::cerr << nd->GetName() << " is " << nd->GetClassName() << std::endl;
@@ -1264,18 +1417,8 @@ void vtkCjyxCLIModuleLogic::ApplyTask(void *clientdata)
     pidString << getpid();
 #endif
 
-    static const char alphanum[] =
-        "0123456789"
-        "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-        "abcdefghijklmnopqrstuvwxyz";
-
-    std::ostringstream code;
-    for (int ii = 0; ii < 10; ii++)
-      {
-      code << alphanum[this->Internal->RandomGenerator() % (sizeof(alphanum)-1)];
-      }
     std::string returnFile = temporaryDirectory + "/" + pidString.str()
-      + "_" + code.str() + ".params";
+      + "_" + this->Internal->GenerateRandomCode(10) + ".params";
 
     commandLineAsString.push_back( returnFile );
 
@@ -1757,9 +1900,18 @@ void vtkCjyxCLIModuleLogic::ApplyTask(void *clientdata)
     // statically linked to the executable.
     // Historically, there was an nvidia driver bug that causes the module
     // to fail on exit with undefined symbol.
+    // If volumes are passed through shared memory, then only the
+    // DMMLSharedMemoryIOPlugin (that only depends on ITK) is loaded.
+    // The environment is shared by all threads, therefore it is locked until
+    // the process is launched and the original value is restored.
+    std::unique_lock<std::mutex> environmentLock(CLIEnvironmentLock);
      std::string saveITKAutoLoadPath;
      itksys::SystemTools::GetEnv("ITK_AUTOLOAD_PATH", saveITKAutoLoadPath);
      std::string emptyString("ITK_AUTOLOAD_PATH=");
+     if (sharedMemoryTransfer)
+       {
+       emptyString += sharedMemoryAutoLoadPath;
+       }
      int putSuccess =
        itksys::SystemTools::PutEnv(const_cast <char *> (emptyString.c_str()));
      if (!putSuccess)
@@ -1771,7 +1923,9 @@ void vtkCjyxCLIModuleLogic::ApplyTask(void *clientdata)
     //
     itksysProcess *process = itksysProcess_New();
 
+    this->Internal->ProcessesKillLock.lock();
     this->Internal->Processes.push_back(process);
+    this->Internal->ProcessesKillLock.unlock();
 
     // setup the command
     itksysProcess_SetCommand(process, command);
@@ -1793,6 +1947,7 @@ void vtkCjyxCLIModuleLogic::ApplyTask(void *clientdata)
       {
       vtkErrorMacro( "Unable to restore ITK_AUTOLOAD_PATH. ");
       }
+    environmentLock.unlock();
 
     // Wait for the command to finish
     char *tbuffer;
@@ -1819,8 +1974,10 @@ void vtkCjyxCLIModuleLogic::ApplyTask(void *clientdata)
       if (node0->GetModuleDescription().GetProcessInformation()->Abort)
         {
         itksysProcess_Kill(process);
+        this->Internal->ProcessesKillLock.lock();
         this->Internal->Processes.erase(
               std::find(this->Internal->Processes.begin(), this->Internal->Processes.end(), process));
+        this->Internal->ProcessesKillLock.unlock();
         node0->GetModuleDescription().GetProcessInformation()->Progress = 0;
         node0->GetModuleDescription().GetProcessInformation()->StageProgress =0;
         this->GetApplicationLogic()->RequestModified( node0 );
@@ -2077,6 +2234,13 @@ void vtkCjyxCLIModuleLogic::ApplyTask(void *clientdata)
     //
     //
 
+    // std::cout and std::cerr are shared by all threads, therefore only one
+    // module can run with redirected streams at a time.
+    std::unique_lock<std::mutex> streamsLock(CLIModuleStreamsLock, std::defer_lock);
+    if (this->Internal->RedirectModuleStreams)
+      {
+      streamsLock.lock();
+      }
     std::ostringstream coutstringstream;
     std::ostringstream cerrstringstream;
     std::streambuf* origcoutrdbuf = std::cout.rdbuf();
@@ -2141,8 +2305,11 @@ void vtkCjyxCLIModuleLogic::ApplyTask(void *clientdata)
         this->GetApplicationLogic()->RequestModified( node0 );
         }
 
-      std::cout.rdbuf( origcoutrdbuf );
-      std::cerr.rdbuf( origcerrrdbuf );
+      if (this->Internal->RedirectModuleStreams)
+        {
+        std::cout.rdbuf( origcoutrdbuf );
+        std::cerr.rdbuf( origcerrrdbuf );
+        }
       }
     catch (...)
       {
@@ -2153,8 +2320,11 @@ void vtkCjyxCLIModuleLogic::ApplyTask(void *clientdata)
       node0->SetStatus(vtkDMMLCommandLineModuleNode::CompletedWithErrors, false);
       this->GetApplicationLogic()->RequestModified( node0 );
 
-      std::cout.rdbuf( origcoutrdbuf );
-      std::cerr.rdbuf( origcerrrdbuf );
+      if (this->Internal->RedirectModuleStreams)
+        {
+        std::cout.rdbuf( origcoutrdbuf );
+        std::cerr.rdbuf( origcerrrdbuf );
+        }
       }
     if (node0->GetStatus() == vtkDMMLCommandLineModuleNode::Cancelling)
       {
@@ -2170,8 +2340,6 @@ void vtkCjyxCLIModuleLogic::ApplyTask(void *clientdata)
       vtkErrorMacro( << information.str().c_str() );
       node0->SetStatus(vtkDMMLCommandLineModuleNode::CompletedWithErrors, false);
       this->GetApplicationLogic()->RequestModified( node0 );
-      std::cout.rdbuf( origcoutrdbuf );
-      std::cerr.rdbuf( origcerrrdbuf );
       }
     }
 
@@ -2210,7 +2378,28 @@ void vtkCjyxCLIModuleLogic::ApplyTask(void *clientdata)
       // miniscene will be handled later
       //
       DMMLIDMap::iterator mit = sceneToMiniSceneMap.find((*id2fn0).first);
-      if (mit == sceneToMiniSceneMap.end())
+      if (mit == sceneToMiniSceneMap.end()
+          && itk::DMMLSharedMemoryImageIO::IsSharedMemoryFileName((*id2fn0).second.c_str()))
+        {
+        // Node is communicated through shared memory. Copy the image into
+        // the node from this thread (modified events are invoked on the main
+        // thread) and request the display of the node as for shared object
+        // modules. The segment is removed with the other temporary files.
+        vtkDMMLNode* node = this->GetDMMLScene()->GetNodeByID((*id2fn0).first);
+        if (!this->ReadSharedMemoryImage((*id2fn0).second, node))
+          {
+          node0->SetStatus(vtkDMMLCommandLineModuleNode::CompletedWithErrors, false);
+          continue;
+          }
+        std::ostringstream nodeFileName;
+        nodeFileName << "cjyx:" << static_cast<void*>(this->GetDMMLScene()) << "#" << (*id2fn0).first;
+        bool displayData = this->IsCommandLineModuleNodeUpdatingDisplay(node0) && !node0->GetAutoRun();
+        vtkMTimeType requestUID = this->GetApplicationLogic()
+          ->RequestReadFile((*id2fn0).first.c_str(), nodeFileName.str().c_str(),
+                            displayData, false);
+        this->Internal->SetLastRequest(node0, requestUID);
+        }
+      else if (mit == sceneToMiniSceneMap.end())
         {
         // Node is not being communicated in the miniscene, load via a file
 
@@ -2427,6 +2616,10 @@ void vtkCjyxCLIModuleLogic::ApplyTask(void *clientdata)
     std::set<std::string>::iterator fit;
     for (fit = filesToDelete.begin(); fit != filesToDelete.end(); ++fit)
       {
+      if (itk::DMMLSharedMemoryImageIO::IsSharedMemoryFileName((*fit).c_str()))
+        {
+        continue;
+        }
       if (itksys::SystemTools::FileExists((*fit).c_str()))
         {
         removed = static_cast<bool>(itksys::SystemTools::RemoveFile((*fit).c_str()));
@@ -2858,3 +3051,103 @@ int vtkCjyxCLIModuleLogic::GetCoordinateSystemFromString(const char* coordinateS
     }
   return coordinateSystem;
 }
+
+//----------------------------------------------------------------------------
+std::string vtkCjyxCLIModuleLogic::GetSharedMemoryAutoLoadPath(const std::string& autoLoadPath) const
+{
+#ifdef _WIN32
+  const char pathSeparator = ';';
+#else
+  const char pathSeparator = ':';
+#endif
+  // DMMLSharedMemoryIOPlugin is in the "SharedMemory" subdirectory of the
+  // ITK factories directory
+  std::string sharedMemoryAutoLoadPath;
+  std::string::size_type start = 0;
+  while (start <= autoLoadPath.size())
+    {
+    std::string::size_type end = autoLoadPath.find(pathSeparator, start);
+    if (end == std::string::npos)
+      {
+      end = autoLoadPath.size();
+      }
+    std::string directory = autoLoadPath.substr(start, end - start);
+    if (!directory.empty())
+      {
+      directory += "/SharedMemory";
+      if (itksys::SystemTools::FileIsDirectory(directory))
+        {
+        if (!sharedMemoryAutoLoadPath.empty())
+          {
+          sharedMemoryAutoLoadPath += pathSeparator;
+          }
+        sharedMemoryAutoLoadPath += directory;
+        }
+      }
+    start = end + 1;
+    }
+  return sharedMemoryAutoLoadPath;
+}
+
+//----------------------------------------------------------------------------
+bool vtkCjyxCLIModuleLogic::WriteSharedMemoryImage(vtkDMMLNode* node, const std::string& fileName)
+{
+  vtkDMMLVolumeNode* volumeNode = vtkDMMLVolumeNode::SafeDownCast(node);
+  if (!volumeNode || !volumeNode->GetImageData() || !volumeNode->GetImageData()->GetScalarPointer())
+    {
+    return false;
+    }
+  std::ostringstream nodeFileName;
+  nodeFileName << "cjyx:" << static_cast<void*>(this->GetDMMLScene()) << "#" << node->GetID();
+  try
+    {
+    // The image is copied directly from the node into the shared memory
+    itk::DMMLIDImageIO::Pointer nodeIO = itk::DMMLIDImageIO::New();
+    nodeIO->SetFileName(nodeFileName.str().c_str());
+    nodeIO->ReadImageInformation();
+    itk::DMMLSharedMemoryImageIO::Pointer sharedMemoryIO = itk::DMMLSharedMemoryImageIO::New();
+    sharedMemoryIO->SetFileName(fileName.c_str());
+    itk::DMMLSharedMemoryImageIO::CopyImageInformation(nodeIO, sharedMemoryIO);
+    sharedMemoryIO->Write(nodeIO->GetOwnBuffer());
+    }
+  catch (itk::ExceptionObject& exc)
+    {
+    vtkErrorMacro("WriteSharedMemoryImage: failed to write " << node->GetID() << " into " << fileName << ": " << exc);
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkCjyxCLIModuleLogic::ReadSharedMemoryImage(const std::string& fileName, vtkDMMLNode* node)
+{
+  if (!vtkDMMLVolumeNode::SafeDownCast(node))
+    {
+    vtkErrorMacro("ReadSharedMemoryImage: invalid volume node for " << fileName);
+    return false;
+    }
+  std::ostringstream nodeFileName;
+  nodeFileName << "cjyx:" << static_cast<void*>(this->GetDMMLScene()) << "#" << node->GetID();
+  try
+    {
+    itk::DMMLSharedMemoryImageIO::Pointer sharedMemoryIO = itk::DMMLSharedMemoryImageIO::New();
+    sharedMemoryIO->SetFileName(fileName.c_str());
+    if (!sharedMemoryIO->CanReadFile(fileName.c_str()))
+      {
+      vtkErrorMacro("ReadSharedMemoryImage: " << node->GetID() << " was not written by the module");
+      return false;
+      }
+    sharedMemoryIO->ReadImageInformation();
+    // The image is copied directly from the shared memory into the node
+    itk::DMMLIDImageIO::Pointer nodeIO = itk::DMMLIDImageIO::New();
+    nodeIO->SetFileName(nodeFileName.str().c_str());
+    itk::DMMLSharedMemoryImageIO::CopyImageInformation(sharedMemoryIO, nodeIO);
+    nodeIO->Write(sharedMemoryIO->GetSharedBuffer());
+    }
+  catch (itk::ExceptionObject& exc)
+    {
+    vtkErrorMacro("ReadSharedMemoryImage: failed to read " << node->GetID() << " from " << fileName << ": " << exc);
+    return false;
+    }
+  return true;
+}
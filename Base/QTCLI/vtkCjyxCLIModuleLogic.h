@@ -91,6 +91,16 @@ public:
   void SetAllowInMemoryTransfer(int value);
   int GetAllowInMemoryTransfer() const;
 
+  /// Control use of shared memory for passing volumes to and from
+  /// command line module executables instead of temporary files.
+  /// Temporary files are used if shared memory is not supported on the
+  /// platform, if the shared memory ImageIO plugin cannot be found in the
+  /// ITK_AUTOLOAD_PATH or if the CLI is run by an interpreter (Python CLI).
+  /// Disabled by default. qCjyxCLIModule enables it for CLIs that declare a
+  /// parameter named "AllowSharedMemoryTransfer" with "true" default value.
+  void SetAllowSharedMemoryTransfer(int value);
+  int GetAllowSharedMemoryTransfer() const;
+
   /// For debugging, control redirection of cout and cerr
   virtual void RedirectModuleStreamsOn();
   virtual void RedirectModuleStreamsOff();
@@ -134,11 +144,15 @@ protected:
   void ProcessDMMLLogicsEvents(vtkObject*, long unsigned int, void*) override;
 
 
+  /// If \a sharedMemoryTransfer is true and the node is a volume that can
+  /// be exchanged through shared memory, then a shared memory segment name
+  /// is returned instead of a temporary file name.
   std::string ConstructTemporaryFileName(const std::string& tag,
                                          const std::string& type,
                                          const std::string& name,
                                      const std::vector<std::string>& extensions,
-                                     CommandLineModuleType commandType);
+                                     CommandLineModuleType commandType,
+                                     bool sharedMemoryTransfer = false);
   std::string ConstructTemporarySceneFileName(vtkDMMLScene *scene);
   std::string FindHiddenNodeID(const ModuleDescription& d,
                                const ModuleParameter& p);
@@ -169,6 +183,19 @@ protected:
 
   int GetCoordinateSystemFromString(const char* coordinateSystemStr)const;
 
+  /// Return the ITK_AUTOLOAD_PATH that only loads the shared memory ImageIO
+  /// plugin in CLIs, or an empty string if the plugin cannot be found.
+  /// \sa SetAllowSharedMemoryTransfer()
+  std::string GetSharedMemoryAutoLoadPath(const std::string& autoLoadPath)const;
+
+  /// Copy the image of a volume node into a shared memory segment.
+  /// Return false if the image could not be written.
+  bool WriteSharedMemoryImage(vtkDMMLNode* node, const std::string& fileName);
+
+  /// Copy the image written by a CLI into a shared memory segment into a
+  /// volume node. Return false if the image could not be read.
+  bool ReadSharedMemoryImage(const std::string& fileName, vtkDMMLNode* node);
+
 private:
   vtkCjyxCLIModuleLogic();
   ~vtkCjyxCLIModuleLogic() override;
@@ -0,0 +1,92 @@
+/*==============================================================================
+
+  Program: 3D Cjyx
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QThread>
+
+// CTK includes
+#include <ctkCoreTestingMacros.h>
+
+// Cjyx includes
+#include "qCjyxAbstractModuleFactoryManager.h"
+
+// STD includes
+#include <cstdlib>
+#include <iostream>
+
+//-----------------------------------------------------------------------------
+int qCjyxAbstractModuleFactoryManagerTest1(int argc, char * argv [])
+{
+  QCoreApplication app(argc, argv);
+
+  qCjyxAbstractModuleFactoryManager factoryManager;
+  CHECK_BOOL(factoryManager.profilingEnabled(), false);
+
+  // Events are not recorded if profiling is disabled
+  factoryManager.beginProfileEvent("Ignored", "load");
+  factoryManager.endProfileEvent();
+
+  // Record nested events
+  factoryManager.setProfilingEnabled(true);
+  CHECK_BOOL(factoryManager.profilingEnabled(), true);
+  factoryManager.beginProfileEvent("Load modules", "startup");
+  {
+    qCjyxScopedModuleProfileEvent moduleEvent(&factoryManager, "ModuleA", "load");
+    QThread::msleep(20);
+    {
+      qCjyxScopedModuleProfileEvent dependencyEvent(&factoryManager, "ModuleB", "load");
+      QThread::msleep(40);
+    }
+  }
+  factoryManager.endProfileEvent();
+  factoryManager.setProfilingEnabled(false);
+
+  // Time spent with loading dependencies is not included in the time of the dependee module
+  QString summary = factoryManager.profileSummary(1);
+  std::cout << qPrintable(summary) << std::endl;
+  CHECK_BOOL(summary.contains("2 modules"), true);
+  CHECK_BOOL(summary.contains("ModuleB"), true);
+  CHECK_BOOL(summary.contains("ModuleA"), false);
+  CHECK_BOOL(summary.contains("Ignored"), false);
+
+  // Write trace file
+  QTemporaryDir tempDir;
+  CHECK_BOOL(tempDir.isValid(), true);
+  QString profileFileName = QDir(tempDir.path()).filePath("StartupProfile.json");
+  CHECK_BOOL(factoryManager.writeProfile(profileFileName), true);
+  QFile profileFile(profileFileName);
+  CHECK_BOOL(profileFile.open(QIODevice::ReadOnly), true);
+  QJsonArray traceEvents = QJsonDocument::fromJson(profileFile.readAll()).object()["traceEvents"].toArray();
+  CHECK_BOOL(traceEvents.count() == 3, true);
+  QJsonObject startupEvent = traceEvents[0].toObject();
+  QJsonObject dependencyEvent = traceEvents[2].toObject();
+  CHECK_QSTRING(startupEvent["name"].toString(), QString("Load modules"));
+  CHECK_QSTRING(dependencyEvent["name"].toString(), QString("ModuleB"));
+  CHECK_QSTRING(dependencyEvent["ph"].toString(), QString("X"));
+  CHECK_BOOL(dependencyEvent["ts"].toDouble() >= startupEvent["ts"].toDouble(), true);
+  CHECK_BOOL(dependencyEvent["dur"].toDouble() <= startupEvent["dur"].toDouble(), true);
+
+  factoryManager.clearProfile();
+  CHECK_BOOL(factoryManager.profileSummary().contains("0 modules"), true);
+
+  return EXIT_SUCCESS;
+}
@@ -19,7 +19,13 @@
 ==============================================================================*/
 
 // Qt includes
+#include <QCoreApplication>
 #include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 
 // Cjyx includes
 #include "qCjyxCoreApplication.h"
@@ -27,6 +33,7 @@
 #include "qCjyxAbstractCoreModule.h"
 
 // STD includes
+#include <algorithm>
 #include <csignal>
 #include <typeinfo>
 
@@ -61,6 +68,20 @@ public:
   QMap<QString, QStringList> ModuleDependees;
 
   bool Verbose;
+
+  struct ProfileEvent
+    {
+    QString Name;
+    QString Category;
+    qint64 StartTime; // in microseconds
+    qint64 Duration; // in microseconds
+    qint64 ChildrenDuration; // time spent in nested events, in microseconds
+    };
+  bool ProfilingEnabled;
+  QElapsedTimer ProfileTimer;
+  QList<ProfileEvent> ProfileEvents;
+  /// Indices of events that have been started but not ended yet
+  QList<int> OpenProfileEvents;
 };
 
 //-----------------------------------------------------------------------------
@@ -69,6 +90,7 @@ qCjyxAbstractModuleFactoryManagerPrivate::qCjyxAbstractModuleFactoryManagerPriva
   : q_ptr(&object)
 {
   this->Verbose = false;
+  this->ProfilingEnabled = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -250,6 +272,7 @@ QStringList qCjyxAbstractModuleFactoryManager::ignoredModuleNames()const
 void qCjyxAbstractModuleFactoryManager::registerModules()
 {
   Q_D(qCjyxAbstractModuleFactoryManager);
+  qCjyxScopedModuleProfileEvent profileEvent(this, "Register modules", "register");
   // Register "regular" factories first
   // \todo: don't support factories other than filebased factories
   foreach(qCjyxModuleFactory* factory, d->notFileBasedFactories())
@@ -400,6 +423,7 @@ qCjyxAbstractCoreModule* qCjyxAbstractModuleFactoryManager
     qCritical() << "Fail to instantiate module " << moduleName << " (not registered)";
     return nullptr;
     }
+  qCjyxScopedModuleProfileEvent profileEvent(this, moduleName, "instantiate");
   qCjyxAbstractCoreModule* module = factory->instantiate(moduleName);
   if (!module)
     {
@@ -554,3 +578,135 @@ void qCjyxAbstractModuleFactoryManager::setIsVerbose(bool flag)
   d->Verbose = flag;
 }
 
+//-----------------------------------------------------------------------------
+void qCjyxAbstractModuleFactoryManager::setProfilingEnabled(bool enabled)
+{
+  Q_D(qCjyxAbstractModuleFactoryManager);
+  if (enabled && !d->ProfileTimer.isValid())
+    {
+    d->ProfileTimer.start();
+    }
+  d->ProfilingEnabled = enabled;
+}
+
+//-----------------------------------------------------------------------------
+bool qCjyxAbstractModuleFactoryManager::profilingEnabled()const
+{
+  Q_D(const qCjyxAbstractModuleFactoryManager);
+  return d->ProfilingEnabled;
+}
+
+//-----------------------------------------------------------------------------
+void qCjyxAbstractModuleFactoryManager::beginProfileEvent(const QString& name, const QString& category)
+{
+  Q_D(qCjyxAbstractModuleFactoryManager);
+  if (!d->ProfilingEnabled)
+    {
+    return;
+    }
+  qCjyxAbstractModuleFactoryManagerPrivate::ProfileEvent event;
+  event.Name = name;
+  event.Category = category;
+  event.StartTime = d->ProfileTimer.nsecsElapsed() / 1000;
+  event.Duration = 0;
+  event.ChildrenDuration = 0;
+  d->OpenProfileEvents << d->ProfileEvents.count();
+  d->ProfileEvents << event;
+}
+
+//-----------------------------------------------------------------------------
+void qCjyxAbstractModuleFactoryManager::endProfileEvent()
+{
+  Q_D(qCjyxAbstractModuleFactoryManager);
+  if (d->OpenProfileEvents.isEmpty())
+    {
+    // profiling was not enabled when the event started
+    return;
+    }
+  qCjyxAbstractModuleFactoryManagerPrivate::ProfileEvent& event = d->ProfileEvents[d->OpenProfileEvents.takeLast()];
+  event.Duration = d->ProfileTimer.nsecsElapsed() / 1000 - event.StartTime;
+  if (!d->OpenProfileEvents.isEmpty())
+    {
+    d->ProfileEvents[d->OpenProfileEvents.last()].ChildrenDuration += event.Duration;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void qCjyxAbstractModuleFactoryManager::clearProfile()
+{
+  Q_D(qCjyxAbstractModuleFactoryManager);
+  if (!d->OpenProfileEvents.isEmpty())
+    {
+    qWarning() << Q_FUNC_INFO << ": profile cannot be cleared while events are recorded";
+    return;
+    }
+  d->ProfileEvents.clear();
+}
+
+//-----------------------------------------------------------------------------
+bool qCjyxAbstractModuleFactoryManager::writeProfile(const QString& fileName)const
+{
+  Q_D(const qCjyxAbstractModuleFactoryManager);
+  QJsonArray traceEvents;
+  foreach(const qCjyxAbstractModuleFactoryManagerPrivate::ProfileEvent& event, d->ProfileEvents)
+    {
+    QJsonObject traceEvent;
+    traceEvent["name"] = event.Name;
+    traceEvent["cat"] = event.Category;
+    traceEvent["ph"] = QString("X"); // complete event
+    traceEvent["ts"] = event.StartTime;
+    traceEvent["dur"] = event.Duration;
+    traceEvent["pid"] = QCoreApplication::applicationPid();
+    traceEvent["tid"] = 1;
+    traceEvents.append(traceEvent);
+    }
+  QJsonObject trace;
+  trace["traceEvents"] = traceEvents;
+  trace["displayTimeUnit"] = QString("ms");
+
+  QFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly))
+    {
+    qWarning() << Q_FUNC_INFO << "failed: cannot write file" << fileName;
+    return false;
+    }
+  file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact));
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+QString qCjyxAbstractModuleFactoryManager::profileSummary(int maximumNumberOfModules)const
+{
+  Q_D(const qCjyxAbstractModuleFactoryManager);
+  // Sum time of all events of each module
+  QMap<QString, qint64> moduleTimes;
+  foreach(const qCjyxAbstractModuleFactoryManagerPrivate::ProfileEvent& event, d->ProfileEvents)
+    {
+    if (event.Category != "instantiate" && event.Category != "load")
+      {
+      continue;
+      }
+    moduleTimes[event.Name] += event.Duration - event.ChildrenDuration;
+    }
+  QList<QPair<qint64, QString> > sortedModuleTimes;
+  for (QMap<QString, qint64>::const_iterator it = moduleTimes.constBegin(); it != moduleTimes.constEnd(); ++it)
+    {
+    sortedModuleTimes << qMakePair(it.value(), it.key());
+    }
+  std::sort(sortedModuleTimes.begin(), sortedModuleTimes.end(),
+    [](const QPair<qint64, QString>& a, const QPair<qint64, QString>& b) { return a.first > b.first; });
+
+  qint64 totalTime = 0;
+  foreach(const qint64& moduleTime, moduleTimes)
+    {
+    totalTime += moduleTime;
+    }
+  QString summary = QString("Instantiating and loading %1 modules: %2 ms\n")
+    .arg(moduleTimes.count()).arg(totalTime / 1000.0, 0, 'f', 1);
+  for (int index = 0; index < qMin(maximumNumberOfModules, sortedModuleTimes.count()); ++index)
+    {
+    summary += QString("  %1: %2 ms\n").arg(sortedModuleTimes[index].second)
+      .arg(sortedModuleTimes[index].first / 1000.0, 0, 'f', 1);
+    }
+  return summary;
+}
@@ -196,6 +196,31 @@ public:
   /// \sa dependentModules(), qCjyxAbstractCoreModule::dependencies()
   QStringList moduleDependees(const QString& module)const;
 
+  /// Enable/disable recording of the time spent with registering, instantiating
+  /// and loading each module. Disabled by default.
+  /// \sa writeProfile(), profileSummary()
+  void setProfilingEnabled(bool enabled);
+  bool profilingEnabled()const;
+
+  /// Start recording a profiled step (for example, a startup step or loading of a module).
+  /// Steps may be nested, each started step must be ended by endProfileEvent().
+  /// No-op if profiling is disabled.
+  /// \sa qCjyxScopedModuleProfileEvent
+  void beginProfileEvent(const QString& name, const QString& category);
+  void endProfileEvent();
+
+  /// Remove all recorded profile events.
+  void clearProfile();
+
+  /// Write recorded profile events into a file in trace event format.
+  /// The file can be viewed in chrome://tracing or https://ui.perfetto.dev.
+  /// Returns false if the file cannot be written.
+  bool writeProfile(const QString& fileName)const;
+
+  /// Return list of modules that took the longest time to instantiate and load,
+  /// excluding time spent with loading their dependencies.
+  QString profileSummary(int maximumNumberOfModules = 10)const;
+
 signals:
   /// \brief This signal is emitted when all the modules associated with the
   /// registered factories have been loaded
@@ -238,6 +263,24 @@ private:
   Q_DISABLE_COPY(qCjyxAbstractModuleFactoryManager);
 };
 
+/// Helper that records a profile event of a factory manager during its lifetime
+class qCjyxScopedModuleProfileEvent
+{
+public:
+  qCjyxScopedModuleProfileEvent(qCjyxAbstractModuleFactoryManager* manager,
+                                const QString& name, const QString& category)
+    : Manager(manager)
+  {
+    this->Manager->beginProfileEvent(name, category);
+  }
+  ~qCjyxScopedModuleProfileEvent()
+  {
+    this->Manager->endProfileEvent();
+  }
+private:
+  qCjyxAbstractModuleFactoryManager* Manager;
+};
+
 //-----------------------------------------------------------------------------
 void qCjyxAbstractModuleFactoryManager::addSearchPaths(const QStringList& paths)
 {
@@ -145,6 +145,20 @@ wchar_t* QStringToPythonWCharPointer(QString str)
 }
 #endif
 
+namespace
+{
+//-----------------------------------------------------------------------------
+// Schedule processing of the event broker queue (used in coalescing event mode).
+// A zero delay processes the queue when the application becomes idle.
+void RequestEventBrokerQueueProcessingCallback(vtkObject* vtkNotUsed(caller),
+  unsigned long vtkNotUsed(eid), void* clientData, void* callData)
+{
+  qCjyxCoreApplication* app = reinterpret_cast<qCjyxCoreApplication*>(clientData);
+  int delayInMs = *reinterpret_cast<int*>(callData);
+  QTimer::singleShot(delayInMs, app, SLOT(processEventBrokerQueue()));
+}
+}
+
 //-----------------------------------------------------------------------------
 // qCjyxCoreApplicationPrivate methods
 
@@ -185,6 +199,7 @@ qCjyxCoreApplicationPrivate::~qCjyxCoreApplicationPrivate()
 #endif
 
   this->AppLogic->TerminateProcessingThread();
+  vtkEventBroker::GetInstance()->SetRequestProcessEventQueueCallback(nullptr);
 }
 
 //-----------------------------------------------------------------------------
@@ -326,6 +341,11 @@ void qCjyxCoreApplicationPrivate::init()
     modifiedRequestCallback->SetClientData(this->AppLogic);
     modifiedRequestCallback->SetCallback(vtkCjyxApplicationLogic::RequestModifiedCallback);
     vtkEventBroker::GetInstance()->SetRequestModifiedCallback(modifiedRequestCallback);
+
+    vtkNew<vtkCallbackCommand> processEventQueueRequestCallback;
+    processEventQueueRequestCallback->SetClientData(q);
+    processEventQueueRequestCallback->SetCallback(RequestEventBrokerQueueProcessingCallback);
+    vtkEventBroker::GetInstance()->SetRequestProcessEventQueueCallback(processEventQueueRequestCallback);
   }
 
   // Ensure that temporary folder is writable
@@ -1911,6 +1931,12 @@ void qCjyxCoreApplication::processAppLogicModified()
   d->AppLogic->ProcessModified();
 }
 
+//-----------------------------------------------------------------------------
+void qCjyxCoreApplication::processEventBrokerQueue()
+{
+  vtkEventBroker::GetInstance()->ProcessEventQueue();
+}
+
 //-----------------------------------------------------------------------------
 void qCjyxCoreApplication::processAppLogicReadData()
 {
@@ -596,6 +596,9 @@ protected slots:
   void processAppLogicModified();
   void processAppLogicReadData();
   void processAppLogicWriteData();
+  /// Invoke the observations queued by vtkEventBroker in coalescing mode.
+  /// \sa vtkEventBroker::SetCoalescingInterval()
+  void processEventBrokerQueue();
 
   /// Editing of a DMML node has been requested.
   /// Implemented in qCjyxApplication.
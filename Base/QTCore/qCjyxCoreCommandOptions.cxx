@@ -308,6 +308,20 @@ bool qCjyxCoreCommandOptions::verboseModuleDiscovery() const
   return d->ParsedArgs.value("verbose-module-discovery").toBool();
 }
 
+//-----------------------------------------------------------------------------
+bool qCjyxCoreCommandOptions::startupProfiling() const
+{
+  Q_D(const qCjyxCoreCommandOptions);
+  return d->ParsedArgs.value("startup-profiling").toBool();
+}
+
+//-----------------------------------------------------------------------------
+QString qCjyxCoreCommandOptions::startupProfileFile() const
+{
+  Q_D(const qCjyxCoreCommandOptions);
+  return d->ParsedArgs.value("startup-profile-file").toString();
+}
+
 //-----------------------------------------------------------------------------
 bool qCjyxCoreCommandOptions::verbose()const
 {
@@ -457,6 +471,13 @@ void qCjyxCoreCommandOptions::addArguments()
   this->addArgument("verbose-module-discovery", "", QVariant::Bool,
                     "Enable verbose output during module discovery process.");
 
+  this->addArgument("startup-profiling", "", QVariant::Bool,
+                    "Display time spent in the main steps of the application startup.");
+
+  this->addArgument("startup-profile-file", "", QVariant::String,
+                    "Write time spent with instantiating and loading each module at startup into the "
+                    "specified file. The file can be viewed in chrome://tracing or https://ui.perfetto.dev.");
+
   this->addArgument("disable-settings", "", QVariant::Bool,
                     "Start application ignoring user settings and using new temporary settings.");
 
@@ -53,6 +53,8 @@ class Q_CJYX_BASE_QTCORE_EXPORT qCjyxCoreCommandOptions : public ctkCommandLineP
   Q_PROPERTY(bool displayTemporaryPathAndExit READ displayTemporaryPathAndExit CONSTANT)
   Q_PROPERTY(bool displayMessageAndExit READ displayMessageAndExit STORED false CONSTANT)
   Q_PROPERTY(bool verboseModuleDiscovery READ verboseModuleDiscovery CONSTANT)
+  Q_PROPERTY(bool startupProfiling READ startupProfiling CONSTANT)
+  Q_PROPERTY(QString startupProfileFile READ startupProfileFile CONSTANT)
   Q_PROPERTY(bool disableMessageHandlers READ disableMessageHandlers CONSTANT)
   Q_PROPERTY(bool testingEnabled READ isTestingEnabled CONSTANT)
 #ifdef Cjyx_USE_PYTHONQT
@@ -157,6 +159,13 @@ public:
   /// Return True if cjyx should display details regarding the module discovery process
   bool verboseModuleDiscovery()const;
 
+  /// Return True if cjyx should display time spent in the main steps of the startup
+  bool startupProfiling()const;
+
+  /// Return the file where time spent with instantiating and loading each module
+  /// is written at startup (in trace event format).
+  QString startupProfileFile()const;
+
   /// Return True if cjyx should display information at startup
   bool verbose()const;
 
@@ -39,6 +39,8 @@ public:
   qCjyxModuleFactoryManagerPrivate(qCjyxModuleFactoryManager& object);
 
   QStringList LoadedModules;
+  /// Modules whose loading has started but not completed yet (used for detecting circular dependencies)
+  QStringList ModulesBeingLoaded;
   vtkCjyxApplicationLogic* AppLogic;
   vtkDMMLScene* DMMLScene;
 };
@@ -159,8 +161,17 @@ bool qCjyxModuleFactoryManager::loadModule(const QString& name, const QString& d
     return false;
     }
 
+  if (d->ModulesBeingLoaded.contains(name))
+    {
+    qWarning() << "When loading module " << dependee << ", circular dependency was found:"
+               << (d->ModulesBeingLoaded.mid(d->ModulesBeingLoaded.indexOf(name)) << name).join(" -> ");
+    return false;
+    }
+
+  qCjyxScopedModuleProfileEvent profileEvent(this, name, "load");
+
   // Load the modules the module depends on.
-  // There is no cycle check, so be careful
+  d->ModulesBeingLoaded << name;
   foreach(const QString& dependency, instance->dependencies())
     {
     // no-op if the module is already loaded
@@ -169,9 +180,11 @@ bool qCjyxModuleFactoryManager::loadModule(const QString& name, const QString& d
       {
       qWarning() << "When loading module " << name << ", the dependency"
                  << dependency << "failed to be loaded.";
+      d->ModulesBeingLoaded.removeOne(name);
       return false;
       }
     }
+  d->ModulesBeingLoaded.removeOne(name);
 
   // Update internal Map
   d->LoadedModules << name;
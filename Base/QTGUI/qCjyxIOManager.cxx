@@ -110,6 +110,9 @@ bool qCjyxIOManagerPrivate::startProgressDialog(int steps)
     q->qvtkConnect(qCjyxCoreApplication::application()->dmmlScene(),
                     vtkDMMLScene::NodeAddedEvent,
                     q, SLOT(updateProgressDialog()));
+    q->qvtkConnect(qCjyxCoreApplication::application()->dmmlScene(),
+                    vtkDMMLScene::NodesAddedEvent,
+                    q, SLOT(updateProgressDialog()));
     }
   return true;
 }
@@ -127,6 +130,9 @@ void qCjyxIOManagerPrivate::stopProgressDialog()
   q->qvtkDisconnect(qCjyxCoreApplication::application()->dmmlScene(),
                     vtkDMMLScene::NodeAddedEvent,
                     q, SLOT(updateProgressDialog()));
+  q->qvtkDisconnect(qCjyxCoreApplication::application()->dmmlScene(),
+                    vtkDMMLScene::NodesAddedEvent,
+                    q, SLOT(updateProgressDialog()));
   delete this->ProgressDialog;
   this->ProgressDialog = nullptr;
 }
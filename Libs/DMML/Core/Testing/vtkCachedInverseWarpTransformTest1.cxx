@@ -0,0 +1,347 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+// DMML includes
+#include "vtkCachedInverseWarpTransform.h"
+#include "vtkDMMLCoreTestingMacros.h"
+#include "vtkDMMLTransformNode.h"
+#include "vtkOrientedBSplineTransform.h"
+#include "vtkOrientedGridTransform.h"
+
+// VTK includes
+#include <vtkCellData.h>
+#include <vtkCollection.h>
+#include <vtkGeneralTransform.h>
+#include <vtkImageData.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+const int GridSize = 20;
+const double GridSpacing = 5.0;
+
+//----------------------------------------------------------------------------
+// Create a rotated displacement grid centered at the origin.
+// If foldingAmplitude is nonzero then the transform folds space around the center.
+vtkSmartPointer<vtkOrientedGridTransform> CreateGridTransform(double amplitude, double foldingAmplitude)
+{
+  vtkNew<vtkMatrix4x4> gridDirectionMatrix;
+  double angle = vtkMath::RadiansFromDegrees(30.0);
+  gridDirectionMatrix->SetElement(0, 0, cos(angle));
+  gridDirectionMatrix->SetElement(0, 1, -sin(angle));
+  gridDirectionMatrix->SetElement(1, 0, sin(angle));
+  gridDirectionMatrix->SetElement(1, 1, cos(angle));
+
+  double halfSize = (GridSize - 1) * GridSpacing / 2.0;
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  for (int row = 0; row < 3; ++row)
+    {
+    for (int col = 0; col < 3; ++col)
+      {
+      origin[row] -= gridDirectionMatrix->GetElement(row, col) * halfSize;
+      }
+    }
+
+  vtkNew<vtkImageData> displacementGrid;
+  displacementGrid->SetDimensions(GridSize, GridSize, GridSize);
+  displacementGrid->SetOrigin(origin);
+  displacementGrid->SetSpacing(GridSpacing, GridSpacing, GridSpacing);
+  displacementGrid->AllocateScalars(VTK_DOUBLE, 3);
+  double* displacements = static_cast<double*>(displacementGrid->GetScalarPointer());
+  for (int k = 0; k < GridSize; ++k)
+    {
+    for (int j = 0; j < GridSize; ++j)
+      {
+      for (int i = 0; i < GridSize; ++i)
+        {
+        double offset[3] = { i * GridSpacing, j * GridSpacing, k * GridSpacing };
+        double position[3] = { origin[0], origin[1], origin[2] };
+        for (int row = 0; row < 3; ++row)
+          {
+          for (int col = 0; col < 3; ++col)
+            {
+            position[row] += gridDirectionMatrix->GetElement(row, col) * offset[col];
+            }
+          }
+        double* displacement = displacements + 3 * (i + GridSize * (j + GridSize * k));
+        displacement[0] = amplitude * sin(position[1] / 15.0);
+        displacement[1] = amplitude * cos(position[0] / 20.0);
+        displacement[2] = amplitude * sin(position[2] / 10.0) * 0.5;
+        if (i == GridSize / 2 && j == GridSize / 2 && k == GridSize / 2)
+          {
+          displacement[0] += foldingAmplitude;
+          }
+        }
+      }
+    }
+
+  vtkSmartPointer<vtkOrientedGridTransform> gridTransform = vtkSmartPointer<vtkOrientedGridTransform>::New();
+  gridTransform->SetGridDirectionMatrix(gridDirectionMatrix);
+  gridTransform->SetDisplacementGridData(displacementGrid);
+  return gridTransform;
+}
+
+//----------------------------------------------------------------------------
+// Returns maximum distance between points transformed by two transforms
+double GetMaximumTransformDifference(vtkAbstractTransform* transform1, vtkAbstractTransform* transform2)
+{
+  double maximumDifference = 0.0;
+  for (double x = -25.0; x <= 25.0; x += 6.3)
+    {
+    for (double y = -25.0; y <= 25.0; y += 5.9)
+      {
+      for (double z = -25.0; z <= 25.0; z += 7.1)
+        {
+        double point[3] = { x, y, z };
+        double transformedPoint1[3];
+        double transformedPoint2[3];
+        transform1->TransformPoint(point, transformedPoint1);
+        transform2->TransformPoint(point, transformedPoint2);
+        double difference = sqrt(vtkMath::Distance2BetweenPoints(transformedPoint1, transformedPoint2));
+        maximumDifference = std::max(maximumDifference, difference);
+        }
+      }
+    }
+  return maximumDifference;
+}
+
+//----------------------------------------------------------------------------
+int TestCachedInverse()
+{
+  vtkSmartPointer<vtkOrientedGridTransform> gridTransform = CreateGridTransform(3.0, 0.0);
+
+  vtkNew<vtkCachedInverseWarpTransform> cachedInverse;
+  cachedInverse->SetSourceTransform(gridTransform);
+  vtkImageData* cache = cachedInverse->GetInverseDisplacementCache();
+  CHECK_NOT_NULL(cache);
+  CHECK_NOT_NULL(cache->GetPointData()->GetArray("InverseDisplacement"));
+  CHECK_NOT_NULL(cache->GetPointData()->GetArray("InverseError"));
+  CHECK_NOT_NULL(cache->GetCellData()->GetArray("InterpolationError"));
+  CHECK_INT(cachedInverse->GetNumberOfSingularCachePoints(), 0);
+  CHECK_BOOL(cachedInverse->GetResidualCheck(), false);
+
+  // Maximum cache error is the interpolation error estimated at cell centers,
+  // which is larger than the error at the cache points
+  double maximumCacheError = cachedInverse->GetMaximumCacheError();
+  double maximumCachePointError = cache->GetPointData()->GetArray("InverseError")->GetRange()[1];
+  std::cout << "Maximum estimated interpolation error: " << maximumCacheError
+    << " (at cache points: " << maximumCachePointError << ")" << std::endl;
+  CHECK_BOOL(maximumCacheError > maximumCachePointError, true);
+  CHECK_DOUBLE(maximumCacheError, cache->GetCellData()->GetArray("InterpolationError")->GetRange()[1]);
+
+  // Cached inverse matches the iteratively computed inverse within the interpolation tolerance
+  // (the error is estimated at cell centers only, therefore it may be slightly exceeded elsewhere)
+  double maximumDifference = GetMaximumTransformDifference(cachedInverse, gridTransform->GetInverse());
+  std::cout << "Maximum difference between interpolated and iterative inverse: " << maximumDifference << std::endl;
+  CHECK_BOOL(maximumDifference < 2.0 * cachedInverse->GetInterpolationTolerance(), true);
+
+  // With residual check each point is refined to the iterative inverse tolerance
+  cachedInverse->ResidualCheckOn();
+  maximumDifference = GetMaximumTransformDifference(cachedInverse, gridTransform->GetInverse());
+  std::cout << "Maximum difference between refined and iterative inverse: " << maximumDifference << std::endl;
+  CHECK_BOOL(maximumDifference < 0.01, true);
+  cachedInverse->ResidualCheckOff();
+
+  // Interpolated inverse is refined in cells where the estimated error is above tolerance
+  cachedInverse->SetInterpolationTolerance(0.0);
+  maximumDifference = GetMaximumTransformDifference(cachedInverse, gridTransform->GetInverse());
+  CHECK_BOOL(maximumDifference < 0.01, true);
+  cachedInverse->SetInterpolationTolerance(0.1);
+
+  // Cache is not recomputed if nothing changed
+  CHECK_POINTER(cachedInverse->GetInverseDisplacementCache(), cache);
+
+  // Inverse of the cached inverse is the source transform
+  double point[3] = { 3.0, -7.0, 11.0 };
+  double expectedPoint[3];
+  double actualPoint[3];
+  gridTransform->TransformPoint(point, expectedPoint);
+  cachedInverse->GetInverse()->TransformPoint(point, actualPoint);
+  CHECK_DOUBLE_TOLERANCE(sqrt(vtkMath::Distance2BetweenPoints(expectedPoint, actualPoint)), 0.0, 1e-9);
+
+  // Cache is recomputed when the source transform is modified
+  vtkMTimeType cacheMTime = cache->GetMTime();
+  double* displacement = static_cast<double*>(gridTransform->GetDisplacementGrid()->GetScalarPointer(8, 9, 10));
+  displacement[1] += 2.0;
+  gridTransform->GetDisplacementGrid()->Modified();
+  CHECK_BOOL(cachedInverse->GetInverseDisplacementCache()->GetMTime() > cacheMTime, true);
+  maximumDifference = GetMaximumTransformDifference(cachedInverse, gridTransform->GetInverse());
+  CHECK_BOOL(maximumDifference < 2.0 * cachedInverse->GetInterpolationTolerance(), true);
+
+  // Near singularities the inverse is computed iteratively
+  vtkSmartPointer<vtkOrientedGridTransform> foldingGridTransform = CreateGridTransform(3.0, 2.0 * GridSpacing);
+  cachedInverse->SetSourceTransform(foldingGridTransform);
+  CHECK_BOOL(cachedInverse->GetNumberOfSingularCachePoints() > 0, true);
+  double farPoint[3] = { -30.0, 20.0, 15.0 };
+  foldingGridTransform->GetInverse()->TransformPoint(farPoint, expectedPoint);
+  cachedInverse->TransformPoint(farPoint, actualPoint);
+  CHECK_BOOL(sqrt(vtkMath::Distance2BetweenPoints(expectedPoint, actualPoint)) < 0.01, true);
+
+  // Explicitly specified cache geometry
+  cachedInverse->SetSourceTransform(gridTransform);
+  cachedInverse->AutoCacheGeometryOff();
+  cachedInverse->SetCacheOrigin(-30.0, -30.0, -30.0);
+  cachedInverse->SetCacheSpacing(2.0, 2.0, 2.0);
+  cachedInverse->SetCacheDimensions(31, 31, 31);
+  cache = cachedInverse->GetInverseDisplacementCache();
+  CHECK_NOT_NULL(cache);
+  CHECK_INT(cache->GetNumberOfPoints(), 31 * 31 * 31);
+  CHECK_INT(cache->GetCellData()->GetArray("InterpolationError")->GetNumberOfTuples(), 30 * 30 * 30);
+  maximumDifference = GetMaximumTransformDifference(cachedInverse, gridTransform->GetInverse());
+  CHECK_BOOL(maximumDifference < 2.0 * cachedInverse->GetInterpolationTolerance(), true);
+
+  // Automatic cache geometry covers the region mapped by the bulk transform of B-spline transforms
+  vtkNew<vtkImageData> bsplineCoefficients;
+  bsplineCoefficients->SetDimensions(4, 4, 4);
+  bsplineCoefficients->SetSpacing(10.0, 10.0, 10.0);
+  bsplineCoefficients->AllocateScalars(VTK_DOUBLE, 3);
+  bsplineCoefficients->GetPointData()->GetScalars()->Fill(0.0);
+  vtkNew<vtkMatrix4x4> bulkTransformMatrix;
+  bulkTransformMatrix->SetElement(0, 3, 100.0);
+  vtkNew<vtkOrientedBSplineTransform> bsplineTransform;
+  bsplineTransform->SetCoefficientData(bsplineCoefficients);
+  bsplineTransform->SetBulkTransformMatrix(bulkTransformMatrix);
+  cachedInverse->SetSourceTransform(bsplineTransform);
+  cachedInverse->AutoCacheGeometryOn();
+  cache = cachedInverse->GetInverseDisplacementCache();
+  CHECK_NOT_NULL(cache);
+  CHECK_DOUBLE_TOLERANCE(cache->GetOrigin()[0], 100.0, 1e-6);
+  double bulkTransformedPoint[3] = { 115.0, 15.0, 15.0 };
+  cachedInverse->TransformPoint(bulkTransformedPoint, actualPoint);
+  CHECK_DOUBLE_TOLERANCE(actualPoint[0], 15.0, 1e-3);
+  CHECK_DOUBLE_TOLERANCE(actualPoint[1], 15.0, 1e-3);
+  CHECK_DOUBLE_TOLERANCE(actualPoint[2], 15.0, 1e-3);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+// Compare speed of the cached and iterative inverse on a large point set
+int TestCachedInverseSpeed()
+{
+  vtkSmartPointer<vtkOrientedGridTransform> gridTransform = CreateGridTransform(3.0, 0.0);
+
+  const int numberOfPointsAlongAxis = 60;
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(numberOfPointsAlongAxis * numberOfPointsAlongAxis * numberOfPointsAlongAxis);
+  vtkIdType pointId = 0;
+  for (int k = 0; k < numberOfPointsAlongAxis; ++k)
+    {
+    for (int j = 0; j < numberOfPointsAlongAxis; ++j)
+      {
+      for (int i = 0; i < numberOfPointsAlongAxis; ++i)
+        {
+        points->SetPoint(pointId++, -40.0 + i * 1.33, -40.0 + j * 1.33, -40.0 + k * 1.33);
+        }
+      }
+    }
+
+  vtkNew<vtkTimerLog> timer;
+  vtkNew<vtkPoints> iterativePoints;
+  timer->StartTimer();
+  gridTransform->GetInverse()->TransformPoints(points, iterativePoints);
+  timer->StopTimer();
+  double iterativeTime = timer->GetElapsedTime();
+
+  vtkNew<vtkCachedInverseWarpTransform> cachedInverse;
+  cachedInverse->SetSourceTransform(gridTransform);
+  timer->StartTimer();
+  cachedInverse->Update();
+  timer->StopTimer();
+  double cacheTime = timer->GetElapsedTime();
+
+  vtkNew<vtkPoints> cachedPoints;
+  timer->StartTimer();
+  cachedInverse->TransformPoints(points, cachedPoints);
+  timer->StopTimer();
+  double cachedTime = timer->GetElapsedTime();
+
+  double maximumDifference = 0.0;
+  for (pointId = 0; pointId < points->GetNumberOfPoints(); ++pointId)
+    {
+    maximumDifference = std::max(maximumDifference,
+      sqrt(vtkMath::Distance2BetweenPoints(iterativePoints->GetPoint(pointId), cachedPoints->GetPoint(pointId))));
+    }
+
+  std::cout << "Inverse transform of " << points->GetNumberOfPoints() << " points:" << std::endl
+    << "  iterative: " << iterativeTime << "s" << std::endl
+    << "  cached: " << cachedTime << "s (cache computation: " << cacheTime << "s)" << std::endl
+    << "  speedup: " << iterativeTime / std::max(cachedTime, 1e-6) << "x" << std::endl
+    << "  maximum difference: " << maximumDifference << std::endl;
+  CHECK_BOOL(maximumDifference < 2.0 * cachedInverse->GetInterpolationTolerance(), true);
+  CHECK_BOOL(cachedTime < iterativeTime, true);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestTransformNodeCachedInverse()
+{
+  vtkSmartPointer<vtkOrientedGridTransform> gridTransform = CreateGridTransform(3.0, 0.0);
+
+  vtkNew<vtkDMMLTransformNode> transformNode;
+  transformNode->SetAndObserveTransformFromParent(gridTransform);
+  CHECK_BOOL(transformNode->GetUseCachedInverse(), false);
+  CHECK_NULL(transformNode->GetCachedInverseTransform());
+  vtkNew<vtkGeneralTransform> iterativeTransformToWorld;
+  transformNode->GetTransformToWorld(iterativeTransformToWorld);
+
+  transformNode->UseCachedInverseOn();
+  CHECK_NOT_NULL(transformNode->GetCachedInverseTransform());
+  CHECK_POINTER(transformNode->GetCachedInverseTransform()->GetSourceTransform(), gridTransform.GetPointer());
+  vtkNew<vtkGeneralTransform> cachedTransformToWorld;
+  transformNode->GetTransformToWorld(cachedTransformToWorld);
+  CHECK_BOOL(GetMaximumTransformDifference(cachedTransformToWorld, iterativeTransformToWorld) < 0.2, true);
+
+  // Transform returned by the node is not affected
+  CHECK_BOOL(vtkCachedInverseWarpTransform::SafeDownCast(transformNode->GetTransformToParent()) == nullptr, true);
+
+  // Cached inverse is not stored in other nodes when the transform is hardened
+  vtkNew<vtkDMMLTransformNode> hardenedTransformNode;
+  hardenedTransformNode->ApplyTransform(cachedTransformToWorld);
+  vtkNew<vtkCollection> hardenedTransformList;
+  vtkDMMLTransformNode::FlattenGeneralTransform(hardenedTransformList, hardenedTransformNode->GetTransformToParent());
+  CHECK_INT(hardenedTransformList->GetNumberOfItems(), 1);
+  CHECK_BOOL(vtkOrientedGridTransform::SafeDownCast(hardenedTransformList->GetItemAsObject(0)) != nullptr, true);
+  CHECK_BOOL(vtkDMMLTransformNode::IsAbstractTransformComputedFromInverse(
+    vtkAbstractTransform::SafeDownCast(hardenedTransformList->GetItemAsObject(0))), true);
+
+  // Inverse of the cache is used if the transform is stored as transform to parent
+  transformNode->Inverse();
+  vtkNew<vtkGeneralTransform> cachedTransformFromWorld;
+  transformNode->GetTransformFromWorld(cachedTransformFromWorld);
+  CHECK_BOOL(GetMaximumTransformDifference(cachedTransformFromWorld, iterativeTransformToWorld) < 0.2, true);
+
+  transformNode->UseCachedInverseOff();
+  CHECK_NULL(transformNode->GetCachedInverseTransform());
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkCachedInverseWarpTransformTest1(int, char * [])
+{
+  CHECK_EXIT_SUCCESS(TestCachedInverse());
+  CHECK_EXIT_SUCCESS(TestCachedInverseSpeed());
+  CHECK_EXIT_SUCCESS(TestTransformNodeCachedInverse());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,191 @@
+/*==============================================================================
+
+  Program: 3D Cjyx
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// DMML includes
+#include "vtkDMMLCoreTestingMacros.h"
+#include "vtkDMMLModelDisplayNode.h"
+#include "vtkDMMLModelNode.h"
+#include "vtkDMMLScene.h"
+#include "vtkDMMLSceneEventRecorder.h"
+
+// VTK includes
+#include <vtkCallbackCommand.h>
+#include <vtkCollection.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+struct NodesAddedCounter
+{
+  int NumberOfEvents{0};
+  int NumberOfNodes{0};
+};
+
+//---------------------------------------------------------------------------
+void NodesAddedCallback(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid), void* clientData, void* callData)
+{
+  NodesAddedCounter* counter = reinterpret_cast<NodesAddedCounter*>(clientData);
+  vtkCollection* addedNodes = reinterpret_cast<vtkCollection*>(callData);
+  counter->NumberOfEvents++;
+  counter->NumberOfNodes += (addedNodes ? addedNodes->GetNumberOfItems() : 0);
+}
+
+//---------------------------------------------------------------------------
+// Add a model and a display node to the scene
+void AddModel(vtkDMMLScene* scene, int index)
+{
+  vtkNew<vtkDMMLModelDisplayNode> displayNode;
+  std::stringstream displayName;
+  displayName << "Display_" << index;
+  displayNode->SetName(displayName.str().c_str());
+  scene->AddNode(displayNode);
+
+  vtkNew<vtkDMMLModelNode> modelNode;
+  std::stringstream modelName;
+  modelName << "Model_" << index;
+  modelNode->SetName(modelName.str().c_str());
+  scene->AddNode(modelNode);
+  modelNode->SetAndObserveDisplayNodeID(displayNode->GetID());
+}
+
+//---------------------------------------------------------------------------
+std::string CreateSceneXML(int numberOfModels)
+{
+  vtkNew<vtkDMMLScene> scene;
+  for (int i = 0; i < numberOfModels; ++i)
+    {
+    AddModel(scene, i);
+    }
+  scene->SetSaveToXMLString(1);
+  scene->Commit();
+  return scene->GetSceneXMLString();
+}
+
+//---------------------------------------------------------------------------
+int ImportScene(const std::string& sceneXML, int numberOfModels, bool bulkImport, bool verbose)
+{
+  vtkNew<vtkDMMLScene> scene;
+  // Existing node IDs conflict with the imported node IDs, therefore
+  // imported node IDs and references must be updated.
+  AddModel(scene, -1);
+
+  vtkNew<vtkDMMLSceneEventRecorder> recorder;
+  scene->AddObserver(vtkCommand::AnyEvent, recorder);
+  NodesAddedCounter counter;
+  vtkNew<vtkCallbackCommand> nodesAddedCallback;
+  nodesAddedCallback->SetCallback(NodesAddedCallback);
+  nodesAddedCallback->SetClientData(&counter);
+  scene->AddObserver(vtkDMMLScene::NodesAddedEvent, nodesAddedCallback);
+
+  scene->SetBulkImport(bulkImport);
+  CHECK_BOOL(scene->GetBulkImport(), bulkImport);
+  scene->SetLoadFromXMLString(1);
+  scene->SetSceneXMLString(sceneXML);
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  CHECK_INT(scene->Import(), 1);
+  timer->StopTimer();
+  if (verbose)
+    {
+    std::cout << "Import " << 2 * numberOfModels << " nodes (bulk import: " << (bulkImport ? "on" : "off") << "): "
+      << timer->GetElapsedTime() << " s" << std::endl;
+    }
+
+  // All nodes are added and references point to the imported nodes
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkDMMLModelNode"), numberOfModels + 1);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkDMMLModelDisplayNode"), numberOfModels + 1);
+  vtkSmartPointer<vtkCollection> modelNodes = vtkSmartPointer<vtkCollection>::Take(
+    scene->GetNodesByClass("vtkDMMLModelNode"));
+  vtkDMMLModelNode* modelNode = nullptr;
+  vtkCollectionSimpleIterator it;
+  for (modelNodes->InitTraversal(it); (modelNode = vtkDMMLModelNode::SafeDownCast(modelNodes->GetNextItemAsObject(it)));)
+    {
+    CHECK_NOT_NULL(modelNode->GetDisplayNode());
+    std::string modelName = modelNode->GetName();
+    std::string displayName = modelNode->GetDisplayNode()->GetName();
+    CHECK_STD_STRING(displayName.substr(std::string("Display_").size()), modelName.substr(std::string("Model_").size()));
+    }
+
+  // Observers are notified about the added nodes
+  if (bulkImport)
+    {
+    CHECK_INT(counter.NumberOfEvents, 2);
+    CHECK_INT(counter.NumberOfNodes, 2 * numberOfModels);
+    CHECK_BOOL(recorder->CalledEvents[vtkDMMLScene::NodeAddedEvent] < 2 * static_cast<unsigned int>(numberOfModels), true);
+    }
+  else
+    {
+    CHECK_INT(counter.NumberOfEvents, 0);
+    CHECK_BOOL(recorder->CalledEvents[vtkDMMLScene::NodeAddedEvent] >= 2 * static_cast<unsigned int>(numberOfModels), true);
+    }
+  CHECK_INT(recorder->CalledEvents[vtkDMMLScene::StartImportEvent], 1);
+  CHECK_INT(recorder->CalledEvents[vtkDMMLScene::EndImportEvent], 1);
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//---------------------------------------------------------------------------
+// Optional arguments: list of number of models to import (each model is stored in two nodes)
+// for measuring scaling of scene import time, for example: 500 5000 25000
+int vtkDMMLSceneLargeImportTest(int argc, char * argv [])
+{
+  // Functional test
+  std::string sceneXML = CreateSceneXML(10);
+  CHECK_EXIT_SUCCESS(ImportScene(sceneXML, 10, false, false));
+  CHECK_EXIT_SUCCESS(ImportScene(sceneXML, 10, true, false));
+
+  // Empty scene
+  std::string emptySceneXML = CreateSceneXML(0);
+  vtkNew<vtkDMMLScene> scene;
+  scene->SetBulkImport(true);
+  scene->SetLoadFromXMLString(1);
+  scene->SetSceneXMLString(emptySceneXML);
+  CHECK_INT(scene->Import(), 1);
+
+  // Scaling
+  if (argc > 1)
+    {
+    for (int argIndex = 1; argIndex < argc; ++argIndex)
+      {
+      int numberOfModels = atoi(argv[argIndex]);
+      sceneXML = CreateSceneXML(numberOfModels);
+      CHECK_EXIT_SUCCESS(ImportScene(sceneXML, numberOfModels, false, true));
+      CHECK_EXIT_SUCCESS(ImportScene(sceneXML, numberOfModels, true, true));
+      }
+    }
+  else
+    {
+    sceneXML = CreateSceneXML(500);
+    CHECK_EXIT_SUCCESS(ImportScene(sceneXML, 500, false, true));
+    CHECK_EXIT_SUCCESS(ImportScene(sceneXML, 500, true, true));
+    sceneXML = CreateSceneXML(5000);
+    CHECK_EXIT_SUCCESS(ImportScene(sceneXML, 5000, false, true));
+    CHECK_EXIT_SUCCESS(ImportScene(sceneXML, 5000, true, true));
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,204 @@
+/*==============================================================================
+
+  Program: 3D Cjyx
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// DMML includes
+#include "vtkDMMLCoreTestingMacros.h"
+#include "vtkDMMLLabelMapVolumeNode.h"
+#include "vtkDMMLModelDisplayNode.h"
+#include "vtkDMMLModelNode.h"
+#include "vtkDMMLScalarVolumeNode.h"
+#include "vtkDMMLScene.h"
+
+// VTK includes
+#include <vtkCollection.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+int TestNodesByClassConsistency();
+int TestNodesByClassScaling(int numberOfNodes);
+
+} // end of anonymous namespace
+
+//---------------------------------------------------------------------------
+int vtkDMMLSceneNodesByClassTest(int vtkNotUsed(argc), char * vtkNotUsed(argv) [] )
+{
+  CHECK_EXIT_SUCCESS(TestNodesByClassConsistency());
+  CHECK_EXIT_SUCCESS(TestNodesByClassScaling(1000));
+  CHECK_EXIT_SUCCESS(TestNodesByClassScaling(5000));
+  CHECK_EXIT_SUCCESS(TestNodesByClassScaling(20000));
+  return EXIT_SUCCESS;
+}
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+int TestNodesByClassConsistency()
+{
+  vtkNew<vtkDMMLScene> scene;
+
+  // Query before adding nodes, the class list must be kept up-to-date
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkDMMLVolumeNode"), 0);
+  CHECK_NULL(scene->GetNthNodeByClass(0, "vtkDMMLVolumeNode"));
+
+  vtkNew<vtkDMMLScalarVolumeNode> scalarVolume1;
+  scene->AddNode(scalarVolume1);
+  vtkNew<vtkDMMLModelNode> model1;
+  scene->AddNode(model1);
+  vtkNew<vtkDMMLLabelMapVolumeNode> labelmapVolume1;
+  scene->AddNode(labelmapVolume1);
+
+  // Subclasses are matched
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkDMMLVolumeNode"), 2);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkDMMLScalarVolumeNode"), 2);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkDMMLLabelMapVolumeNode"), 1);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkDMMLModelNode"), 1);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkDMMLNode"), scene->GetNumberOfNodes());
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkDMMLNonExistingNode"), 0);
+
+  // Nodes are returned in scene order
+  CHECK_POINTER(scene->GetNthNodeByClass(0, "vtkDMMLVolumeNode"), scalarVolume1.GetPointer());
+  CHECK_POINTER(scene->GetNthNodeByClass(1, "vtkDMMLVolumeNode"), labelmapVolume1.GetPointer());
+  CHECK_NULL(scene->GetNthNodeByClass(2, "vtkDMMLVolumeNode"));
+  CHECK_POINTER(scene->GetFirstNodeByClass("vtkDMMLModelNode"), model1.GetPointer());
+
+  // Insertion in the middle of the scene keeps the scene order
+  vtkNew<vtkDMMLScalarVolumeNode> scalarVolume2;
+  scene->InsertBeforeNode(labelmapVolume1, scalarVolume2);
+  std::vector<vtkDMMLNode*> volumeNodes;
+  CHECK_INT(scene->GetNodesByClass("vtkDMMLVolumeNode", volumeNodes), 3);
+  CHECK_POINTER(volumeNodes[0], scalarVolume1.GetPointer());
+  CHECK_POINTER(volumeNodes[1], scalarVolume2.GetPointer());
+  CHECK_POINTER(volumeNodes[2], labelmapVolume1.GetPointer());
+
+  // Removal
+  scene->RemoveNode(scalarVolume1);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkDMMLVolumeNode"), 2);
+  CHECK_POINTER(scene->GetNthNodeByClass(0, "vtkDMMLVolumeNode"), scalarVolume2.GetPointer());
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkDMMLNode"), scene->GetNumberOfNodes());
+
+  // Removed nodes do not change the order of the remaining nodes
+  vtkNew<vtkDMMLScalarVolumeNode> scalarVolume3;
+  scene->AddNode(scalarVolume3);
+  scene->RemoveNode(labelmapVolume1);
+  CHECK_INT(scene->GetNodesByClass("vtkDMMLVolumeNode", volumeNodes), 2);
+  CHECK_POINTER(volumeNodes[0], scalarVolume2.GetPointer());
+  CHECK_POINTER(volumeNodes[1], scalarVolume3.GetPointer());
+
+  vtkSmartPointer<vtkCollection> models = vtkSmartPointer<vtkCollection>::Take(
+    scene->GetNodesByClass("vtkDMMLModelNode"));
+  CHECK_INT(models->GetNumberOfItems(), 1);
+  CHECK_POINTER(models->GetItemAsObject(0), model1.GetPointer());
+
+  // Clear
+  scene->Clear(1);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkDMMLVolumeNode"), 0);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkDMMLModelNode"), 0);
+  vtkNew<vtkDMMLModelNode> model2;
+  scene->AddNode(model2);
+  CHECK_POINTER(scene->GetFirstNodeByClass("vtkDMMLModelNode"), model2.GetPointer());
+
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestNodesByClassScaling(int numberOfNodes)
+{
+  vtkNew<vtkDMMLScene> scene;
+  vtkNew<vtkTimerLog> timerLog;
+
+  // Few volumes among a large number of models and display nodes,
+  // similar to scenes with many markups or segments.
+  const int numberOfVolumes = 10;
+  timerLog->StartTimer();
+  for (int i = 0; i < numberOfNodes; ++i)
+    {
+    vtkSmartPointer<vtkDMMLNode> node;
+    if (i % (numberOfNodes / numberOfVolumes) == 0)
+      {
+      node = vtkSmartPointer<vtkDMMLScalarVolumeNode>::New();
+      }
+    else if (i % 2)
+      {
+      node = vtkSmartPointer<vtkDMMLModelNode>::New();
+      }
+    else
+      {
+      node = vtkSmartPointer<vtkDMMLModelDisplayNode>::New();
+      }
+    scene->AddNode(node);
+    }
+  timerLog->StopTimer();
+  std::cout << numberOfNodes << " nodes: AddNode: " << timerLog->GetElapsedTime() << "s" << std::endl;
+
+  const int numberOfQueries = 1000;
+  timerLog->StartTimer();
+  for (int i = 0; i < numberOfQueries; ++i)
+    {
+    CHECK_INT(scene->GetNumberOfNodesByClass("vtkDMMLVolumeNode"), numberOfVolumes);
+    }
+  timerLog->StopTimer();
+  std::cout << numberOfNodes << " nodes: GetNumberOfNodesByClass: "
+    << timerLog->GetElapsedTime() / numberOfQueries * 1e6 << "us" << std::endl;
+
+  timerLog->StartTimer();
+  for (int i = 0; i < numberOfQueries; ++i)
+    {
+    CHECK_NOT_NULL(scene->GetNthNodeByClass(numberOfVolumes - 1, "vtkDMMLVolumeNode"));
+    }
+  timerLog->StopTimer();
+  std::cout << numberOfNodes << " nodes: GetNthNodeByClass: "
+    << timerLog->GetElapsedTime() / numberOfQueries * 1e6 << "us" << std::endl;
+
+  std::vector<vtkDMMLNode*> nodes;
+  timerLog->StartTimer();
+  for (int i = 0; i < numberOfQueries; ++i)
+    {
+    CHECK_INT(scene->GetNodesByClass("vtkDMMLVolumeNode", nodes), numberOfVolumes);
+    }
+  timerLog->StopTimer();
+  std::cout << numberOfNodes << " nodes: GetNodesByClass: "
+    << timerLog->GetElapsedTime() / numberOfQueries * 1e6 << "us" << std::endl;
+
+  // Adding and removing nodes keeps the lists of already queried classes up-to-date
+  vtkNew<vtkDMMLScalarVolumeNode> volumeNode;
+  scene->AddNode(volumeNode);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkDMMLVolumeNode"), numberOfVolumes + 1);
+  CHECK_POINTER(scene->GetNthNodeByClass(numberOfVolumes, "vtkDMMLVolumeNode"), volumeNode.GetPointer());
+  scene->RemoveNode(volumeNode);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkDMMLVolumeNode"), numberOfVolumes);
+
+  // Removing nodes from large class lists
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkDMMLNode"), scene->GetNumberOfNodes());
+  CHECK_BOOL(scene->GetNumberOfNodesByClass("vtkDMMLDisplayNode") > 0, true);
+  timerLog->StartTimer();
+  scene->Clear(1);
+  timerLog->StopTimer();
+  std::cout << numberOfNodes << " nodes: Clear: " << timerLog->GetElapsedTime() << "s" << std::endl;
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkDMMLNode"), scene->GetNumberOfNodes());
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
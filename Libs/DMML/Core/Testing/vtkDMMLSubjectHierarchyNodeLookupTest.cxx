@@ -0,0 +1,259 @@
+/*==============================================================================
+
+  Program: 3D Cjyx
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// DMML includes
+#include "vtkDMMLCoreTestingMacros.h"
+#include "vtkDMMLScalarVolumeNode.h"
+#include "vtkDMMLScene.h"
+#include "vtkDMMLSubjectHierarchyNode.h"
+
+// VTK includes
+#include <vtkIdList.h>
+#include <vtkNew.h>
+#include <vtkSMPTools.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <atomic>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+int TestLookupConsistency();
+int TestSeparateHierarchies();
+int TestLookupScaling(int numberOfItems);
+
+} // end of anonymous namespace
+
+//---------------------------------------------------------------------------
+int vtkDMMLSubjectHierarchyNodeLookupTest(int vtkNotUsed(argc), char * vtkNotUsed(argv) [] )
+{
+  CHECK_EXIT_SUCCESS(TestLookupConsistency());
+  CHECK_EXIT_SUCCESS(TestSeparateHierarchies());
+  CHECK_EXIT_SUCCESS(TestLookupScaling(1000));
+  CHECK_EXIT_SUCCESS(TestLookupScaling(10000));
+  CHECK_EXIT_SUCCESS(TestLookupScaling(100000));
+  return EXIT_SUCCESS;
+}
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+int TestLookupConsistency()
+{
+  vtkNew<vtkDMMLScene> scene;
+  vtkDMMLSubjectHierarchyNode* shNode = vtkDMMLSubjectHierarchyNode::GetSubjectHierarchyNode(scene);
+  CHECK_NOT_NULL(shNode);
+  vtkIdType sceneItemID = shNode->GetSceneItemID();
+
+  vtkIdType patientItemID = shNode->CreateSubjectItem(sceneItemID, "Patient");
+  vtkIdType studyItemID = shNode->CreateStudyItem(patientItemID, "Study");
+  vtkIdType folderItemID = shNode->CreateFolderItem(sceneItemID, "Folder");
+
+  vtkDMMLNode* volumeNode = scene->AddNewNodeByClass("vtkDMMLScalarVolumeNode", "Volume");
+  vtkIdType volumeItemID = shNode->GetItemByDataNode(volumeNode);
+  CHECK_BOOL(volumeItemID != vtkDMMLSubjectHierarchyNode::INVALID_ITEM_ID, true);
+  shNode->SetItemParent(volumeItemID, studyItemID);
+
+  // Data node lookup in branches
+  CHECK_INT(shNode->GetItemParent(volumeItemID), studyItemID);
+  CHECK_INT(shNode->GetItemByDataNode(volumeNode), volumeItemID);
+
+  // UID lookup, also after changing the UID and reparenting
+  shNode->SetItemUID(studyItemID, "DICOM", "1.2.3");
+  CHECK_INT(shNode->GetItemByUID("DICOM", "1.2.3"), studyItemID);
+  shNode->SetItemUID(studyItemID, "DICOM", "1.2.4");
+  CHECK_INT(shNode->GetItemByUID("DICOM", "1.2.3"), vtkDMMLSubjectHierarchyNode::INVALID_ITEM_ID);
+  CHECK_INT(shNode->GetItemByUID("DICOM", "1.2.4"), studyItemID);
+  shNode->SetItemParent(studyItemID, folderItemID);
+  CHECK_INT(shNode->GetItemByUID("DICOM", "1.2.4"), studyItemID);
+
+  // Duplicate UIDs: the first item in tree order is returned
+  vtkIdType otherStudyItemID = shNode->CreateStudyItem(sceneItemID, "OtherStudy");
+  shNode->SetItemUID(otherStudyItemID, "DICOM", "1.2.4");
+  CHECK_INT(shNode->GetItemByUID("DICOM", "1.2.4"), studyItemID);
+  shNode->RemoveItem(studyItemID, false, false);
+  CHECK_INT(shNode->GetItemByUID("DICOM", "1.2.4"), otherStudyItemID);
+
+  // Children of removed (non-recursive) items are moved to the parent and remain accessible
+  CHECK_INT(shNode->GetItemByDataNode(volumeNode), volumeItemID);
+  CHECK_INT(shNode->GetItemParent(volumeItemID), folderItemID);
+
+  // Removed items are not found anymore
+  scene->RemoveNode(volumeNode);
+  CHECK_INT(shNode->GetItemByDataNode(volumeNode), vtkDMMLSubjectHierarchyNode::INVALID_ITEM_ID);
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  CHECK_INT(shNode->GetItemParent(volumeItemID), vtkDMMLSubjectHierarchyNode::INVALID_ITEM_ID);
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+
+  // Clear scene removes all items
+  scene->Clear();
+  shNode = vtkDMMLSubjectHierarchyNode::GetSubjectHierarchyNode(scene);
+  std::vector<vtkIdType> childIDs;
+  shNode->GetItemChildren(shNode->GetSceneItemID(), childIDs, true);
+  CHECK_INT(static_cast<int>(childIDs.size()), 0);
+  CHECK_INT(shNode->GetItemByUID("DICOM", "1.2.4"), vtkDMMLSubjectHierarchyNode::INVALID_ITEM_ID);
+  CHECK_INT(shNode->GetItemChildWithName(shNode->GetSceneItemID(), "Patient"), vtkDMMLSubjectHierarchyNode::INVALID_ITEM_ID);
+
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestSeparateHierarchies()
+{
+  // Items of a hierarchy are not found in the hierarchy of another scene
+  vtkNew<vtkDMMLScene> scene1;
+  vtkNew<vtkDMMLScene> scene2;
+  vtkDMMLSubjectHierarchyNode* shNode1 = vtkDMMLSubjectHierarchyNode::GetSubjectHierarchyNode(scene1);
+  vtkDMMLSubjectHierarchyNode* shNode2 = vtkDMMLSubjectHierarchyNode::GetSubjectHierarchyNode(scene2);
+  vtkIdType folderItemID1 = shNode1->CreateFolderItem(shNode1->GetSceneItemID(), "Folder");
+  vtkIdType folderItemID2 = shNode2->CreateFolderItem(shNode2->GetSceneItemID(), "Folder");
+  CHECK_BOOL(folderItemID1 != folderItemID2, true);
+  CHECK_INT(shNode1->GetItemParent(folderItemID1), shNode1->GetSceneItemID());
+  CHECK_INT(shNode2->GetItemParent(folderItemID2), shNode2->GetSceneItemID());
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  CHECK_STD_STRING(shNode1->GetItemName(folderItemID2), "");
+  CHECK_STD_STRING(shNode2->GetItemName(folderItemID1), "");
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+
+  vtkDMMLNode* volumeNode1 = scene1->AddNewNodeByClass("vtkDMMLScalarVolumeNode");
+  CHECK_BOOL(shNode1->GetItemByDataNode(volumeNode1) != vtkDMMLSubjectHierarchyNode::INVALID_ITEM_ID, true);
+  CHECK_INT(shNode2->GetItemByDataNode(volumeNode1), vtkDMMLSubjectHierarchyNode::INVALID_ITEM_ID);
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestLookupScaling(int numberOfItems)
+{
+  vtkNew<vtkDMMLScene> scene;
+  vtkDMMLSubjectHierarchyNode* shNode = vtkDMMLSubjectHierarchyNode::GetSubjectHierarchyNode(scene);
+  vtkIdType sceneItemID = shNode->GetSceneItemID();
+
+  // 10 items per folder, folders are grouped under 100 patients
+  const int numberOfPatients = 100;
+  std::vector<vtkIdType> patientItemIDs;
+  for (int i = 0; i < numberOfPatients; ++i)
+    {
+    std::stringstream name;
+    name << "Patient" << i;
+    patientItemIDs.push_back(shNode->CreateSubjectItem(sceneItemID, name.str()));
+    }
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  std::vector<vtkIdType> itemIDs;
+  vtkIdType folderItemID = vtkDMMLSubjectHierarchyNode::INVALID_ITEM_ID;
+  for (int i = 0; i < numberOfItems; ++i)
+    {
+    std::stringstream name;
+    name << "Item" << i;
+    if (i % 10 == 0)
+      {
+      folderItemID = shNode->CreateFolderItem(patientItemIDs[i % numberOfPatients], name.str() + "Folder");
+      }
+    vtkIdType itemID = shNode->CreateHierarchyItem(folderItemID, name.str(), "Series");
+    std::stringstream uid;
+    uid << "1.2.840." << i;
+    shNode->SetItemUID(itemID, "DICOM", uid.str());
+    itemIDs.push_back(itemID);
+    }
+  timer->StopTimer();
+  double createTime = timer->GetElapsedTime();
+
+  // Lookup by ID
+  timer->StartTimer();
+  for (vtkIdType itemID : itemIDs)
+    {
+    if (shNode->GetItemLevel(itemID) != "Series")
+      {
+      std::cerr << "Item lookup by ID failed for " << itemID << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  timer->StopTimer();
+  double idLookupTime = timer->GetElapsedTime();
+
+  // Lookup by UID
+  timer->StartTimer();
+  const int numberOfUIDLookups = 1000;
+  for (int i = 0; i < numberOfUIDLookups; ++i)
+    {
+    int itemIndex = (i * 7919) % numberOfItems;
+    std::stringstream uid;
+    uid << "1.2.840." << itemIndex;
+    CHECK_INT(shNode->GetItemByUID("DICOM", uid.str().c_str()), itemIDs[itemIndex]);
+    }
+  timer->StopTimer();
+  double uidLookupTime = timer->GetElapsedTime();
+
+  // Concurrent lookups by ID
+  std::atomic<int> numberOfFailedLookups(0);
+  timer->StartTimer();
+  vtkSMPTools::For(0, numberOfItems, [&](vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      if (shNode->GetItemParent(itemIDs[i]) == vtkDMMLSubjectHierarchyNode::INVALID_ITEM_ID)
+        {
+        numberOfFailedLookups++;
+        }
+      }
+    });
+  timer->StopTimer();
+  double concurrentLookupTime = timer->GetElapsedTime();
+  CHECK_INT(numberOfFailedLookups, 0);
+
+  // FindChildrenByName, through GetItemsByName
+  timer->StartTimer();
+  vtkNew<vtkIdList> foundItemIDs;
+  shNode->GetItemsByName("Item1", foundItemIDs, false);
+  CHECK_INT(foundItemIDs->GetNumberOfIds(), 1);
+  shNode->GetItemsByName("item1", foundItemIDs, true);
+  CHECK_BOOL(foundItemIDs->GetNumberOfIds() > 1, true);
+  timer->StopTimer();
+  double findByNameTime = timer->GetElapsedTime();
+
+  // GetAllChildren, through recursive GetItemChildren
+  timer->StartTimer();
+  std::vector<vtkIdType> childIDs;
+  shNode->GetItemChildren(sceneItemID, childIDs, true);
+  timer->StopTimer();
+  double getAllChildrenTime = timer->GetElapsedTime();
+  CHECK_INT(static_cast<int>(childIDs.size()), numberOfPatients + numberOfItems + numberOfItems / 10);
+
+  // Remove all items
+  timer->StartTimer();
+  shNode->RemoveAllItems();
+  timer->StopTimer();
+  double removeTime = timer->GetElapsedTime();
+  shNode->GetItemChildren(sceneItemID, childIDs, true);
+  CHECK_INT(static_cast<int>(childIDs.size()), 0);
+
+  std::cout << numberOfItems << " items: create " << createTime << "s"
+    << ", " << itemIDs.size() << " ID lookups " << idLookupTime << "s"
+    << ", " << numberOfUIDLookups << " UID lookups " << uidLookupTime << "s"
+    << ", concurrent ID lookups " << concurrentLookupTime << "s"
+    << ", find by name " << findByNameTime << "s"
+    << ", get all children " << getAllChildrenTime << "s"
+    << ", remove all " << removeTime << "s" << std::endl;
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
@@ -0,0 +1,143 @@
+/*==============================================================================
+
+  Program: 3D Cjyx
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// DMML includes
+#include "vtkDMMLCoreTestingMacros.h"
+#include "vtkEventBroker.h"
+#include "vtkObservation.h"
+
+// VTK includes
+#include <vtkCallbackCommand.h>
+#include <vtkNew.h>
+
+// STD includes
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+
+//---------------------------------------------------------------------------
+void CountInvocations(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid),
+                      void* clientData, void* vtkNotUsed(callData))
+{
+  int* invocationCount = reinterpret_cast<int*>(clientData);
+  (*invocationCount)++;
+}
+
+//---------------------------------------------------------------------------
+void RecordProcessEventQueueRequest(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid),
+                                    void* clientData, void* callData)
+{
+  std::vector<int>* requestedDelays = reinterpret_cast<std::vector<int>*>(clientData);
+  requestedDelays->push_back(*reinterpret_cast<int*>(callData));
+}
+
+} // end of anonymous namespace
+
+//---------------------------------------------------------------------------
+int vtkEventBrokerTest1(int vtkNotUsed(argc), char * vtkNotUsed(argv) [] )
+{
+  vtkEventBroker* broker = vtkEventBroker::GetInstance();
+  broker->ResetObservationTimings();
+
+  vtkNew<vtkObject> subject;
+  vtkNew<vtkObject> observer;
+  vtkNew<vtkCallbackCommand> callback;
+  int invocationCount = 0;
+  callback->SetCallback(CountInvocations);
+  callback->SetClientData(&invocationCount);
+  vtkObservation* observation = broker->AddObservation(subject, vtkCommand::ModifiedEvent, observer, callback);
+  CHECK_NOT_NULL(observation);
+
+  // Synchronous mode: every event is invoked
+  subject->Modified();
+  subject->Modified();
+  CHECK_INT(invocationCount, 2);
+
+  // Coalescing mode: repeated events result in a single invocation
+  broker->SetEventModeToCoalescing();
+  CHECK_STRING(broker->GetEventModeAsString(), "Coalescing");
+  for (int i = 0; i < 1000; ++i)
+    {
+    subject->Modified();
+    }
+  CHECK_INT(invocationCount, 2);
+  CHECK_INT(broker->GetNumberOfQueuedObservations(), 1);
+  CHECK_INT(static_cast<int>(broker->GetNumberOfCoalescedEvents()), 999);
+  broker->ProcessEventQueue();
+  CHECK_INT(invocationCount, 3);
+  CHECK_INT(broker->GetNumberOfQueuedObservations(), 0);
+
+  // Events with different call data are not coalesced
+  int callData1 = 1;
+  int callData2 = 2;
+  subject->InvokeEvent(vtkCommand::ModifiedEvent, &callData1);
+  subject->InvokeEvent(vtkCommand::ModifiedEvent, &callData2);
+  subject->InvokeEvent(vtkCommand::ModifiedEvent, &callData1);
+  CHECK_INT(static_cast<int>(broker->GetNumberOfCoalescedEvents()), 1000);
+  broker->ProcessEventQueue();
+  CHECK_INT(invocationCount, 5);
+
+  // Processing of the queue is requested once, when the first event is queued
+  std::vector<int> requestedDelays;
+  vtkNew<vtkCallbackCommand> requestProcessEventQueueCallback;
+  requestProcessEventQueueCallback->SetCallback(RecordProcessEventQueueRequest);
+  requestProcessEventQueueCallback->SetClientData(&requestedDelays);
+  broker->SetRequestProcessEventQueueCallback(requestProcessEventQueueCallback);
+  broker->SetCoalescingInterval(0.01);
+  subject->Modified();
+  subject->Modified();
+  CHECK_INT(static_cast<int>(requestedDelays.size()), 1);
+  CHECK_INT(requestedDelays[0], 10);
+  CHECK_INT(invocationCount, 5);
+  broker->ProcessEventQueue();
+  CHECK_INT(invocationCount, 6);
+  subject->Modified();
+  CHECK_INT(static_cast<int>(requestedDelays.size()), 2);
+  broker->ProcessEventQueue();
+  CHECK_INT(invocationCount, 7);
+  broker->SetCoalescingInterval(0.0);
+  broker->SetRequestProcessEventQueueCallback(nullptr);
+
+  // Changing the event mode processes the queue
+  subject->Modified();
+  broker->SetEventModeToSynchronous();
+  CHECK_INT(invocationCount, 8);
+  CHECK_INT(broker->GetNumberOfQueuedObservations(), 0);
+
+  // Timing counters
+  CHECK_INT(static_cast<int>(observation->GetInvocationCount()), 8);
+  CHECK_INT(static_cast<int>(broker->GetObserverInvocationCount(observer)), 8);
+  CHECK_BOOL(observation->GetMaximumElapsedTime() <= observation->GetTotalElapsedTime(), true);
+  CHECK_BOOL(broker->GetObserverTotalElapsedTime(observer) == observation->GetTotalElapsedTime(), true);
+  std::vector<vtkObservation*> observations;
+  broker->GetObservationsSortedByElapsedTime(observations);
+  CHECK_BOOL(std::find(observations.begin(), observations.end(), observation) != observations.end(), true);
+  for (size_t i = 1; i < observations.size(); ++i)
+    {
+    CHECK_BOOL(observations[i - 1]->GetTotalElapsedTime() >= observations[i]->GetTotalElapsedTime(), true);
+    }
+  broker->GetObservationsSortedByElapsedTime(observations, 1);
+  CHECK_INT(static_cast<int>(observations.size()), 1);
+  broker->PrintObservationTimings(std::cout);
+
+  broker->ResetObservationTimings();
+  CHECK_INT(static_cast<int>(observation->GetInvocationCount()), 0);
+  CHECK_INT(static_cast<int>(broker->GetNumberOfCoalescedEvents()), 0);
+
+  broker->RemoveObservation(observation);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,245 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Cjyx
+
+=========================================================================auto=*/
+
+// DMML includes
+#include "vtkDMMLCoreTestingMacros.h"
+#include "vtkDMMLScalarVolumeDisplayNode.h"
+#include "vtkImageAutoRangeCalculator.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkImageHistogramStatistics.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <cmath>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Image with uniformly distributed values in the range [0, 9999]
+vtkSmartPointer<vtkImageData> CreateImage(int seed)
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(200, 160, 90);
+  image->AllocateScalars(VTK_SHORT, 1);
+  short* voxels = static_cast<short*>(image->GetScalarPointer());
+  unsigned int state = static_cast<unsigned int>(seed);
+  vtkIdType numberOfVoxels = image->GetNumberOfPoints();
+  for (vtkIdType i = 0; i < numberOfVoxels; ++i)
+    {
+    state = state * 1664525u + 1013904223u;
+    voxels[i] = static_cast<short>((state >> 8) % 10000);
+    }
+  return image;
+}
+
+//----------------------------------------------------------------------------
+void SetVoxels(vtkImageData* image, const int extent[6], short value)
+{
+  for (int k = extent[4]; k <= extent[5]; ++k)
+    {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+      {
+      for (int i = extent[0]; i <= extent[1]; ++i)
+        {
+        *static_cast<short*>(image->GetScalarPointer(i, j, k)) = value;
+        }
+      }
+    }
+  image->Modified();
+}
+
+//----------------------------------------------------------------------------
+void ComputeExactRange(vtkImageData* image, double range[2])
+{
+  vtkNew<vtkImageAutoRangeCalculator> calculator;
+  calculator->SamplingOff();
+  calculator->ComputeAutoRange(image, range);
+}
+
+//----------------------------------------------------------------------------
+int TestExactRange()
+{
+  vtkSmartPointer<vtkImageData> image = CreateImage(1);
+  vtkIdType numberOfVoxels = image->GetNumberOfPoints();
+
+  vtkNew<vtkImageHistogramStatistics> histogramStatistics;
+  histogramStatistics->SetAutoRangePercentiles(0.1, 99.9);
+  histogramStatistics->SetAutoRangeExpansionFactors(0.0, 0.0);
+  histogramStatistics->SetInputData(image);
+  histogramStatistics->Update();
+  double* expectedRange = histogramStatistics->GetAutoRange();
+
+  vtkNew<vtkImageAutoRangeCalculator> calculator;
+  calculator->SamplingOff();
+  double range[2] = { 0.0, 0.0 };
+  CHECK_BOOL(calculator->ComputeAutoRange(image, range), true);
+  CHECK_INT(calculator->GetNumberOfProcessedVoxels(), numberOfVoxels);
+  CHECK_DOUBLE_TOLERANCE(range[0], expectedRange[0], 2.0);
+  CHECK_DOUBLE_TOLERANCE(range[1], expectedRange[1], 2.0);
+
+  // Unchanged image is not processed again
+  CHECK_BOOL(calculator->ComputeAutoRange(image, range), true);
+  CHECK_INT(calculator->GetNumberOfProcessedVoxels(), 0);
+
+  // Modified region within the histogram range: only image rows in the region are processed
+  int modifiedExtent[6] = { 10, 20, 10, 20, 40, 42 };
+  calculator->AddModifiedExtent(modifiedExtent);
+  SetVoxels(image, modifiedExtent, 5000);
+  CHECK_BOOL(calculator->ComputeAutoRange(image, range), true);
+  const vtkIdType rowLength = image->GetDimensions()[0];
+  CHECK_INT(calculator->GetNumberOfProcessedVoxels(), 11 * 3 * rowLength);
+  double exactRange[2] = { 0.0, 0.0 };
+  ComputeExactRange(image, exactRange);
+  CHECK_DOUBLE(range[0], exactRange[0]);
+  CHECK_DOUBLE(range[1], exactRange[1]);
+
+  // Multiple modifications: rows in overlapping extents are processed once
+  int modifiedExtent1[6] = { 0, 5, 0, 9, 0, 0 };
+  int modifiedExtent2[6] = { 50, 60, 5, 14, 0, 0 };
+  calculator->AddModifiedExtent(modifiedExtent1);
+  SetVoxels(image, modifiedExtent1, 100);
+  calculator->AddModifiedExtent(modifiedExtent2);
+  SetVoxels(image, modifiedExtent2, 9000);
+  CHECK_BOOL(calculator->ComputeAutoRange(image, range), true);
+  CHECK_INT(calculator->GetNumberOfProcessedVoxels(), 15 * rowLength);
+  ComputeExactRange(image, exactRange);
+  CHECK_DOUBLE(range[0], exactRange[0]);
+  CHECK_DOUBLE(range[1], exactRange[1]);
+
+  // Modified region outside of the image: nothing is processed
+  int outsideExtent[6] = { 300, 310, 0, 10, 0, 10 };
+  calculator->AddModifiedExtent(outsideExtent);
+  image->Modified();
+  CHECK_BOOL(calculator->ComputeAutoRange(image, range), true);
+  CHECK_INT(calculator->GetNumberOfProcessedVoxels(), 0);
+
+  // Modified values out of the histogram range: entire image is processed
+  int outlierExtent[6] = { 5, 5, 5, 5, 5, 5 };
+  calculator->AddModifiedExtent(outlierExtent);
+  SetVoxels(image, outlierExtent, 20000);
+  CHECK_BOOL(calculator->ComputeAutoRange(image, range), true);
+  CHECK_INT(calculator->GetNumberOfProcessedVoxels(), numberOfVoxels);
+  ComputeExactRange(image, exactRange);
+  CHECK_DOUBLE(range[0], exactRange[0]);
+  CHECK_DOUBLE(range[1], exactRange[1]);
+
+  // Modified without specifying the extent: entire image is processed
+  SetVoxels(image, modifiedExtent, 3);
+  CHECK_BOOL(calculator->ComputeAutoRange(image, range), true);
+  CHECK_INT(calculator->GetNumberOfProcessedVoxels(), numberOfVoxels);
+
+  // Extent specified after the image was modified: entire image is processed
+  SetVoxels(image, modifiedExtent, 4);
+  calculator->AddModifiedExtent(modifiedExtent);
+  CHECK_BOOL(calculator->ComputeAutoRange(image, range), true);
+  CHECK_INT(calculator->GetNumberOfProcessedVoxels(), numberOfVoxels);
+  ComputeExactRange(image, exactRange);
+  CHECK_DOUBLE(range[0], exactRange[0]);
+  CHECK_DOUBLE(range[1], exactRange[1]);
+
+  // Extent specified before the first computation: entire image is processed
+  vtkNew<vtkImageAutoRangeCalculator> newCalculator;
+  newCalculator->SamplingOff();
+  newCalculator->AddModifiedExtent(modifiedExtent);
+  SetVoxels(image, modifiedExtent, 5);
+  CHECK_BOOL(newCalculator->ComputeAutoRange(image, range), true);
+  CHECK_INT(newCalculator->GetNumberOfProcessedVoxels(), numberOfVoxels);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestSampledRange()
+{
+  vtkSmartPointer<vtkImageData> image = CreateImage(2);
+  double exactRange[2] = { 0.0, 0.0 };
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  ComputeExactRange(image, exactRange);
+  timer->StopTimer();
+  double exactTime = timer->GetElapsedTime();
+
+  const double tolerancePercent = 0.5;
+  vtkNew<vtkImageAutoRangeCalculator> calculator;
+  calculator->SetSamplingPercentileTolerance(tolerancePercent);
+  double range[2] = { 0.0, 0.0 };
+  timer->StartTimer();
+  CHECK_BOOL(calculator->ComputeAutoRange(image, range), true);
+  timer->StopTimer();
+  std::cout << "Auto range of " << image->GetNumberOfPoints() << " voxels: exact " << exactTime
+    << " s, sampled " << timer->GetElapsedTime() << " s" << std::endl;
+
+  CHECK_INT(calculator->GetNumberOfProcessedVoxels(), vtkImageAutoRangeCalculator::GetRequiredNumberOfSamples(tolerancePercent));
+  // Values are uniformly distributed in [0, 9999], percentile error translates to value error
+  double maximumValueError = 10000.0 * tolerancePercent / 100.0 + 2.0;
+  CHECK_DOUBLE_TOLERANCE(range[0], exactRange[0], maximumValueError);
+  CHECK_DOUBLE_TOLERANCE(range[1], exactRange[1], maximumValueError);
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestCachedResults()
+{
+  // Switching between images (e.g., sequence frames) reuses previous results
+  vtkSmartPointer<vtkImageData> frame1 = CreateImage(3);
+  vtkSmartPointer<vtkImageData> frame2 = CreateImage(4);
+  vtkNew<vtkImageAutoRangeCalculator> calculator;
+  double range1[2] = { 0.0, 0.0 };
+  double range2[2] = { 0.0, 0.0 };
+  CHECK_BOOL(calculator->ComputeAutoRange(frame1, range1), true);
+  CHECK_BOOL(calculator->ComputeAutoRange(frame2, range2), true);
+  CHECK_BOOL(calculator->GetNumberOfProcessedVoxels() > 0, true);
+  double range[2] = { 0.0, 0.0 };
+  CHECK_BOOL(calculator->ComputeAutoRange(frame1, range), true);
+  CHECK_INT(calculator->GetNumberOfProcessedVoxels(), 0);
+  CHECK_DOUBLE(range[0], range1[0]);
+  CHECK_DOUBLE(range[1], range1[1]);
+
+  // Changing parameters invalidates cached results
+  calculator->SetAutoRangePercentiles(1.0, 99.0);
+  CHECK_BOOL(calculator->ComputeAutoRange(frame1, range), true);
+  CHECK_BOOL(calculator->GetNumberOfProcessedVoxels() > 0, true);
+
+  // Images without scalars
+  vtkNew<vtkImageData> emptyImage;
+  CHECK_BOOL(calculator->ComputeAutoRange(emptyImage, range), false);
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestDisplayNode()
+{
+  vtkNew<vtkDMMLScalarVolumeDisplayNode> displayNode;
+  CHECK_NOT_NULL(displayNode->GetAutoRangeCalculator());
+  CHECK_DOUBLE(displayNode->GetAutoRangeCalculator()->GetAutoRangePercentiles()[0], 0.1);
+  CHECK_DOUBLE(displayNode->GetAutoRangeCalculator()->GetAutoRangePercentiles()[1], 99.9);
+  int extent[6] = { 0, 1, 0, 1, 0, 1 };
+  displayNode->AddImageDataModifiedExtent(extent);
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkImageAutoRangeCalculatorTest1(int , char * [] )
+{
+  CHECK_EXIT_SUCCESS(TestExactRange());
+  CHECK_EXIT_SUCCESS(TestSampledRange());
+  CHECK_EXIT_SUCCESS(TestCachedResults());
+  CHECK_EXIT_SUCCESS(TestDisplayNode());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,850 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#include "vtkCachedInverseWarpTransform.h"
+
+// DMML includes
+#include "vtkOrientedBSplineTransform.h"
+#include "vtkOrientedGridTransform.h"
+
+// VTK includes
+#include <vtkBSplineTransform.h>
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkGridTransform.h>
+#include <vtkImageData.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+/// Maximum number of times the Newton step is halved if it does not decrease the error
+const int MAXIMUM_NUMBER_OF_STEP_HALVINGS = 10;
+}
+
+//----------------------------------------------------------------------------
+class vtkCachedInverseWarpTransform::vtkInternal
+{
+public:
+  /// Source transform and parameters that the cache was computed for
+  struct CacheKey
+    {
+    vtkAbstractTransform* SourceTransform{nullptr};
+    vtkMTimeType SourceTransformMTime{0};
+    bool AutoCacheGeometry{true};
+    double Origin[3]{0.0, 0.0, 0.0};
+    double Spacing[3]{0.0, 0.0, 0.0};
+    int Dimensions[3]{0, 0, 0};
+    vtkIdType MaximumNumberOfCachePoints{0};
+    double InverseTolerance{0.0};
+    int InverseIterations{0};
+    double SingularityThreshold{0.0};
+
+    bool operator==(const CacheKey& other) const
+      {
+      return this->SourceTransform == other.SourceTransform
+        && this->SourceTransformMTime == other.SourceTransformMTime
+        && this->AutoCacheGeometry == other.AutoCacheGeometry
+        && std::equal(this->Origin, this->Origin + 3, other.Origin)
+        && std::equal(this->Spacing, this->Spacing + 3, other.Spacing)
+        && std::equal(this->Dimensions, this->Dimensions + 3, other.Dimensions)
+        && this->MaximumNumberOfCachePoints == other.MaximumNumberOfCachePoints
+        && this->InverseTolerance == other.InverseTolerance
+        && this->InverseIterations == other.InverseIterations
+        && this->SingularityThreshold == other.SingularityThreshold;
+      }
+    };
+
+  CacheKey Key;
+  bool KeyValid{false};
+
+  vtkSmartPointer<vtkImageData> Cache;
+  /// Direct access to the cache arrays (evaluated for each transformed point)
+  double* Displacements{nullptr};
+  float* InterpolationErrors{nullptr};
+  double Origin[3]{0.0, 0.0, 0.0};
+  double Spacing[3]{1.0, 1.0, 1.0};
+  int Dimensions[3]{0, 0, 0};
+
+  double MaximumCacheError{0.0};
+  vtkIdType NumberOfSingularCachePoints{0};
+};
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkCachedInverseWarpTransform);
+
+//----------------------------------------------------------------------------
+vtkCxxSetObjectMacro(vtkCachedInverseWarpTransform, SourceTransform, vtkAbstractTransform);
+
+//----------------------------------------------------------------------------
+vtkCachedInverseWarpTransform::vtkCachedInverseWarpTransform()
+{
+  this->SourceTransform = nullptr;
+  this->AutoCacheGeometry = true;
+  for (int i = 0; i < 3; ++i)
+    {
+    this->CacheOrigin[i] = 0.0;
+    this->CacheSpacing[i] = 1.0;
+    this->CacheDimensions[i] = 1;
+    }
+  this->MaximumNumberOfCachePoints = 8000000;
+  this->ResidualCheck = false;
+  this->InterpolationTolerance = 0.1;
+  this->SingularityThreshold = 0.01;
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkCachedInverseWarpTransform::~vtkCachedInverseWarpTransform()
+{
+  this->SetSourceTransform(nullptr);
+  delete this->Internal;
+  this->Internal = nullptr;
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedInverseWarpTransform::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "SourceTransform: " << this->SourceTransform << "\n";
+  if (this->SourceTransform)
+    {
+    this->SourceTransform->PrintSelf(os, indent.GetNextIndent());
+    }
+  os << indent << "AutoCacheGeometry: " << (this->AutoCacheGeometry ? "true" : "false") << "\n";
+  os << indent << "CacheOrigin: " << this->CacheOrigin[0] << " " << this->CacheOrigin[1] << " " << this->CacheOrigin[2] << "\n";
+  os << indent << "CacheSpacing: " << this->CacheSpacing[0] << " " << this->CacheSpacing[1] << " " << this->CacheSpacing[2] << "\n";
+  os << indent << "CacheDimensions: " << this->CacheDimensions[0] << " " << this->CacheDimensions[1] << " " << this->CacheDimensions[2] << "\n";
+  os << indent << "MaximumNumberOfCachePoints: " << this->MaximumNumberOfCachePoints << "\n";
+  os << indent << "ResidualCheck: " << (this->ResidualCheck ? "true" : "false") << "\n";
+  os << indent << "InterpolationTolerance: " << this->InterpolationTolerance << "\n";
+  os << indent << "SingularityThreshold: " << this->SingularityThreshold << "\n";
+  os << indent << "Cache: " << this->Internal->Cache.GetPointer() << "\n";
+  if (this->Internal->Cache)
+    {
+    os << indent << "MaximumCacheError: " << this->Internal->MaximumCacheError << "\n";
+    os << indent << "NumberOfSingularCachePoints: " << this->Internal->NumberOfSingularCachePoints << "\n";
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkAbstractTransform* vtkCachedInverseWarpTransform::MakeTransform()
+{
+  return vtkCachedInverseWarpTransform::New();
+}
+
+//----------------------------------------------------------------------------
+vtkMTimeType vtkCachedInverseWarpTransform::GetMTime()
+{
+  vtkMTimeType mtime = this->Superclass::GetMTime();
+  if (this->SourceTransform)
+    {
+    mtime = std::max(mtime, this->SourceTransform->GetMTime());
+    }
+  return mtime;
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedInverseWarpTransform::InternalDeepCopy(vtkAbstractTransform* transform)
+{
+  vtkCachedInverseWarpTransform* cachedTransform = static_cast<vtkCachedInverseWarpTransform*>(transform);
+
+  this->SetInverseTolerance(cachedTransform->InverseTolerance);
+  this->SetInverseIterations(cachedTransform->InverseIterations);
+  this->SetSourceTransform(cachedTransform->SourceTransform);
+  this->SetAutoCacheGeometry(cachedTransform->AutoCacheGeometry);
+  this->SetCacheOrigin(cachedTransform->CacheOrigin);
+  this->SetCacheSpacing(cachedTransform->CacheSpacing);
+  this->SetCacheDimensions(cachedTransform->CacheDimensions);
+  this->SetMaximumNumberOfCachePoints(cachedTransform->MaximumNumberOfCachePoints);
+  this->SetResidualCheck(cachedTransform->ResidualCheck);
+  this->SetInterpolationTolerance(cachedTransform->InterpolationTolerance);
+  this->SetSingularityThreshold(cachedTransform->SingularityThreshold);
+
+  // The cache image is never modified after it is computed, so it can be shared
+  *this->Internal = *cachedTransform->Internal;
+
+  if (this->InverseFlag != cachedTransform->InverseFlag)
+    {
+    this->InverseFlag = cachedTransform->InverseFlag;
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedInverseWarpTransform::InternalUpdate()
+{
+  if (this->SourceTransform)
+    {
+    this->SourceTransform->Update();
+    }
+  if (this->InverseFlag)
+    {
+    // Only the source transform is used, the cache is computed when it is needed
+    return;
+    }
+  this->UpdateCache();
+}
+
+//----------------------------------------------------------------------------
+bool vtkCachedInverseWarpTransform::ComputeAutoCacheGeometry(double origin[3], double spacing[3], int dimensions[3])
+{
+  vtkImageData* grid = nullptr;
+  vtkMatrix4x4* gridDirectionMatrix = nullptr;
+  // Additive bulk transform of B-spline transforms: transformed point is bulk(point) + displacement(point)
+  vtkMatrix4x4* bulkTransformMatrix = nullptr;
+  double displacementScale = 1.0;
+  double displacementShift = 0.0;
+  if (vtkOrientedGridTransform* orientedGridTransform = vtkOrientedGridTransform::SafeDownCast(this->SourceTransform))
+    {
+    grid = orientedGridTransform->GetDisplacementGrid();
+    gridDirectionMatrix = orientedGridTransform->GetGridDirectionMatrix();
+    displacementScale = orientedGridTransform->GetDisplacementScale();
+    displacementShift = orientedGridTransform->GetDisplacementShift();
+    }
+  else if (vtkOrientedBSplineTransform* orientedBSplineTransform = vtkOrientedBSplineTransform::SafeDownCast(this->SourceTransform))
+    {
+    grid = orientedBSplineTransform->GetCoefficientData();
+    gridDirectionMatrix = orientedBSplineTransform->GetGridDirectionMatrix();
+    bulkTransformMatrix = orientedBSplineTransform->GetBulkTransformMatrix();
+    displacementScale = orientedBSplineTransform->GetDisplacementScale();
+    }
+  else if (vtkGridTransform* gridTransform = vtkGridTransform::SafeDownCast(this->SourceTransform))
+    {
+    grid = gridTransform->GetDisplacementGrid();
+    displacementScale = gridTransform->GetDisplacementScale();
+    displacementShift = gridTransform->GetDisplacementShift();
+    }
+  else if (vtkBSplineTransform* bsplineTransform = vtkBSplineTransform::SafeDownCast(this->SourceTransform))
+    {
+    grid = bsplineTransform->GetCoefficientData();
+    displacementScale = bsplineTransform->GetDisplacementScale();
+    }
+  if (!grid || !grid->GetPointData()->GetScalars() || grid->GetNumberOfPoints() < 1)
+    {
+    return false;
+    }
+
+  // Bounding box of the grid in physical space (mapped by the bulk transform, if any)
+  double bounds[6] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN };
+  int* gridExtent = grid->GetExtent();
+  double* gridOrigin = grid->GetOrigin();
+  double* gridSpacing = grid->GetSpacing();
+  for (int corner = 0; corner < 8; ++corner)
+    {
+    double offset[3] =
+      {
+      gridExtent[(corner & 1) ? 1 : 0] * gridSpacing[0],
+      gridExtent[(corner & 2) ? 3 : 2] * gridSpacing[1],
+      gridExtent[(corner & 4) ? 5 : 4] * gridSpacing[2]
+      };
+    double position[4] = { 0.0, 0.0, 0.0, 1.0 };
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      position[axis] = gridOrigin[axis];
+      for (int gridAxis = 0; gridAxis < 3; ++gridAxis)
+        {
+        double direction = gridDirectionMatrix ? gridDirectionMatrix->GetElement(axis, gridAxis) : (axis == gridAxis ? 1.0 : 0.0);
+        position[axis] += direction * offset[gridAxis];
+        }
+      }
+    if (bulkTransformMatrix)
+      {
+      bulkTransformMatrix->MultiplyPoint(position, position);
+      }
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      bounds[axis * 2] = std::min(bounds[axis * 2], position[axis]);
+      bounds[axis * 2 + 1] = std::max(bounds[axis * 2 + 1], position[axis]);
+      }
+    }
+
+  // Inverse of points near the boundary may be anywhere within the largest displacement
+  double maximumDisplacement = grid->GetPointData()->GetScalars()->GetMaxNorm() * std::abs(displacementScale)
+    + std::abs(displacementShift) * std::sqrt(3.0);
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    bounds[axis * 2] -= maximumDisplacement;
+    bounds[axis * 2 + 1] += maximumDisplacement;
+    }
+
+  // Use isotropic spacing, with approximately as many points as the source grid
+  vtkIdType numberOfPoints = std::min(grid->GetNumberOfPoints(), this->MaximumNumberOfCachePoints);
+  numberOfPoints = std::max(numberOfPoints, vtkIdType(8));
+  double volume = 1.0;
+  int numberOfAxes = 0;
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    double length = bounds[axis * 2 + 1] - bounds[axis * 2];
+    if (length > 0)
+      {
+      volume *= length;
+      ++numberOfAxes;
+      }
+    }
+  if (numberOfAxes == 0)
+    {
+    return false;
+    }
+  double isotropicSpacing = std::pow(volume / numberOfPoints, 1.0 / numberOfAxes);
+  while (true)
+    {
+    vtkIdType cacheNumberOfPoints = 1;
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      double length = bounds[axis * 2 + 1] - bounds[axis * 2];
+      origin[axis] = bounds[axis * 2];
+      if (length > 0)
+        {
+        dimensions[axis] = std::max(2, static_cast<int>(std::ceil(length / isotropicSpacing)) + 1);
+        spacing[axis] = length / (dimensions[axis] - 1);
+        }
+      else
+        {
+        dimensions[axis] = 1;
+        spacing[axis] = 1.0;
+        }
+      cacheNumberOfPoints *= dimensions[axis];
+      }
+    if (cacheNumberOfPoints <= this->MaximumNumberOfCachePoints)
+      {
+      break;
+      }
+    isotropicSpacing *= 1.1;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedInverseWarpTransform::UpdateCache()
+{
+  vtkInternal* internal = this->Internal;
+  if (!this->SourceTransform)
+    {
+    internal->Cache = nullptr;
+    internal->KeyValid = false;
+    return;
+    }
+
+  vtkInternal::CacheKey key;
+  key.SourceTransform = this->SourceTransform;
+  key.SourceTransformMTime = this->SourceTransform->GetMTime();
+  key.AutoCacheGeometry = this->AutoCacheGeometry;
+  if (!this->AutoCacheGeometry)
+    {
+    std::copy(this->CacheOrigin, this->CacheOrigin + 3, key.Origin);
+    std::copy(this->CacheSpacing, this->CacheSpacing + 3, key.Spacing);
+    std::copy(this->CacheDimensions, this->CacheDimensions + 3, key.Dimensions);
+    }
+  key.MaximumNumberOfCachePoints = this->MaximumNumberOfCachePoints;
+  key.InverseTolerance = this->InverseTolerance;
+  key.InverseIterations = this->InverseIterations;
+  key.SingularityThreshold = this->SingularityThreshold;
+  if (internal->KeyValid && internal->Key == key)
+    {
+    // cache is up-to-date
+    return;
+    }
+  internal->Key = key;
+  internal->KeyValid = true;
+
+  internal->Cache = nullptr;
+  internal->Displacements = nullptr;
+  internal->InterpolationErrors = nullptr;
+  internal->MaximumCacheError = 0.0;
+  internal->NumberOfSingularCachePoints = 0;
+
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  int dimensions[3] = { 0, 0, 0 };
+  if (this->AutoCacheGeometry)
+    {
+    if (!this->ComputeAutoCacheGeometry(origin, spacing, dimensions))
+      {
+      vtkWarningMacro("vtkCachedInverseWarpTransform::UpdateCache: cache geometry cannot be determined for "
+        << this->SourceTransform->GetClassName() << ". Inverse is computed iteratively for each point.");
+      return;
+      }
+    }
+  else
+    {
+    std::copy(this->CacheOrigin, this->CacheOrigin + 3, origin);
+    std::copy(this->CacheSpacing, this->CacheSpacing + 3, spacing);
+    std::copy(this->CacheDimensions, this->CacheDimensions + 3, dimensions);
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      if (dimensions[axis] < 1 || spacing[axis] <= 0.0)
+        {
+        vtkErrorMacro("vtkCachedInverseWarpTransform::UpdateCache failed: invalid cache geometry");
+        return;
+        }
+      }
+    }
+
+  vtkNew<vtkImageData> cache;
+  cache->SetOrigin(origin);
+  cache->SetSpacing(spacing);
+  cache->SetDimensions(dimensions);
+  vtkIdType numberOfPoints = cache->GetNumberOfPoints();
+  vtkNew<vtkDoubleArray> displacementArray;
+  displacementArray->SetName("InverseDisplacement");
+  displacementArray->SetNumberOfComponents(3);
+  displacementArray->SetNumberOfTuples(numberOfPoints);
+  cache->GetPointData()->SetVectors(displacementArray);
+  vtkNew<vtkFloatArray> errorArray;
+  errorArray->SetName("InverseError");
+  errorArray->SetNumberOfTuples(numberOfPoints);
+  cache->GetPointData()->SetScalars(errorArray);
+
+  double* displacements = displacementArray->GetPointer(0);
+  float* errors = errorArray->GetPointer(0);
+  vtkAbstractTransform* sourceTransform = this->SourceTransform;
+  const double singularityThreshold = this->SingularityThreshold;
+
+  // Each row is solved sequentially so that the inverse at the previous point can be used
+  // as initial estimate; rows are processed in parallel.
+  vtkSMPThreadLocal<vtkIdType> localNumberOfSingularPoints(0);
+  vtkIdType numberOfRows = static_cast<vtkIdType>(dimensions[1]) * dimensions[2];
+  vtkSMPTools::For(0, numberOfRows, [&](vtkIdType beginRow, vtkIdType endRow)
+    {
+    vtkIdType& numberOfSingularPoints = localNumberOfSingularPoints.Local();
+    for (vtkIdType row = beginRow; row < endRow; ++row)
+      {
+      double point[3] =
+        {
+        0.0,
+        origin[1] + (row % dimensions[1]) * spacing[1],
+        origin[2] + (row / dimensions[1]) * spacing[2]
+        };
+      bool previousValid = false;
+      double previousDisplacement[3] = { 0.0, 0.0, 0.0 };
+      for (int i = 0; i < dimensions[0]; ++i)
+        {
+        point[0] = origin[0] + i * spacing[0];
+        double inverse[3];
+        bool converged = false;
+        if (previousValid)
+          {
+          inverse[0] = point[0] + previousDisplacement[0];
+          inverse[1] = point[1] + previousDisplacement[1];
+          inverse[2] = point[2] + previousDisplacement[2];
+          converged = this->RefineInverse(point, inverse);
+          }
+        if (!converged)
+          {
+          // First-order estimate: if F(x) = x + d(x) then x is approximately y - d(y)
+          double transformedPoint[3];
+          sourceTransform->InternalTransformPoint(point, transformedPoint);
+          inverse[0] = 2.0 * point[0] - transformedPoint[0];
+          inverse[1] = 2.0 * point[1] - transformedPoint[1];
+          inverse[2] = 2.0 * point[2] - transformedPoint[2];
+          converged = this->RefineInverse(point, inverse);
+          }
+
+        double transformedInverse[3];
+        double derivative[3][3];
+        sourceTransform->InternalTransformDerivative(inverse, transformedInverse, derivative);
+        vtkIdType pointId = i + row * dimensions[0];
+        double* displacement = displacements + pointId * 3;
+        displacement[0] = inverse[0] - point[0];
+        displacement[1] = inverse[1] - point[1];
+        displacement[2] = inverse[2] - point[2];
+        if (!converged || vtkMath::Determinant3x3(derivative) < singularityThreshold)
+          {
+          errors[pointId] = VTK_FLOAT_MAX;
+          ++numberOfSingularPoints;
+          previousValid = false;
+          }
+        else
+          {
+          double error = std::sqrt(vtkMath::Distance2BetweenPoints(transformedInverse, point));
+          errors[pointId] = static_cast<float>(error);
+          std::copy(displacement, displacement + 3, previousDisplacement);
+          previousValid = true;
+          }
+        }
+      }
+    });
+
+  for (vtkIdType numberOfSingularPoints : localNumberOfSingularPoints)
+    {
+    internal->NumberOfSingularCachePoints += numberOfSingularPoints;
+    }
+
+  // Estimate the interpolation error of each cell at the cell center, where the error
+  // of trilinear interpolation is typically the largest.
+  int cellDimensions[3] = { 1, 1, 1 };
+  double cellCenterOffset[3] = { 0.0, 0.0, 0.0 };
+  vtkIdType cornerIncrements[3] = { 0, 0, 0 };
+  vtkIdType pointIncrement = 1;
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    if (dimensions[axis] > 1)
+      {
+      cellDimensions[axis] = dimensions[axis] - 1;
+      cellCenterOffset[axis] = 0.5 * spacing[axis];
+      cornerIncrements[axis] = pointIncrement;
+      }
+    pointIncrement *= dimensions[axis];
+    }
+  vtkIdType numberOfCells = static_cast<vtkIdType>(cellDimensions[0]) * cellDimensions[1] * cellDimensions[2];
+  vtkNew<vtkFloatArray> interpolationErrorArray;
+  interpolationErrorArray->SetName("InterpolationError");
+  interpolationErrorArray->SetNumberOfTuples(numberOfCells);
+  cache->GetCellData()->SetScalars(interpolationErrorArray);
+  float* interpolationErrors = interpolationErrorArray->GetPointer(0);
+
+  vtkSMPThreadLocal<double> localMaximumError(0.0);
+  vtkSMPTools::For(0, numberOfCells, [&](vtkIdType beginCell, vtkIdType endCell)
+    {
+    double& maximumError = localMaximumError.Local();
+    for (vtkIdType cellId = beginCell; cellId < endCell; ++cellId)
+      {
+      vtkIdType cellIndex[3] =
+        {
+        cellId % cellDimensions[0],
+        (cellId / cellDimensions[0]) % cellDimensions[1],
+        cellId / (static_cast<vtkIdType>(cellDimensions[0]) * cellDimensions[1])
+        };
+      vtkIdType basePointId = cellIndex[0] + dimensions[0] * (cellIndex[1] + dimensions[1] * cellIndex[2]);
+      float error = 0.0f;
+      double displacement[3] = { 0.0, 0.0, 0.0 };
+      for (int corner = 0; corner < 8; ++corner)
+        {
+        vtkIdType pointId = basePointId
+          + ((corner & 1) ? cornerIncrements[0] : 0)
+          + ((corner & 2) ? cornerIncrements[1] : 0)
+          + ((corner & 4) ? cornerIncrements[2] : 0);
+        error = std::max(error, errors[pointId]);
+        displacement[0] += 0.125 * displacements[pointId * 3];
+        displacement[1] += 0.125 * displacements[pointId * 3 + 1];
+        displacement[2] += 0.125 * displacements[pointId * 3 + 2];
+        }
+      if (error < VTK_FLOAT_MAX)
+        {
+        double center[3];
+        double inverse[3];
+        for (int axis = 0; axis < 3; ++axis)
+          {
+          center[axis] = origin[axis] + cellIndex[axis] * spacing[axis] + cellCenterOffset[axis];
+          inverse[axis] = center[axis] + displacement[axis];
+          }
+        double transformedInverse[3];
+        sourceTransform->InternalTransformPoint(inverse, transformedInverse);
+        error = std::max(error, static_cast<float>(std::sqrt(vtkMath::Distance2BetweenPoints(transformedInverse, center))));
+        maximumError = std::max(maximumError, static_cast<double>(error));
+        }
+      interpolationErrors[cellId] = error;
+      }
+    });
+
+  for (double maximumError : localMaximumError)
+    {
+    internal->MaximumCacheError = std::max(internal->MaximumCacheError, maximumError);
+    }
+
+  internal->Cache = cache;
+  internal->Displacements = displacements;
+  internal->InterpolationErrors = interpolationErrors;
+  std::copy(origin, origin + 3, internal->Origin);
+  std::copy(spacing, spacing + 3, internal->Spacing);
+  std::copy(dimensions, dimensions + 3, internal->Dimensions);
+}
+
+//----------------------------------------------------------------------------
+bool vtkCachedInverseWarpTransform::InterpolateInverse(const double in[3], double out[3], double& estimatedError)
+{
+  vtkInternal* internal = this->Internal;
+  bool inside = true;
+  int baseIndex[3] = { 0, 0, 0 };
+  vtkIdType increments[3] = { 0, 0, 0 };
+  double fraction[3] = { 0.0, 0.0, 0.0 };
+  vtkIdType pointIncrement = 1;
+  int cellDimensions[3] = { 1, 1, 1 };
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    int dimension = internal->Dimensions[axis];
+    double index = (in[axis] - internal->Origin[axis]) / internal->Spacing[axis];
+    if (dimension < 2)
+      {
+      // single slice: no interpolation along this axis
+      inside = inside && std::abs(index) < 1e-6;
+      }
+    else
+      {
+      if (index < 0.0 || index > dimension - 1)
+        {
+        inside = false;
+        index = std::min(std::max(index, 0.0), static_cast<double>(dimension - 1));
+        }
+      baseIndex[axis] = std::min(static_cast<int>(index), dimension - 2);
+      fraction[axis] = index - baseIndex[axis];
+      increments[axis] = pointIncrement;
+      cellDimensions[axis] = dimension - 1;
+      }
+    pointIncrement *= dimension;
+    }
+  vtkIdType basePointId = baseIndex[0]
+    + internal->Dimensions[0] * (baseIndex[1] + static_cast<vtkIdType>(internal->Dimensions[1]) * baseIndex[2]);
+
+  vtkIdType cellId = baseIndex[0]
+    + cellDimensions[0] * (baseIndex[1] + static_cast<vtkIdType>(cellDimensions[1]) * baseIndex[2]);
+
+  double displacement[3] = { 0.0, 0.0, 0.0 };
+  for (int corner = 0; corner < 8; ++corner)
+    {
+    double weight = 1.0;
+    vtkIdType pointId = basePointId;
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      if (corner & (1 << axis))
+        {
+        weight *= fraction[axis];
+        pointId += increments[axis];
+        }
+      else
+        {
+        weight *= 1.0 - fraction[axis];
+        }
+      }
+    if (weight == 0.0)
+      {
+      continue;
+      }
+    const double* cornerDisplacement = internal->Displacements + pointId * 3;
+    displacement[0] += weight * cornerDisplacement[0];
+    displacement[1] += weight * cornerDisplacement[1];
+    displacement[2] += weight * cornerDisplacement[2];
+    }
+
+  out[0] = in[0] + displacement[0];
+  out[1] = in[1] + displacement[1];
+  out[2] = in[2] + displacement[2];
+  estimatedError = inside ? internal->InterpolationErrors[cellId] : VTK_FLOAT_MAX;
+  return inside;
+}
+
+//----------------------------------------------------------------------------
+bool vtkCachedInverseWarpTransform::RefineInverse(const double in[3], double inverse[3])
+{
+  double toleranceSquared = this->InverseTolerance * this->InverseTolerance;
+
+  double transformedPoint[3];
+  double derivative[3][3];
+  this->SourceTransform->InternalTransformDerivative(inverse, transformedPoint, derivative);
+  double delta[3] = { transformedPoint[0] - in[0], transformedPoint[1] - in[1], transformedPoint[2] - in[2] };
+  double errorSquared = vtkMath::Dot(delta, delta);
+
+  for (int iteration = 0; iteration < this->InverseIterations; ++iteration)
+    {
+    if (errorSquared <= toleranceSquared)
+      {
+      return true;
+      }
+
+    // Newton step (fixed-point step if the derivative is singular)
+    double step[3] = { delta[0], delta[1], delta[2] };
+    if (std::abs(vtkMath::Determinant3x3(derivative)) > 1e-12)
+      {
+      double inverseDerivative[3][3];
+      vtkMath::Invert3x3(derivative, inverseDerivative);
+      vtkMath::Multiply3x3(inverseDerivative, delta, step);
+      }
+
+    // Halve the step until the error decreases
+    bool improved = false;
+    double stepScale = 1.0;
+    for (int halving = 0; halving < MAXIMUM_NUMBER_OF_STEP_HALVINGS; ++halving, stepScale *= 0.5)
+      {
+      double candidate[3] =
+        {
+        inverse[0] - stepScale * step[0],
+        inverse[1] - stepScale * step[1],
+        inverse[2] - stepScale * step[2]
+        };
+      double candidateDerivative[3][3];
+      this->SourceTransform->InternalTransformDerivative(candidate, transformedPoint, candidateDerivative);
+      double candidateDelta[3] = { transformedPoint[0] - in[0], transformedPoint[1] - in[1], transformedPoint[2] - in[2] };
+      double candidateErrorSquared = vtkMath::Dot(candidateDelta, candidateDelta);
+      if (candidateErrorSquared < errorSquared)
+        {
+        std::copy(candidate, candidate + 3, inverse);
+        std::copy(candidateDelta, candidateDelta + 3, delta);
+        for (int row = 0; row < 3; ++row)
+          {
+          std::copy(candidateDerivative[row], candidateDerivative[row] + 3, derivative[row]);
+          }
+        errorSquared = candidateErrorSquared;
+        improved = true;
+        break;
+        }
+      }
+    if (!improved)
+      {
+      // local minimum of the error (typically near a singularity)
+      break;
+      }
+    }
+  return errorSquared <= toleranceSquared;
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedInverseWarpTransform::ForwardTransformPoint(const double in[3], double out[3])
+{
+  if (!this->SourceTransform)
+    {
+    std::copy(in, in + 3, out);
+    return;
+    }
+
+  if (!this->Internal->Cache)
+    {
+    // No cache, compute the inverse iteratively
+    double transformedPoint[3];
+    this->SourceTransform->InternalTransformPoint(in, transformedPoint);
+    out[0] = 2.0 * in[0] - transformedPoint[0];
+    out[1] = 2.0 * in[1] - transformedPoint[1];
+    out[2] = 2.0 * in[2] - transformedPoint[2];
+    this->RefineInverse(in, out);
+    return;
+    }
+
+  double estimatedError = 0.0;
+  this->InterpolateInverse(in, out, estimatedError);
+  if (!this->ResidualCheck && estimatedError <= this->InterpolationTolerance)
+    {
+    // Interpolation is accurate in this cache cell
+    return;
+    }
+
+  // Refine the interpolated inverse (only a residual check if it is already accurate)
+  this->RefineInverse(in, out);
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedInverseWarpTransform::ForwardTransformPoint(const float in[3], float out[3])
+{
+  double inDouble[3] = { in[0], in[1], in[2] };
+  double outDouble[3];
+  this->ForwardTransformPoint(inDouble, outDouble);
+  out[0] = static_cast<float>(outDouble[0]);
+  out[1] = static_cast<float>(outDouble[1]);
+  out[2] = static_cast<float>(outDouble[2]);
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedInverseWarpTransform::ForwardTransformDerivative(const double in[3], double out[3], double derivative[3][3])
+{
+  this->ForwardTransformPoint(in, out);
+  if (!this->SourceTransform)
+    {
+    vtkMath::Identity3x3(derivative);
+    return;
+    }
+  // Derivative of the inverse is the inverse of the derivative of the source transform
+  double transformedPoint[3];
+  this->SourceTransform->InternalTransformDerivative(out, transformedPoint, derivative);
+  vtkMath::Invert3x3(derivative, derivative);
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedInverseWarpTransform::ForwardTransformDerivative(const float in[3], float out[3], float derivative[3][3])
+{
+  double inDouble[3] = { in[0], in[1], in[2] };
+  double outDouble[3];
+  double derivativeDouble[3][3];
+  this->ForwardTransformDerivative(inDouble, outDouble, derivativeDouble);
+  for (int i = 0; i < 3; ++i)
+    {
+    out[i] = static_cast<float>(outDouble[i]);
+    for (int j = 0; j < 3; ++j)
+      {
+      derivative[i][j] = static_cast<float>(derivativeDouble[i][j]);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedInverseWarpTransform::InverseTransformPoint(const double in[3], double out[3])
+{
+  if (!this->SourceTransform)
+    {
+    std::copy(in, in + 3, out);
+    return;
+    }
+  this->SourceTransform->InternalTransformPoint(in, out);
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedInverseWarpTransform::InverseTransformPoint(const float in[3], float out[3])
+{
+  if (!this->SourceTransform)
+    {
+    std::copy(in, in + 3, out);
+    return;
+    }
+  this->SourceTransform->InternalTransformPoint(in, out);
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedInverseWarpTransform::InverseTransformDerivative(const double in[3], double out[3], double derivative[3][3])
+{
+  if (!this->SourceTransform)
+    {
+    std::copy(in, in + 3, out);
+    vtkMath::Identity3x3(derivative);
+    return;
+    }
+  this->SourceTransform->InternalTransformDerivative(in, out, derivative);
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedInverseWarpTransform::InverseTransformDerivative(const float in[3], float out[3], float derivative[3][3])
+{
+  if (!this->SourceTransform)
+    {
+    std::copy(in, in + 3, out);
+    vtkMath::Identity3x3(derivative);
+    return;
+    }
+  this->SourceTransform->InternalTransformDerivative(in, out, derivative);
+}
+
+//----------------------------------------------------------------------------
+vtkImageData* vtkCachedInverseWarpTransform::GetInverseDisplacementCache()
+{
+  // The cache is not updated automatically if this transform is inverted, therefore update it here
+  this->Update();
+  this->UpdateCache();
+  return this->Internal->Cache;
+}
+
+//----------------------------------------------------------------------------
+double vtkCachedInverseWarpTransform::GetMaximumCacheError()
+{
+  return this->GetInverseDisplacementCache() ? this->Internal->MaximumCacheError : 0.0;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCachedInverseWarpTransform::GetNumberOfSingularCachePoints()
+{
+  return this->GetInverseDisplacementCache() ? this->Internal->NumberOfSingularCachePoints : 0;
+}
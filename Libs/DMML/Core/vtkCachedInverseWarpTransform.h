@@ -0,0 +1,172 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#ifndef __vtkCachedInverseWarpTransform_h
+#define __vtkCachedInverseWarpTransform_h
+
+// DMML includes
+#include "vtkDMML.h"
+
+// VTK includes
+#include <vtkWarpTransform.h>
+
+class vtkImageData;
+
+/// \brief Inverse of a warp transform, accelerated by a precomputed inverse displacement field.
+///
+/// Inverse of grid and B-spline transforms can only be computed by iteratively solving
+/// the transform equation for each point, which is very slow when many points are transformed
+/// (for example, when hardening a transform on a large model or resampling a volume).
+/// This transform computes the inverse of the SourceTransform: first the inverse is computed
+/// at each point of a regular grid (the inverse displacement field cache), in parallel; then
+/// the inverse at any point is obtained by interpolating this displacement field.
+///
+/// The interpolation error is estimated at the center of each cache cell. Points in cells where
+/// the estimated error is larger than InterpolationTolerance (for example, near singularities,
+/// where the source transform folds space and so interpolation of the inverse is not accurate)
+/// are refined iteratively, starting from the interpolated position. Points outside the cache
+/// are computed iteratively.
+///
+/// The cache is recomputed when the source transform or cache parameters are modified.
+/// Inverting this transform gives a transform that uses the source transform directly.
+class VTK_DMML_EXPORT vtkCachedInverseWarpTransform : public vtkWarpTransform
+{
+public:
+  static vtkCachedInverseWarpTransform *New();
+  vtkTypeMacro(vtkCachedInverseWarpTransform, vtkWarpTransform);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Transform that is inverted by this transform.
+  /// If the cache geometry is computed automatically then it must be a grid or B-spline transform.
+  virtual void SetSourceTransform(vtkAbstractTransform* transform);
+  vtkGetObjectMacro(SourceTransform, vtkAbstractTransform);
+
+  /// Compute cache geometry from the grid of the source transform.
+  /// The cache covers the region of the source transform grid and its transformed image,
+  /// and it contains approximately as many points as the source transform grid
+  /// (at most MaximumNumberOfCachePoints). Enabled by default.
+  vtkSetMacro(AutoCacheGeometry, bool);
+  vtkGetMacro(AutoCacheGeometry, bool);
+  vtkBooleanMacro(AutoCacheGeometry, bool);
+
+  /// Geometry of the inverse displacement field cache.
+  /// Only used if AutoCacheGeometry is disabled.
+  vtkSetVector3Macro(CacheOrigin, double);
+  vtkGetVector3Macro(CacheOrigin, double);
+  vtkSetVector3Macro(CacheSpacing, double);
+  vtkGetVector3Macro(CacheSpacing, double);
+  vtkSetVector3Macro(CacheDimensions, int);
+  vtkGetVector3Macro(CacheDimensions, int);
+
+  /// Maximum number of points in an automatically computed cache geometry.
+  /// Default is 8 million (requires 256MB memory).
+  vtkSetClampMacro(MaximumNumberOfCachePoints, vtkIdType, 8, VTK_ID_MAX);
+  vtkGetMacro(MaximumNumberOfCachePoints, vtkIdType);
+
+  /// Check the error of each interpolated inverse by transforming it with the source transform
+  /// and refine it until the error is below InverseTolerance. This gives the same accuracy as
+  /// the iterative inverse, but it is only slightly faster. Disabled by default.
+  vtkSetMacro(ResidualCheck, bool);
+  vtkGetMacro(ResidualCheck, bool);
+  vtkBooleanMacro(ResidualCheck, bool);
+
+  /// Interpolated inverse is used without refinement in cache cells where the estimated
+  /// interpolation error is below this value (if ResidualCheck is disabled).
+  /// Default is 0.1 (in physical units, typically millimeters).
+  vtkSetMacro(InterpolationTolerance, double);
+  vtkGetMacro(InterpolationTolerance, double);
+
+  /// Cache points where the determinant of the Jacobian of the source transform is below
+  /// this value are considered singular. Points that are transformed near singular cache
+  /// points are always computed iteratively. Default is 0.01.
+  vtkSetMacro(SingularityThreshold, double);
+  vtkGetMacro(SingularityThreshold, double);
+
+  /// Return the inverse displacement field cache (updated if needed).
+  /// Point data contains the "InverseDisplacement" vector and the "InverseError" scalar,
+  /// which is the distance between the cache point and its inverse transformed by the source transform
+  /// (VTK_FLOAT_MAX if the source transform is singular at the point).
+  /// Cell data contains the "InterpolationError" scalar, which is the largest of the errors
+  /// at the cell corners and at the cell center, where the inverse is interpolated
+  /// (VTK_FLOAT_MAX if the source transform is singular at any corner).
+  /// Returns nullptr if the cache cannot be computed.
+  vtkImageData* GetInverseDisplacementCache();
+
+  /// Maximum estimated error of the interpolated inverse in non-singular cache cells (updated if needed).
+  double GetMaximumCacheError();
+
+  /// Number of cache points where the source transform is singular or the inverse did not converge (updated if needed).
+  vtkIdType GetNumberOfSingularCachePoints();
+
+  /// Make another transform of the same type.
+  vtkAbstractTransform* MakeTransform() override;
+
+  /// Get the MTime (including the source transform).
+  vtkMTimeType GetMTime() override;
+
+protected:
+  vtkCachedInverseWarpTransform();
+  ~vtkCachedInverseWarpTransform() override;
+
+  /// Transform a point by the cached inverse of the source transform
+  void ForwardTransformPoint(const float in[3], float out[3]) override;
+  void ForwardTransformPoint(const double in[3], double out[3]) override;
+
+  void ForwardTransformDerivative(const float in[3], float out[3], float derivative[3][3]) override;
+  void ForwardTransformDerivative(const double in[3], double out[3], double derivative[3][3]) override;
+
+  /// Inverse of this transform is the source transform
+  void InverseTransformPoint(const float in[3], float out[3]) override;
+  void InverseTransformPoint(const double in[3], double out[3]) override;
+
+  void InverseTransformDerivative(const float in[3], float out[3], float derivative[3][3]) override;
+  void InverseTransformDerivative(const double in[3], double out[3], double derivative[3][3]) override;
+
+  /// Update the cache if the source transform or cache parameters changed
+  void InternalUpdate() override;
+
+  /// Copy settings and the cache (the cache is not modified after it is computed, therefore it is shared)
+  void InternalDeepCopy(vtkAbstractTransform* transform) override;
+
+  /// Compute origin, spacing, and dimensions of the cache from the source transform grid
+  /// (and bulk transform of B-spline transforms). Returns false if the source transform is not a grid or B-spline transform.
+  bool ComputeAutoCacheGeometry(double origin[3], double spacing[3], int dimensions[3]);
+
+  /// Compute the inverse displacement field cache if the source transform or cache parameters changed
+  void UpdateCache();
+
+  /// Compute an approximate inverse by interpolating the cache.
+  /// Returns the estimated interpolation error of the cache cell that contains the input point
+  /// in estimatedError (VTK_FLOAT_MAX if the point is outside the cache).
+  bool InterpolateInverse(const double in[3], double out[3], double& estimatedError);
+
+  /// Iteratively refine the inverse of the source transform at point in,
+  /// starting from the initial estimate in inverse. Returns true if converged.
+  bool RefineInverse(const double in[3], double inverse[3]);
+
+  vtkAbstractTransform* SourceTransform;
+
+  bool AutoCacheGeometry;
+  double CacheOrigin[3];
+  double CacheSpacing[3];
+  int CacheDimensions[3];
+  vtkIdType MaximumNumberOfCachePoints;
+  bool ResidualCheck;
+  double InterpolationTolerance;
+  double SingularityThreshold;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkCachedInverseWarpTransform(const vtkCachedInverseWarpTransform&) = delete;
+  void operator=(const vtkCachedInverseWarpTransform&) = delete;
+};
+
+#endif
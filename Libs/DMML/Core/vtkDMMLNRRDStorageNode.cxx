@@ -587,15 +587,15 @@ void vtkDMMLNRRDStorageNode::InitializeSupportedWriteFileTypes()
 //----------------------------------------------------------------------------
 int vtkDMMLNRRDStorageNode::GetGzipCompressionLevelFromCompressionParameter(std::string compressionParameter)
 {
-  if (compressionParameter == this->GetCompressionParameterFastest())
+  if (compressionParameter == vtkDMMLNRRDStorageNode::GetCompressionParameterFastest())
     {
     return 1;
     }
-  else if(compressionParameter == this->GetCompressionParameterNormal())
+  else if(compressionParameter == vtkDMMLNRRDStorageNode::GetCompressionParameterNormal())
     {
     return 6;
     }
-  else if (compressionParameter == this->GetCompressionParameterMinimumSize())
+  else if (compressionParameter == vtkDMMLNRRDStorageNode::GetCompressionParameterMinimumSize())
     {
     return 9;
     }
@@ -67,11 +67,15 @@ class VTK_DMML_EXPORT vtkDMMLNRRDStorageNode : public vtkDMMLStorageNode
   void ConfigureForDataExchange() override;
 
   /// Compression parameter corresponding to minimum compression (fast)
-  std::string GetCompressionParameterFastest() { return "gzip_fastest"; };
+  static std::string GetCompressionParameterFastest() { return "gzip_fastest"; };
   /// Compression parameter corresponding to normal compression
-  std::string GetCompressionParameterNormal() { return "gzip_normal"; };
+  static std::string GetCompressionParameterNormal() { return "gzip_normal"; };
   /// Compression parameter corresponding to maximum compression (slow)
-  std::string GetCompressionParameterMinimumSize() { return "gzip_minimum_size"; };
+  static std::string GetCompressionParameterMinimumSize() { return "gzip_minimum_size"; };
+
+  /// Convert compression parameter string to gzip compression level.
+  /// Also used by other storage nodes that write NRRD files (for example segmentations).
+  static int GetGzipCompressionLevelFromCompressionParameter(std::string parameter);
 
 protected:
   vtkDMMLNRRDStorageNode();
@@ -91,9 +95,6 @@ protected:
   /// Write data from a  referenced node
   int WriteDataInternal(vtkDMMLNode *refNode) override;
 
-  /// Convert compression parameter string to gzip compression level
-  int GetGzipCompressionLevelFromCompressionParameter(std::string parameter);
-
   int CenterImage;
 };
 
@@ -99,12 +99,20 @@ void vtkDMMLParser::StartElement(const char* tagName, const char** atts)
     // children items named SubjectHierarchyItem.
     // Another possibility is that it's part of a scene view, in which case we need to access the
     // last node in the scene view's snapshot scene
-    vtkDMMLSubjectHierarchyNode* subjectHierarchyNode = vtkDMMLSubjectHierarchyNode::SafeDownCast(
-      this->NodeCollection->GetItemAsObject(this->NodeCollection->GetNumberOfItems()-1) );
+    vtkObject* lastNode = nullptr;
+    if (this->LastCollectedNode && this->LastCollectedNodeCount == this->NodeCollection->GetNumberOfItems())
+      {
+      lastNode = this->LastCollectedNode;
+      }
+    else
+      {
+      // the collection was modified externally
+      lastNode = this->NodeCollection->GetItemAsObject(this->NodeCollection->GetNumberOfItems()-1);
+      }
+    vtkDMMLSubjectHierarchyNode* subjectHierarchyNode = vtkDMMLSubjectHierarchyNode::SafeDownCast(lastNode);
     if (!subjectHierarchyNode)
       {
-      vtkDMMLSceneViewNode* sceneViewNode = vtkDMMLSceneViewNode::SafeDownCast(
-        this->NodeCollection->GetItemAsObject(this->NodeCollection->GetNumberOfItems()-1) );
+      vtkDMMLSceneViewNode* sceneViewNode = vtkDMMLSceneViewNode::SafeDownCast(lastNode);
       if (!sceneViewNode)
         {
         vtkWarningMacro("Invalid parent node element for SubjectHierarchyItem");
@@ -211,6 +219,8 @@ void vtkDMMLParser::StartElement(const char* tagName, const char** atts)
     if (node->GetAddToScene())
       {
       this->NodeCollection->vtkCollection::AddItem((vtkObject *)node);
+      this->LastCollectedNode = node;
+      this->LastCollectedNodeCount = this->NodeCollection->GetNumberOfItems();
       }
     }
   else
@@ -32,7 +32,7 @@ public:
   void SetDMMLScene(vtkDMMLScene* scene) {this->DMMLScene = scene;};
 
   vtkCollection* GetNodeCollection() {return this->NodeCollection;};
-  void SetNodeCollection(vtkCollection* scene) {this->NodeCollection = scene;};
+  void SetNodeCollection(vtkCollection* scene) {this->NodeCollection = scene; this->LastCollectedNode = nullptr;};
 
 protected:
   vtkDMMLParser() = default;;
@@ -46,6 +46,10 @@ protected:
 private:
   vtkDMMLScene* DMMLScene{nullptr};
   vtkCollection* NodeCollection{nullptr};
+  /// Last node that was added to NodeCollection. Stored to avoid linear search
+  /// in the collection when the last item is needed.
+  vtkDMMLNode* LastCollectedNode{nullptr};
+  int LastCollectedNodeCount{0};
   std::stack< vtkDMMLNode *> NodeStack;
 };
 
@@ -14,6 +14,7 @@ Version:   $Revision: 1.2 $
 
 // DMML includes
 #include "vtkEventBroker.h"
+#include "vtkImageAutoRangeCalculator.h"
 #include "vtkDMMLScalarVolumeDisplayNode.h"
 #include "vtkDMMLScene.h"
 #include "vtkDMMLProceduralColorNode.h"
@@ -27,7 +28,6 @@ Version:   $Revision: 1.2 $
 #include <vtkImageCast.h>
 #include <vtkImageData.h>
 #include <vtkImageExtractComponents.h>
-#include <vtkImageHistogramStatistics.h>
 #include <vtkImageLogic.h>
 #include <vtkImageMapToWindowLevelColors.h>
 #include <vtkImageStencil.h>
@@ -103,7 +103,7 @@ vtkDMMLScalarVolumeDisplayNode::vtkDMMLScalarVolumeDisplayNode()
   this->AppendComponents->AddInputConnection(0, this->ExtractRGB->GetOutputPort() );
   this->AppendComponents->AddInputConnection(0, this->AlphaLogic->GetOutputPort() );
 
-  this->HistogramStatistics = nullptr;
+  this->AutoRangeCalculator = nullptr;
   this->IsInCalculateAutoLevels = false;
 
   vtkEventBroker::GetInstance()->AddObservation(
@@ -124,10 +124,10 @@ vtkDMMLScalarVolumeDisplayNode::~vtkDMMLScalarVolumeDisplayNode()
   this->ExtractAlpha->Delete();
   this->MultiplyAlpha->Delete();
 
-  if (this->HistogramStatistics)
+  if (this->AutoRangeCalculator)
     {
-    this->HistogramStatistics->Delete();
-    this->HistogramStatistics = nullptr;
+    this->AutoRangeCalculator->Delete();
+    this->AutoRangeCalculator = nullptr;
     }
 }
 
@@ -723,6 +723,35 @@ void vtkDMMLScalarVolumeDisplayNode::GetDisplayScalarRange(double range[2])
     }
 }
 
+//---------------------------------------------------------------------------
+vtkImageAutoRangeCalculator* vtkDMMLScalarVolumeDisplayNode::GetAutoRangeCalculator()
+{
+  if (this->AutoRangeCalculator == nullptr)
+    {
+    this->AutoRangeCalculator = vtkImageAutoRangeCalculator::New();
+
+    // Set automatic window/level to include the entire intensity range
+    // (except top/bottom 0.1%, to not let a very thin tail of the intensity
+    // distribution to decrease the image contrast too much).
+    // While in CT and sometimes in MRI, there may be a large empty area
+    // outside the reconstructed image, which could be suppressed
+    // by a larger lower percentile value, it would make the method
+    // too specific to particular imaging modalities and could lead to
+    // suboptimal results for other types of images.
+    // Therefore, we choose small, symmetric percentile values here
+    // and maybe add modality-specific methods later (e.g., for CT
+    // images we could set lower value to -1000HU).
+    this->AutoRangeCalculator->SetAutoRangePercentiles(0.1, 99.9);
+    }
+  return this->AutoRangeCalculator;
+}
+
+//---------------------------------------------------------------------------
+void vtkDMMLScalarVolumeDisplayNode::AddImageDataModifiedExtent(const int extent[6])
+{
+  this->GetAutoRangeCalculator()->AddModifiedExtent(extent);
+}
+
 //---------------------------------------------------------------------------
 void vtkDMMLScalarVolumeDisplayNode::CalculateAutoLevels()
 {
@@ -755,32 +784,15 @@ void vtkDMMLScalarVolumeDisplayNode::CalculateAutoLevels()
     return;
     }
 
-  if (this->HistogramStatistics == nullptr)
-    {
-    this->HistogramStatistics = vtkImageHistogramStatistics::New();
-
-    // Set automatic window/level to include the entire intensity range
-    // (except top/bottom 0.1%, to not let a very thin tail of the intensity
-    // distribution to decrease the image contrast too much).
-    // While in CT and sometimes in MRI, there may be a large empty area
-    // outside the reconstructed image, which could be suppressed
-    // by a larger lower percentile value, it would make the method
-    // too specific to particular imaging modalities and could lead to
-    // suboptimal results for other types of images.
-    // Therefore, we choose small, symmetric percentile values here
-    // and maybe add modality-specific methods later (e.g., for CT
-    // images we could set lower value to -1000HU).
-    this->HistogramStatistics->SetAutoRangePercentiles(0.1, 99.9);
-
-    // Percentiles are very low (0.1%), so there is no need for
-    // range expansion.
-    this->HistogramStatistics->SetAutoRangeExpansionFactors(0.0, 0.0);
-    }
+  vtkImageAutoRangeCalculator* autoRangeCalculator = this->GetAutoRangeCalculator();
 
   this->IsInCalculateAutoLevels = true;
-  this->HistogramStatistics->SetInputData(imageDataScalar);
-  this->HistogramStatistics->Update();
-  double* intensityRange = this->HistogramStatistics->GetAutoRange();
+  double intensityRange[2] = { 0.0, 0.0 };
+  if (!autoRangeCalculator->ComputeAutoRange(imageDataScalar, intensityRange))
+    {
+    this->IsInCalculateAutoLevels = false;
+    return;
+    }
   vtkDebugMacro("CalculateScalarAutoLevels:"
                 << " lower: " << intensityRange[0] << " upper: " << intensityRange[1]);
 
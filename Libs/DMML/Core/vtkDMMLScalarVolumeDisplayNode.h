@@ -21,7 +21,6 @@
 // VTK includes
 class vtkImageAlgorithm;
 class vtkImageAppendComponents;
-class vtkImageHistogramStatistics;
 class vtkImageCast;
 class vtkImageLogic;
 class vtkImageMapToColors;
@@ -30,6 +29,7 @@ class vtkImageStencil;
 class vtkImageThreshold;
 class vtkImageExtractComponents;
 class vtkImageMathematics;
+class vtkImageAutoRangeCalculator;
 
 // STD includes
 #include <vector>
@@ -78,6 +78,17 @@ class VTK_DMML_EXPORT vtkDMMLScalarVolumeDisplayNode : public vtkDMMLVolumeDispl
   vtkGetMacro(AutoWindowLevel, int);
   vtkSetMacro(AutoWindowLevel, int);
 
+  ///
+  /// Calculator used for computing automatic window/level and threshold.
+  /// It can be used for adjusting accuracy of the computation (e.g., disable sampling).
+  vtkImageAutoRangeCalculator* GetAutoRangeCalculator();
+
+  ///
+  /// Indicate that only voxels within the specified IJK extent of the image data will be
+  /// modified. If called before the image data is modified then automatic window/level
+  /// and threshold computation only processes the modified region of the image.
+  void AddImageDataModifiedExtent(const int extent[6]);
+
   ///
   /// The window value to use when autoWindowLevel is 'no'
   double GetWindow();
@@ -241,7 +252,7 @@ protected:
 
   ///
   /// Used internally in CalculateScalarAutoLevels and CalculateStatisticsAutoLevels
-  vtkImageHistogramStatistics *HistogramStatistics;
+  vtkImageAutoRangeCalculator *AutoRangeCalculator;
   bool IsInCalculateAutoLevels;
 };
 
@@ -117,6 +117,7 @@ vtkDMMLScene::vtkDMMLScene()
   this->RandomGenerator.seed(std::random_device{}());
 
   this->NodeIDsMTime = 0;
+  this->NodeClassIndexMTime = 0;
 
   this->Nodes = vtkCollection::New();
   this->MaximumNumberOfSavedUndoStates = 20;
@@ -133,6 +134,8 @@ vtkDMMLScene::vtkDMMLScene()
 
   this->ReadDataOnLoad = 1;
 
+  this->BulkImport = false;
+
   this->LastLoadedVersion = nullptr;
   this->LastLoadedExtensions = nullptr;
   this->Version = nullptr;
@@ -839,10 +842,44 @@ int vtkDMMLScene::Import(vtkDMMLMessageCollection* userMessagesInput/*=nullptr*/
     // in case of singleton nodes the existing singleton node is kept
     // and only the contents is overwritten.
     vtkSmartPointer<vtkCollection> addedNodes = vtkSmartPointer<vtkCollection>::New();
-    for (loadedNodes->InitTraversal(it);
-         (node = (vtkDMMLNode*)loadedNodes->GetNextItemAsObject(it)) ;)
+    if (this->BulkImport)
       {
-      addedNodes->AddItem(this->AddNode(node));
+      // Add all nodes without notification and then notify observers once per node class,
+      // to avoid processing each node addition separately in the observers.
+      std::vector<std::string> addedClassNames;
+      std::map<std::string, vtkSmartPointer<vtkCollection> > addedNodesByClass;
+      for (loadedNodes->InitTraversal(it);
+           (node = (vtkDMMLNode*)loadedNodes->GetNextItemAsObject(it)) ;)
+        {
+        // Existing singleton nodes are just updated, they are not added
+        bool add = (node->GetSingletonTag() == nullptr || this->GetSingletonNode(node) == nullptr);
+        vtkDMMLNode* addedNode = this->AddNodeNoNotify(node);
+        addedNodes->AddItem(addedNode);
+        if (!add || !addedNode)
+          {
+          continue;
+          }
+        vtkSmartPointer<vtkCollection>& classNodes = addedNodesByClass[addedNode->GetClassName()];
+        if (!classNodes)
+          {
+          classNodes = vtkSmartPointer<vtkCollection>::New();
+          addedClassNames.push_back(addedNode->GetClassName());
+          }
+        classNodes->AddItem(addedNode);
+        }
+      this->Modified();
+      for (const std::string& className : addedClassNames)
+        {
+        this->InvokeEvent(vtkDMMLScene::NodesAddedEvent, addedNodesByClass[className].GetPointer());
+        }
+      }
+    else
+      {
+      for (loadedNodes->InitTraversal(it);
+           (node = (vtkDMMLNode*)loadedNodes->GetNextItemAsObject(it)) ;)
+        {
+        addedNodes->AddItem(this->AddNode(node));
+        }
       }
 #ifdef DMMLSCENE_VERBOSE
     addNodesTimer->StopTimer();
@@ -1139,10 +1176,10 @@ int vtkDMMLScene::Commit(const char* url, vtkDMMLMessageCollection * userMessage
   //--- END test of user tags
 
   // Write each node
-  int n;
-  for (n=0; n < this->Nodes->GetNumberOfItems(); n++)
+  vtkCollectionSimpleIterator it;
+  for (this->Nodes->InitTraversal(it);
+       (node = (vtkDMMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
     {
-    node = (vtkDMMLNode*)this->Nodes->GetItemAsObject(n);
     if (!node->GetSaveWithScene())
       {
       continue;
@@ -1287,6 +1324,7 @@ vtkDMMLNode* vtkDMMLScene::AddNodeNoNotify(vtkDMMLNode *n)
 
   // cache the node so the whole scene cache stays up-to date
   this->AddNodeID(n);
+  this->AddNodeToClassIndex(n);
 
   // Keep the SH up-to-date
   if (vtkDMMLSubjectHierarchyNode::SafeDownCast(n) != nullptr &&
@@ -1504,6 +1542,7 @@ void vtkDMMLScene::RemoveNode(vtkDMMLNode *n)
 
   std::string nid = (n->GetID() ? n->GetID() : "");
   this->RemoveNodeID(n->GetID());
+  this->RemoveNodeFromClassIndex(n);
 
   this->InvokeEvent(vtkDMMLScene::NodeRemovedEvent, n);
 
@@ -1684,18 +1723,7 @@ int vtkDMMLScene::GetNumberOfNodesByClass(const char *className)
     vtkErrorMacro("GetNumberOfNodesByClass: class name is null.");
     return 0;
     }
-  int num=0;
-  vtkDMMLNode *node;
-  vtkCollectionSimpleIterator it;
-  for (this->Nodes->InitTraversal(it);
-       (node = (vtkDMMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
-    {
-    if (node->IsA(className))
-      {
-      num++;
-      }
-    }
-  return num;
+  return static_cast<int>(this->GetNodeClassIndex(className).size());
 }
 
 //------------------------------------------------------------------------------
@@ -1707,16 +1735,8 @@ int vtkDMMLScene::GetNodesByClass(const char *className, std::vector<vtkDMMLNode
     vtkErrorMacro("GetNodesByClass: class name is null.");
     return 0;
     }
-  vtkDMMLNode *node;
-  vtkCollectionSimpleIterator it;
-  for (this->Nodes->InitTraversal(it);
-       (node = (vtkDMMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
-    {
-    if (node->IsA(className))
-      {
-      nodes.push_back(node);
-      }
-    }
+  const std::vector<vtkDMMLNode*>& classNodes = this->GetNodeClassIndex(className);
+  nodes.insert(nodes.end(), classNodes.begin(), classNodes.end());
   return static_cast<int>(nodes.size());
 }
 
@@ -1729,15 +1749,10 @@ vtkCollection* vtkDMMLScene::GetNodesByClass(const char *className)
     return nullptr;
     }
   vtkCollection* nodes = vtkCollection::New();
-  vtkDMMLNode *node;
-  vtkCollectionSimpleIterator it;
-  for (this->Nodes->InitTraversal(it);
-       (node = (vtkDMMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
+  const std::vector<vtkDMMLNode*>& classNodes = this->GetNodeClassIndex(className);
+  for (vtkDMMLNode* node : classNodes)
     {
-    if (node->IsA(className))
-      {
-      nodes->AddItem(node);
-      }
+    nodes->AddItem(node);
     }
   return nodes;
 }
@@ -1798,13 +1813,10 @@ vtkDMMLNode* vtkDMMLScene::GetSingletonNode(const char* singletonTag, const char
     return nullptr;
     }
 
-  vtkCollectionSimpleIterator it;
-  vtkDMMLNode* node = nullptr;
-  for (this->Nodes->InitTraversal(it);
-       (node = (vtkDMMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
+  const std::vector<vtkDMMLNode*>& classNodes = this->GetNodeClassIndex(className);
+  for (vtkDMMLNode* node : classNodes)
     {
-    if (node->IsA(className) &&
-        node->GetSingletonTag() != nullptr &&
+    if (node->GetSingletonTag() != nullptr &&
         strcmp(node->GetSingletonTag(), singletonTag) == 0)
       {
       return node;
@@ -1874,22 +1886,12 @@ vtkDMMLNode* vtkDMMLScene::GetNthNodeByClass(int n, const char *className)
     return nullptr;
     }
 
-  int num=0;
-  vtkDMMLNode *node;
-  vtkCollectionSimpleIterator it;
-  for (this->Nodes->InitTraversal(it);
-       (node = (vtkDMMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
+  const std::vector<vtkDMMLNode*>& classNodes = this->GetNodeClassIndex(className);
+  if (n >= static_cast<int>(classNodes.size()))
     {
-    if (node->IsA(className))
-      {
-      if (num == n)
-        {
-        return node;
-        }
-      num++;
-      }
+    return nullptr;
     }
-  return nullptr;
+  return classNodes[n];
 }
 
 //------------------------------------------------------------------------------
@@ -2125,6 +2127,7 @@ vtkDMMLNode* vtkDMMLScene::InsertAfterNode(vtkDMMLNode *item, vtkDMMLNode *n)
     {
     // it wasn't found, just add
     this->Nodes->vtkCollection::AddItem((vtkObject *)n);
+    this->AddNodeToClassIndex(n);
     }
   else
     {
@@ -2132,6 +2135,8 @@ vtkDMMLNode* vtkDMMLScene::InsertAfterNode(vtkDMMLNode *item, vtkDMMLNode *n)
     index = itemIndex - 1;
     vtkDebugMacro("InsertAfterNode: item index = " << itemIndex-1 << ", inserting after index = " << index);
     this->Nodes->vtkCollection::InsertItem(index, (vtkObject *)n);
+    // the class index stores nodes in collection order, it is rebuilt on next query
+    this->ClearNodeClassIndex();
     }
   // cache the node so the whole scene cache stays up-to-date
   this->AddNodeID(n);
@@ -2222,6 +2227,7 @@ vtkDMMLNode* vtkDMMLScene::InsertBeforeNode(vtkDMMLNode *item, vtkDMMLNode *n)
     {
     // it wasn't found, just add
     this->Nodes->vtkCollection::AddItem((vtkObject *)n);
+    this->AddNodeToClassIndex(n);
     }
   else
     {
@@ -2230,6 +2236,8 @@ vtkDMMLNode* vtkDMMLScene::InsertBeforeNode(vtkDMMLNode *item, vtkDMMLNode *n)
     index = itemIndex - 2;
     vtkDebugMacro("InsertBeforeNode: item index = " << itemIndex-1 << ", inserting after index = " << index);
     this->Nodes->vtkCollection::InsertItem(index, (vtkObject *)n);
+    // the class index stores nodes in collection order, it is rebuilt on next query
+    this->ClearNodeClassIndex();
     }
   // cache the node so the whole scene cache stays up-todate
   this->AddNodeID(n);
@@ -3228,6 +3236,23 @@ const char* vtkDMMLScene::GetChangedID(const char* id)
 //------------------------------------------------------------------------------
 void vtkDMMLScene::UpdateNodeReferences(vtkCollection* checkNodes/*=nullptr*/)
 {
+  if (this->ReferencedIDChanges.empty())
+    {
+    return;
+    }
+  // Collect the nodes to check into a set to avoid linear search in the collection
+  // for each referring node.
+  std::set<vtkDMMLNode*> checkNodesSet;
+  if (checkNodes != nullptr)
+    {
+    vtkDMMLNode* checkNode = nullptr;
+    vtkCollectionSimpleIterator it;
+    for (checkNodes->InitTraversal(it);
+      (checkNode = vtkDMMLNode::SafeDownCast(checkNodes->GetNextItemAsObject(it)));)
+      {
+      checkNodesSet.insert(checkNode);
+      }
+    }
   for (std::map< std::string, std::string>::const_iterator iterChanged = this->ReferencedIDChanges.begin();
     iterChanged != this->ReferencedIDChanges.end(); iterChanged++)
     {
@@ -3250,7 +3275,7 @@ void vtkDMMLScene::UpdateNodeReferences(vtkCollection* checkNodes/*=nullptr*/)
         {
         continue;
         }
-      if (checkNodes!=nullptr && !checkNodes->IsItemPresent(node))
+      if (checkNodes!=nullptr && checkNodesSet.find(node) == checkNodesSet.end())
         {
         continue;
         }
@@ -3467,6 +3492,110 @@ void vtkDMMLScene::ClearNodeIDs()
   }
 }
 
+//-----------------------------------------------------------------------------
+const std::vector<vtkDMMLNode*>& vtkDMMLScene::GetNodeClassIndex(const char* className)
+{
+  if (this->Nodes->GetMTime() > this->NodeClassIndexMTime)
+    {
+    // The collection was modified without going through AddNode/RemoveNode
+    // (for example using GetNodes()), all cached lists are invalid.
+    this->ClearNodeClassIndex();
+    }
+  std::map< std::string, NodeClassIndexEntry >::iterator classIt =
+    this->NodeClassIndex.find(className);
+  if (classIt != this->NodeClassIndex.end())
+    {
+    NodeClassIndexEntry& classEntry = classIt->second;
+    if (classEntry.NumberOfRemovedNodes > 0)
+      {
+      // Erase removed nodes from the list
+      classEntry.Nodes.erase(std::remove(classEntry.Nodes.begin(), classEntry.Nodes.end(), nullptr),
+        classEntry.Nodes.end());
+      for (size_t position = 0; position < classEntry.Nodes.size(); ++position)
+        {
+        classEntry.NodePositions[classEntry.Nodes[position]] = position;
+        }
+      classEntry.NumberOfRemovedNodes = 0;
+      }
+    return classEntry.Nodes;
+    }
+
+  // First query for this class: collect matching nodes (in collection order).
+  // The list is then kept up-to-date when nodes are added or removed.
+  NodeClassIndexEntry& classEntry = this->NodeClassIndex[className];
+  vtkDMMLNode *node;
+  vtkCollectionSimpleIterator it;
+  for (this->Nodes->InitTraversal(it);
+       (node = (vtkDMMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
+    {
+    if (node->IsA(className))
+      {
+      classEntry.NodePositions[node] = classEntry.Nodes.size();
+      classEntry.Nodes.push_back(node);
+      }
+    }
+  return classEntry.Nodes;
+}
+
+//-----------------------------------------------------------------------------
+void vtkDMMLScene::AddNodeToClassIndex(vtkDMMLNode *node)
+{
+  if (!this->Nodes || !node)
+    {
+    return;
+    }
+  for (std::map< std::string, NodeClassIndexEntry >::iterator classIt = this->NodeClassIndex.begin();
+    classIt != this->NodeClassIndex.end(); ++classIt)
+    {
+    if (node->IsA(classIt->first.c_str()))
+      {
+      NodeClassIndexEntry& classEntry = classIt->second;
+      classEntry.NodePositions[node] = classEntry.Nodes.size();
+      classEntry.Nodes.push_back(node);
+      }
+    }
+  this->NodeClassIndexMTime = this->Nodes->GetMTime();
+}
+
+//-----------------------------------------------------------------------------
+void vtkDMMLScene::RemoveNodeFromClassIndex(vtkDMMLNode *node)
+{
+  if (!this->Nodes || !node)
+    {
+    return;
+    }
+  if (this->Nodes->GetNumberOfItems() == 0)
+    {
+    this->ClearNodeClassIndex();
+    return;
+    }
+  for (std::map< std::string, NodeClassIndexEntry >::iterator classIt = this->NodeClassIndex.begin();
+    classIt != this->NodeClassIndex.end(); ++classIt)
+    {
+    NodeClassIndexEntry& classEntry = classIt->second;
+    std::map<vtkDMMLNode*, size_t>::iterator positionIt = classEntry.NodePositions.find(node);
+    if (positionIt == classEntry.NodePositions.end())
+      {
+      continue;
+      }
+    // The list is compacted on next query
+    classEntry.Nodes[positionIt->second] = nullptr;
+    classEntry.NodePositions.erase(positionIt);
+    ++classEntry.NumberOfRemovedNodes;
+    }
+  this->NodeClassIndexMTime = this->Nodes->GetMTime();
+}
+
+//-----------------------------------------------------------------------------
+void vtkDMMLScene::ClearNodeClassIndex()
+{
+  if (this->Nodes)
+    {
+    this->NodeClassIndex.clear();
+    this->NodeClassIndexMTime = this->Nodes->GetMTime();
+    }
+}
+
 //------------------------------------------------------------------------------
 void vtkDMMLScene::AddURIHandler(vtkURIHandler *handler)
 {
@@ -3979,6 +4108,18 @@ bool vtkDMMLScene::ReadFromMRB(const char* fullName, bool clear/*=false*/, vtkDM
     {
     success = this->Import(userMessages);
     }
+  // Volume sequence frames that are read on demand must be read before the unpacked files are removed
+  std::vector<vtkDMMLNode*> volumeSequenceStorageNodes;
+  this->GetNodesByClass("vtkDMMLVolumeSequenceStorageNode", volumeSequenceStorageNodes);
+  for (vtkDMMLNode* node : volumeSequenceStorageNodes)
+    {
+    vtkDMMLVolumeSequenceStorageNode* storageNode = vtkDMMLVolumeSequenceStorageNode::SafeDownCast(node);
+    if (storageNode->GetNumberOfPendingFrames() > 0
+      && vtksys::SystemTools::IsSubDirectory(storageNode->GetFullNameFromFileName(), unpackDir))
+      {
+      storageNode->LoadAllFrames();
+      }
+    }
   if (!vtksys::SystemTools::RemoveADirectory(unpackDir))
     {
     vtkErrorToMessageCollectionMacro(userMessages, "vtkDMMLScene::ReadFromMRB",
@@ -520,6 +520,22 @@ public:
   vtkSetMacro(ReadDataOnLoad,int);
   vtkGetMacro(ReadDataOnLoad,int);
 
+  /// \brief This property controls whether Import() adds the loaded nodes in bulk.
+  ///
+  /// If true, Import() adds all loaded nodes without invoking NodeAboutToBeAddedEvent
+  /// and NodeAddedEvent for each node. Instead, a single NodesAddedEvent is invoked
+  /// for each node class after all the nodes are added (the event is invoked for
+  /// classes in the order they first appear in the imported scene).
+  /// This makes loading of scenes that contain many thousands of nodes much faster
+  /// if there are observers that process each added node.
+  /// Observers that keep track of added nodes must observe NodesAddedEvent as well,
+  /// otherwise they miss the imported nodes.
+  /// Default is false.
+  /// \sa Import(), NodesAddedEvent
+  vtkSetMacro(BulkImport, bool);
+  vtkGetMacro(BulkImport, bool);
+  vtkBooleanMacro(BulkImport, bool);
+
   /// \brief Set the XML string to read from by Import() if
   /// GetLoadFromXMLString() is true.
   ///
@@ -677,6 +693,10 @@ public:
     NodeAboutToBeRemovedEvent,
     NodeRemovedEvent,
     NodeClassRegisteredEvent,
+    /// Invoked by Import() in BulkImport mode instead of NodeAddedEvent,
+    /// once for each node class. Call data is a vtkCollection that contains
+    /// all the added nodes of the same class.
+    NodesAddedEvent,
 
     NewSceneEvent = 66030,
     MetadataAddedEvent = 66032, // ### Cjyx 4.5: Simplify - Do not explicitly set for backward compat. See issue #3472
@@ -890,6 +910,23 @@ protected:
   /// Clear NodeIDs map used to speedup GetByID() method.
   void ClearNodeIDs();
 
+  /// \brief Get the list of nodes of a class (including subclasses) in the
+  /// order of the \a Nodes collection.
+  ///
+  /// The list of a class is created when it is first queried and is then
+  /// updated incrementally in AddNode/RemoveNode, to speedup
+  /// GetNodesByClass(), GetNumberOfNodesByClass() and GetNthNodeByClass().
+  const std::vector<vtkDMMLNode*>& GetNodeClassIndex(const char* className);
+
+  /// Add node to all the class lists of \a NodeClassIndex it belongs to.
+  void AddNodeToClassIndex(vtkDMMLNode *node);
+
+  /// Remove node from all the class lists of \a NodeClassIndex.
+  void RemoveNodeFromClassIndex(vtkDMMLNode *node);
+
+  /// Clear NodeClassIndex map, class lists are recomputed on next query.
+  void ClearNodeClassIndex();
+
   /// Get a NodeReferences iterator for a node reference.
   NodeReferencesType::iterator FindNodeReference(const char* referencedId, vtkDMMLNode* referencingNode);
 
@@ -947,6 +984,17 @@ protected:
   NodeReferencesType NodeReferences; // ReferencedIDs (string), ReferencingNodes (node pointer)
   std::map< std::string, std::string > ReferencedIDChanges;
   std::map< std::string, vtkSmartPointer<vtkDMMLNode> > NodeIDs;
+  /// Nodes of a class in collection order. Removed nodes are replaced by nullptr
+  /// (found using NodePositions) and only erased from the list when it is queried next time,
+  /// so that removing many nodes does not take quadratic time.
+  struct NodeClassIndexEntry
+    {
+    std::vector<vtkDMMLNode*> Nodes;
+    std::map<vtkDMMLNode*, size_t> NodePositions;
+    size_t NumberOfRemovedNodes{0};
+    };
+  /// Nodes of the scene grouped by queried class name (class name -> nodes that are IsA(class name))
+  std::map< std::string, NodeClassIndexEntry > NodeClassIndex;
 
   // Stores default nodes. If a class is created or reset (using CreateNodeByClass or Clear) and
   // a default node is defined for it then the content of the default node will be used to initialize
@@ -961,7 +1009,10 @@ protected:
 
   int ReadDataOnLoad;
 
+  bool BulkImport;
+
   vtkMTimeType  NodeIDsMTime;
+  vtkMTimeType  NodeClassIndexMTime;
 
   void RemoveAllNodes(bool removeSingletons);
 
@@ -27,6 +27,7 @@
 
 // DMML includes
 #include "vtkDMMLMessageCollection.h"
+#include "vtkDMMLNRRDStorageNode.h"
 #include <vtkDMMLScalarVolumeNode.h>
 #include <vtkDMMLScene.h>
 #include "vtkDMMLSegmentationNode.h"
@@ -94,7 +95,11 @@ static const int SINGLE_SEGMENT_INDEX = -1; // used as segment index when there
 vtkDMMLNodeNewMacro(vtkDMMLSegmentationStorageNode);
 
 //----------------------------------------------------------------------------
-vtkDMMLSegmentationStorageNode::vtkDMMLSegmentationStorageNode() = default;
+vtkDMMLSegmentationStorageNode::vtkDMMLSegmentationStorageNode()
+{
+  // Same compression level as zlib default, which was used before compression presets were available
+  this->CompressionParameter = vtkDMMLNRRDStorageNode::GetCompressionParameterNormal();
+}
 
 //----------------------------------------------------------------------------
 vtkDMMLSegmentationStorageNode::~vtkDMMLSegmentationStorageNode() = default;
@@ -231,6 +236,20 @@ const char* vtkDMMLSegmentationStorageNode::GetDefaultWriteFileExtension()
   return nullptr;
 }
 
+//----------------------------------------------------------------------------
+void vtkDMMLSegmentationStorageNode::UpdateCompressionPresets()
+{
+  this->CompressionPresets.clear();
+  vtkDMMLSegmentationNode* segmentationNode = this->GetAssociatedDataNode();
+  if (segmentationNode && !segmentationNode->GetSegmentation()->IsMasterRepresentationImageData())
+    {
+    return;
+    }
+  this->CompressionPresets.emplace_back(vtkDMMLNRRDStorageNode::GetCompressionParameterFastest(), "Fastest");
+  this->CompressionPresets.emplace_back(vtkDMMLNRRDStorageNode::GetCompressionParameterNormal(), "Normal");
+  this->CompressionPresets.emplace_back(vtkDMMLNRRDStorageNode::GetCompressionParameterMinimumSize(), "Minimum size");
+}
+
 //----------------------------------------------------------------------------
 void vtkDMMLSegmentationStorageNode::ResetSupportedWriteFileTypes()
 {
@@ -1206,6 +1225,7 @@ int vtkDMMLSegmentationStorageNode::WriteBinaryLabelmapRepresentation(vtkDMMLSeg
   vtkNew<vtkTeemNRRDWriter> writer;
   writer->SetFileName(fullName.c_str());
   writer->SetUseCompression(this->GetUseCompression());
+  writer->SetCompressionLevel(vtkDMMLNRRDStorageNode::GetGzipCompressionLevelFromCompressionParameter(this->CompressionParameter));
   writer->SetSpace(nrrdSpaceLeftPosteriorSuperior);
   writer->SetMeasurementFrameMatrix(nullptr);
 
@@ -118,6 +118,11 @@ protected:
   /// Initialize all the supported write file types
   void InitializeSupportedWriteFileTypes() override;
 
+  /// Compression presets are only offered for binary labelmap
+  /// master representation (seg.nrrd), as they set the gzip compression level.
+  /// Presets are the same as for volumes (see vtkDMMLNRRDStorageNode).
+  void UpdateCompressionPresets() override;
+
   /// Get data node that is associated with this storage node
   vtkDMMLSegmentationNode* GetAssociatedDataNode();
 
@@ -20,6 +20,7 @@
 #include "vtkDMMLSequenceNode.h"
 #include "vtkDMMLSequenceStorageNode.h"
 #include "vtkDMMLStorableNode.h"
+#include "vtkDMMLVolumeSequenceStorageNode.h"
 
 // DMML includes
 #include <vtkDMMLScene.h>
@@ -33,6 +34,8 @@
 #include <vtkTimerLog.h>
 
 // STD includes
+#include <algorithm>
+#include <cstdlib>
 #include <sstream>
 
 #define SAFE_CHAR_POINTER(unsafeString) ( unsafeString==nullptr?"":unsafeString )
@@ -80,6 +83,7 @@ vtkDMMLSequenceNode::~vtkDMMLSequenceNode()
 void vtkDMMLSequenceNode::RemoveAllDataNodes()
 {
   this->IndexEntries.clear();
+  this->InvalidateIndexValueLookup();
   if (!this->SequenceScene)
     {
     return;
@@ -191,6 +195,7 @@ void vtkDMMLSequenceNode::ReadIndexValues(const std::string& indexText)
     this->IndexEntries.clear();
     modified = true;
     }
+  this->InvalidateIndexValueLookup();
 
   std::stringstream ss(indexText);
   std::string nodeId_indexValue;
@@ -203,7 +208,7 @@ void vtkDMMLSequenceNode::ReadIndexValues(const std::string& indexText)
       std::string indexValue = nodeId_indexValue.substr(indexValueSeparatorPos+1, nodeId_indexValue.size()-indexValueSeparatorPos-1);
 
       IndexEntryType indexEntry;
-      indexEntry.IndexValue=indexValue;
+      indexEntry.SetIndexValue(indexValue);
       // The nodes are not read yet, so we can only store the node ID and get the pointer to the node later (in UpdateScene())
       indexEntry.DataNodeID=nodeId;
       indexEntry.DataNode=nullptr;
@@ -258,16 +263,23 @@ void vtkDMMLSequenceNode::Copy(vtkDMMLNode *anode)
         vtkErrorMacro("Invalid node in vtkDMMLSequenceNode");
         continue;
         }
+      if (snode->DataNodeLoader)
+        {
+        // make sure data is copied, too
+        snode->DataNodeLoader->LoadFrame(node);
+        }
       vtkDMMLNode* targetDataNode = this->DeepCopyNodeToScene(node, this->SequenceScene);
       sourceToTargetDataNodeID[node->GetID()] = targetDataNode->GetID();
       }
     }
 
   this->IndexEntries.clear();
+  this->InvalidateIndexValueLookup();
   for(std::deque< IndexEntryType >::iterator sourceIndexIt=snode->IndexEntries.begin(); sourceIndexIt!=snode->IndexEntries.end(); ++sourceIndexIt)
     {
     IndexEntryType seqItem;
     seqItem.IndexValue=sourceIndexIt->IndexValue;
+    seqItem.NumericIndexValue=sourceIndexIt->NumericIndexValue;
     seqItem.DataNode = nullptr;
     if (sourceIndexIt->DataNode!=nullptr)
       {
@@ -305,10 +317,12 @@ void vtkDMMLSequenceNode::CopySequenceIndex(vtkDMMLNode *anode)
   if (this->IndexEntries.size() > 0 || snode->IndexEntries.size() > 0)
     {
     this->IndexEntries.clear();
+    this->InvalidateIndexValueLookup();
     for (std::deque< IndexEntryType >::iterator sourceIndexIt = snode->IndexEntries.begin(); sourceIndexIt != snode->IndexEntries.end(); ++sourceIndexIt)
       {
       IndexEntryType seqItem;
       seqItem.IndexValue = sourceIndexIt->IndexValue;
+      seqItem.NumericIndexValue = sourceIndexIt->NumericIndexValue;
       if (sourceIndexIt->DataNode != nullptr)
         {
         seqItem.DataNodeID = sourceIndexIt->DataNode->GetID();
@@ -382,7 +396,7 @@ int vtkDMMLSequenceNode::GetInsertPosition(const std::string& indexValue)
     {
     int itemNumber = this->GetItemNumberFromIndexValue(indexValue, false);
     double numericIndexValue = atof(indexValue.c_str());
-    double foundNumericIndexValue = atof(this->IndexEntries[itemNumber].IndexValue.c_str());
+    double foundNumericIndexValue = this->IndexEntries[itemNumber].NumericIndexValue;
     if (numericIndexValue < foundNumericIndexValue) // Deals with case of index value being smaller than any in the sequence and numeric tolerances
       {
       insertPosition = itemNumber;
@@ -414,8 +428,21 @@ vtkDMMLNode* vtkDMMLSequenceNode::SetDataNodeAtValue(vtkDMMLNode* node, const st
     seqItemIndex = GetInsertPosition(indexValue);
     // Create new item
     IndexEntryType seqItem;
-    seqItem.IndexValue = indexValue;
-    this->IndexEntries.insert(this->IndexEntries.begin() + seqItemIndex, seqItem);
+    seqItem.SetIndexValue(indexValue);
+    if (seqItemIndex == static_cast<int>(this->IndexEntries.size()))
+      {
+      // Appending does not change item number of existing entries, so the lookup table can be kept
+      this->IndexEntries.push_back(seqItem);
+      if (this->IndexValueLookupValid)
+        {
+        this->IndexValueLookup.emplace(indexValue, seqItemIndex);
+        }
+      }
+    else
+      {
+      this->IndexEntries.insert(this->IndexEntries.begin() + seqItemIndex, seqItem);
+      this->InvalidateIndexValueLookup();
+      }
     }
   this->IndexEntries[seqItemIndex].DataNode = newNode;
   this->IndexEntries[seqItemIndex].DataNodeID.clear();
@@ -441,6 +468,7 @@ void vtkDMMLSequenceNode::RemoveDataNodeAtValue(const std::string& indexValue)
   // TODO: remove associated nodes as well (such as storage node)?
   this->SequenceScene->RemoveNode(this->IndexEntries[seqItemIndex].DataNode);
   this->IndexEntries.erase(this->IndexEntries.begin()+seqItemIndex);
+  this->InvalidateIndexValueLookup();
   this->Modified();
   this->StorableModifiedTime.Modified();
 }
@@ -462,8 +490,8 @@ int vtkDMMLSequenceNode::GetItemNumberFromIndexValue(const std::string& indexVal
 
     // Deal with index values not within the range of index values in the Sequence
     double numericIndexValue = atof(indexValue.c_str());
-    double lowerNumericIndexValue = atof(this->IndexEntries[lowerBound].IndexValue.c_str());
-    double upperNumericIndexValue = atof(this->IndexEntries[upperBound].IndexValue.c_str());
+    double lowerNumericIndexValue = this->IndexEntries[lowerBound].NumericIndexValue;
+    double upperNumericIndexValue = this->IndexEntries[upperBound].NumericIndexValue;
     if (numericIndexValue <= lowerNumericIndexValue + this->NumericIndexValueTolerance)
       {
       if (numericIndexValue < lowerNumericIndexValue - this->NumericIndexValueTolerance && exactMatchRequired)
@@ -487,40 +515,64 @@ int vtkDMMLSequenceNode::GetItemNumberFromIndexValue(const std::string& indexVal
         }
       }
 
-    while (upperBound - lowerBound > 1)
+    // Find the last item that is not greater than the requested value (there is always one, as
+    // values below the first item are already handled above) and the item after that.
+    std::deque< IndexEntryType >::iterator upperIt = std::upper_bound(this->IndexEntries.begin(), this->IndexEntries.end(),
+      numericIndexValue, [](double value, const IndexEntryType& entry) { return value < entry.NumericIndexValue; });
+    int lowerItemNumber = static_cast<int>(upperIt - this->IndexEntries.begin()) - 1;
+    double lowerDistance = numericIndexValue - this->IndexEntries[lowerItemNumber].NumericIndexValue;
+    double upperDistance = (lowerItemNumber + 1 < numberOfSeqItems)
+      ? this->IndexEntries[lowerItemNumber + 1].NumericIndexValue - numericIndexValue : VTK_DOUBLE_MAX;
+    if (lowerDistance <= this->NumericIndexValueTolerance || upperDistance <= this->NumericIndexValueTolerance)
       {
-      // Note that if middle is equal to either lowerBound or upperBound then upperBound - lowerBound <= 1
-      int middle = int((lowerBound + upperBound)/2);
-      double middleNumericIndexValue = atof(this->IndexEntries[middle].IndexValue.c_str());
-      if (fabs(numericIndexValue - middleNumericIndexValue) <= this->NumericIndexValueTolerance)
-        {
-        return middle;
-        }
-      if (numericIndexValue > middleNumericIndexValue)
-        {
-        lowerBound = middle;
-        }
-      if (numericIndexValue < middleNumericIndexValue)
-        {
-        upperBound = middle;
-        }
+      // Return the closest item within tolerance
+      return (lowerDistance <= upperDistance) ? lowerItemNumber : lowerItemNumber + 1;
       }
     if (!exactMatchRequired)
       {
-      return lowerBound;
+      return lowerItemNumber;
       }
     }
 
-  // Need linear search for non-numeric index
-  for (int i=0; i<numberOfSeqItems; i++)
+  // Exact string match (for text index or if index values are not sorted, for example after index type change)
+  return this->GetItemNumberFromIndexValueString(indexValue);
+}
+
+//---------------------------------------------------------------------------
+int vtkDMMLSequenceNode::GetItemNumberFromIndexValueString(const std::string& indexValue)
+{
+  if (!this->IndexValueLookupValid)
     {
-    if (this->IndexEntries[i].IndexValue.compare(indexValue)==0)
+    this->IndexValueLookup.clear();
+    this->IndexValueLookup.reserve(this->IndexEntries.size());
+    int numberOfSeqItems = static_cast<int>(this->IndexEntries.size());
+    for (int i = 0; i < numberOfSeqItems; i++)
       {
-      return i;
+      // emplace does not overwrite existing elements, so the first matching item is found (same as linear search)
+      this->IndexValueLookup.emplace(this->IndexEntries[i].IndexValue, i);
       }
+    this->IndexValueLookupValid = true;
+    }
+  std::unordered_map< std::string, int >::iterator foundIt = this->IndexValueLookup.find(indexValue);
+  if (foundIt == this->IndexValueLookup.end())
+    {
+    return -1;
     }
+  return foundIt->second;
+}
 
-  return -1;
+//---------------------------------------------------------------------------
+void vtkDMMLSequenceNode::InvalidateIndexValueLookup()
+{
+  this->IndexValueLookupValid = false;
+  this->IndexValueLookup.clear();
+}
+
+//---------------------------------------------------------------------------
+void vtkDMMLSequenceNode::IndexEntryType::SetIndexValue(const std::string& indexValue)
+{
+  this->IndexValue = indexValue;
+  this->NumericIndexValue = atof(indexValue.c_str());
 }
 
 //---------------------------------------------------------------------------
@@ -537,7 +589,7 @@ vtkDMMLNode* vtkDMMLSequenceNode::GetDataNodeAtValue(const std::string& indexVal
     // not found
     return nullptr;
     }
-  return this->IndexEntries[seqItemIndex].DataNode;
+  return this->GetNthDataNode(seqItemIndex);
 }
 
 //---------------------------------------------------------------------------
@@ -577,16 +629,27 @@ bool vtkDMMLSequenceNode::UpdateIndexValue(const std::string& oldIndexValue, con
     return false;
     }
   // Update the index value
-  this->IndexEntries[oldSeqItemIndex].IndexValue = newIndexValue;
+  this->IndexEntries[oldSeqItemIndex].SetIndexValue(newIndexValue);
   if (this->IndexType == vtkDMMLSequenceNode::NumericIndex)
     {
     IndexEntryType movingEntry = this->IndexEntries[oldSeqItemIndex];
     // Remove from current position
     this->IndexEntries.erase(this->IndexEntries.begin() + oldSeqItemIndex);
+    this->InvalidateIndexValueLookup();
     // Insert into new position
     int insertPosition = this->GetInsertPosition(newIndexValue);
     this->IndexEntries.insert(this->IndexEntries.begin() + insertPosition, movingEntry);
     }
+  else if (this->IndexValueLookupValid)
+    {
+    // Item number is unchanged, only the key needs to be updated
+    std::unordered_map< std::string, int >::iterator oldIt = this->IndexValueLookup.find(oldIndexValue);
+    if (oldIt != this->IndexValueLookup.end() && oldIt->second == oldSeqItemIndex)
+      {
+      this->IndexValueLookup.erase(oldIt);
+      }
+    this->IndexValueLookup.emplace(newIndexValue, oldSeqItemIndex);
+    }
   this->Modified();
   this->StorableModifiedTime.Modified();
   return true;
@@ -635,13 +698,36 @@ std::string vtkDMMLSequenceNode::GetDataNodeTagName()
 
 //-----------------------------------------------------------------------------
 vtkDMMLNode* vtkDMMLSequenceNode::GetNthDataNode(int itemNumber)
+{
+  return this->GetNthDataNode(itemNumber, true);
+}
+
+//-----------------------------------------------------------------------------
+vtkDMMLNode* vtkDMMLSequenceNode::GetNthDataNode(int itemNumber, bool loadData)
 {
   if (static_cast<int>(this->IndexEntries.size())<=itemNumber)
     {
     vtkErrorMacro("vtkDMMLSequenceNode::GetNthDataNode failed: itemNumber "<<itemNumber<<" is out of range");
     return nullptr;
     }
-  return this->IndexEntries[itemNumber].DataNode;
+  vtkDMMLNode* dataNode = this->IndexEntries[itemNumber].DataNode;
+  if (loadData && dataNode && this->DataNodeLoader)
+    {
+    this->DataNodeLoader->LoadFrame(dataNode);
+    }
+  return dataNode;
+}
+
+//-----------------------------------------------------------------------------
+void vtkDMMLSequenceNode::SetDataNodeLoader(vtkDMMLVolumeSequenceStorageNode* loader)
+{
+  this->DataNodeLoader = loader;
+}
+
+//-----------------------------------------------------------------------------
+vtkDMMLVolumeSequenceStorageNode* vtkDMMLSequenceNode::GetDataNodeLoader()
+{
+  return this->DataNodeLoader;
 }
 
 //-----------------------------------------------------------------------------
@@ -22,10 +22,15 @@
 #include <vtkDMML.h>
 #include <vtkDMMLStorableNode.h>
 
+// VTK includes
+#include <vtkWeakPointer.h>
+
 // std includes
 #include <deque>
 #include <set>
+#include <unordered_map>
 
+class vtkDMMLVolumeSequenceStorageNode;
 
 /// \brief DMML node for representing a sequence of DMML nodes
 ///
@@ -120,6 +125,12 @@ public:
   /// Get the data node corresponding to the n-th index value
   vtkDMMLNode* GetNthDataNode(int itemNumber);
 
+  /// Get the data node corresponding to the n-th index value.
+  /// If loadData is false then data of nodes that are read on demand is not read
+  /// (useful for accessing node properties without reading data of all nodes).
+  /// \sa SetDataNodeLoader()
+  vtkDMMLNode* GetNthDataNode(int itemNumber, bool loadData);
+
   /// Index value of n-th data node.
   std::string GetNthIndexValue(int itemNumber);
 
@@ -156,6 +167,13 @@ public:
   /// Update node IDs in case of node ID conflicts on scene import
   void UpdateScene(vtkDMMLScene *scene) override;
 
+  /// Storage node that reads data of data nodes on demand.
+  /// If set then GetNthDataNode() and GetDataNodeAtValue() ask the loader to read
+  /// the data of the returned node (if it has not been read yet).
+  /// The loader is set by the storage node when the sequence is read.
+  void SetDataNodeLoader(vtkDMMLVolumeSequenceStorageNode* loader);
+  vtkDMMLVolumeSequenceStorageNode* GetDataNodeLoader();
+
   /// Type of the index. Controls the behavior of sorting, finding, etc.
   /// Additional types may be added in the future, such as tag cloud, two-dimensional index, ...
   enum IndexTypes
@@ -181,11 +199,23 @@ protected:
 
   struct IndexEntryType
     {
+    /// Set the index value and update the cached numeric value
+    void SetIndexValue(const std::string& indexValue);
+
     std::string IndexValue;
-    vtkDMMLNode* DataNode;
+    double NumericIndexValue{0.0}; // IndexValue converted to number, cached for fast numeric lookup
+    vtkDMMLNode* DataNode{nullptr};
     std::string DataNodeID; // only used temporarily, during scene load
     };
 
+  /// Find item by exact index value string using the lookup table.
+  /// The table is rebuilt if it was invalidated by a change in the index entries.
+  int GetItemNumberFromIndexValueString(const std::string& indexValue);
+
+  /// Mark the index value lookup table out-of-date.
+  /// Must be called whenever item numbers of existing index entries change.
+  void InvalidateIndexValueLookup();
+
 protected:
 
   /// Describes index of the sequence node
@@ -200,6 +230,13 @@ protected:
 
   /// List of data items (the scene may contain some more nodes, such as storage nodes)
   std::deque< IndexEntryType > IndexEntries;
+
+  /// Maps index value strings to item numbers. Rebuilt on demand when IndexValueLookupValid is false.
+  std::unordered_map< std::string, int > IndexValueLookup;
+  bool IndexValueLookupValid{false};
+
+  /// Reads data of data nodes on demand (not owned, typically the storage node of this sequence)
+  vtkWeakPointer<vtkDMMLVolumeSequenceStorageNode> DataNodeLoader;
 };
 
 #endif
@@ -42,6 +42,9 @@
 #include <set>
 #include <map>
 #include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <unordered_map>
 
 //----------------------------------------------------------------------------
 const vtkIdType vtkDMMLSubjectHierarchyNode::INVALID_ITEM_ID = 0;
@@ -52,6 +55,39 @@ const std::string vtkDMMLSubjectHierarchyNode::SUBJECTHIERARCHY_VERSION_ATTRIBUT
 //----------------------------------------------------------------------------
 vtkDMMLNodeNewMacro(vtkDMMLSubjectHierarchyNode);
 
+//----------------------------------------------------------------------------
+class vtkSubjectHierarchyItem;
+
+//----------------------------------------------------------------------------
+/// Lookup tables for the items in the tree of one subject hierarchy node.
+/// They are owned by the subject hierarchy node and shared by all items in its tree.
+/// The tables are only changed when the tree is changed, so lookups do not need locking:
+/// concurrent lookups are safe as long as the hierarchy is not modified at the same time.
+struct vtkSubjectHierarchyItemCache
+{
+  std::unordered_map<vtkIdType, vtkSubjectHierarchyItem*> Items;
+  std::unordered_map<vtkDMMLNode*, vtkSubjectHierarchyItem*> DataNodes;
+  /// Items by UID (key is created by GetUIDKey). Multiple items may have the same UID.
+  std::unordered_multimap<std::string, vtkSubjectHierarchyItem*> UIDs;
+
+  static std::string GetUIDKey(const std::string& uidName, const std::string& uidValue)
+  {
+    return uidName + vtkDMMLSubjectHierarchyNode::SUBJECTHIERARCHY_NAME_VALUE_SEPARATOR + uidValue;
+  }
+  void RemoveUID(const std::string& uidName, const std::string& uidValue, vtkSubjectHierarchyItem* item)
+  {
+    auto range = this->UIDs.equal_range(GetUIDKey(uidName, uidValue));
+    for (auto uidIt = range.first; uidIt != range.second; ++uidIt)
+      {
+      if (uidIt->second == item)
+        {
+        this->UIDs.erase(uidIt);
+        return;
+        }
+      }
+  }
+};
+
 //----------------------------------------------------------------------------
 class vtkSubjectHierarchyItem : public vtkObject
 {
@@ -103,10 +139,12 @@ public:
   /// The ID is resolved to pointer after import ends, and this member is set to INVALID_ITEM_ID.
   vtkIdType TemporaryParentItemID;
 
-  /// Item and data node cache to speed up lookups that are needed many times.
-  /// It can be static as the item IDs are unique in one application session.
-  static std::map<vtkIdType, vtkSubjectHierarchyItem*> ItemCache;
-  static std::map<vtkDMMLNode*, vtkSubjectHierarchyItem*> DataNodeCache;
+  /// Lookup tables of the subject hierarchy that contains this item.
+  /// Set when the item is added to the tree, nullptr for items that are not in the tree (for example unresolved items).
+  vtkSubjectHierarchyItemCache* Cache{nullptr};
+  /// Data node pointer that the item is registered under in Cache->DataNodes.
+  /// It is only used as a key for removing the entry, as the data node may have been deleted already.
+  vtkDMMLNode* CachedDataNodeKey{nullptr};
 
 // Get/set functions
 public:
@@ -127,6 +165,13 @@ public:
   /// Get name of the item. If has data node associated then return name of data node, \sa Name member otherwise
   std::string GetName();
 
+  /// Add item (ID, data node, UIDs) to the lookup tables of the hierarchy
+  void AddToCache();
+  /// Remove item from the lookup tables of the hierarchy
+  void RemoveFromCache();
+  /// Determine whether this item is a child (or any descendant if recursive) of the given item
+  bool IsChildOf(vtkSubjectHierarchyItem* item, bool recursive);
+
   /// Set UID to the item
   void SetUID(std::string uidName, std::string uidValue);
   /// Get a UID with a given name
@@ -183,6 +228,9 @@ public:
   /// \return Item if found, nullptr otherwise
   void FindChildrenByName( std::string name, std::vector<vtkIdType> &foundItemIDs,
                            bool contains=false, bool recursive=true );
+  /// Find children by name. Name must be lowercase if contains is true.
+  void FindChildrenByNameInBranch( const std::string& name, std::vector<vtkIdType> &foundItemIDs,
+                                   bool contains, bool recursive, std::string& nameBuffer );
   /// Get data nodes (of a certain type) associated to items in the branch of this item
   void GetDataNodesInBranch(vtkCollection *children, const char* childClass=nullptr);
   /// Get IDs of all children in the branch recursively
@@ -235,8 +283,9 @@ public:
   ~vtkSubjectHierarchyItem() override;
 
 private:
-  /// Incremental ID used to uniquely identify subject hierarchy items
-  static vtkIdType NextSubjectHierarchyItemID;
+  /// Incremental ID used to uniquely identify subject hierarchy items.
+  /// Shared by all subject hierarchy nodes (also in different scenes), so it is atomic.
+  static std::atomic<vtkIdType> NextSubjectHierarchyItemID;
 
   vtkSubjectHierarchyItem(const vtkSubjectHierarchyItem&) = delete;
   void operator=(const vtkSubjectHierarchyItem&) = delete;
@@ -245,10 +294,7 @@ private:
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSubjectHierarchyItem);
 
-vtkIdType vtkSubjectHierarchyItem::NextSubjectHierarchyItemID = vtkDMMLSubjectHierarchyNode::INVALID_ITEM_ID + 1;
-
-std::map<vtkIdType, vtkSubjectHierarchyItem*> vtkSubjectHierarchyItem::ItemCache = std::map<vtkIdType, vtkSubjectHierarchyItem*>();
-std::map<vtkDMMLNode*, vtkSubjectHierarchyItem*> vtkSubjectHierarchyItem::DataNodeCache = std::map<vtkDMMLNode*, vtkSubjectHierarchyItem*>();
+std::atomic<vtkIdType> vtkSubjectHierarchyItem::NextSubjectHierarchyItemID(vtkDMMLSubjectHierarchyNode::INVALID_ITEM_ID + 1);
 
 //---------------------------------------------------------------------------
 // vtkSubjectHierarchyItem methods
@@ -280,9 +326,8 @@ vtkSubjectHierarchyItem::~vtkSubjectHierarchyItem()
 //---------------------------------------------------------------------------
 vtkIdType vtkSubjectHierarchyItem::AddToTree(vtkSubjectHierarchyItem* parent, vtkDMMLNode* dataNode)
 {
-  this->ID = vtkSubjectHierarchyItem::NextSubjectHierarchyItemID;
-  vtkSubjectHierarchyItem::NextSubjectHierarchyItemID++;
-  if (vtkSubjectHierarchyItem::NextSubjectHierarchyItemID == static_cast<vtkIdType>(VTK_UNSIGNED_LONG_MAX))
+  this->ID = vtkSubjectHierarchyItem::NextSubjectHierarchyItemID++;
+  if (this->ID + 1 == static_cast<vtkIdType>(VTK_UNSIGNED_LONG_MAX))
     {
     // There is a negligible chance that it reaches maximum, but if it happens then report error
     vtkErrorMacro("AddToTree: Next subject hierarchy item ID reached its maximum value! Item is not added to the tree");
@@ -301,11 +346,8 @@ vtkIdType vtkSubjectHierarchyItem::AddToTree(vtkSubjectHierarchyItem* parent, vt
     this->Parent->Children.push_back(childPointer);
 
     // Add to cache
-    vtkSubjectHierarchyItem::ItemCache[this->ID] = this;
-    if (dataNode)
-      {
-      vtkSubjectHierarchyItem::DataNodeCache[dataNode] = this;
-      }
+    this->Cache = parent->Cache;
+    this->AddToCache();
     }
   else
     {
@@ -320,9 +362,8 @@ vtkIdType vtkSubjectHierarchyItem::AddToTree(vtkSubjectHierarchyItem* parent, vt
 //---------------------------------------------------------------------------
 vtkIdType vtkSubjectHierarchyItem::AddToTree(vtkSubjectHierarchyItem* parent, std::string name, std::string level, int positionUnderParent/*=-1*/)
 {
-  this->ID = vtkSubjectHierarchyItem::NextSubjectHierarchyItemID;
-  vtkSubjectHierarchyItem::NextSubjectHierarchyItemID++;
-  if (vtkSubjectHierarchyItem::NextSubjectHierarchyItemID == static_cast<vtkIdType>(VTK_UNSIGNED_LONG_MAX))
+  this->ID = vtkSubjectHierarchyItem::NextSubjectHierarchyItemID++;
+  if (this->ID + 1 == static_cast<vtkIdType>(VTK_UNSIGNED_LONG_MAX))
     {
     // There is a negligible chance that it reaches maximum, report error in that case
     vtkErrorMacro("AddToTree: Next subject hierarchy item ID reached its maximum value! Item is not added to the tree");
@@ -348,8 +389,9 @@ vtkIdType vtkSubjectHierarchyItem::AddToTree(vtkSubjectHierarchyItem* parent, st
       this->Parent->Children.insert(this->Parent->Children.begin() + positionUnderParent, childPointer);
       }
 
-    // Add to cache (DataNode is nullptr, so no need to add to node cache)
-    vtkSubjectHierarchyItem::ItemCache[this->ID] = this;
+    // Add to cache
+    this->Cache = parent->Cache;
+    this->AddToCache();
     }
   else if (! ( (!name.compare("Scene") && !level.compare("Scene"))
             || (!name.compare("UnresolvedItems") && !level.compare("UnresolvedItems")) ) )
@@ -695,6 +737,68 @@ std::string vtkSubjectHierarchyItem::GetName()
   return this->Name;
 }
 
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItem::AddToCache()
+{
+  if (!this->Cache)
+    {
+    return;
+    }
+  this->Cache->Items[this->ID] = this;
+  if (this->DataNode)
+    {
+    this->CachedDataNodeKey = this->DataNode;
+    this->Cache->DataNodes[this->CachedDataNodeKey] = this;
+    }
+  for (std::map<std::string, std::string>::iterator uidIt = this->UIDs.begin(); uidIt != this->UIDs.end(); ++uidIt)
+    {
+    this->Cache->UIDs.emplace(vtkSubjectHierarchyItemCache::GetUIDKey(uidIt->first, uidIt->second), this);
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItem::RemoveFromCache()
+{
+  if (!this->Cache)
+    {
+    return;
+    }
+  this->Cache->Items.erase(this->ID);
+  if (this->CachedDataNodeKey)
+    {
+    // The entry may have been taken over by another item if the data node was deleted
+    // and a new node was created at the same address
+    auto dataNodeIt = this->Cache->DataNodes.find(this->CachedDataNodeKey);
+    if (dataNodeIt != this->Cache->DataNodes.end() && dataNodeIt->second == this)
+      {
+      this->Cache->DataNodes.erase(dataNodeIt);
+      }
+    this->CachedDataNodeKey = nullptr;
+    }
+  for (std::map<std::string, std::string>::iterator uidIt = this->UIDs.begin(); uidIt != this->UIDs.end(); ++uidIt)
+    {
+    this->Cache->RemoveUID(uidIt->first, uidIt->second, this);
+    }
+  this->Cache = nullptr;
+}
+
+//---------------------------------------------------------------------------
+bool vtkSubjectHierarchyItem::IsChildOf(vtkSubjectHierarchyItem* item, bool recursive)
+{
+  for (vtkSubjectHierarchyItem* parent = this->Parent; parent; parent = parent->Parent)
+    {
+    if (parent == item)
+      {
+      return true;
+      }
+    if (!recursive)
+      {
+      break;
+      }
+    }
+  return false;
+}
+
 //---------------------------------------------------------------------------
 bool vtkSubjectHierarchyItem::HasChildren()
 {
@@ -717,16 +821,16 @@ vtkSubjectHierarchyItem* vtkSubjectHierarchyItem::FindChildByID(vtkIdType itemID
     return nullptr;
     }
 
-  // Try to find item in cache
-  std::map<vtkIdType, vtkSubjectHierarchyItem*>::iterator itemIt = vtkSubjectHierarchyItem::ItemCache.find(itemID);
-  if (itemIt != vtkSubjectHierarchyItem::ItemCache.end())
+  // All items in the tree are in the cache
+  if (this->Cache)
     {
-    return itemIt->second;
+    // It is not an error if item is not found in cache. It happens normally when
+    // scene has just been closed and widgets are updating themselves and trying to look up their selected item.
+    auto itemIt = this->Cache->Items.find(itemID);
+    return (itemIt != this->Cache->Items.end() ? itemIt->second : nullptr);
     }
-  // It is not an error if item is not found in cache. It happens normally when
-  // scene has just been closed and widgets are updating themselves and trying to look up their selected item.
 
-  // On failure to look up in cache (should not happen), traverse tree to find item
+  // Item is not in the tree (for example unresolved items), traverse branch to find item
   ChildVector::iterator childIt;
   vtkSubjectHierarchyItem* foundItem = nullptr;
   for (childIt=this->Children.begin(); childIt!=this->Children.end(); ++childIt)
@@ -747,10 +851,6 @@ vtkSubjectHierarchyItem* vtkSubjectHierarchyItem::FindChildByID(vtkIdType itemID
         }
       }
     }
-  if (foundItem)
-    {
-    vtkSubjectHierarchyItem::ItemCache[itemID] = this;
-    }
 
   return foundItem;
 }
@@ -763,6 +863,17 @@ vtkSubjectHierarchyItem* vtkSubjectHierarchyItem::FindChildByDataNode(vtkDMMLNod
     return nullptr;
     }
 
+  if (this->Cache)
+    {
+    auto itemIt = this->Cache->DataNodes.find(dataNode);
+    if (itemIt == this->Cache->DataNodes.end() || itemIt->second->DataNode != dataNode
+      || !itemIt->second->IsChildOf(this, recursive))
+      {
+      return nullptr;
+      }
+    return itemIt->second;
+    }
+
   ChildVector::iterator childIt;
   for (childIt=this->Children.begin(); childIt!=this->Children.end(); ++childIt)
     {
@@ -790,6 +901,27 @@ vtkSubjectHierarchyItem* vtkSubjectHierarchyItem::FindChildByUID(std::string uid
     {
     return nullptr;
     }
+
+  if (this->Cache)
+    {
+    vtkSubjectHierarchyItem* foundItem = nullptr;
+    int numberOfFoundItems = 0;
+    auto range = this->Cache->UIDs.equal_range(vtkSubjectHierarchyItemCache::GetUIDKey(uidName, uidValue));
+    for (auto uidIt = range.first; uidIt != range.second; ++uidIt)
+      {
+      if (uidIt->second->IsChildOf(this, recursive))
+        {
+        foundItem = uidIt->second;
+        ++numberOfFoundItems;
+        }
+      }
+    if (numberOfFoundItems <= 1)
+      {
+      return foundItem;
+      }
+    // If multiple items have the same UID then traverse the branch to return the first one in tree order
+    }
+
   ChildVector::iterator childIt;
   for (childIt=this->Children.begin(); childIt!=this->Children.end(); ++childIt)
     {
@@ -844,32 +976,45 @@ void vtkSubjectHierarchyItem::FindChildrenByName(std::string name, std::vector<v
     {
     std::transform(name.begin(), name.end(), name.begin(), ::tolower); // Make it lowercase for case-insensitive comparison
     }
+  std::string nameBuffer;
+  this->FindChildrenByNameInBranch(name, foundItemIDs, contains, recursive, nameBuffer);
+}
 
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItem::FindChildrenByNameInBranch(const std::string& name, std::vector<vtkIdType> &foundItemIDs,
+  bool contains, bool recursive, std::string& nameBuffer)
+{
   ChildVector::iterator childIt;
   for (childIt=this->Children.begin(); childIt!=this->Children.end(); ++childIt)
     {
     vtkSubjectHierarchyItem* currentItem = childIt->GetPointer();
-    std::string currentName = currentItem->GetName();
     if (name.empty())
       {
       // If given name is empty (e.g. GetAllChildrenIDs is called), then it is quicker not to do the unnecessary string operations
       foundItemIDs.push_back(currentItem->ID);
       }
-    else if (contains)
+    else
       {
-      std::transform(currentName.begin(), currentName.end(), currentName.begin(), ::tolower); // Make it lowercase for case-insensitive comparison
-      if (currentName.find(name) != std::string::npos)
+      // Same as GetName, but without creating a string for each item
+      vtkDMMLNode* dataNode = currentItem->DataNode.GetPointer();
+      const char* currentName = (dataNode && dataNode->GetName()) ? dataNode->GetName() : currentItem->Name.c_str();
+      if (contains)
+        {
+        nameBuffer = currentName;
+        std::transform(nameBuffer.begin(), nameBuffer.end(), nameBuffer.begin(), ::tolower); // Make it lowercase for case-insensitive comparison
+        if (nameBuffer.find(name) != std::string::npos)
+          {
+          foundItemIDs.push_back(currentItem->ID);
+          }
+        }
+      else if (!name.compare(currentName))
         {
         foundItemIDs.push_back(currentItem->ID);
         }
       }
-    else if (!currentName.compare(name))
-      {
-      foundItemIDs.push_back(currentItem->ID);
-      }
     if (recursive)
       {
-      currentItem->FindChildrenByName(name, foundItemIDs, contains);
+      currentItem->FindChildrenByNameInBranch(name, foundItemIDs, contains, recursive, nameBuffer);
       }
     }
 }
@@ -1100,19 +1245,15 @@ bool vtkSubjectHierarchyItem::RemoveChild(vtkSubjectHierarchyItem* item)
     return false;
     }
 
-  ChildVector::iterator childIt;
-  for (childIt=this->Children.begin(); childIt!=this->Children.end(); ++childIt)
-    {
-    if (item == childIt->GetPointer())
-      {
-      break;
-      }
-    }
-  if (childIt == this->Children.end())
+  // Search from the end, as children are typically removed in reverse order (see RemoveAllChildren)
+  ChildVector::reverse_iterator childReverseIt = std::find_if(this->Children.rbegin(), this->Children.rend(),
+    [item](const vtkSmartPointer<vtkSubjectHierarchyItem>& child) { return child.GetPointer() == item; });
+  if (childReverseIt == this->Children.rend())
     {
     vtkErrorMacro("RemoveChild: Subject hierarchy item '" << item->GetName() << "' not found in item '" << this->GetName() << "'");
     return false;
     }
+  ChildVector::iterator childIt = std::next(childReverseIt).base();
 
   // Prevent deletion of the item from memory until the events are processed
   vtkSmartPointer<vtkSubjectHierarchyItem> removedItem = (*childIt);
@@ -1132,11 +1273,7 @@ bool vtkSubjectHierarchyItem::RemoveChild(vtkSubjectHierarchyItem* item)
   removedItem->ReparentChildrenToParent();
 
   // Remove from cache
-  vtkSubjectHierarchyItem::ItemCache.erase(removedItem->ID);
-  if (removedItem->DataNode)
-    {
-    vtkSubjectHierarchyItem::DataNodeCache.erase(removedItem->DataNode);
-    }
+  removedItem->RemoveFromCache();
 
   // Invoke events
   this->InvokeEvent(vtkDMMLSubjectHierarchyNode::SubjectHierarchyItemRemovedEvent, item);
@@ -1148,22 +1285,17 @@ bool vtkSubjectHierarchyItem::RemoveChild(vtkSubjectHierarchyItem* item)
 //---------------------------------------------------------------------------
 bool vtkSubjectHierarchyItem::RemoveChild(vtkIdType itemID)
 {
-  ChildVector::iterator childIt;
-  for (childIt=this->Children.begin(); childIt!=this->Children.end(); ++childIt)
-    {
-    if (itemID == (*childIt)->ID)
-      {
-      break;
-      }
-    }
-  if (childIt == this->Children.end())
+  // Search from the end, as children are typically removed in reverse order (see RemoveAllChildren)
+  auto hasItemID = [itemID](const vtkSmartPointer<vtkSubjectHierarchyItem>& child) { return child->ID == itemID; };
+  ChildVector::reverse_iterator childReverseIt = std::find_if(this->Children.rbegin(), this->Children.rend(), hasItemID);
+  if (childReverseIt == this->Children.rend())
     {
     vtkErrorMacro("RemoveChild: Subject hierarchy item with ID " << itemID << " not found in item '" << this->GetName() << "'");
     return false;
     }
 
   // Prevent deletion of the item from memory until the events are processed
-  vtkSmartPointer<vtkSubjectHierarchyItem> removedItem = (*childIt);
+  vtkSmartPointer<vtkSubjectHierarchyItem> removedItem = (*childReverseIt);
 
   // If child is a virtual branch (meaning that its children are invalid without the item,
   // as they represent the item's data node's content), then remove virtual branch
@@ -1177,28 +1309,17 @@ bool vtkSubjectHierarchyItem::RemoveChild(vtkIdType itemID)
 
   // The iterator may be invalidated by operations in callback functions (for example, a module may
   // delete some related items when this item is deleted), therefore we need to retrieve the item again.
-  for (childIt = this->Children.begin(); childIt != this->Children.end(); ++childIt)
+  childReverseIt = std::find_if(this->Children.rbegin(), this->Children.rend(), hasItemID);
+  if (childReverseIt != this->Children.rend())
     {
-    if (itemID == (*childIt)->ID)
-      {
-      // item found
-      break;
-      }
-    }
-  if (childIt != this->Children.end())
-    {
-    this->Children.erase(childIt);
+    this->Children.erase(std::next(childReverseIt).base());
     }
 
   // Reparent children to parent node (to avoid them becoming orphans and thus lost to the hierarchy)
   removedItem->ReparentChildrenToParent();
 
   // Remove from cache
-  vtkSubjectHierarchyItem::ItemCache.erase(removedItem->ID);
-  if (removedItem->DataNode)
-    {
-    vtkSubjectHierarchyItem::DataNodeCache.erase(removedItem->DataNode);
-    }
+  removedItem->RemoveFromCache();
 
   // Invoke events
   this->InvokeEvent(vtkDMMLSubjectHierarchyNode::SubjectHierarchyItemRemovedEvent, removedItem.GetPointer());
@@ -1247,30 +1368,37 @@ void vtkSubjectHierarchyItem::ReparentChildrenToParent()
 //---------------------------------------------------------------------------
 void vtkSubjectHierarchyItem::RemoveAllChildren()
 {
+  // Children are listed in depth-first order, so by removing them starting from the end of the list
+  // each item is a leaf item by the time it is removed.
   std::vector<vtkIdType> childIDs;
   this->GetAllChildren(childIDs);
-  while (childIDs.size())
+  while (!childIDs.empty())
     {
-    // Remove first leaf item found
-    std::vector<vtkIdType>::iterator childIt;
-    for (childIt=childIDs.begin(); childIt!=childIDs.end(); ++childIt)
+    vtkIdType childID = childIDs.back();
+    if (childID == vtkDMMLSubjectHierarchyNode::INVALID_ITEM_ID)
       {
-      if ((*childIt) == vtkDMMLSubjectHierarchyNode::INVALID_ITEM_ID)
-        {
-        // This can happen when UnresolvedItems are deleted. In that case the items will automatically deconstruct
-        childIDs.erase(childIt);
-        break;
-        }
-      vtkSubjectHierarchyItem* currentItem = this->FindChildByID(*childIt);
-      if (currentItem && !currentItem->HasChildren())
-        {
-        // Remove leaf item
-        currentItem->Parent->RemoveChild(*childIt);
-        // Remove ID of deleted item from list and keep deleting until empty
-        childIDs.erase(childIt);
-        break;
-        }
+      // This can happen when UnresolvedItems are deleted. In that case the items will automatically deconstruct
+      childIDs.pop_back();
+      continue;
+      }
+    vtkSubjectHierarchyItem* currentItem = this->FindChildByID(childID);
+    if (!currentItem)
+      {
+      // Already removed (for example by an observer of a previous removal)
+      childIDs.pop_back();
+      continue;
       }
+    if (currentItem->HasChildren())
+      {
+      // Items were added under the item while removing its children, remove those first
+      std::vector<vtkIdType> addedChildIDs;
+      currentItem->GetAllChildren(addedChildIDs);
+      childIDs.insert(childIDs.end(), addedChildIDs.begin(), addedChildIDs.end());
+      continue;
+      }
+    // Remove leaf item
+    childIDs.pop_back();
+    currentItem->Parent->RemoveChild(childID);
     } // While there are children to delete
 }
 
@@ -1290,8 +1418,16 @@ void vtkSubjectHierarchyItem::SetUID(std::string uidName, std::string uidValue)
       {
       return; // Do nothing if the UID values match
       }
+    if (this->Cache)
+      {
+      this->Cache->RemoveUID(uidName, this->UIDs[uidName], this);
+      }
     }
   this->UIDs[uidName] = uidValue;
+  if (this->Cache)
+    {
+    this->Cache->UIDs.emplace(vtkSubjectHierarchyItemCache::GetUIDKey(uidName, uidValue), this);
+    }
   this->InvokeEvent(vtkDMMLSubjectHierarchyNode::SubjectHierarchyItemUIDAddedEvent, this);
   this->Modified();
 }
@@ -1473,6 +1609,9 @@ public:
   /// potentially being handled as normal, resolved subject hierarchy items.
   vtkSubjectHierarchyItem* UnresolvedItems;
 
+  /// Lookup tables of the items in the tree under the scene item
+  vtkSubjectHierarchyItemCache ItemCache;
+
   /// Flag determining whether to skip processing any events. Used only internally
   bool EventsDisabled;
   /// Flag indicating whether resolving unresolved items is underway (after scene import or restore)
@@ -1494,6 +1633,8 @@ vtkDMMLSubjectHierarchyNode::vtkInternal::vtkInternal(vtkDMMLSubjectHierarchyNod
   // Create scene item
   this->SceneItem = vtkSubjectHierarchyItem::New();
   this->SceneItemID = this->SceneItem->AddToTree(nullptr, "Scene", "Scene");
+  // Items added under the scene item are stored in the cache of this hierarchy
+  this->SceneItem->Cache = &this->ItemCache;
 
   // Create mock item containing unresolved items
   this->UnresolvedItems = vtkSubjectHierarchyItem::New();
@@ -2078,22 +2219,13 @@ void vtkDMMLSubjectHierarchyNode::SetItemDataNode(vtkIdType itemID, vtkDMMLNode*
     return;
     }
 
-  // Remove old cached node
-  if (item->DataNode)
-    {
-    auto itemIt = vtkSubjectHierarchyItem::DataNodeCache.find(item->DataNode);
-    if (itemIt != vtkSubjectHierarchyItem::DataNodeCache.end())
-      {
-      vtkSubjectHierarchyItem::DataNodeCache.erase(itemIt);
-      }
-    }
-
   item->DataNode = dataNode;
 
   // Add new node to cache
-  if (item->DataNode)
+  if (item->DataNode && item->Cache)
     {
-    vtkSubjectHierarchyItem::DataNodeCache[item->DataNode] = item;
+    item->CachedDataNodeKey = item->DataNode;
+    item->Cache->DataNodes[item->CachedDataNodeKey] = item;
     }
 
   // Add observers for data node
@@ -2966,31 +3098,8 @@ vtkIdType vtkDMMLSubjectHierarchyNode::GetItemByDataNode(vtkDMMLNode* dataNode)
     return INVALID_ITEM_ID;
     }
 
-  auto itemIt = vtkSubjectHierarchyItem::DataNodeCache.find(dataNode);
-  if (itemIt != vtkSubjectHierarchyItem::DataNodeCache.end())
-    {
-    if (itemIt->second)
-      {
-      if (itemIt->second->DataNode == dataNode)
-        {
-        // found it in cache
-        return itemIt->second->ID;
-        }
-      else
-        {
-        vtkErrorMacro("vtkSubjectHierarchyItem::DataNodeCache inconsistency found");
-        vtkSubjectHierarchyItem::DataNodeCache.erase(itemIt);
-        }
-      }
-    }
-
+  // Look up in the cache of the hierarchy
   vtkSubjectHierarchyItem* item = this->Internal->SceneItem->FindChildByDataNode(dataNode);
-  if (item)
-    {
-    // item was not in the cache, add it now
-    vtkErrorMacro("vtkSubjectHierarchyItem::DataNodeCache item was missing");
-    vtkSubjectHierarchyItem::DataNodeCache[dataNode] = item;
-    }
   return (item ? item->ID : INVALID_ITEM_ID);
 }
 
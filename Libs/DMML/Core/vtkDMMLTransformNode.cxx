@@ -15,6 +15,7 @@ Version:   $Revision: 1.14 $
 #include "vtkDMMLTransformNode.h"
 
 // DMML includes
+#include "vtkCachedInverseWarpTransform.h"
 #include "vtkDMMLBSplineTransformNode.h"
 #include "vtkDMMLGridTransformNode.h"
 #include "vtkDMMLLinearTransformNode.h"
@@ -54,6 +55,8 @@ vtkDMMLTransformNode::vtkDMMLTransformNode()
   this->TransformToParent=nullptr;
   this->TransformFromParent=nullptr;
   this->ReadAsTransformToParent=0;
+  this->UseCachedInverse=false;
+  this->CachedInverseTransform=nullptr;
 
   this->CachedMatrixTransformToParent=vtkMatrix4x4::New();
   this->CachedMatrixTransformFromParent=vtkMatrix4x4::New();
@@ -69,6 +72,12 @@ vtkDMMLTransformNode::~vtkDMMLTransformNode()
   vtkSetAndObserveDMMLObjectMacro(this->TransformToParent, nullptr);
   vtkSetAndObserveDMMLObjectMacro(this->TransformFromParent, nullptr);
 
+  if (this->CachedInverseTransform)
+    {
+    this->CachedInverseTransform->Delete();
+    this->CachedInverseTransform=nullptr;
+    }
+
   this->CachedMatrixTransformToParent->Delete();
   this->CachedMatrixTransformToParent=nullptr;
   this->CachedMatrixTransformFromParent->Delete();
@@ -79,6 +88,8 @@ vtkDMMLTransformNode::~vtkDMMLTransformNode()
 void vtkDMMLTransformNode::WriteXML(ostream& of, int nIndent)
 {
   Superclass::WriteXML(of, nIndent);
+
+  of << " useCachedInverse=\"" << (this->UseCachedInverse ? "true" : "false") << "\"";
 }
 
 //----------------------------------------------------------------------------
@@ -107,6 +118,10 @@ void vtkDMMLTransformNode::ReadXMLAttributes(const char** atts)
         this->ReadAsTransformToParent = 0;
         }
       }
+    else if (!strcmp(attName, "useCachedInverse"))
+      {
+      this->SetUseCachedInverse(!strcmp(attValue, "true"));
+      }
 
     }
 
@@ -302,6 +317,7 @@ void vtkDMMLTransformNode::CopyContent(vtkDMMLNode* anode, bool deepCopy/*=true*
     {
     return;
     }
+  this->SetUseCachedInverse(node->GetUseCachedInverse());
   if (deepCopy)
   {
   this->SetReadAsTransformToParent(node->GetReadAsTransformToParent());
@@ -347,6 +363,7 @@ void vtkDMMLTransformNode::PrintSelf(ostream& os, vtkIndent indent)
 {
   Superclass::PrintSelf(os,indent);
   os << indent << "ReadAsTransformToParent: " << this->ReadAsTransformToParent << "\n";
+  os << indent << "UseCachedInverse: " << (this->UseCachedInverse ? "true" : "false") << "\n";
 
   // Flatten the transform list to make the copying simpler
   if (this->TransformToParent)
@@ -396,6 +413,66 @@ vtkAbstractTransform* vtkDMMLTransformNode::GetTransformToParent()
     }
 }
 
+//----------------------------------------------------------------------------
+vtkAbstractTransform* vtkDMMLTransformNode::GetTransformToParentForConcatenation()
+{
+  vtkCachedInverseWarpTransform* cachedInverseTransform = this->GetCachedInverseTransform();
+  if (!cachedInverseTransform)
+    {
+    return this->GetTransformToParent();
+    }
+  if (this->TransformToParent)
+    {
+    // Transform to parent is used directly, only its inverse is computed using the cache
+    return cachedInverseTransform->GetInverse();
+    }
+  return cachedInverseTransform;
+}
+
+//----------------------------------------------------------------------------
+void vtkDMMLTransformNode::SetUseCachedInverse(bool use)
+{
+  if (this->UseCachedInverse == use)
+    {
+    return;
+    }
+  this->UseCachedInverse = use;
+  if (!use && this->CachedInverseTransform)
+    {
+    this->CachedInverseTransform->Delete();
+    this->CachedInverseTransform = nullptr;
+    }
+  this->Modified();
+  this->TransformModified();
+}
+
+//----------------------------------------------------------------------------
+vtkCachedInverseWarpTransform* vtkDMMLTransformNode::GetCachedInverseTransform()
+{
+  if (!this->UseCachedInverse)
+    {
+    return nullptr;
+    }
+  vtkAbstractTransform* storedTransform = (this->TransformToParent ? this->TransformToParent : this->TransformFromParent);
+  if (!vtkGridTransform::SafeDownCast(storedTransform) && !vtkBSplineTransform::SafeDownCast(storedTransform))
+    {
+    return nullptr;
+    }
+  if (this->CachedInverseTransform && this->CachedInverseTransform->GetSourceTransform() != storedTransform)
+    {
+    // Transform objects that were concatenated before keep using the previous transform,
+    // therefore the cached inverse is not modified but a new one is created.
+    this->CachedInverseTransform->Delete();
+    this->CachedInverseTransform = nullptr;
+    }
+  if (!this->CachedInverseTransform)
+    {
+    this->CachedInverseTransform = vtkCachedInverseWarpTransform::New();
+    this->CachedInverseTransform->SetSourceTransform(storedTransform);
+    }
+  return this->CachedInverseTransform;
+}
+
 //----------------------------------------------------------------------------
 vtkAbstractTransform* vtkDMMLTransformNode::GetTransformFromParent()
 {
@@ -539,7 +616,7 @@ void vtkDMMLTransformNode::GetTransformBetweenNodes(vtkDMMLTransformNode* source
     // traverse the transform tree from bottom to top, from sourceNode to targetNode
     for (vtkDMMLTransformNode* current = sourceNode; current != targetNode; current = current->GetParentTransformNode())
       {
-      vtkAbstractTransform* transformToParent=current->GetTransformToParent();
+      vtkAbstractTransform* transformToParent=current->GetTransformToParentForConcatenation();
       if (transformToParent)
         {
         transformSourceToTarget->Concatenate(transformToParent);
@@ -561,7 +638,7 @@ void vtkDMMLTransformNode::GetTransformBetweenNodes(vtkDMMLTransformNode* source
     // traverse the transform tree from bottom to top, from targetNode to sourceNode
     for (vtkDMMLTransformNode* current = targetNode; current != sourceNode; current = current->GetParentTransformNode())
       {
-      vtkAbstractTransform* transformToParent=current->GetTransformToParent();
+      vtkAbstractTransform* transformToParent=current->GetTransformToParentForConcatenation();
       if (transformToParent)
         {
         transformSourceToTarget->Concatenate(transformToParent);
@@ -669,6 +746,26 @@ void vtkDMMLTransformNode::ApplyTransform(vtkAbstractTransform* transform)
   vtkNew<vtkCollection> transformCopyList;
   FlattenGeneralTransform(transformCopyList.GetPointer(), transformCopy);
 
+  // Cached inverse transforms are only used for computation, store the transform they are computed from
+  // (otherwise the transform could not be saved or edited)
+  for (int transformComponentIndex = 0; transformComponentIndex < transformCopyList->GetNumberOfItems(); transformComponentIndex++)
+    {
+    vtkCachedInverseWarpTransform* cachedInverseTransform = vtkCachedInverseWarpTransform::SafeDownCast(
+      transformCopyList->GetItemAsObject(transformComponentIndex));
+    if (!cachedInverseTransform || !cachedInverseTransform->GetSourceTransform())
+      {
+      continue;
+      }
+    vtkAbstractTransform* sourceTransform = cachedInverseTransform->GetSourceTransform();
+    vtkSmartPointer<vtkAbstractTransform> sourceTransformCopy = vtkSmartPointer<vtkAbstractTransform>::Take(sourceTransform->MakeTransform());
+    DeepCopyTransform(sourceTransformCopy, sourceTransform);
+    if (!cachedInverseTransform->GetInverseFlag())
+      {
+      sourceTransformCopy->Inverse();
+      }
+    transformCopyList->ReplaceItem(transformComponentIndex, sourceTransformCopy);
+    }
+
   vtkAbstractTransform* oldTransformToParent = GetTransformToParent();
   if (oldTransformToParent==nullptr && transformCopyList->GetNumberOfItems()==1)
     {
@@ -1165,6 +1262,13 @@ void vtkDMMLTransformNode::SetAndObserveTransform(vtkAbstractTransform** origina
   // We set the inverse to nullptr, which means that it's unknown and will be computed atuomatically from the original transform
   vtkSetAndObserveDMMLObjectMacro((*inverseTransformPtr), nullptr);
 
+  // The cached inverse was computed from the previous transform
+  if (this->CachedInverseTransform)
+    {
+    this->CachedInverseTransform->Delete();
+    this->CachedInverseTransform = nullptr;
+    }
+
   this->StorableModifiedTime.Modified();
   this->TransformModified();
 
@@ -17,6 +17,7 @@
 
 #include "vtkDMMLDisplayableNode.h"
 
+class vtkCachedInverseWarpTransform;
 class vtkCollection;
 class vtkAbstractTransform;
 class vtkGeneralTransform;
@@ -346,6 +347,24 @@ public:
   /// Internally it does not perform any actual computation just switches ToParent and FromParent.
   void Inverse();
 
+  /// Use a precomputed inverse displacement field for computing the inverse of grid and B-spline transforms.
+  /// The cached inverse is used when the transform is concatenated into transforms between nodes
+  /// (for example, for hardening, resampling, and transform visualization). Computing the inverse
+  /// this way is much faster when many points are transformed but the cache requires memory and
+  /// its computation takes time when the transform is modified.
+  /// The transforms returned by GetTransformToParent() and GetTransformFromParent() are not affected.
+  /// Disabled by default.
+  /// \sa GetCachedInverseTransform
+  void SetUseCachedInverse(bool use);
+  vtkGetMacro(UseCachedInverse, bool);
+  vtkBooleanMacro(UseCachedInverse, bool);
+
+  /// Get the transform that computes the inverse of the stored grid or B-spline transform
+  /// using a precomputed inverse displacement field. It can be used for adjusting cache
+  /// parameters and getting error bounds of the inverse.
+  /// Returns nullptr if UseCachedInverse is disabled or the stored transform is not a grid or B-spline transform.
+  vtkCachedInverseWarpTransform* GetCachedInverseTransform();
+
   /// Update the node's name to reflect that the node content is inverted.
   /// Inversion is implemented by adding/removing " (-)" suffix.
   virtual void InverseName();
@@ -377,6 +396,11 @@ protected:
   /// transform type then it returns nullptr.
   virtual vtkAbstractTransform* GetAbstractTransformAs(vtkAbstractTransform* inputTransform, const char* transformClassName, bool logErrorIfFails);
 
+  ///
+  /// Transform of this node to parent, as it is concatenated into transforms between nodes.
+  /// Same as GetTransformToParent() but uses the cached inverse if UseCachedInverse is enabled.
+  vtkAbstractTransform* GetTransformToParentForConcatenation();
+
   ///
   /// Sets and observes a transform and deletes the inverse (so that the inverse will be computed automatically)
   virtual void SetAndObserveTransform(vtkAbstractTransform** originalTransformPtr, vtkAbstractTransform** inverseTransformPtr, vtkAbstractTransform *transform);
@@ -393,6 +417,9 @@ protected:
 
   int ReadAsTransformToParent;
 
+  bool UseCachedInverse;
+  vtkCachedInverseWarpTransform* CachedInverseTransform;
+
   // Temporary buffers used for returning transform info as char*
   std::string TransformInfo;
 
@@ -22,23 +22,501 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 #include "vtkTeemNRRDReader.h"
 #include "vtkTeemNRRDWriter.h"
 #include "vtkObjectFactory.h"
+#include "vtkDataArray.h"
 #include "vtkImageData.h"
 #ifndef NRRD_CHUNK_IO_AVAILABLE
 #include "vtkImageAppendComponents.h"
 #endif
 #include "vtkImageExtractComponents.h"
+#include "vtkByteSwap.h"
 #include "vtkNew.h"
+#include "vtkSmartPointer.h"
 #include "vtkStringArray.h"
+#include "vtkWeakPointer.h"
+#include "vtksys/FStream.hxx"
 #include "vtksys/SystemTools.hxx"
 
+#include <cstring>
+#include <initializer_list>
+#include <list>
+#include <map>
+#include <vector>
+
+//----------------------------------------------------------------------------
+class vtkDMMLVolumeSequenceStorageNode::vtkInternal
+{
+public:
+  enum FrameStateType
+    {
+    FramePending, ///< voxels are not in memory, they are read when the frame is accessed
+    FrameLoaded, ///< voxels are in memory and can be released
+    FrameRetained ///< voxels are in memory and are not released (for example, modified after reading)
+    };
+
+  struct FrameInfo
+    {
+    vtkWeakPointer<vtkDMMLVolumeNode> VolumeNode;
+    FrameStateType State{FramePending};
+    // Image data and its modification time right after reading, for detecting changes
+    vtkImageData* LoadedImageData{nullptr};
+    vtkMTimeType LoadedImageDataMTime{0};
+    std::list<int>::iterator RecentlyUsedIt;
+    };
+
+  /// Get voxel layout from the file header.
+  /// Returns false if frames cannot be read individually from the file (compressed encoding,
+  /// detached header, unsupported axis order, etc.).
+  bool ReadFileLayout(const std::string& fileName, vtkTeemNRRDReader* reader);
+
+  /// Read voxels of the specified frames into the provided images.
+  bool ReadFrames(const std::vector<int>& frameIndices, const std::vector<vtkImageData*>& images);
+
+  /// Read a single voxel value of the specified frames.
+  bool ReadVoxelValues(const std::vector<int>& frameIndices, vtkIdType voxelIndex, std::vector<double>& values);
+
+  /// Read voxels of the specified frames and set them in the frame volume nodes.
+  /// If releasable is true then the frames are added to the recently used list.
+  bool LoadFrames(const std::vector<int>& frameIndices, bool releasable);
+
+  /// Release least recently used frames until the size of loaded frames is
+  /// not larger than maximumSize. The most recently used frame is kept.
+  void ReleaseFrames(vtkTypeInt64 maximumSize);
+
+  /// Returns true if the frame is not in memory and can be read from the file.
+  bool IsFramePending(int frameIndex);
+
+  /// Move the frame to the front of the recently used list.
+  void TouchFrame(int frameIndex);
+
+  /// Add volume node of the next frame in the file.
+  void AddFrame(vtkDMMLVolumeNode* volumeNode);
+
+  /// Returns frame index of the data node, -1 if the node is not a frame of this file.
+  int GetFrameIndex(vtkDMMLNode* dataNode);
+
+  /// Size of voxels of a single frame, in bytes.
+  vtkTypeInt64 GetFrameSize();
+
+  /// Stop reading frames on demand.
+  void Reset(vtkDMMLVolumeSequenceStorageNode* loader);
+
+  std::string FileName;
+  vtkTypeInt64 DataOffset{0};
+  int Dimensions[3]{0, 0, 0};
+  int ScalarType{VTK_VOID};
+  int ScalarSize{0};
+  int NumberOfFrames{0};
+  /// If true then voxels of all frames are interleaved (axis kinds: list domain domain domain),
+  /// otherwise voxels of each frame are stored in a contiguous block (domain domain domain list).
+  bool FramesInterleaved{false};
+  bool SwapBytes{false};
+
+  std::vector<FrameInfo> Frames;
+  std::map<vtkDMMLNode*, int> FrameIndexByNode;
+  /// Loaded frames that can be released, most recently used is at the front
+  std::list<int> RecentlyUsedFrames;
+  vtkTypeInt64 LoadedFramesSize{0};
+  vtkWeakPointer<vtkDMMLSequenceNode> SequenceNode;
+};
+
+//----------------------------------------------------------------------------
+namespace
+{
+template <class T>
+void CastVoxelValues(const T* source, double* target, size_t numberOfValues)
+{
+  for (size_t i = 0; i < numberOfValues; ++i)
+    {
+    // memcpy is used because the source values may be unaligned
+    T value;
+    memcpy(&value, source + i, sizeof(T));
+    target[i] = static_cast<double>(value);
+    }
+}
+
+template <class T>
+void CopyInterleavedFrameVoxels(const char* source, char* target, vtkIdType numberOfVoxels, vtkIdType sourceStride)
+{
+  for (vtkIdType voxelIndex = 0; voxelIndex < numberOfVoxels; ++voxelIndex)
+    {
+    // memcpy is used because the source values may be unaligned
+    memcpy(target, source, sizeof(T));
+    target += sizeof(T);
+    source += sourceStride;
+    }
+}
+}
+
+//----------------------------------------------------------------------------
+bool vtkDMMLVolumeSequenceStorageNode::vtkInternal::ReadFileLayout(const std::string& fileName, vtkTeemNRRDReader* reader)
+{
+  Nrrd* nrrd = nrrdNew();
+  NrrdIoState* nio = nrrdIoStateNew();
+  // Read just the header, and none of the data
+  nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+  bool supported = (nrrdLoad(nrrd, fileName.c_str(), nio) == 0);
+  unsigned int rangeAxisIdx[NRRD_DIM_MAX] = { 0 };
+  int scalarType = reader->GetDataScalarType();
+  if (supported)
+    {
+    // Only raw encoding allows reading parts of the data
+    supported = (nio->encoding == nrrdEncodingRaw && nio->lineSkip == 0
+      && nrrd->dim == 4 && nrrdRangeAxesGet(nrrd, rangeAxisIdx) == 1
+      && (rangeAxisIdx[0] == 0 || rangeAxisIdx[0] == 3)
+      && nrrd->axis[rangeAxisIdx[0]].kind == nrrdKindList
+      && nrrdElementSize(nrrd) == static_cast<size_t>(vtkDataArray::GetDataTypeSize(scalarType)));
+    }
+  long int byteSkip = 0;
+  if (supported)
+    {
+    this->FramesInterleaved = (rangeAxisIdx[0] == 0);
+    this->NumberOfFrames = static_cast<int>(nrrd->axis[rangeAxisIdx[0]].size);
+    int firstDomainAxis = (this->FramesInterleaved ? 1 : 0);
+    for (int i = 0; i < 3; ++i)
+      {
+      this->Dimensions[i] = static_cast<int>(nrrd->axis[firstDomainAxis + i].size);
+      }
+    this->ScalarType = scalarType;
+    this->ScalarSize = static_cast<int>(nrrdElementSize(nrrd));
+#ifdef VTK_WORDS_BIGENDIAN
+    int machineEndian = airEndianBig;
+#else
+    int machineEndian = airEndianLittle;
+#endif
+    this->SwapBytes = (this->ScalarSize > 1 && nio->endian != machineEndian);
+    byteSkip = nio->byteSkip;
+    }
+  nrrdNuke(nrrd);
+  nrrdIoStateNix(nio);
+  if (!supported)
+    {
+    return false;
+    }
+
+  // Make sure the frames have the same size as the image that the reader would produce
+  int* dataExtent = reader->GetDataExtent();
+  for (int i = 0; i < 3; ++i)
+    {
+    if (dataExtent[i * 2 + 1] - dataExtent[i * 2] + 1 != this->Dimensions[i])
+      {
+      return false;
+      }
+    }
+
+  // Voxels are stored after the header, separated by an empty line.
+  vtksys::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+  if (!file)
+    {
+    return false;
+    }
+  bool headerEndFound = false;
+  std::string line;
+  while (std::getline(file, line))
+    {
+    if (!line.empty() && line[line.size() - 1] == '\r')
+      {
+      line.resize(line.size() - 1);
+      }
+    if (line.empty())
+      {
+      headerEndFound = true;
+      break;
+      }
+    if (line.compare(0, 9, "data file") == 0 || line.compare(0, 8, "datafile") == 0)
+      {
+      // detached header
+      return false;
+      }
+    }
+  if (!headerEndFound)
+    {
+    return false;
+    }
+  vtkTypeInt64 headerSize = static_cast<vtkTypeInt64>(file.tellg());
+  file.seekg(0, std::ios::end);
+  vtkTypeInt64 fileSize = static_cast<vtkTypeInt64>(file.tellg());
+  vtkTypeInt64 dataSize = this->GetFrameSize() * this->NumberOfFrames;
+  // byte skip of -1 means that the data is at the end of the file
+  this->DataOffset = (byteSkip < 0 ? fileSize - dataSize : headerSize + byteSkip);
+  if (this->DataOffset < headerSize || this->DataOffset + dataSize > fileSize)
+    {
+    return false;
+    }
+  this->FileName = fileName;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkDMMLVolumeSequenceStorageNode::vtkInternal::ReadFrames(const std::vector<int>& frameIndices,
+  const std::vector<vtkImageData*>& images)
+{
+  vtksys::ifstream file(this->FileName.c_str(), std::ios::in | std::ios::binary);
+  if (!file)
+    {
+    return false;
+    }
+  const vtkIdType numberOfVoxels = static_cast<vtkIdType>(this->Dimensions[0]) * this->Dimensions[1] * this->Dimensions[2];
+  if (!this->FramesInterleaved)
+    {
+    // Voxels of each frame are stored in a contiguous block
+    const vtkTypeInt64 frameSize = this->GetFrameSize();
+    for (size_t i = 0; i < frameIndices.size(); ++i)
+      {
+      file.seekg(this->DataOffset + frameIndices[i] * frameSize, std::ios::beg);
+      file.read(static_cast<char*>(images[i]->GetScalarPointer()), frameSize);
+      if (!file)
+        {
+        return false;
+        }
+      }
+    }
+  else
+    {
+    // Voxels of frames are interleaved: read the data in blocks and
+    // copy values of the requested frames from each block.
+    const vtkIdType voxelStride = static_cast<vtkIdType>(this->NumberOfFrames) * this->ScalarSize;
+    const vtkIdType blockSizeInVoxels = std::max<vtkIdType>(1, (16 * 1024 * 1024) / voxelStride);
+    std::vector<char> block(blockSizeInVoxels * voxelStride);
+    file.seekg(this->DataOffset, std::ios::beg);
+    for (vtkIdType firstVoxel = 0; firstVoxel < numberOfVoxels; firstVoxel += blockSizeInVoxels)
+      {
+      vtkIdType numberOfBlockVoxels = std::min(blockSizeInVoxels, numberOfVoxels - firstVoxel);
+      file.read(block.data(), numberOfBlockVoxels * voxelStride);
+      if (!file)
+        {
+        return false;
+        }
+      for (size_t i = 0; i < frameIndices.size(); ++i)
+        {
+        const char* source = block.data() + static_cast<vtkIdType>(frameIndices[i]) * this->ScalarSize;
+        char* target = static_cast<char*>(images[i]->GetScalarPointer()) + firstVoxel * this->ScalarSize;
+        switch (this->ScalarSize)
+          {
+          case 1: CopyInterleavedFrameVoxels<vtkTypeUInt8>(source, target, numberOfBlockVoxels, voxelStride); break;
+          case 2: CopyInterleavedFrameVoxels<vtkTypeUInt16>(source, target, numberOfBlockVoxels, voxelStride); break;
+          case 4: CopyInterleavedFrameVoxels<vtkTypeUInt32>(source, target, numberOfBlockVoxels, voxelStride); break;
+          case 8: CopyInterleavedFrameVoxels<vtkTypeUInt64>(source, target, numberOfBlockVoxels, voxelStride); break;
+          default:
+            return false;
+          }
+        }
+      }
+    }
+  if (this->SwapBytes)
+    {
+    for (vtkImageData* image : images)
+      {
+      vtkByteSwap::SwapVoidRange(image->GetScalarPointer(), numberOfVoxels, this->ScalarSize);
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkDMMLVolumeSequenceStorageNode::vtkInternal::ReadVoxelValues(const std::vector<int>& frameIndices,
+  vtkIdType voxelIndex, std::vector<double>& values)
+{
+  values.resize(frameIndices.size());
+  if (frameIndices.empty())
+    {
+    return true;
+    }
+  vtksys::ifstream file(this->FileName.c_str(), std::ios::in | std::ios::binary);
+  if (!file)
+    {
+    return false;
+    }
+  std::vector<char> buffer(frameIndices.size() * this->ScalarSize);
+  if (this->FramesInterleaved)
+    {
+    // Values of all frames of a voxel are stored next to each other, read them at once
+    std::vector<char> voxelValues(static_cast<size_t>(this->NumberOfFrames) * this->ScalarSize);
+    file.seekg(this->DataOffset + voxelIndex * this->NumberOfFrames * this->ScalarSize, std::ios::beg);
+    file.read(voxelValues.data(), voxelValues.size());
+    if (!file)
+      {
+      return false;
+      }
+    for (size_t i = 0; i < frameIndices.size(); ++i)
+      {
+      memcpy(buffer.data() + i * this->ScalarSize, voxelValues.data() + frameIndices[i] * this->ScalarSize, this->ScalarSize);
+      }
+    }
+  else
+    {
+    const vtkTypeInt64 frameSize = this->GetFrameSize();
+    for (size_t i = 0; i < frameIndices.size(); ++i)
+      {
+      file.seekg(this->DataOffset + frameIndices[i] * frameSize + voxelIndex * this->ScalarSize, std::ios::beg);
+      file.read(buffer.data() + i * this->ScalarSize, this->ScalarSize);
+      if (!file)
+        {
+        return false;
+        }
+      }
+    }
+  if (this->SwapBytes)
+    {
+    vtkByteSwap::SwapVoidRange(buffer.data(), static_cast<int>(frameIndices.size()), this->ScalarSize);
+    }
+  switch (this->ScalarType)
+    {
+    vtkTemplateMacro(CastVoxelValues(reinterpret_cast<const VTK_TT*>(buffer.data()), values.data(), frameIndices.size()));
+    default:
+      return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkDMMLVolumeSequenceStorageNode::vtkInternal::LoadFrames(const std::vector<int>& frameIndices, bool releasable)
+{
+  std::vector< vtkSmartPointer<vtkImageData> > images;
+  std::vector< vtkImageData* > imagePointers;
+  for (size_t i = 0; i < frameIndices.size(); ++i)
+    {
+    vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+    // Cjyx expects normalized image position and spacing
+    image->SetDimensions(this->Dimensions);
+    image->AllocateScalars(this->ScalarType, 1);
+    images.push_back(image);
+    imagePointers.push_back(image);
+    }
+  if (!this->ReadFrames(frameIndices, imagePointers))
+    {
+    return false;
+    }
+  for (size_t i = 0; i < frameIndices.size(); ++i)
+    {
+    int frameIndex = frameIndices[i];
+    FrameInfo& frame = this->Frames[frameIndex];
+    if (!frame.VolumeNode)
+      {
+      continue;
+      }
+    frame.VolumeNode->SetAndObserveImageData(images[i]);
+    if (!releasable)
+      {
+      frame.State = FrameRetained;
+      continue;
+      }
+    frame.State = FrameLoaded;
+    frame.LoadedImageData = images[i];
+    frame.LoadedImageDataMTime = images[i]->GetMTime();
+    this->RecentlyUsedFrames.push_front(frameIndex);
+    frame.RecentlyUsedIt = this->RecentlyUsedFrames.begin();
+    this->LoadedFramesSize += this->GetFrameSize();
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkDMMLVolumeSequenceStorageNode::vtkInternal::ReleaseFrames(vtkTypeInt64 maximumSize)
+{
+  while (this->LoadedFramesSize > maximumSize && this->RecentlyUsedFrames.size() > 1)
+    {
+    int frameIndex = this->RecentlyUsedFrames.back();
+    this->RecentlyUsedFrames.pop_back();
+    this->LoadedFramesSize -= this->GetFrameSize();
+    FrameInfo& frame = this->Frames[frameIndex];
+    frame.State = FramePending;
+    if (!frame.VolumeNode)
+      {
+      // node has been deleted
+      continue;
+      }
+    vtkImageData* imageData = frame.VolumeNode->GetImageData();
+    if (imageData != frame.LoadedImageData || (imageData && imageData->GetMTime() != frame.LoadedImageDataMTime))
+      {
+      // Voxels were modified, they cannot be restored from the file
+      frame.State = FrameRetained;
+      continue;
+      }
+    frame.LoadedImageData = nullptr;
+    frame.VolumeNode->SetAndObserveImageData(nullptr);
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkDMMLVolumeSequenceStorageNode::vtkInternal::IsFramePending(int frameIndex)
+{
+  const FrameInfo& frame = this->Frames[frameIndex];
+  return (frame.State == FramePending && frame.VolumeNode && !frame.VolumeNode->GetImageData());
+}
+
+//----------------------------------------------------------------------------
+void vtkDMMLVolumeSequenceStorageNode::vtkInternal::TouchFrame(int frameIndex)
+{
+  this->RecentlyUsedFrames.splice(this->RecentlyUsedFrames.begin(), this->RecentlyUsedFrames,
+    this->Frames[frameIndex].RecentlyUsedIt);
+}
+
+//----------------------------------------------------------------------------
+void vtkDMMLVolumeSequenceStorageNode::vtkInternal::AddFrame(vtkDMMLVolumeNode* volumeNode)
+{
+  FrameInfo frame;
+  frame.VolumeNode = volumeNode;
+  this->Frames.push_back(frame);
+  this->FrameIndexByNode[volumeNode] = static_cast<int>(this->Frames.size()) - 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkDMMLVolumeSequenceStorageNode::vtkInternal::GetFrameIndex(vtkDMMLNode* dataNode)
+{
+  std::map<vtkDMMLNode*, int>::iterator frameIt = this->FrameIndexByNode.find(dataNode);
+  if (frameIt == this->FrameIndexByNode.end()
+    || this->Frames[frameIt->second].VolumeNode.GetPointer() != dataNode)
+    {
+    return -1;
+    }
+  return frameIt->second;
+}
+
+//----------------------------------------------------------------------------
+vtkTypeInt64 vtkDMMLVolumeSequenceStorageNode::vtkInternal::GetFrameSize()
+{
+  return static_cast<vtkTypeInt64>(this->Dimensions[0]) * this->Dimensions[1] * this->Dimensions[2] * this->ScalarSize;
+}
+
+//----------------------------------------------------------------------------
+void vtkDMMLVolumeSequenceStorageNode::vtkInternal::Reset(vtkDMMLVolumeSequenceStorageNode* loader)
+{
+  if (this->SequenceNode && this->SequenceNode->GetDataNodeLoader() == loader)
+    {
+    this->SequenceNode->SetDataNodeLoader(nullptr);
+    }
+  this->SequenceNode = nullptr;
+  this->Frames.clear();
+  this->FrameIndexByNode.clear();
+  this->RecentlyUsedFrames.clear();
+  this->LoadedFramesSize = 0;
+  this->FileName.clear();
+}
+
 //----------------------------------------------------------------------------
 vtkDMMLNodeNewMacro(vtkDMMLVolumeSequenceStorageNode);
 
 //----------------------------------------------------------------------------
-vtkDMMLVolumeSequenceStorageNode::vtkDMMLVolumeSequenceStorageNode() = default;
+vtkDMMLVolumeSequenceStorageNode::vtkDMMLVolumeSequenceStorageNode()
+{
+  this->FrameCacheSize = static_cast<vtkTypeInt64>(4) * 1024 * 1024 * 1024;
+  this->Internal = new vtkInternal;
+}
 
 //----------------------------------------------------------------------------
-vtkDMMLVolumeSequenceStorageNode::~vtkDMMLVolumeSequenceStorageNode() = default;
+vtkDMMLVolumeSequenceStorageNode::~vtkDMMLVolumeSequenceStorageNode()
+{
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkDMMLVolumeSequenceStorageNode::PrintSelf(ostream& os, vtkIndent indent)
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "FrameCacheSize: " << this->FrameCacheSize << "\n";
+  os << indent << "NumberOfPendingFrames: " << this->GetNumberOfPendingFrames() << "\n";
+  os << indent << "LoadedFramesSize: " << this->GetLoadedFramesSize() << "\n";
+}
 
 //----------------------------------------------------------------------------
 bool vtkDMMLVolumeSequenceStorageNode::CanReadInReferenceNode(vtkDMMLNode *refNode)
@@ -172,17 +650,30 @@ int vtkDMMLVolumeSequenceStorageNode::ReadDataInternal(vtkDMMLNode* refNode)
     extractComponents->SetInputConnection(reader->GetOutputPort());
     }
 #else
-  reader->Update();
-  // Copy image data to sequence of volume nodes
-  vtkImageData* imageData = reader->GetOutput();
-  if (imageData == nullptr || imageData->GetPointData()==nullptr || imageData->GetPointData()->GetScalars() == nullptr)
+  // Frames of uncompressed files are read directly into the frame volumes, which avoids
+  // keeping the entire 4D image and the extracted frames in memory at the same time.
+  // Frames that do not fit into the frame cache are read when they are accessed.
+  this->Internal->Reset(this);
+  bool readFramesFromFile = this->Internal->ReadFileLayout(fullName, reader);
+  int numberOfFrames = 0;
+  vtkNew<vtkImageExtractComponents> extractComponents;
+  if (readFramesFromFile)
     {
-    vtkErrorMacro("vtkDMMLVolumeSequenceStorageNode::ReadDataInternal: invalid image data");
-    return 0;
+    numberOfFrames = this->Internal->NumberOfFrames;
+    }
+  else
+    {
+    reader->Update();
+    // Copy image data to sequence of volume nodes
+    vtkImageData* imageData = reader->GetOutput();
+    if (imageData == nullptr || imageData->GetPointData()==nullptr || imageData->GetPointData()->GetScalars() == nullptr)
+      {
+      vtkErrorMacro("vtkDMMLVolumeSequenceStorageNode::ReadDataInternal: invalid image data");
+      return 0;
+      }
+    numberOfFrames = imageData->GetNumberOfScalarComponents();
+    extractComponents->SetInputConnection(reader->GetOutputPort());
     }
-  int numberOfFrames = imageData->GetNumberOfScalarComponents();
-  vtkNew<vtkImageExtractComponents> extractComponents;
-  extractComponents->SetInputConnection(reader->GetOutputPort());
 #endif
 
   vtkDebugMacro(<< " vtkDMMLVolumeSequenceStorageNode::ReadDataInternal: Starting reading sequence. ");
@@ -206,10 +697,13 @@ int vtkDMMLVolumeSequenceStorageNode::ReadDataInternal(vtkDMMLNode* refNode)
       frameVoxels = extractComponents->GetOutput();
       }
 #else
-    extractComponents->SetComponents(frameIndex);
-    extractComponents->Update();
     vtkNew<vtkImageData> frameVoxels;
-    frameVoxels->DeepCopy(extractComponents->GetOutput());
+    if (!readFramesFromFile)
+      {
+      extractComponents->SetComponents(frameIndex);
+      extractComponents->Update();
+      frameVoxels->DeepCopy(extractComponents->GetOutput());
+      }
 #endif
     // Cjyx expects normalized image position and spacing
     frameVoxels->SetOrigin(0, 0, 0);
@@ -218,7 +712,10 @@ int vtkDMMLVolumeSequenceStorageNode::ReadDataInternal(vtkDMMLNode* refNode)
 #ifdef NRRD_CHUNK_IO_AVAILABLE
     frameVolume->SetAndObserveImageData(frameVoxels);
 #else
-    frameVolume->SetAndObserveImageData(frameVoxels.GetPointer());
+    if (!readFramesFromFile)
+      {
+      frameVolume->SetAndObserveImageData(frameVoxels.GetPointer());
+      }
 #endif
     frameVolume->SetRASToIJKMatrix(reader->GetRasToIjkMatrix());
 
@@ -235,8 +732,44 @@ int vtkDMMLVolumeSequenceStorageNode::ReadDataInternal(vtkDMMLNode* refNode)
     std::ostringstream nameStr;
     nameStr << refNode->GetName() << "_" << std::setw(4) << std::setfill('0') << frameIndex << std::ends;
     frameVolume->SetName( nameStr.str().c_str() );
+#ifdef NRRD_CHUNK_IO_AVAILABLE
     volSequenceNode->SetDataNodeAtValue(frameVolume.GetPointer(), indexStr.str().c_str() );
+#else
+    vtkDMMLNode* addedFrameNode = volSequenceNode->SetDataNodeAtValue(frameVolume.GetPointer(), indexStr.str().c_str() );
+    if (readFramesFromFile)
+      {
+      this->Internal->AddFrame(vtkDMMLVolumeNode::SafeDownCast(addedFrameNode));
+      }
+#endif
+    }
+
+#ifndef NRRD_CHUNK_IO_AVAILABLE
+  if (readFramesFromFile)
+    {
+    if (this->Internal->GetFrameSize() * numberOfFrames <= this->FrameCacheSize)
+      {
+      // All frames fit into the cache, read them now
+      if (!this->LoadAllFrames())
+        {
+        vtkErrorMacro("vtkDMMLVolumeSequenceStorageNode::ReadDataInternal: failed to read frames from " << fullName);
+        return 0;
+        }
+      }
+    else
+      {
+      vtkDebugMacro(<< " vtkDMMLVolumeSequenceStorageNode::ReadDataInternal: frames will be read on demand. ");
+      this->Internal->SequenceNode = volSequenceNode;
+      volSequenceNode->SetDataNodeLoader(this);
+      // Read the first frame to allow quick access to image properties
+      if (numberOfFrames > 0 && !this->LoadFrame(volSequenceNode->GetNthDataNode(0, false)))
+        {
+        vtkErrorMacro("vtkDMMLVolumeSequenceStorageNode::ReadDataInternal: failed to read frames from " << fullName);
+        this->Internal->Reset(this);
+        return 0;
+        }
+      }
     }
+#endif
 
   vtkDebugMacro(<< " vtkDMMLVolumeSequenceStorageNode::ReadDataInternal: sequence successfully read. ");
 
@@ -244,6 +777,148 @@ int vtkDMMLVolumeSequenceStorageNode::ReadDataInternal(vtkDMMLNode* refNode)
   return 1;
 }
 
+//----------------------------------------------------------------------------
+bool vtkDMMLVolumeSequenceStorageNode::LoadFrame(vtkDMMLNode* dataNode)
+{
+  int frameIndex = this->Internal->GetFrameIndex(dataNode);
+  if (frameIndex < 0)
+    {
+    // not read by this storage node
+    return false;
+    }
+  vtkInternal::FrameInfo& frame = this->Internal->Frames[frameIndex];
+  if (frame.State == vtkInternal::FrameLoaded)
+    {
+    this->Internal->TouchFrame(frameIndex);
+    return true;
+    }
+  if (frame.State == vtkInternal::FrameRetained)
+    {
+    return true;
+    }
+  if (frame.VolumeNode->GetImageData())
+    {
+    // image data has been set already, do not overwrite it
+    frame.State = vtkInternal::FrameRetained;
+    return true;
+    }
+  std::vector<int> frameIndices;
+  if (this->Internal->FramesInterleaved)
+    {
+    // Reading any frame of an interleaved file requires a pass through all the voxels of the file,
+    // therefore the nearest pending frames (that are likely to be accessed next when browsing
+    // or playing the sequence) are read in the same pass. Up to half of the frame cache is filled,
+    // so that the frames that are read together are not released immediately.
+    const vtkTypeInt64 frameSize = std::max<vtkTypeInt64>(1, this->Internal->GetFrameSize());
+    const size_t maximumNumberOfFrames = static_cast<size_t>(std::max<vtkTypeInt64>(1, this->FrameCacheSize / 2 / frameSize));
+    const int numberOfFrames = static_cast<int>(this->Internal->Frames.size());
+    for (int offset = 1; offset < numberOfFrames && frameIndices.size() + 1 < maximumNumberOfFrames; ++offset)
+      {
+      for (int neighborFrameIndex : { frameIndex + offset, frameIndex - offset })
+        {
+        if (neighborFrameIndex >= 0 && neighborFrameIndex < numberOfFrames
+          && frameIndices.size() + 1 < maximumNumberOfFrames
+          && this->Internal->IsFramePending(neighborFrameIndex))
+          {
+          frameIndices.push_back(neighborFrameIndex);
+          }
+        }
+      }
+    // Frames are added to the recently used list in this order, the farthest frame is released first
+    std::reverse(frameIndices.begin(), frameIndices.end());
+    }
+  frameIndices.push_back(frameIndex);
+  if (!this->Internal->LoadFrames(frameIndices, true))
+    {
+    vtkErrorMacro("LoadFrame: failed to read frame " << frameIndex << " from " << this->Internal->FileName);
+    return false;
+    }
+  this->Internal->ReleaseFrames(this->FrameCacheSize);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkDMMLVolumeSequenceStorageNode::LoadAllFrames()
+{
+  std::vector<int> pendingFrameIndices;
+  for (int frameIndex = 0; frameIndex < static_cast<int>(this->Internal->Frames.size()); ++frameIndex)
+    {
+    if (this->Internal->IsFramePending(frameIndex))
+      {
+      pendingFrameIndices.push_back(frameIndex);
+      }
+    }
+  if (!pendingFrameIndices.empty() && !this->Internal->LoadFrames(pendingFrameIndices, false))
+    {
+    vtkErrorMacro("LoadAllFrames: failed to read frames from " << this->Internal->FileName);
+    return false;
+    }
+  // All frames are in memory now, there is no need to access the file anymore
+  this->Internal->Reset(this);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkDMMLVolumeSequenceStorageNode::IsFrameLoadPending(vtkDMMLNode* dataNode)
+{
+  int frameIndex = this->Internal->GetFrameIndex(dataNode);
+  return (frameIndex >= 0 && this->Internal->Frames[frameIndex].State == vtkInternal::FramePending);
+}
+
+//----------------------------------------------------------------------------
+bool vtkDMMLVolumeSequenceStorageNode::ReadPendingFrameVoxelValues(const int ijk[3], std::map<vtkDMMLNode*, double>& values)
+{
+  values.clear();
+  const int* dimensions = this->Internal->Dimensions;
+  for (int i = 0; i < 3; ++i)
+    {
+    if (ijk[i] < 0 || ijk[i] >= dimensions[i])
+      {
+      return false;
+      }
+    }
+  std::vector<int> pendingFrameIndices;
+  for (int frameIndex = 0; frameIndex < static_cast<int>(this->Internal->Frames.size()); ++frameIndex)
+    {
+    if (this->Internal->IsFramePending(frameIndex))
+      {
+      pendingFrameIndices.push_back(frameIndex);
+      }
+    }
+  vtkIdType voxelIndex = ijk[0] + static_cast<vtkIdType>(dimensions[0]) * (ijk[1] + static_cast<vtkIdType>(dimensions[1]) * ijk[2]);
+  std::vector<double> pendingFrameValues;
+  if (!this->Internal->ReadVoxelValues(pendingFrameIndices, voxelIndex, pendingFrameValues))
+    {
+    vtkErrorMacro("ReadPendingFrameVoxelValues: failed to read voxel values from " << this->Internal->FileName);
+    return false;
+    }
+  for (size_t i = 0; i < pendingFrameIndices.size(); ++i)
+    {
+    values[this->Internal->Frames[pendingFrameIndices[i]].VolumeNode.GetPointer()] = pendingFrameValues[i];
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkDMMLVolumeSequenceStorageNode::GetNumberOfPendingFrames()
+{
+  int numberOfPendingFrames = 0;
+  for (const vtkInternal::FrameInfo& frame : this->Internal->Frames)
+    {
+    if (frame.State == vtkInternal::FramePending && frame.VolumeNode)
+      {
+      numberOfPendingFrames++;
+      }
+    }
+  return numberOfPendingFrames;
+}
+
+//----------------------------------------------------------------------------
+vtkTypeInt64 vtkDMMLVolumeSequenceStorageNode::GetLoadedFramesSize()
+{
+  return this->Internal->LoadedFramesSize;
+}
+
 //----------------------------------------------------------------------------
 bool vtkDMMLVolumeSequenceStorageNode::CanWriteFromReferenceNode(vtkDMMLNode *refNode)
 {
@@ -281,7 +956,8 @@ bool vtkDMMLVolumeSequenceStorageNode::CanWriteFromReferenceNode(vtkDMMLNode *re
   int numberOfFrameVolumes = volSequenceNode->GetNumberOfDataNodes();
   for (int frameIndex = 1; frameIndex<numberOfFrameVolumes; frameIndex++)
     {
-    vtkDMMLVolumeNode* currentFrameVolume = vtkDMMLVolumeNode::SafeDownCast(volSequenceNode->GetNthDataNode(frameIndex));
+    // Frames that are not read yet are not loaded here, as they have the same geometry as the first frame
+    vtkDMMLVolumeNode* currentFrameVolume = vtkDMMLVolumeNode::SafeDownCast(volSequenceNode->GetNthDataNode(frameIndex, false));
     if (currentFrameVolume == nullptr)
       {
       vtkDebugMacro("vtkDMMLVolumeSequenceStorageNode::CanWriteFromReferenceNode: only volume nodes can be written (frame "<<frameIndex<<")");
@@ -298,6 +974,11 @@ bool vtkDMMLVolumeSequenceStorageNode::CanWriteFromReferenceNode(vtkDMMLNode *re
       this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("Geometry of all volumes in the sequence must be the same."));
       return false;
       }
+    vtkDMMLVolumeSequenceStorageNode* loader = volSequenceNode->GetDataNodeLoader();
+    if (loader && loader->IsFrameLoadPending(currentFrameVolume))
+      {
+      continue;
+      }
     int currentFrameVolumeExtent[6] = { 0, -1, 0, -1, 0, -1 };
     int currentFrameVolumeScalarType = VTK_VOID;
     int currentFrameVolumeNumberOfComponents = 0;
@@ -344,6 +1025,15 @@ int vtkDMMLVolumeSequenceStorageNode::WriteDataInternal(vtkDMMLNode *refNode)
     return 0;
     }
 
+  // Frames that are read on demand must be read before their file is overwritten
+  if (!this->Internal->FileName.empty()
+    && vtksys::SystemTools::SameFile(this->Internal->FileName, this->GetFullNameFromFileName())
+    && !this->LoadAllFrames())
+    {
+    this->GetUserMessages()->AddMessage(vtkCommand::ErrorEvent, std::string("Failed to read frames before overwriting the file."));
+    return 0;
+    }
+
   vtkNew<vtkMatrix4x4> firstVolumeIjkToRas;
   int frameVolumeDimensions[3] = {0};
   int frameVolumeScalarType = VTK_VOID;
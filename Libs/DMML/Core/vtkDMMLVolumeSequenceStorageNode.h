@@ -16,6 +16,7 @@
 #include "vtkDMML.h"
 
 #include "vtkDMMLNRRDStorageNode.h"
+#include <map>
 #include <string>
 
 /// \ingroup Cjyx_QtModules_Sequences
@@ -25,6 +26,7 @@ class VTK_DMML_EXPORT vtkDMMLVolumeSequenceStorageNode : public vtkDMMLNRRDStora
 
   static vtkDMMLVolumeSequenceStorageNode *New();
   vtkTypeMacro(vtkDMMLVolumeSequenceStorageNode,vtkDMMLNRRDStorageNode);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
 
   vtkDMMLNode* CreateNodeInstance() override;
 
@@ -55,6 +57,43 @@ class VTK_DMML_EXPORT vtkDMMLVolumeSequenceStorageNode : public vtkDMMLNRRDStora
   /// Return a default file extension for writing
   const char* GetDefaultWriteFileExtension() override;
 
+  /// Maximum total size (in bytes) of frame voxels that are kept in memory.
+  /// If the frames of an uncompressed NRRD file do not fit into this size then only
+  /// the first frame is read when the sequence is loaded and other frames are read
+  /// when they are accessed (for example, when selected in a sequence browser).
+  /// Least recently accessed frames are released from memory when this size is exceeded.
+  /// Frames that are modified after reading are kept in memory.
+  /// Default is 4GB.
+  vtkSetMacro(FrameCacheSize, vtkTypeInt64);
+  vtkGetMacro(FrameCacheSize, vtkTypeInt64);
+
+  /// Read voxels of a data node that was not read at load time (or was released from memory).
+  /// It is called by the sequence node when the data node is accessed.
+  /// Returns true if the voxels of the data node are in memory.
+  bool LoadFrame(vtkDMMLNode* dataNode);
+
+  /// Read voxels of all frames that are not in memory and stop releasing frames.
+  /// It must be called before the file is modified or removed.
+  /// Returns false if reading failed.
+  bool LoadAllFrames();
+
+  /// Returns true if voxels of the data node have not been read yet
+  /// (they will be read when the node is accessed).
+  bool IsFrameLoadPending(vtkDMMLNode* dataNode);
+
+  /// Read the value of voxel ijk in all frames that are not in memory, without reading the frames.
+  /// This allows getting the voxel value over time (for example, for plotting) at low cost:
+  /// if voxels of frames are interleaved in the file then values of a voxel in all frames
+  /// are read at once. Values are returned for each pending frame data node.
+  /// Returns false if ijk is outside the image or reading failed.
+  bool ReadPendingFrameVoxelValues(const int ijk[3], std::map<vtkDMMLNode*, double>& values);
+
+  /// Number of frames that are not in memory.
+  int GetNumberOfPendingFrames();
+
+  /// Total size (in bytes) of frames that are currently in memory and can be released.
+  vtkTypeInt64 GetLoadedFramesSize();
+
 protected:
   vtkDMMLVolumeSequenceStorageNode();
   ~vtkDMMLVolumeSequenceStorageNode() override;
@@ -80,6 +119,11 @@ protected:
 
   /// Initialize all the supported write file types
   void InitializeSupportedWriteFileTypes() override;
+
+  vtkTypeInt64 FrameCacheSize;
+
+  class vtkInternal;
+  vtkInternal* Internal;
 };
 
 #endif
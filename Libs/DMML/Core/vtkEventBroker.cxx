@@ -22,8 +22,13 @@
 #include <vtkObjectFactory.h>
 #include <vtkTimerLog.h>
 
+// STD includes
+#include <algorithm>
+#include <cstring>
+
 vtkCxxSetObjectMacro(vtkEventBroker, TimerLog, vtkTimerLog);
 vtkCxxSetObjectMacro(vtkEventBroker, RequestModifiedCallback, vtkCallbackCommand);
+vtkCxxSetObjectMacro(vtkEventBroker, RequestProcessEventQueueCallback, vtkCallbackCommand);
 
 //----------------------------------------------------------------------------
 // The IO manager singleton.
@@ -96,10 +101,14 @@ vtkEventBroker::vtkEventBroker()
   this->EventNestingLevel = 0;
   this->TimerLog = vtkTimerLog::New();
   this->CompressCallData = 0;
+  this->CoalescingInterval = 0.0;
+  this->EventQueueProcessingRequested = false;
+  this->NumberOfCoalescedEvents = 0;
   this->LogFileName = nullptr;
   this->ScriptHandler = nullptr;
   this->ScriptHandlerClientData = nullptr;
   this->RequestModifiedCallback = nullptr;
+  this->RequestProcessEventQueueCallback = nullptr;
 }
 
 //----------------------------------------------------------------------------
@@ -124,6 +133,10 @@ vtkEventBroker::~vtkEventBroker()
     {
     this->RequestModifiedCallback->Delete();
     }
+  if (this->RequestProcessEventQueueCallback)
+    {
+    this->RequestProcessEventQueueCallback->Delete();
+    }
   //cout << "vtkEventBroker singleton Deleted" << endl;
 }
 
@@ -696,6 +709,17 @@ void vtkEventBroker::ProcessEvent ( vtkObservation *observation, vtkObject *call
       {
       this->QueueObservation( observation, eid, callData );
       }
+    else if ( this->EventMode == vtkEventBroker::Coalescing )
+      {
+      this->QueueObservation( observation, eid, callData );
+      // schedule processing of the queue when the first event is queued
+      if ( !this->EventQueueProcessingRequested && this->RequestProcessEventQueueCallback )
+        {
+        this->EventQueueProcessingRequested = true;
+        int delayInMs = static_cast<int>( this->CoalescingInterval * 1000.0 );
+        this->RequestProcessEventQueueCallback->Execute( this, vtkCommand::ModifiedEvent, &delayInMs );
+        }
+      }
     else
       {
       vtkErrorMacro ( "Bad EventMode " << this->EventMode );
@@ -758,7 +782,25 @@ void vtkEventBroker::QueueObservation ( vtkObservation *observation,
   // If the event is not currently in the queue, add it and keep a flag.
   //
   vtkObservation::CallType call(eid, callData);
-  if ( this->GetCompressCallData() &&
+  if ( this->EventMode == vtkEventBroker::Coalescing )
+    {
+    // events with different call data are all invoked, only exact repeats are dropped
+    std::deque< vtkObservation::CallType >::const_iterator dataIter;
+    for(dataIter=observation->GetCallDataList()->begin();dataIter != observation->GetCallDataList()->end(); dataIter++)
+      {
+      if ( call.EventID == dataIter->EventID &&
+           call.CallData == dataIter->CallData)
+        {
+        this->NumberOfCoalescedEvents++;
+        break;
+        }
+      }
+    if ( dataIter == observation->GetCallDataList()->end() )
+      {
+      observation->GetCallDataList()->push_back( call );
+      }
+    }
+  else if ( this->GetCompressCallData() &&
        observation->GetEvent() != vtkCommand::AnyEvent)
     {
     observation->GetCallDataList()->clear();
@@ -848,6 +890,11 @@ void vtkEventBroker::InvokeObservation ( vtkObservation *observation,
   double elapsedTime = this->TimerLog->GetUniversalTime() - startTime;
   observation->SetTotalElapsedTime (observation->GetTotalElapsedTime() + elapsedTime);
   observation->SetLastElapsedTime (elapsedTime);
+  observation->SetInvocationCount (observation->GetInvocationCount() + 1);
+  if ( elapsedTime > observation->GetMaximumElapsedTime() )
+    {
+    observation->SetMaximumElapsedTime (elapsedTime);
+    }
   this->LogEvent (observation);
 
   // clear reference to observation (may cause delete)
@@ -866,6 +913,8 @@ void vtkEventBroker::ProcessEventQueue ()
   // - if the observation is no longer in the queue, stop processing events
   // - unregister before after dequeing in case the observation should go away
   //
+  // events queued from now on need a new processing request
+  this->EventQueueProcessingRequested = false;
   while ( this->GetNumberOfQueuedObservations() > 0 )
     {
     vtkObservation *observation = this->EventQueue.front();
@@ -889,6 +938,105 @@ void vtkEventBroker::ProcessEventQueue ()
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkEventBroker::ResetObservationTimings ()
+{
+  ObjectToObservationVectorMap::iterator iter;
+  for(iter=this->SubjectMap.begin(); iter != this->SubjectMap.end(); iter++)
+    {
+    for(ObservationVector::iterator obsIter=iter->second.begin(); obsIter != iter->second.end(); obsIter++)
+      {
+      (*obsIter)->SetLastElapsedTime(0.0);
+      (*obsIter)->SetTotalElapsedTime(0.0);
+      (*obsIter)->SetMaximumElapsedTime(0.0);
+      (*obsIter)->SetInvocationCount(0);
+      }
+    }
+  this->NumberOfCoalescedEvents = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkEventBroker::GetObservationsSortedByElapsedTime (
+  std::vector< vtkObservation* >& observations, unsigned int maxNumberOfObservations/*=0*/)
+{
+  observations.clear();
+  ObjectToObservationVectorMap::iterator iter;
+  for(iter=this->SubjectMap.begin(); iter != this->SubjectMap.end(); iter++)
+    {
+    observations.insert(observations.end(), iter->second.begin(), iter->second.end());
+    }
+  std::sort(observations.begin(), observations.end(),
+    [](vtkObservation* observation1, vtkObservation* observation2)
+    {
+    return observation1->GetTotalElapsedTime() > observation2->GetTotalElapsedTime();
+    });
+  if (maxNumberOfObservations && observations.size() > maxNumberOfObservations)
+    {
+    observations.resize(maxNumberOfObservations);
+    }
+}
+
+//----------------------------------------------------------------------------
+double vtkEventBroker::GetObserverTotalElapsedTime ( vtkObject *observer )
+{
+  double totalElapsedTime = 0.0;
+  ObjectToObservationVectorMap::iterator observerIt = this->ObserverMap.find(observer);
+  if (observerIt == this->ObserverMap.end())
+    {
+    return totalElapsedTime;
+    }
+  for(ObservationVector::iterator obsIter=observerIt->second.begin(); obsIter != observerIt->second.end(); obsIter++)
+    {
+    totalElapsedTime += (*obsIter)->GetTotalElapsedTime();
+    }
+  return totalElapsedTime;
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkEventBroker::GetObserverInvocationCount ( vtkObject *observer )
+{
+  unsigned long invocationCount = 0;
+  ObjectToObservationVectorMap::iterator observerIt = this->ObserverMap.find(observer);
+  if (observerIt == this->ObserverMap.end())
+    {
+    return invocationCount;
+    }
+  for(ObservationVector::iterator obsIter=observerIt->second.begin(); obsIter != observerIt->second.end(); obsIter++)
+    {
+    invocationCount += (*obsIter)->GetInvocationCount();
+    }
+  return invocationCount;
+}
+
+//----------------------------------------------------------------------------
+void vtkEventBroker::PrintObservationTimings ( ostream& os, unsigned int maxNumberOfObservations/*=20*/ )
+{
+  std::vector< vtkObservation* > observations;
+  this->GetObservationsSortedByElapsedTime(observations, maxNumberOfObservations);
+  for (vtkObservation* observation : observations)
+    {
+    if (observation->GetInvocationCount() == 0)
+      {
+      continue;
+      }
+    os << observation->GetSubject()->GetClassName() << " -> "
+       << (observation->GetObserver() ? observation->GetObserver()->GetClassName() : "No observer class")
+       << " [";
+    const char *eventString = vtkCommand::GetStringFromEventId( observation->GetEvent() );
+    if ( strcmp (eventString, "NoEvent") )
+      {
+      os << eventString;
+      }
+    else
+      {
+      os << observation->GetEvent();
+      }
+    os << "]: " << observation->GetTotalElapsedTime() << "s total, "
+       << observation->GetInvocationCount() << " invocations, "
+       << observation->GetMaximumElapsedTime() << "s maximum\n";
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkEventBroker::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -897,6 +1045,8 @@ void vtkEventBroker::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "NumberOfObservations: " << this->GetNumberOfObservations() << "\n";
   os << indent << "NumberOfQueueObservations: " << this->GetNumberOfQueuedObservations() << "\n";
   os << indent << "EventMode: " << this->GetEventModeAsString() << "\n";
+  os << indent << "CoalescingInterval: " << this->CoalescingInterval << "\n";
+  os << indent << "NumberOfCoalescedEvents: " << this->NumberOfCoalescedEvents << "\n";
   os << indent << "EventLogging: " << this->EventLogging << "\n";
   os << indent << "EventNestingLevel: " << this->EventNestingLevel << "\n";
   os << indent << "LogFileName: " <<
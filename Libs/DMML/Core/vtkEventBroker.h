@@ -179,9 +179,15 @@ public:
   /// In synchronous mode, observations are invoked immediately when the
   /// event takes place.  In asynchronous mode, observations are added
   /// to the event queue for later invocation.
+  /// Coalescing mode is the same as asynchronous mode, but a repeated event is
+  /// not queued again if an invocation with the same event ID and call data
+  /// is already in the queue for the observation. This prevents invoking
+  /// the same callback many times in a row, for example for each ModifiedEvent
+  /// of a batch update.
   enum EventMode {
     Synchronous,
-    Asynchronous
+    Asynchronous,
+    Coalescing
   };
   vtkGetMacro(EventMode, int);
   void SetEventMode(int eventMode)
@@ -196,12 +202,29 @@ public:
 
   void SetEventModeToSynchronous() {this->SetEventMode(vtkEventBroker::Synchronous);};
   void SetEventModeToAsynchronous() {this->SetEventMode(vtkEventBroker::Asynchronous);};
+  void SetEventModeToCoalescing() {this->SetEventMode(vtkEventBroker::Coalescing);};
   const char * GetEventModeAsString() {
     if (this->EventMode == vtkEventBroker::Synchronous) return ("Synchronous");
     if (this->EventMode == vtkEventBroker::Asynchronous) return ("Asynchronous");
+    if (this->EventMode == vtkEventBroker::Coalescing) return ("Coalescing");
     return "Undefined";
   }
 
+  ///
+  /// Time interval (in seconds) between queuing the first event in coalescing mode
+  /// and processing the event queue. When the first event is queued, the broker calls
+  /// RequestProcessEventQueueCallback with the interval in milliseconds (int*) as call data,
+  /// which should call ProcessEventQueue after that delay (0 means when the application
+  /// becomes idle). The queue is also processed when ProcessEventQueue is called
+  /// or the event mode is changed.
+  vtkSetMacro (CoalescingInterval, double);
+  vtkGetMacro (CoalescingInterval, double);
+
+  ///
+  /// Number of events that did not need a new invocation because an invocation
+  /// for the same observation and event was already in the queue (coalescing mode only).
+  vtkGetMacro (NumberOfCoalescedEvents, unsigned long);
+
 
   /// Event queue processing
 
@@ -233,6 +256,32 @@ public:
   vtkGetMacro (CompressCallData, int);
   vtkSetMacro (CompressCallData, int);
 
+  /// Observation timing
+  ///
+  /// Elapsed time and number of invocations are recorded in each observation
+  /// (see vtkObservation::GetTotalElapsedTime). These methods help to find
+  /// observers that take the most time.
+
+  ///
+  /// Reset elapsed times and invocation counts of all observations
+  void ResetObservationTimings();
+
+  ///
+  /// Get observations sorted by total elapsed time, largest first.
+  /// If maxNumberOfObservations is != 0, only up to this number of observations are returned
+  void GetObservationsSortedByElapsedTime(std::vector< vtkObservation* >& observations,
+                                          unsigned int maxNumberOfObservations = 0);
+
+  ///
+  /// Total elapsed time (in seconds) and number of invocations of all
+  /// observations of the observer
+  double GetObserverTotalElapsedTime(vtkObject *observer);
+  unsigned long GetObserverInvocationCount(vtkObject *observer);
+
+  ///
+  /// Print timings of the observations that took the most time
+  void PrintObservationTimings(ostream& os, unsigned int maxNumberOfObservations = 20);
+
   ///
   /// Sets the method pointer to be used for processing script observations
   void SetScriptHandler ( void (*scriptHandler) (const char* script, void *clientData), void *clientData )
@@ -252,6 +301,11 @@ public:
   virtual void SetRequestModifiedCallback(vtkCallbackCommand* callback);
   vtkGetObjectMacro(RequestModifiedCallback, vtkCallbackCommand);
 
+  /// Set callback command that schedules processing of the event queue in coalescing mode.
+  /// \sa SetCoalescingInterval
+  virtual void SetRequestProcessEventQueueCallback(vtkCallbackCommand* callback);
+  vtkGetObjectMacro(RequestProcessEventQueueCallback, vtkCallbackCommand);
+
 protected:
   vtkEventBroker();
   ~vtkEventBroker() override;
@@ -297,9 +351,14 @@ protected:
   int EventMode;
   int CompressCallData;
 
+  double CoalescingInterval;
+  bool EventQueueProcessingRequested;
+  unsigned long NumberOfCoalescedEvents;
+
   std::ofstream LogFile;
 
   vtkCallbackCommand* RequestModifiedCallback;
+  vtkCallbackCommand* RequestProcessEventQueueCallback;
 
 private:
   /// DetachObservations is a fast (but dangerous) method to delete all the
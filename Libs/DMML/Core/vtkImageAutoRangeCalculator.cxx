@@ -0,0 +1,615 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#include "vtkImageAutoRangeCalculator.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
+#include <vtkWeakPointer.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <list>
+#include <vector>
+
+namespace
+{
+
+/// Probability that percentiles computed from samples are not within the tolerance
+const double SAMPLING_FAILURE_PROBABILITY = 0.01;
+
+//----------------------------------------------------------------------------
+struct HistogramBinning
+{
+  /// Range of values that can be added to the histogram
+  double Minimum{0.0};
+  double Maximum{0.0};
+  /// Center of the first bin
+  double Origin{0.0};
+  double Spacing{1.0};
+  int NumberOfBins{1};
+};
+
+//----------------------------------------------------------------------------
+HistogramBinning CreateBinning(double minimum, double maximum, bool integerValues, int maximumNumberOfBins)
+{
+  HistogramBinning binning;
+  binning.Minimum = minimum;
+  binning.Maximum = maximum;
+  binning.Origin = minimum;
+  if (!(maximum > minimum))
+    {
+    binning.Maximum = minimum;
+    return binning;
+    }
+  if (integerValues && maximum - minimum + 1 <= maximumNumberOfBins)
+    {
+    binning.NumberOfBins = static_cast<int>(maximum - minimum) + 1;
+    binning.Spacing = 1.0;
+    }
+  else
+    {
+    binning.NumberOfBins = maximumNumberOfBins;
+    binning.Spacing = (maximum - minimum) / (maximumNumberOfBins - 1);
+    }
+  return binning;
+}
+
+//----------------------------------------------------------------------------
+/// Add first component of tuples [begin, end) to the histogram.
+/// Returns the number of values that are outside of the binning range (NaN values are ignored).
+template <class T>
+vtkIdType AccumulateHistogram(const T* values, int numberOfComponents, vtkIdType begin, vtkIdType end,
+  const HistogramBinning& binning, vtkIdType* histogram)
+{
+  const double minimum = binning.Minimum;
+  const double maximum = binning.Maximum;
+  const double origin = binning.Origin;
+  const double inverseSpacing = 1.0 / binning.Spacing;
+  const int lastBinIndex = binning.NumberOfBins - 1;
+  vtkIdType numberOfOutOfRangeValues = 0;
+  for (vtkIdType i = begin; i < end; ++i)
+    {
+    double value = static_cast<double>(values[i * numberOfComponents]);
+    if (value >= minimum && value <= maximum)
+      {
+      histogram[std::min(static_cast<int>((value - origin) * inverseSpacing + 0.5), lastBinIndex)]++;
+      }
+    else if (value < minimum || value > maximum)
+      {
+      numberOfOutOfRangeValues++;
+      }
+    }
+  return numberOfOutOfRangeValues;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType AccumulateHistogram(vtkDataArray* scalars, vtkIdType begin, vtkIdType end,
+  const HistogramBinning& binning, vtkIdType* histogram)
+{
+  int numberOfComponents = scalars->GetNumberOfComponents();
+  switch (scalars->GetDataType())
+    {
+    vtkTemplateMacro(return AccumulateHistogram(static_cast<VTK_TT*>(scalars->GetVoidPointer(0)),
+      numberOfComponents, begin, end, binning, histogram));
+    }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+/// Compute histogram of lines of voxels (a line is a row of voxels along the first axis), in parallel.
+/// If lineIndices is nullptr then lines [0, numberOfLines) are used.
+/// Returns the number of values that are outside of the binning range.
+vtkIdType ComputeLinesHistogram(vtkDataArray* scalars, vtkIdType lineLength, vtkIdType numberOfLines,
+  const vtkIdType* lineIndices, const HistogramBinning& binning, std::vector<vtkIdType>& histogram)
+{
+  vtkSMPThreadLocal<std::vector<vtkIdType>> localHistograms(std::vector<vtkIdType>(binning.NumberOfBins, 0));
+  vtkSMPThreadLocal<vtkIdType> localNumberOfOutOfRangeValues(0);
+  vtkSMPTools::For(0, numberOfLines, [&](vtkIdType begin, vtkIdType end)
+    {
+    vtkIdType* localHistogram = localHistograms.Local().data();
+    vtkIdType& numberOfOutOfRangeValues = localNumberOfOutOfRangeValues.Local();
+    if (!lineIndices)
+      {
+      numberOfOutOfRangeValues += AccumulateHistogram(scalars, begin * lineLength, end * lineLength, binning, localHistogram);
+      return;
+      }
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      numberOfOutOfRangeValues += AccumulateHistogram(scalars, lineIndices[i] * lineLength,
+        (lineIndices[i] + 1) * lineLength, binning, localHistogram);
+      }
+    });
+  histogram.assign(binning.NumberOfBins, 0);
+  for (const std::vector<vtkIdType>& localHistogram : localHistograms)
+    {
+    for (int binIndex = 0; binIndex < binning.NumberOfBins; ++binIndex)
+      {
+      histogram[binIndex] += localHistogram[binIndex];
+      }
+    }
+  vtkIdType numberOfOutOfRangeValues = 0;
+  for (vtkIdType count : localNumberOfOutOfRangeValues)
+    {
+    numberOfOutOfRangeValues += count;
+    }
+  return numberOfOutOfRangeValues;
+}
+
+//----------------------------------------------------------------------------
+/// Index of the voxel that is used as the n-th sample.
+/// Voxels are divided into equal-size strata and a pseudo-random voxel is chosen from each.
+vtkIdType GetSampleVoxelIndex(vtkIdType sampleIndex, double stride, vtkIdType numberOfVoxels)
+{
+  // splitmix64 hash, provides deterministic offset within the stratum
+  uint64_t z = static_cast<uint64_t>(sampleIndex) + 0x9E3779B97F4A7C15ULL;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  z = z ^ (z >> 31);
+  double offset = static_cast<double>(z >> 11) / 9007199254740992.0; // [0, 1)
+  return std::min(static_cast<vtkIdType>((sampleIndex + offset) * stride), numberOfVoxels - 1);
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void ComputeSampledHistogram(const T* values, int numberOfComponents, vtkIdType numberOfVoxels,
+  vtkIdType numberOfSamples, bool integerValues, int maximumNumberOfBins,
+  HistogramBinning& binning, std::vector<vtkIdType>& histogram)
+{
+  const double stride = static_cast<double>(numberOfVoxels) / numberOfSamples;
+
+  // Range of sampled values
+  vtkSMPThreadLocal<double> localMinimum(VTK_DOUBLE_MAX);
+  vtkSMPThreadLocal<double> localMaximum(VTK_DOUBLE_MIN);
+  vtkSMPTools::For(0, numberOfSamples, [&](vtkIdType begin, vtkIdType end)
+    {
+    double& minimum = localMinimum.Local();
+    double& maximum = localMaximum.Local();
+    for (vtkIdType sampleIndex = begin; sampleIndex < end; ++sampleIndex)
+      {
+      double value = static_cast<double>(values[GetSampleVoxelIndex(sampleIndex, stride, numberOfVoxels) * numberOfComponents]);
+      minimum = std::min(minimum, value);
+      maximum = std::max(maximum, value);
+      }
+    });
+  double minimum = VTK_DOUBLE_MAX;
+  double maximum = VTK_DOUBLE_MIN;
+  for (double value : localMinimum)
+    {
+    minimum = std::min(minimum, value);
+    }
+  for (double value : localMaximum)
+    {
+    maximum = std::max(maximum, value);
+    }
+  binning = CreateBinning(minimum, maximum, integerValues, maximumNumberOfBins);
+
+  // Histogram of sampled values
+  const double origin = binning.Origin;
+  const double inverseSpacing = 1.0 / binning.Spacing;
+  const int lastBinIndex = binning.NumberOfBins - 1;
+  vtkSMPThreadLocal<std::vector<vtkIdType>> localHistograms(std::vector<vtkIdType>(binning.NumberOfBins, 0));
+  vtkSMPTools::For(0, numberOfSamples, [&](vtkIdType begin, vtkIdType end)
+    {
+    vtkIdType* localHistogram = localHistograms.Local().data();
+    for (vtkIdType sampleIndex = begin; sampleIndex < end; ++sampleIndex)
+      {
+      double value = static_cast<double>(values[GetSampleVoxelIndex(sampleIndex, stride, numberOfVoxels) * numberOfComponents]);
+      if (value >= minimum && value <= maximum)
+        {
+        localHistogram[std::min(static_cast<int>((value - origin) * inverseSpacing + 0.5), lastBinIndex)]++;
+        }
+      }
+    });
+  histogram.assign(binning.NumberOfBins, 0);
+  for (const std::vector<vtkIdType>& localHistogram : localHistograms)
+    {
+    for (int binIndex = 0; binIndex < binning.NumberOfBins; ++binIndex)
+      {
+      histogram[binIndex] += localHistogram[binIndex];
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void ComputeRangeFromHistogram(const std::vector<vtkIdType>& histogram, const HistogramBinning& binning,
+  const double percentiles[2], double range[2])
+{
+  vtkIdType total = 0;
+  for (vtkIdType count : histogram)
+    {
+    total += count;
+    }
+  range[0] = binning.Minimum;
+  range[1] = binning.Maximum;
+  if (total == 0)
+    {
+    return;
+    }
+  const double lowerCount = total * percentiles[0] / 100.0;
+  const double upperCount = total * percentiles[1] / 100.0;
+  vtkIdType cumulativeCount = 0;
+  bool lowerFound = false;
+  for (int binIndex = 0; binIndex < static_cast<int>(histogram.size()); ++binIndex)
+    {
+    cumulativeCount += histogram[binIndex];
+    if (!lowerFound && cumulativeCount > lowerCount)
+      {
+      range[0] = binning.Origin + binIndex * binning.Spacing;
+      lowerFound = true;
+      }
+    if (cumulativeCount >= upperCount && cumulativeCount > 0)
+      {
+      range[1] = binning.Origin + binIndex * binning.Spacing;
+      break;
+      }
+    }
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+class vtkImageAutoRangeCalculator::vtkInternal
+{
+public:
+  struct CachedResult
+    {
+    vtkWeakPointer<vtkDataArray> Scalars;
+    vtkMTimeType ScalarsMTime{0};
+    double Range[2]{0.0, 0.0};
+    };
+
+  /// Recompute the histogram of the entire image.
+  void ComputeHistogram(vtkDataArray* scalars, int maximumNumberOfBins);
+  /// Store histogram of lines in the extent that have not been added yet.
+  /// Called before the voxels are modified.
+  void AddModifiedLines(const int extent[6]);
+  /// Recompute histogram of modified lines.
+  /// Returns the number of processed voxels or -1 if the histogram cannot be updated
+  /// (modified values are out of the histogram range).
+  vtkIdType UpdateModifiedLines();
+  /// Returns number of processed voxels.
+  vtkIdType UpdateHistogram(vtkImageData* image, vtkDataArray* scalars, const int extent[6], vtkMTimeType scalarsMTime,
+    vtkMTimeType parametersMTime, int maximumNumberOfBins);
+  void ResetHistogram();
+  /// Release memory used for storing modified lines.
+  void ClearModifiedLines();
+
+  /// Most recently used first
+  std::list<CachedResult> CachedResults;
+  vtkMTimeType CachedResultsParametersMTime{0};
+
+  // Histogram of the entire image.
+  // Voxels are processed in lines (rows of voxels along the first axis).
+  vtkWeakPointer<vtkImageData> HistogramImage;
+  vtkWeakPointer<vtkDataArray> HistogramScalars;
+  vtkMTimeType HistogramScalarsMTime{0};
+  vtkMTimeType HistogramParametersMTime{0};
+  int HistogramExtent[6]{0, -1, 0, -1, 0, -1};
+  HistogramBinning Binning;
+  vtkIdType LineLength{0};
+  vtkIdType NumberOfLines{0};
+  std::vector<vtkIdType> Histogram;
+
+  // Lines that are about to be modified and the histogram of their values before the modification.
+  // Only allocated if modified extents are added, released at the next update.
+  std::vector<bool> ModifiedLineFlags;
+  std::vector<vtkIdType> ModifiedLines;
+  std::vector<vtkIdType> ModifiedLinesHistogram;
+};
+
+//----------------------------------------------------------------------------
+void vtkImageAutoRangeCalculator::vtkInternal::ResetHistogram()
+{
+  this->HistogramImage = nullptr;
+  this->HistogramScalars = nullptr;
+  std::vector<vtkIdType>().swap(this->Histogram);
+  this->ClearModifiedLines();
+}
+
+//----------------------------------------------------------------------------
+void vtkImageAutoRangeCalculator::vtkInternal::ClearModifiedLines()
+{
+  std::vector<bool>().swap(this->ModifiedLineFlags);
+  std::vector<vtkIdType>().swap(this->ModifiedLines);
+  std::vector<vtkIdType>().swap(this->ModifiedLinesHistogram);
+}
+
+//----------------------------------------------------------------------------
+void vtkImageAutoRangeCalculator::vtkInternal::ComputeHistogram(vtkDataArray* scalars, int maximumNumberOfBins)
+{
+  double dataRange[2] = { 0.0, 0.0 };
+  scalars->GetRange(dataRange, 0);
+  bool integerValues = (scalars->GetDataType() != VTK_FLOAT && scalars->GetDataType() != VTK_DOUBLE);
+  this->Binning = CreateBinning(dataRange[0], dataRange[1], integerValues, maximumNumberOfBins);
+  ComputeLinesHistogram(scalars, this->LineLength, this->NumberOfLines, nullptr, this->Binning, this->Histogram);
+}
+
+//----------------------------------------------------------------------------
+void vtkImageAutoRangeCalculator::vtkInternal::AddModifiedLines(const int extent[6])
+{
+  vtkDataArray* scalars = this->HistogramScalars;
+  if (this->ModifiedLineFlags.empty())
+    {
+    // The histogram can only be updated if it was computed from the current (not yet modified) voxels.
+    vtkImageData* image = this->HistogramImage;
+    if (!image || !scalars || this->Histogram.empty()
+      || std::max(image->GetMTime(), scalars->GetMTime()) != this->HistogramScalarsMTime)
+      {
+      this->ResetHistogram();
+      return;
+      }
+    this->ModifiedLineFlags.assign(this->NumberOfLines, false);
+    }
+
+  const int* ext = this->HistogramExtent;
+  int modifiedExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    modifiedExtent[axis * 2] = std::max(extent[axis * 2], ext[axis * 2]);
+    modifiedExtent[axis * 2 + 1] = std::min(extent[axis * 2 + 1], ext[axis * 2 + 1]);
+    if (modifiedExtent[axis * 2] > modifiedExtent[axis * 2 + 1])
+      {
+      // modified region is outside of the image
+      return;
+      }
+    }
+
+  const vtkIdType numberOfLinesPerSlice = ext[3] - ext[2] + 1;
+  std::vector<vtkIdType> addedLines;
+  for (int k = modifiedExtent[4]; k <= modifiedExtent[5]; ++k)
+    {
+    for (int j = modifiedExtent[2]; j <= modifiedExtent[3]; ++j)
+      {
+      vtkIdType lineIndex = (k - ext[4]) * numberOfLinesPerSlice + (j - ext[2]);
+      if (!this->ModifiedLineFlags[lineIndex])
+        {
+        this->ModifiedLineFlags[lineIndex] = true;
+        addedLines.push_back(lineIndex);
+        }
+      }
+    }
+  if (addedLines.empty())
+    {
+    return;
+    }
+
+  std::vector<vtkIdType> addedLinesHistogram;
+  ComputeLinesHistogram(scalars, this->LineLength, static_cast<vtkIdType>(addedLines.size()), addedLines.data(),
+    this->Binning, addedLinesHistogram);
+  if (this->ModifiedLinesHistogram.empty())
+    {
+    this->ModifiedLinesHistogram.swap(addedLinesHistogram);
+    }
+  else
+    {
+    for (int binIndex = 0; binIndex < this->Binning.NumberOfBins; ++binIndex)
+      {
+      this->ModifiedLinesHistogram[binIndex] += addedLinesHistogram[binIndex];
+      }
+    }
+  this->ModifiedLines.insert(this->ModifiedLines.end(), addedLines.begin(), addedLines.end());
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkImageAutoRangeCalculator::vtkInternal::UpdateModifiedLines()
+{
+  const vtkIdType numberOfModifiedLines = static_cast<vtkIdType>(this->ModifiedLines.size());
+  if (numberOfModifiedLines == 0)
+    {
+    // only voxels outside of the image were modified
+    return 0;
+    }
+  std::vector<vtkIdType> modifiedLinesHistogram;
+  if (ComputeLinesHistogram(this->HistogramScalars, this->LineLength, numberOfModifiedLines,
+    this->ModifiedLines.data(), this->Binning, modifiedLinesHistogram) > 0)
+    {
+    // new values are not in the histogram range
+    return -1;
+    }
+  for (int binIndex = 0; binIndex < this->Binning.NumberOfBins; ++binIndex)
+    {
+    this->Histogram[binIndex] += modifiedLinesHistogram[binIndex] - this->ModifiedLinesHistogram[binIndex];
+    }
+  return numberOfModifiedLines * this->LineLength;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkImageAutoRangeCalculator::vtkInternal::UpdateHistogram(vtkImageData* image, vtkDataArray* scalars,
+  const int extent[6], vtkMTimeType scalarsMTime, vtkMTimeType parametersMTime, int maximumNumberOfBins)
+{
+  bool histogramValid = (this->HistogramScalars.GetPointer() == scalars
+    && std::equal(extent, extent + 6, this->HistogramExtent)
+    && this->HistogramParametersMTime == parametersMTime
+    && !this->Histogram.empty());
+  if (histogramValid && this->HistogramScalarsMTime == scalarsMTime)
+    {
+    // histogram is already up-to-date
+    return 0;
+    }
+
+  this->HistogramImage = image;
+  if (histogramValid && !this->ModifiedLineFlags.empty())
+    {
+    vtkIdType numberOfProcessedVoxels = this->UpdateModifiedLines();
+    if (numberOfProcessedVoxels >= 0)
+      {
+      this->HistogramScalarsMTime = scalarsMTime;
+      return numberOfProcessedVoxels;
+      }
+    }
+
+  // Full update
+  this->HistogramScalars = scalars;
+  this->HistogramScalarsMTime = scalarsMTime;
+  this->HistogramParametersMTime = parametersMTime;
+  std::copy(extent, extent + 6, this->HistogramExtent);
+  vtkIdType numberOfVoxels = scalars->GetNumberOfTuples();
+  this->LineLength = extent[1] - extent[0] + 1;
+  this->NumberOfLines = static_cast<vtkIdType>(extent[3] - extent[2] + 1) * (extent[5] - extent[4] + 1);
+  if (this->LineLength < 1 || this->NumberOfLines < 1 || this->LineLength * this->NumberOfLines != numberOfVoxels)
+    {
+    // extent is inconsistent with the number of voxels, process them as a single line
+    this->LineLength = numberOfVoxels;
+    this->NumberOfLines = 1;
+    this->HistogramExtent[0] = 0;
+    this->HistogramExtent[1] = static_cast<int>(numberOfVoxels - 1);
+    std::fill(this->HistogramExtent + 2, this->HistogramExtent + 6, 0);
+    }
+  this->ComputeHistogram(scalars, maximumNumberOfBins);
+  return numberOfVoxels;
+}
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkImageAutoRangeCalculator);
+
+//----------------------------------------------------------------------------
+vtkImageAutoRangeCalculator::vtkImageAutoRangeCalculator()
+{
+  this->AutoRangePercentiles[0] = 0.1;
+  this->AutoRangePercentiles[1] = 99.9;
+  this->Sampling = true;
+  this->SamplingPercentileTolerance = 0.05;
+  this->MaximumNumberOfBins = 65536;
+  this->MaximumNumberOfCachedResults = 32;
+  this->NumberOfProcessedVoxels = 0;
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkImageAutoRangeCalculator::~vtkImageAutoRangeCalculator()
+{
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageAutoRangeCalculator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "AutoRangePercentiles: " << this->AutoRangePercentiles[0] << ", " << this->AutoRangePercentiles[1] << "\n";
+  os << indent << "Sampling: " << (this->Sampling ? "true" : "false") << "\n";
+  os << indent << "SamplingPercentileTolerance: " << this->SamplingPercentileTolerance << "\n";
+  os << indent << "MaximumNumberOfBins: " << this->MaximumNumberOfBins << "\n";
+  os << indent << "MaximumNumberOfCachedResults: " << this->MaximumNumberOfCachedResults << "\n";
+  os << indent << "NumberOfCachedResults: " << this->Internal->CachedResults.size() << "\n";
+  os << indent << "NumberOfProcessedVoxels: " << this->NumberOfProcessedVoxels << "\n";
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkImageAutoRangeCalculator::GetRequiredNumberOfSamples(double percentileTolerance)
+{
+  // Dvoretzky-Kiefer-Wolfowitz inequality: P(sup|F_n(x) - F(x)| > epsilon) <= 2 exp(-2 n epsilon^2)
+  double epsilon = percentileTolerance / 100.0;
+  if (epsilon <= 0.0)
+    {
+    return VTK_ID_MAX;
+    }
+  return static_cast<vtkIdType>(std::ceil(std::log(2.0 / SAMPLING_FAILURE_PROBABILITY) / (2.0 * epsilon * epsilon)));
+}
+
+//----------------------------------------------------------------------------
+void vtkImageAutoRangeCalculator::AddModifiedExtent(const int extent[6])
+{
+  this->Internal->AddModifiedLines(extent);
+}
+
+//----------------------------------------------------------------------------
+void vtkImageAutoRangeCalculator::ClearCache()
+{
+  this->Internal->CachedResults.clear();
+  this->Internal->ResetHistogram();
+}
+
+//----------------------------------------------------------------------------
+bool vtkImageAutoRangeCalculator::ComputeAutoRange(vtkImageData* image, double range[2])
+{
+  this->NumberOfProcessedVoxels = 0;
+  vtkDataArray* scalars = (image && image->GetPointData()) ? image->GetPointData()->GetScalars() : nullptr;
+  if (!scalars || scalars->GetNumberOfTuples() < 1)
+    {
+    return false;
+    }
+  vtkMTimeType scalarsMTime = std::max(image->GetMTime(), scalars->GetMTime());
+
+  // Use cached result if available
+  if (this->Internal->CachedResultsParametersMTime != this->GetMTime())
+    {
+    this->Internal->CachedResults.clear();
+    this->Internal->CachedResultsParametersMTime = this->GetMTime();
+    }
+  for (auto it = this->Internal->CachedResults.begin(); it != this->Internal->CachedResults.end(); ++it)
+    {
+    if (it->Scalars.GetPointer() == scalars && it->ScalarsMTime == scalarsMTime)
+      {
+      range[0] = it->Range[0];
+      range[1] = it->Range[1];
+      this->Internal->CachedResults.splice(this->Internal->CachedResults.begin(), this->Internal->CachedResults, it);
+      this->Internal->ClearModifiedLines();
+      return true;
+      }
+    }
+
+  vtkIdType numberOfVoxels = scalars->GetNumberOfTuples();
+  vtkIdType numberOfSamples = vtkImageAutoRangeCalculator::GetRequiredNumberOfSamples(this->SamplingPercentileTolerance);
+  if (this->Sampling && numberOfVoxels / 2 > numberOfSamples)
+    {
+    // Histogram of the entire image would not be updated, release it
+    this->Internal->ResetHistogram();
+    HistogramBinning binning;
+    std::vector<vtkIdType> histogram;
+    bool integerValues = (scalars->GetDataType() != VTK_FLOAT && scalars->GetDataType() != VTK_DOUBLE);
+    int numberOfComponents = scalars->GetNumberOfComponents();
+    switch (scalars->GetDataType())
+      {
+      vtkTemplateMacro(ComputeSampledHistogram(static_cast<VTK_TT*>(scalars->GetVoidPointer(0)), numberOfComponents,
+        numberOfVoxels, numberOfSamples, integerValues, this->MaximumNumberOfBins, binning, histogram));
+      default:
+        vtkErrorMacro("ComputeAutoRange: unsupported scalar type " << scalars->GetDataTypeAsString());
+        return false;
+      }
+    ComputeRangeFromHistogram(histogram, binning, this->AutoRangePercentiles, range);
+    this->NumberOfProcessedVoxels = numberOfSamples;
+    }
+  else
+    {
+    int extent[6] = { 0, -1, 0, -1, 0, -1 };
+    image->GetExtent(extent);
+    this->NumberOfProcessedVoxels = this->Internal->UpdateHistogram(image, scalars, extent, scalarsMTime,
+      this->GetMTime(), this->MaximumNumberOfBins);
+    ComputeRangeFromHistogram(this->Internal->Histogram, this->Internal->Binning, this->AutoRangePercentiles, range);
+    }
+  this->Internal->ClearModifiedLines();
+
+  if (this->MaximumNumberOfCachedResults > 0)
+    {
+    // Only the most recent result is kept for each array
+    this->Internal->CachedResults.remove_if([scalars](const vtkInternal::CachedResult& cachedResult)
+      {
+      return cachedResult.Scalars.GetPointer() == nullptr || cachedResult.Scalars.GetPointer() == scalars;
+      });
+    vtkInternal::CachedResult result;
+    result.Scalars = scalars;
+    result.ScalarsMTime = scalarsMTime;
+    result.Range[0] = range[0];
+    result.Range[1] = range[1];
+    this->Internal->CachedResults.push_front(result);
+    while (static_cast<int>(this->Internal->CachedResults.size()) > this->MaximumNumberOfCachedResults)
+      {
+      this->Internal->CachedResults.pop_back();
+      }
+    }
+  return true;
+}
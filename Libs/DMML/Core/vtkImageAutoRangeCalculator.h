@@ -0,0 +1,113 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#ifndef __vtkImageAutoRangeCalculator_h
+#define __vtkImageAutoRangeCalculator_h
+
+// DMML includes
+#include "vtkDMML.h"
+
+// VTK includes
+#include <vtkObject.h>
+
+class vtkImageData;
+
+/// \brief Compute intensity range between two percentiles of an image.
+///
+/// vtkImageAutoRangeCalculator computes the same auto range as vtkImageHistogramStatistics
+/// (used for automatic window/level and threshold computation) but avoids processing
+/// the entire image whenever possible:
+/// - Large images are sampled: only as many voxels are read as needed to guarantee that
+///   the computed percentiles are within SamplingPercentileTolerance of the exact percentiles
+///   (with 99% probability).
+/// - Results are cached for recently used scalar arrays, therefore switching between
+///   previously displayed images (for example, browsing sequence frames) does not require
+///   recomputation.
+/// - The histogram of the most recently processed image is kept. If the region that is
+///   about to be modified is specified by AddModifiedExtent() then the histogram of the
+///   image rows in this region is computed before the modification and at the next update
+///   only these rows are processed again.
+///
+/// The first component of the image scalars is used.
+class VTK_DMML_EXPORT vtkImageAutoRangeCalculator : public vtkObject
+{
+public:
+  static vtkImageAutoRangeCalculator *New();
+  vtkTypeMacro(vtkImageAutoRangeCalculator, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Percentiles (in the range of 0 to 100) that define the lower and upper value
+  /// of the computed range. Default is (0.1, 99.9).
+  vtkSetVector2Macro(AutoRangePercentiles, double);
+  vtkGetVector2Macro(AutoRangePercentiles, double);
+
+  /// Compute histogram from a subset of the voxels if the image is large.
+  /// Enabled by default.
+  vtkSetMacro(Sampling, bool);
+  vtkGetMacro(Sampling, bool);
+  vtkBooleanMacro(Sampling, bool);
+
+  /// Maximum difference (in percent of voxels) between percentiles computed from
+  /// sampled voxels and the exact percentiles. Smaller values require more samples.
+  /// Default is 0.05.
+  vtkSetClampMacro(SamplingPercentileTolerance, double, 0.0001, 10.0);
+  vtkGetMacro(SamplingPercentileTolerance, double);
+
+  /// Maximum number of histogram bins. Integer images with a smaller range
+  /// than this use one bin for each value, therefore percentiles are exact.
+  /// Default is 65536.
+  vtkSetClampMacro(MaximumNumberOfBins, int, 2, 1 << 24);
+  vtkGetMacro(MaximumNumberOfBins, int);
+
+  /// Number of most recently computed results that are kept.
+  /// Default is 32.
+  vtkSetClampMacro(MaximumNumberOfCachedResults, int, 0, 100000);
+  vtkGetMacro(MaximumNumberOfCachedResults, int);
+
+  /// Compute the intensity range between AutoRangePercentiles.
+  /// Returns false if the image has no scalars.
+  bool ComputeAutoRange(vtkImageData* image, double range[2]);
+
+  /// Indicate that only voxels within the specified extent will be modified before
+  /// the next call of ComputeAutoRange. This allows updating only the affected part
+  /// of the histogram. It must be called before the voxels are modified.
+  /// Multiple extents can be added, their union is used.
+  void AddModifiedExtent(const int extent[6]);
+
+  /// Remove all cached results and histograms.
+  void ClearCache();
+
+  /// Number of voxels that were read in the last ComputeAutoRange call.
+  /// It is 0 if a cached result was used.
+  vtkGetMacro(NumberOfProcessedVoxels, vtkIdType);
+
+  /// Number of samples required for the specified tolerance (in percent of voxels).
+  /// Based on the Dvoretzky-Kiefer-Wolfowitz inequality, at 99% confidence.
+  static vtkIdType GetRequiredNumberOfSamples(double percentileTolerance);
+
+protected:
+  vtkImageAutoRangeCalculator();
+  ~vtkImageAutoRangeCalculator() override;
+
+  double AutoRangePercentiles[2];
+  bool Sampling;
+  double SamplingPercentileTolerance;
+  int MaximumNumberOfBins;
+  int MaximumNumberOfCachedResults;
+  vtkIdType NumberOfProcessedVoxels;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkImageAutoRangeCalculator(const vtkImageAutoRangeCalculator&) = delete;
+  void operator=(const vtkImageAutoRangeCalculator&) = delete;
+};
+
+#endif
@@ -46,6 +46,8 @@ vtkObservation::vtkObservation()
 
   this->LastElapsedTime = 0.0;
   this->TotalElapsedTime = 0.0;
+  this->MaximumElapsedTime = 0.0;
+  this->InvocationCount = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -100,4 +102,6 @@ void vtkObservation::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "LastElapsedTime: " << this->LastElapsedTime << "\n";
   os << indent << "TotalElapsedTime: " << this->TotalElapsedTime << "\n";
+  os << indent << "MaximumElapsedTime: " << this->MaximumElapsedTime << "\n";
+  os << indent << "InvocationCount: " << this->InvocationCount << "\n";
 }
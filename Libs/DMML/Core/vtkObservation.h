@@ -90,6 +90,14 @@ class VTK_DMML_EXPORT vtkObservation : public vtkObject
   vtkGetMacro (TotalElapsedTime, double);
   vtkSetMacro (TotalElapsedTime, double);
 
+  /// Description
+  /// Longest elapsed time of an invocation and number of invocations
+  /// since the timings were last reset
+  vtkGetMacro (MaximumElapsedTime, double);
+  vtkSetMacro (MaximumElapsedTime, double);
+  vtkGetMacro (InvocationCount, unsigned long);
+  vtkSetMacro (InvocationCount, unsigned long);
+
   struct CallType
   {
     inline CallType(unsigned long eventID, void* callData);
@@ -159,6 +167,8 @@ protected:
 
   double LastElapsedTime;
   double TotalElapsedTime;
+  double MaximumElapsedTime;
+  unsigned long InvocationCount;
 
 };
 
@@ -0,0 +1,309 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+// DMML includes
+#include "itkDMMLSharedMemoryImageIO.h"
+#include "itkDMMLSharedMemoryImageIOFactory.h"
+#include "vtkDMMLCoreTestingMacros.h"
+
+// ITK includes
+#include <itkImage.h>
+#include <itkImageFileReader.h>
+#include <itkImageFileWriter.h>
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionIterator.h>
+#include <itkVectorImage.h>
+
+// STD includes
+#include <cmath>
+#include <sstream>
+#include <string>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Return a segment name that is unique to this process
+std::string GetTestFileName(const std::string& suffix)
+{
+  std::ostringstream fileName;
+  fileName << itk::DMMLSharedMemoryImageIO::GetScheme() << "/ShmTest";
+#ifndef _WIN32
+  fileName << getpid();
+#endif
+  fileName << "_" << suffix;
+  return fileName.str();
+}
+
+//----------------------------------------------------------------------------
+// Set non-trivial LPS geometry: origin, anisotropic spacing, and rotated axes
+template <class TImage>
+void SetTestGeometry(TImage* image)
+{
+  typename TImage::PointType origin;
+  typename TImage::SpacingType spacing;
+  typename TImage::DirectionType direction;
+  direction.SetIdentity();
+  const double angle = 0.3;
+  for (unsigned int i = 0; i < TImage::ImageDimension; ++i)
+    {
+    origin[i] = -12.5 + 7.0 * i;
+    spacing[i] = 0.5 + 0.25 * i;
+    }
+  direction[0][0] = std::cos(angle);
+  direction[0][1] = -std::sin(angle);
+  direction[1][0] = std::sin(angle);
+  direction[1][1] = std::cos(angle);
+  image->SetOrigin(origin);
+  image->SetSpacing(spacing);
+  image->SetDirection(direction);
+}
+
+//----------------------------------------------------------------------------
+template <class TImage>
+int CheckGeometry(const TImage* expected, const TImage* actual)
+{
+  CHECK_BOOL(actual->GetLargestPossibleRegion() == expected->GetLargestPossibleRegion(), true);
+  for (unsigned int i = 0; i < TImage::ImageDimension; ++i)
+    {
+    CHECK_DOUBLE_TOLERANCE(actual->GetOrigin()[i], expected->GetOrigin()[i], 1e-9);
+    CHECK_DOUBLE_TOLERANCE(actual->GetSpacing()[i], expected->GetSpacing()[i], 1e-9);
+    for (unsigned int j = 0; j < TImage::ImageDimension; ++j)
+      {
+      CHECK_DOUBLE_TOLERANCE(actual->GetDirection()[i][j], expected->GetDirection()[i][j], 1e-9);
+      }
+    }
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+// Write a scalar image into shared memory and read it back by file name
+template <class TPixel, unsigned int VDimension>
+int TestScalarImageRoundTrip(const std::string& suffix)
+{
+  typedef itk::Image<TPixel, VDimension> ImageType;
+  typename ImageType::Pointer image = ImageType::New();
+  typename ImageType::SizeType size;
+  for (unsigned int i = 0; i < VDimension; ++i)
+    {
+    size[i] = 5 + i;
+    }
+  image->SetRegions(size);
+  image->Allocate();
+  SetTestGeometry(image.GetPointer());
+  itk::ImageRegionIterator<ImageType> it(image, image->GetLargestPossibleRegion());
+  int value = 0;
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it, ++value)
+    {
+    it.Set(static_cast<TPixel>(value % 100) + static_cast<TPixel>(0.5));
+    }
+
+  std::string fileName = GetTestFileName(suffix);
+  typedef itk::ImageFileWriter<ImageType> WriterType;
+  typename WriterType::Pointer writer = WriterType::New();
+  writer->SetFileName(fileName);
+  writer->SetInput(image);
+  writer->Update();
+  CHECK_BOOL(itk::DMMLSharedMemoryImageIO::New()->CanReadFile(fileName.c_str()), true);
+
+  // The ImageIO is found by the file name
+  typedef itk::ImageFileReader<ImageType> ReaderType;
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  reader->Update();
+  CHECK_NOT_NULL(dynamic_cast<itk::DMMLSharedMemoryImageIO*>(reader->GetImageIO()));
+  CHECK_BOOL(reader->GetImageIO()->GetComponentType() == itk::ImageIOBase::MapPixelType<TPixel>::CType, true);
+  CHECK_INT(reader->GetImageIO()->GetNumberOfComponents(), 1u);
+  CHECK_EXIT_SUCCESS(CheckGeometry<ImageType>(image, reader->GetOutput()));
+  itk::ImageRegionConstIterator<ImageType> expectedIt(image, image->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<ImageType> actualIt(reader->GetOutput(), reader->GetOutput()->GetLargestPossibleRegion());
+  for (expectedIt.GoToBegin(), actualIt.GoToBegin(); !expectedIt.IsAtEnd(); ++expectedIt, ++actualIt)
+    {
+    CHECK_BOOL(actualIt.Get() == expectedIt.Get(), true);
+    }
+
+  // The segment can be read multiple times until it is removed
+  reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  reader->Update();
+  CHECK_BOOL(itk::DMMLSharedMemoryImageIO::RemoveSharedMemory(fileName.c_str()), true);
+  CHECK_BOOL(itk::DMMLSharedMemoryImageIO::New()->CanReadFile(fileName.c_str()), false);
+  CHECK_BOOL(itk::DMMLSharedMemoryImageIO::RemoveSharedMemory(fileName.c_str()), false);
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+// Write a multi-component image into shared memory and read it back by file name
+int TestVectorImageRoundTrip()
+{
+  typedef itk::VectorImage<float, 3> ImageType;
+  const unsigned int numberOfComponents = 3;
+  ImageType::Pointer image = ImageType::New();
+  ImageType::SizeType size = {{ 6, 5, 4 }};
+  image->SetRegions(size);
+  image->SetVectorLength(numberOfComponents);
+  image->Allocate();
+  SetTestGeometry(image.GetPointer());
+  itk::ImageRegionIterator<ImageType> it(image, image->GetLargestPossibleRegion());
+  ImageType::PixelType pixel(numberOfComponents);
+  float value = 0.0f;
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+    for (unsigned int c = 0; c < numberOfComponents; ++c)
+      {
+      pixel[c] = value;
+      value += 0.25f;
+      }
+    it.Set(pixel);
+    }
+
+  std::string fileName = GetTestFileName("vector");
+  typedef itk::ImageFileWriter<ImageType> WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetFileName(fileName);
+  writer->SetInput(image);
+  writer->Update();
+
+  typedef itk::ImageFileReader<ImageType> ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  reader->Update();
+  CHECK_INT(reader->GetImageIO()->GetNumberOfComponents(), numberOfComponents);
+  CHECK_BOOL(reader->GetImageIO()->GetComponentType() == itk::ImageIOBase::FLOAT, true);
+  CHECK_INT(reader->GetOutput()->GetNumberOfComponentsPerPixel(), numberOfComponents);
+  CHECK_EXIT_SUCCESS(CheckGeometry<ImageType>(image, reader->GetOutput()));
+  itk::ImageRegionConstIterator<ImageType> expectedIt(image, image->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<ImageType> actualIt(reader->GetOutput(), reader->GetOutput()->GetLargestPossibleRegion());
+  for (expectedIt.GoToBegin(), actualIt.GoToBegin(); !expectedIt.IsAtEnd(); ++expectedIt, ++actualIt)
+    {
+    for (unsigned int c = 0; c < numberOfComponents; ++c)
+      {
+      CHECK_DOUBLE(actualIt.Get()[c], expectedIt.Get()[c]);
+      }
+    }
+
+  CHECK_BOOL(itk::DMMLSharedMemoryImageIO::RemoveSharedMemory(fileName.c_str()), true);
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestInvalidFileNames()
+{
+  itk::DMMLSharedMemoryImageIO::Pointer io = itk::DMMLSharedMemoryImageIO::New();
+  const char* invalidFileNames[] =
+    {
+    "cjyxshm:",
+    "cjyxshm:/",
+    "cjyxshm:name",
+    "cjyxshm:/a/b",
+    "/tmp/image.nrrd",
+    "cjyx:0x1234#vtkDMMLScalarVolumeNode1",
+    };
+  for (const char* fileName : invalidFileNames)
+    {
+    CHECK_BOOL(io->CanWriteFile(fileName), false);
+    CHECK_BOOL(io->CanReadFile(fileName), false);
+    CHECK_BOOL(itk::DMMLSharedMemoryImageIO::RemoveSharedMemory(fileName), false);
+    }
+  CHECK_BOOL(itk::DMMLSharedMemoryImageIO::IsSharedMemoryFileName("cjyxshm:/name"), true);
+  CHECK_BOOL(itk::DMMLSharedMemoryImageIO::IsSharedMemoryFileName("cjyx:/name"), false);
+  CHECK_BOOL(itk::DMMLSharedMemoryImageIO::IsSharedMemoryFileName(nullptr), false);
+
+  // Reading a segment that does not exist fails
+  std::string fileName = GetTestFileName("missing");
+  CHECK_BOOL(io->CanReadFile(fileName.c_str()), false);
+  io->SetFileName(fileName);
+  bool exceptionThrown = false;
+  try
+    {
+    io->ReadImageInformation();
+    }
+  catch (itk::ExceptionObject&)
+    {
+    exceptionThrown = true;
+    }
+  CHECK_BOOL(exceptionThrown, true);
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+// If the segment cannot be allocated then no segment is left behind
+int TestUnlinkOnFailure()
+{
+  std::string fileName = GetTestFileName("failure");
+  itk::DMMLSharedMemoryImageIO::Pointer io = itk::DMMLSharedMemoryImageIO::New();
+  io->SetFileName(fileName);
+  io->SetNumberOfDimensions(3);
+  // Larger than the address space, so either allocation or mapping fails
+  io->SetDimensions(0, 1 << 20);
+  io->SetDimensions(1, 1 << 20);
+  io->SetDimensions(2, 1 << 20);
+  io->SetComponentType(itk::ImageIOBase::DOUBLE);
+  io->SetPixelType(itk::ImageIOBase::SCALAR);
+  io->SetNumberOfComponents(1);
+  char buffer[8] = { 0 };
+  bool exceptionThrown = false;
+  try
+    {
+    io->Write(buffer);
+    }
+  catch (itk::ExceptionObject& exc)
+    {
+    std::cout << "Expected write failure: " << exc.GetDescription() << std::endl;
+    exceptionThrown = true;
+    }
+  CHECK_BOOL(exceptionThrown, true);
+  CHECK_BOOL(io->CanReadFile(fileName.c_str()), false);
+  CHECK_BOOL(itk::DMMLSharedMemoryImageIO::RemoveSharedMemory(fileName.c_str()), false);
+
+  // Images with more than 3 dimensions are rejected before the segment is created
+  io->SetNumberOfDimensions(4);
+  exceptionThrown = false;
+  try
+    {
+    io->Write(buffer);
+    }
+  catch (itk::ExceptionObject&)
+    {
+    exceptionThrown = true;
+    }
+  CHECK_BOOL(exceptionThrown, true);
+  CHECK_BOOL(io->CanReadFile(fileName.c_str()), false);
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int itkDMMLSharedMemoryImageIOTest1(int, char * [])
+{
+  if (!itk::DMMLSharedMemoryImageIO::IsSharedMemorySupported())
+    {
+    std::cout << "Shared memory is not supported on this platform, test skipped" << std::endl;
+    CHECK_BOOL(itk::DMMLSharedMemoryImageIO::New()->CanWriteFile(GetTestFileName("unsupported").c_str()), false);
+    return EXIT_SUCCESS;
+    }
+
+  itk::DMMLSharedMemoryImageIOFactory::RegisterOneFactory();
+
+  CHECK_EXIT_SUCCESS((TestScalarImageRoundTrip<unsigned char, 3>("uchar")));
+  CHECK_EXIT_SUCCESS((TestScalarImageRoundTrip<short, 3>("short")));
+  CHECK_EXIT_SUCCESS((TestScalarImageRoundTrip<unsigned int, 3>("uint")));
+  CHECK_EXIT_SUCCESS((TestScalarImageRoundTrip<float, 3>("float")));
+  CHECK_EXIT_SUCCESS((TestScalarImageRoundTrip<double, 3>("double")));
+  CHECK_EXIT_SUCCESS((TestScalarImageRoundTrip<short, 2>("short2d")));
+  CHECK_EXIT_SUCCESS(TestVectorImageRoundTrip());
+  CHECK_EXIT_SUCCESS(TestInvalidFileNames());
+  CHECK_EXIT_SUCCESS(TestUnlinkOnFailure());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,30 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+/// itkDMMLSharedMemoryIOExport
+///
+/// The itkDMMLSharedMemoryIOExport captures some system differences between Unix
+/// and Windows operating systems.
+
+#ifndef itkDMMLSharedMemoryIOExport_h
+#define itkDMMLSharedMemoryIOExport_h
+
+#include <itkDMMLIDImageIOConfigure.h>
+
+#if defined(WIN32) && !defined(DMMLIDIO_STATIC)
+#if defined(DMMLSharedMemoryIO_EXPORTS)
+#define DMMLSharedMemoryImageIO_EXPORT __declspec( dllexport )
+#else
+#define DMMLSharedMemoryImageIO_EXPORT __declspec( dllimport )
+#endif
+#else
+#define DMMLSharedMemoryImageIO_EXPORT
+#endif
+
+#endif
@@ -0,0 +1,15 @@
+#include "itkDMMLSharedMemoryIOPlugin.h"
+#include "itkDMMLSharedMemoryImageIOFactory.h"
+
+/**
+ * Routine that is called when the shared library is loaded by
+ * itk::ObjectFactoryBase::LoadDynamicFactories().
+ *
+ * itkLoad() is C (not C++) function.
+ */
+itk::ObjectFactoryBase* itkLoad()
+{
+  static itk::DMMLSharedMemoryImageIOFactory::Pointer f
+    = itk::DMMLSharedMemoryImageIOFactory::New();
+  return f;
+}
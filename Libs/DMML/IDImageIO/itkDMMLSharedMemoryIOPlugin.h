@@ -0,0 +1,25 @@
+#ifndef itkDMMLSharedMemoryIOPlugin_h
+#define itkDMMLSharedMemoryIOPlugin_h
+
+#include "itkObjectFactoryBase.h"
+
+#ifdef WIN32
+#ifdef DMMLSharedMemoryIOPlugin_EXPORTS
+#define DMMLSharedMemoryIOPlugin_EXPORT __declspec(dllexport)
+#else
+#define DMMLSharedMemoryIOPlugin_EXPORT __declspec(dllimport)
+#endif
+#else
+#define DMMLSharedMemoryIOPlugin_EXPORT
+#endif
+
+/**
+ * Routine that is called when the shared library is loaded by
+ * itk::ObjectFactoryBase::LoadDynamicFactories().
+ *
+ * itkLoad() is C (not C++) function.
+ */
+extern "C" {
+    DMMLSharedMemoryIOPlugin_EXPORT itk::ObjectFactoryBase* itkLoad();
+}
+#endif
@@ -0,0 +1,392 @@
+/*=auto=========================================================================
+
+Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+See COPYRIGHT.txt
+or http://www.slicer.org/copyright/copyright.txt for details.
+
+Program:   3D Cjyx
+
+=========================================================================auto=*/
+
+#include "itkDMMLSharedMemoryImageIO.h"
+
+// STD includes
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+const char SHARED_MEMORY_SCHEME[] = "cjyxshm:";
+const char SHARED_MEMORY_MAGIC[8] = "CJYXSHM";
+const uint32_t SHARED_MEMORY_VERSION = 1;
+// Pixel buffer is aligned so that it can be used directly by vectorized code
+const size_t SHARED_MEMORY_BUFFER_ALIGNMENT = 64;
+
+//----------------------------------------------------------------------------
+// Layout of the beginning of the shared memory segment.
+// Geometry is stored in LPS, as in image files.
+struct SharedMemoryImageHeader
+{
+  char Magic[8];
+  uint32_t Version;
+  uint32_t NumberOfDimensions;
+  int32_t ComponentType;
+  int32_t PixelType;
+  uint32_t NumberOfComponents;
+  uint32_t Reserved;
+  uint64_t Dimensions[3];
+  double Spacing[3];
+  double Origin[3];
+  double Direction[9]; // direction of axis i is stored in Direction[3*i..3*i+2]
+  uint64_t BufferOffset;
+  uint64_t BufferSize;
+};
+
+//----------------------------------------------------------------------------
+// Return the segment name ("/name") of a "cjyxshm:/name" filename,
+// or an empty string if the filename is not a valid segment name.
+std::string GetSegmentName(const char* filename)
+{
+  if (!itk::DMMLSharedMemoryImageIO::IsSharedMemoryFileName(filename))
+    {
+    return std::string();
+    }
+  std::string name = filename + strlen(SHARED_MEMORY_SCHEME);
+  // POSIX requires a single leading slash
+  if (name.size() < 2 || name[0] != '/' || name.find('/', 1) != std::string::npos)
+    {
+    return std::string();
+    }
+  return name;
+}
+
+} // end of anonymous namespace
+
+namespace itk {
+//----------------------------------------------------------------------------
+DMMLSharedMemoryImageIO
+::DMMLSharedMemoryImageIO()
+{
+  this->m_Mapping = nullptr;
+  this->m_MappingSize = 0;
+  this->m_BufferOffset = 0;
+}
+
+//----------------------------------------------------------------------------
+DMMLSharedMemoryImageIO
+::~DMMLSharedMemoryImageIO()
+{
+  this->ReleaseMapping();
+}
+
+//----------------------------------------------------------------------------
+bool
+DMMLSharedMemoryImageIO
+::IsSharedMemorySupported()
+{
+#ifdef _WIN32
+  return false;
+#else
+  return true;
+#endif
+}
+
+//----------------------------------------------------------------------------
+const char*
+DMMLSharedMemoryImageIO
+::GetScheme()
+{
+  return SHARED_MEMORY_SCHEME;
+}
+
+//----------------------------------------------------------------------------
+bool
+DMMLSharedMemoryImageIO
+::IsSharedMemoryFileName(const char* filename)
+{
+  return filename != nullptr
+    && strncmp(filename, SHARED_MEMORY_SCHEME, strlen(SHARED_MEMORY_SCHEME)) == 0;
+}
+
+//----------------------------------------------------------------------------
+bool
+DMMLSharedMemoryImageIO
+::RemoveSharedMemory(const char* filename)
+{
+  std::string name = GetSegmentName(filename);
+  if (name.empty() || !IsSharedMemorySupported())
+    {
+    return false;
+    }
+#ifdef _WIN32
+  return false;
+#else
+  return shm_unlink(name.c_str()) == 0;
+#endif
+}
+
+//----------------------------------------------------------------------------
+bool
+DMMLSharedMemoryImageIO
+::CanReadFile(const char* filename)
+{
+  std::string name = GetSegmentName(filename);
+  if (name.empty() || !IsSharedMemorySupported())
+    {
+    return false;
+    }
+#ifdef _WIN32
+  return false;
+#else
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0)
+    {
+    return false;
+    }
+  close(fd);
+  return true;
+#endif
+}
+
+//----------------------------------------------------------------------------
+void
+DMMLSharedMemoryImageIO
+::ReleaseMapping()
+{
+#ifndef _WIN32
+  if (this->m_Mapping)
+    {
+    munmap(this->m_Mapping, this->m_MappingSize);
+    }
+#endif
+  this->m_Mapping = nullptr;
+  this->m_MappingSize = 0;
+  this->m_BufferOffset = 0;
+}
+
+//----------------------------------------------------------------------------
+void
+DMMLSharedMemoryImageIO
+::ReadImageInformation()
+{
+  this->ReleaseMapping();
+
+  std::string name = GetSegmentName(m_FileName.c_str());
+  if (name.empty() || !IsSharedMemorySupported())
+    {
+    itkExceptionMacro("Invalid shared memory image name: " << m_FileName);
+    }
+#ifndef _WIN32
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0)
+    {
+    itkExceptionMacro("Failed to open shared memory image " << m_FileName << ": " << strerror(errno));
+    }
+  struct stat segmentStat;
+  if (fstat(fd, &segmentStat) != 0 || static_cast<size_t>(segmentStat.st_size) < sizeof(SharedMemoryImageHeader))
+    {
+    close(fd);
+    itkExceptionMacro("Invalid shared memory image " << m_FileName);
+    }
+  size_t segmentSize = static_cast<size_t>(segmentStat.st_size);
+  void* mapping = mmap(nullptr, segmentSize, PROT_READ, MAP_SHARED, fd, 0);
+  // the mapping remains valid after the descriptor is closed
+  close(fd);
+  if (mapping == MAP_FAILED)
+    {
+    itkExceptionMacro("Failed to map shared memory image " << m_FileName << ": " << strerror(errno));
+    }
+  this->m_Mapping = mapping;
+  this->m_MappingSize = segmentSize;
+#endif
+
+  const SharedMemoryImageHeader* header = static_cast<const SharedMemoryImageHeader*>(this->m_Mapping);
+  if (memcmp(header->Magic, SHARED_MEMORY_MAGIC, sizeof(SHARED_MEMORY_MAGIC)) != 0
+    || header->Version != SHARED_MEMORY_VERSION
+    || header->NumberOfDimensions < 1 || header->NumberOfDimensions > 3
+    || header->BufferOffset < sizeof(SharedMemoryImageHeader)
+    || header->BufferOffset + header->BufferSize > this->m_MappingSize)
+    {
+    this->ReleaseMapping();
+    itkExceptionMacro("Invalid shared memory image header in " << m_FileName);
+    }
+  this->m_BufferOffset = static_cast<size_t>(header->BufferOffset);
+
+  this->SetNumberOfDimensions(header->NumberOfDimensions);
+  for (unsigned int i = 0; i < header->NumberOfDimensions; ++i)
+    {
+    this->SetDimensions(i, static_cast<SizeValueType>(header->Dimensions[i]));
+    this->SetSpacing(i, header->Spacing[i]);
+    this->SetOrigin(i, header->Origin[i]);
+    std::vector<double> direction(header->NumberOfDimensions);
+    for (unsigned int j = 0; j < header->NumberOfDimensions; ++j)
+      {
+      direction[j] = header->Direction[3 * i + j];
+      }
+    this->SetDirection(i, direction);
+    }
+  this->SetNumberOfComponents(header->NumberOfComponents);
+  this->SetComponentType(static_cast<IOComponentType>(header->ComponentType));
+  this->SetPixelType(static_cast<IOPixelType>(header->PixelType));
+
+  if (header->BufferSize < this->GetImageSizeInBytes())
+    {
+    this->ReleaseMapping();
+    itkExceptionMacro("Shared memory image " << m_FileName << " is truncated");
+    }
+}
+
+//----------------------------------------------------------------------------
+void
+DMMLSharedMemoryImageIO
+::Read(void* buffer)
+{
+  if (!this->m_Mapping)
+    {
+    this->ReadImageInformation();
+    }
+  memcpy(buffer, this->GetSharedBuffer(), this->GetImageSizeInBytes());
+}
+
+//----------------------------------------------------------------------------
+const void*
+DMMLSharedMemoryImageIO
+::GetSharedBuffer() const
+{
+  if (!this->m_Mapping)
+    {
+    return nullptr;
+    }
+  return static_cast<const char*>(this->m_Mapping) + this->m_BufferOffset;
+}
+
+//----------------------------------------------------------------------------
+bool
+DMMLSharedMemoryImageIO
+::CanWriteFile(const char* filename)
+{
+  return IsSharedMemorySupported() && !GetSegmentName(filename).empty();
+}
+
+//----------------------------------------------------------------------------
+void
+DMMLSharedMemoryImageIO
+::WriteImageInformation()
+{
+}
+
+//----------------------------------------------------------------------------
+void
+DMMLSharedMemoryImageIO
+::Write(const void* buffer)
+{
+  std::string name = GetSegmentName(m_FileName.c_str());
+  if (name.empty() || !IsSharedMemorySupported())
+    {
+    itkExceptionMacro("Invalid shared memory image name: " << m_FileName);
+    }
+  if (this->GetNumberOfDimensions() < 1 || this->GetNumberOfDimensions() > 3)
+    {
+    itkExceptionMacro("Shared memory images must have 1 to 3 dimensions (Dimension = "
+                      << this->GetNumberOfDimensions() << ")");
+    }
+
+  SharedMemoryImageHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.Magic, SHARED_MEMORY_MAGIC, sizeof(SHARED_MEMORY_MAGIC));
+  header.Version = SHARED_MEMORY_VERSION;
+  header.NumberOfDimensions = this->GetNumberOfDimensions();
+  header.ComponentType = static_cast<int32_t>(this->GetComponentType());
+  header.PixelType = static_cast<int32_t>(this->GetPixelType());
+  header.NumberOfComponents = this->GetNumberOfComponents();
+  for (unsigned int i = 0; i < header.NumberOfDimensions; ++i)
+    {
+    header.Dimensions[i] = this->GetDimensions(i);
+    header.Spacing[i] = this->GetSpacing(i);
+    header.Origin[i] = this->GetOrigin(i);
+    std::vector<double> direction = this->GetDirection(i);
+    for (unsigned int j = 0; j < header.NumberOfDimensions && j < direction.size(); ++j)
+      {
+      header.Direction[3 * i + j] = direction[j];
+      }
+    }
+  header.BufferOffset = ((sizeof(SharedMemoryImageHeader) + SHARED_MEMORY_BUFFER_ALIGNMENT - 1)
+    / SHARED_MEMORY_BUFFER_ALIGNMENT) * SHARED_MEMORY_BUFFER_ALIGNMENT;
+  header.BufferSize = this->GetImageSizeInBytes();
+  size_t segmentSize = static_cast<size_t>(header.BufferOffset + header.BufferSize);
+
+#ifndef _WIN32
+  int fd = shm_open(name.c_str(), O_CREAT | O_RDWR | O_TRUNC, S_IRUSR | S_IWUSR);
+  if (fd < 0)
+    {
+    itkExceptionMacro("Failed to create shared memory image " << m_FileName << ": " << strerror(errno));
+    }
+  if (ftruncate(fd, static_cast<off_t>(segmentSize)) != 0)
+    {
+    int error = errno;
+    close(fd);
+    shm_unlink(name.c_str());
+    itkExceptionMacro("Failed to allocate " << segmentSize << " bytes of shared memory for "
+                      << m_FileName << ": " << strerror(error));
+    }
+  void* mapping = mmap(nullptr, segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+    {
+    int error = errno;
+    shm_unlink(name.c_str());
+    itkExceptionMacro("Failed to map shared memory image " << m_FileName << ": " << strerror(error));
+    }
+  memcpy(mapping, &header, sizeof(header));
+  memcpy(static_cast<char*>(mapping) + header.BufferOffset, buffer, static_cast<size_t>(header.BufferSize));
+  munmap(mapping, segmentSize);
+#else
+  (void)buffer;
+  (void)segmentSize;
+#endif
+}
+
+//----------------------------------------------------------------------------
+void
+DMMLSharedMemoryImageIO
+::CopyImageInformation(const ImageIOBase* source, ImageIOBase* target)
+{
+  if (!source || !target)
+    {
+    return;
+    }
+  unsigned int numberOfDimensions = source->GetNumberOfDimensions();
+  target->SetNumberOfDimensions(numberOfDimensions);
+  for (unsigned int i = 0; i < numberOfDimensions; ++i)
+    {
+    target->SetDimensions(i, source->GetDimensions(i));
+    target->SetSpacing(i, source->GetSpacing(i));
+    target->SetOrigin(i, source->GetOrigin(i));
+    target->SetDirection(i, source->GetDirection(i));
+    }
+  target->SetNumberOfComponents(source->GetNumberOfComponents());
+  target->SetComponentType(source->GetComponentType());
+  target->SetPixelType(source->GetPixelType());
+}
+
+//----------------------------------------------------------------------------
+void
+DMMLSharedMemoryImageIO
+::PrintSelf(std::ostream& os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Mapped: " << (this->m_Mapping ? "true" : "false") << std::endl;
+  os << indent << "MappingSize: " << this->m_MappingSize << std::endl;
+}
+
+} // end namespace itk
@@ -0,0 +1,125 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#ifndef itkDMMLSharedMemoryImageIO_h
+#define itkDMMLSharedMemoryImageIO_h
+
+#ifdef _MSC_VER
+#pragma warning ( disable : 4786 )
+#endif
+
+#include "itkDMMLSharedMemoryIOExport.h"
+
+#include "itkImageIOBase.h"
+
+namespace itk
+{
+/** \class DMMLSharedMemoryImageIO
+ * \brief ImageIO object for exchanging images through shared memory
+ *
+ * DMMLSharedMemoryImageIO reads and writes images stored in a named
+ * POSIX shared memory segment. It allows Cjyx and a command line
+ * module executed in a separate process to exchange image buffers
+ * without writing them to temporary files. Unlike DMMLIDImageIO, it
+ * only depends on ITK so that it can be loaded in command line
+ * modules.
+ *
+ * The segment starts with a fixed size header describing the pixel
+ * type and the image geometry (in LPS), followed by the pixel buffer.
+ * The segment is created by the writer and must be removed by the
+ * consumer using RemoveSharedMemory().
+ *
+ * The "filename" specified will look like a URI:
+ *     <code>cjyxshm:/\<segment name\></code>
+ *
+ * On platforms without POSIX shared memory, IsSharedMemorySupported()
+ * returns false and no file can be read or written.
+ */
+class DMMLSharedMemoryImageIO_EXPORT DMMLSharedMemoryImageIO : public ImageIOBase
+{
+public:
+  /** Standard class typedefs. */
+  typedef DMMLSharedMemoryImageIO  Self;
+  typedef ImageIOBase              Superclass;
+  typedef SmartPointer<Self>       Pointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(DMMLSharedMemoryImageIO, ImageIOBase);
+
+  /** Returns true if shared memory segments can be used on this platform. */
+  static bool IsSharedMemorySupported();
+
+  /** Scheme prefix of the filenames handled by this ImageIO ("cjyxshm:"). */
+  static const char* GetScheme();
+
+  /** Returns true if the filename refers to a shared memory segment. */
+  static bool IsSharedMemoryFileName(const char* filename);
+
+  /** Remove the shared memory segment referred by the filename.
+   * The memory is released once all the mappings are closed.
+   * Returns false if the segment did not exist. */
+  static bool RemoveSharedMemory(const char* filename);
+
+  /** Determine the file type. Returns true if this ImageIO can read the
+   * file specified. */
+  bool CanReadFile(const char*) override;
+
+  /** Set the spacing and dimension information for the set filename.
+   * The segment remains mapped until the object is destroyed or
+   * another segment is read. */
+  void ReadImageInformation() override;
+
+  /** Reads the data from shared memory into the memory buffer provided. */
+  void Read(void* buffer) override;
+
+  /** Pixel buffer of the segment mapped by ReadImageInformation().
+   * Allows consumers to copy the image directly from shared memory. */
+  const void* GetSharedBuffer() const;
+
+  /*-------- This part of the interfaces deals with writing data. ----- */
+
+  /** Determine the file type. Returns true if this ImageIO can write the
+   * file specified. */
+  bool CanWriteFile(const char*) override;
+
+  /** The header is written along with the data in Write(). */
+  void WriteImageInformation() override;
+
+  /** Create the shared memory segment and write the header and the
+   * data from the memory buffer provided. Make sure that the IORegion
+   * has been set properly. */
+  void Write(const void* buffer) override;
+
+  /** Copy pixel type, dimensions and geometry between ImageIOs.
+   * Used for exchanging images with DMMLIDImageIO without an intermediate
+   * itk::Image. */
+  static void CopyImageInformation(const ImageIOBase* source, ImageIOBase* target);
+
+protected:
+  DMMLSharedMemoryImageIO();
+  ~DMMLSharedMemoryImageIO() override;
+  void PrintSelf(std::ostream& os, Indent indent) const override;
+
+  /** Unmap the segment mapped by ReadImageInformation(). */
+  void ReleaseMapping();
+
+private:
+  DMMLSharedMemoryImageIO(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+  void* m_Mapping;
+  size_t m_MappingSize;
+  size_t m_BufferOffset;
+};
+
+} /// end namespace itk
+#endif /// itkDMMLSharedMemoryImageIO_h
@@ -0,0 +1,46 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkDMMLSharedMemoryImageIOFactory.h"
+#include "itkVersion.h"
+
+
+namespace itk
+{
+DMMLSharedMemoryImageIOFactory::DMMLSharedMemoryImageIOFactory()
+{
+  this->RegisterOverride("itkImageIOBase",
+                         "itkDMMLSharedMemoryImageIO",
+                         "ImageIO to exchange images through shared memory.",
+                         true,
+                         CreateObjectFunction<DMMLSharedMemoryImageIO>::New());
+}
+
+DMMLSharedMemoryImageIOFactory::~DMMLSharedMemoryImageIOFactory() = default;
+
+const char* DMMLSharedMemoryImageIOFactory::GetITKSourceVersion() const
+{
+  return ITK_SOURCE_VERSION;
+}
+
+const char*
+DMMLSharedMemoryImageIOFactory::GetDescription() const
+{
+  return "ImageIOFactory that imports/exports data through shared memory.";
+}
+
+} // end namespace itk
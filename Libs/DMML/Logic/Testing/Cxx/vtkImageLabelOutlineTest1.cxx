@@ -0,0 +1,111 @@
+/*==============================================================================
+
+  Program: 3D Cjyx
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// DMMLLogic includes
+#include "vtkImageLabelOutline.h"
+
+// DMML includes
+#include "vtkDMMLCoreTestingMacros.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <cstring>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Create a labelmap of rectangular regions with a few isolated voxels
+vtkSmartPointer<vtkImageData> CreateLabelImage(int scalarType, int sizeX, int sizeY, int sizeZ)
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(sizeX, sizeY, sizeZ);
+  image->AllocateScalars(scalarType, 1);
+  for (int k = 0; k < sizeZ; ++k)
+    {
+    for (int j = 0; j < sizeY; ++j)
+      {
+      for (int i = 0; i < sizeX; ++i)
+        {
+        int label = ((i / 37) + (j / 23) + k) % 5;
+        if ((i * 7 + j * 13) % 101 == 0)
+          {
+          label = 6;
+          }
+        image->SetScalarComponentFromDouble(i, j, k, 0, label);
+        }
+      }
+    }
+  return image;
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkImageData> ComputeOutline(vtkImageData* image, int outline, bool useRowKernel, double& elapsedTime)
+{
+  vtkNew<vtkImageLabelOutline> filter;
+  filter->SetInputData(image);
+  filter->SetOutline(outline);
+  filter->SetUseRowKernel(useRowKernel);
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  filter->Update();
+  timer->StopTimer();
+  elapsedTime = timer->GetElapsedTime();
+  vtkSmartPointer<vtkImageData> output = filter->GetOutput();
+  return output;
+}
+
+//----------------------------------------------------------------------------
+int CompareOutlines(int scalarType, int sizeX, int sizeY, int sizeZ, int outline)
+{
+  vtkSmartPointer<vtkImageData> image = CreateLabelImage(scalarType, sizeX, sizeY, sizeZ);
+  double neighborhoodTime = 0.0;
+  vtkSmartPointer<vtkImageData> expected = ComputeOutline(image, outline, false, neighborhoodTime);
+  double rowTime = 0.0;
+  vtkSmartPointer<vtkImageData> actual = ComputeOutline(image, outline, true, rowTime);
+  std::cout << image->GetScalarTypeAsString() << " " << sizeX << "x" << sizeY << "x" << sizeZ
+    << " outline " << outline << ": neighborhood " << neighborhoodTime << " s, row kernel " << rowTime << " s" << std::endl;
+
+  CHECK_INT(actual->GetScalarType(), scalarType);
+  CHECK_INT(actual->GetNumberOfPoints(), expected->GetNumberOfPoints());
+  size_t size = static_cast<size_t>(expected->GetNumberOfPoints()) * expected->GetScalarSize();
+  CHECK_INT(memcmp(actual->GetScalarPointer(), expected->GetScalarPointer(), size), 0);
+
+  // Interior of labels is set to background and voxels at the image boundary are on the outline
+  CHECK_DOUBLE(actual->GetScalarComponentAsDouble(18, 11, 0, 0), 0.0);
+  CHECK_DOUBLE(actual->GetScalarComponentAsDouble(18, 34, 0, 0), 0.0);
+  CHECK_DOUBLE(actual->GetScalarComponentAsDouble(37, 11, 0, 0), 1.0);
+  CHECK_DOUBLE(actual->GetScalarComponentAsDouble(40, 0, 0, 0), 1.0);
+  CHECK_DOUBLE(actual->GetScalarComponentAsDouble(0, 0, 0, 0), 6.0);
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkImageLabelOutlineTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  CHECK_EXIT_SUCCESS(CompareOutlines(VTK_UNSIGNED_CHAR, 211, 97, 1, 1));
+  CHECK_EXIT_SUCCESS(CompareOutlines(VTK_SHORT, 64, 48, 5, 2));
+  CHECK_EXIT_SUCCESS(CompareOutlines(VTK_FLOAT, 50, 40, 1, 3));
+  // 4K slice, as displayed in a full-screen slice view
+  CHECK_EXIT_SUCCESS(CompareOutlines(VTK_SHORT, 3840, 2160, 1, 1));
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,255 @@
+/*==============================================================================
+
+  Program: 3D Cjyx
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// DMMLLogic includes
+#include "vtkImageLayerBlend.h"
+
+// DMML includes
+#include "vtkDMMLCoreTestingMacros.h"
+#include "vtkTestingOutputWindow.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageAppendComponents.h>
+#include <vtkImageBlend.h>
+#include <vtkImageCast.h>
+#include <vtkImageData.h>
+#include <vtkImageExtractComponents.h>
+#include <vtkImageMathematics.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkImageData> CreateLayerImage(int width, int height, int seed)
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(width, height, 1);
+  image->AllocateScalars(VTK_UNSIGNED_CHAR, 4);
+  unsigned char* ptr = static_cast<unsigned char*>(image->GetScalarPointer());
+  for (int y = 0; y < height; ++y)
+    {
+    for (int x = 0; x < width; ++x, ptr += 4)
+      {
+      ptr[0] = static_cast<unsigned char>((x * seed + y) & 0xff);
+      ptr[1] = static_cast<unsigned char>((y * seed + x * 3) & 0xff);
+      ptr[2] = static_cast<unsigned char>((x ^ y) * seed & 0xff);
+      // mix of transparent, opaque and semi-transparent pixels, as in slice layers
+      int alphaSelector = (x / 16 + y / 16 + seed) % 3;
+      ptr[3] = static_cast<unsigned char>(alphaSelector == 0 ? 0 : (alphaSelector == 1 ? 255 : (x + y) & 0xff));
+      }
+    }
+  return image;
+}
+
+//----------------------------------------------------------------------------
+// Returns the largest difference between corresponding voxel values, or -1 if the images are not comparable
+int MaximumDifference(vtkImageData* image1, vtkImageData* image2)
+{
+  if (!image1 || !image2
+    || image1->GetNumberOfScalarComponents() != image2->GetNumberOfScalarComponents()
+    || image1->GetNumberOfPoints() != image2->GetNumberOfPoints())
+    {
+    std::cerr << "Images cannot be compared" << std::endl;
+    return -1;
+    }
+  vtkIdType numberOfValues = image1->GetNumberOfPoints() * image1->GetNumberOfScalarComponents();
+  const unsigned char* ptr1 = static_cast<unsigned char*>(image1->GetScalarPointer());
+  const unsigned char* ptr2 = static_cast<unsigned char*>(image2->GetScalarPointer());
+  int maximumDifference = 0;
+  for (vtkIdType i = 0; i < numberOfValues; ++i)
+    {
+    maximumDifference = std::max(maximumDifference, std::abs(ptr1[i] - ptr2[i]));
+    }
+  return maximumDifference;
+}
+
+//----------------------------------------------------------------------------
+// Blending pipeline that was used in vtkDMMLSliceLogic before vtkImageLayerBlend
+struct ReferenceBlendPipeline
+{
+  ReferenceBlendPipeline(vtkImageData* background, vtkImageData* foreground, vtkImageData* label,
+    bool addSubtract, bool subtract, double foregroundOpacity, double labelOpacity)
+  {
+    if (addSubtract)
+      {
+      this->ForegroundCast->SetOutputScalarTypeToShort();
+      this->BackgroundCast->SetOutputScalarTypeToShort();
+      this->ForegroundCast->SetInputData(foreground);
+      this->BackgroundCast->SetInputData(background);
+      if (subtract)
+        {
+        this->Math->SetOperationToSubtract();
+        }
+      else
+        {
+        this->Math->SetOperationToAdd();
+        }
+      this->Math->SetInputConnection(0, this->BackgroundCast->GetOutputPort());
+      this->Math->SetInputConnection(1, this->ForegroundCast->GetOutputPort());
+      this->OutputCast->SetInputConnection(this->Math->GetOutputPort());
+      this->OutputCast->SetOutputScalarTypeToUnsignedChar();
+      this->OutputCast->ClampOverflowOn();
+      this->ExtractRGB->SetInputConnection(this->OutputCast->GetOutputPort());
+      this->ExtractRGB->SetComponents(0, 1, 2);
+      this->ExtractAlpha->SetInputData(background);
+      this->ExtractAlpha->SetComponents(3);
+      this->AppendRGBA->AddInputConnection(this->ExtractRGB->GetOutputPort());
+      this->AppendRGBA->AddInputConnection(this->ExtractAlpha->GetOutputPort());
+      this->Blend->AddInputConnection(this->AppendRGBA->GetOutputPort());
+      this->Blend->SetOpacity(0, 1.0);
+      this->Blend->AddInputData(label);
+      this->Blend->SetOpacity(1, labelOpacity);
+      }
+    else
+      {
+      this->Blend->AddInputData(background);
+      this->Blend->AddInputData(foreground);
+      this->Blend->AddInputData(label);
+      this->Blend->SetOpacity(0, 1.0);
+      this->Blend->SetOpacity(1, foregroundOpacity);
+      this->Blend->SetOpacity(2, labelOpacity);
+      }
+  }
+
+  vtkNew<vtkImageCast> ForegroundCast;
+  vtkNew<vtkImageCast> BackgroundCast;
+  vtkNew<vtkImageMathematics> Math;
+  vtkNew<vtkImageCast> OutputCast;
+  vtkNew<vtkImageExtractComponents> ExtractRGB;
+  vtkNew<vtkImageExtractComponents> ExtractAlpha;
+  vtkNew<vtkImageAppendComponents> AppendRGBA;
+  vtkNew<vtkImageBlend> Blend;
+};
+
+//----------------------------------------------------------------------------
+// Returns average time of a slice render, forcing re-execution of the whole pipeline
+double MeasureRenderTime(vtkAlgorithm* blend, vtkImageData* background, vtkImageData* foreground, int numberOfRepeats)
+{
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  for (int i = 0; i < numberOfRepeats; ++i)
+    {
+    background->Modified();
+    foreground->Modified();
+    blend->Update();
+    }
+  timer->StopTimer();
+  return timer->GetElapsedTime() / numberOfRepeats;
+}
+
+//----------------------------------------------------------------------------
+int TestCompositing(int width, int height, int compositing, int numberOfRepeats)
+{
+  const double foregroundOpacity = 0.6;
+  const double labelOpacity = 0.8;
+  vtkSmartPointer<vtkImageData> background = CreateLayerImage(width, height, 1);
+  vtkSmartPointer<vtkImageData> foreground = CreateLayerImage(width, height, 7);
+  vtkSmartPointer<vtkImageData> label = CreateLayerImage(width, height, 13);
+
+  bool addSubtract = (compositing != vtkImageLayerBlend::BlendModeAlpha);
+  ReferenceBlendPipeline reference(background, foreground, label,
+    addSubtract, compositing == vtkImageLayerBlend::BlendModeSubtract, foregroundOpacity, labelOpacity);
+
+  vtkNew<vtkImageLayerBlend> layerBlend;
+  layerBlend->AddInputData(background);
+  layerBlend->AddInputData(foreground);
+  layerBlend->AddInputData(label);
+  layerBlend->SetOpacity(1, addSubtract ? 1.0 : foregroundOpacity);
+  layerBlend->SetBlendMode(1, compositing);
+  layerBlend->SetOpacity(2, labelOpacity);
+
+  reference.Blend->Update();
+  layerBlend->Update();
+  CHECK_INT(layerBlend->GetOutput()->GetNumberOfScalarComponents(), 4);
+  // Alpha blending results may differ due to rounding
+  int maximumDifference = MaximumDifference(reference.Blend->GetOutput(), layerBlend->GetOutput());
+  CHECK_BOOL(maximumDifference >= 0 && maximumDifference <= 3, true);
+
+  double referenceTime = MeasureRenderTime(reference.Blend, background, foreground, numberOfRepeats);
+  double layerBlendTime = MeasureRenderTime(layerBlend, background, foreground, numberOfRepeats);
+  std::cout << vtkImageLayerBlend::GetBlendModeAsString(compositing) << " compositing of "
+    << width << "x" << height << " slice layers: vtkImageBlend pipeline " << referenceTime * 1000.0 << " ms, "
+    << "vtkImageLayerBlend " << layerBlendTime * 1000.0 << " ms" << std::endl;
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestInputTypes()
+{
+  // Luminance background, RGB foreground: the output has the components of the first input
+  vtkNew<vtkImageData> background;
+  background->SetDimensions(4, 3, 1);
+  background->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  background->GetPointData()->GetScalars()->Fill(100);
+  vtkNew<vtkImageData> foreground;
+  foreground->SetDimensions(4, 3, 1);
+  foreground->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+  foreground->GetPointData()->GetScalars()->Fill(200);
+
+  vtkNew<vtkImageLayerBlend> layerBlend;
+  layerBlend->AddInputData(background);
+  layerBlend->AddInputData(foreground);
+  layerBlend->SetOpacity(1, 0.5);
+  layerBlend->Update();
+  CHECK_INT(layerBlend->GetOutput()->GetNumberOfScalarComponents(), 1);
+  CHECK_INT(static_cast<int>(layerBlend->GetOutput()->GetScalarComponentAsDouble(1, 1, 0, 0)), 150);
+
+  layerBlend->SetBlendMode(1, vtkImageLayerBlend::BlendModeAdd);
+  layerBlend->SetOpacity(1, 1.0);
+  layerBlend->Update();
+  CHECK_INT(static_cast<int>(layerBlend->GetOutput()->GetScalarComponentAsDouble(1, 1, 0, 0)), 255);
+
+  // Only unsigned char inputs are supported
+  vtkNew<vtkImageData> floatImage;
+  floatImage->SetDimensions(4, 3, 1);
+  floatImage->AllocateScalars(VTK_FLOAT, 1);
+  vtkNew<vtkImageLayerBlend> invalidBlend;
+  invalidBlend->AddInputData(floatImage);
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  invalidBlend->Update();
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkImageLayerBlendTest1(int argc, char* argv[])
+{
+  // Viewport size can be specified for benchmarking, default is 4K
+  int width = 3840;
+  int height = 2160;
+  if (argc > 2)
+    {
+    width = atoi(argv[1]);
+    height = atoi(argv[2]);
+    }
+  const int numberOfRepeats = 5;
+  CHECK_EXIT_SUCCESS(TestCompositing(width, height, vtkImageLayerBlend::BlendModeAlpha, numberOfRepeats));
+  CHECK_EXIT_SUCCESS(TestCompositing(width, height, vtkImageLayerBlend::BlendModeAdd, numberOfRepeats));
+  CHECK_EXIT_SUCCESS(TestCompositing(width, height, vtkImageLayerBlend::BlendModeSubtract, numberOfRepeats));
+  CHECK_EXIT_SUCCESS(TestInputTypes());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,179 @@
+/*==============================================================================
+
+  Program: 3D Cjyx
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// DMMLLogic includes
+#include "vtkImagePyramid.h"
+
+// DMML includes
+#include "vtkDMMLCoreTestingMacros.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <cmath>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Create an image where each voxel value is the physical x coordinate of the voxel
+vtkSmartPointer<vtkImageData> CreateGradientImage(int scalarType)
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(64, 32, 16);
+  image->SetSpacing(1.0, 2.0, 3.0);
+  image->SetOrigin(0.0, 10.0, 20.0);
+  image->AllocateScalars(scalarType, 1);
+  for (int k = 0; k < 16; ++k)
+    {
+    for (int j = 0; j < 32; ++j)
+      {
+      for (int i = 0; i < 64; ++i)
+        {
+        image->SetScalarComponentFromDouble(i, j, k, 0, i);
+        }
+      }
+    }
+  return image;
+}
+
+//----------------------------------------------------------------------------
+// Returns true if voxel values match the physical x coordinate of the voxels
+bool IsValueMatchingPosition(vtkImageData* image)
+{
+  int dimensions[3] = { 0, 0, 0 };
+  image->GetDimensions(dimensions);
+  for (int i = 0; i < dimensions[0]; ++i)
+    {
+    double position[3] = { 0.0, 0.0, 0.0 };
+    int ijk[3] = { i, dimensions[1] / 2, dimensions[2] / 2 };
+    image->TransformIndexToPhysicalPoint(ijk, position);
+    double value = image->GetScalarComponentAsDouble(ijk[0], ijk[1], ijk[2], 0);
+    if (std::fabs(value - position[0]) > 1e-3)
+      {
+      std::cerr << "Value mismatch at i=" << i << ": " << value << " != " << position[0] << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int TestLevels()
+{
+  vtkSmartPointer<vtkImageData> image = CreateGradientImage(VTK_FLOAT);
+  vtkNew<vtkImagePyramid> pyramid;
+  pyramid->SetInputImage(image);
+
+  // 64x32x16 can be halved until the longest axis has 2 voxels
+  CHECK_INT(pyramid->GetNumberOfLevels(), 6);
+  CHECK_POINTER(pyramid->GetLevel(0), image.GetPointer());
+
+  vtkImageData* level2 = pyramid->GetLevel(2);
+  CHECK_NOT_NULL(level2);
+  int dimensions[3] = { 0, 0, 0 };
+  level2->GetDimensions(dimensions);
+  CHECK_INT(dimensions[0], 16);
+  CHECK_INT(dimensions[1], 8);
+  CHECK_INT(dimensions[2], 4);
+  CHECK_DOUBLE(level2->GetSpacing()[0], 4.0);
+  CHECK_DOUBLE(level2->GetSpacing()[1], 8.0);
+  CHECK_DOUBLE(level2->GetSpacing()[2], 12.0);
+  for (int level = 0; level < pyramid->GetNumberOfLevels(); ++level)
+    {
+    CHECK_BOOL(IsValueMatchingPosition(pyramid->GetLevel(level)), true);
+    }
+
+  // Levels are cached
+  CHECK_POINTER(pyramid->GetLevel(2), level2);
+
+  // Requesting a level that is not available returns the coarsest level
+  CHECK_POINTER(pyramid->GetLevel(100), pyramid->GetLevel(pyramid->GetNumberOfLevels() - 1));
+  CHECK_POINTER(pyramid->GetLevel(-1), image.GetPointer());
+
+  pyramid->SetMaximumNumberOfLevels(3);
+  CHECK_INT(pyramid->GetNumberOfLevels(), 3);
+  pyramid->SetMaximumNumberOfLevels(8);
+
+  // Levels are regenerated when the input changes
+  vtkSmartPointer<vtkImageData> level2Before = level2;
+  image->SetScalarComponentFromDouble(0, 0, 0, 0, 100.0);
+  image->Modified();
+  CHECK_POINTER_DIFFERENT(pyramid->GetLevel(2), level2Before.GetPointer());
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestLabelLevels()
+{
+  vtkSmartPointer<vtkImageData> labelmap = CreateGradientImage(VTK_SHORT);
+  vtkNew<vtkImagePyramid> pyramid;
+  pyramid->SetInputImage(labelmap);
+  pyramid->AveragingOff();
+
+  // Subsampling keeps the original voxel values and positions
+  vtkImageData* level1 = pyramid->GetLevel(1);
+  CHECK_NOT_NULL(level1);
+  CHECK_DOUBLE(level1->GetOrigin()[0], 0.0);
+  CHECK_DOUBLE(level1->GetSpacing()[0], 2.0);
+  CHECK_BOOL(IsValueMatchingPosition(level1), true);
+  CHECK_BOOL(IsValueMatchingPosition(pyramid->GetLevel(3)), true);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestSharedPyramid()
+{
+  vtkSmartPointer<vtkImageData> image = CreateGradientImage(VTK_FLOAT);
+  vtkImagePyramid* pyramid = vtkImagePyramid::GetImagePyramid(image);
+  CHECK_NOT_NULL(pyramid);
+  CHECK_POINTER(pyramid->GetInputImage(), image.GetPointer());
+  CHECK_POINTER(vtkImagePyramid::GetImagePyramid(image), pyramid);
+
+  vtkSmartPointer<vtkImageData> otherImage = CreateGradientImage(VTK_FLOAT);
+  CHECK_POINTER_DIFFERENT(vtkImagePyramid::GetImagePyramid(otherImage), pyramid);
+  CHECK_NULL(vtkImagePyramid::GetImagePyramid(nullptr));
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestLevelForVoxelsPerPixel()
+{
+  CHECK_INT(vtkImagePyramid::GetLevelForVoxelsPerPixel(0.0), 0);
+  CHECK_INT(vtkImagePyramid::GetLevelForVoxelsPerPixel(0.5), 0);
+  CHECK_INT(vtkImagePyramid::GetLevelForVoxelsPerPixel(1.9), 0);
+  CHECK_INT(vtkImagePyramid::GetLevelForVoxelsPerPixel(2.0), 1);
+  CHECK_INT(vtkImagePyramid::GetLevelForVoxelsPerPixel(3.9), 1);
+  CHECK_INT(vtkImagePyramid::GetLevelForVoxelsPerPixel(8.5), 3);
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkImagePyramidTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  CHECK_EXIT_SUCCESS(TestLevels());
+  CHECK_EXIT_SUCCESS(TestLabelLevels());
+  CHECK_EXIT_SUCCESS(TestSharedPyramid());
+  CHECK_EXIT_SUCCESS(TestLevelForVoxelsPerPixel());
+  return EXIT_SUCCESS;
+}
@@ -47,9 +47,11 @@
 
 //
 #include "vtkImageLabelOutline.h"
+#include "vtkImagePyramid.h"
 
 // STD includes
 #include <algorithm>
+#include <cmath>
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkDMMLSliceLayerLogic);
@@ -149,6 +151,11 @@ vtkDMMLSliceLayerLogic::vtkDMMLSliceLayerLogic()
   this->UpdatingTransforms = 0;
 
   this->InterpolationMode = VTK_RESLICE_LINEAR;
+
+  this->UseImagePyramid = true;
+  this->Interacting = false;
+  this->ImagePyramidLevel = 0;
+  this->ResliceVoxelsPerPixel = 0.0;
 }
 
 //----------------------------------------------------------------------------
@@ -545,10 +552,21 @@ void vtkDMMLSliceLayerLogic::UpdateTransforms()
       {
       SnapToPermuteMatrix(linearXYToIJKTransform);
       this->Reslice->SetResliceTransform(linearXYToIJKTransform);
+      // Length of the screen x and y axes in voxels determines the image pyramid level
+      vtkMatrix4x4* xyToIJKMatrix = linearXYToIJKTransform->GetMatrix();
+      double voxelsPerPixel[2] = { 0.0, 0.0 };
+      for (int c = 0; c < 2; c++)
+        {
+        voxelsPerPixel[c] = sqrt(xyToIJKMatrix->Element[0][c] * xyToIJKMatrix->Element[0][c]
+          + xyToIJKMatrix->Element[1][c] * xyToIJKMatrix->Element[1][c]
+          + xyToIJKMatrix->Element[2][c] * xyToIJKMatrix->Element[2][c]);
+        }
+      this->ResliceVoxelsPerPixel = std::min(voxelsPerPixel[0], voxelsPerPixel[1]);
       }
     else
       {
       this->Reslice->SetResliceTransform(this->XYToIJKTransform);
+      this->ResliceVoxelsPerPixel = 0.0;
       }
     vtkSmartPointer<vtkTransform> linearUVWToIJKTransform = vtkSmartPointer<vtkTransform>::New();
     if (vtkDMMLTransformNode::IsGeneralTransformLinear(this->UVWToIJKTransform, linearUVWToIJKTransform))
@@ -589,6 +607,9 @@ void vtkDMMLSliceLayerLogic::UpdateTransforms()
                                      0, dimensionsUVW[1]-1,
                                      0, dimensionsUVW[2]-1);
 
+  // Zoom factor may have changed, which may require a different resolution level
+  this->UpdateResliceInput();
+
   this->UpdatingTransforms = 0;
 
   //if (transformModified || transformModifiedUVW)
@@ -762,7 +783,7 @@ void vtkDMMLSliceLayerLogic::UpdateImageDisplay()
 //      {
 //      volumeNode->GetImageData()->Print(std::cout);
 //      }
-    this->Reslice->SetInputData(volumeNode->GetImageData());
+    this->UpdateResliceInput();
     this->ResliceUVW->SetInputData(volumeNode->GetImageData());
     // use the label outline if we have a label map volume, this is the label
     // layer (turned on in slice logic when the label layer is instantiated)
@@ -825,6 +846,66 @@ void vtkDMMLSliceLayerLogic::UpdateImageDisplay()
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkDMMLSliceLayerLogic::UpdateResliceInput()
+{
+  if (!this->VolumeNode || this->VolumeNode->IsA("vtkDMMLDiffusionTensorVolumeNode"))
+    {
+    // tensor volumes are resliced through the attribute assignment filters
+    return;
+    }
+  vtkImageData* imageData = this->VolumeNode->GetImageData();
+  vtkImageData* resliceInput = imageData;
+  int level = 0;
+  if (imageData && this->UseImagePyramid && this->Interacting)
+    {
+    level = vtkImagePyramid::GetLevelForVoxelsPerPixel(this->ResliceVoxelsPerPixel);
+    if (level > 0)
+      {
+      // The pyramid is stored in the image, so it is shared between all views
+      vtkImagePyramid* pyramid = vtkImagePyramid::GetImagePyramid(imageData);
+      // Label values must not be averaged
+      pyramid->SetAveraging(vtkDMMLLabelMapVolumeDisplayNode::SafeDownCast(this->VolumeDisplayNode) == nullptr);
+      level = std::min(level, pyramid->GetNumberOfLevels() - 1);
+      resliceInput = pyramid->GetLevel(level);
+      }
+    }
+  this->ImagePyramidLevel = level;
+  if (this->Reslice->GetInput() != resliceInput)
+    {
+    this->Reslice->SetInputData(resliceInput);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkDMMLSliceLayerLogic::SetInteracting(bool interacting)
+{
+  if (this->Interacting == interacting)
+    {
+    return;
+    }
+  this->Interacting = interacting;
+  vtkMTimeType oldReSliceMTime = this->Reslice->GetMTime();
+  this->UpdateResliceInput();
+  if (oldReSliceMTime != this->Reslice->GetMTime())
+    {
+    // Reslice input changed (e.g., full resolution is needed after interaction ended)
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkDMMLSliceLayerLogic::SetUseImagePyramid(bool use)
+{
+  if (this->UseImagePyramid == use)
+    {
+    return;
+    }
+  this->UseImagePyramid = use;
+  this->UpdateResliceInput();
+  this->Modified();
+}
+
 //----------------------------------------------------------------------------
 vtkAlgorithmOutput* vtkDMMLSliceLayerLogic::GetSliceImageDataConnection()
 {
@@ -998,6 +1079,10 @@ void vtkDMMLSliceLayerLogic::PrintSelf(ostream& os, vtkIndent indent)
     os << indent << " (0)\n";
     }
 
+  os << indent << "UseImagePyramid: " << (this->UseImagePyramid ? "true" : "false") << "\n";
+  os << indent << "Interacting: " << (this->Interacting ? "true" : "false") << "\n";
+  os << indent << "ImagePyramidLevel: " << this->ImagePyramidLevel << "\n";
+
   os << indent << "IsLabelLayer: " << this->GetIsLabelLayer() << "\n";
   os << indent << "LabelOutline:\n";
   if (this->LabelOutline)
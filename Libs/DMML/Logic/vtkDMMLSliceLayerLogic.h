@@ -135,6 +135,23 @@ public:
   vtkGetMacro(InterpolationMode, int);
   vtkSetMacro(InterpolationMode, int);
 
+  ///
+  /// Use downsampled versions of the volume (see vtkImagePyramid) for reslicing
+  /// while the view is interacted with, if a screen pixel covers multiple voxels.
+  /// The full resolution volume is used when the interaction ends. Enabled by default.
+  void SetUseImagePyramid(bool use);
+  vtkGetMacro(UseImagePyramid, bool);
+  vtkBooleanMacro(UseImagePyramid, bool);
+
+  ///
+  /// Set by the slice logic while the slice view is interacted with (panned, zoomed, etc.).
+  void SetInteracting(bool interacting);
+  vtkGetMacro(Interacting, bool);
+
+  ///
+  /// Image pyramid level that is currently resliced (0 = full resolution).
+  vtkGetMacro(ImagePyramidLevel, int);
+
 protected:
   vtkDMMLSliceLayerLogic();
   ~vtkDMMLSliceLayerLogic() override;
@@ -161,6 +178,11 @@ protected:
   // Copy VolumeDisplayNodeObserved into VolumeDisplayNode
   void UpdateVolumeDisplayNode();
 
+  ///
+  /// Set full resolution or downsampled volume as input of Reslice
+  /// (not used for tensor volumes)
+  void UpdateResliceInput();
+
   ///
   /// the DMML Nodes that define this Logic's parameters
   vtkDMMLVolumeNode *VolumeNode;
@@ -189,6 +211,12 @@ protected:
   int UpdatingTransforms;
 
   int InterpolationMode;
+
+  bool UseImagePyramid;
+  bool Interacting;
+  int ImagePyramidLevel;
+  /// Number of voxels covered by a screen pixel at full resolution (0 if unknown)
+  double ResliceVoxelsPerPixel;
 };
 
 #endif
@@ -16,6 +16,7 @@
 #include "vtkDMMLApplicationLogic.h"
 #include "vtkDMMLSliceLogic.h"
 #include "vtkDMMLSliceLayerLogic.h"
+#include "vtkImageLayerBlend.h"
 
 // DMML includes
 #include <vtkEventBroker.h>
@@ -35,12 +36,8 @@
 #include <vtkCallbackCommand.h>
 #include <vtkCollection.h>
 #include <vtkGeneralTransform.h>
-#include <vtkImageAppendComponents.h>
-#include <vtkImageBlend.h>
 #include <vtkImageResample.h>
-#include <vtkImageCast.h>
 #include <vtkImageData.h>
-#include <vtkImageMathematics.h>
 #include <vtkImageReslice.h>
 #include <vtkImageThreshold.h>
 #include <vtkInformation.h>
@@ -69,62 +66,40 @@ const std::string vtkDMMLSliceLogic::SLICE_MODEL_NODE_NAME_SUFFIX = std::string(
 //----------------------------------------------------------------------------
 struct SliceLayerInfo
   {
-  SliceLayerInfo(vtkAlgorithmOutput* blendInput, double opacity)
+  SliceLayerInfo(vtkAlgorithmOutput* blendInput, double opacity, int blendMode = vtkImageLayerBlend::BlendModeAlpha)
     {
     this->BlendInput = blendInput;
     this->Opacity = opacity;
+    this->BlendMode = blendMode;
     }
   vtkSmartPointer<vtkAlgorithmOutput> BlendInput;
   double Opacity;
+  int BlendMode;
   };
 
 //----------------------------------------------------------------------------
 struct BlendPipeline
 {
-  BlendPipeline()
-  {
-    /*
-    // AlphaBlending, ReverseAlphaBlending:
-    //
-    //   foreground \
-    //               > Blend
-    //   background /
-    //
-    // Add, Subtract:
-    //
-    //   Casting is needed to avoid overflow during adding (or subtracting).
-    //
-    //   AddSubMath adds/subtracts alpha channel, therefore we copy RGB and alpha
-    //   components and copy of the background's alpha channel to the output.
-    //   Splitting and appending channels is probably quite inefficient, but there does not
-    //   seem to be simpler pipeline to do this in VTK.
-    //
-    //   foreground > AddSubForegroundCast \
-    //                                      > AddSubMath > AddSubOutputCast ...
-    //   background > AddSubBackroundCast  /
-    //
-    //
-    //     ... AddSubOutputCast > AddSubExtractRGB \
-    //                                              > AddSubAppendRGBA > Blend
-    //             background > AddSubExtractAlpha /
-    */
-
-    this->AddSubForegroundCast->SetOutputScalarTypeToShort();
-    this->AddSubBackgroundCast->SetOutputScalarTypeToShort();
-    this->AddSubMath->SetOperationToAdd();
-    this->AddSubMath->SetInputConnection(0, this->AddSubBackgroundCast->GetOutputPort());
-    this->AddSubMath->SetInputConnection(1, this->AddSubForegroundCast->GetOutputPort());
-    this->AddSubOutputCast->SetInputConnection(this->AddSubMath->GetOutputPort());
-
-    this->AddSubExtractRGB->SetInputConnection(this->AddSubOutputCast->GetOutputPort());
-    this->AddSubExtractRGB->SetComponents(0, 1, 2);
-    this->AddSubExtractAlpha->SetComponents(3);
-    this->AddSubAppendRGBA->AddInputConnection(this->AddSubExtractRGB->GetOutputPort());
-    this->AddSubAppendRGBA->AddInputConnection(this->AddSubExtractAlpha->GetOutputPort());
-
-    this->AddSubOutputCast->SetOutputScalarTypeToUnsignedChar();
-    this->AddSubOutputCast->ClampOverflowOn();
-  }
+  /*
+  // All layers are composited by a single filter, in one pass:
+  //
+  // AlphaBlending, ReverseAlphaBlending:
+  //
+  //   foreground (alpha) \
+  //                       > Blend
+  //   background (alpha) /
+  //
+  // Add, Subtract:
+  //
+  //   The foreground is added to (subtracted from) the background RGB channels
+  //   with clamping, the alpha channel of the background is kept.
+  //
+  //   background (alpha)             \
+  //                                   > Blend
+  //   foreground (add or subtract)   /
+  //
+  // The label layer is always alpha blended on top.
+  */
 
   void AddLayers(std::deque<SliceLayerInfo>& layers, int sliceCompositing,
     vtkAlgorithmOutput* backgroundImagePort,
@@ -164,18 +139,9 @@ struct BlendPipeline
       }
     else
       {
-      this->AddSubForegroundCast->SetInputConnection(foregroundImagePort);
-      this->AddSubBackgroundCast->SetInputConnection(backgroundImagePort);
-      this->AddSubExtractAlpha->SetInputConnection(backgroundImagePort);
-      if (sliceCompositing == vtkDMMLSliceCompositeNode::Add)
-        {
-        this->AddSubMath->SetOperationToAdd();
-        }
-      else
-        {
-        this->AddSubMath->SetOperationToSubtract();
-        }
-      layers.emplace_back(this->AddSubAppendRGBA->GetOutputPort(), 1.0);
+      layers.emplace_back(backgroundImagePort, 1.0);
+      layers.emplace_back(foregroundImagePort, 1.0,
+        sliceCompositing == vtkDMMLSliceCompositeNode::Add ? vtkImageLayerBlend::BlendModeAdd : vtkImageLayerBlend::BlendModeSubtract);
       }
 
     // always blending the label layer
@@ -185,14 +151,7 @@ struct BlendPipeline
       }
   }
 
-  vtkNew<vtkImageCast> AddSubForegroundCast;
-  vtkNew<vtkImageCast> AddSubBackgroundCast;
-  vtkNew<vtkImageMathematics> AddSubMath;
-  vtkNew<vtkImageExtractComponents> AddSubExtractRGB;
-  vtkNew<vtkImageExtractComponents> AddSubExtractAlpha;
-  vtkNew<vtkImageAppendComponents> AddSubAppendRGBA;
-  vtkNew<vtkImageCast> AddSubOutputCast;
-  vtkNew<vtkImageBlend> Blend;
+  vtkNew<vtkImageLayerBlend> Blend;
 };
 
 //----------------------------------------------------------------------------
@@ -892,7 +851,7 @@ void vtkDMMLSliceLogic::UpdateImageData ()
 }
 
 //----------------------------------------------------------------------------
-bool vtkDMMLSliceLogic::UpdateBlendLayers(vtkImageBlend* blend, const std::deque<SliceLayerInfo> &layers)
+bool vtkDMMLSliceLogic::UpdateBlendLayers(vtkImageLayerBlend* blend, const std::deque<SliceLayerInfo> &layers)
 {
   const int blendPort = 0;
   vtkMTimeType oldBlendMTime = blend->GetMTime();
@@ -925,12 +884,13 @@ bool vtkDMMLSliceLogic::UpdateBlendLayers(vtkImageBlend* blend, const std::deque
       }
     }
 
-  // Update opacities
+  // Update opacities and blend modes
     {
     int layerIndex = 0;
     for (std::deque<SliceLayerInfo>::const_iterator layerIt = layers.begin(); layerIt != layers.end(); ++layerIt, ++layerIndex)
       {
       blend->SetOpacity(layerIndex, layerIt->Opacity);
+      blend->SetBlendMode(layerIndex, layerIt->BlendMode);
       }
     }
 
@@ -1947,6 +1907,9 @@ void vtkDMMLSliceLogic::StartSliceNodeInteraction(unsigned int parameters)
   // to this this outside the conditional on HotLinkedControl and LinkedControl
   this->SliceNode->SetInteractionFlags(parameters);
 
+  // Reslice downsampled volumes while interacting
+  this->SetLayersInteracting(true);
+
   // If we have hot linked controls, then we want to broadcast changes
   if ((this->SliceCompositeNode->GetHotLinkedControl() || parameters == vtkDMMLSliceNode::MultiplanarReformatFlag)
       && this->SliceCompositeNode->GetLinkedControl())
@@ -2070,6 +2033,22 @@ void vtkDMMLSliceLogic::EndSliceNodeInteraction()
     }
 
   this->SliceNode->SetInteractionFlags(0);
+
+  // Switch back to full resolution volumes
+  this->SetLayersInteracting(false);
+}
+
+//----------------------------------------------------------------------------
+void vtkDMMLSliceLogic::SetLayersInteracting(bool interacting)
+{
+  vtkDMMLSliceLayerLogic* layers[3] = { this->BackgroundLayer, this->ForegroundLayer, this->LabelLayer };
+  for (vtkDMMLSliceLayerLogic* layer : layers)
+    {
+    if (layer)
+      {
+      layer->SetInteracting(interacting);
+      }
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -2371,13 +2350,13 @@ bool vtkDMMLSliceLogic::IsSliceModelDisplayNode(vtkDMMLDisplayNode *dmmlDisplayN
 }
 
 //----------------------------------------------------------------------------
-vtkImageBlend* vtkDMMLSliceLogic::GetBlend()
+vtkImageLayerBlend* vtkDMMLSliceLogic::GetBlend()
 {
   return this->Pipeline->Blend.GetPointer();
 }
 
 //----------------------------------------------------------------------------
-vtkImageBlend* vtkDMMLSliceLogic::GetBlendUVW()
+vtkImageLayerBlend* vtkDMMLSliceLogic::GetBlendUVW()
 {
   return this->PipelineUVW->Blend.GetPointer();
 }
@@ -34,7 +34,7 @@ class vtkDMMLVolumeNode;
 
 class vtkAlgorithmOutput;
 class vtkCollection;
-class vtkImageBlend;
+class vtkImageLayerBlend;
 class vtkTransform;
 class vtkImageData;
 class vtkImageReslice;
@@ -157,8 +157,8 @@ public:
   ///
   /// The compositing filter
   /// TODO: this will eventually be generalized to a per-layer compositing function
-  vtkImageBlend* GetBlend();
-  vtkImageBlend* GetBlendUVW();
+  vtkImageLayerBlend* GetBlend();
+  vtkImageLayerBlend* GetBlendUVW();
 
   ///
   /// An image reslice instance to pull a single slice from the volume that
@@ -420,7 +420,11 @@ protected:
   /// It minimizes changes to the imaging pipeline (does not remove and
   /// re-add an input if it is not changed) because rebuilding of the pipeline
   /// is a relatively expensive operation.
-  bool UpdateBlendLayers(vtkImageBlend* blend, const std::deque<SliceLayerInfo> &layers);
+  bool UpdateBlendLayers(vtkImageLayerBlend* blend, const std::deque<SliceLayerInfo> &layers);
+
+  /// Notify layers about start/end of view interaction, so that they can
+  /// use lower resolution images while interacting.
+  void SetLayersInteracting(bool interacting);
 
   /// Returns true if position is inside the selected layer volume.
   /// Use background flag to choose between foreground/background layer.
@@ -20,6 +20,10 @@
 #include <vtkStreamingDemandDrivenPipeline.h>
 #include <vtkVersion.h>
 
+// STD includes
+#include <algorithm>
+#include <vector>
+
 //------------------------------------------------------------------------------
 vtkStandardNewMacro(vtkImageLabelOutline);
 
@@ -31,6 +35,7 @@ vtkImageLabelOutline::vtkImageLabelOutline()
   this->Outline = 1;
   this->Background = 0;
   this->HandleBoundaries = 1;
+  this->UseRowKernel = true;
   this->SetNeighborTo8();
 }
 
@@ -40,6 +45,132 @@ vtkImageLabelOutline::~vtkImageLabelOutline() = default;
 //----------------------------------------------------------------------------
 
 
+// Description:
+// Computes the outline slice by slice, processing a whole row at a time.
+// A non-background pixel is not on the outline if all pixels in its
+// (2*outline+1)^2 in-plane neighborhood are within the image and have the
+// same value. This is decomposed into a horizontal test (is the pixel's row
+// neighborhood uniform?), which is computed once for each input row, and
+// a vertical test that combines the horizontal results of the neighboring rows.
+// Inner loops are branch-free comparisons of contiguous arrays so that the
+// compiler can vectorize them.
+template <class T>
+static void vtkImageLabelOutlineRowExecute(vtkImageLabelOutline *self,
+                     vtkImageData *inData, vtkImageData *outData,
+                     int outExt[6], int id)
+{
+  vtkIdType inInc0, inInc1, inInc2;
+  vtkIdType outInc0, outInc1, outInc2;
+  inData->GetIncrements(inInc0, inInc1, inInc2);
+  outData->GetIncrements(outInc0, outInc1, outInc2);
+  int wholeExt[6];
+  self->GetInputInformation()->Get(
+        vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExt);
+
+  const T backgroundLabelValue = static_cast<T>(self->GetBackground());
+  const int outline = std::max(self->GetOutline(), 0);
+  const int numberOfNeighborhoodRows = 2 * outline + 1;
+  const int rowLength = outExt[1] - outExt[0] + 1;
+
+  // Range of row indices (relative to outExt[0]) where the neighborhood
+  // does not reach outside of the image. Pixels outside this range are
+  // always on the outline.
+  const int firstInteriorIndex = std::max(outExt[0], wholeExt[0] + outline) - outExt[0];
+  const int lastInteriorIndex = std::min(outExt[1], wholeExt[1] - outline) - outExt[0];
+
+  // Ring buffer of horizontal test results for the rows of the neighborhood
+  std::vector<unsigned char> uniformRows(static_cast<size_t>(numberOfNeighborhoodRows) * rowLength);
+  std::vector<unsigned char> interiorPixels(rowLength);
+  unsigned char* interior = interiorPixels.data();
+
+  unsigned long count = 0;
+  unsigned long target = (unsigned long)((outExt[5]-outExt[4]+1)*(outExt[3]-outExt[2]+1)/50.0);
+  target++;
+
+  T* outPtr = static_cast<T*>(outData->GetScalarPointerForExtent(outExt));
+  for (int outIdx2 = outExt[4]; outIdx2 <= outExt[5]; outIdx2++)
+    {
+    const T* inSlicePtr = static_cast<T*>(inData->GetScalarPointer(outExt[0], outExt[2], outIdx2));
+    T* outSlicePtr = outPtr + (outIdx2 - outExt[4]) * outInc2;
+    // Row y of the input may start before outExt[2] (up to outline rows)
+    auto getInputRow = [&](int y) { return inSlicePtr + (y - outExt[2]) * inInc1; };
+    auto getUniformRow = [&](int y)
+      {
+      return uniformRows.data() + ((y - outExt[2] + outline) % numberOfNeighborhoodRows) * rowLength;
+      };
+    auto computeUniformRow = [&](int y)
+      {
+      const T* inRow = getInputRow(y);
+      unsigned char* uniform = getUniformRow(y);
+      std::fill(uniform, uniform + rowLength, 0);
+      for (int i = firstInteriorIndex; i <= lastInteriorIndex; ++i)
+        {
+        uniform[i] = 1;
+        }
+      for (int offset = -outline; offset <= outline; ++offset)
+        {
+        if (offset == 0)
+          {
+          continue;
+          }
+        for (int i = firstInteriorIndex; i <= lastInteriorIndex; ++i)
+          {
+          uniform[i] &= static_cast<unsigned char>(inRow[i + offset] == inRow[i]);
+          }
+        }
+      };
+
+    // Rows above the first output row
+    for (int y = std::max(outExt[2] - outline, wholeExt[2]);
+      y < outExt[2] + outline && y <= wholeExt[3]; ++y)
+      {
+      computeUniformRow(y);
+      }
+
+    for (int outIdx1 = outExt[2];
+      !self->AbortExecute && outIdx1 <= outExt[3]; outIdx1++)
+      {
+      if (!id)
+        {
+        if (!(count%target))
+          {
+          self->UpdateProgress(count/(50.0*target));
+          }
+        count++;
+        }
+      if (outIdx1 + outline <= wholeExt[3])
+        {
+        computeUniformRow(outIdx1 + outline);
+        }
+
+      const T* inRow = getInputRow(outIdx1);
+      T* outRow = outSlicePtr + (outIdx1 - outExt[2]) * outInc1;
+      std::fill(interior, interior + rowLength, 0);
+      if (outIdx1 - outline >= wholeExt[2] && outIdx1 + outline <= wholeExt[3])
+        {
+        for (int i = firstInteriorIndex; i <= lastInteriorIndex; ++i)
+          {
+          interior[i] = 1;
+          }
+        for (int offset = -outline; offset <= outline; ++offset)
+          {
+          const T* neighborRow = getInputRow(outIdx1 + offset);
+          const unsigned char* uniform = getUniformRow(outIdx1 + offset);
+          for (int i = firstInteriorIndex; i <= lastInteriorIndex; ++i)
+            {
+            interior[i] &= uniform[i] & static_cast<unsigned char>(neighborRow[i] == inRow[i]);
+            }
+          }
+        }
+      for (int i = 0; i < rowLength; ++i)
+        {
+        outRow[i] = (inRow[i] != backgroundLabelValue && !interior[i]) ? inRow[i] : backgroundLabelValue;
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
 // Description:
 // This templated function executes the filter for any type of data.
 template <class T>
@@ -48,6 +179,12 @@ static void vtkImageLabelOutlineExecute(vtkImageLabelOutline *self,
                      vtkImageData *outData,
                      int outExt[6], int id)
 {
+  if (self->GetUseRowKernel())
+    {
+    vtkImageLabelOutlineRowExecute<T>(self, inData, outData, outExt, id);
+    return;
+    }
+
   int *kernelMiddle, *kernelSize;
   // For looping though output (and input) pixels.
   int outMin0, outMax0, outMin1, outMax1, outMin2, outMax2;
@@ -275,6 +412,7 @@ void vtkImageLabelOutline::PrintSelf(ostream& os, vtkIndent indent)
 
     os << indent << "Outline: " << this->Outline << "\n";
     os << indent << "Background: " << this->Background<< "\n";
+    os << indent << "UseRowKernel: " << this->UseRowKernel << "\n";
 
     if (this->GetInput() != nullptr)
       {
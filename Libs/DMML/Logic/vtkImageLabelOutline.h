@@ -42,12 +42,21 @@ public:
   void SetOutline(int outline);
   vtkGetMacro(Outline, int);
 
+  ///
+  /// Compute the outline of each slice by comparing whole rows of the input
+  /// instead of visiting the neighborhood of each voxel (default on).
+  /// The output is the same, this option is only provided for benchmarking.
+  vtkSetMacro(UseRowKernel, bool);
+  vtkGetMacro(UseRowKernel, bool);
+  vtkBooleanMacro(UseRowKernel, bool);
+
 protected:
   vtkImageLabelOutline();
   ~vtkImageLabelOutline() override;
 
   float Background;
   int Outline;
+  bool UseRowKernel;
 
   void ThreadedExecute(vtkImageData *inData, vtkImageData *outData,
                        int extent[6], int id) override;
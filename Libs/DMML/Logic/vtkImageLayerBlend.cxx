@@ -0,0 +1,402 @@
+/*==============================================================================
+
+  Program: 3D Cjyx
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "vtkImageLayerBlend.h"
+
+// VTK includes
+#include <vtkAlgorithm.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+
+// STD includes
+#include <algorithm>
+#include <cstring>
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkImageLayerBlend);
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Number of color (non-alpha) components for a given number of components
+constexpr int ColorComponents(int numberOfComponents)
+{
+  return numberOfComponents < 3 ? 1 : 3;
+}
+
+//----------------------------------------------------------------------------
+// Alpha value of a pixel (255 if the image has no alpha channel)
+template <int InC>
+inline unsigned int PixelAlpha(const unsigned char* inPtr)
+{
+  return (InC == 2 || InC == 4) ? inPtr[InC - 1] : 255;
+}
+
+//----------------------------------------------------------------------------
+// Color component of a pixel. Luminance images return the same value for all colors.
+template <int InC>
+inline unsigned int PixelColor(const unsigned char* inPtr, int component)
+{
+  return inPtr[InC < 3 ? 0 : component];
+}
+
+//----------------------------------------------------------------------------
+// The loops below only use integer arithmetic and compile-time constant
+// number of components so that the compiler can vectorize them.
+template <int InC, int OutC>
+void BlendRowAlpha(const unsigned char* inPtr, unsigned char* outPtr, int count, unsigned int opacity)
+{
+  for (int i = 0; i < count; ++i, inPtr += InC, outPtr += OutC)
+    {
+    unsigned int r = (opacity * PixelAlpha<InC>(inPtr) + 127) / 255;
+    unsigned int f = 255 - r;
+    for (int c = 0; c < ColorComponents(OutC); ++c)
+      {
+      outPtr[c] = static_cast<unsigned char>((outPtr[c] * f + PixelColor<InC>(inPtr, c) * r + 127) / 255);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+template <int InC, int OutC, bool Subtract>
+void BlendRowAddSubtract(const unsigned char* inPtr, unsigned char* outPtr, int count, unsigned int opacity)
+{
+  for (int i = 0; i < count; ++i, inPtr += InC, outPtr += OutC)
+    {
+    for (int c = 0; c < ColorComponents(OutC); ++c)
+      {
+      int value = static_cast<int>((PixelColor<InC>(inPtr, c) * opacity + 127) / 255);
+      value = Subtract ? outPtr[c] - value : outPtr[c] + value;
+      outPtr[c] = static_cast<unsigned char>(std::min(std::max(value, 0), 255));
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+template <int InC, int OutC>
+void BlendRow(int blendMode, const unsigned char* inPtr, unsigned char* outPtr, int count, unsigned int opacity)
+{
+  switch (blendMode)
+    {
+    case vtkImageLayerBlend::BlendModeAdd:
+      BlendRowAddSubtract<InC, OutC, false>(inPtr, outPtr, count, opacity);
+      break;
+    case vtkImageLayerBlend::BlendModeSubtract:
+      BlendRowAddSubtract<InC, OutC, true>(inPtr, outPtr, count, opacity);
+      break;
+    case vtkImageLayerBlend::BlendModeAlpha:
+    default:
+      BlendRowAlpha<InC, OutC>(inPtr, outPtr, count, opacity);
+      break;
+    }
+}
+
+//----------------------------------------------------------------------------
+template <int OutC>
+void BlendRow(int blendMode, int inC, const unsigned char* inPtr, unsigned char* outPtr, int count, unsigned int opacity)
+{
+  switch (inC)
+    {
+    case 1: BlendRow<1, OutC>(blendMode, inPtr, outPtr, count, opacity); break;
+    case 2: BlendRow<2, OutC>(blendMode, inPtr, outPtr, count, opacity); break;
+    case 3: BlendRow<3, OutC>(blendMode, inPtr, outPtr, count, opacity); break;
+    case 4: BlendRow<4, OutC>(blendMode, inPtr, outPtr, count, opacity); break;
+    default: break;
+    }
+}
+
+//----------------------------------------------------------------------------
+void BlendRow(int blendMode, int inC, int outC, const unsigned char* inPtr, unsigned char* outPtr, int count, unsigned int opacity)
+{
+  switch (outC)
+    {
+    case 1: BlendRow<1>(blendMode, inC, inPtr, outPtr, count, opacity); break;
+    case 2: BlendRow<2>(blendMode, inC, inPtr, outPtr, count, opacity); break;
+    case 3: BlendRow<3>(blendMode, inC, inPtr, outPtr, count, opacity); break;
+    case 4: BlendRow<4>(blendMode, inC, inPtr, outPtr, count, opacity); break;
+    default: break;
+    }
+}
+
+//----------------------------------------------------------------------------
+struct LayerInfo
+{
+  vtkImageData* Image{nullptr};
+  int Extent[6]; // part of the output extent that is covered by the layer
+  int NumberOfComponents{0};
+  int BlendMode{vtkImageLayerBlend::BlendModeAlpha};
+  unsigned int Opacity{255}; // 0-255
+  bool CopyToOutput{false}; // the first input is copied instead of blended
+};
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+vtkImageLayerBlend::vtkImageLayerBlend() = default;
+
+//----------------------------------------------------------------------------
+vtkImageLayerBlend::~vtkImageLayerBlend() = default;
+
+//----------------------------------------------------------------------------
+void vtkImageLayerBlend::SetOpacity(int inputIndex, double opacity)
+{
+  if (inputIndex < 0)
+    {
+    vtkErrorMacro("SetOpacity: invalid input index " << inputIndex);
+    return;
+    }
+  opacity = std::min(std::max(opacity, 0.0), 1.0);
+  if (inputIndex >= static_cast<int>(this->Opacities.size()))
+    {
+    this->Opacities.resize(inputIndex + 1, 1.0);
+    }
+  else if (this->Opacities[inputIndex] == opacity)
+    {
+    return;
+    }
+  this->Opacities[inputIndex] = opacity;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+double vtkImageLayerBlend::GetOpacity(int inputIndex)
+{
+  if (inputIndex < 0 || inputIndex >= static_cast<int>(this->Opacities.size()))
+    {
+    return 1.0;
+    }
+  return this->Opacities[inputIndex];
+}
+
+//----------------------------------------------------------------------------
+void vtkImageLayerBlend::SetBlendMode(int inputIndex, int blendMode)
+{
+  if (inputIndex < 0)
+    {
+    vtkErrorMacro("SetBlendMode: invalid input index " << inputIndex);
+    return;
+    }
+  if (blendMode < 0 || blendMode >= BlendMode_Last)
+    {
+    vtkErrorMacro("SetBlendMode: invalid blend mode " << blendMode);
+    return;
+    }
+  if (inputIndex >= static_cast<int>(this->BlendModes.size()))
+    {
+    this->BlendModes.resize(inputIndex + 1, BlendModeAlpha);
+    }
+  else if (this->BlendModes[inputIndex] == blendMode)
+    {
+    return;
+    }
+  this->BlendModes[inputIndex] = blendMode;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkImageLayerBlend::GetBlendMode(int inputIndex)
+{
+  if (inputIndex < 0 || inputIndex >= static_cast<int>(this->BlendModes.size()))
+    {
+    return BlendModeAlpha;
+    }
+  return this->BlendModes[inputIndex];
+}
+
+//----------------------------------------------------------------------------
+const char* vtkImageLayerBlend::GetBlendModeAsString(int blendMode)
+{
+  switch (blendMode)
+    {
+    case BlendModeAlpha: return "Alpha";
+    case BlendModeAdd: return "Add";
+    case BlendModeSubtract: return "Subtract";
+    default:
+      return "";
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkImageLayerBlend::FillInputPortInformation(int port, vtkInformation* info)
+{
+  if (port == 0)
+    {
+    info->Set(vtkAlgorithm::INPUT_IS_REPEATABLE(), 1);
+    info->Set(vtkAlgorithm::INPUT_IS_OPTIONAL(), 1);
+    }
+  return this->Superclass::FillInputPortInformation(port, info);
+}
+
+//----------------------------------------------------------------------------
+int vtkImageLayerBlend::RequestUpdateExtent(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  int outExt[6];
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), outExt);
+
+  // Request only the part of each input that overlaps with the output
+  int numberOfInputs = this->GetNumberOfInputConnections(0);
+  for (int inputIndex = 0; inputIndex < numberOfInputs; ++inputIndex)
+    {
+    vtkInformation* inInfo = inputVector[0]->GetInformationObject(inputIndex);
+    int wholeExt[6];
+    inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExt);
+    int inExt[6];
+    bool empty = false;
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      inExt[axis * 2] = std::max(outExt[axis * 2], wholeExt[axis * 2]);
+      inExt[axis * 2 + 1] = std::min(outExt[axis * 2 + 1], wholeExt[axis * 2 + 1]);
+      if (inExt[axis * 2] > inExt[axis * 2 + 1])
+        {
+        empty = true;
+        }
+      }
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), empty ? wholeExt : inExt, 6);
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkImageLayerBlend::RequestData(vtkInformation* request,
+  vtkInformationVector** inputVector, vtkInformationVector* outputVector)
+{
+  int numberOfInputs = this->GetNumberOfInputConnections(0);
+  if (numberOfInputs == 0)
+    {
+    return 1;
+    }
+  for (int inputIndex = 0; inputIndex < numberOfInputs; ++inputIndex)
+    {
+    vtkImageData* input = vtkImageData::GetData(inputVector[0], inputIndex);
+    if (!input)
+      {
+      vtkErrorMacro("RequestData: input " << inputIndex << " is invalid");
+      return 0;
+      }
+    int numberOfComponents = input->GetNumberOfScalarComponents();
+    if (input->GetScalarType() != VTK_UNSIGNED_CHAR || numberOfComponents < 1 || numberOfComponents > 4)
+      {
+      vtkErrorMacro("RequestData: input " << inputIndex << " must be unsigned char with 1-4 components, got "
+        << input->GetScalarTypeAsString() << " with " << numberOfComponents << " components");
+      return 0;
+      }
+    }
+  return this->Superclass::RequestData(request, inputVector, outputVector);
+}
+
+//----------------------------------------------------------------------------
+void vtkImageLayerBlend::ThreadedRequestData(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** vtkNotUsed(inputVector), vtkInformationVector* vtkNotUsed(outputVector),
+  vtkImageData*** inData, vtkImageData** outData, int outExt[6], int vtkNotUsed(threadId))
+{
+  int numberOfInputs = this->GetNumberOfInputConnections(0);
+  if (numberOfInputs == 0 || outExt[0] > outExt[1] || outExt[2] > outExt[3] || outExt[4] > outExt[5])
+    {
+    return;
+    }
+  vtkImageData* output = outData[0];
+  const int outC = output->GetNumberOfScalarComponents();
+
+  std::vector<LayerInfo> layers;
+  layers.reserve(numberOfInputs);
+  for (int inputIndex = 0; inputIndex < numberOfInputs; ++inputIndex)
+    {
+    LayerInfo layer;
+    layer.Image = inData[0][inputIndex];
+    if (!layer.Image || !layer.Image->GetScalarPointer())
+      {
+      continue;
+      }
+    const int* inExt = layer.Image->GetExtent();
+    bool empty = false;
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      layer.Extent[axis * 2] = std::max(outExt[axis * 2], inExt[axis * 2]);
+      layer.Extent[axis * 2 + 1] = std::min(outExt[axis * 2 + 1], inExt[axis * 2 + 1]);
+      if (layer.Extent[axis * 2] > layer.Extent[axis * 2 + 1])
+        {
+        empty = true;
+        }
+      }
+    if (empty)
+      {
+      continue;
+      }
+    layer.NumberOfComponents = layer.Image->GetNumberOfScalarComponents();
+    layer.BlendMode = (inputIndex == 0 ? BlendModeAlpha : this->GetBlendMode(inputIndex));
+    layer.Opacity = static_cast<unsigned int>(this->GetOpacity(inputIndex) * 255.0 + 0.5);
+    layer.CopyToOutput = (inputIndex == 0 && layer.NumberOfComponents == outC);
+    layers.push_back(layer);
+    }
+
+  // Composite all layers row by row, so that the output row stays in the cache
+  // while the layers are blended into it.
+  const int rowLength = outExt[1] - outExt[0] + 1;
+  for (int z = outExt[4]; z <= outExt[5]; ++z)
+    {
+    for (int y = outExt[2]; !this->AbortExecute && y <= outExt[3]; ++y)
+      {
+      unsigned char* outRow = static_cast<unsigned char*>(output->GetScalarPointer(outExt[0], y, z));
+      bool initialized = false;
+      for (const LayerInfo& layer : layers)
+        {
+        if (y < layer.Extent[2] || y > layer.Extent[3] || z < layer.Extent[4] || z > layer.Extent[5])
+          {
+          continue;
+          }
+        const unsigned char* inRow = static_cast<const unsigned char*>(layer.Image->GetScalarPointer(layer.Extent[0], y, z));
+        unsigned char* outSegment = outRow + static_cast<vtkIdType>(layer.Extent[0] - outExt[0]) * outC;
+        const int count = layer.Extent[1] - layer.Extent[0] + 1;
+        if (!initialized)
+          {
+          initialized = true;
+          if (!layer.CopyToOutput || count < rowLength)
+            {
+            memset(outRow, 0, static_cast<size_t>(rowLength) * outC);
+            }
+          if (layer.CopyToOutput)
+            {
+            memcpy(outSegment, inRow, static_cast<size_t>(count) * outC);
+            continue;
+            }
+          }
+        BlendRow(layer.BlendMode, layer.NumberOfComponents, outC, inRow, outSegment, count, layer.Opacity);
+        }
+      if (!initialized)
+        {
+        // no layer covers this row
+        memset(outRow, 0, static_cast<size_t>(rowLength) * outC);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkImageLayerBlend::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  int numberOfInputs = this->GetNumberOfInputConnections(0);
+  for (int inputIndex = 0; inputIndex < numberOfInputs; ++inputIndex)
+    {
+    os << indent << "Input " << inputIndex << ": opacity = " << this->GetOpacity(inputIndex)
+      << ", blend mode = " << vtkImageLayerBlend::GetBlendModeAsString(this->GetBlendMode(inputIndex)) << "\n";
+    }
+}
@@ -0,0 +1,93 @@
+/*==============================================================================
+
+  Program: 3D Cjyx
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkImageLayerBlend_h
+#define __vtkImageLayerBlend_h
+
+#include <vtkThreadedImageAlgorithm.h>
+
+#include "vtkDMMLLogicExport.h"
+
+// STD includes
+#include <vector>
+
+/// \brief Composite slice layers in a single pass.
+///
+/// All inputs are connected to port 0 and must be unsigned char images with
+/// 1 (luminance), 2 (luminance+alpha), 3 (RGB) or 4 (RGBA) components.
+/// The output has the same geometry and number of components as the first input.
+///
+/// The first input is copied to the output, then each further input is composited
+/// on top of it, in the order of the connections, using the blend mode of the input:
+/// - Alpha: output = output * (1 - opacity * alpha) + input * opacity * alpha
+/// - Add: output = output + opacity * input (clamped)
+/// - Subtract: output = output - opacity * input (clamped)
+/// The alpha channel of the output is always taken from the first input.
+///
+/// Unlike a vtkImageBlend combined with vtkImageMathematics for add/subtract
+/// compositing, all layers are processed row by row in the output buffer,
+/// without allocating intermediate images.
+class VTK_DMML_LOGIC_EXPORT vtkImageLayerBlend : public vtkThreadedImageAlgorithm
+{
+public:
+  static vtkImageLayerBlend *New();
+  vtkTypeMacro(vtkImageLayerBlend, vtkThreadedImageAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  enum BlendModes
+    {
+    BlendModeAlpha = 0,
+    BlendModeAdd,
+    BlendModeSubtract,
+    BlendMode_Last // insert valid types above this line
+    };
+
+  /// Opacity of an input, between 0 and 1. Default is 1.
+  /// Opacity of the first input is ignored.
+  void SetOpacity(int inputIndex, double opacity);
+  double GetOpacity(int inputIndex);
+
+  /// Blend mode of an input (BlendModeAlpha, BlendModeAdd, BlendModeSubtract).
+  /// Default is BlendModeAlpha. Blend mode of the first input is ignored.
+  void SetBlendMode(int inputIndex, int blendMode);
+  int GetBlendMode(int inputIndex);
+
+  static const char* GetBlendModeAsString(int blendMode);
+
+protected:
+  vtkImageLayerBlend();
+  ~vtkImageLayerBlend() override;
+
+  int FillInputPortInformation(int port, vtkInformation* info) override;
+
+  int RequestUpdateExtent(vtkInformation* request,
+    vtkInformationVector** inputVector, vtkInformationVector* outputVector) override;
+
+  int RequestData(vtkInformation* request,
+    vtkInformationVector** inputVector, vtkInformationVector* outputVector) override;
+
+  void ThreadedRequestData(vtkInformation* request,
+    vtkInformationVector** inputVector, vtkInformationVector* outputVector,
+    vtkImageData*** inData, vtkImageData** outData, int outExt[6], int threadId) override;
+
+  std::vector<double> Opacities;
+  std::vector<int> BlendModes;
+
+private:
+  vtkImageLayerBlend(const vtkImageLayerBlend&) = delete;
+  void operator=(const vtkImageLayerBlend&) = delete;
+};
+
+#endif
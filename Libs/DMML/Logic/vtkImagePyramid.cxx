@@ -0,0 +1,206 @@
+/*==============================================================================
+
+  Program: 3D Cjyx
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "vtkImagePyramid.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkImageShrink3D.h>
+#include <vtkInformation.h>
+#include <vtkInformationObjectBaseKey.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkImagePyramid);
+vtkInformationKeyMacro(vtkImagePyramid, IMAGE_PYRAMID, ObjectBase);
+
+//----------------------------------------------------------------------------
+vtkImagePyramid::vtkImagePyramid() = default;
+
+//----------------------------------------------------------------------------
+vtkImagePyramid::~vtkImagePyramid() = default;
+
+//----------------------------------------------------------------------------
+vtkImagePyramid* vtkImagePyramid::GetImagePyramid(vtkImageData* image)
+{
+  if (!image)
+    {
+    return nullptr;
+    }
+  vtkInformation* imageInfo = image->GetInformation();
+  vtkImagePyramid* pyramid = vtkImagePyramid::SafeDownCast(imageInfo->Get(vtkImagePyramid::IMAGE_PYRAMID()));
+  if (!pyramid || pyramid->GetInputImage() != image)
+    {
+    // Information may have been copied from another image, do not reuse its pyramid
+    vtkNew<vtkImagePyramid> newPyramid;
+    newPyramid->SetInputImage(image);
+    imageInfo->Set(vtkImagePyramid::IMAGE_PYRAMID(), newPyramid);
+    pyramid = newPyramid;
+    }
+  return pyramid;
+}
+
+//----------------------------------------------------------------------------
+void vtkImagePyramid::SetInputImage(vtkImageData* image)
+{
+  if (this->InputImage == image)
+    {
+    return;
+    }
+  this->InputImage = image;
+  this->ClearLevels();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkImageData* vtkImagePyramid::GetInputImage()
+{
+  return this->InputImage;
+}
+
+//----------------------------------------------------------------------------
+void vtkImagePyramid::SetAveraging(bool averaging)
+{
+  if (this->Averaging == averaging)
+    {
+    return;
+    }
+  this->Averaging = averaging;
+  this->ClearLevels();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkImagePyramid::ClearLevels()
+{
+  this->Levels.clear();
+  this->InputImageMTime = 0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkImagePyramid::CanDownsample(const int dimensions[3])
+{
+  // at least two voxels must remain along the longest axis
+  return std::max(std::max(dimensions[0], dimensions[1]), dimensions[2]) >= 4;
+}
+
+//----------------------------------------------------------------------------
+int vtkImagePyramid::GetNumberOfLevels()
+{
+  vtkImageData* image = this->InputImage;
+  if (!image || !image->GetPointData()->GetScalars())
+    {
+    return image ? 1 : 0;
+    }
+  int dimensions[3] = { 0, 0, 0 };
+  image->GetDimensions(dimensions);
+  int numberOfLevels = 1;
+  while (numberOfLevels < this->MaximumNumberOfLevels && vtkImagePyramid::CanDownsample(dimensions))
+    {
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      dimensions[axis] = std::max(dimensions[axis] / 2, 1);
+      }
+    ++numberOfLevels;
+    }
+  return numberOfLevels;
+}
+
+//----------------------------------------------------------------------------
+int vtkImagePyramid::GetLevelForVoxelsPerPixel(double voxelsPerPixel)
+{
+  if (voxelsPerPixel < 2.0)
+    {
+    return 0;
+    }
+  return static_cast<int>(std::floor(std::log2(voxelsPerPixel)));
+}
+
+//----------------------------------------------------------------------------
+vtkImageData* vtkImagePyramid::GetLevel(int level)
+{
+  vtkImageData* inputImage = this->InputImage;
+  if (!inputImage)
+    {
+    return nullptr;
+    }
+  if (inputImage->GetMTime() != this->InputImageMTime)
+    {
+    // input image changed, previously generated levels are obsolete
+    this->ClearLevels();
+    this->InputImageMTime = inputImage->GetMTime();
+    }
+  level = std::min(std::max(level, 0), this->GetNumberOfLevels() - 1);
+
+  while (static_cast<int>(this->Levels.size()) < level)
+    {
+    vtkImageData* previousLevel = this->Levels.empty() ? inputImage : this->Levels.back().GetPointer();
+    int dimensions[3] = { 0, 0, 0 };
+    previousLevel->GetDimensions(dimensions);
+    int shrinkFactors[3] = { 1, 1, 1 };
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      shrinkFactors[axis] = (dimensions[axis] >= 2 ? 2 : 1);
+      }
+
+    vtkNew<vtkImageShrink3D> shrink;
+    shrink->SetInputData(previousLevel);
+    shrink->SetShrinkFactors(shrinkFactors);
+    shrink->SetShift(0, 0, 0);
+    shrink->SetMean(this->Averaging);
+    shrink->MedianOff();
+    shrink->MinimumOff();
+    shrink->MaximumOff();
+    shrink->Update();
+
+    vtkSmartPointer<vtkImageData> nextLevel = vtkSmartPointer<vtkImageData>::New();
+    nextLevel->ShallowCopy(shrink->GetOutput());
+
+    // Place each voxel at the center of the voxels it was computed from
+    double spacing[3] = { 1.0, 1.0, 1.0 };
+    double origin[3] = { 0.0, 0.0, 0.0 };
+    previousLevel->GetSpacing(spacing);
+    previousLevel->GetOrigin(origin);
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      if (this->Averaging)
+        {
+        origin[axis] += 0.5 * (shrinkFactors[axis] - 1) * spacing[axis];
+        }
+      spacing[axis] *= shrinkFactors[axis];
+      }
+    nextLevel->SetSpacing(spacing);
+    nextLevel->SetOrigin(origin);
+    this->Levels.push_back(nextLevel);
+    }
+
+  return level == 0 ? inputImage : this->Levels[level - 1].GetPointer();
+}
+
+//----------------------------------------------------------------------------
+void vtkImagePyramid::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "InputImage: " << this->InputImage.GetPointer() << "\n";
+  os << indent << "Averaging: " << (this->Averaging ? "true" : "false") << "\n";
+  os << indent << "MaximumNumberOfLevels: " << this->MaximumNumberOfLevels << "\n";
+  os << indent << "Number of generated levels: " << this->Levels.size() + (this->InputImage ? 1 : 0) << "\n";
+}
@@ -0,0 +1,110 @@
+/*==============================================================================
+
+  Program: 3D Cjyx
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkImagePyramid_h
+#define __vtkImagePyramid_h
+
+#include <vtkObject.h>
+#include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
+
+#include "vtkDMMLLogicExport.h"
+
+// STD includes
+#include <vector>
+
+class vtkImageData;
+class vtkInformationObjectBaseKey;
+
+/// \brief Multi-resolution representation of an image.
+///
+/// Level 0 is the input image, each further level is downsampled by a factor of 2
+/// along each axis that has more than one voxel. Levels are generated on request
+/// (from the previous level) and kept until the input image is modified.
+///
+/// Voxels of a level are placed at the center of the voxels they were computed from
+/// (spacing and origin are set accordingly), therefore the same index to physical
+/// transform can be used for reslicing any level.
+///
+/// Downsampling computes the average of voxels by default. Averaging must be
+/// disabled for label maps, so that label values are preserved.
+///
+/// Use GetImagePyramid() to get the pyramid of an image that is shared
+/// between all users of the same image (e.g., slice views).
+class VTK_DMML_LOGIC_EXPORT vtkImagePyramid : public vtkObject
+{
+public:
+  static vtkImagePyramid *New();
+  vtkTypeMacro(vtkImagePyramid, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Get the pyramid associated with the image.
+  /// The pyramid is created if it does not exist yet and stored in the
+  /// information of the image, so it is released when the image is deleted.
+  static vtkImagePyramid* GetImagePyramid(vtkImageData* image);
+
+  /// Key used for storing the pyramid in the information of the image.
+  static vtkInformationObjectBaseKey* IMAGE_PYRAMID();
+
+  /// Full resolution image. The pyramid does not keep a reference to it.
+  void SetInputImage(vtkImageData* image);
+  vtkImageData* GetInputImage();
+
+  /// Compute average of voxels (enabled by default). If disabled then
+  /// every second voxel is kept, which is required for label maps.
+  void SetAveraging(bool averaging);
+  vtkGetMacro(Averaging, bool);
+  vtkBooleanMacro(Averaging, bool);
+
+  /// Maximum number of levels (including the full resolution level). Default is 8.
+  vtkSetClampMacro(MaximumNumberOfLevels, int, 1, 16);
+  vtkGetMacro(MaximumNumberOfLevels, int);
+
+  /// Number of levels that can be generated for the current input image.
+  int GetNumberOfLevels();
+
+  /// Get image at the specified level (0 = full resolution).
+  /// If the level is not available then the coarsest level is returned.
+  /// Returns nullptr if there is no input image.
+  vtkImageData* GetLevel(int level);
+
+  /// Get the coarsest level that still has at least one voxel per screen
+  /// pixel, if one screen pixel covers voxelsPerPixel voxels at full resolution.
+  static int GetLevelForVoxelsPerPixel(double voxelsPerPixel);
+
+  /// Remove all generated levels
+  void ClearLevels();
+
+protected:
+  vtkImagePyramid();
+  ~vtkImagePyramid() override;
+
+  /// Returns true if an image of the specified size can be downsampled to get the next level
+  static bool CanDownsample(const int dimensions[3]);
+
+  vtkWeakPointer<vtkImageData> InputImage;
+  vtkMTimeType InputImageMTime{0};
+  bool Averaging{true};
+  int MaximumNumberOfLevels{8};
+
+  /// Generated levels, the first element is level 1
+  std::vector< vtkSmartPointer<vtkImageData> > Levels;
+
+private:
+  vtkImagePyramid(const vtkImagePyramid&) = delete;
+  void operator=(const vtkImagePyramid&) = delete;
+};
+
+#endif
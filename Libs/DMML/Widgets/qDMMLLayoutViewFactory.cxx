@@ -258,6 +258,8 @@ void qDMMLLayoutViewFactory::setDMMLScene(vtkDMMLScene* scene)
     }
   this->qvtkReconnect(d->DMMLScene, scene, vtkDMMLScene::NodeAddedEvent,
                       this, SLOT(onNodeAdded(vtkObject*,vtkObject*)));
+  this->qvtkReconnect(d->DMMLScene, scene, vtkDMMLScene::NodesAddedEvent,
+                      this, SLOT(onNodesAdded(vtkObject*,vtkObject*)));
 
   this->qvtkReconnect(d->DMMLScene, scene, vtkDMMLScene::NodeRemovedEvent,
                      this, SLOT(onNodeRemoved(vtkObject*,vtkObject*)));
@@ -363,6 +365,22 @@ void qDMMLLayoutViewFactory::onNodeAdded(vtkObject* scene, vtkObject* node)
     }
 }
 
+// --------------------------------------------------------------------------
+void qDMMLLayoutViewFactory::onNodesAdded(vtkObject* scene, vtkObject* nodes)
+{
+  vtkCollection* addedNodes = vtkCollection::SafeDownCast(nodes);
+  if (!addedNodes)
+    {
+    return;
+    }
+  vtkCollectionSimpleIterator it;
+  vtkObject* node = nullptr;
+  for (addedNodes->InitTraversal(it); (node = addedNodes->GetNextItemAsObject(it));)
+    {
+    this->onNodeAdded(scene, node);
+    }
+}
+
 // --------------------------------------------------------------------------
 void qDMMLLayoutViewFactory::onNodeRemoved(vtkObject* scene, vtkObject* node)
 {
@@ -110,6 +110,9 @@ public Q_SLOTS:
   virtual void setDMMLScene(vtkDMMLScene* scene);
 
   virtual void onNodeAdded(vtkObject* scene, vtkObject* node);
+  /// Called when nodes are added by a scene import in bulk import mode
+  /// \sa vtkDMMLScene::NodesAddedEvent
+  virtual void onNodesAdded(vtkObject* scene, vtkObject* nodes);
   virtual void onNodeRemoved(vtkObject* scene, vtkObject* node);
   virtual void onNodeModified(vtkObject* node);
   virtual void onViewNodeAdded(vtkDMMLAbstractViewNode* node);
@@ -349,6 +349,7 @@ void qDMMLSceneModel::setDMMLScene(vtkDMMLScene* scene)
     {
     scene->AddObserver(vtkDMMLScene::NodeAboutToBeAddedEvent, d->CallBack, -10.);
     scene->AddObserver(vtkDMMLScene::NodeAddedEvent, d->CallBack, 10.);
+    scene->AddObserver(vtkDMMLScene::NodesAddedEvent, d->CallBack, 10.);
     scene->AddObserver(vtkDMMLScene::NodeAboutToBeRemovedEvent, d->CallBack, -10.);
     scene->AddObserver(vtkDMMLScene::NodeRemovedEvent, d->CallBack, 10.);
     scene->AddObserver(vtkCommand::DeleteEvent, d->CallBack);
@@ -1142,6 +1143,18 @@ void qDMMLSceneModel::onDMMLSceneEvent(vtkObject* vtk_obj, unsigned long event,
       Q_ASSERT(node);
       sceneModel->onDMMLSceneNodeAdded(scene, node);
       break;
+    case vtkDMMLScene::NodesAddedEvent:
+      {
+      vtkCollection* addedNodes = reinterpret_cast<vtkCollection*>(call_data);
+      Q_ASSERT(addedNodes);
+      vtkCollectionSimpleIterator it;
+      vtkObject* addedNode = nullptr;
+      for (addedNodes->InitTraversal(it); (addedNode = addedNodes->GetNextItemAsObject(it));)
+        {
+        sceneModel->onDMMLSceneNodeAdded(scene, vtkDMMLNode::SafeDownCast(addedNode));
+        }
+      }
+      break;
     case vtkDMMLScene::NodeAboutToBeRemovedEvent:
       Q_ASSERT(node);
       sceneModel->onDMMLSceneNodeAboutToBeRemoved(scene, node);
@@ -0,0 +1,157 @@
+/*==============================================================================
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkPolyData.h>
+#include <vtkTimerLog.h>
+
+// SegmentationCore includes
+#include "vtkBinaryLabelmapToClosedSurfaceConversionRule.h"
+#include "vtkOrientedImageData.h"
+#include "vtkSegment.h"
+#include "vtkSegmentation.h"
+#include "vtkSegmentationConverter.h"
+#include "vtkSegmentationConverterFactory.h"
+
+// STD includes
+#include <cmath>
+#include <sstream>
+
+namespace
+{
+
+const int NUMBER_OF_LABELS = 50;
+
+//----------------------------------------------------------------------------
+// Create a labelmap with NUMBER_OF_LABELS non-overlapping ellipsoids
+void CreateMultiLabelLabelmap(vtkOrientedImageData* labelmap)
+{
+  const int dimensions[3] = { 200, 200, 100 };
+  labelmap->SetExtent(0, dimensions[0] - 1, 0, dimensions[1] - 1, 0, dimensions[2] - 1);
+  labelmap->SetSpacing(0.8, 0.8, 1.5);
+  labelmap->SetOrigin(-80.0, -80.0, -75.0);
+  labelmap->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  unsigned char* voxels = static_cast<unsigned char*>(labelmap->GetScalarPointer());
+  for (int k = 0; k < dimensions[2]; ++k)
+    {
+    for (int j = 0; j < dimensions[1]; ++j)
+      {
+      for (int i = 0; i < dimensions[0]; ++i, ++voxels)
+        {
+        *voxels = 0;
+        for (int label = 1; label <= NUMBER_OF_LABELS; ++label)
+          {
+          double center[3] = { 20.0 + 40.0 * ((label - 1) % 5), 20.0 + 40.0 * (((label - 1) / 5) % 5), 25.0 + 50.0 * ((label - 1) / 25) };
+          double radius[3] = { 12.0 + label % 7, 10.0 + label % 5, 14.0 + label % 11 };
+          double d[3] = { (i - center[0]) / radius[0], (j - center[1]) / radius[1], (k - center[2]) / radius[2] };
+          if (d[0] * d[0] + d[1] * d[1] + d[2] * d[2] <= 1.0)
+            {
+            *voxels = static_cast<unsigned char>(label);
+            break;
+            }
+          }
+        }
+      }
+    }
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkBinaryLabelmapToClosedSurfaceConversionTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkSegmentationConverterFactory::GetInstance()->RegisterConverterRule(
+    vtkSmartPointer<vtkBinaryLabelmapToClosedSurfaceConversionRule>::New());
+
+  vtkNew<vtkOrientedImageData> sharedLabelmap;
+  CreateMultiLabelLabelmap(sharedLabelmap);
+
+  // Segmentation with all segments in a single shared labelmap layer
+  vtkNew<vtkSegmentation> segmentation;
+  segmentation->SetMasterRepresentationName(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName());
+  for (int label = 1; label <= NUMBER_OF_LABELS; ++label)
+    {
+    vtkNew<vtkSegment> segment;
+    std::stringstream ss;
+    ss << "label" << label;
+    segment->SetName(ss.str().c_str());
+    segment->SetLabelValue(label);
+    segment->AddRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName(), sharedLabelmap);
+    segmentation->AddSegment(segment, ss.str());
+    }
+
+  // Reference: contour the entire labelmap separately for each label
+  vtkNew<vtkBinaryLabelmapToClosedSurfaceConversionRule> rule;
+  std::vector<vtkSmartPointer<vtkPolyData> > referenceSurfaces;
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  for (int label = 1; label <= NUMBER_OF_LABELS; ++label)
+    {
+    vtkSmartPointer<vtkPolyData> referenceSurface = vtkSmartPointer<vtkPolyData>::New();
+    std::vector<int> labelValues = { label };
+    rule->CreateClosedSurface(sharedLabelmap, referenceSurface, labelValues);
+    referenceSurfaces.push_back(referenceSurface);
+    }
+  timer->StopTimer();
+  double referenceTime = timer->GetElapsedTime();
+  std::cout << NUMBER_OF_LABELS << " labels, whole labelmap contoured per label: " << referenceTime << "s" << std::endl;
+
+  // Conversion using a single pass over the labelmap to find the region of each label
+  timer->StartTimer();
+  if (!segmentation->CreateRepresentation(vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName()))
+    {
+    std::cerr << __LINE__ << ": Failed to convert shared labelmap to closed surface" << std::endl;
+    return EXIT_FAILURE;
+    }
+  timer->StopTimer();
+  double conversionTime = timer->GetElapsedTime();
+  std::cout << NUMBER_OF_LABELS << " labels, segmentation conversion: " << conversionTime << "s"
+    << " (speedup: " << referenceTime / conversionTime << "x)" << std::endl;
+
+  for (int label = 1; label <= NUMBER_OF_LABELS; ++label)
+    {
+    std::stringstream ss;
+    ss << "label" << label;
+    vtkPolyData* surface = vtkPolyData::SafeDownCast(segmentation->GetSegment(ss.str())->GetRepresentation(
+      vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName()));
+    vtkPolyData* referenceSurface = referenceSurfaces[label - 1];
+    if (!surface || surface->GetNumberOfPoints() == 0)
+      {
+      std::cerr << __LINE__ << ": Empty closed surface for label " << label << std::endl;
+      return EXIT_FAILURE;
+      }
+    if (surface->GetNumberOfPoints() != referenceSurface->GetNumberOfPoints()
+      || surface->GetNumberOfPolys() != referenceSurface->GetNumberOfPolys())
+      {
+      std::cerr << __LINE__ << ": Closed surface mismatch for label " << label << ": "
+        << surface->GetNumberOfPoints() << " points, " << surface->GetNumberOfPolys() << " polys, expected "
+        << referenceSurface->GetNumberOfPoints() << " points, " << referenceSurface->GetNumberOfPolys() << " polys" << std::endl;
+      return EXIT_FAILURE;
+      }
+    double bounds[6] = { 0.0, -1.0, 0.0, -1.0, 0.0, -1.0 };
+    double referenceBounds[6] = { 0.0, -1.0, 0.0, -1.0, 0.0, -1.0 };
+    surface->GetBounds(bounds);
+    referenceSurface->GetBounds(referenceBounds);
+    for (int i = 0; i < 6; ++i)
+      {
+      if (fabs(bounds[i] - referenceBounds[i]) > 1e-6)
+        {
+        std::cerr << __LINE__ << ": Closed surface bounds mismatch for label " << label << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,209 @@
+/*==============================================================================
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+
+// SegmentationCore includes
+#include "vtkOrientedImageData.h"
+#include "vtkSegment.h"
+#include "vtkSegmentation.h"
+#include "vtkSegmentationConverter.h"
+#include "vtkSegmentationHistory.h"
+
+// STD includes
+#include <cstring>
+#include <vector>
+
+namespace
+{
+
+const int NUMBER_OF_EDITS = 4;
+
+//----------------------------------------------------------------------------
+// Fill a box with the specified label value
+void PaintBox(vtkOrientedImageData* labelmap, const int box[6], unsigned char labelValue)
+{
+  for (int k = box[4]; k <= box[5]; ++k)
+    {
+    for (int j = box[2]; j <= box[3]; ++j)
+      {
+      for (int i = box[0]; i <= box[1]; ++i)
+        {
+        *static_cast<unsigned char*>(labelmap->GetScalarPointer(i, j, k)) = labelValue;
+        }
+      }
+    }
+  labelmap->Modified();
+}
+
+//----------------------------------------------------------------------------
+bool AreLabelmapsEqual(vtkOrientedImageData* labelmap1, vtkOrientedImageData* labelmap2)
+{
+  if (!labelmap1 || !labelmap2)
+    {
+    return false;
+    }
+  int* extent1 = labelmap1->GetExtent();
+  int* extent2 = labelmap2->GetExtent();
+  for (int i = 0; i < 6; ++i)
+    {
+    if (extent1[i] != extent2[i])
+      {
+      return false;
+      }
+    }
+  return memcmp(labelmap1->GetScalarPointer(), labelmap2->GetScalarPointer(),
+    static_cast<size_t>(labelmap1->GetNumberOfPoints())) == 0;
+}
+
+//----------------------------------------------------------------------------
+vtkOrientedImageData* GetLabelmap(vtkSegmentation* segmentation, const std::string& segmentId)
+{
+  return vtkOrientedImageData::SafeDownCast(segmentation->GetSegment(segmentId)->GetRepresentation(
+    vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName()));
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkSegmentationHistoryTest2(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  // Two segments sharing a 256x256x128 labelmap (8MB)
+  vtkNew<vtkOrientedImageData> labelmap;
+  labelmap->SetExtent(0, 255, 0, 255, 0, 127);
+  labelmap->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  labelmap->GetPointData()->GetScalars()->Fill(0);
+  const int box1[6] = { 20, 100, 20, 100, 10, 60 };
+  PaintBox(labelmap, box1, 1);
+  const int box2[6] = { 120, 200, 120, 200, 60, 110 };
+  PaintBox(labelmap, box2, 2);
+  const unsigned long labelmapMemorySize = labelmap->GetActualMemorySize();
+
+  vtkNew<vtkSegmentation> segmentation;
+  for (int labelValue = 1; labelValue <= 2; ++labelValue)
+    {
+    vtkNew<vtkSegment> segment;
+    segment->SetLabelValue(labelValue);
+    segment->AddRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName(), labelmap);
+    segmentation->AddSegment(segment, labelValue == 1 ? "Segment_1" : "Segment_2");
+    }
+
+  vtkNew<vtkSegmentationHistory> history;
+  history->SetMaximumNumberOfStates(NUMBER_OF_EDITS + 2);
+  history->SetSegmentation(segmentation);
+
+  // Save states with small edits in between, keep copies of the saved labelmaps for comparison
+  std::vector<vtkSmartPointer<vtkOrientedImageData> > savedLabelmaps;
+  for (int editIndex = 0; editIndex <= NUMBER_OF_EDITS; ++editIndex)
+    {
+    if (editIndex > 0)
+      {
+      int box[6] = { 10 * editIndex, 10 * editIndex + 15, 200, 220, 5 * editIndex, 5 * editIndex + 10 };
+      PaintBox(GetLabelmap(segmentation, "Segment_1"), box, 1);
+      }
+    if (!history->SaveState())
+      {
+      std::cerr << __LINE__ << ": Failed to save state " << editIndex << std::endl;
+      return EXIT_FAILURE;
+      }
+    vtkSmartPointer<vtkOrientedImageData> savedLabelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+    savedLabelmap->DeepCopy(GetLabelmap(segmentation, "Segment_1"));
+    savedLabelmaps.push_back(savedLabelmap);
+    }
+  if (history->GetNumberOfStates() != NUMBER_OF_EDITS + 1)
+    {
+    std::cerr << __LINE__ << ": Unexpected number of states: " << history->GetNumberOfStates() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Shared labelmap is stored once per state and only the changed regions are stored after the first state.
+  // In addition, one decoded copy of the shared labelmap of the last state is kept.
+  unsigned long memorySize = history->GetMemorySize();
+  std::cout << "Memory size of " << history->GetNumberOfStates() << " states: " << memorySize << "kiB"
+    << " (labelmap: " << labelmapMemorySize << "kiB)" << std::endl;
+  if (memorySize < labelmapMemorySize || (memorySize - labelmapMemorySize) * 10 > labelmapMemorySize)
+    {
+    std::cerr << __LINE__ << ": Saved states use too much memory: " << memorySize << "kiB" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Undo all edits
+  for (int editIndex = NUMBER_OF_EDITS - 1; editIndex >= 0; --editIndex)
+    {
+    if (!history->RestorePreviousState())
+      {
+      std::cerr << __LINE__ << ": Failed to restore state " << editIndex << std::endl;
+      return EXIT_FAILURE;
+      }
+    if (GetLabelmap(segmentation, "Segment_1") != GetLabelmap(segmentation, "Segment_2"))
+      {
+      std::cerr << __LINE__ << ": Restored segments do not share the labelmap" << std::endl;
+      return EXIT_FAILURE;
+      }
+    if (!AreLabelmapsEqual(GetLabelmap(segmentation, "Segment_1"), savedLabelmaps[editIndex]))
+      {
+      std::cerr << __LINE__ << ": Restored labelmap differs from saved labelmap " << editIndex << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Redo all edits
+  for (int editIndex = 1; editIndex <= NUMBER_OF_EDITS; ++editIndex)
+    {
+    if (!history->RestoreNextState())
+      {
+      std::cerr << __LINE__ << ": Failed to restore state " << editIndex << std::endl;
+      return EXIT_FAILURE;
+      }
+    if (!AreLabelmapsEqual(GetLabelmap(segmentation, "Segment_1"), savedLabelmaps[editIndex]))
+      {
+      std::cerr << __LINE__ << ": Restored labelmap differs from saved labelmap " << editIndex << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Memory limit removes the oldest states, remaining states can still be restored
+  const unsigned long maximumMemorySize = labelmapMemorySize + (memorySize - labelmapMemorySize) / 2;
+  history->SetMaximumMemorySize(maximumMemorySize);
+  if (history->GetNumberOfStates() >= NUMBER_OF_EDITS + 1 || history->GetNumberOfStates() < 1)
+    {
+    std::cerr << __LINE__ << ": Memory limit is not applied, number of states: " << history->GetNumberOfStates() << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (history->GetMemorySize() > maximumMemorySize && history->GetNumberOfStates() > 1)
+    {
+    std::cerr << __LINE__ << ": Memory limit is exceeded: " << history->GetMemorySize() << "kiB" << std::endl;
+    return EXIT_FAILURE;
+    }
+  int firstRemainingState = NUMBER_OF_EDITS + 1 - history->GetNumberOfStates();
+  for (int editIndex = NUMBER_OF_EDITS - 1; editIndex >= firstRemainingState; --editIndex)
+    {
+    if (!history->RestorePreviousState()
+      || !AreLabelmapsEqual(GetLabelmap(segmentation, "Segment_1"), savedLabelmaps[editIndex]))
+      {
+      std::cerr << __LINE__ << ": Failed to restore state " << editIndex << " after applying memory limit" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  if (history->IsRestorePreviousStateAvailable())
+    {
+    std::cerr << __LINE__ << ": Removed state is still available" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,253 @@
+/*==============================================================================
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkTimerLog.h>
+
+// SegmentationCore includes
+#include "vtkBinaryLabelmapToClosedSurfaceConversionRule.h"
+#include "vtkClosedSurfaceToBinaryLabelmapConversionRule.h"
+#include "vtkOrientedImageData.h"
+#include "vtkSegment.h"
+#include "vtkSegmentation.h"
+#include "vtkSegmentationConverter.h"
+#include "vtkSegmentationConverterFactory.h"
+
+// STD includes
+#include <cstring>
+#include <sstream>
+
+namespace
+{
+
+const int NUMBER_OF_SEGMENTS = 12;
+
+//----------------------------------------------------------------------------
+void CreateSphereSegmentation(vtkSegmentation* segmentation)
+{
+  segmentation->SetMasterRepresentationName(
+    vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName());
+  for (int segmentIndex = 0; segmentIndex < NUMBER_OF_SEGMENTS; ++segmentIndex)
+    {
+    vtkNew<vtkSphereSource> sphere;
+    sphere->SetCenter(20.0 * (segmentIndex % 4), 20.0 * (segmentIndex / 4), 0.0);
+    sphere->SetRadius(8.0 + segmentIndex % 3);
+    sphere->SetThetaResolution(32);
+    sphere->SetPhiResolution(32);
+    sphere->Update();
+
+    vtkNew<vtkSegment> segment;
+    std::stringstream ss;
+    ss << "sphere" << segmentIndex;
+    segment->SetName(ss.str().c_str());
+    segment->AddRepresentation(
+      vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName(), sphere->GetOutput());
+    segmentation->AddSegment(segment);
+    }
+  // Use a common geometry so that collapsing labelmaps is exercised as well
+  segmentation->SetConversionParameter(vtkSegmentationConverter::GetReferenceImageGeometryParameterName(),
+    "0.5;0;0;-15;0;0.5;0;-15;0;0;0.5;-15;0;0;0;1;0;160;0;110;0;60;");
+}
+
+//----------------------------------------------------------------------------
+bool AreLabelmapsEqual(vtkOrientedImageData* labelmap1, vtkOrientedImageData* labelmap2)
+{
+  if (!labelmap1 || !labelmap2)
+    {
+    return false;
+    }
+  if (vtkSegmentationConverter::SerializeImageGeometry(labelmap1)
+    != vtkSegmentationConverter::SerializeImageGeometry(labelmap2))
+    {
+    return false;
+    }
+  if (labelmap1->GetScalarType() != labelmap2->GetScalarType()
+    || labelmap1->GetNumberOfScalarComponents() != labelmap2->GetNumberOfScalarComponents())
+    {
+    return false;
+    }
+  int* extent = labelmap1->GetExtent();
+  if (extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5])
+    {
+    return true;
+    }
+  size_t size = static_cast<size_t>(labelmap1->GetNumberOfPoints())
+    * labelmap1->GetScalarSize() * labelmap1->GetNumberOfScalarComponents();
+  return memcmp(labelmap1->GetScalarPointer(), labelmap2->GetScalarPointer(), size) == 0;
+}
+
+//----------------------------------------------------------------------------
+bool ArePolyDataEqual(vtkPolyData* polyData1, vtkPolyData* polyData2)
+{
+  if (!polyData1 || !polyData2)
+    {
+    return false;
+    }
+  if (polyData1->GetNumberOfPoints() != polyData2->GetNumberOfPoints()
+    || polyData1->GetNumberOfCells() != polyData2->GetNumberOfCells())
+    {
+    return false;
+    }
+  for (vtkIdType pointIndex = 0; pointIndex < polyData1->GetNumberOfPoints(); ++pointIndex)
+    {
+    double* point1 = polyData1->GetPoint(pointIndex);
+    double point2[3] = { 0.0, 0.0, 0.0 };
+    polyData2->GetPoint(pointIndex, point2);
+    if (point1[0] != point2[0] || point1[1] != point2[1] || point1[2] != point2[2])
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int ConvertAndCompare(const std::string& targetRepresentationName, vtkSegmentation* serialSegmentation,
+  vtkSegmentation* parallelSegmentation)
+{
+  vtkNew<vtkTimerLog> timer;
+
+  serialSegmentation->SetParallelConversion(false);
+  timer->StartTimer();
+  if (!serialSegmentation->CreateRepresentation(targetRepresentationName, true))
+    {
+    std::cerr << __LINE__ << ": Serial conversion to " << targetRepresentationName << " failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+  timer->StopTimer();
+  std::cout << targetRepresentationName << " serial conversion time: " << timer->GetElapsedTime() << "s" << std::endl;
+
+  parallelSegmentation->SetParallelConversion(true);
+  timer->StartTimer();
+  if (!parallelSegmentation->CreateRepresentation(targetRepresentationName, true))
+    {
+    std::cerr << __LINE__ << ": Parallel conversion to " << targetRepresentationName << " failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+  timer->StopTimer();
+  std::cout << targetRepresentationName << " parallel conversion time: " << timer->GetElapsedTime() << "s" << std::endl;
+
+  std::vector<std::string> segmentIDs;
+  serialSegmentation->GetSegmentIDs(segmentIDs);
+  for (const std::string& segmentID : segmentIDs)
+    {
+    vtkSegment* serialSegment = serialSegmentation->GetSegment(segmentID);
+    vtkSegment* parallelSegment = parallelSegmentation->GetSegment(segmentID);
+    if (!serialSegment || !parallelSegment)
+      {
+      std::cerr << __LINE__ << ": Segment " << segmentID << " not found" << std::endl;
+      return EXIT_FAILURE;
+      }
+    if (serialSegment->GetLabelValue() != parallelSegment->GetLabelValue())
+      {
+      std::cerr << __LINE__ << ": Label value mismatch in segment " << segmentID << std::endl;
+      return EXIT_FAILURE;
+      }
+    vtkDataObject* serialRepresentation = serialSegment->GetRepresentation(targetRepresentationName);
+    vtkDataObject* parallelRepresentation = parallelSegment->GetRepresentation(targetRepresentationName);
+    bool equal = false;
+    if (targetRepresentationName == vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName())
+      {
+      equal = AreLabelmapsEqual(vtkOrientedImageData::SafeDownCast(serialRepresentation),
+        vtkOrientedImageData::SafeDownCast(parallelRepresentation));
+      }
+    else
+      {
+      equal = ArePolyDataEqual(vtkPolyData::SafeDownCast(serialRepresentation),
+        vtkPolyData::SafeDownCast(parallelRepresentation));
+      }
+    if (!equal)
+      {
+      std::cerr << __LINE__ << ": Parallel conversion result differs from serial conversion in segment "
+        << segmentID << " (" << targetRepresentationName << ")" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkSegmentationParallelConversionTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkSegmentationConverterFactory::GetInstance()->RegisterConverterRule(
+    vtkSmartPointer<vtkBinaryLabelmapToClosedSurfaceConversionRule>::New());
+  vtkSegmentationConverterFactory::GetInstance()->RegisterConverterRule(
+    vtkSmartPointer<vtkClosedSurfaceToBinaryLabelmapConversionRule>::New());
+
+  vtkNew<vtkSegmentation> serialSegmentation;
+  CreateSphereSegmentation(serialSegmentation);
+  vtkNew<vtkSegmentation> parallelSegmentation;
+  CreateSphereSegmentation(parallelSegmentation);
+
+  // Closed surface -> binary labelmap (labelmaps are collapsed into shared layers in PostConvert)
+  if (ConvertAndCompare(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName(),
+    serialSegmentation, parallelSegmentation) != EXIT_SUCCESS)
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Binary labelmap -> closed surface from shared labelmaps
+  serialSegmentation->SetMasterRepresentationName(
+    vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName());
+  parallelSegmentation->SetMasterRepresentationName(
+    vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName());
+  if (ConvertAndCompare(vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName(),
+    serialSegmentation, parallelSegmentation) != EXIT_SUCCESS)
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Binary labelmap -> closed surface with joint smoothing
+  serialSegmentation->SetConversionParameter(
+    vtkBinaryLabelmapToClosedSurfaceConversionRule::GetJointSmoothingParameterName(), "1");
+  parallelSegmentation->SetConversionParameter(
+    vtkBinaryLabelmapToClosedSurfaceConversionRule::GetJointSmoothingParameterName(), "1");
+  if (ConvertAndCompare(vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName(),
+    serialSegmentation, parallelSegmentation) != EXIT_SUCCESS)
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Closed surface -> binary labelmap again, replacing the existing labelmaps
+  // (target representations are replaced before the segments are converted in parallel)
+  serialSegmentation->SetMasterRepresentationName(
+    vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName());
+  parallelSegmentation->SetMasterRepresentationName(
+    vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName());
+  vtkSegment* firstParallelSegment = parallelSegmentation->GetNthSegment(0);
+  vtkSmartPointer<vtkDataObject> previousLabelmap = firstParallelSegment->GetRepresentation(
+    vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName());
+  if (ConvertAndCompare(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName(),
+    serialSegmentation, parallelSegmentation) != EXIT_SUCCESS)
+    {
+    return EXIT_FAILURE;
+    }
+  if (firstParallelSegment->GetRepresentation(
+    vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName()) == previousLabelmap.GetPointer())
+    {
+    std::cerr << __LINE__ << ": Binary labelmap representation was not replaced by parallel conversion" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Parallel conversion test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
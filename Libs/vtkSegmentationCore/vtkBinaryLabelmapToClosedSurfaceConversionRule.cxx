@@ -63,6 +63,10 @@
 #include <vtkExtractSelection.h>
 #include <vtkSelectionSource.h>
 
+// STD includes
+#include <array>
+#include <mutex>
+
 //----------------------------------------------------------------------------
 vtkSegmentationConverterRuleNewMacro(vtkBinaryLabelmapToClosedSurfaceConversionRule);
 
@@ -150,12 +154,33 @@ bool vtkBinaryLabelmapToClosedSurfaceConversionRule::Convert(vtkSegment* segment
     return false;
     }
 
-  double smoothingFactor = vtkVariant(this->ConversionParameters[GetSmoothingFactorParameterName()].first).ToDouble();
-  int jointSmoothing = vtkVariant(this->ConversionParameters[GetJointSmoothingParameterName()].first).ToInt();
+  double smoothingFactor = vtkVariant(this->GetConversionParameter(GetSmoothingFactorParameterName())).ToDouble();
+  int jointSmoothing = vtkVariant(this->GetConversionParameter(GetJointSmoothingParameterName())).ToInt();
 
   if (jointSmoothing > 0 && smoothingFactor > 0)
     {
-    if (this->JointSmoothCache.find(orientedBinaryLabelmap) == this->JointSmoothCache.end())
+    // Convert may be called concurrently for segments sharing the same labelmap,
+    // the joint smoothed surface must be computed only once. The first segment of the layer
+    // computes it, the others wait for its result. Segments of other layers are not blocked.
+    std::promise<vtkSmartPointer<vtkPolyData> > jointSmoothedSurfacePromise;
+    std::shared_future<vtkSmartPointer<vtkPolyData> > jointSmoothedSurfaceFuture;
+    bool computeJointSmoothedSurface = false;
+      {
+      std::lock_guard<std::mutex> jointSmoothCacheLock(this->JointSmoothCacheMutex);
+      auto cacheIt = this->JointSmoothCache.find(orientedBinaryLabelmap);
+      if (cacheIt == this->JointSmoothCache.end())
+        {
+        jointSmoothedSurfaceFuture = jointSmoothedSurfacePromise.get_future().share();
+        this->JointSmoothCache[orientedBinaryLabelmap] = jointSmoothedSurfaceFuture;
+        computeJointSmoothedSurface = true;
+        }
+      else
+        {
+        jointSmoothedSurfaceFuture = cacheIt->second;
+        }
+      }
+
+    if (computeJointSmoothedSurface)
       {
       double* scalarRange = orientedBinaryLabelmap->GetScalarRange();
       int lowLabel = (int)(floor(scalarRange[0]));
@@ -182,15 +207,21 @@ bool vtkBinaryLabelmapToClosedSurfaceConversionRule::Convert(vtkSegment* segment
 
       vtkSmartPointer<vtkPolyData> jointSmoothedSurface = vtkSmartPointer<vtkPolyData>::New();
       this->CreateClosedSurface(orientedBinaryLabelmap, jointSmoothedSurface, labelValues);
-      this->JointSmoothCache[orientedBinaryLabelmap] = jointSmoothedSurface;
+      jointSmoothedSurfacePromise.set_value(jointSmoothedSurface);
       }
 
-    vtkDataObject* sharedSurface = this->JointSmoothCache[orientedBinaryLabelmap];
-    if (!sharedSurface)
+    vtkPolyData* cachedSurface = jointSmoothedSurfaceFuture.get();
+    if (!cachedSurface)
       {
       vtkErrorMacro("Convert: Could not find cached surface");
       return false;
       }
+    // Use a shallow copy as filter input so that the cached surface is not modified by the pipeline
+    vtkNew<vtkPolyData> sharedSurface;
+      {
+      std::lock_guard<std::mutex> jointSmoothCacheLock(this->JointSmoothCacheMutex);
+      sharedSurface->ShallowCopy(cachedSurface);
+      }
 
     vtkNew<vtkSelectionSource> selection;
     selection->SetContentType(vtkSelectionNode::THRESHOLDS);
@@ -211,8 +242,13 @@ bool vtkBinaryLabelmapToClosedSurfaceConversionRule::Convert(vtkSegment* segment
     }
   else
     {
+    // Extents of all labels of the labelmap are computed in a single pass over the voxels,
+    // then only the region of the segment's label is contoured.
+    int labelExtent[6] = { 0, -1, 0, -1, 0, -1 };
+    bool labelExtentValid = this->GetLabelExtent(orientedBinaryLabelmap, segment->GetLabelValue(), labelExtent);
     std::vector<int> labelValue = { segment->GetLabelValue() };
-    this->CreateClosedSurface(orientedBinaryLabelmap, closedSurfacePolyData, labelValue);
+    this->CreateClosedSurface(orientedBinaryLabelmap, closedSurfacePolyData, labelValue,
+      labelExtentValid ? labelExtent : nullptr);
     }
 
   // Remove "ImageScalars" array because having a scalar in a model would get that
@@ -228,7 +264,7 @@ bool vtkBinaryLabelmapToClosedSurfaceConversionRule::Convert(vtkSegment* segment
 
 //----------------------------------------------------------------------------
 bool vtkBinaryLabelmapToClosedSurfaceConversionRule::CreateClosedSurface(vtkOrientedImageData* orientedBinaryLabelmap,
-  vtkPolyData* closedSurfacePolyData, std::vector<int> labelValues)
+  vtkPolyData* closedSurfacePolyData, std::vector<int> labelValues, int* labelExtent/*=nullptr*/)
 {
   if (!closedSurfacePolyData)
     {
@@ -243,7 +279,10 @@ bool vtkBinaryLabelmapToClosedSurfaceConversionRule::CreateClosedSurface(vtkOrie
     return false;
     }
 
-  vtkSmartPointer<vtkImageData> binaryLabelmap = orientedBinaryLabelmap;
+  // Labelmaps may be shared between segments that are converted concurrently. Use a shallow copy
+  // as filter input so that the shared labelmap is not modified by the pipeline.
+  vtkSmartPointer<vtkImageData> binaryLabelmap = vtkSmartPointer<vtkImageData>::New();
+  binaryLabelmap->ShallowCopy(orientedBinaryLabelmap);
   if (!binaryLabelmap)
     {
     vtkErrorMacro("Convert: Source representation is not data");
@@ -262,10 +301,27 @@ bool vtkBinaryLabelmapToClosedSurfaceConversionRule::CreateClosedSurface(vtkOrie
     return true;
     }
 
+  if (labelExtent)
+    {
+    if (labelExtent[0] > labelExtent[1] || labelExtent[2] > labelExtent[3] || labelExtent[4] > labelExtent[5])
+      {
+      vtkDebugMacro("Convert: No polygons can be created, label extent is empty");
+      closedSurfacePolyData->Initialize();
+      return true;
+      }
+    // Crop the labelmap to the label extent with a 1 voxel background margin, which also closes the surface
+    // at the image boundary. Voxel indices are preserved, therefore the output is the same as contouring
+    // the entire labelmap.
+    vtkSmartPointer<vtkImageConstantPad> cropper = vtkSmartPointer<vtkImageConstantPad>::New();
+    cropper->SetInputData(binaryLabelmap);
+    cropper->SetOutputWholeExtent(labelExtent[0] - 1, labelExtent[1] + 1, labelExtent[2] - 1, labelExtent[3] + 1,
+      labelExtent[4] - 1, labelExtent[5] + 1);
+    cropper->Update();
+    binaryLabelmap = cropper->GetOutput();
+    }
   /// If input labelmap has non-background border voxels, then those regions remain open in the output closed surface.
   /// This function adds a 1 voxel padding to the labelmap in these cases.
-  bool paddingNecessary = this->IsLabelmapPaddingNecessary(binaryLabelmap);
-  if (paddingNecessary)
+  else if (this->IsLabelmapPaddingNecessary(binaryLabelmap))
     {
     vtkSmartPointer<vtkImageConstantPad> padder = vtkSmartPointer<vtkImageConstantPad>::New();
     padder->SetInputData(binaryLabelmap);
@@ -285,9 +341,9 @@ bool vtkBinaryLabelmapToClosedSurfaceConversionRule::CreateClosedSurface(vtkOrie
   binaryLabelmapWithIdentityGeometry->SetSpacing(1.0, 1.0, 1.0);
 
   // Get conversion parameters
-  double decimationFactor = vtkVariant(this->ConversionParameters[GetDecimationFactorParameterName()].first).ToDouble();
-  double smoothingFactor = vtkVariant(this->ConversionParameters[GetSmoothingFactorParameterName()].first).ToDouble();
-  int computeSurfaceNormals = vtkVariant(this->ConversionParameters[GetComputeSurfaceNormalsParameterName()].first).ToInt();
+  double decimationFactor = vtkVariant(this->GetConversionParameter(GetDecimationFactorParameterName())).ToDouble();
+  double smoothingFactor = vtkVariant(this->GetConversionParameter(GetSmoothingFactorParameterName())).ToDouble();
+  int computeSurfaceNormals = vtkVariant(this->GetConversionParameter(GetComputeSurfaceNormalsParameterName())).ToInt();
 
   vtkNew<vtkDiscreteFlyingEdges3D> marchingCubes;
   marchingCubes->SetInputData(binaryLabelmapWithIdentityGeometry);
@@ -387,7 +443,102 @@ bool vtkBinaryLabelmapToClosedSurfaceConversionRule::CreateClosedSurface(vtkOrie
 //----------------------------------------------------------------------------
 bool vtkBinaryLabelmapToClosedSurfaceConversionRule::PostConvert(vtkSegmentation* vtkNotUsed(segmentation))
 {
+  std::lock_guard<std::mutex> jointSmoothCacheLock(this->JointSmoothCacheMutex);
   this->JointSmoothCache.clear();
+  std::lock_guard<std::mutex> labelExtentCacheLock(this->LabelExtentCacheMutex);
+  this->LabelExtentCache.clear();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+template<class ImageScalarType>
+void ComputeLabelExtentsGeneric(vtkImageData* labelmap, std::map<int, std::array<int, 6> >& labelExtents)
+{
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  labelmap->GetExtent(extent);
+  ImageScalarType* imagePtr = static_cast<ImageScalarType*>(labelmap->GetScalarPointerForExtent(extent));
+  if (!imagePtr)
+    {
+    return;
+    }
+  std::array<int, 6>* currentLabelExtent = nullptr;
+  ImageScalarType currentLabel = 0;
+  for (int k = extent[4]; k <= extent[5]; ++k)
+    {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+      {
+      for (int i = extent[0]; i <= extent[1]; ++i, ++imagePtr)
+        {
+        ImageScalarType voxelValue = *imagePtr;
+        if (voxelValue == 0)
+          {
+          continue;
+          }
+        if (!currentLabelExtent || voxelValue != currentLabel)
+          {
+          // Voxels of the same label are typically next to each other, so the map is only searched
+          // when the label changes
+          currentLabel = voxelValue;
+          std::map<int, std::array<int, 6> >::iterator labelExtentIt = labelExtents.find(static_cast<int>(voxelValue));
+          if (labelExtentIt == labelExtents.end())
+            {
+            std::array<int, 6> newLabelExtent = { { i, i, j, j, k, k } };
+            labelExtentIt = labelExtents.insert(std::make_pair(static_cast<int>(voxelValue), newLabelExtent)).first;
+            }
+          currentLabelExtent = &(labelExtentIt->second);
+          }
+        std::array<int, 6>& labelExtent = *currentLabelExtent;
+        if (i < labelExtent[0]) { labelExtent[0] = i; }
+        if (i > labelExtent[1]) { labelExtent[1] = i; }
+        if (j < labelExtent[2]) { labelExtent[2] = j; }
+        if (j > labelExtent[3]) { labelExtent[3] = j; }
+        if (k < labelExtent[4]) { labelExtent[4] = k; }
+        if (k > labelExtent[5]) { labelExtent[5] = k; }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkBinaryLabelmapToClosedSurfaceConversionRule::GetLabelExtent(vtkOrientedImageData* labelmap, int labelValue, int labelExtent[6])
+{
+  labelExtent[0] = 0;
+  labelExtent[1] = -1;
+  labelExtent[2] = 0;
+  labelExtent[3] = -1;
+  labelExtent[4] = 0;
+  labelExtent[5] = -1;
+  if (!labelmap || !labelmap->GetPointData() || !labelmap->GetPointData()->GetScalars()
+    || labelmap->GetNumberOfScalarComponents() != 1)
+    {
+    return false;
+    }
+
+  std::lock_guard<std::mutex> labelExtentCacheLock(this->LabelExtentCacheMutex);
+  LabelExtentCacheType::iterator cacheIt = this->LabelExtentCache.find(labelmap);
+  if (cacheIt == this->LabelExtentCache.end())
+    {
+    std::map<int, std::array<int, 6> > labelExtents;
+    switch (labelmap->GetScalarType())
+      {
+      vtkTemplateMacro(ComputeLabelExtentsGeneric<VTK_TT>(labelmap, labelExtents));
+      default:
+        vtkErrorMacro("GetLabelExtent: Unknown image scalar type!");
+        return false;
+      }
+    cacheIt = this->LabelExtentCache.insert(std::make_pair(labelmap, labelExtents)).first;
+    }
+
+  std::map<int, std::array<int, 6> >::iterator labelExtentIt = cacheIt->second.find(labelValue);
+  if (labelExtentIt == cacheIt->second.end())
+    {
+    // label is not present in the labelmap
+    return true;
+    }
+  for (int i = 0; i < 6; ++i)
+    {
+    labelExtent[i] = labelExtentIt->second[i];
+    }
   return true;
 }
 
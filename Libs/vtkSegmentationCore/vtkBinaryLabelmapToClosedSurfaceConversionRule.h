@@ -30,6 +30,11 @@
 // VTK includes
 #include <vtkPolyData.h>
 
+// STD includes
+#include <array>
+#include <future>
+#include <mutex>
+
 /// \ingroup SegmentationCore
 /// \brief Convert binary labelmap representation (vtkOrientedImageData type) to
 ///   closed surface representation (vtkPolyData type). The conversion algorithm
@@ -66,7 +71,17 @@ public:
   vtkDataObject* ConstructRepresentationObjectByClass(std::string className) override;
 
   /// Perform the actual binary labelmap to closed surface conversion
-  bool CreateClosedSurface(vtkOrientedImageData* inputImage, vtkPolyData* outputPolydata, std::vector<int> values);
+  /// \param labelExtent If specified then only this region of the input image is contoured. All voxels
+  ///   of the label values must be within this extent.
+  bool CreateClosedSurface(vtkOrientedImageData* inputImage, vtkPolyData* outputPolydata, std::vector<int> values,
+    int* labelExtent=nullptr);
+
+  /// Get the extent of the voxels that have the specified label value in the labelmap.
+  /// The extents of all the labels are computed in a single pass over the labelmap and
+  /// cached until PostConvert, so that segments of a shared labelmap only contour their own region.
+  /// An empty extent is returned if the label is not found.
+  /// Returns false if the extent cannot be computed (the entire labelmap has to be contoured then).
+  bool GetLabelExtent(vtkOrientedImageData* labelmap, int labelValue, int labelExtent[6]);
 
   /// Update the target representation based on the source representation
   bool Convert(vtkSegment* segment) override;
@@ -75,6 +90,9 @@ public:
   /// Clears the joint smoothing cache
   bool PostConvert(vtkSegmentation* segmentation) override;
 
+  /// Segments can be converted concurrently. Access to the joint smoothing cache is synchronized.
+  bool IsReentrant() override { return true; };
+
   /// Get the cost of the conversion.
   unsigned int GetConversionCost(vtkDataObject* sourceRepresentation=nullptr, vtkDataObject* targetRepresentation=nullptr) override;
 
@@ -98,8 +116,18 @@ protected:
 
 protected:
   /// Cache for storing merged closed surfaces that have been joint smoothed
-  /// The key used is the binary labelmap representation, which maps to the combined vtkPolyData containing surfaces for all segments in the segmentation
-  std::map<vtkOrientedImageData*, vtkSmartPointer<vtkPolyData> > JointSmoothCache;
+  /// The key used is the binary labelmap representation, which maps to the combined vtkPolyData containing surfaces for all segments in the segmentation.
+  /// The surface is provided as a future so that segments of the same layer wait for the conversion that is already in progress.
+  std::map<vtkOrientedImageData*, std::shared_future<vtkSmartPointer<vtkPolyData> > > JointSmoothCache;
+  /// Protects JointSmoothCache when segments are converted concurrently. Not held while a surface is computed.
+  std::mutex JointSmoothCacheMutex;
+
+  /// Cache for storing extent of each label value of the binary labelmap representations
+  /// The key used is the binary labelmap representation, which maps to the extent (IJK) of each label value
+  typedef std::map<vtkOrientedImageData*, std::map<int, std::array<int, 6> > > LabelExtentCacheType;
+  LabelExtentCacheType LabelExtentCache;
+  /// Protects LabelExtentCache when segments are converted concurrently
+  std::mutex LabelExtentCacheMutex;
 
 private:
   vtkBinaryLabelmapToClosedSurfaceConversionRule(const vtkBinaryLabelmapToClosedSurfaceConversionRule&) = delete;
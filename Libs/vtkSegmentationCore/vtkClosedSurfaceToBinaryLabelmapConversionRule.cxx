@@ -124,16 +124,20 @@ vtkDataObject* vtkClosedSurfaceToBinaryLabelmapConversionRule::ConstructRepresen
 bool vtkClosedSurfaceToBinaryLabelmapConversionRule::Convert(vtkSegment* segment)
 {
   vtkSmartPointer<vtkOrientedImageData> outputGeometryLabelmap = vtkOrientedImageData::SafeDownCast(
-    segment->GetRepresentation(this->GetTargetRepresentationName()));
+    this->GetPreviousTargetRepresentation(segment));
   this->CreateTargetRepresentation(segment);
 
   // Check validity of source and target representation objects
-  vtkPolyData* closedSurfacePolyData = vtkPolyData::SafeDownCast(segment->GetRepresentation(this->GetSourceRepresentationName()));
-  if (!closedSurfacePolyData)
+  vtkPolyData* sourcePolyData = vtkPolyData::SafeDownCast(segment->GetRepresentation(this->GetSourceRepresentationName()));
+  if (!sourcePolyData)
     {
     vtkErrorMacro("Convert: Source representation is not a poly data!");
     return false;
     }
+  // Segments may be converted concurrently. Use a shallow copy as filter input
+  // so that the source representation is not modified by the pipeline.
+  vtkNew<vtkPolyData> closedSurfacePolyData;
+  closedSurfacePolyData->ShallowCopy(sourcePolyData);
 
   if (closedSurfacePolyData->GetNumberOfPoints() < 2 || closedSurfacePolyData->GetNumberOfCells() < 2)
     {
@@ -255,7 +259,7 @@ bool vtkClosedSurfaceToBinaryLabelmapConversionRule::Convert(vtkSegment* segment
 //----------------------------------------------------------------------------
 bool vtkClosedSurfaceToBinaryLabelmapConversionRule::PostConvert(vtkSegmentation* segmentation)
 {
-  int collapseLabelmaps = vtkVariant(this->ConversionParameters[GetCollapseLabelmapsParameterName()].first).ToInt();
+  int collapseLabelmaps = vtkVariant(this->GetConversionParameter(GetCollapseLabelmapsParameterName())).ToInt();
   if (collapseLabelmaps > 0)
     {
     segmentation->CollapseBinaryLabelmaps(false);
@@ -278,7 +282,7 @@ bool vtkClosedSurfaceToBinaryLabelmapConversionRule::CalculateOutputGeometry(vtk
     }
 
   // Get reference image geometry from parameters
-  std::string geometryString = this->ConversionParameters[vtkSegmentationConverter::GetReferenceImageGeometryParameterName()].first;
+  std::string geometryString = this->GetConversionParameter(vtkSegmentationConverter::GetReferenceImageGeometryParameterName());
   if (geometryString.empty() || !vtkSegmentationConverter::DeserializeImageGeometry(geometryString, geometryImageData))
     {
     geometryString = this->GetDefaultImageGeometryStringForPolyData(closedSurfacePolyData);
@@ -299,7 +303,7 @@ bool vtkClosedSurfaceToBinaryLabelmapConversionRule::CalculateOutputGeometry(vtk
     }
 
   // Get oversampling factor
-  std::string oversamplingString = this->ConversionParameters[GetOversamplingFactorParameterName()].first;
+  std::string oversamplingString = this->GetConversionParameter(GetOversamplingFactorParameterName());
   double oversamplingFactor = 1.0;
   if (!oversamplingString.compare("A"))
     {
@@ -334,7 +338,7 @@ bool vtkClosedSurfaceToBinaryLabelmapConversionRule::CalculateOutputGeometry(vtk
 
   int cropToReferenceImageGeometry = 0;
     {
-    std::string cropToReferenceImageGeometryString = this->ConversionParameters[GetCropToReferenceImageGeometryParameterName()].first;
+    std::string cropToReferenceImageGeometryString = this->GetConversionParameter(GetCropToReferenceImageGeometryParameterName());
     std::stringstream ss;
     ss << cropToReferenceImageGeometryString;
     ss >> cropToReferenceImageGeometry;
@@ -69,6 +69,9 @@ public:
   /// Collapses the segments to as few labelmaps as is possible
   bool PostConvert(vtkSegmentation* segmentation) override;
 
+  /// Segments can be converted concurrently, each segment gets its own target labelmap
+  bool IsReentrant() override { return true; };
+
   /// Get the cost of the conversion.
   unsigned int GetConversionCost(vtkDataObject* sourceRepresentation=nullptr, vtkDataObject* targetRepresentation=nullptr) override;
 
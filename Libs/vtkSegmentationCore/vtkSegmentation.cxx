@@ -40,6 +40,7 @@
 #include <vtkObjectFactory.h>
 #include <vtkPointData.h>
 #include <vtkPolyData.h>
+#include <vtkSMPTools.h>
 #include <vtkStringArray.h>
 #include <vtkTransform.h>
 #include <vtkTransformPolyDataFilter.h>
@@ -70,6 +71,7 @@ vtkSegmentation::vtkSegmentation()
 
   this->MasterRepresentationModifiedEnabled = true;
   this->SegmentModifiedEnabled = true;
+  this->ParallelConversion = true;
 
   this->SegmentIdAutogeneratorIndex = 0;
 
@@ -1035,6 +1037,7 @@ bool vtkSegmentation::ConvertSegmentsUsingPath(std::vector<std::string> segmentI
 
     // Perform conversion step
     currentConversionRule->PreConvert(this);
+    std::vector<vtkSegment*> segmentsToConvert;
     for (auto segmentID : segmentIDs)
       {
       vtkSegment* segment = this->GetSegment(segmentID);
@@ -1057,7 +1060,19 @@ bool vtkSegmentation::ConvertSegmentsUsingPath(std::vector<std::string> segmentI
         {
         continue;
         }
-      currentConversionRule->Convert(segment);
+      segmentsToConvert.push_back(segment);
+      }
+
+    if (this->ParallelConversion && segmentsToConvert.size() > 1 && currentConversionRule->IsReentrant())
+      {
+      this->ConvertSegmentsInParallel(currentConversionRule, segmentsToConvert);
+      }
+    else
+      {
+      for (vtkSegment* segment : segmentsToConvert)
+        {
+        currentConversionRule->Convert(segment);
+        }
       }
     currentConversionRule->PostConvert(this);
 
@@ -1066,6 +1081,43 @@ bool vtkSegmentation::ConvertSegmentsUsingPath(std::vector<std::string> segmentI
   return true;
 }
 
+//-----------------------------------------------------------------------------
+void vtkSegmentation::ConvertSegmentsInParallel(vtkSegmentationConverterRule* rule, const std::vector<vtkSegment*>& segments)
+{
+  // Segment modified events are processed by the segmentation (updating observers), which must not
+  // happen in worker threads. Observation is suspended during conversion and segments that were
+  // modified are notified from the calling thread when all segments are converted.
+  bool wasSegmentModifiedEnabled = this->SetSegmentModifiedEnabled(false);
+
+  std::vector<vtkMTimeType> segmentMTimesBefore;
+  for (vtkSegment* segment : segments)
+    {
+    segmentMTimesBefore.push_back(segment->GetMTime());
+    }
+
+  // Target representations are created (or replaced) in the calling thread, as adding a representation
+  // to a segment invokes a modified event. Convert does not add representations to segments then.
+  rule->BeginParallelConversion(segments);
+  vtkSMPTools::For(0, static_cast<vtkIdType>(segments.size()),
+    [&](vtkIdType firstSegmentIndex, vtkIdType endSegmentIndex)
+    {
+    for (vtkIdType segmentIndex = firstSegmentIndex; segmentIndex < endSegmentIndex; ++segmentIndex)
+      {
+      rule->Convert(segments[segmentIndex]);
+      }
+    });
+  rule->EndParallelConversion();
+
+  this->SetSegmentModifiedEnabled(wasSegmentModifiedEnabled);
+  for (size_t segmentIndex = 0; segmentIndex < segments.size(); ++segmentIndex)
+    {
+    if (segments[segmentIndex]->GetMTime() > segmentMTimesBefore[segmentIndex])
+      {
+      segments[segmentIndex]->Modified();
+      }
+    }
+}
+
 //-----------------------------------------------------------------------------
 bool vtkSegmentation::ConvertSegmentUsingPath(vtkSegment* segment, vtkSegmentationConverter::ConversionPathType path, bool overwriteExisting/*=false*/)
 {
@@ -470,6 +470,13 @@ public:
 
 // Get/set methods
 
+  /// If enabled (default) then segments are converted concurrently
+  /// when the conversion rule supports it (see vtkSegmentationConverterRule::IsReentrant).
+  /// The result is the same as with sequential conversion.
+  vtkGetMacro(ParallelConversion, bool);
+  vtkSetMacro(ParallelConversion, bool);
+  vtkBooleanMacro(ParallelConversion, bool);
+
   /// Get master representation name
   vtkGetMacro(MasterRepresentationName, std::string);
   /// Set master representation name.
@@ -493,6 +500,10 @@ protected:
   /// \return Success flag
   bool ConvertSegmentUsingPath(vtkSegment* segment, vtkSegmentationConverter::ConversionPathType path, bool overwriteExisting = false);
 
+  /// Convert segments with a reentrant conversion rule using multiple threads.
+  /// Must be called between PreConvert and PostConvert of the rule.
+  void ConvertSegmentsInParallel(vtkSegmentationConverterRule* rule, const std::vector<vtkSegment*>& segments);
+
   /// Converts a single segment to a representation.
   bool ConvertSingleSegment(std::string segmentId, std::string targetRepresentationName);
 
@@ -554,6 +565,9 @@ protected:
   /// Modified events of segments are observed
   bool SegmentModifiedEnabled;
 
+  /// Convert segments concurrently if the conversion rule is reentrant
+  bool ParallelConversion;
+
   /// This number is incremented and used for generating the next
   /// segment ID.
   int SegmentIdAutogeneratorIndex;
@@ -48,6 +48,12 @@ vtkSegmentationConverterRule* vtkSegmentationConverterRule::Clone()
 //----------------------------------------------------------------------------
 bool vtkSegmentationConverterRule::CreateTargetRepresentation(vtkSegment* segment)
 {
+  if (this->ParallelConversion)
+    {
+    // Target representation has been created in BeginParallelConversion, it must not be replaced here
+    return segment->GetRepresentation(this->GetTargetRepresentationName()) != nullptr;
+    }
+
   // Get target representation
   vtkSmartPointer<vtkDataObject> targetRepresentation = segment->GetRepresentation(
     this->GetTargetRepresentationName());
@@ -62,6 +68,45 @@ bool vtkSegmentationConverterRule::CreateTargetRepresentation(vtkSegment* segmen
   return true;
 }
 
+//----------------------------------------------------------------------------
+vtkDataObject* vtkSegmentationConverterRule::GetPreviousTargetRepresentation(vtkSegment* segment)
+{
+  if (this->ParallelConversion)
+    {
+    auto replacedRepresentationIt = this->ReplacedTargetRepresentations.find(segment);
+    if (replacedRepresentationIt != this->ReplacedTargetRepresentations.end())
+      {
+      return replacedRepresentationIt->second;
+      }
+    }
+  return segment->GetRepresentation(this->GetTargetRepresentationName());
+}
+
+//----------------------------------------------------------------------------
+void vtkSegmentationConverterRule::BeginParallelConversion(const std::vector<vtkSegment*>& segments)
+{
+  this->EndParallelConversion();
+  for (vtkSegment* segment : segments)
+    {
+    vtkSmartPointer<vtkDataObject> previousTargetRepresentation = segment->GetRepresentation(
+      this->GetTargetRepresentationName());
+    this->CreateTargetRepresentation(segment);
+    if (previousTargetRepresentation.GetPointer()
+      && previousTargetRepresentation.GetPointer() != segment->GetRepresentation(this->GetTargetRepresentationName()))
+      {
+      this->ReplacedTargetRepresentations[segment] = previousTargetRepresentation;
+      }
+    }
+  this->ParallelConversion = true;
+}
+
+//----------------------------------------------------------------------------
+void vtkSegmentationConverterRule::EndParallelConversion()
+{
+  this->ParallelConversion = false;
+  this->ReplacedTargetRepresentations.clear();
+}
+
 //----------------------------------------------------------------------------
 void vtkSegmentationConverterRule::GetRuleConversionParameters(ConversionParameterListType& conversionParameters)
 {
@@ -87,7 +132,14 @@ void vtkSegmentationConverterRule::SetConversionParameter(const std::string& nam
 //----------------------------------------------------------------------------
 std::string vtkSegmentationConverterRule::GetConversionParameter(const std::string& name)
 {
-  return this->ConversionParameters[name].first;
+  // Only look up the parameter (do not insert missing ones) so that
+  // parameters can be read from concurrent Convert calls
+  ConversionParameterListType::const_iterator paramIt = this->ConversionParameters.find(name);
+  if (paramIt == this->ConversionParameters.end())
+    {
+    return "";
+    }
+  return paramIt->second.first;
 }
 
 //----------------------------------------------------------------------------
@@ -25,6 +25,7 @@
 
 // VTK includes
 #include <vtkObject.h>
+#include <vtkSmartPointer.h>
 
 // STD includes
 #include <map>
@@ -96,6 +97,20 @@ public:
   /// This step should be unnecessary if only converting a single segment
   virtual bool PostConvert(vtkSegmentation* vtkNotUsed(segmentation)) { return true; };
 
+  /// Returns true if Convert can be called concurrently from multiple threads for different segments
+  /// (between PreConvert and PostConvert). Rules that return true must not invoke events or modify
+  /// shared state in Convert without synchronization. False by default.
+  virtual bool IsReentrant() { return false; };
+
+  /// Prepare concurrent conversion of the segments (called from the calling thread).
+  /// Adding a representation to a segment invokes events, therefore target representations are
+  /// created (or replaced, if ReplaceTargetRepresentation is set) here and Convert uses them
+  /// instead of creating new ones, until EndParallelConversion is called.
+  void BeginParallelConversion(const std::vector<vtkSegment*>& segments);
+  /// Finish concurrent conversion of segments.
+  /// \sa BeginParallelConversion
+  void EndParallelConversion();
+
   /// Get the cost of the conversion.
   /// \return Expected duration of the conversion in milliseconds. If the arguments are omitted, then a rough average can be
   ///   given just to indicate the relative computational cost of the algorithm. If the objects are given, then a more educated
@@ -136,6 +151,11 @@ protected:
   /// Update the target representation based on the source representation
   virtual bool CreateTargetRepresentation(vtkSegment* segment);
 
+  /// Get the target representation that the segment had before CreateTargetRepresentation was called
+  /// (it is different from the current one if ReplaceTargetRepresentation is set).
+  /// Must be called in Convert before CreateTargetRepresentation.
+  vtkDataObject* GetPreviousTargetRepresentation(vtkSegment* segment);
+
   vtkSegmentationConverterRule();
   ~vtkSegmentationConverterRule() override;
   void operator=(const vtkSegmentationConverterRule&);
@@ -154,6 +174,12 @@ protected:
   /// False by default.
   bool ReplaceTargetRepresentation{false};
 
+  /// Set between BeginParallelConversion and EndParallelConversion.
+  /// CreateTargetRepresentation does not modify segments then.
+  bool ParallelConversion{false};
+  /// Target representations that were replaced in BeginParallelConversion
+  std::map<vtkSegment*, vtkSmartPointer<vtkDataObject> > ReplacedTargetRepresentations;
+
   friend class vtkSegmentationConverter;
 };
 
@@ -22,14 +22,231 @@
 #include "vtkSegmentationHistory.h"
 #include "vtkSegmentationConverterFactory.h"
 #include "vtkSegmentation.h"
+#include "vtkOrientedImageData.h"
 
 // VTK includes
 #include <vtkNew.h>
+#include <vtkMatrix4x4.h>
 #include <vtkObjectFactory.h>
 #include <vtkCallbackCommand.h>
+#include <vtkPointData.h>
 
 // std includes
 #include <algorithm>
+#include <cstring>
+#include <set>
+
+namespace
+{
+
+/// Maximum number of consecutive states that store only the changed region of a labelmap.
+/// The full labelmap is stored again after this, which limits the cost of restoring a state.
+const int MAXIMUM_NUMBER_OF_LABELMAP_BASELINES = 10;
+
+//----------------------------------------------------------------------------
+// Store voxels of the region run-length encoded: runLengths[i] consecutive voxels have the i-th value
+// (of type T) in values. If the runs would take more memory than the voxels then the voxel values
+// are copied as they are and runLengths is left empty.
+template <class T>
+void EncodeLabelmapRegionGeneric(vtkImageData* labelmap, const int region[6],
+  std::vector<unsigned char>& values, std::vector<vtkTypeUInt32>& runLengths)
+{
+  values.clear();
+  runLengths.clear();
+  const vtkIdType rowLength = static_cast<vtkIdType>(region[1] - region[0] + 1) * labelmap->GetNumberOfScalarComponents();
+  const vtkIdType numberOfRows = static_cast<vtkIdType>(region[3] - region[2] + 1) * (region[5] - region[4] + 1);
+  if (rowLength <= 0 || numberOfRows <= 0)
+    {
+    return;
+    }
+  // Encoding is stopped as soon as it becomes larger than the voxel array
+  const size_t rowSize = static_cast<size_t>(rowLength) * sizeof(T);
+  const size_t maximumNumberOfRuns = rowSize * static_cast<size_t>(numberOfRows) / (sizeof(T) + sizeof(vtkTypeUInt32));
+  std::vector<T> runValues;
+  for (int k = region[4]; k <= region[5] && runLengths.size() <= maximumNumberOfRuns; ++k)
+    {
+    for (int j = region[2]; j <= region[3] && runLengths.size() <= maximumNumberOfRuns; ++j)
+      {
+      const T* voxel = static_cast<const T*>(labelmap->GetScalarPointer(region[0], j, k));
+      for (vtkIdType n = 0; n < rowLength; ++n)
+        {
+        if (!runValues.empty() && runValues.back() == voxel[n] && runLengths.back() < VTK_TYPE_UINT32_MAX)
+          {
+          ++runLengths.back();
+          }
+        else
+          {
+          runValues.push_back(voxel[n]);
+          runLengths.push_back(1);
+          }
+        }
+      }
+    }
+  if (runLengths.size() <= maximumNumberOfRuns)
+    {
+    values.resize(runValues.size() * sizeof(T));
+    memcpy(values.data(), runValues.data(), values.size());
+    return;
+    }
+
+  runLengths.clear();
+  values.resize(rowSize * static_cast<size_t>(numberOfRows));
+  unsigned char* value = values.data();
+  for (int k = region[4]; k <= region[5]; ++k)
+    {
+    for (int j = region[2]; j <= region[3]; ++j)
+      {
+      memcpy(value, labelmap->GetScalarPointer(region[0], j, k), rowSize);
+      value += rowSize;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void DecodeLabelmapRegionGeneric(vtkImageData* labelmap, const int region[6],
+  const std::vector<unsigned char>& values, const std::vector<vtkTypeUInt32>& runLengths)
+{
+  const vtkIdType rowLength = static_cast<vtkIdType>(region[1] - region[0] + 1) * labelmap->GetNumberOfScalarComponents();
+  if (rowLength <= 0 || values.empty())
+    {
+    return;
+    }
+  if (runLengths.empty())
+    {
+    // Voxel values are stored as they are
+    const size_t rowSize = static_cast<size_t>(rowLength) * sizeof(T);
+    const unsigned char* value = values.data();
+    for (int k = region[4]; k <= region[5]; ++k)
+      {
+      for (int j = region[2]; j <= region[3]; ++j)
+        {
+        memcpy(labelmap->GetScalarPointer(region[0], j, k), value, rowSize);
+        value += rowSize;
+        }
+      }
+    return;
+    }
+
+  const T* runValues = reinterpret_cast<const T*>(values.data());
+  size_t runIndex = 0;
+  vtkIdType remainingRunLength = runLengths[0];
+  for (int k = region[4]; k <= region[5]; ++k)
+    {
+    for (int j = region[2]; j <= region[3]; ++j)
+      {
+      T* voxel = static_cast<T*>(labelmap->GetScalarPointer(region[0], j, k));
+      vtkIdType n = 0;
+      while (n < rowLength)
+        {
+        if (remainingRunLength == 0)
+          {
+          if (++runIndex >= runLengths.size())
+            {
+            return;
+            }
+          remainingRunLength = runLengths[runIndex];
+          }
+        vtkIdType count = std::min(remainingRunLength, rowLength - n);
+        std::fill(voxel + n, voxel + n + count, runValues[runIndex]);
+        n += count;
+        remainingRunLength -= count;
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Copy voxels of a region between labelmaps that have the same extent, scalar type, and number of components.
+void CopyLabelmapRegion(vtkImageData* sourceLabelmap, vtkImageData* targetLabelmap, const int region[6])
+{
+  const size_t rowSize = static_cast<size_t>(region[1] - region[0] + 1)
+    * sourceLabelmap->GetScalarSize() * sourceLabelmap->GetNumberOfScalarComponents();
+  for (int k = region[4]; k <= region[5]; ++k)
+    {
+    for (int j = region[2]; j <= region[3]; ++j)
+      {
+      memcpy(targetLabelmap->GetScalarPointer(region[0], j, k), sourceLabelmap->GetScalarPointer(region[0], j, k), rowSize);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Get the bounding box of voxels that are different in the two labelmaps.
+// The labelmaps must have the same extent, scalar type, and number of components.
+template <class T>
+void GetChangedLabelmapRegionGeneric(vtkImageData* labelmap, vtkImageData* baselineLabelmap, int changedRegion[6])
+{
+  int* extent = labelmap->GetExtent();
+  const int numberOfComponents = labelmap->GetNumberOfScalarComponents();
+  const vtkIdType rowLength = static_cast<vtkIdType>(extent[1] - extent[0] + 1) * numberOfComponents;
+  bool changed = false;
+  for (int k = extent[4]; k <= extent[5]; ++k)
+    {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+      {
+      const T* voxel = static_cast<const T*>(labelmap->GetScalarPointer(extent[0], j, k));
+      const T* baselineVoxel = static_cast<const T*>(baselineLabelmap->GetScalarPointer(extent[0], j, k));
+      vtkIdType first = std::mismatch(voxel, voxel + rowLength, baselineVoxel).first - voxel;
+      if (first == rowLength)
+        {
+        continue;
+        }
+      vtkIdType last = rowLength - 1;
+      while (last > first && voxel[last] == baselineVoxel[last])
+        {
+        --last;
+        }
+      int iMin = extent[0] + static_cast<int>(first / numberOfComponents);
+      int iMax = extent[0] + static_cast<int>(last / numberOfComponents);
+      if (!changed)
+        {
+        changedRegion[0] = iMin;
+        changedRegion[1] = iMax;
+        changedRegion[2] = j;
+        changedRegion[3] = j;
+        changedRegion[4] = k;
+        changed = true;
+        }
+      changedRegion[0] = std::min(changedRegion[0], iMin);
+      changedRegion[1] = std::max(changedRegion[1], iMax);
+      changedRegion[2] = std::min(changedRegion[2], j);
+      changedRegion[3] = std::max(changedRegion[3], j);
+      changedRegion[5] = k;
+      }
+    }
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+// Run-length encoded copy of a labelmap. Labelmaps consist of long runs of identical voxel
+// values, therefore the runs take much less memory than the voxel array. Run values are stored
+// in the scalar type of the labelmap. If RunLengths is empty then Values contains the voxels as they are.
+// If Baseline is set then only StoredExtent is stored, the rest of the labelmap is the same
+// as in Baseline.
+struct vtkSegmentationHistory::LabelmapState
+{
+  double ImageToWorldMatrix[16];
+  int Extent[6];
+  int ScalarType;
+  int NumberOfScalarComponents;
+
+  int StoredExtent[6];
+  std::vector<unsigned char> Values;
+  std::vector<vtkTypeUInt32> RunLengths;
+  LabelmapStatePointer Baseline;
+  int NumberOfBaselines;
+
+  // Decoded labelmap. Only kept for labelmaps of the last saved state so that the next state
+  // can be compared to it without decoding the baseline chain.
+  vtkSmartPointer<vtkOrientedImageData> Snapshot;
+
+  // Labelmap object and its modified time when it was saved. Only used for detecting
+  // that the labelmap has not changed since then, the object is never accessed.
+  vtkDataObject* Source;
+  vtkMTimeType SourceMTime;
+};
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSegmentationHistory);
@@ -40,6 +257,7 @@ vtkSegmentationHistory::vtkSegmentationHistory()
   this->Segmentation = nullptr;
 
   this->MaximumNumberOfStates = 5;
+  this->MaximumMemorySize = 0;
 
   this->LastRestoredState = 0;
   this->RestoreStateInProgress = false;
@@ -98,6 +316,8 @@ void vtkSegmentationHistory::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Modified Time: " << this->GetMTime() << "\n";
 
   os << indent << "Number of saved states:  " << this->SegmentationStates.size() << "\n";
+  os << indent << "Maximum number of states:  " << this->MaximumNumberOfStates << "\n";
+  os << indent << "Maximum memory size:  " << this->MaximumMemorySize << "\n";
 }
 
 //---------------------------------------------------------------------------
@@ -130,6 +350,7 @@ bool vtkSegmentationHistory::SaveState()
   this->Segmentation->GetSegmentIDs(segmentIDs);
   newSegmentationState.SegmentIds = segmentIDs;
   std::map<vtkDataObject*, vtkDataObject*> savedObjects;
+  std::map<vtkDataObject*, LabelmapStatePointer> savedLabelmaps;
   for (std::vector<std::string>::iterator segmentIDIt = segmentIDs.begin(); segmentIDIt != segmentIDs.end(); ++segmentIDIt)
     {
     vtkSegment* segment = this->Segmentation->GetSegment(*segmentIDIt);
@@ -141,6 +362,7 @@ bool vtkSegmentationHistory::SaveState()
     // Previous saved state of the segment
     // (if the new state has exactly the same representation then only a shallow copy will be made)
     vtkSegment* baselineSegment = nullptr;
+    LabelmapsMap* baselineLabelmaps = nullptr;
     if (this->SegmentationStates.size() > 0)
       {
       SegmentsMap::iterator baselineSegmentIt = this->SegmentationStates.back().Segments.find(*segmentIDIt);
@@ -148,12 +370,75 @@ bool vtkSegmentationHistory::SaveState()
         {
         baselineSegment = baselineSegmentIt->second.GetPointer();
         }
+      std::map<std::string, LabelmapsMap>::iterator baselineLabelmapsIt = this->SegmentationStates.back().Labelmaps.find(*segmentIDIt);
+      if (baselineLabelmapsIt != this->SegmentationStates.back().Labelmaps.end())
+        {
+        baselineLabelmaps = &(baselineLabelmapsIt->second);
+        }
+      }
+
+    // Labelmaps are stored compressed, all other representations are copied into the segment clone
+    vtkNew<vtkSegment> segmentToCopy;
+    segmentToCopy->DeepCopyMetadata(segment);
+    std::vector<std::string> representationNames;
+    segment->GetContainedRepresentationNames(representationNames);
+    for (const std::string& representationName : representationNames)
+      {
+      vtkDataObject* representation = segment->GetRepresentation(representationName);
+      vtkOrientedImageData* labelmap = vtkOrientedImageData::SafeDownCast(representation);
+      if (!labelmap || labelmap->IsEmpty() || !labelmap->GetPointData()->GetScalars())
+        {
+        segmentToCopy->AddRepresentation(representationName, representation);
+        continue;
+        }
+      std::map<vtkDataObject*, LabelmapStatePointer>::iterator savedLabelmapIt = savedLabelmaps.find(labelmap);
+      if (savedLabelmapIt != savedLabelmaps.end())
+        {
+        // Shared labelmap that has already been saved for a previous segment
+        newSegmentationState.Labelmaps[*segmentIDIt][representationName] = savedLabelmapIt->second;
+        continue;
+        }
+      LabelmapStatePointer baselineLabelmap;
+      if (baselineLabelmaps)
+        {
+        LabelmapsMap::iterator baselineLabelmapIt = baselineLabelmaps->find(representationName);
+        if (baselineLabelmapIt != baselineLabelmaps->end())
+          {
+          baselineLabelmap = baselineLabelmapIt->second;
+          }
+        }
+      LabelmapStatePointer labelmapState = vtkSegmentationHistory::CreateLabelmapState(labelmap, baselineLabelmap);
+      savedLabelmaps[labelmap] = labelmapState;
+      newSegmentationState.Labelmaps[*segmentIDIt][representationName] = labelmapState;
       }
 
     vtkSmartPointer<vtkSegment> segmentClone = vtkSmartPointer<vtkSegment>::New();
-    vtkSegmentation::CopySegment(segmentClone, segment, baselineSegment, savedObjects);
+    vtkSegmentation::CopySegment(segmentClone, segmentToCopy, baselineSegment, savedObjects);
     newSegmentationState.Segments[*segmentIDIt] = segmentClone;
     }
+
+  // Only labelmaps of the last saved state are kept decoded
+  if (!this->SegmentationStates.empty())
+    {
+    std::set<LabelmapState*> newLabelmapStates;
+    for (std::pair<const std::string, LabelmapsMap>& segmentLabelmaps : newSegmentationState.Labelmaps)
+      {
+      for (std::pair<const std::string, LabelmapStatePointer>& labelmap : segmentLabelmaps.second)
+        {
+        newLabelmapStates.insert(labelmap.second.get());
+        }
+      }
+    for (std::pair<const std::string, LabelmapsMap>& segmentLabelmaps : this->SegmentationStates.back().Labelmaps)
+      {
+      for (std::pair<const std::string, LabelmapStatePointer>& labelmap : segmentLabelmaps.second)
+        {
+        if (newLabelmapStates.find(labelmap.second.get()) == newLabelmapStates.end())
+          {
+          labelmap.second->Snapshot = nullptr;
+          }
+        }
+      }
+    }
   this->SegmentationStates.push_back(newSegmentationState);
 
   // Set the current state as last restored state.
@@ -224,6 +509,7 @@ bool vtkSegmentationHistory::RestoreState(unsigned int stateIndex)
 
   std::set<std::string> segmentIDsToKeep;
   std::map<vtkDataObject*, vtkDataObject*> restoredRepresentations;
+  std::map<LabelmapState*, vtkSmartPointer<vtkOrientedImageData> > restoredLabelmaps;
   for (SegmentsMap::iterator restoredSegmentsIt = restoredState.Segments.begin();
     restoredSegmentsIt != restoredState.Segments.end(); ++restoredSegmentsIt)
     {
@@ -240,6 +526,23 @@ bool vtkSegmentationHistory::RestoreState(unsigned int stateIndex)
 
     std::vector<std::string> restoredRepresentationNames;
     segmentToRestore->GetContainedRepresentationNames(restoredRepresentationNames);
+
+    std::map<std::string, LabelmapsMap>::iterator labelmapsIt = restoredState.Labelmaps.find(restoredSegmentsIt->first);
+    if (labelmapsIt != restoredState.Labelmaps.end())
+      {
+      for (LabelmapsMap::iterator labelmapIt = labelmapsIt->second.begin(); labelmapIt != labelmapsIt->second.end(); ++labelmapIt)
+        {
+        // Segments that shared a labelmap get the same restored labelmap object
+        vtkSmartPointer<vtkOrientedImageData>& restoredLabelmap = restoredLabelmaps[labelmapIt->second.get()];
+        if (!restoredLabelmap)
+          {
+          restoredLabelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+          vtkSegmentationHistory::RestoreLabelmap(labelmapIt->second.get(), restoredLabelmap);
+          }
+        segment->AddRepresentation(labelmapIt->first, restoredLabelmap);
+        restoredRepresentationNames.push_back(labelmapIt->first);
+        }
+      }
     std::vector<std::string> currentRepresentationNames;
     segment->GetContainedRepresentationNames(currentRepresentationNames);
     // Remove representations that are not in the restoring segment
@@ -312,12 +615,28 @@ void vtkSegmentationHistory::RemoveAllNextStates()
 void vtkSegmentationHistory::RemoveAllObsoleteStates()
 {
   bool modified = false;
-  while ((this->SegmentationStates.size() > this->MaximumNumberOfStates) && (!this->SegmentationStates.empty()))
+  while (!this->SegmentationStates.empty()
+    && (this->SegmentationStates.size() > this->MaximumNumberOfStates
+      || (this->MaximumMemorySize > 0 && this->SegmentationStates.size() > 1 && this->LastRestoredState > 0
+        && this->GetMemorySize() > this->MaximumMemorySize)))
     {
     this->SegmentationStates.pop_front();
     this->LastRestoredState--;
     modified = true;
-   }
+    if (this->SegmentationStates.empty())
+      {
+      break;
+      }
+    // Labelmaps in the oldest remaining state may be stored as a difference from the removed state.
+    // Store them fully so that the removed state's labelmaps can be released.
+    for (std::pair<const std::string, LabelmapsMap>& segmentLabelmaps : this->SegmentationStates.front().Labelmaps)
+      {
+      for (std::pair<const std::string, LabelmapStatePointer>& labelmap : segmentLabelmaps.second)
+        {
+        vtkSegmentationHistory::RemoveLabelmapBaseline(labelmap.second.get());
+        }
+      }
+    }
   if (modified)
     {
     this->Modified();
@@ -336,6 +655,196 @@ void vtkSegmentationHistory::SetMaximumNumberOfStates(unsigned int maximumNumber
   this->Modified();
 }
 
+//---------------------------------------------------------------------------
+void vtkSegmentationHistory::SetMaximumMemorySize(unsigned long maximumMemorySize)
+{
+  if (maximumMemorySize == this->MaximumMemorySize)
+    {
+    return;
+    }
+  this->MaximumMemorySize = maximumMemorySize;
+  this->RemoveAllObsoleteStates();
+  this->Modified();
+}
+
+//---------------------------------------------------------------------------
+unsigned long vtkSegmentationHistory::GetMemorySize()
+{
+  std::set<vtkDataObject*> countedRepresentations;
+  std::set<LabelmapState*> countedLabelmaps;
+  unsigned long representationsMemorySize = 0; // in kiB
+  size_t labelmapsMemorySize = 0; // in bytes
+  for (SegmentationState& state : this->SegmentationStates)
+    {
+    for (SegmentsMap::iterator segmentIt = state.Segments.begin(); segmentIt != state.Segments.end(); ++segmentIt)
+      {
+      std::vector<std::string> representationNames;
+      segmentIt->second->GetContainedRepresentationNames(representationNames);
+      for (const std::string& representationName : representationNames)
+        {
+        vtkDataObject* representation = segmentIt->second->GetRepresentation(representationName);
+        if (representation && countedRepresentations.insert(representation).second)
+          {
+          representationsMemorySize += representation->GetActualMemorySize();
+          }
+        }
+      }
+    for (std::pair<const std::string, LabelmapsMap>& segmentLabelmaps : state.Labelmaps)
+      {
+      for (std::pair<const std::string, LabelmapStatePointer>& labelmap : segmentLabelmaps.second)
+        {
+        // Baselines of an already counted labelmap are already counted, too
+        for (LabelmapState* labelmapState = labelmap.second.get();
+          labelmapState && countedLabelmaps.insert(labelmapState).second;
+          labelmapState = labelmapState->Baseline.get())
+          {
+          labelmapsMemorySize += sizeof(LabelmapState) + labelmapState->Values.capacity()
+            + labelmapState->RunLengths.capacity() * sizeof(vtkTypeUInt32);
+          if (labelmapState->Snapshot)
+            {
+            representationsMemorySize += labelmapState->Snapshot->GetActualMemorySize();
+            }
+          }
+        }
+      }
+    }
+  return representationsMemorySize + static_cast<unsigned long>(labelmapsMemorySize / 1024);
+}
+
+//---------------------------------------------------------------------------
+vtkSegmentationHistory::LabelmapStatePointer vtkSegmentationHistory::CreateLabelmapState(
+  vtkOrientedImageData* labelmap, LabelmapStatePointer baseline)
+{
+  LabelmapStatePointer labelmapState = std::make_shared<LabelmapState>();
+  vtkNew<vtkMatrix4x4> imageToWorldMatrix;
+  labelmap->GetImageToWorldMatrix(imageToWorldMatrix);
+  std::copy(&imageToWorldMatrix->Element[0][0], &imageToWorldMatrix->Element[0][0] + 16, labelmapState->ImageToWorldMatrix);
+  labelmap->GetExtent(labelmapState->Extent);
+  labelmapState->ScalarType = labelmap->GetScalarType();
+  labelmapState->NumberOfScalarComponents = labelmap->GetNumberOfScalarComponents();
+  std::copy(labelmapState->Extent, labelmapState->Extent + 6, labelmapState->StoredExtent);
+  labelmapState->NumberOfBaselines = 0;
+  labelmapState->Source = labelmap;
+  labelmapState->SourceMTime = labelmap->GetMTime();
+
+  if (baseline
+    && baseline->ScalarType == labelmapState->ScalarType
+    && baseline->NumberOfScalarComponents == labelmapState->NumberOfScalarComponents
+    && std::equal(labelmapState->Extent, labelmapState->Extent + 6, baseline->Extent)
+    && std::equal(labelmapState->ImageToWorldMatrix, labelmapState->ImageToWorldMatrix + 16, baseline->ImageToWorldMatrix))
+    {
+    if (baseline->Source == labelmap && baseline->SourceMTime == labelmapState->SourceMTime)
+      {
+      // Labelmap has not been modified since the baseline was saved
+      return baseline;
+      }
+
+    // Labelmaps of the last saved state are kept decoded, other baselines (e.g., after undo) need to be decoded
+    vtkSmartPointer<vtkOrientedImageData> baselineLabelmap = baseline->Snapshot;
+    if (!baselineLabelmap)
+      {
+      baselineLabelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+      vtkSegmentationHistory::RestoreLabelmap(baseline.get(), baselineLabelmap);
+      }
+    int changedExtent[6] = { 0, -1, 0, -1, 0, -1 };
+    switch (labelmap->GetScalarType())
+      {
+      vtkTemplateMacro(GetChangedLabelmapRegionGeneric<VTK_TT>(labelmap, baselineLabelmap, changedExtent));
+      }
+    if (changedExtent[0] > changedExtent[1])
+      {
+      // Labelmap content is the same as the baseline
+      baseline->Source = labelmap;
+      baseline->SourceMTime = labelmapState->SourceMTime;
+      baseline->Snapshot = baselineLabelmap;
+      return baseline;
+      }
+
+    // Update the decoded baseline to become the decoded copy of the new state
+    baseline->Snapshot = nullptr;
+    CopyLabelmapRegion(labelmap, baselineLabelmap, changedExtent);
+    labelmapState->Snapshot = baselineLabelmap;
+
+    double numberOfChangedVoxels = 1.0;
+    double numberOfVoxels = 1.0;
+    for (int i = 0; i < 3; ++i)
+      {
+      numberOfChangedVoxels *= changedExtent[2 * i + 1] - changedExtent[2 * i] + 1;
+      numberOfVoxels *= labelmapState->Extent[2 * i + 1] - labelmapState->Extent[2 * i] + 1;
+      }
+    if (baseline->NumberOfBaselines < MAXIMUM_NUMBER_OF_LABELMAP_BASELINES && numberOfChangedVoxels < 0.5 * numberOfVoxels)
+      {
+      // Only store the changed region
+      std::copy(changedExtent, changedExtent + 6, labelmapState->StoredExtent);
+      labelmapState->Baseline = baseline;
+      labelmapState->NumberOfBaselines = baseline->NumberOfBaselines + 1;
+      }
+    }
+
+  switch (labelmapState->ScalarType)
+    {
+    vtkTemplateMacro(EncodeLabelmapRegionGeneric<VTK_TT>(labelmap, labelmapState->StoredExtent,
+      labelmapState->Values, labelmapState->RunLengths));
+    }
+  labelmapState->Values.shrink_to_fit();
+  labelmapState->RunLengths.shrink_to_fit();
+  if (!labelmapState->Snapshot)
+    {
+    labelmapState->Snapshot = vtkSmartPointer<vtkOrientedImageData>::New();
+    labelmapState->Snapshot->DeepCopy(labelmap);
+    }
+  return labelmapState;
+}
+
+//---------------------------------------------------------------------------
+void vtkSegmentationHistory::RestoreLabelmap(LabelmapState* labelmapState, vtkOrientedImageData* labelmap)
+{
+  if (labelmapState->Snapshot)
+    {
+    labelmap->DeepCopy(labelmapState->Snapshot);
+    return;
+    }
+  if (labelmapState->Baseline)
+    {
+    // Baseline has the same geometry
+    vtkSegmentationHistory::RestoreLabelmap(labelmapState->Baseline.get(), labelmap);
+    }
+  else
+    {
+    vtkNew<vtkMatrix4x4> imageToWorldMatrix;
+    imageToWorldMatrix->DeepCopy(labelmapState->ImageToWorldMatrix);
+    labelmap->SetExtent(labelmapState->Extent);
+    labelmap->SetGeometryFromImageToWorldMatrix(imageToWorldMatrix);
+    labelmap->AllocateScalars(labelmapState->ScalarType, labelmapState->NumberOfScalarComponents);
+    }
+  switch (labelmapState->ScalarType)
+    {
+    vtkTemplateMacro(DecodeLabelmapRegionGeneric<VTK_TT>(labelmap, labelmapState->StoredExtent,
+      labelmapState->Values, labelmapState->RunLengths));
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkSegmentationHistory::RemoveLabelmapBaseline(LabelmapState* labelmapState)
+{
+  if (!labelmapState->Baseline)
+    {
+    return;
+    }
+  vtkNew<vtkOrientedImageData> labelmap;
+  vtkSegmentationHistory::RestoreLabelmap(labelmapState, labelmap);
+  std::copy(labelmapState->Extent, labelmapState->Extent + 6, labelmapState->StoredExtent);
+  switch (labelmapState->ScalarType)
+    {
+    vtkTemplateMacro(EncodeLabelmapRegionGeneric<VTK_TT>(labelmap, labelmapState->StoredExtent,
+      labelmapState->Values, labelmapState->RunLengths));
+    }
+  labelmapState->Values.shrink_to_fit();
+  labelmapState->RunLengths.shrink_to_fit();
+  labelmapState->Baseline = nullptr;
+  labelmapState->NumberOfBaselines = 0;
+}
+
 //---------------------------------------------------------------------------
 void vtkSegmentationHistory::OnSegmentationModified(vtkObject* vtkNotUsed(caller),
   unsigned long vtkNotUsed(eid),
@@ -28,12 +28,14 @@
 // STD includes
 #include <deque>
 #include <map>
+#include <memory>
 #include <vector>
 
 #include "vtkSegmentationCoreConfigure.h"
 
 class vtkCallbackCommand;
 class vtkDataObject;
+class vtkOrientedImageData;
 class vtkSegment;
 class vtkSegmentation;
 
@@ -54,6 +56,10 @@ public:
 
   /// Saves all master representations of the segmentation in its current state.
   /// States more recent than the last restored state are removed.
+  /// Labelmap representations are stored run-length encoded (or as they are, if encoding would not
+  /// reduce their size). If a labelmap has the same geometry as in the previous state then only
+  /// the region that has changed since then is stored. A decoded copy of the labelmaps of the last
+  /// saved state is kept to find the changed region quickly.
   /// \return Success flag
   bool SaveState();
 
@@ -86,6 +92,17 @@ public:
   /// Get the current number of states.
   int GetNumberOfStates();
 
+  /// Limits how much memory the stored states may use (in kiB). 0 means no limit.
+  /// If the stored states use more memory than the limit then the oldest states are removed
+  /// (the most recent state is always kept).
+  void SetMaximumMemorySize(unsigned long maximumMemorySize);
+
+  /// Get the limit of how much memory the stored states may use (in kiB).
+  vtkGetMacro(MaximumMemorySize, unsigned long);
+
+  /// Get the amount of memory used by the stored states (in kiB).
+  unsigned long GetMemorySize();
+
 protected:
   /// Callback function called when the segmentation has been modified.
   /// It clears all states that are more recent than the last restored state.
@@ -95,20 +112,38 @@ protected:
   void RemoveAllNextStates();
 
   /// Delete all old states so that we keep only up to MaximumNumberOfStates states
+  /// and the stored states do not use more memory than MaximumMemorySize.
   void RemoveAllObsoleteStates();
 
   /// Restores a state defined by stateIndex.
   bool RestoreState(unsigned int stateIndex);
 
+  struct LabelmapState;
+  typedef std::shared_ptr<LabelmapState> LabelmapStatePointer;
+
+  /// Create compressed copy of a labelmap.
+  /// If baseline is specified and has the same geometry then only the changed region is stored.
+  /// Returns baseline if the labelmap has not changed.
+  static LabelmapStatePointer CreateLabelmapState(vtkOrientedImageData* labelmap, LabelmapStatePointer baseline);
+
+  /// Reconstruct the labelmap stored in labelmapState.
+  static void RestoreLabelmap(LabelmapState* labelmapState, vtkOrientedImageData* labelmap);
+
+  /// Store the full labelmap in labelmapState instead of its difference from the baseline,
+  /// which allows releasing the baseline.
+  static void RemoveLabelmapBaseline(LabelmapState* labelmapState);
+
 protected:
   vtkSegmentationHistory();
   ~vtkSegmentationHistory() override;
 
   typedef std::map<std::string, vtkSmartPointer<vtkSegment> > SegmentsMap;
+  typedef std::map<std::string, LabelmapStatePointer> LabelmapsMap;
 
   struct SegmentationState
     {
-    SegmentsMap Segments;
+    SegmentsMap Segments; // segment metadata and non-labelmap representations
+    std::map<std::string, LabelmapsMap> Labelmaps; // labelmap representations of each segment
     std::vector<std::string> SegmentIds; // order of segments
     };
 
@@ -116,6 +151,7 @@ protected:
   vtkCallbackCommand* SegmentationModifiedCallbackCommand;
   std::deque<SegmentationState> SegmentationStates;
   unsigned int MaximumNumberOfStates;
+  unsigned long MaximumMemorySize;
 
   // Index of the state in SegmentationStates that was restored last.
   // If LastRestoredState == size of states then it means that the segmentation has changed
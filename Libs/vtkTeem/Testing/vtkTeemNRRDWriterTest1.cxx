@@ -0,0 +1,129 @@
+/*==============================================================================
+
+  Program: 3D Cjyx
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkTeem includes
+#include <vtkTeemNRRDReader.h>
+#include <vtkTeemNRRDWriter.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkTimerLog.h>
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+bool WriteAndReadImage(vtkImageData* image, const std::string& fileName, bool parallelCompression, int compressionLevel)
+{
+  vtkNew<vtkTeemNRRDWriter> writer;
+  writer->SetFileName(fileName.c_str());
+  writer->SetInputData(image);
+  writer->SetUseCompression(true);
+  writer->SetCompressionLevel(compressionLevel);
+  writer->SetParallelCompression(parallelCompression);
+  // use small blocks to get many gzip members even for a moderate size image
+  writer->SetCompressionBlockSize(64 * 1024);
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  writer->Write();
+  timer->StopTimer();
+  if (writer->GetWriteError())
+    {
+    std::cerr << "Line " << __LINE__ << ": Failed to write " << fileName << std::endl;
+    return false;
+    }
+  std::cout << (parallelCompression ? "Parallel" : "Single-threaded") << " compression (level " << compressionLevel << "): "
+    << timer->GetElapsedTime() << "s, " << vtksys::SystemTools::FileLength(fileName) << " bytes" << std::endl;
+
+  vtkNew<vtkTeemNRRDReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->Update();
+  if (reader->GetReadStatus())
+    {
+    std::cerr << "Line " << __LINE__ << ": Failed to read " << fileName << std::endl;
+    return false;
+    }
+  vtkImageData* readImage = reader->GetOutput();
+  int* dims = image->GetDimensions();
+  int* readDims = readImage->GetDimensions();
+  if (dims[0] != readDims[0] || dims[1] != readDims[1] || dims[2] != readDims[2]
+    || readImage->GetScalarType() != image->GetScalarType())
+    {
+    std::cerr << "Line " << __LINE__ << ": Image geometry mismatch in " << fileName << std::endl;
+    return false;
+    }
+  size_t dataSize = static_cast<size_t>(image->GetNumberOfPoints()) * image->GetScalarSize() * image->GetNumberOfScalarComponents();
+  if (memcmp(image->GetScalarPointer(), readImage->GetScalarPointer(), dataSize) != 0)
+    {
+    std::cerr << "Line " << __LINE__ << ": Voxel values mismatch in " << fileName << std::endl;
+    return false;
+    }
+  return true;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkTeemNRRDWriterTest1(int argc, char* argv[])
+{
+  if (argc < 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string tempDir = argv[1];
+
+  // Label-like content, similar to a segmentation
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(256, 256, 64);
+  image->AllocateScalars(VTK_SHORT, 1);
+  short* voxels = static_cast<short*>(image->GetScalarPointer());
+  for (int k = 0; k < 64; ++k)
+    {
+    for (int j = 0; j < 256; ++j)
+      {
+      for (int i = 0; i < 256; ++i)
+        {
+        *(voxels++) = static_cast<short>(((i / 16) + (j / 32) * 3 + k) % 7);
+        }
+      }
+    }
+
+  // Compare parallel compression with the single-threaded teem encoder
+  const int compressionLevels[2] = { 1, 6 };
+  for (int compressionLevel : compressionLevels)
+    {
+    if (!WriteAndReadImage(image, tempDir + "/vtkTeemNRRDWriterTest1_parallel.nrrd", true, compressionLevel)
+      || !WriteAndReadImage(image, tempDir + "/vtkTeemNRRDWriterTest1_single.nrrd", false, compressionLevel))
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Detached header is written by teem
+  if (!WriteAndReadImage(image, tempDir + "/vtkTeemNRRDWriterTest1_detached.nhdr", true, 1))
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
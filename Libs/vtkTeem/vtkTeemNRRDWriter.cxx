@@ -7,13 +7,20 @@
 #include "vtkPointData.h"
 #include "vtkObjectFactory.h"
 #include "vtkInformation.h"
+#include <vtkSMPTools.h>
 #include <vtkVersion.h>
+#include <vtksys/SystemTools.hxx>
 
 #include <itkMath.h>
+#include <itk_zlib.h>
 #include <vnl/vnl_double_3.h>
 
 #include "itkNumberToString.h"
 
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
 
 class AttributeMapType: public std::map<std::string, std::string> {};
 class AxisInfoMapType : public std::map<unsigned int, std::string> {};
@@ -31,6 +38,8 @@ vtkTeemNRRDWriter::vtkTeemNRRDWriter()
   this->UseCompression = 1;
   // use default CompressionLevel
   this->CompressionLevel = -1;
+  this->ParallelCompression = true;
+  this->CompressionBlockSize = 1024 * 1024;
   this->DiffusionWeightedData = 0;
   this->FileType = VTK_BINARY;
   this->WriteErrorOff();
@@ -439,8 +448,22 @@ void vtkTeemNRRDWriter::WriteData()
   // set endianness as unknown of output
   nio->endian = airEndianUnknown;
 
+  // Parallel compression only pays off if there are multiple blocks to compress.
+  // Detached headers are left to teem, which takes care of the data file naming.
+  bool parallelCompression = this->ParallelCompression
+    && nio->encoding == nrrdEncodingGzip
+    && nrrdElementNumber(nrrd) * nrrdElementSize(nrrd) > static_cast<size_t>(this->CompressionBlockSize)
+    && vtksys::SystemTools::LowerCase(vtksys::SystemTools::GetFilenameLastExtension(this->GetFileName())) != ".nhdr";
+
   // Write the nrrd to file.
-  if (nrrdSave(this->GetFileName(), nrrd, nio))
+  if (parallelCompression)
+    {
+    if (!this->WriteParallelCompressed(nrrd, nio))
+      {
+      this->WriteErrorOn();
+      }
+    }
+  else if (nrrdSave(this->GetFileName(), nrrd, nio))
     {
     char *err = biffGetDone(NRRD); // would be nice to free(err)
     vtkErrorMacro("Write: Error writing "
@@ -452,10 +475,119 @@ void vtkTeemNRRDWriter::WriteData()
   nio = nrrdIoStateNix(nio);
 }
 
+//----------------------------------------------------------------------------
+namespace
+{
+// Compress a block of data into a complete gzip member.
+bool CompressGzipMember(const unsigned char* input, size_t inputSize, int level, std::vector<unsigned char>& output)
+{
+  z_stream stream;
+  stream.zalloc = Z_NULL;
+  stream.zfree = Z_NULL;
+  stream.opaque = Z_NULL;
+  // windowBits + 16 writes a gzip header and trailer instead of a zlib wrapper
+  if (deflateInit2(&stream, level, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+    return false;
+    }
+  output.resize(deflateBound(&stream, static_cast<uLong>(inputSize)));
+  stream.next_in = const_cast<Bytef*>(input);
+  stream.avail_in = static_cast<uInt>(inputSize);
+  stream.next_out = output.data();
+  stream.avail_out = static_cast<uInt>(output.size());
+  int result = deflate(&stream, Z_FINISH);
+  output.resize(stream.total_out);
+  deflateEnd(&stream);
+  return (result == Z_STREAM_END);
+}
+}
+
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDWriter::WriteParallelCompressed(Nrrd* nrrd, NrrdIoState* nio)
+{
+  FILE* file = vtksys::SystemTools::Fopen(this->GetFileName(), "wb");
+  if (!file)
+    {
+    vtkErrorMacro("Write: Cannot open file " << this->GetFileName() << " for writing");
+    return false;
+    }
+
+  // Let teem write the header (including "encoding: gzip" and the empty line
+  // that separates the header from the data) then append the compressed data.
+  nio->format = nrrdFormatNRRD;
+  nio->skipData = AIR_TRUE;
+  if (nrrdWrite(file, nrrd, nio))
+    {
+    char *err = biffGetDone(NRRD); // would be nice to free(err)
+    vtkErrorMacro("Write: Error writing header of "
+                      << this->GetFileName() << ":\n" << err);
+    fclose(file);
+    return false;
+    }
+
+  // Concatenated gzip members are decompressed as a single stream by gzip readers
+  // (including teem and ITK), therefore blocks can be compressed independently.
+  // Blocks are processed in batches to limit the memory used by compressed buffers.
+  const unsigned char* data = static_cast<const unsigned char*>(nrrd->data);
+  const size_t dataSize = nrrdElementNumber(nrrd) * nrrdElementSize(nrrd);
+  const size_t blockSize = static_cast<size_t>(this->CompressionBlockSize);
+  const vtkIdType numberOfBlocks = static_cast<vtkIdType>((dataSize + blockSize - 1) / blockSize);
+  const vtkIdType batchSize = 4 * vtkSMPTools::GetEstimatedNumberOfThreads();
+  const int level = this->CompressionLevel;
+  std::vector<std::vector<unsigned char> > compressedBlocks(batchSize);
+  bool success = true;
+  for (vtkIdType batchStart = 0; batchStart < numberOfBlocks && success; batchStart += batchSize)
+    {
+    const vtkIdType batchEnd = std::min(batchStart + batchSize, numberOfBlocks);
+    std::atomic<bool> compressionFailed(false);
+    vtkSMPTools::For(batchStart, batchEnd, [&](vtkIdType begin, vtkIdType end)
+      {
+      for (vtkIdType blockIndex = begin; blockIndex < end; ++blockIndex)
+        {
+        size_t blockOffset = static_cast<size_t>(blockIndex) * blockSize;
+        size_t blockLength = std::min(blockSize, dataSize - blockOffset);
+        if (!CompressGzipMember(data + blockOffset, blockLength, level, compressedBlocks[blockIndex - batchStart]))
+          {
+          compressionFailed = true;
+          }
+        }
+      });
+    if (compressionFailed)
+      {
+      vtkErrorMacro("Write: Failed to compress data of " << this->GetFileName());
+      success = false;
+      break;
+      }
+    for (vtkIdType blockIndex = batchStart; blockIndex < batchEnd; ++blockIndex)
+      {
+      const std::vector<unsigned char>& compressedBlock = compressedBlocks[blockIndex - batchStart];
+      if (fwrite(compressedBlock.data(), 1, compressedBlock.size(), file) != compressedBlock.size())
+        {
+        vtkErrorMacro("Write: Error writing data of " << this->GetFileName());
+        success = false;
+        break;
+        }
+      }
+    }
+
+  if (fclose(file) != 0)
+    {
+    vtkErrorMacro("Write: Error closing " << this->GetFileName());
+    success = false;
+    }
+  return success;
+}
+
+//----------------------------------------------------------------------------
 void vtkTeemNRRDWriter::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
 
+  os << indent << "UseCompression: " << this->UseCompression << "\n";
+  os << indent << "CompressionLevel: " << this->CompressionLevel << "\n";
+  os << indent << "ParallelCompression: " << (this->ParallelCompression ? "true" : "false") << "\n";
+  os << indent << "CompressionBlockSize: " << this->CompressionBlockSize << "\n";
+
   os << indent << "RAS to IJK Matrix: ";
      this->IJKToRASMatrix->PrintSelf(os,indent);
   os << indent << "Measurement frame: ";
@@ -58,6 +58,23 @@ public:
   vtkSetClampMacro(CompressionLevel, int, 0, 9);
   vtkGetMacro(CompressionLevel, int);
 
+  /// Compress the image data on multiple threads (enabled by default).
+  /// The data is split into blocks of CompressionBlockSize bytes that are
+  /// compressed independently and written as concatenated gzip members,
+  /// which can be read by any NRRD reader. Only used for files with
+  /// attached header (.nrrd); detached headers (.nhdr) are always
+  /// compressed on a single thread.
+  vtkSetMacro(ParallelCompression, bool);
+  vtkGetMacro(ParallelCompression, bool);
+  vtkBooleanMacro(ParallelCompression, bool);
+
+  /// Size of the blocks (in bytes) that are compressed independently
+  /// when ParallelCompression is enabled. Larger blocks slightly improve
+  /// compression ratio, smaller blocks allow using more threads for small images.
+  /// Default is 1MB.
+  vtkSetClampMacro(CompressionBlockSize, vtkIdType, 64 * 1024, VTK_ID_MAX);
+  vtkGetMacro(CompressionBlockSize, vtkIdType);
+
   vtkSetClampMacro(FileType,int,VTK_ASCII,VTK_BINARY);
   vtkGetMacro(FileType,int);
   void SetFileTypeToASCII() {this->SetFileType(VTK_ASCII);};
@@ -129,6 +146,8 @@ protected:
 
   int UseCompression;
   int CompressionLevel;
+  bool ParallelCompression;
+  vtkIdType CompressionBlockSize;
   int FileType;
 
   AttributeMapType *Attributes;
@@ -144,6 +163,9 @@ private:
   void operator=(const vtkTeemNRRDWriter&) = delete;
   void vtkImageDataInfoToNrrdInfo(vtkImageData *in, int &nrrdKind, size_t &numComp, int &vtkType, void **buffer);
   int VTKToNrrdPixelType( const int vtkPixelType );
+  /// Write the header using teem and the data as concatenated gzip members
+  /// compressed in parallel. Returns false on failure.
+  bool WriteParallelCompressed(Nrrd* nrrd, NrrdIoState* nio);
   int DiffusionWeightedData;
 };
 
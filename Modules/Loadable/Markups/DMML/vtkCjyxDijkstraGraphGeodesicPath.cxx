@@ -22,10 +22,56 @@
 #include "vtkCjyxDijkstraGraphGeodesicPath.h"
 
 // VTK includes
+#include <vtkCellType.h>
 #include <vtkFloatArray.h>
+#include <vtkIdList.h>
 #include <vtkPointData.h>
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
+#include <vtkMath.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
+
+// STD includes
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+//------------------------------------------------------------------------------
+class vtkCjyxDijkstraGraphGeodesicPath::vtkInternal
+{
+public:
+  /// Search state of a thread. Instead of resetting the arrays for each search,
+  /// values are only valid for vertices that have been visited in the current search.
+  struct SearchState
+    {
+    std::vector<double> Cost;
+    std::vector<vtkIdType> Predecessor;
+    std::vector<unsigned int> VisitedSearchId;
+    std::vector<unsigned int> ClosedSearchId;
+    unsigned int SearchId{0};
+    };
+
+  /// Edges of the graph in compressed sparse row format:
+  /// edges of vertex i are stored from index EdgeOffsets[i] to EdgeOffsets[i+1]-1.
+  std::vector<vtkIdType> EdgeOffsets;
+  std::vector<vtkIdType> EdgeEndVertices;
+  std::vector<double> EdgeCosts;
+  std::vector<double> VertexCoordinates;
+
+  /// Euclidean distance is multiplied by this value to get a lower bound of the path cost
+  double HeuristicScale{0.0};
+
+  vtkTimeStamp GraphBuildTime;
+  bool GraphBuilt{false};
+  int GraphCostFunctionType{-1};
+  bool GraphUseScalarWeights{false};
+
+  vtkSMPThreadLocal<SearchState> SearchStates;
+};
 
 //------------------------------------------------------------------------------
 vtkStandardNewMacro(vtkCjyxDijkstraGraphGeodesicPath);
@@ -37,10 +83,15 @@ vtkCjyxDijkstraGraphGeodesicPath::vtkCjyxDijkstraGraphGeodesicPath()
   this->PreviousUseScalarWeights = this->UseScalarWeights;
   this->CostFunctionType = COST_FUNCTION_TYPE_DISTANCE;
   this->PreviousCostFunctionType = this->CostFunctionType;
+  this->Internal = new vtkInternal();
 }
 
 //------------------------------------------------------------------------------
-vtkCjyxDijkstraGraphGeodesicPath::~vtkCjyxDijkstraGraphGeodesicPath() = default;
+vtkCjyxDijkstraGraphGeodesicPath::~vtkCjyxDijkstraGraphGeodesicPath()
+{
+  delete this->Internal;
+  this->Internal = nullptr;
+}
 
 //------------------------------------------------------------------------------
 void vtkCjyxDijkstraGraphGeodesicPath::PrintSelf(std::ostream &os, vtkIndent indent)
@@ -189,3 +240,236 @@ double vtkCjyxDijkstraGraphGeodesicPath::CalculateStaticEdgeCost(vtkDataSet* inD
     }
   return cost;
 }
+
+//------------------------------------------------------------------------------
+void vtkCjyxDijkstraGraphGeodesicPath::UpdateGraph(vtkPolyData* surface)
+{
+  vtkInternal* internal = this->Internal;
+  if (!surface)
+    {
+    internal->EdgeOffsets.clear();
+    internal->EdgeEndVertices.clear();
+    internal->EdgeCosts.clear();
+    internal->VertexCoordinates.clear();
+    internal->GraphBuilt = false;
+    internal->GraphBuildTime.Modified();
+    return;
+    }
+  if (internal->GraphBuilt
+    && internal->GraphBuildTime.GetMTime() > surface->GetMTime()
+    && internal->GraphCostFunctionType == this->CostFunctionType
+    && internal->GraphUseScalarWeights == static_cast<bool>(this->UseScalarWeights))
+    {
+    // graph is up-to-date
+    return;
+    }
+
+  vtkIdType numberOfVertices = surface->GetNumberOfPoints();
+  internal->VertexCoordinates.resize(3 * numberOfVertices);
+  for (vtkIdType vertexIndex = 0; vertexIndex < numberOfVertices; ++vertexIndex)
+    {
+    surface->GetPoint(vertexIndex, &internal->VertexCoordinates[3 * vertexIndex]);
+    }
+
+  // Same cell types and edges are used as in vtkDijkstraGraphGeodesicPath::BuildAdjacency:
+  // consecutive points of polygons, triangles, and lines, and the last and first point.
+  std::vector<vtkIdType>& edgeOffsets = internal->EdgeOffsets;
+  std::vector<vtkIdType>& edgeEndVertices = internal->EdgeEndVertices;
+  vtkIdType numberOfCells = surface->GetNumberOfCells();
+  auto forEachCellEdge = [surface, numberOfCells](auto addEdge)
+    {
+    for (vtkIdType cellIndex = 0; cellIndex < numberOfCells; ++cellIndex)
+      {
+      int cellType = surface->GetCellType(cellIndex);
+      if (cellType != VTK_POLYGON && cellType != VTK_TRIANGLE && cellType != VTK_LINE)
+        {
+        continue;
+        }
+      vtkIdType numberOfCellPoints = 0;
+      const vtkIdType* cellPoints = nullptr;
+      surface->GetCellPoints(cellIndex, numberOfCellPoints, cellPoints);
+      for (vtkIdType i = 0; i < numberOfCellPoints; ++i)
+        {
+        addEdge(cellPoints[i], cellPoints[(i + 1) % numberOfCellPoints]);
+        }
+      }
+    };
+
+  // Count edges of each vertex (including duplicates, as edges are shared between cells)
+  edgeOffsets.assign(numberOfVertices + 1, 0);
+  forEachCellEdge([&edgeOffsets](vtkIdType u, vtkIdType v)
+    {
+    ++edgeOffsets[u + 1];
+    ++edgeOffsets[v + 1];
+    });
+  for (vtkIdType vertexIndex = 0; vertexIndex < numberOfVertices; ++vertexIndex)
+    {
+    edgeOffsets[vertexIndex + 1] += edgeOffsets[vertexIndex];
+    }
+  edgeEndVertices.resize(edgeOffsets[numberOfVertices]);
+  std::vector<vtkIdType> insertPositions(edgeOffsets.begin(), edgeOffsets.end() - 1);
+  forEachCellEdge([&edgeEndVertices, &insertPositions](vtkIdType u, vtkIdType v)
+    {
+    edgeEndVertices[insertPositions[u]++] = v;
+    edgeEndVertices[insertPositions[v]++] = u;
+    });
+
+  // Remove duplicate edges
+  std::vector<vtkIdType> numberOfUniqueEdges(numberOfVertices, 0);
+  vtkSMPTools::For(0, numberOfVertices, [&](vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType vertexIndex = begin; vertexIndex < end; ++vertexIndex)
+      {
+      auto first = edgeEndVertices.begin() + edgeOffsets[vertexIndex];
+      auto last = edgeEndVertices.begin() + edgeOffsets[vertexIndex + 1];
+      std::sort(first, last);
+      numberOfUniqueEdges[vertexIndex] = std::unique(first, last) - first;
+      }
+    });
+  vtkIdType numberOfEdges = 0;
+  for (vtkIdType vertexIndex = 0; vertexIndex < numberOfVertices; ++vertexIndex)
+    {
+    vtkIdType firstEdgeIndex = edgeOffsets[vertexIndex];
+    edgeOffsets[vertexIndex] = numberOfEdges;
+    std::copy(edgeEndVertices.begin() + firstEdgeIndex,
+      edgeEndVertices.begin() + firstEdgeIndex + numberOfUniqueEdges[vertexIndex],
+      edgeEndVertices.begin() + numberOfEdges);
+    numberOfEdges += numberOfUniqueEdges[vertexIndex];
+    }
+  edgeOffsets[numberOfVertices] = numberOfEdges;
+  edgeEndVertices.resize(numberOfEdges);
+  edgeEndVertices.shrink_to_fit();
+
+  // Compute edge costs
+  internal->EdgeCosts.resize(numberOfEdges);
+  vtkSMPTools::For(0, numberOfVertices, [&](vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType u = begin; u < end; ++u)
+      {
+      for (vtkIdType edgeIndex = edgeOffsets[u]; edgeIndex < edgeOffsets[u + 1]; ++edgeIndex)
+        {
+        internal->EdgeCosts[edgeIndex] = this->CalculateStaticEdgeCost(surface, u, edgeEndVertices[edgeIndex]);
+        }
+      }
+    });
+
+  // The heuristic must not overestimate the cost of the remaining path,
+  // therefore it is scaled by the lowest cost per unit length of all edges.
+  double heuristicScale = 1.0;
+  for (vtkIdType u = 0; u < numberOfVertices; ++u)
+    {
+    for (vtkIdType edgeIndex = edgeOffsets[u]; edgeIndex < edgeOffsets[u + 1]; ++edgeIndex)
+      {
+      vtkIdType v = edgeEndVertices[edgeIndex];
+      double edgeLength = sqrt(vtkMath::Distance2BetweenPoints(
+        &internal->VertexCoordinates[3 * u], &internal->VertexCoordinates[3 * v]));
+      if (edgeLength > 0.0)
+        {
+        heuristicScale = std::min(heuristicScale, internal->EdgeCosts[edgeIndex] / edgeLength);
+        }
+      }
+    }
+  internal->HeuristicScale = std::max(heuristicScale, 0.0);
+
+  internal->GraphBuilt = true;
+  internal->GraphCostFunctionType = this->CostFunctionType;
+  internal->GraphUseScalarWeights = this->UseScalarWeights;
+  internal->GraphBuildTime.Modified();
+}
+
+//------------------------------------------------------------------------------
+vtkMTimeType vtkCjyxDijkstraGraphGeodesicPath::GetGraphBuildTime()
+{
+  return this->Internal->GraphBuildTime.GetMTime();
+}
+
+//------------------------------------------------------------------------------
+bool vtkCjyxDijkstraGraphGeodesicPath::FindShortestPath(vtkIdType startVertex, vtkIdType endVertex, vtkIdList* pathPointIds)
+{
+  vtkInternal* internal = this->Internal;
+  if (!pathPointIds)
+    {
+    return false;
+    }
+  pathPointIds->Reset();
+  vtkIdType numberOfVertices = static_cast<vtkIdType>(internal->EdgeOffsets.size()) - 1;
+  if (startVertex < 0 || startVertex >= numberOfVertices || endVertex < 0 || endVertex >= numberOfVertices)
+    {
+    return false;
+    }
+
+  vtkInternal::SearchState& state = internal->SearchStates.Local();
+  if (static_cast<vtkIdType>(state.Cost.size()) != numberOfVertices)
+    {
+    state.Cost.assign(numberOfVertices, 0.0);
+    state.Predecessor.assign(numberOfVertices, -1);
+    state.VisitedSearchId.assign(numberOfVertices, 0);
+    state.ClosedSearchId.assign(numberOfVertices, 0);
+    state.SearchId = 0;
+    }
+  ++state.SearchId;
+  if (state.SearchId == 0)
+    {
+    // search ID wrapped around, previous search IDs must be cleared
+    std::fill(state.VisitedSearchId.begin(), state.VisitedSearchId.end(), 0);
+    std::fill(state.ClosedSearchId.begin(), state.ClosedSearchId.end(), 0);
+    state.SearchId = 1;
+    }
+  const unsigned int searchId = state.SearchId;
+
+  const double* endPoint = &internal->VertexCoordinates[3 * endVertex];
+  auto heuristic = [internal, endPoint](vtkIdType vertex)
+    {
+    return internal->HeuristicScale * sqrt(vtkMath::Distance2BetweenPoints(&internal->VertexCoordinates[3 * vertex], endPoint));
+    };
+
+  // Open vertices sorted by estimated total cost
+  typedef std::pair<double, vtkIdType> OpenVertex;
+  std::priority_queue<OpenVertex, std::vector<OpenVertex>, std::greater<OpenVertex>> openVertices;
+  state.Cost[startVertex] = 0.0;
+  state.Predecessor[startVertex] = -1;
+  state.VisitedSearchId[startVertex] = searchId;
+  openVertices.emplace(heuristic(startVertex), startVertex);
+  while (!openVertices.empty())
+    {
+    vtkIdType u = openVertices.top().second;
+    openVertices.pop();
+    if (state.ClosedSearchId[u] == searchId)
+      {
+      // vertex was already reached with a lower cost
+      continue;
+      }
+    state.ClosedSearchId[u] = searchId;
+    if (u == endVertex)
+      {
+      break;
+      }
+    for (vtkIdType edgeIndex = internal->EdgeOffsets[u]; edgeIndex < internal->EdgeOffsets[u + 1]; ++edgeIndex)
+      {
+      vtkIdType v = internal->EdgeEndVertices[edgeIndex];
+      if (state.ClosedSearchId[v] == searchId)
+        {
+        continue;
+        }
+      double cost = state.Cost[u] + internal->EdgeCosts[edgeIndex];
+      if (state.VisitedSearchId[v] != searchId || cost < state.Cost[v])
+        {
+        state.VisitedSearchId[v] = searchId;
+        state.Cost[v] = cost;
+        state.Predecessor[v] = u;
+        openVertices.emplace(cost + heuristic(v), v);
+        }
+      }
+    }
+
+  if (state.ClosedSearchId[endVertex] != searchId)
+    {
+    // end vertex cannot be reached from the start vertex
+    return false;
+    }
+  for (vtkIdType vertex = endVertex; vertex >= 0; vertex = state.Predecessor[vertex])
+    {
+    pathPointIds->InsertNextId(vertex);
+    }
+  return true;
+}
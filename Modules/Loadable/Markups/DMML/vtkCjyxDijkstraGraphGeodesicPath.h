@@ -24,6 +24,8 @@
 // VTK includes
 #include <vtkDijkstraGraphGeodesicPath.h>
 
+class vtkIdList;
+
 // export
 #include "vtkCjyxMarkupsModuleDMMLExport.h"
 
@@ -54,6 +56,22 @@ public:
   vtkSetMacro(CostFunctionType, int);
   vtkGetMacro(CostFunctionType, int);
 
+  /// Build the graph of surface mesh edges that is used by FindShortestPath.
+  /// The graph is only rebuilt if the surface, the cost function type, or the use of scalar weights
+  /// has changed since the last build.
+  void UpdateGraph(vtkPolyData* surface);
+
+  /// Time of the last graph build. Paths that were computed before this time are outdated.
+  vtkMTimeType GetGraphBuildTime();
+
+  /// Find the lowest cost path between two vertices of the graph built by UpdateGraph.
+  /// A* search is used, with the Euclidean distance to the end vertex as heuristic (scaled down
+  /// if needed so that it never overestimates the edge costs).
+  /// Point ids are stored in pathPointIds from endVertex to startVertex, same order as in the filter output.
+  /// This method can be called concurrently from multiple threads.
+  /// Returns false if there is no path between the vertices.
+  bool FindShortestPath(vtkIdType startVertex, vtkIdType endVertex, vtkIdList* pathPointIds);
+
 protected:
   /// Reimplemented to rebuild the adjacency info if either CostFunctionType or UseScalarWeights are changed.
   int RequestData(vtkInformation*, vtkInformationVector**,
@@ -68,6 +86,9 @@ protected:
   int PreviousCostFunctionType;
   bool PreviousUseScalarWeights;
 
+  class vtkInternal;
+  vtkInternal* Internal;
+
 protected:
   vtkCjyxDijkstraGraphGeodesicPath();
   ~vtkCjyxDijkstraGraphGeodesicPath() override;
@@ -23,7 +23,9 @@
 
 // VTK includes
 #include <vtkCardinalSpline.h>
+#include <vtkCellArray.h>
 #include <vtkDoubleArray.h>
+#include <vtkIdList.h>
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
 #include <vtkKochanekSpline.h>
@@ -34,6 +36,7 @@
 #include <vtkPointData.h>
 #include <vtkPointLocator.h>
 #include <vtkPolyData.h>
+#include <vtkSMPTools.h>
 #include <vtkCjyxDijkstraGraphGeodesicPath.h>
 
 #include <vtkLine.h>
@@ -41,6 +44,7 @@
 // std includes
 #include <algorithm>
 #include <list>
+#include <utility>
 
 //------------------------------------------------------------------------------
 vtkStandardNewMacro(vtkCurveGenerator);
@@ -71,6 +75,7 @@ vtkCurveGenerator::vtkCurveGenerator()
   this->SurfacePointLocator = vtkSmartPointer<vtkPointLocator>::New();
   this->SurfacePathFilter = vtkSmartPointer<vtkCjyxDijkstraGraphGeodesicPath>::New();
   this->SurfacePathFilter->StopWhenEndReachedOn();
+  this->SurfacePointIds = vtkSmartPointer<vtkIdList>::New();
   this->InputParameters = nullptr;
   this->ParametricFunction = nullptr;
 }
@@ -530,9 +535,23 @@ void vtkCurveGenerator::SetParametricFunctionToPolynomial(vtkPoints* inputPoints
 //------------------------------------------------------------------------------
 int vtkCurveGenerator::GeneratePoints(vtkPoints* inputPoints, vtkPolyData* inputSurface, vtkPolyData* outputPolyData)
 {
+  this->InterpolatedPointIdsForControlPoints.clear();
+  this->SurfacePointIds->Reset();
+  this->NumberOfUpdatedSurfacePaths = 0;
+
+  if (this->IsLocalSupportCurve() && this->UpdatePointsFromFunction(inputPoints))
+    {
+    // Only the curve points near moved control points have been recomputed
+    outputPolyData->SetPoints(this->CurvePoints);
+    outputPolyData->GetPointData()->AddArray(this->CurvePedigreeIdArray);
+    return 1;
+    }
+
+  this->CurvePoints = nullptr;
+  this->CurvePedigreeIdArray = nullptr;
+
   vtkNew<vtkPoints> outputPoints;
   this->OutputCurveLength = 0.0;
-  this->InterpolatedPointIdsForControlPoints.clear();
 
   // Initialize pedigree IDs array
   vtkNew<vtkDoubleArray> outputPedigreeIdArray;
@@ -567,9 +586,164 @@ int vtkCurveGenerator::GeneratePoints(vtkPoints* inputPoints, vtkPolyData* input
 
   outputPolyData->SetPoints(outputPoints);
   outputPolyData->GetPointData()->AddArray(outputPedigreeIdArray);
+  this->NumberOfUpdatedCurvePoints = outputPoints->GetNumberOfPoints();
+
+  // Store the generated curve so that it can be updated incrementally when control points are moved
+  vtkIdType numberOfInputPoints = inputPoints->GetNumberOfPoints();
+  if (this->IsLocalSupportCurve() && numberOfInputPoints >= 2)
+    {
+    this->CurvePoints = outputPoints;
+    this->CurvePedigreeIdArray = outputPedigreeIdArray;
+    this->CurveParametersMTime = this->GetMTime();
+    this->CurveControlPointCoordinates.resize(3 * numberOfInputPoints);
+    for (vtkIdType pointIndex = 0; pointIndex < numberOfInputPoints; ++pointIndex)
+      {
+      inputPoints->GetPoint(pointIndex, &this->CurveControlPointCoordinates[3 * pointIndex]);
+      }
+    }
+  else
+    {
+    this->CurveControlPointCoordinates.clear();
+    this->CurveSampleCoordinates.clear();
+    this->CurveSampleSegmentLengths.clear();
+    }
   return 1;
 }
 
+//------------------------------------------------------------------------------
+bool vtkCurveGenerator::IsLocalSupportCurve()
+{
+  // Cardinal spline coefficients are computed by solving a system of equations for all
+  // control points, therefore moving a single control point changes the whole curve.
+  return (this->CurveType == CURVE_TYPE_LINEAR_SPLINE
+    || this->CurveType == CURVE_TYPE_KOCHANEK_SPLINE);
+}
+
+//------------------------------------------------------------------------------
+bool vtkCurveGenerator::UpdatePointsFromFunction(vtkPoints* inputPoints)
+{
+  vtkIdType numberOfInputPoints = inputPoints->GetNumberOfPoints();
+  if (!this->CurvePoints || !this->CurvePedigreeIdArray
+    || this->CurveParametersMTime != this->GetMTime()
+    || static_cast<vtkIdType>(this->CurveControlPointCoordinates.size()) != 3 * numberOfInputPoints)
+    {
+    return false;
+    }
+  vtkIdType numberOfSegments = (this->CurveIsClosed ? numberOfInputPoints : numberOfInputPoints - 1);
+  vtkIdType numberOfPointsPerSegment = this->NumberOfPointsPerInterpolatingSegment;
+  vtkIdType totalNumberOfPoints = this->CurvePoints->GetNumberOfPoints();
+  if (numberOfSegments < 1 || totalNumberOfPoints != numberOfPointsPerSegment * numberOfSegments + 1
+    || static_cast<vtkIdType>(this->CurveSampleCoordinates.size()) != 3 * totalNumberOfPoints
+    || static_cast<vtkIdType>(this->CurveSampleSegmentLengths.size()) != totalNumberOfPoints)
+    {
+    return false;
+    }
+
+  // Segment i connects control points i and i+1. Linear spline segments only depend on their
+  // two control points, Kochanek spline segments also depend on the control points before and after
+  // (through the derivatives at the segment end points).
+  vtkIdType numberOfAffectedSegmentsBefore = (this->CurveType == CURVE_TYPE_KOCHANEK_SPLINE ? 2 : 1);
+  vtkIdType numberOfAffectedSegmentsAfter = (this->CurveType == CURVE_TYPE_KOCHANEK_SPLINE ? 1 : 0);
+  std::vector<bool> segmentModified(numberOfSegments, false);
+  for (vtkIdType pointIndex = 0; pointIndex < numberOfInputPoints; ++pointIndex)
+    {
+    double controlPoint[3] = { 0.0, 0.0, 0.0 };
+    inputPoints->GetPoint(pointIndex, controlPoint);
+    double* previousControlPoint = &this->CurveControlPointCoordinates[3 * pointIndex];
+    if (controlPoint[0] == previousControlPoint[0]
+      && controlPoint[1] == previousControlPoint[1]
+      && controlPoint[2] == previousControlPoint[2])
+      {
+      continue;
+      }
+    previousControlPoint[0] = controlPoint[0];
+    previousControlPoint[1] = controlPoint[1];
+    previousControlPoint[2] = controlPoint[2];
+    for (vtkIdType segmentIndex = pointIndex - numberOfAffectedSegmentsBefore;
+      segmentIndex <= pointIndex + numberOfAffectedSegmentsAfter; ++segmentIndex)
+      {
+      if (this->CurveIsClosed)
+        {
+        segmentModified[(segmentIndex + numberOfSegments) % numberOfSegments] = true;
+        }
+      else if (segmentIndex >= 0 && segmentIndex < numberOfSegments)
+        {
+        segmentModified[segmentIndex] = true;
+        }
+      }
+    }
+
+  // The parametric function is always updated, as it is available for other computations.
+  // Spline coefficients are computed when the function is first evaluated.
+  if (this->CurveType == CURVE_TYPE_KOCHANEK_SPLINE)
+    {
+    this->SetParametricFunctionToKochanekSpline(inputPoints);
+    }
+  else
+    {
+    this->SetParametricFunctionToLinearSpline(inputPoints);
+    }
+
+  // Ranges of curve points (first and last index) to recompute
+  std::vector<std::pair<vtkIdType, vtkIdType>> modifiedRanges;
+  for (vtkIdType segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+    {
+    if (!segmentModified[segmentIndex])
+      {
+      continue;
+      }
+    vtkIdType firstPointIndex = segmentIndex * numberOfPointsPerSegment;
+    vtkIdType lastPointIndex = (segmentIndex + 1) * numberOfPointsPerSegment;
+    if (!modifiedRanges.empty() && modifiedRanges.back().second >= firstPointIndex)
+      {
+      modifiedRanges.back().second = lastPointIndex;
+      }
+    else
+      {
+      modifiedRanges.emplace_back(firstPointIndex, lastPointIndex);
+      }
+    }
+
+  this->NumberOfUpdatedCurvePoints = 0;
+  if (modifiedRanges.empty())
+    {
+    return true;
+    }
+
+  // Sample parameters must be computed exactly the same way as in GeneratePointsFromFunction
+  // so that the result is identical to regenerating the entire curve.
+  for (const std::pair<vtkIdType, vtkIdType>& range : modifiedRanges)
+    {
+    for (vtkIdType pointIndex = range.first; pointIndex <= range.second; ++pointIndex)
+      {
+      double sampleParameter = double(pointIndex) / ((double)(totalNumberOfPoints - 1));
+      double* curvePoint = &this->CurveSampleCoordinates[3 * pointIndex];
+      this->ParametricFunction->Evaluate(&sampleParameter, curvePoint, nullptr);
+      this->CurvePoints->SetPoint(pointIndex, curvePoint);
+      }
+    this->NumberOfUpdatedCurvePoints += range.second - range.first + 1;
+    }
+  for (const std::pair<vtkIdType, vtkIdType>& range : modifiedRanges)
+    {
+    vtkIdType lastPointIndex = std::min(range.second + 1, totalNumberOfPoints - 1);
+    for (vtkIdType pointIndex = std::max(range.first, vtkIdType(1)); pointIndex <= lastPointIndex; ++pointIndex)
+      {
+      this->CurveSampleSegmentLengths[pointIndex] = sqrt(vtkMath::Distance2BetweenPoints(
+        &this->CurveSampleCoordinates[3 * (pointIndex - 1)], &this->CurveSampleCoordinates[3 * pointIndex]));
+      }
+    }
+  this->CurvePoints->Modified();
+
+  // Sum the segment lengths in the same order as in GeneratePointsFromFunction
+  this->OutputCurveLength = 0.0;
+  for (vtkIdType pointIndex = 1; pointIndex < totalNumberOfPoints; ++pointIndex)
+    {
+    this->OutputCurveLength += this->CurveSampleSegmentLengths[pointIndex];
+    }
+
+  return true;
+}
+
 //------------------------------------------------------------------------------
 int vtkCurveGenerator::GeneratePointsFromFunction(vtkPoints* inputPoints, vtkPoints* outputPoints, vtkDoubleArray* outputPedigreeIdArray)
 {
@@ -627,6 +801,10 @@ int vtkCurveGenerator::GeneratePointsFromFunction(vtkPoints* inputPoints, vtkPoi
   outputPedigreeIdArray->Reset();
   outputPedigreeIdArray->FillComponent(0, 0.0);
 
+  // Sample coordinates and distances are stored for incremental update
+  this->CurveSampleCoordinates.resize(3 * totalNumberOfPoints);
+  this->CurveSampleSegmentLengths.assign(totalNumberOfPoints, 0.0);
+
   double previousPoint[3] = { 0.0 };
   for (int pointIndex = 0; pointIndex < totalNumberOfPoints; pointIndex++)
     {
@@ -634,10 +812,14 @@ int vtkCurveGenerator::GeneratePointsFromFunction(vtkPoints* inputPoints, vtkPoi
     double curvePoint[3];
     this->ParametricFunction->Evaluate(&sampleParameter, curvePoint, nullptr);
     outputPoints->InsertNextPoint(curvePoint);
+    this->CurveSampleCoordinates[3 * pointIndex] = curvePoint[0];
+    this->CurveSampleCoordinates[3 * pointIndex + 1] = curvePoint[1];
+    this->CurveSampleCoordinates[3 * pointIndex + 2] = curvePoint[2];
     if (pointIndex > 0)
       {
       double segmentLength = sqrt(vtkMath::Distance2BetweenPoints(previousPoint, curvePoint));
       this->OutputCurveLength += segmentLength;
+      this->CurveSampleSegmentLengths[pointIndex] = segmentLength;
       }
     previousPoint[0] = curvePoint[0];
     previousPoint[1] = curvePoint[1];
@@ -685,10 +867,17 @@ int vtkCurveGenerator::GeneratePointsFromSurface(
     numberOfSegments = (numberOfInputPoints - 1);
     }
 
-  this->SurfacePathFilter->SetInputData(inputSurface);
   this->SurfacePointLocator->SetDataSet(inputSurface);
   this->SurfacePointLocator->BuildLocator();
 
+  // The graph of the surface mesh is only rebuilt if the surface has changed.
+  // If the graph is the same then paths are only computed for segments whose end points moved.
+  this->SurfacePathFilter->UpdateGraph(inputSurface);
+  bool graphModified = (this->SurfacePathGraphBuildTime != this->SurfacePathFilter->GetGraphBuildTime());
+  this->SurfacePathGraphBuildTime = this->SurfacePathFilter->GetGraphBuildTime();
+  this->SurfacePathSegmentPointIds.resize(numberOfSegments);
+  this->SurfacePathSegmentEndPointIds.resize(2 * numberOfSegments, -1);
+  std::vector<vtkIdType> segmentsToUpdate;
   for (vtkIdType controlPointIndex = 0; controlPointIndex < numberOfSegments; ++controlPointIndex)
     {
     double controlPoint1[3] = { 0 };
@@ -699,21 +888,55 @@ int vtkCurveGenerator::GeneratePointsFromSurface(
     inputPoints->GetPoint((controlPointIndex + 1) % numberOfInputPoints, controlPoint2);
     vtkIdType id2 = this->SurfacePointLocator->FindClosestPoint(controlPoint2);
 
-    // Path is traced backward, so start vertex should be point2, and end should be point1.
-    this->SurfacePathFilter->SetStartVertex(id2);
-    this->SurfacePathFilter->SetEndVertex(id1);
-    this->SurfacePathFilter->Update();
+    if (!graphModified && this->SurfacePathSegmentPointIds[controlPointIndex]
+      && this->SurfacePathSegmentEndPointIds[2 * controlPointIndex] == id1
+      && this->SurfacePathSegmentEndPointIds[2 * controlPointIndex + 1] == id2)
+      {
+      // end points of the segment have not moved
+      continue;
+      }
+    this->SurfacePathSegmentEndPointIds[2 * controlPointIndex] = id1;
+    this->SurfacePathSegmentEndPointIds[2 * controlPointIndex + 1] = id2;
+    if (!this->SurfacePathSegmentPointIds[controlPointIndex])
+      {
+      this->SurfacePathSegmentPointIds[controlPointIndex] = vtkSmartPointer<vtkIdList>::New();
+      }
+    segmentsToUpdate.push_back(controlPointIndex);
+    }
+  this->NumberOfUpdatedSurfacePaths = static_cast<vtkIdType>(segmentsToUpdate.size());
+
+  // Segment paths are independent, compute them in parallel
+  vtkSMPTools::For(0, static_cast<vtkIdType>(segmentsToUpdate.size()), [&](vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType updateIndex = begin; updateIndex < end; ++updateIndex)
+      {
+      vtkIdType controlPointIndex = segmentsToUpdate[updateIndex];
+      vtkIdType id1 = this->SurfacePathSegmentEndPointIds[2 * controlPointIndex];
+      vtkIdType id2 = this->SurfacePathSegmentEndPointIds[2 * controlPointIndex + 1];
+      vtkIdList* pathPointIds = this->SurfacePathSegmentPointIds[controlPointIndex];
+      // Path is traced backward, so start vertex should be point2, and end should be point1.
+      if (!this->SurfacePathFilter->FindShortestPath(id2, id1, pathPointIds))
+        {
+        // There is no path on the surface between the points, connect them directly
+        pathPointIds->InsertNextId(id1);
+        pathPointIds->InsertNextId(id2);
+        }
+      }
+    });
 
-    vtkPolyData* outputPath = this->SurfacePathFilter->GetOutput();
+  for (vtkIdType controlPointIndex = 0; controlPointIndex < numberOfSegments; ++controlPointIndex)
+    {
+    vtkIdList* pathPointIds = this->SurfacePathSegmentPointIds[controlPointIndex];
     double previousPoint[3] = { 0 };
-    for (vtkIdType pointIndex = 0; pointIndex < outputPath->GetNumberOfPoints(); ++pointIndex)
+    for (vtkIdType pointIndex = 0; pointIndex < pathPointIds->GetNumberOfIds(); ++pointIndex)
       {
       double curvePoint[3] = { 0 };
-      outputPath->GetPoint(pointIndex, curvePoint);
+      inputSurface->GetPoint(pathPointIds->GetId(pointIndex), curvePoint);
 
       if (controlPointIndex == 0 || pointIndex > 0)
         {
         vtkIdType outputPointId = outputPoints->InsertNextPoint(curvePoint);
+        this->SurfacePointIds->InsertNextId(pathPointIds->GetId(pointIndex));
         if (static_cast<vtkIdType>(this->InterpolatedPointIdsForControlPoints.size()) <= controlPointIndex)
           {
           this->InterpolatedPointIdsForControlPoints.push_back(outputPointId);
@@ -762,7 +985,11 @@ int vtkCurveGenerator::GenerateLines(vtkPolyData* polyData)
   // Update lines: a single cell containing a line with point
   // indices: 0, 1, ..., last point (and an extra 0 if closed curve).
   vtkIdType numberOfPoints = polyData->GetNumberOfPoints();
-  vtkNew<vtkCellArray> lines;
+  if (!this->CurveLines)
+    {
+    this->CurveLines = vtkSmartPointer<vtkCellArray>::New();
+    }
+  vtkCellArray* lines = this->CurveLines;
   if (numberOfPoints > 1)
     {
     bool closed = (numberOfPoints > 2 && this->CurveIsClosed);
@@ -797,6 +1024,11 @@ int vtkCurveGenerator::GenerateLines(vtkPolyData* polyData)
       lines->Modified();
       }
     }
+  else if (lines->GetNumberOfCells() > 0)
+    {
+    lines->Reset();
+    lines->Modified();
+    }
   polyData->SetLines(lines);
   return 1;
 }
@@ -1033,7 +1265,7 @@ bool vtkCurveGenerator::IsInterpolatingCurve()
 //------------------------------------------------------------------------------
 vtkIdList* vtkCurveGenerator::GetSurfacePointIds()
 {
-  return this->SurfacePathFilter->GetIdList();
+  return this->SurfacePointIds;
 }
 
 //------------------------------------------------------------------------------
@@ -28,8 +28,13 @@
 #include <vtkSetGet.h>
 #include <vtkSmartPointer.h>
 
+// std includes
+#include <vector>
+
+class vtkCellArray;
 class vtkCjyxDijkstraGraphGeodesicPath;
 class vtkDoubleArray;
+class vtkIdList;
 class vtkPoints;
 class vtkSpline;
 
@@ -179,9 +184,13 @@ public:
   /// Currently only works for shortest surface distance
   vtkIdType GetControlPointIdFromInterpolatedPointId(vtkIdType interpolatedPointId);
 
-  /// Get the list of curve point ids on the surface mesh
+  /// Get the list of surface mesh point ids of the curve points (for shortest distance on surface curves)
   vtkIdList* GetSurfacePointIds();
 
+  /// Get the number of curve segments whose shortest path on the surface was computed in the last update.
+  /// Paths are only recomputed for segments whose end points have moved or if the surface has changed.
+  vtkGetMacro(NumberOfUpdatedSurfacePaths, vtkIdType);
+
   /// Get the length of the curve
   double GetOutputCurveLength();
 
@@ -194,6 +203,11 @@ public:
   /// Get the output sampled points
   vtkPoints* GetOutputPoints();
 
+  /// Get the number of curve points that were computed in the last update.
+  /// If only a few control points of a linear or Kochanek spline curve are moved
+  /// then only the curve points in the neighboring segments are recomputed.
+  vtkGetMacro(NumberOfUpdatedCurvePoints, vtkIdType);
+
   /// Calculates point parameters for use in vtkParametricPolynomialApproximation
   /// The parameter values are based on the point index and range from 0.0 at the start to 1.0 at the end of the line.
   /// \sa SortByMinimumSpanningTreePosition
@@ -235,8 +249,26 @@ protected:
   vtkSmartPointer<vtkDoubleArray> InputParameters;
   vtkSmartPointer<vtkParametricFunction> ParametricFunction;
 
+  // shortest distance on surface paths of each segment and the surface point ids of their end points
+  vtkSmartPointer<vtkIdList> SurfacePointIds;
+  std::vector<vtkSmartPointer<vtkIdList>> SurfacePathSegmentPointIds;
+  std::vector<vtkIdType> SurfacePathSegmentEndPointIds;
+  vtkMTimeType SurfacePathGraphBuildTime{0};
+  vtkIdType NumberOfUpdatedSurfacePaths{0};
+
   // output
   double OutputCurveLength;
+  vtkIdType NumberOfUpdatedCurvePoints{0};
+
+  // state of the last generated curve, used for updating only the segments near moved control points
+  vtkSmartPointer<vtkPoints> CurvePoints;
+  vtkSmartPointer<vtkDoubleArray> CurvePedigreeIdArray;
+  vtkSmartPointer<vtkCellArray> CurveLines;
+  vtkMTimeType CurveParametersMTime{0};
+  std::vector<double> CurveControlPointCoordinates;
+  std::vector<double> CurveSampleCoordinates;
+  /// Distance between curve point i-1 and i (first value is 0)
+  std::vector<double> CurveSampleSegmentLengths;
 
   // logic
   void SetParametricFunctionToSpline(vtkPoints* inputPoints, vtkSpline* xSpline, vtkSpline* ySpline, vtkSpline* zSpline);
@@ -245,6 +277,12 @@ protected:
   void SetParametricFunctionToKochanekSpline(vtkPoints* inputPoints);
   void SetParametricFunctionToPolynomial(vtkPoints* inputPoints);
   int GeneratePoints(vtkPoints* inputPoints, vtkPolyData* inputSurface, vtkPolyData* outputPolyData);
+  /// Returns true if a curve segment only depends on nearby control points
+  /// (moving a control point only changes the neighboring segments).
+  bool IsLocalSupportCurve();
+  /// Recompute only the curve points of segments that are affected by moved control points.
+  /// Returns false if the curve has to be fully regenerated.
+  bool UpdatePointsFromFunction(vtkPoints* inputPoints);
   int GeneratePointsFromFunction(vtkPoints* inputPoints, vtkPoints* outputPoints, vtkDoubleArray* outputPedigreeIdArray);
   int GeneratePointsFromSurface(vtkPoints* inputPoints, vtkPolyData* inputSurface, vtkPoints* outputPoints, vtkDoubleArray* outputPedigreeIdArray);
   int GenerateLines(vtkPolyData* polyData);
@@ -34,6 +34,9 @@
 #include <vtkPolyData.h>
 #include <vtkTriangleFilter.h>
 
+// STD includes
+#include <algorithm>
+
 //------------------------------------------------------------------------------
 vtkStandardNewMacro(vtkCurveMeasurementsCalculator);
 
@@ -188,6 +191,42 @@ bool vtkCurveMeasurementsCalculator::CalculatePolyDataCurvature(vtkPolyData* pol
   vtkIdType numberOfPoints = // Last point in closed curve line is the first point
     (this->CurveIsClosed ? linePoints->GetNumberOfIds()-1 : linePoints->GetNumberOfIds());
 
+  // Store curve point coordinates and find the points that have been moved since the last update
+  bool allPointsModified = (static_cast<vtkIdType>(this->CurvatureLinePointCoordinates.size()) != 3 * numberOfPoints);
+  if (allPointsModified)
+    {
+    this->CurvatureLinePointCoordinates.resize(3 * numberOfPoints);
+    this->CurvatureLinePointValues.assign(numberOfPoints, 0.0);
+    this->CurvatureLinePointWeights.assign(numberOfPoints, 0.0);
+    }
+  std::vector<vtkIdType> modifiedPointIndices;
+  for (vtkIdType idx=0; idx<numberOfPoints; ++idx)
+    {
+    double point[3] = {0.0, 0.0, 0.0};
+    points->GetPoint(linePoints->GetId(idx), point);
+    double* storedPoint = &this->CurvatureLinePointCoordinates[3*idx];
+    if (!allPointsModified && point[0] == storedPoint[0] && point[1] == storedPoint[1] && point[2] == storedPoint[2])
+      {
+      continue;
+      }
+    storedPoint[0] = point[0];
+    storedPoint[1] = point[1];
+    storedPoint[2] = point[2];
+    modifiedPointIndices.push_back(idx);
+    }
+
+  // Curvature at a point depends on the point and its two neighbors
+  vtkIdType nextPointIndexToUpdate = 1;
+  for (vtkIdType modifiedPointIndex : modifiedPointIndices)
+    {
+    vtkIdType lastPointIndexToUpdate = std::min(modifiedPointIndex + 1, numberOfPoints - 2);
+    for (vtkIdType idx = std::max(modifiedPointIndex - 1, nextPointIndexToUpdate); idx <= lastPointIndexToUpdate; ++idx)
+      {
+      this->UpdateCurvatureAtLinePoint(idx);
+      }
+    nextPointIndexToUpdate = std::max(nextPointIndexToUpdate, lastPointIndexToUpdate + 1);
+    }
+
   // Initialize curvature array
   vtkNew<vtkDoubleArray> curvatureValues;
   curvatureValues->Initialize();
@@ -198,73 +237,25 @@ bool vtkCurveMeasurementsCalculator::CalculatePolyDataCurvature(vtkPolyData* pol
   curvatureValues->FillComponent(0,0.0);
 
   // Initialize curvature variables
-  double minKappa = 0.0;
   double maxKappa = 0.0;
   double meanKappa = 0.0; // Mean is weighted by the length of each segment
-
-  // Get values for first point
-  double prevPoint[3] = {points->GetPoint(linePoints->GetId(0))[0], points->GetPoint(linePoints->GetId(0))[1], points->GetPoint(linePoints->GetId(0))[2]}; // pp
-  double* currPoint = points->GetPoint(linePoints->GetId(1)); // p
-  double diffVector[3] = {currPoint[0]-prevPoint[0], currPoint[1]-prevPoint[1], currPoint[2]-prevPoint[2]};
-  double diffNorm = sqrt(diffVector[0]*diffVector[0] + diffVector[1]*diffVector[1] + diffVector[2]*diffVector[2]); // ds
-  double normDiffVector[3] = {0.0, 0.0, 0.0}; // T
-  double prevNormDiffVector[3] = {diffVector[0]/diffNorm, diffVector[1]/diffNorm, diffVector[2]/diffNorm}; // pT
-  double meanPoint[3] = {0.0, 0.0, 0.0}; // m
-  double prevMeanPoint[3] = {currPoint[0], currPoint[1], currPoint[2]}; // pm (Skip first point)
-  double kappa = 0.0;
-  double currentLength = 0.0;
   double length = 0.0;
 
   // The curvature for the first cell is 0.0 for open curves
   curvatureValues->InsertValue(linePoints->GetId(0), 0.0);
 
-  prevPoint[0] = currPoint[0]; prevPoint[1] = currPoint[1]; prevPoint[2] = currPoint[2];
   for (vtkIdType idx=1; idx<numberOfPoints-1; ++idx)
     {
-    currPoint = points->GetPoint(linePoints->GetId(idx+1));
-
-    diffVector[0] = currPoint[0]-prevPoint[0];
-    diffVector[1] = currPoint[1]-prevPoint[1];
-    diffVector[2] = currPoint[2]-prevPoint[2];
-    diffNorm = sqrt(diffVector[0]*diffVector[0] + diffVector[1]*diffVector[1] + diffVector[2]*diffVector[2]);
-
-    normDiffVector[0] = diffVector[0] / diffNorm;
-    normDiffVector[1] = diffVector[1] / diffNorm;
-    normDiffVector[2] = diffVector[2] / diffNorm;
-
-    // Local curvature
-    kappa = sqrt( (normDiffVector[0]-prevNormDiffVector[0])*(normDiffVector[0]-prevNormDiffVector[0])
-                + (normDiffVector[1]-prevNormDiffVector[1])*(normDiffVector[1]-prevNormDiffVector[1])
-                + (normDiffVector[2]-prevNormDiffVector[2])*(normDiffVector[2]-prevNormDiffVector[2]) )
-            / diffNorm;
+    double kappa = this->CurvatureLinePointValues[idx];
     curvatureValues->InsertValue(linePoints->GetId(idx), kappa);
 
     // Statistics
-    meanPoint[0] = (currPoint[0]+prevPoint[0]) / 2.0;
-    meanPoint[1] = (currPoint[1]+prevPoint[1]) / 2.0;
-    meanPoint[2] = (currPoint[2]+prevPoint[2]) / 2.0;
-
-    currentLength = sqrt( (meanPoint[0]-prevMeanPoint[0])*(meanPoint[0]-prevMeanPoint[0])
-                        + (meanPoint[1]-prevMeanPoint[1])*(meanPoint[1]-prevMeanPoint[1])
-                        + (meanPoint[2]-prevMeanPoint[2])*(meanPoint[2]-prevMeanPoint[2]) );
-    if (kappa < minKappa)
-      {
-      minKappa = kappa;
-      }
-    else if (kappa > maxKappa)
+    if (kappa > maxKappa)
       {
       maxKappa = kappa;
       }
-    meanKappa += kappa * currentLength; // weighted mean
-    length += currentLength;
-
-    // Propagate current values to previous
-    for (int i=0; i<3; ++i)
-      {
-      prevPoint[i] = currPoint[i];
-      prevMeanPoint[i] = meanPoint[i];
-      prevNormDiffVector[i] = normDiffVector[i];
-      }
+    meanKappa += kappa * this->CurvatureLinePointWeights[idx]; // weighted mean
+    length += this->CurvatureLinePointWeights[idx];
     } // For each line point
 
   if (!this->CurveIsClosed)
@@ -281,9 +272,20 @@ bool vtkCurveMeasurementsCalculator::CalculatePolyDataCurvature(vtkPolyData* pol
       curvatureValues->GetValue(linePoints->GetId(numberOfPoints-2)));
     }
 
-  currentLength = sqrt( (prevPoint[0]-prevMeanPoint[0])*(prevPoint[0]-prevMeanPoint[0])
-                      + (prevPoint[1]-prevMeanPoint[1])*(prevPoint[1]-prevMeanPoint[1])
-                      + (prevPoint[2]-prevMeanPoint[2])*(prevPoint[2]-prevMeanPoint[2]) );
+  // Length of the half segment at the end of the curve
+  const double* lastPoint = &this->CurvatureLinePointCoordinates[3*(numberOfPoints-1)];
+  double lastMeanPoint[3] = {lastPoint[0], lastPoint[1], lastPoint[2]};
+  if (numberOfPoints > 2)
+    {
+    const double* secondLastPoint = &this->CurvatureLinePointCoordinates[3*(numberOfPoints-2)];
+    for (int i=0; i<3; ++i)
+      {
+      lastMeanPoint[i] = (lastPoint[i]+secondLastPoint[i]) / 2.0;
+      }
+    }
+  double currentLength = sqrt( (lastPoint[0]-lastMeanPoint[0])*(lastPoint[0]-lastMeanPoint[0])
+                             + (lastPoint[1]-lastMeanPoint[1])*(lastPoint[1]-lastMeanPoint[1])
+                             + (lastPoint[2]-lastMeanPoint[2])*(lastPoint[2]-lastMeanPoint[2]) );
   length += currentLength;
   meanKappa = meanKappa / length;
 
@@ -314,6 +316,46 @@ bool vtkCurveMeasurementsCalculator::CalculatePolyDataCurvature(vtkPolyData* pol
   return true;
 }
 
+//------------------------------------------------------------------------------
+void vtkCurveMeasurementsCalculator::UpdateCurvatureAtLinePoint(vtkIdType idx)
+{
+  const double* prevPoint = &this->CurvatureLinePointCoordinates[3*(idx-1)]; // pp
+  const double* currPoint = &this->CurvatureLinePointCoordinates[3*idx]; // p
+  const double* nextPoint = &this->CurvatureLinePointCoordinates[3*(idx+1)];
+
+  double prevDiffVector[3] = {currPoint[0]-prevPoint[0], currPoint[1]-prevPoint[1], currPoint[2]-prevPoint[2]};
+  double prevDiffNorm = sqrt(prevDiffVector[0]*prevDiffVector[0] + prevDiffVector[1]*prevDiffVector[1] + prevDiffVector[2]*prevDiffVector[2]);
+  double prevNormDiffVector[3] = {prevDiffVector[0]/prevDiffNorm, prevDiffVector[1]/prevDiffNorm, prevDiffVector[2]/prevDiffNorm}; // pT
+
+  double diffVector[3] = {nextPoint[0]-currPoint[0], nextPoint[1]-currPoint[1], nextPoint[2]-currPoint[2]};
+  double diffNorm = sqrt(diffVector[0]*diffVector[0] + diffVector[1]*diffVector[1] + diffVector[2]*diffVector[2]); // ds
+  double normDiffVector[3] = {diffVector[0]/diffNorm, diffVector[1]/diffNorm, diffVector[2]/diffNorm}; // T
+
+  // Local curvature
+  double kappa = sqrt( (normDiffVector[0]-prevNormDiffVector[0])*(normDiffVector[0]-prevNormDiffVector[0])
+                     + (normDiffVector[1]-prevNormDiffVector[1])*(normDiffVector[1]-prevNormDiffVector[1])
+                     + (normDiffVector[2]-prevNormDiffVector[2])*(normDiffVector[2]-prevNormDiffVector[2]) )
+                 / diffNorm;
+
+  // Weight is the distance between the midpoints of the adjacent segments (skip first point)
+  double meanPoint[3] = {0.0, 0.0, 0.0}; // m
+  double prevMeanPoint[3] = {currPoint[0], currPoint[1], currPoint[2]}; // pm
+  for (int i=0; i<3; ++i)
+    {
+    meanPoint[i] = (nextPoint[i]+currPoint[i]) / 2.0;
+    if (idx > 1)
+      {
+      prevMeanPoint[i] = (currPoint[i]+prevPoint[i]) / 2.0;
+      }
+    }
+  double currentLength = sqrt( (meanPoint[0]-prevMeanPoint[0])*(meanPoint[0]-prevMeanPoint[0])
+                             + (meanPoint[1]-prevMeanPoint[1])*(meanPoint[1]-prevMeanPoint[1])
+                             + (meanPoint[2]-prevMeanPoint[2])*(meanPoint[2]-prevMeanPoint[2]) );
+
+  this->CurvatureLinePointValues[idx] = kappa;
+  this->CurvatureLinePointWeights[idx] = currentLength;
+}
+
 //------------------------------------------------------------------------------
 bool vtkCurveMeasurementsCalculator::InterpolateControlPointMeasurementToPolyData(vtkPolyData* outputPolyData)
 {
@@ -363,10 +405,14 @@ bool vtkCurveMeasurementsCalculator::InterpolateControlPointMeasurementToPolyDat
       return false;
       }
 
-    // Observe control point data array. If it is modified, then interpolation needs to be re-run
-    controlPointValues->AddObserver(vtkCommand::ModifiedEvent, this->ControlPointArrayModifiedCallbackCommand);
-    vtkWeakPointer<vtkDoubleArray> controlPointArrayWeakPointer(controlPointValues);
-    this->ObservedControlPointArrays->AddItem(controlPointArrayWeakPointer);
+    // Observe control point data array. If it is modified, then interpolation needs to be re-run.
+    // The array is only observed once, otherwise each update would add another observation.
+    if (!this->ObservedControlPointArrays->IsItemPresent(controlPointValues))
+      {
+      controlPointValues->AddObserver(vtkCommand::ModifiedEvent, this->ControlPointArrayModifiedCallbackCommand);
+      vtkWeakPointer<vtkDoubleArray> controlPointArrayWeakPointer(controlPointValues);
+      this->ObservedControlPointArrays->AddItem(controlPointArrayWeakPointer);
+      }
 
     vtkNew<vtkDoubleArray> interpolatedMeasurement;
     std::string arrayName = !currentMeasurement->GetName().empty() ? currentMeasurement->GetName() : "Unnamed";
@@ -25,6 +25,9 @@
 #include <vtkSetGet.h>
 #include <vtkWeakPointer.h>
 
+// STD includes
+#include <vector>
+
 // Export
 #include "vtkCjyxMarkupsModuleDMMLExport.h"
 
@@ -80,6 +83,9 @@ public:
 
 protected:
   bool CalculatePolyDataCurvature(vtkPolyData* polyData);
+  /// Compute curvature and its weight (length of curve around the point) at the specified point of the line
+  /// from the stored curve point coordinates.
+  void UpdateCurvatureAtLinePoint(vtkIdType linePointIndex);
   bool InterpolateControlPointMeasurementToPolyData(vtkPolyData* outputPolyData);
 
   /// Callback function observing data array modified events.
@@ -103,6 +109,13 @@ protected:
 
   std::string CurvatureUnits;
 
+  /// Curve point coordinates (in the order of line points) that curvature values were computed from.
+  /// Curvature at a point only depends on the point and its neighbors, therefore when only a few
+  /// points are moved then only curvature values of those points and their neighbors are recomputed.
+  std::vector<double> CurvatureLinePointCoordinates;
+  std::vector<double> CurvatureLinePointValues;
+  std::vector<double> CurvatureLinePointWeights;
+
 protected:
   int FillInputPortInformation(int port, vtkInformation* info) override;
   int RequestData(vtkInformation* request, vtkInformationVector** inputVector, vtkInformationVector* outputVector) override;
@@ -0,0 +1,315 @@
+/*==============================================================================
+
+  Program: 3D Cjyx
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "vtkCurveSegmentLocator.h"
+
+// VTK includes
+#include <vtkMath.h>
+#include <vtkObjectFactory.h>
+#include <vtkPoints.h>
+
+// STD includes
+#include <algorithm>
+#include <limits>
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkCurveSegmentLocator);
+
+//----------------------------------------------------------------------------
+vtkCurveSegmentLocator::vtkCurveSegmentLocator() = default;
+
+//----------------------------------------------------------------------------
+vtkCurveSegmentLocator::~vtkCurveSegmentLocator() = default;
+
+//----------------------------------------------------------------------------
+void vtkCurveSegmentLocator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Points: " << this->Points.GetPointer() << "\n";
+  os << indent << "NumberOfSegmentsPerLeaf: " << this->NumberOfSegmentsPerLeaf << "\n";
+  os << indent << "NumberOfPoints: " << this->NumberOfPoints << "\n";
+  os << indent << "NumberOfLeaves: " << this->NumberOfLeaves << "\n";
+  os << indent << "NumberOfUpdatedLeaves: " << this->NumberOfUpdatedLeaves << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkCurveSegmentLocator::SetPoints(vtkPoints* points)
+{
+  if (this->Points == points)
+    {
+    return;
+    }
+  this->Points = points;
+  // Points may be replaced by another object that has the same content
+  // (e.g., when a filter output is regenerated), therefore the hierarchy is not
+  // discarded here, but the points are compared in the next update.
+  this->PointsChanged = true;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkPoints* vtkCurveSegmentLocator::GetPoints()
+{
+  return this->Points;
+}
+
+//----------------------------------------------------------------------------
+void vtkCurveSegmentLocator::Update()
+{
+  vtkPoints* points = this->Points;
+  vtkMTimeType pointsMTime = points ? points->GetMTime() : 0;
+  this->NumberOfUpdatedLeaves = 0;
+  if (!this->PointsChanged && pointsMTime == this->PointsMTime)
+    {
+    // up-to-date
+    return;
+    }
+  this->PointsChanged = false;
+  this->PointsMTime = pointsMTime;
+
+  vtkIdType numberOfPoints = points ? points->GetNumberOfPoints() : 0;
+  const vtkIdType segmentsPerLeaf = this->NumberOfSegmentsPerLeaf;
+  if (numberOfPoints != this->NumberOfPoints || this->NodeBounds.empty())
+    {
+    // Rebuild
+    this->NumberOfPoints = numberOfPoints;
+    this->Coordinates.resize(3 * numberOfPoints);
+    for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; ++pointIndex)
+      {
+      points->GetPoint(pointIndex, &this->Coordinates[3 * pointIndex]);
+      }
+    this->NumberOfLeaves = 0;
+    if (numberOfPoints > 0)
+      {
+      // a single point is stored in a leaf without segments
+      this->NumberOfLeaves = std::max<vtkIdType>(1, (numberOfPoints - 1 + segmentsPerLeaf - 1) / segmentsPerLeaf);
+      }
+    this->FirstLeafNodeIndex = 1;
+    while (this->FirstLeafNodeIndex < this->NumberOfLeaves)
+      {
+      this->FirstLeafNodeIndex *= 2;
+      }
+    // Unused leaves have empty bounding box, which is infinitely far from any position
+    const double emptyBounds[6] =
+      {
+      std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(),
+      std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(),
+      std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity()
+      };
+    this->NodeBounds.resize(6 * 2 * this->FirstLeafNodeIndex);
+    for (vtkIdType nodeIndex = 0; nodeIndex < 2 * this->FirstLeafNodeIndex; ++nodeIndex)
+      {
+      std::copy(emptyBounds, emptyBounds + 6, &this->NodeBounds[6 * nodeIndex]);
+      }
+    for (vtkIdType leafIndex = 0; leafIndex < this->NumberOfLeaves; ++leafIndex)
+      {
+      this->UpdateLeafBounds(leafIndex);
+      }
+    for (vtkIdType nodeIndex = this->FirstLeafNodeIndex - 1; nodeIndex >= 1; --nodeIndex)
+      {
+      this->UpdateNodeBounds(nodeIndex);
+      }
+    this->NumberOfUpdatedLeaves = this->NumberOfLeaves;
+    return;
+    }
+
+  // Number of points is unchanged, only update bounding boxes that contain moved points
+  std::vector<bool> nodeModified(2 * this->FirstLeafNodeIndex, false);
+  for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; ++pointIndex)
+    {
+    double* storedPosition = &this->Coordinates[3 * pointIndex];
+    double position[3] = { 0.0, 0.0, 0.0 };
+    points->GetPoint(pointIndex, position);
+    if (position[0] == storedPosition[0] && position[1] == storedPosition[1] && position[2] == storedPosition[2])
+      {
+      continue;
+      }
+    std::copy(position, position + 3, storedPosition);
+    // the first point of a leaf is also the last point of the previous leaf
+    vtkIdType leafIndex = std::min(pointIndex / segmentsPerLeaf, this->NumberOfLeaves - 1);
+    nodeModified[this->FirstLeafNodeIndex + leafIndex] = true;
+    if (pointIndex > 0 && pointIndex % segmentsPerLeaf == 0)
+      {
+      nodeModified[this->FirstLeafNodeIndex + pointIndex / segmentsPerLeaf - 1] = true;
+      }
+    }
+  for (vtkIdType leafIndex = 0; leafIndex < this->NumberOfLeaves; ++leafIndex)
+    {
+    if (nodeModified[this->FirstLeafNodeIndex + leafIndex])
+      {
+      this->UpdateLeafBounds(leafIndex);
+      this->NumberOfUpdatedLeaves++;
+      }
+    }
+  for (vtkIdType nodeIndex = this->FirstLeafNodeIndex - 1; nodeIndex >= 1; --nodeIndex)
+    {
+    if (nodeModified[2 * nodeIndex] || nodeModified[2 * nodeIndex + 1])
+      {
+      this->UpdateNodeBounds(nodeIndex);
+      nodeModified[nodeIndex] = true;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkCurveSegmentLocator::UpdateLeafBounds(vtkIdType leafIndex)
+{
+  vtkIdType firstPointIndex = leafIndex * this->NumberOfSegmentsPerLeaf;
+  vtkIdType lastPointIndex = std::min(firstPointIndex + this->NumberOfSegmentsPerLeaf, this->NumberOfPoints - 1);
+  double* bounds = &this->NodeBounds[6 * (this->FirstLeafNodeIndex + leafIndex)];
+  const double* position = &this->Coordinates[3 * firstPointIndex];
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    bounds[2 * axis] = position[axis];
+    bounds[2 * axis + 1] = position[axis];
+    }
+  for (vtkIdType pointIndex = firstPointIndex + 1; pointIndex <= lastPointIndex; ++pointIndex)
+    {
+    position = &this->Coordinates[3 * pointIndex];
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      bounds[2 * axis] = std::min(bounds[2 * axis], position[axis]);
+      bounds[2 * axis + 1] = std::max(bounds[2 * axis + 1], position[axis]);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkCurveSegmentLocator::UpdateNodeBounds(vtkIdType nodeIndex)
+{
+  double* bounds = &this->NodeBounds[6 * nodeIndex];
+  const double* bounds1 = &this->NodeBounds[6 * (2 * nodeIndex)];
+  const double* bounds2 = &this->NodeBounds[6 * (2 * nodeIndex + 1)];
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    bounds[2 * axis] = std::min(bounds1[2 * axis], bounds2[2 * axis]);
+    bounds[2 * axis + 1] = std::max(bounds1[2 * axis + 1], bounds2[2 * axis + 1]);
+    }
+}
+
+//----------------------------------------------------------------------------
+double vtkCurveSegmentLocator::GetDistance2ToNode(const double position[3], vtkIdType nodeIndex)
+{
+  const double* bounds = &this->NodeBounds[6 * nodeIndex];
+  double distance2 = 0.0;
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    double d = 0.0;
+    if (position[axis] < bounds[2 * axis])
+      {
+      d = bounds[2 * axis] - position[axis];
+      }
+    else if (position[axis] > bounds[2 * axis + 1])
+      {
+      d = position[axis] - bounds[2 * axis + 1];
+      }
+    distance2 += d * d;
+    }
+  return distance2;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCurveSegmentLocator::FindClosestPoint(const double position[3])
+{
+  return this->FindClosest(position, false, nullptr);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCurveSegmentLocator::FindClosestPointOnCurve(const double position[3], double closestPosition[3])
+{
+  return this->FindClosest(position, true, closestPosition);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCurveSegmentLocator::FindClosest(const double position[3], bool segments, double closestPosition[3])
+{
+  this->Update();
+  if (this->NumberOfPoints < (segments ? 2 : 1))
+    {
+    return -1;
+    }
+
+  double closestDistance2 = VTK_DOUBLE_MAX;
+  vtkIdType closestIndex = -1;
+  std::vector<vtkIdType> nodesToVisit;
+  nodesToVisit.push_back(1);
+  while (!nodesToVisit.empty())
+    {
+    vtkIdType nodeIndex = nodesToVisit.back();
+    nodesToVisit.pop_back();
+    if (this->GetDistance2ToNode(position, nodeIndex) >= closestDistance2)
+      {
+      // all points of this node are farther than the closest point found so far
+      continue;
+      }
+    if (nodeIndex < this->FirstLeafNodeIndex)
+      {
+      // Visit the closer child first
+      vtkIdType childNodeIndex1 = 2 * nodeIndex;
+      vtkIdType childNodeIndex2 = 2 * nodeIndex + 1;
+      if (this->GetDistance2ToNode(position, childNodeIndex1) < this->GetDistance2ToNode(position, childNodeIndex2))
+        {
+        std::swap(childNodeIndex1, childNodeIndex2);
+        }
+      nodesToVisit.push_back(childNodeIndex1);
+      nodesToVisit.push_back(childNodeIndex2);
+      continue;
+      }
+
+    vtkIdType firstPointIndex = (nodeIndex - this->FirstLeafNodeIndex) * this->NumberOfSegmentsPerLeaf;
+    vtkIdType lastPointIndex = std::min(firstPointIndex + this->NumberOfSegmentsPerLeaf, this->NumberOfPoints - 1);
+    if (!segments)
+      {
+      for (vtkIdType pointIndex = firstPointIndex; pointIndex <= lastPointIndex; ++pointIndex)
+        {
+        double distance2 = vtkMath::Distance2BetweenPoints(position, &this->Coordinates[3 * pointIndex]);
+        if (distance2 < closestDistance2)
+          {
+          closestDistance2 = distance2;
+          closestIndex = pointIndex;
+          }
+        }
+      continue;
+      }
+
+    for (vtkIdType segmentIndex = firstPointIndex; segmentIndex < lastPointIndex; ++segmentIndex)
+      {
+      const double* point1 = &this->Coordinates[3 * segmentIndex];
+      const double* point2 = &this->Coordinates[3 * (segmentIndex + 1)];
+      double segmentVector[3] = { point2[0] - point1[0], point2[1] - point1[1], point2[2] - point1[2] };
+      double segmentLength2 = vtkMath::Dot(segmentVector, segmentVector);
+      double t = 0.0;
+      if (segmentLength2 > 0.0)
+        {
+        double point1ToPosition[3] = { position[0] - point1[0], position[1] - point1[1], position[2] - point1[2] };
+        t = std::min(std::max(vtkMath::Dot(point1ToPosition, segmentVector) / segmentLength2, 0.0), 1.0);
+        }
+      double pointOnSegment[3] =
+        {
+        point1[0] + t * segmentVector[0],
+        point1[1] + t * segmentVector[1],
+        point1[2] + t * segmentVector[2]
+        };
+      double distance2 = vtkMath::Distance2BetweenPoints(position, pointOnSegment);
+      if (distance2 < closestDistance2)
+        {
+        closestDistance2 = distance2;
+        closestIndex = segmentIndex;
+        std::copy(pointOnSegment, pointOnSegment + 3, closestPosition);
+        }
+      }
+    }
+  return closestIndex;
+}
@@ -0,0 +1,113 @@
+/*==============================================================================
+
+  Program: 3D Cjyx
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+/**
+ * @class   vtkCurveSegmentLocator
+ * @brief   finds closest points and segments of a polyline
+ *
+ * vtkCurveSegmentLocator is a bounding volume hierarchy over the line segments
+ * of a polyline (segment i connects point i and point i+1). Each leaf contains
+ * a fixed number of consecutive segments, therefore the structure of the hierarchy
+ * only depends on the number of points. When points are moved, the hierarchy is
+ * not rebuilt but only the bounding boxes of leaves that contain moved points
+ * (and their parents) are updated.
+ *
+ * The locator is updated automatically before each query if the points have
+ * been modified since the last update.
+*/
+
+#ifndef vtkCurveSegmentLocator_h
+#define vtkCurveSegmentLocator_h
+
+#include "vtkCjyxMarkupsModuleDMMLExport.h" // For export macro
+
+// VTK includes
+#include <vtkObject.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <vector>
+
+class vtkPoints;
+
+class VTK_CJYX_MARKUPS_MODULE_DMML_EXPORT vtkCurveSegmentLocator : public vtkObject
+{
+public:
+  static vtkCurveSegmentLocator *New();
+  vtkTypeMacro(vtkCurveSegmentLocator, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Points of the polyline.
+  void SetPoints(vtkPoints* points);
+  vtkPoints* GetPoints();
+
+  /// Number of segments in each leaf of the hierarchy. Default is 16.
+  vtkSetClampMacro(NumberOfSegmentsPerLeaf, int, 1, 1024);
+  vtkGetMacro(NumberOfSegmentsPerLeaf, int);
+
+  /// Update the hierarchy if the points have been modified.
+  /// Only bounding boxes of moved points are updated if the number of points is unchanged.
+  void Update();
+
+  /// Get the index of the point that is closest to the specified position.
+  /// Returns -1 if there are no points.
+  vtkIdType FindClosestPoint(const double position[3]);
+
+  /// Get the position on the polyline that is closest to the specified position.
+  /// Returns the index of the segment that contains the closest position (the index of its first point),
+  /// or -1 if there are less than 2 points.
+  vtkIdType FindClosestPointOnCurve(const double position[3], double closestPosition[3]);
+
+  /// Number of leaves whose bounding box was recomputed in the last update.
+  vtkGetMacro(NumberOfUpdatedLeaves, vtkIdType);
+
+protected:
+  vtkCurveSegmentLocator();
+  ~vtkCurveSegmentLocator() override;
+
+  /// Compute bounding box of a leaf from the stored point coordinates
+  void UpdateLeafBounds(vtkIdType leafIndex);
+  /// Compute bounding box of a node from the bounding boxes of its children
+  void UpdateNodeBounds(vtkIdType nodeIndex);
+  /// Squared distance between a position and the bounding box of a node
+  double GetDistance2ToNode(const double position[3], vtkIdType nodeIndex);
+
+  /// Search the hierarchy for the closest point (if segments is false) or segment (if segments is true)
+  vtkIdType FindClosest(const double position[3], bool segments, double closestPosition[3]);
+
+  vtkSmartPointer<vtkPoints> Points;
+  bool PointsChanged{true};
+  vtkMTimeType PointsMTime{0};
+
+  int NumberOfSegmentsPerLeaf{16};
+
+  /// Point coordinates that the bounding boxes are computed from
+  std::vector<double> Coordinates;
+  vtkIdType NumberOfPoints{0};
+  vtkIdType NumberOfLeaves{0};
+  /// Index of the first leaf node. Nodes are stored as a complete binary tree,
+  /// the root is node 1, children of node i are 2*i and 2*i+1.
+  vtkIdType FirstLeafNodeIndex{1};
+  /// Bounding box of each node (xmin, xmax, ymin, ymax, zmin, zmax)
+  std::vector<double> NodeBounds;
+
+  vtkIdType NumberOfUpdatedLeaves{0};
+
+private:
+  vtkCurveSegmentLocator(const vtkCurveSegmentLocator&) = delete;
+  void operator=(const vtkCurveSegmentLocator&) = delete;
+};
+
+#endif
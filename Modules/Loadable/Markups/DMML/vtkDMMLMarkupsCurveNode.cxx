@@ -20,6 +20,7 @@
 // DMML includes
 #include "vtkCurveGenerator.h"
 #include "vtkCurveMeasurementsCalculator.h"
+#include "vtkCurveSegmentLocator.h"
 #include "vtkDMMLMarkupsDisplayNode.h"
 #include "vtkDMMLMeasurementLength.h"
 #include "vtkDMMLStaticMeasurement.h"
@@ -41,7 +42,6 @@
 #include <vtkDoubleArray.h>
 #include <vtkGeneralTransform.h>
 #include <vtkGenericCell.h>
-#include <vtkLine.h>
 #include <vtkMathUtilities.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
@@ -114,6 +114,7 @@ vtkDMMLMarkupsCurveNode::vtkDMMLMarkupsCurveNode()
   this->CurveMeasurementsCalculator->AddObserver(vtkCommand::ModifiedEvent, this->DMMLCallbackCommand);
 
   this->WorldOutput = vtkSmartPointer<vtkPassThroughFilter>::New();
+  this->CurveWorldLocator = vtkSmartPointer<vtkCurveSegmentLocator>::New();
   this->WorldOutput->SetInputConnection(this->CurveMeasurementsCalculator->GetOutputPort());
 
   this->CurveCoordinateSystemGeneratorWorld->SetInputConnection(this->WorldOutput->GetOutputPort());
@@ -732,8 +733,8 @@ vtkIdType vtkDMMLMarkupsCurveNode::GetClosestCurvePointIndexToPositionWorld(cons
     {
     return -1;
     }
-  this->TransformedCurvePolyLocator->Update(); // or ->BuildLocator()?
-  return this->TransformedCurvePolyLocator->FindClosestPoint(posWorld);
+  this->CurveWorldLocator->SetPoints(points);
+  return this->CurveWorldLocator->FindClosestPoint(posWorld);
 }
 
 //---------------------------------------------------------------------------
@@ -997,51 +998,9 @@ vtkIdType vtkDMMLMarkupsCurveNode::GetClosestPointPositionAlongCurveWorld(const
     return -1;
     }
 
-  // Find closest curve point
-  vtkIdType closestCurvePointIndex = this->GetClosestCurvePointIndexToPositionWorld(posWorld);
-  if (closestCurvePointIndex < 0)
-    {
-    return -1;
-    }
-  double closestCurvePoint[3] = { 0.0 };
-  points->GetPoint(closestCurvePointIndex, closestCurvePoint);
-  double closestDistance2 = vtkMath::Distance2BetweenPoints(posWorld, closestPosWorld);
-  closestPosWorld[0] = closestCurvePoint[0];
-  closestPosWorld[1] = closestCurvePoint[1];
-  closestPosWorld[2] = closestCurvePoint[2];
-  vtkIdType lineIndex = closestCurvePointIndex;
-
-  // See if we can find any points closer along the curve
-  double relativePositionAlongLine = -1.0; // between 0.0-1.0 if between the endpoints of the line segment
-  double otherPoint[3] = { 0.0 };
-  double closestPointOnLine[3] = { 0.0 };
-  if (closestCurvePointIndex - 1 >= 0)
-    {
-    points->GetPoint(closestCurvePointIndex - 1, otherPoint);
-    double distance2 = vtkLine::DistanceToLine(posWorld, closestCurvePoint, otherPoint, relativePositionAlongLine, closestPointOnLine);
-    if (distance2 < closestDistance2 && relativePositionAlongLine >= 0 && relativePositionAlongLine <= 1)
-      {
-      closestDistance2 = distance2;
-      closestPosWorld[0] = closestPointOnLine[0];
-      closestPosWorld[1] = closestPointOnLine[1];
-      closestPosWorld[2] = closestPointOnLine[2];
-      lineIndex = closestCurvePointIndex - 1;
-      }
-    }
-  if (closestCurvePointIndex + 1 < points->GetNumberOfPoints())
-    {
-    points->GetPoint(closestCurvePointIndex + 1, otherPoint);
-    double distance2 = vtkLine::DistanceToLine(posWorld, closestCurvePoint, otherPoint, relativePositionAlongLine, closestPointOnLine);
-    if (distance2 < closestDistance2 && relativePositionAlongLine >= 0 && relativePositionAlongLine <= 1)
-      {
-      closestDistance2 = distance2;
-      closestPosWorld[0] = closestPointOnLine[0];
-      closestPosWorld[1] = closestPointOnLine[1];
-      closestPosWorld[2] = closestPointOnLine[2];
-      lineIndex = closestCurvePointIndex;
-      }
-    }
-  return lineIndex;
+  // Find closest curve segment
+  this->CurveWorldLocator->SetPoints(points);
+  return this->CurveWorldLocator->FindClosestPointOnCurve(posWorld, closestPosWorld);
 }
 
 //---------------------------------------------------------------------------
@@ -38,6 +38,7 @@ class vtkAssignAttribute;
 class vtkCallbackCommand;
 class vtkCleanPolyData;
 class vtkCurveMeasurementsCalculator;
+class vtkCurveSegmentLocator;
 class vtkPassThroughFilter;
 class vtkPlane;
 class vtkProjectMarkupsCurvePointsFilter;
@@ -309,6 +310,9 @@ protected:
   vtkSmartPointer<vtkPassThroughFilter> SurfaceScalarPassThroughFilter;
   vtkSmartPointer<vtkCurveMeasurementsCalculator> CurveMeasurementsCalculator;
   vtkSmartPointer<vtkPassThroughFilter> WorldOutput;
+  /// Locator for closest point queries on the world curve. It is kept between queries
+  /// and only the parts of the curve that are moved are updated.
+  vtkSmartPointer<vtkCurveSegmentLocator> CurveWorldLocator;
   const char* ShortestDistanceSurfaceActiveScalar;
 
   /// Filter that changes the active scalar of the input mesh using the ActiveScalarName
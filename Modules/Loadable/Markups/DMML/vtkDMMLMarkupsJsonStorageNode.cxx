@@ -46,6 +46,7 @@
 
 #include "rapidjson/document.h"     // rapidjson's DOM-style API
 #include "rapidjson/prettywriter.h" // for stringify JSON
+#include "rapidjson/reader.h"      // rapidjson's SAX-style API
 #include "rapidjson/filereadstream.h"
 #include "rapidjson/filewritestream.h"
 
@@ -60,6 +61,315 @@ namespace
 
 #include <vtkDMMLMarkupsJsonStorageNode_Private.h>
 
+//---------------------------------------------------------------------------
+// vtkInternal::ReaderHandler methods
+
+//---------------------------------------------------------------------------
+class vtkDMMLMarkupsJsonStorageNode::vtkInternal::ReaderHandler
+{
+public:
+  ReaderHandler(rapidjson::Document& document)
+    : Document(document)
+  {
+  }
+
+  /// Parsed control points, for each markup index
+  std::map<int, std::unique_ptr<ControlPointItemList> > ControlPointLists;
+
+  // Implementation of rapidjson Handler concept
+
+  bool Null() { return this->StreamingDepth ? this->StreamInvalidValue() : this->Document.Null(); }
+  bool Bool(bool b) { return this->StreamingDepth ? this->StreamBool(b) : this->Document.Bool(b); }
+  bool Int(int i) { return this->StreamingDepth ? this->StreamInvalidValue() : this->Document.Int(i); }
+  bool Uint(unsigned i) { return this->StreamingDepth ? this->StreamInvalidValue() : this->Document.Uint(i); }
+  bool Int64(int64_t i) { return this->StreamingDepth ? this->StreamInvalidValue() : this->Document.Int64(i); }
+  bool Uint64(uint64_t i) { return this->StreamingDepth ? this->StreamInvalidValue() : this->Document.Uint64(i); }
+  bool Double(double d) { return this->StreamingDepth ? this->StreamDouble(d) : this->Document.Double(d); }
+  bool RawNumber(const char* str, rapidjson::SizeType length, bool copy)
+  {
+    return this->StreamingDepth ? this->StreamInvalidValue() : this->Document.RawNumber(str, length, copy);
+  }
+  bool String(const char* str, rapidjson::SizeType length, bool copy)
+  {
+    return this->StreamingDepth ? this->StreamString(str, length) : this->Document.String(str, length, copy);
+  }
+
+  bool Key(const char* str, rapidjson::SizeType length, bool copy)
+  {
+    if (this->StreamingDepth)
+      {
+      if (this->StreamingDepth == 2)
+        {
+        this->MemberKey.assign(str, length);
+        }
+      return true;
+      }
+    if (this->Containers.size() == 1)
+      {
+      this->RootKey.assign(str, length);
+      }
+    this->LastKey.assign(str, length);
+    return this->Document.Key(str, length, copy);
+  }
+
+  bool StartObject()
+  {
+    if (this->StreamingDepth)
+      {
+      return this->StreamStartContainer(false);
+      }
+    if (this->Containers.size() == 2 && this->IsInMarkupsArray())
+      {
+      this->MarkupIndex++;
+      }
+    this->Containers.push_back('o');
+    return this->Document.StartObject();
+  }
+
+  bool EndObject(rapidjson::SizeType memberCount)
+  {
+    if (this->StreamingDepth)
+      {
+      return this->StreamEndContainer();
+      }
+    this->Containers.pop_back();
+    return this->Document.EndObject(memberCount);
+  }
+
+  bool StartArray()
+  {
+    if (this->StreamingDepth)
+      {
+      return this->StreamStartContainer(true);
+      }
+    if (this->Containers.size() == 3 && this->Containers[2] == 'o' && this->IsInMarkupsArray()
+      && this->LastKey == "controlPoints")
+      {
+      // Control points of a markup: items are parsed into a list, an empty array is stored in the document
+      this->StreamingDepth = 1;
+      this->CurrentList = new ControlPointItemList;
+      this->ControlPointLists[this->MarkupIndex].reset(this->CurrentList);
+      return this->Document.StartArray();
+      }
+    this->Containers.push_back('a');
+    return this->Document.StartArray();
+  }
+
+  bool EndArray(rapidjson::SizeType elementCount)
+  {
+    if (this->StreamingDepth == 1)
+      {
+      this->StreamingDepth = 0;
+      this->CurrentList = nullptr;
+      return this->Document.EndArray(0);
+      }
+    if (this->StreamingDepth)
+      {
+      return this->StreamEndContainer();
+      }
+    this->Containers.pop_back();
+    return this->Document.EndArray(elementCount);
+  }
+
+protected:
+  /// Returns true if the current value is within the "markups" array of the root object
+  bool IsInMarkupsArray()
+  {
+    return this->Containers.size() >= 2
+      && this->Containers[0] == 'o' && this->Containers[1] == 'a' && this->RootKey == "markups";
+  }
+
+  bool StreamStartContainer(bool isArray)
+  {
+    if (this->StreamingDepth == 1)
+      {
+      // start of a control point
+      this->CurrentItem = nullptr;
+      if (!isArray)
+        {
+        this->CurrentList->emplace_back();
+        this->CurrentItem = &this->CurrentList->back();
+        }
+      }
+    else if (this->StreamingDepth == 2)
+      {
+      // start of a vector
+      this->SetMemberSpecified();
+      this->NumberOfValues = 0;
+      this->ValuesValid = isArray;
+      }
+    else
+      {
+      // vectors must not contain containers
+      this->ValuesValid = false;
+      }
+    this->StreamingDepth++;
+    return true;
+  }
+
+  bool StreamEndContainer()
+  {
+    this->StreamingDepth--;
+    if (this->StreamingDepth == 1)
+      {
+      this->CurrentItem = nullptr;
+      }
+    else if (this->StreamingDepth == 2 && this->CurrentItem)
+      {
+      // end of a vector
+      if (this->MemberKey == "position")
+        {
+        this->CurrentItem->PositionValid = (this->ValuesValid && this->NumberOfValues == 3);
+        if (this->NumberOfValues == 3)
+          {
+          std::copy(this->Values, this->Values + 3, this->CurrentItem->ControlPoint->Position);
+          }
+        }
+      else if (this->MemberKey == "orientation")
+        {
+        this->CurrentItem->OrientationValid = (this->ValuesValid && this->NumberOfValues == 9);
+        if (this->NumberOfValues == 9)
+          {
+          std::copy(this->Values, this->Values + 9, this->CurrentItem->ControlPoint->OrientationMatrix);
+          }
+        }
+      }
+    return true;
+  }
+
+  /// Mark position or orientation as specified (but not valid yet)
+  void SetMemberSpecified()
+  {
+    if (!this->CurrentItem)
+      {
+      return;
+      }
+    if (this->MemberKey == "position")
+      {
+      this->CurrentItem->PositionSpecified = true;
+      this->CurrentItem->PositionValid = false;
+      }
+    else if (this->MemberKey == "orientation")
+      {
+      this->CurrentItem->OrientationSpecified = true;
+      this->CurrentItem->OrientationValid = false;
+      }
+  }
+
+  bool StreamDouble(double d)
+  {
+    if (this->StreamingDepth == 3)
+      {
+      if (this->NumberOfValues < 9)
+        {
+        this->Values[this->NumberOfValues] = d;
+        }
+      this->NumberOfValues++;
+      }
+    else if (this->StreamingDepth == 2)
+      {
+      this->SetMemberSpecified();
+      }
+    return true;
+  }
+
+  bool StreamInvalidValue()
+  {
+    if (this->StreamingDepth == 3)
+      {
+      this->ValuesValid = false;
+      this->NumberOfValues++;
+      }
+    else if (this->StreamingDepth == 2)
+      {
+      this->SetMemberSpecified();
+      }
+    return true;
+  }
+
+  bool StreamBool(bool b)
+  {
+    if (this->StreamingDepth != 2 || !this->CurrentItem)
+      {
+      return this->StreamInvalidValue();
+      }
+    vtkDMMLMarkupsNode::ControlPoint* cp = this->CurrentItem->ControlPoint.get();
+    if (this->MemberKey == "selected")
+      {
+      cp->Selected = b;
+      }
+    else if (this->MemberKey == "locked")
+      {
+      cp->Locked = b;
+      }
+    else if (this->MemberKey == "visibility")
+      {
+      cp->Visibility = b;
+      }
+    else
+      {
+      this->SetMemberSpecified();
+      }
+    return true;
+  }
+
+  bool StreamString(const char* str, rapidjson::SizeType length)
+  {
+    if (this->StreamingDepth != 2 || !this->CurrentItem)
+      {
+      return this->StreamInvalidValue();
+      }
+    vtkDMMLMarkupsNode::ControlPoint* cp = this->CurrentItem->ControlPoint.get();
+    if (this->MemberKey == "id")
+      {
+      cp->ID.assign(str, length);
+      }
+    else if (this->MemberKey == "label")
+      {
+      cp->Label.assign(str, length);
+      }
+    else if (this->MemberKey == "description")
+      {
+      cp->Description.assign(str, length);
+      }
+    else if (this->MemberKey == "associatedNodeID")
+      {
+      cp->AssociatedNodeID.assign(str, length);
+      }
+    else if (this->MemberKey == "positionStatus")
+      {
+      this->CurrentItem->PositionStatusSpecified = true;
+      this->CurrentItem->PositionStatus.assign(str, length);
+      }
+    else
+      {
+      this->SetMemberSpecified();
+      }
+    return true;
+  }
+
+  rapidjson::Document& Document;
+
+  /// Types of containers ('o' for object, 'a' for array) from the root to the current value (when not streaming)
+  std::vector<char> Containers;
+  /// Last key in the root object
+  std::string RootKey;
+  /// Last key in the current object
+  std::string LastKey;
+  /// Index of the current item in the markups array
+  int MarkupIndex{-1};
+
+  /// Depth within the streamed controlPoints array (0 = not streaming, 1 = in the array,
+  /// 2 = in a control point, 3 = in a vector of a control point)
+  int StreamingDepth{0};
+  ControlPointItemList* CurrentList{nullptr};
+  ControlPointItem* CurrentItem{nullptr};
+  std::string MemberKey;
+  double Values[9];
+  int NumberOfValues{0};
+  bool ValuesValid{false};
+};
+
 //---------------------------------------------------------------------------
 // vtkInternal methods
 
@@ -104,17 +414,49 @@ std::unique_ptr<rapidjson::Document> vtkDMMLMarkupsJsonStorageNode::vtkInternal:
       "Error opening the file '" << filePath << "'");
     return nullptr;
     }
+  this->StreamedControlPoints.clear();
   std::unique_ptr<rapidjson::Document> jsonRoot = std::unique_ptr<rapidjson::Document>(new rapidjson::Document);
-  char buffer[4096];
+  char buffer[65536];
   rapidjson::FileReadStream fs(fp, buffer, sizeof(buffer));
-  if (jsonRoot->ParseStream(fs).HasParseError())
-  {
+  // Control points are parsed directly into control point items, all other content
+  // is stored in the document.
+  std::map<int, std::unique_ptr<ControlPointItemList> > controlPointLists;
+  rapidjson::ParseResult parseResult;
+  auto parser = [&](rapidjson::Document& document) -> bool
+    {
+    ReaderHandler handler(document);
+    rapidjson::Reader reader;
+    parseResult = reader.Parse(fs, handler);
+    controlPointLists = std::move(handler.ControlPointLists);
+    return !parseResult.IsError();
+    };
+  jsonRoot->Populate(parser);
+  fclose(fp);
+  if (parseResult.IsError())
+    {
     vtkErrorToMessageCollectionWithObjectMacro(this->External, this->External->GetUserMessages(), "vtkDMMLMarkupsJsonStorageNode::ReadDataInternal",
       "Error parsing the file'" << filePath << "'");
-    fclose(fp);
     return nullptr;
-  }
-  fclose(fp);
+    }
+
+  // Associate parsed control points with the controlPoints arrays in the document
+  if (jsonRoot->IsObject() && jsonRoot->HasMember("markups") && (*jsonRoot)["markups"].IsArray())
+    {
+    rapidjson::Value& markups = (*jsonRoot)["markups"];
+    for (auto& controlPointList : controlPointLists)
+      {
+      if (controlPointList.first < 0 || controlPointList.first >= static_cast<int>(markups.Size()))
+        {
+        continue;
+        }
+      rapidjson::Value& markup = markups[controlPointList.first];
+      if (!markup.IsObject() || !markup.HasMember("controlPoints"))
+        {
+        continue;
+        }
+      this->StreamedControlPoints[&markup["controlPoints"]] = std::move(controlPointList.second);
+      }
+    }
 
   // Verify schema
   if (!(*jsonRoot).HasMember("@schema"))
@@ -178,122 +520,174 @@ bool vtkDMMLMarkupsJsonStorageNode::vtkInternal::ReadControlPoints(rapidjson::Va
       "File reading failed: invalid controlPoints item (it is expected to be an array).");
     return false;
     }
+
+  // Control points are already parsed if the array was streamed from a file
+  std::unique_ptr<ControlPointItemList> streamedControlPoints;
+  auto streamedControlPointsIt = this->StreamedControlPoints.find(&controlPointsArray);
+  if (streamedControlPointsIt != this->StreamedControlPoints.end())
+    {
+    streamedControlPoints = std::move(streamedControlPointsIt->second);
+    this->StreamedControlPoints.erase(streamedControlPointsIt);
+    }
+  int numberOfControlPoints = (streamedControlPoints ? static_cast<int>(streamedControlPoints->size())
+    : static_cast<int>(controlPointsArray.Size()));
+
   bool wasUpdatingPoints = markupsNode->IsUpdatingPoints;
   markupsNode->IsUpdatingPoints = true;
-  for (rapidjson::SizeType controlPointIndex = 0; controlPointIndex < controlPointsArray.Size(); ++controlPointIndex)
+  markupsNode->GetControlPoints()->reserve(markupsNode->GetNumberOfControlPoints() + numberOfControlPoints);
+  bool success = true;
+  for (int controlPointIndex = 0; controlPointIndex < numberOfControlPoints && success; ++controlPointIndex)
     {
-    rapidjson::Value& controlPointItem = controlPointsArray[controlPointIndex];
-    vtkDMMLMarkupsNode::ControlPoint* cp = new vtkDMMLMarkupsNode::ControlPoint;
-    if (controlPointItem.HasMember("id"))
-      {
-      cp->ID = controlPointItem["id"].GetString();
-      }
-    if (controlPointItem.HasMember("label"))
+    if (streamedControlPoints)
       {
-      cp->Label = controlPointItem["label"].GetString();
+      success = this->AddControlPointItem((*streamedControlPoints)[controlPointIndex], controlPointIndex, coordinateSystem, markupsNode);
       }
-    if (controlPointItem.HasMember("description"))
+    else
       {
-      cp->Description = controlPointItem["description"].GetString();
+      ControlPointItem item;
+      this->ReadControlPointItem(controlPointsArray[controlPointIndex], item);
+      success = this->AddControlPointItem(item, controlPointIndex, coordinateSystem, markupsNode);
       }
-    if (controlPointItem.HasMember("associatedNodeID"))
+    }
+
+  markupsNode->IsUpdatingPoints = wasUpdatingPoints;
+  if (!success)
+    {
+    return false;
+    }
+  markupsNode->UpdateAllMeasurements();
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkDMMLMarkupsJsonStorageNode::vtkInternal::ReadControlPointItem(rapidjson::Value& controlPointItem, ControlPointItem& item)
+{
+  vtkDMMLMarkupsNode::ControlPoint* cp = item.ControlPoint.get();
+  if (controlPointItem.HasMember("id"))
+    {
+    cp->ID = controlPointItem["id"].GetString();
+    }
+  if (controlPointItem.HasMember("label"))
+    {
+    cp->Label = controlPointItem["label"].GetString();
+    }
+  if (controlPointItem.HasMember("description"))
+    {
+    cp->Description = controlPointItem["description"].GetString();
+    }
+  if (controlPointItem.HasMember("associatedNodeID"))
+    {
+    cp->AssociatedNodeID = controlPointItem["associatedNodeID"].GetString();
+    }
+  if (controlPointItem.HasMember("positionStatus"))
+    {
+    item.PositionStatusSpecified = true;
+    item.PositionStatus = controlPointItem["positionStatus"].GetString();
+    }
+  if (controlPointItem.HasMember("position"))
+    {
+    item.PositionSpecified = true;
+    item.PositionValid = this->ReadVector(controlPointItem["position"], cp->Position);
+    }
+  if (controlPointItem.HasMember("orientation"))
+    {
+    item.OrientationSpecified = true;
+    item.OrientationValid = this->ReadVector(controlPointItem["orientation"], cp->OrientationMatrix, 9);
+    }
+  if (controlPointItem.HasMember("selected"))
+    {
+    cp->Selected = controlPointItem["selected"].GetBool();
+    }
+  if (controlPointItem.HasMember("locked"))
+    {
+    cp->Locked = controlPointItem["locked"].GetBool();
+    }
+  if (controlPointItem.HasMember("visibility"))
+    {
+    cp->Visibility = controlPointItem["visibility"].GetBool();
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkDMMLMarkupsJsonStorageNode::vtkInternal::AddControlPointItem(ControlPointItem& item,
+  int controlPointIndex, int coordinateSystem, vtkDMMLMarkupsNode* markupsNode)
+{
+  vtkDMMLMarkupsNode::ControlPoint* cp = item.ControlPoint.get();
+  if (item.PositionStatusSpecified)
+    {
+    int positionStatus = vtkDMMLMarkupsNode::GetPositionStatusFromString(item.PositionStatus.c_str());
+    if (positionStatus < 0)
       {
-      cp->AssociatedNodeID = controlPointItem["associatedNodeID"].GetString();
+      vtkErrorToMessageCollectionWithObjectMacro(this->External, this->External->GetUserMessages(),
+        "vtkDMMLMarkupsJsonStorageNode::vtkInternal::ReadControlPoints",
+        "File reading failed: invalid positionStatus '" << item.PositionStatus
+        << "' for control point " << controlPointIndex + 1 << ".");
+      return false;
       }
-
-    if (controlPointItem.HasMember("positionStatus"))
+    cp->PositionStatus = positionStatus;
+    }
+  if (item.PositionSpecified)
+    {
+    if (!item.PositionValid)
       {
-      int positionStatus = vtkDMMLMarkupsNode::GetPositionStatusFromString(controlPointItem["positionStatus"].GetString());
-      if (positionStatus < 0)
+      // If positionStatus is not defined there is a position value
+      // then it indicates that a valid position should be present,
+      // therefore it is an error that the position vector is invalid.
+      if (!item.PositionStatusSpecified
+        || cp->PositionStatus == vtkDMMLMarkupsNode::PositionDefined)
         {
         vtkErrorToMessageCollectionWithObjectMacro(this->External, this->External->GetUserMessages(),
           "vtkDMMLMarkupsJsonStorageNode::vtkInternal::ReadControlPoints",
-          "File reading failed: invalid positionStatus '" << controlPointItem["positionStatus"].GetString()
-          << "' for control point " << controlPointIndex + 1 << ".");
+          "File reading failed: position must be a 3-element numeric array"
+          << " for control point " << controlPointIndex + 1 << ".");
         return false;
         }
-      cp->PositionStatus = positionStatus;
       }
-    if (controlPointItem.HasMember("position"))
+    if (coordinateSystem == vtkDMMLStorageNode::CoordinateSystemLPS)
       {
-      rapidjson::Value& positionItem = controlPointItem["position"];
-      if (!this->ReadVector(positionItem, cp->Position))
-        {
-        // If positionStatus is not defined there is a position value
-        // then it indicates that a valid position should be present,
-        // therefore it is an error that the position vector is invalid.
-        if (!controlPointItem.HasMember("positionStatus")
-          || cp->PositionStatus == vtkDMMLMarkupsNode::PositionDefined)
-          {
-          vtkErrorToMessageCollectionWithObjectMacro(this->External, this->External->GetUserMessages(),
-            "vtkDMMLMarkupsJsonStorageNode::vtkInternal::ReadControlPoints",
-            "File reading failed: position must be a 3-element numeric array"
-            << " for control point " << controlPointIndex + 1 << ".");
-          return false;
-          }
-        }
-      if (coordinateSystem == vtkDMMLStorageNode::CoordinateSystemLPS)
-        {
-        cp->Position[0] = -cp->Position[0];
-        cp->Position[1] = -cp->Position[1];
-        }
-      if (!controlPointItem.HasMember("positionStatus"))
-        {
-        cp->PositionStatus = vtkDMMLMarkupsNode::PositionDefined;
-        }
+      cp->Position[0] = -cp->Position[0];
+      cp->Position[1] = -cp->Position[1];
       }
-    else
+    if (!item.PositionStatusSpecified)
       {
-      if (controlPointItem.HasMember("positionStatus")
-        && cp->PositionStatus == vtkDMMLMarkupsNode::PositionDefined)
-        {
-        vtkWarningToMessageCollectionWithObjectMacro(this->External, this->External->GetUserMessages(),
-          "vtkDMMLMarkupsJsonStorageNode::vtkInternal::ReadControlPoints",
-          "File content is inconsistent: positionStatus is set to defined but no position values are provided"
-          << " for control point " << controlPointIndex + 1 << ".");
-        }
-      cp->PositionStatus = vtkDMMLMarkupsNode::PositionUndefined;
+      cp->PositionStatus = vtkDMMLMarkupsNode::PositionDefined;
       }
-
-    if (controlPointItem.HasMember("orientation"))
+    }
+  else
+    {
+    if (item.PositionStatusSpecified
+      && cp->PositionStatus == vtkDMMLMarkupsNode::PositionDefined)
       {
-      rapidjson::Value& orientationItem = controlPointItem["orientation"];
-      if (!this->ReadVector(orientationItem, cp->OrientationMatrix, 9))
-        {
-        vtkErrorToMessageCollectionWithObjectMacro(this->External, this->External->GetUserMessages(),
-          "vtkDMMLMarkupsJsonStorageNode::vtkInternal::ReadControlPoints",
-          "File reading failed: position must be a 3-element numeric array"
-          << " for control point " << controlPointIndex + 1 << ".");
-        return false;
-        }
-      if (coordinateSystem == vtkDMMLStorageNode::CoordinateSystemLPS)
-        {
-        for (int i = 0; i < 6; ++i)
-          {
-          cp->OrientationMatrix[i] *= -1.0;
-          }
-        }
+      vtkWarningToMessageCollectionWithObjectMacro(this->External, this->External->GetUserMessages(),
+        "vtkDMMLMarkupsJsonStorageNode::vtkInternal::ReadControlPoints",
+        "File content is inconsistent: positionStatus is set to defined but no position values are provided"
+        << " for control point " << controlPointIndex + 1 << ".");
       }
+    cp->PositionStatus = vtkDMMLMarkupsNode::PositionUndefined;
+    }
 
-    if (controlPointItem.HasMember("selected"))
-      {
-      cp->Selected = controlPointItem["selected"].GetBool();
-      }
-    if (controlPointItem.HasMember("locked"))
+  if (item.OrientationSpecified)
+    {
+    if (!item.OrientationValid)
       {
-      cp->Locked = controlPointItem["locked"].GetBool();
+      vtkErrorToMessageCollectionWithObjectMacro(this->External, this->External->GetUserMessages(),
+        "vtkDMMLMarkupsJsonStorageNode::vtkInternal::ReadControlPoints",
+        "File reading failed: orientation must be a 9-element numeric array"
+        << " for control point " << controlPointIndex + 1 << ".");
+      return false;
       }
-    if (controlPointItem.HasMember("visibility"))
+    if (coordinateSystem == vtkDMMLStorageNode::CoordinateSystemLPS)
       {
-      cp->Visibility = controlPointItem["visibility"].GetBool();
+      for (int i = 0; i < 6; ++i)
+        {
+        cp->OrientationMatrix[i] *= -1.0;
+        }
       }
-
-    markupsNode->AddControlPoint(cp, false);
     }
 
-  markupsNode->IsUpdatingPoints = wasUpdatingPoints;
-  markupsNode->UpdateAllMeasurements();
-
+  // markups node takes ownership of the control point
+  markupsNode->AddControlPoint(item.ControlPoint.release(), false);
   return true;
 }
 
@@ -929,8 +1323,7 @@ bool vtkDMMLMarkupsJsonStorageNode::vtkInternal::WriteControlPoints(
 
     if(cp->PositionStatus == vtkDMMLMarkupsNode::PositionDefined)
       {
-      double xyz[3] = { 0.0, 0.0, 0.0 };
-      markupsNode->GetNthControlPointPosition(controlPointIndex, xyz);
+      double xyz[3] = { cp->Position[0], cp->Position[1], cp->Position[2] };
       if (coordinateSystem == vtkDMMLStorageNode::CoordinateSystemLPS)
         {
         xyz[0] = -xyz[0];
@@ -942,7 +1335,7 @@ bool vtkDMMLMarkupsJsonStorageNode::vtkInternal::WriteControlPoints(
       {
       writer.Key("position"); writer.String("");
       }
-    double* orientationMatrix = markupsNode->GetNthControlPointOrientationMatrix(controlPointIndex);
+    double* orientationMatrix = cp->OrientationMatrix;
     if (coordinateSystem == vtkDMMLStorageNode::CoordinateSystemLPS)
       {
       double orientationMatrixLPS[9] = {
@@ -1122,7 +1515,10 @@ void vtkDMMLMarkupsJsonStorageNode::vtkInternal::WriteVector(
     writer.Double(v[i]);
     }
   writer.EndArray();
-  writer.SetFormatOptions(rapidjson::kFormatDefault);
+  if (!this->External->GetCompactFormat())
+    {
+    writer.SetFormatOptions(rapidjson::kFormatDefault);
+    }
 }
 
 //---------------------------------------------------------------------------
@@ -1157,24 +1553,38 @@ vtkDMMLMarkupsJsonStorageNode::~vtkDMMLMarkupsJsonStorageNode() = default;
 void vtkDMMLMarkupsJsonStorageNode::WriteXML(ostream& of, int nIndent)
 {
   Superclass::WriteXML(of,nIndent);
+  vtkDMMLWriteXMLBeginMacro(of);
+  vtkDMMLWriteXMLBooleanMacro(compactFormat, CompactFormat);
+  vtkDMMLWriteXMLEndMacro();
 }
 
 //----------------------------------------------------------------------------
 void vtkDMMLMarkupsJsonStorageNode::ReadXMLAttributes(const char** atts)
 {
+  DMMLNodeModifyBlocker blocker(this);
   Superclass::ReadXMLAttributes(atts);
+  vtkDMMLReadXMLBeginMacro(atts);
+  vtkDMMLReadXMLBooleanMacro(compactFormat, CompactFormat);
+  vtkDMMLReadXMLEndMacro();
 }
 
 //----------------------------------------------------------------------------
 void vtkDMMLMarkupsJsonStorageNode::PrintSelf(ostream& os, vtkIndent indent)
 {
   Superclass::PrintSelf(os,indent);
+  vtkDMMLPrintBeginMacro(os, indent);
+  vtkDMMLPrintBooleanMacro(CompactFormat);
+  vtkDMMLPrintEndMacro();
 }
 
 //----------------------------------------------------------------------------
 void vtkDMMLMarkupsJsonStorageNode::Copy(vtkDMMLNode *anode)
 {
+  DMMLNodeModifyBlocker blocker(anode);
   Superclass::Copy(anode);
+  vtkDMMLCopyBeginMacro(anode);
+  vtkDMMLCopyBooleanMacro(CompactFormat);
+  vtkDMMLCopyEndMacro();
 }
 
 //----------------------------------------------------------------------------
@@ -1192,6 +1602,7 @@ void vtkDMMLMarkupsJsonStorageNode::GetMarkupsTypesInFile(const char* filePath,
     // error is already logged
     return;
     }
+  this->Internal->StreamedControlPoints.clear();
   rapidjson::Value& markups = (*jsonRoot)["markups"];
   if (markups.IsArray())
     {
@@ -1282,6 +1693,8 @@ vtkDMMLMarkupsNode* vtkDMMLMarkupsJsonStorageNode::AddNewMarkupsNodeFromFile(con
 
   bool success = true;
   success = success && this->Internal->UpdateMarkupsNodeFromJsonValue(markupsNode, markup);
+  // control points of other markups in the file are not needed
+  this->Internal->StreamedControlPoints.clear();
 
   vtkDMMLMarkupsDisplayNode* displayNode = nullptr;
   if (success && markupsNode)
@@ -1357,6 +1770,8 @@ int vtkDMMLMarkupsJsonStorageNode::ReadDataInternal(vtkDMMLNode *refNode)
 
   vtkDMMLMarkupsNode* markupsNode = vtkDMMLMarkupsNode::SafeDownCast(refNode);
   bool success = this->Internal->UpdateMarkupsNodeFromJsonValue(markupsNode, markup);
+  // control points of other markups in the file are not needed
+  this->Internal->StreamedControlPoints.clear();
 
   this->Modified();
   return success ? 1 : 0;
@@ -1401,6 +1816,11 @@ int vtkDMMLMarkupsJsonStorageNode::WriteDataInternal(vtkDMMLNode *refNode)
   char writeBuffer[65536];
   rapidjson::FileWriteStream os(fp, writeBuffer, sizeof(writeBuffer));
   rapidjson::PrettyWriter<rapidjson::FileWriteStream> writer(os);
+  if (this->CompactFormat)
+    {
+    writer.SetIndent(' ', 0);
+    writer.SetFormatOptions(rapidjson::kFormatSingleLineArray);
+    }
 
   writer.StartObject();
   writer.Key("@schema"); writer.String(MARKUPS_SCHEMA.c_str());
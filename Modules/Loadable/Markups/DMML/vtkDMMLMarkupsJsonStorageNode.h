@@ -62,6 +62,13 @@ public:
   /// The types are ordered by the index in which they appear in the Json file.
   void GetMarkupsTypesInFile(const char* filePath, std::vector<std::string>& outputMarkupsTypes);
 
+  /// If enabled then the file is written without indentation and numeric arrays are written in a single line.
+  /// This makes files of markups with many control points smaller and faster to write and read.
+  /// Disabled by default.
+  vtkSetMacro(CompactFormat, bool);
+  vtkGetMacro(CompactFormat, bool);
+  vtkBooleanMacro(CompactFormat, bool);
+
 protected:
   vtkDMMLMarkupsJsonStorageNode();
   ~vtkDMMLMarkupsJsonStorageNode() override;
@@ -80,6 +87,8 @@ protected:
   /// Write data from a  referenced node.
   int WriteDataInternal(vtkDMMLNode *refNode) override;
 
+  bool CompactFormat{false};
+
   class vtkInternal;
   vtkInternal* Internal;
   friend class vtkInternal;
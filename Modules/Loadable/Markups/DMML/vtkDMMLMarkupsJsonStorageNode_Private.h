@@ -16,10 +16,13 @@
 ==============================================================================*/
 
 // STD includes
+#include <algorithm>
+#include <map>
 #include <memory>
 
 // DMML includes
 #include "vtkDMMLMarkupsJsonStorageNode.h"
+#include "vtkDMMLMarkupsNode.h"
 
 // Relax JSON standard and allow reading/writing of nan and inf
 // values. Such values should not normally occur, but if they do then
@@ -44,7 +47,25 @@ public:
   vtkInternal(vtkDMMLMarkupsJsonStorageNode* external);
   ~vtkInternal();
 
+  /// Content of an item of a "controlPoints" array.
+  /// Position and orientation values are stored as they are in the file (coordinate system is not converted).
+  struct ControlPointItem
+    {
+    ControlPointItem() : ControlPoint(new vtkDMMLMarkupsNode::ControlPoint) {}
+    std::unique_ptr<vtkDMMLMarkupsNode::ControlPoint> ControlPoint;
+    std::string PositionStatus;
+    bool PositionStatusSpecified{false};
+    bool PositionSpecified{false};
+    bool PositionValid{false};
+    bool OrientationSpecified{false};
+    bool OrientationValid{false};
+    };
+  typedef std::deque<ControlPointItem> ControlPointItemList;
+
   // Reader
+  /// Parse the file into a document. Items of "controlPoints" arrays of markups are not stored in
+  /// the document but parsed directly into control points while streaming the file,
+  /// they are retrieved by ReadControlPoints from StreamedControlPoints.
   std::unique_ptr<rapidjson::Document> CreateJsonDocumentFromFile(const char* filePath);
   std::string GetMarkupsClassNameFromMarkupsType(std::string markupsType);
   std::string GetMarkupsClassNameFromJsonValue(rapidjson::Value& markupObject);
@@ -52,6 +73,8 @@ public:
   bool UpdateMarkupsDisplayNodeFromJsonValue(vtkDMMLMarkupsDisplayNode* displayNode, rapidjson::Value& markupObject);
   bool ReadVector(rapidjson::Value& item, double* v, int numberOfComponents=3);
   bool ReadControlPoints(rapidjson::Value& item, int coordinateSystem, vtkDMMLMarkupsNode* markupsNode);
+  void ReadControlPointItem(rapidjson::Value& controlPointItem, ControlPointItem& item);
+  bool AddControlPointItem(ControlPointItem& item, int controlPointIndex, int coordinateSystem, vtkDMMLMarkupsNode* markupsNode);
   bool ReadMeasurements(rapidjson::Value& item, vtkDMMLMarkupsNode* markupsNode);
 
   // Writer
@@ -64,6 +87,15 @@ public:
 
   std::string GetCoordinateUnitsFromSceneAsString(vtkDMMLMarkupsNode* markupsNode);
 
+  /// Control points that were parsed while streaming the file, for each "controlPoints" array
+  /// of the document returned by the last CreateJsonDocumentFromFile call.
+  /// Entries are removed when they are read by ReadControlPoints.
+  std::map<const rapidjson::Value*, std::unique_ptr<ControlPointItemList> > StreamedControlPoints;
+
 protected:
+  /// SAX handler that parses items of "controlPoints" arrays into ControlPointItemList
+  /// and forwards all other content to a document.
+  class ReaderHandler;
+
   vtkDMMLMarkupsJsonStorageNode* External;
 };
@@ -40,6 +40,7 @@
 #include <vtkCollection.h>
 #include <vtkParallelTransportFrame.h>
 #include <vtkGeneralTransform.h>
+#include <vtkIntArray.h>
 #include <vtkMatrix3x3.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
@@ -209,6 +210,7 @@ void vtkDMMLMarkupsNode::CopyContent(vtkDMMLNode* aSource, bool deepCopy/*=true*
   this->CurveInputPoly->GetPoints()->Reset();
   this->RemoveAllControlPoints();
   int numMarkups = source->GetNumberOfControlPoints();
+  this->ControlPoints.reserve(numMarkups);
   for (int n = 0; n < numMarkups; n++)
     {
     ControlPoint* controlPoint = source->GetNthControlPoint(n);
@@ -445,6 +447,8 @@ void vtkDMMLMarkupsNode::RemoveAllControlPoints()
     }
 
   this->ControlPoints.clear();
+  this->ControlPointIndexByID.clear();
+  this->StorableModifiedTime.Modified();
 
   if (!this->GetDisableModifiedEvent())
     {
@@ -619,6 +623,8 @@ int vtkDMMLMarkupsNode::AddControlPoint(ControlPoint *controlPoint, bool autoLab
     }
 
   this->ControlPoints.push_back(controlPoint);
+  // if the ID is already used then the index keeps referring to the first control point
+  this->ControlPointIndexByID.emplace(controlPoint->ID, static_cast<int>(this->ControlPoints.size()) - 1);
 
   if (!this->GetDisableModifiedEvent())
     {
@@ -833,8 +839,11 @@ void vtkDMMLMarkupsNode::RemoveNthControlPoint(int pointIndex)
 
   this->InvokeCustomModifiedEvent(vtkDMMLMarkupsNode::PointAboutToBeRemovedEvent, static_cast<void*>(&pointIndex));
 
+  // indices of all subsequent control points change
+  this->RemoveControlPointIDsFromIndex(pointIndex, this->GetNumberOfControlPoints() - 1);
   delete this->ControlPoints[static_cast<unsigned int> (pointIndex)];
   this->ControlPoints.erase(this->ControlPoints.begin() + pointIndex);
+  this->AddControlPointIDsToIndex(pointIndex, this->GetNumberOfControlPoints() - 1);
 
   if (!this->GetDisableModifiedEvent())
     {
@@ -877,8 +886,12 @@ bool vtkDMMLMarkupsNode::InsertControlPoint(ControlPoint *controlPoint, int targ
     destIndex = listSize;
     }
 
+  // indices of all subsequent control points change
+  this->RemoveControlPointIDsFromIndex(destIndex, listSize - 1);
   std::vector < ControlPoint* >::iterator pos = this->ControlPoints.begin() + destIndex;
   this->ControlPoints.insert(pos, controlPoint);
+  this->AddControlPointIDsToIndex(destIndex, listSize);
+  this->StorableModifiedTime.Modified();
 
   if (!this->GetDisableModifiedEvent())
     {
@@ -970,12 +983,17 @@ void vtkDMMLMarkupsNode::SwapControlPoints(int m1, int m2)
     return;
     }
 
+  // control points between the swapped ones may have the same ID, therefore all of them are reindexed
+  int firstSwappedIndex = std::min(m1, m2);
+  int lastSwappedIndex = std::max(m1, m2);
+  this->RemoveControlPointIDsFromIndex(firstSwappedIndex, lastSwappedIndex);
   // make a copy of the first control point
   ControlPoint controlPoint1Backup = *controlPoint1;
   // copy the second control point into the first
   *controlPoint1 = *controlPoint2;
   // and copy the backup of the first one into the second
   *controlPoint2 = controlPoint1Backup;
+  this->AddControlPointIDsToIndex(firstSwappedIndex, lastSwappedIndex);
 
   if (!this->GetDisableModifiedEvent())
     {
@@ -1544,16 +1562,12 @@ int vtkDMMLMarkupsNode::GetNthControlPointIndexByID(const char* controlPointID)
     {
     return -1;
     }
-  for (int controlPointIndex = 0; controlPointIndex < this->GetNumberOfControlPoints(); controlPointIndex++)
+  auto indexIt = this->ControlPointIndexByID.find(controlPointID);
+  if (indexIt == this->ControlPointIndexByID.end())
     {
-    ControlPoint *compareControlPoint = this->ControlPoints[controlPointIndex];
-    if (compareControlPoint &&
-        strcmp(compareControlPoint->ID.c_str(), controlPointID) == 0)
-      {
-      return controlPointIndex;
-      }
+    return -1;
     }
-  return -1;
+  return indexIt->second;
 }
 
 //-------------------------------------------------------------------------
@@ -1584,7 +1598,36 @@ void vtkDMMLMarkupsNode::SetNthControlPointID(int n, std::string id)
     // no change
     return;
     }
+  // other control points after this one may have the same ID, therefore all of them are reindexed
+  int lastIndex = this->GetNumberOfControlPoints() - 1;
+  this->RemoveControlPointIDsFromIndex(n, lastIndex);
   controlPoint->ID = id;
+  this->AddControlPointIDsToIndex(n, lastIndex);
+  this->StorableModifiedTime.Modified();
+}
+
+//-----------------------------------------------------------
+void vtkDMMLMarkupsNode::RemoveControlPointIDsFromIndex(int firstPointIndex, int lastPointIndex)
+{
+  for (int controlPointIndex = firstPointIndex; controlPointIndex <= lastPointIndex; controlPointIndex++)
+    {
+    auto indexIt = this->ControlPointIndexByID.find(this->ControlPoints[controlPointIndex]->ID);
+    // entries that refer to a control point before the range remain valid
+    if (indexIt != this->ControlPointIndexByID.end() && indexIt->second >= firstPointIndex)
+      {
+      this->ControlPointIndexByID.erase(indexIt);
+      }
+    }
+}
+
+//-----------------------------------------------------------
+void vtkDMMLMarkupsNode::AddControlPointIDsToIndex(int firstPointIndex, int lastPointIndex)
+{
+  for (int controlPointIndex = firstPointIndex; controlPointIndex <= lastPointIndex; controlPointIndex++)
+    {
+    // emplace does not overwrite existing entries, so the first control point with an ID is found
+    this->ControlPointIndexByID.emplace(this->ControlPoints[controlPointIndex]->ID, controlPointIndex);
+    }
 }
 
 //---------------------------------------------------------------------------
@@ -2374,17 +2417,21 @@ int vtkDMMLMarkupsNode::GetClosestControlPointIndexToPositionWorld(double pos[3]
     // there is one control point, so the closest one is the only one
     return 0;
     }
+  // Get all world positions at once to avoid computing the world transform for each point
+  vtkNew<vtkPoints> pointsWorld;
+  pointsWorld->SetDataTypeToDouble();
+  this->GetControlPointPositionsWorld(pointsWorld);
   vtkIdType indexOfClosestMarkup = -1;
   double closestDistanceSquare = 0;
   for (vtkIdType pointIndex = 0; pointIndex < numberOfControlPoints; pointIndex++)
     {
-    if (visibleOnly && !this->GetNthControlPointVisibility(pointIndex))
+    if (visibleOnly && !this->ControlPoints[pointIndex]->Visibility)
       {
       // we need to find closest visible point but this one is not visible
       continue;
       }
-    double currentPos[4] = { 0.0, 0.0, 0.0, 1.0 };
-    this->GetNthControlPointPositionWorld(pointIndex, currentPos);
+    double currentPos[3] = { 0.0, 0.0, 0.0 };
+    pointsWorld->GetPoint(pointIndex, currentPos);
     double distanceSquare = vtkMath::Distance2BetweenPoints(pos, currentPos);
     if (distanceSquare < closestDistanceSquare || indexOfClosestMarkup < 0)
       {
@@ -2413,6 +2460,57 @@ void vtkDMMLMarkupsNode::GetControlPointLabels(vtkStringArray* labels)
 
 //---------------------------------------------------------------------------
 void vtkDMMLMarkupsNode::SetControlPointPositionsWorld(vtkPoints* points)
+{
+  if (!points)
+    {
+    this->RemoveAllControlPoints();
+    return;
+    }
+
+  if (!this->GetParentTransformNode())
+    {
+    // not transformed
+    this->SetControlPointPositions(points);
+    return;
+    }
+
+  // Transform all points at once instead of getting the transform for each point
+  vtkNew<vtkGeneralTransform> worldToLocalTransform;
+  vtkDMMLTransformNode::GetTransformBetweenNodes(nullptr, this->GetParentTransformNode(), worldToLocalTransform);
+  vtkNew<vtkPoints> pointsLocal;
+  pointsLocal->SetDataTypeToDouble();
+  pointsLocal->Allocate(points->GetNumberOfPoints());
+  worldToLocalTransform->TransformPoints(points, pointsLocal);
+  this->SetControlPointPositions(pointsLocal);
+}
+
+//---------------------------------------------------------------------------
+void vtkDMMLMarkupsNode::GetControlPointPositionsWorld(vtkPoints* points)
+{
+  if (!points)
+    {
+    return;
+    }
+  if (!this->GetParentTransformNode())
+    {
+    // not transformed
+    this->GetControlPointPositions(points);
+    return;
+    }
+
+  // Transform all points at once instead of getting the transform for each point
+  vtkNew<vtkPoints> pointsLocal;
+  pointsLocal->SetDataTypeToDouble();
+  this->GetControlPointPositions(pointsLocal);
+  vtkNew<vtkGeneralTransform> localToWorldTransform;
+  vtkDMMLTransformNode::GetTransformBetweenNodes(this->GetParentTransformNode(), nullptr, localToWorldTransform);
+  points->Reset();
+  points->Allocate(pointsLocal->GetNumberOfPoints());
+  localToWorldTransform->TransformPoints(pointsLocal, points);
+}
+
+//---------------------------------------------------------------------------
+void vtkDMMLMarkupsNode::SetControlPointPositions(vtkPoints* points)
 {
   if (!points)
     {
@@ -2424,23 +2522,57 @@ void vtkDMMLMarkupsNode::SetControlPointPositionsWorld(vtkPoints* points)
   this->IsUpdatingPoints = true;
 
   vtkIdType numberOfPoints = points->GetNumberOfPoints();
-  for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+  while (this->GetNumberOfControlPoints() > numberOfPoints)
+    {
+    this->RemoveNthControlPoint(this->GetNumberOfControlPoints() - 1);
+    }
+
+  // Update existing points directly, events are invoked once for all points
+  int numberOfUpdatedPoints = std::min(this->GetNumberOfControlPoints(), static_cast<int>(numberOfPoints));
+  bool positionDefinedChanged = false;
+  bool positionMissingChanged = false;
+  for (int pointIndex = 0; pointIndex < numberOfUpdatedPoints; pointIndex++)
     {
-    double* posWorld = points->GetPoint(pointIndex);
-    if (pointIndex < this->GetNumberOfControlPoints())
+    ControlPoint* controlPoint = this->ControlPoints[pointIndex];
+    points->GetPoint(pointIndex, controlPoint->Position);
+    controlPoint->AutoCreated = false;
+    if (controlPoint->PositionStatus != PositionDefined)
       {
-      // point already exists, just update it
-      this->SetNthControlPointPositionWorld(pointIndex, posWorld);
+      positionDefinedChanged = true;
+      if (controlPoint->PositionStatus == PositionMissing)
+        {
+        positionMissingChanged = true;
+        }
+      controlPoint->PositionStatus = PositionDefined;
       }
-    else
+    }
+  if (numberOfUpdatedPoints > 0)
+    {
+    int n = -1;
+    this->InvokeCustomModifiedEvent(vtkDMMLMarkupsNode::PointModifiedEvent, static_cast<void*>(&n));
+    if (positionDefinedChanged)
       {
-      // need to add a new point
-      vtkDMMLMarkupsNode::AddControlPointWorld(vtkVector3d(posWorld));
+      this->InvokeCustomModifiedEvent(vtkDMMLMarkupsNode::PointPositionDefinedEvent, static_cast<void*>(&n));
       }
+    if (positionMissingChanged)
+      {
+      this->InvokeCustomModifiedEvent(vtkDMMLMarkupsNode::PointPositionNonMissingEvent, static_cast<void*>(&n));
+      }
+    this->StorableModifiedTime.Modified();
     }
-  while (this->GetNumberOfControlPoints() > numberOfPoints)
+
+  // Add new points
+  this->ControlPoints.reserve(numberOfPoints);
+  double pos[3] = { 0.0, 0.0, 0.0 };
+  for (vtkIdType pointIndex = numberOfUpdatedPoints; pointIndex < numberOfPoints; pointIndex++)
     {
-    this->RemoveNthControlPoint(this->GetNumberOfControlPoints() - 1);
+    points->GetPoint(pointIndex, pos);
+    this->AddControlPoint(pos);
+    }
+
+  if (this->GetDisplayNode())
+    {
+    this->GetDisplayNode()->UpdateScalarRange();
     }
 
   this->IsUpdatingPoints = false;
@@ -2450,7 +2582,7 @@ void vtkDMMLMarkupsNode::SetControlPointPositionsWorld(vtkPoints* points)
 }
 
 //---------------------------------------------------------------------------
-void vtkDMMLMarkupsNode::GetControlPointPositionsWorld(vtkPoints* points)
+void vtkDMMLMarkupsNode::GetControlPointPositions(vtkPoints* points)
 {
   if (!points)
     {
@@ -2458,11 +2590,44 @@ void vtkDMMLMarkupsNode::GetControlPointPositionsWorld(vtkPoints* points)
     }
   int numberOfControlPoints = this->GetNumberOfControlPoints();
   points->SetNumberOfPoints(numberOfControlPoints);
-  double posWorld[3] = { 0.0, 0.0, 0.0 };
   for (int controlPointIndex = 0; controlPointIndex < numberOfControlPoints; controlPointIndex++)
     {
-    this->GetNthControlPointPositionWorld(controlPointIndex, posWorld);
-    points->SetPoint(controlPointIndex, posWorld);
+    points->SetPoint(controlPointIndex, this->ControlPoints[controlPointIndex]->Position);
+    }
+}
+
+//---------------------------------------------------------------------------
+vtkPoints* vtkDMMLMarkupsNode::GetControlPointPositions()
+{
+  if (!this->ControlPointPositions)
+    {
+    this->ControlPointPositions = vtkSmartPointer<vtkPoints>::New();
+    this->ControlPointPositions->SetDataTypeToDouble();
+    }
+  // Only copy positions if control points have been modified since the last update
+  if (this->ControlPointPositionsTime < this->StorableModifiedTime)
+    {
+    this->GetControlPointPositions(this->ControlPointPositions);
+    this->ControlPointPositions->Modified();
+    this->ControlPointPositionsTime.Modified();
+    }
+  return this->ControlPointPositions;
+}
+
+//---------------------------------------------------------------------------
+void vtkDMMLMarkupsNode::GetControlPointPositionStatuses(vtkIntArray* statuses)
+{
+  if (!statuses)
+    {
+    vtkErrorMacro("GetControlPointPositionStatuses failed: invalid statuses");
+    return;
+    }
+  int numberOfControlPoints = this->GetNumberOfControlPoints();
+  statuses->SetNumberOfComponents(1);
+  statuses->SetNumberOfValues(numberOfControlPoints);
+  for (int controlPointIndex = 0; controlPointIndex < numberOfControlPoints; controlPointIndex++)
+    {
+    statuses->SetValue(controlPointIndex, this->ControlPoints[controlPointIndex]->PositionStatus);
     }
 }
 
@@ -2790,18 +2955,17 @@ void vtkDMMLMarkupsNode::UpdateInteractionHandleToWorldMatrix()
 {
   // The origin of the coordinate system is at the center of mass of the control points
   double origin_World[3] = { 0 };
-  int numberOfControlPoints = this->GetNumberOfControlPoints();
   vtkNew<vtkPoints> controlPoints_World;
+  this->GetControlPointPositionsWorld(controlPoints_World);
+  int numberOfControlPoints = controlPoints_World->GetNumberOfPoints();
   for (int i = 0; i < numberOfControlPoints; ++i)
     {
     double controlPointPosition_World[3] = { 0.0, 0.0, 0.0 };
-    this->GetNthControlPointPositionWorld(i, controlPointPosition_World);
+    controlPoints_World->GetPoint(i, controlPointPosition_World);
 
     origin_World[0] += controlPointPosition_World[0] / numberOfControlPoints;
     origin_World[1] += controlPointPosition_World[1] / numberOfControlPoints;
     origin_World[2] += controlPointPosition_World[2] / numberOfControlPoints;
-
-    controlPoints_World->InsertNextPoint(controlPointPosition_World);
     }
 
   for (int i = 0; i < 3; ++i)
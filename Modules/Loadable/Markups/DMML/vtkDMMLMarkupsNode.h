@@ -32,6 +32,9 @@
 #include <vtkSmartPointer.h>
 #include <vtkVector.h>
 
+// STD includes
+#include <unordered_map>
+
 class vtkMatrix3x3;
 class vtkDMMLUnitNode;
 class vtkParallelTransportFrame;
@@ -67,6 +70,7 @@ class vtkParallelTransportFrame;
 class vtkAlgorithmOutput;
 class vtkCollection;
 class vtkDataArray;
+class vtkIntArray;
 class vtkGeneralTransform;
 class vtkMatrix4x4;
 class vtkDMMLMarkupsDisplayNode;
@@ -317,6 +321,30 @@ public:
   /// Get a copy of all control point positions in world coordinate system
   void GetControlPointPositionsWorld(vtkPoints* points);
 
+  /// Set all control point positions from a point list, in local coordinate system.
+  /// If points is nullptr then all control points are removed.
+  /// New control points are added if needed.
+  /// Existing control points are updated with the new positions.
+  /// Any extra existing control points are removed.
+  /// Modified events are invoked once for all points, therefore this is much faster
+  /// than calling SetNthControlPointPosition for each point of a large point list.
+  void SetControlPointPositions(vtkPoints* points);
+
+  /// Get a copy of all control point positions in local coordinate system.
+  /// Positions of control points that are not defined are included, too.
+  /// In Python, vtk.util.numpy_support.vtk_to_numpy(points.GetData()) gives
+  /// a numpy array view of the retrieved positions.
+  void GetControlPointPositions(vtkPoints* points);
+
+  /// Get all control point positions in local coordinate system, without copying them to a new point list.
+  /// The returned points are owned by the node and are only updated if control points have been
+  /// modified since the last call, therefore repeated calls on a large, unchanged point list are cheap.
+  /// The returned points must not be modified.
+  vtkPoints* GetControlPointPositions();
+
+  /// Get position status of all control points (PositionUndefined, PositionPreview, ...).
+  void GetControlPointPositionStatuses(vtkIntArray* statuses);
+
   ///@{
   /// Add a new control point, returning the point index, -1 on failure.
   int AddControlPoint(vtkVector3d point, std::string label = std::string());
@@ -521,7 +549,9 @@ public:
   /// Get the id for the Nth control point
   std::string GetNthControlPointID(int n);
 
-  /// Get the Nth control point index based on it's ID
+  /// Get the Nth control point index based on it's ID.
+  /// If multiple control points have the same ID then the index of the first one is returned.
+  /// Control point IDs must be changed by SetNthControlPointID, otherwise they cannot be looked up.
   int GetNthControlPointIndexByID(const char* controlPointID);
   /// Get the Nth control point based on it's ID
   ControlPoint* GetNthControlPointByID(const char* controlPointID);
@@ -931,6 +961,12 @@ protected:
   /// have been in this list
   std::string GenerateUniqueControlPointID();
 
+  /// Remove IDs of the control points in the index range (inclusive) from ControlPointIndexByID.
+  /// Must be called before control points in the range are moved or their IDs are changed.
+  void RemoveControlPointIDsFromIndex(int firstPointIndex, int lastPointIndex);
+  /// Add IDs of the control points in the index range (inclusive) to ControlPointIndexByID.
+  void AddControlPointIDsToIndex(int firstPointIndex, int lastPointIndex);
+
   std::string GenerateControlPointLabel(int controlPointIndex);
 
   virtual void UpdateCurvePolyFromControlPoints();
@@ -968,6 +1004,14 @@ protected:
   /// Vector of control points
   ControlPointsListType ControlPoints;
 
+  /// Control point index for each control point ID. It is updated when control points
+  /// are added, inserted, removed, swapped, or their ID is changed.
+  std::unordered_map<std::string, int> ControlPointIndexByID;
+
+  /// Control point positions returned by GetControlPointPositions()
+  vtkSmartPointer<vtkPoints> ControlPointPositions;
+  vtkTimeStamp ControlPointPositionsTime;
+
   /// Converts curve control points to curve points.
   vtkSmartPointer<vtkCurveGenerator> CurveGenerator;
 
@@ -0,0 +1,328 @@
+/*==============================================================================
+
+  Program: 3D Cjyx
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Markups includes
+#include "vtkCurveGenerator.h"
+#include "vtkCurveMeasurementsCalculator.h"
+
+// DMML includes
+#include "vtkDMMLCoreTestingMacros.h"
+
+// VTK includes
+#include <vtkCollection.h>
+#include <vtkDijkstraGraphGeodesicPath.h>
+#include <vtkDoubleArray.h>
+#include <vtkIdList.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPointLocator.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSphereSource.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <cmath>
+
+// Test that curves are updated incrementally when control points are moved
+// and that the result is the same as regenerating the entire curve.
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+void CreateHelix(vtkPoints* points, int numberOfPoints)
+{
+  points->SetDataTypeToDouble();
+  points->SetNumberOfPoints(numberOfPoints);
+  for (int i = 0; i < numberOfPoints; ++i)
+    {
+    points->SetPoint(i, 20.0 * cos(i * 0.3), 20.0 * sin(i * 0.3), i * 0.5);
+    }
+}
+
+//----------------------------------------------------------------------------
+void SetupGenerator(vtkCurveGenerator* generator, vtkPoints* points, int curveType, bool closed)
+{
+  generator->SetCurveType(curveType);
+  generator->SetCurveIsClosed(closed);
+  generator->SetInputPoints(points);
+}
+
+//----------------------------------------------------------------------------
+// Compare incrementally updated curve to a curve generated from scratch
+int CheckSameAsFullUpdate(vtkCurveGenerator* generator, vtkCurveMeasurementsCalculator* calculator,
+  vtkPoints* points, int curveType, bool closed)
+{
+  vtkNew<vtkCurveGenerator> referenceGenerator;
+  SetupGenerator(referenceGenerator, points, curveType, closed);
+  vtkNew<vtkCollection> measurements;
+  vtkNew<vtkCurveMeasurementsCalculator> referenceCalculator;
+  referenceCalculator->SetMeasurements(measurements);
+  referenceCalculator->SetCurveIsClosed(closed);
+  referenceCalculator->SetCalculateCurvature(true);
+  referenceCalculator->SetInputConnection(referenceGenerator->GetOutputPort());
+  referenceCalculator->Update();
+
+  vtkPoints* curvePoints = generator->GetOutputPoints();
+  vtkPoints* referenceCurvePoints = referenceGenerator->GetOutputPoints();
+  CHECK_NOT_NULL(curvePoints);
+  CHECK_INT(curvePoints->GetNumberOfPoints(), referenceCurvePoints->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < curvePoints->GetNumberOfPoints(); ++i)
+    {
+    double* curvePoint = curvePoints->GetPoint(i);
+    double* referenceCurvePoint = referenceCurvePoints->GetPoint(i);
+    if (curvePoint[0] != referenceCurvePoint[0]
+      || curvePoint[1] != referenceCurvePoint[1]
+      || curvePoint[2] != referenceCurvePoint[2])
+      {
+      std::cerr << "Line " << __LINE__ << ": curve point " << i << " differs from regenerated curve" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  CHECK_DOUBLE_TOLERANCE(generator->GetOutputCurveLength(), referenceGenerator->GetOutputCurveLength(), 1e-9);
+  CHECK_INT(generator->GetOutput()->GetNumberOfLines(), 1);
+
+  vtkDoubleArray* curvature = vtkDoubleArray::SafeDownCast(calculator->GetOutput()->GetPointData()->GetArray("Curvature"));
+  vtkDoubleArray* referenceCurvature = vtkDoubleArray::SafeDownCast(referenceCalculator->GetOutput()->GetPointData()->GetArray("Curvature"));
+  CHECK_NOT_NULL(curvature);
+  CHECK_NOT_NULL(referenceCurvature);
+  CHECK_INT(curvature->GetNumberOfValues(), referenceCurvature->GetNumberOfValues());
+  for (vtkIdType i = 0; i < curvature->GetNumberOfValues(); ++i)
+    {
+    CHECK_DOUBLE_TOLERANCE(curvature->GetValue(i), referenceCurvature->GetValue(i), 1e-9);
+    }
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestIncrementalUpdate(int curveType, bool closed)
+{
+  const int numberOfControlPoints = 30;
+  vtkNew<vtkPoints> points;
+  CreateHelix(points, numberOfControlPoints);
+
+  vtkNew<vtkCurveGenerator> generator;
+  SetupGenerator(generator, points, curveType, closed);
+  vtkNew<vtkCollection> measurements;
+  vtkNew<vtkCurveMeasurementsCalculator> calculator;
+  calculator->SetMeasurements(measurements);
+  calculator->SetCurveIsClosed(closed);
+  calculator->SetCalculateCurvature(true);
+  calculator->SetInputConnection(generator->GetOutputPort());
+  calculator->Update();
+  vtkIdType numberOfCurvePoints = generator->GetOutputPoints()->GetNumberOfPoints();
+  CHECK_INT(generator->GetNumberOfUpdatedCurvePoints(), numberOfCurvePoints);
+
+  // Move first, middle, and last control points
+  bool localSupport = (curveType == vtkCurveGenerator::CURVE_TYPE_LINEAR_SPLINE
+    || curveType == vtkCurveGenerator::CURVE_TYPE_KOCHANEK_SPLINE);
+  int numberOfAffectedSegments = (curveType == vtkCurveGenerator::CURVE_TYPE_KOCHANEK_SPLINE ? 4 : 2);
+  for (int pointIndex : { numberOfControlPoints / 2, 0, numberOfControlPoints - 1, 1 })
+    {
+    double position[3] = { 0.0, 0.0, 0.0 };
+    points->GetPoint(pointIndex, position);
+    points->SetPoint(pointIndex, position[0] + 3.0, position[1] - 2.0, position[2] + 1.0);
+    points->Modified();
+    calculator->Update();
+    if (localSupport)
+      {
+      CHECK_BOOL(generator->GetNumberOfUpdatedCurvePoints() > 0, true);
+      // Affected segments may not be contiguous for closed curves
+      CHECK_BOOL(generator->GetNumberOfUpdatedCurvePoints()
+        <= numberOfAffectedSegments * (generator->GetNumberOfPointsPerInterpolatingSegment() + 1), true);
+      }
+    else
+      {
+      CHECK_INT(generator->GetNumberOfUpdatedCurvePoints(), numberOfCurvePoints);
+      }
+    CHECK_EXIT_SUCCESS(CheckSameAsFullUpdate(generator, calculator, points, curveType, closed));
+    }
+
+  // Changing curve parameters or number of points regenerates the entire curve
+  generator->SetNumberOfPointsPerInterpolatingSegment(7);
+  calculator->Update();
+  CHECK_INT(generator->GetNumberOfUpdatedCurvePoints(), generator->GetOutputPoints()->GetNumberOfPoints());
+  points->InsertNextPoint(0.0, 0.0, 0.0);
+  points->Modified();
+  calculator->Update();
+  CHECK_INT(generator->GetNumberOfUpdatedCurvePoints(), generator->GetOutputPoints()->GetNumberOfPoints());
+  generator->SetNumberOfPointsPerInterpolatingSegment(5);
+  calculator->Update();
+  CHECK_EXIT_SUCCESS(CheckSameAsFullUpdate(generator, calculator, points, curveType, closed));
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+// Measure the time of moving a single control point
+int TestInteractionPerformance(int numberOfControlPoints, vtkIdType& numberOfUpdatedCurvePoints)
+{
+  vtkNew<vtkPoints> points;
+  CreateHelix(points, numberOfControlPoints);
+
+  vtkNew<vtkCurveGenerator> generator;
+  SetupGenerator(generator, points, vtkCurveGenerator::CURVE_TYPE_KOCHANEK_SPLINE, false);
+  vtkNew<vtkCollection> measurements;
+  vtkNew<vtkCurveMeasurementsCalculator> calculator;
+  calculator->SetMeasurements(measurements);
+  calculator->SetCalculateCurvature(true);
+  calculator->SetInputConnection(generator->GetOutputPort());
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  calculator->Update();
+  timer->StopTimer();
+  double fullUpdateTime = timer->GetElapsedTime();
+
+  const int numberOfDragSteps = 20;
+  int pointIndex = numberOfControlPoints / 2;
+  double position[3] = { 0.0, 0.0, 0.0 };
+  points->GetPoint(pointIndex, position);
+  timer->StartTimer();
+  for (int step = 0; step < numberOfDragSteps; ++step)
+    {
+    points->SetPoint(pointIndex, position[0] + step * 0.1, position[1], position[2]);
+    points->Modified();
+    calculator->Update();
+    }
+  timer->StopTimer();
+  std::cout << "Curve with " << numberOfControlPoints << " control points: full update " << fullUpdateTime << " s, "
+    << "moving a control point " << timer->GetElapsedTime() / numberOfDragSteps << " s" << std::endl;
+
+  numberOfUpdatedCurvePoints = generator->GetNumberOfUpdatedCurvePoints();
+  CHECK_EXIT_SUCCESS(CheckSameAsFullUpdate(generator, calculator, points, vtkCurveGenerator::CURVE_TYPE_KOCHANEK_SPLINE, false));
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+// Length of the shortest path on the surface between control points computed by VTK's Dijkstra filter
+double GetReferenceSurfacePathLength(vtkPolyData* surface, vtkPoints* points)
+{
+  vtkNew<vtkPointLocator> locator;
+  locator->SetDataSet(surface);
+  locator->BuildLocator();
+  vtkNew<vtkDijkstraGraphGeodesicPath> pathFilter;
+  pathFilter->SetInputData(surface);
+  pathFilter->StopWhenEndReachedOn();
+  double length = 0.0;
+  for (vtkIdType i = 0; i + 1 < points->GetNumberOfPoints(); ++i)
+    {
+    pathFilter->SetStartVertex(locator->FindClosestPoint(points->GetPoint(i + 1)));
+    pathFilter->SetEndVertex(locator->FindClosestPoint(points->GetPoint(i)));
+    pathFilter->Update();
+    vtkPoints* pathPoints = pathFilter->GetOutput()->GetPoints();
+    for (vtkIdType pointIndex = 1; pathPoints && pointIndex < pathPoints->GetNumberOfPoints(); ++pointIndex)
+      {
+      length += sqrt(vtkMath::Distance2BetweenPoints(pathPoints->GetPoint(pointIndex - 1), pathPoints->GetPoint(pointIndex)));
+      }
+    }
+  return length;
+}
+
+//----------------------------------------------------------------------------
+void SetPointOnSphere(vtkPoints* points, vtkIdType pointIndex, double radius, double theta, double phi)
+{
+  points->SetPoint(pointIndex, radius * sin(phi) * cos(theta), radius * sin(phi) * sin(theta), radius * cos(phi));
+}
+
+//----------------------------------------------------------------------------
+int TestSurfacePath()
+{
+  const double radius = 50.0;
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetRadius(radius);
+  sphere->SetThetaResolution(300);
+  sphere->SetPhiResolution(300);
+  sphere->Update();
+  vtkPolyData* surface = sphere->GetOutput();
+
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(4);
+  for (vtkIdType i = 0; i < 4; ++i)
+    {
+    SetPointOnSphere(points, i, radius, i * 0.8, 0.5 + i * 0.6);
+    }
+
+  vtkNew<vtkCurveGenerator> generator;
+  generator->SetCurveTypeToShortestDistanceOnSurface();
+  generator->SetInputPoints(points);
+  generator->SetInputData(1, surface);
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  generator->Update();
+  timer->StopTimer();
+  std::cout << "Shortest distance on surface curve with " << surface->GetNumberOfPolys() << " triangles: "
+    << "initial update " << timer->GetElapsedTime() << " s" << std::endl;
+  CHECK_INT(generator->GetNumberOfUpdatedSurfacePaths(), 3);
+  CHECK_INT(generator->GetSurfacePointIds()->GetNumberOfIds(), generator->GetOutputPoints()->GetNumberOfPoints());
+  CHECK_DOUBLE_TOLERANCE(generator->GetOutputCurveLength(), GetReferenceSurfacePathLength(surface, points), 1e-6);
+
+  // Only the paths of segments with moved end points are recomputed
+  SetPointOnSphere(points, 3, radius, 2.0, 2.2);
+  points->Modified();
+  timer->StartTimer();
+  generator->Update();
+  timer->StopTimer();
+  std::cout << "Moving last control point: " << timer->GetElapsedTime() << " s" << std::endl;
+  CHECK_INT(generator->GetNumberOfUpdatedSurfacePaths(), 1);
+  CHECK_DOUBLE_TOLERANCE(generator->GetOutputCurveLength(), GetReferenceSurfacePathLength(surface, points), 1e-6);
+
+  SetPointOnSphere(points, 1, radius, 1.0, 1.0);
+  points->Modified();
+  generator->Update();
+  CHECK_INT(generator->GetNumberOfUpdatedSurfacePaths(), 2);
+  CHECK_DOUBLE_TOLERANCE(generator->GetOutputCurveLength(), GetReferenceSurfacePathLength(surface, points), 1e-6);
+  double curveStartPosition[3] = { 0.0, 0.0, 0.0 };
+  generator->GetOutputPoints()->GetPoint(0, curveStartPosition);
+  double expectedCurveStartPosition[3] = { 0.0, 0.0, 0.0 };
+  surface->GetPoint(generator->GetSurfacePointIds()->GetId(0), expectedCurveStartPosition);
+  CHECK_DOUBLE(curveStartPosition[0], expectedCurveStartPosition[0]);
+  CHECK_DOUBLE(curveStartPosition[1], expectedCurveStartPosition[1]);
+
+  // Modified surface rebuilds the graph and recomputes all paths
+  surface->Modified();
+  generator->Update();
+  CHECK_INT(generator->GetNumberOfUpdatedSurfacePaths(), 3);
+  CHECK_DOUBLE_TOLERANCE(generator->GetOutputCurveLength(), GetReferenceSurfacePathLength(surface, points), 1e-6);
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkCurveGeneratorTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  for (bool closed : { false, true })
+    {
+    CHECK_EXIT_SUCCESS(TestIncrementalUpdate(vtkCurveGenerator::CURVE_TYPE_LINEAR_SPLINE, closed));
+    CHECK_EXIT_SUCCESS(TestIncrementalUpdate(vtkCurveGenerator::CURVE_TYPE_KOCHANEK_SPLINE, closed));
+    CHECK_EXIT_SUCCESS(TestIncrementalUpdate(vtkCurveGenerator::CURVE_TYPE_CARDINAL_SPLINE, closed));
+    }
+
+  // Number of recomputed curve points does not depend on the length of the curve
+  vtkIdType numberOfUpdatedCurvePointsShortCurve = 0;
+  vtkIdType numberOfUpdatedCurvePointsLongCurve = 0;
+  CHECK_EXIT_SUCCESS(TestInteractionPerformance(2000, numberOfUpdatedCurvePointsShortCurve));
+  CHECK_EXIT_SUCCESS(TestInteractionPerformance(20000, numberOfUpdatedCurvePointsLongCurve));
+  CHECK_INT(numberOfUpdatedCurvePointsShortCurve, numberOfUpdatedCurvePointsLongCurve);
+
+  CHECK_EXIT_SUCCESS(TestSurfacePath());
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,212 @@
+/*==============================================================================
+
+  Program: 3D Cjyx
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Markups includes
+#include "vtkCurveSegmentLocator.h"
+#include "vtkDMMLMarkupsCurveNode.h"
+
+// DMML includes
+#include "vtkDMMLCoreTestingMacros.h"
+
+// VTK includes
+#include <vtkMath.h>
+#include <vtkMinimalStandardRandomSequence.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+double GetNextRandomValue(vtkMinimalStandardRandomSequence* random, double rangeMin, double rangeMax)
+{
+  random->Next();
+  return random->GetRangeValue(rangeMin, rangeMax);
+}
+
+//----------------------------------------------------------------------------
+// Closest point and segment computed by checking all points and segments
+void FindClosestBruteForce(vtkPoints* points, const double position[3],
+  vtkIdType& closestPointIndex, double& closestPointDistance2, double& closestSegmentDistance2)
+{
+  closestPointIndex = -1;
+  closestPointDistance2 = VTK_DOUBLE_MAX;
+  closestSegmentDistance2 = VTK_DOUBLE_MAX;
+  for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i)
+    {
+    double point1[3] = { 0.0, 0.0, 0.0 };
+    points->GetPoint(i, point1);
+    double distance2 = vtkMath::Distance2BetweenPoints(position, point1);
+    if (distance2 < closestPointDistance2)
+      {
+      closestPointDistance2 = distance2;
+      closestPointIndex = i;
+      }
+    if (i + 1 >= points->GetNumberOfPoints())
+      {
+      continue;
+      }
+    double point2[3] = { 0.0, 0.0, 0.0 };
+    points->GetPoint(i + 1, point2);
+    double segmentVector[3] = { point2[0] - point1[0], point2[1] - point1[1], point2[2] - point1[2] };
+    double point1ToPosition[3] = { position[0] - point1[0], position[1] - point1[1], position[2] - point1[2] };
+    double segmentLength2 = vtkMath::Dot(segmentVector, segmentVector);
+    double t = (segmentLength2 > 0.0 ? vtkMath::Dot(point1ToPosition, segmentVector) / segmentLength2 : 0.0);
+    t = std::min(std::max(t, 0.0), 1.0);
+    double pointOnSegment[3] = { point1[0] + t * segmentVector[0], point1[1] + t * segmentVector[1], point1[2] + t * segmentVector[2] };
+    closestSegmentDistance2 = std::min(closestSegmentDistance2, vtkMath::Distance2BetweenPoints(position, pointOnSegment));
+    }
+}
+
+//----------------------------------------------------------------------------
+int CheckQueries(vtkCurveSegmentLocator* locator, vtkMinimalStandardRandomSequence* random, int numberOfQueries)
+{
+  vtkPoints* points = locator->GetPoints();
+  for (int queryIndex = 0; queryIndex < numberOfQueries; ++queryIndex)
+    {
+    double position[3] = { 0.0, 0.0, 0.0 };
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      position[axis] = GetNextRandomValue(random, -60.0, 60.0);
+      }
+    vtkIdType expectedPointIndex = -1;
+    double expectedPointDistance2 = 0.0;
+    double expectedSegmentDistance2 = 0.0;
+    FindClosestBruteForce(points, position, expectedPointIndex, expectedPointDistance2, expectedSegmentDistance2);
+
+    vtkIdType pointIndex = locator->FindClosestPoint(position);
+    CHECK_BOOL(pointIndex >= 0, true);
+    CHECK_DOUBLE_TOLERANCE(vtkMath::Distance2BetweenPoints(position, points->GetPoint(pointIndex)), expectedPointDistance2, 1e-9);
+
+    double closestPosition[3] = { 0.0, 0.0, 0.0 };
+    vtkIdType segmentIndex = locator->FindClosestPointOnCurve(position, closestPosition);
+    CHECK_BOOL(segmentIndex >= 0 && segmentIndex + 1 < points->GetNumberOfPoints(), true);
+    CHECK_DOUBLE_TOLERANCE(vtkMath::Distance2BetweenPoints(position, closestPosition), expectedSegmentDistance2, 1e-9);
+    }
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestLocator(int numberOfPoints)
+{
+  // Random walk, similar to a centerline
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(42);
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  points->SetNumberOfPoints(numberOfPoints);
+  double position[3] = { 0.0, 0.0, 0.0 };
+  for (vtkIdType i = 0; i < numberOfPoints; ++i)
+    {
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      position[axis] = std::min(std::max(position[axis] + GetNextRandomValue(random, -1.0, 1.0), -50.0), 50.0);
+      }
+    points->SetPoint(i, position);
+    }
+
+  vtkNew<vtkCurveSegmentLocator> locator;
+  locator->SetPoints(points);
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  locator->Update();
+  timer->StopTimer();
+  std::cout << "Build locator for " << numberOfPoints << " points: " << timer->GetElapsedTime() << " s" << std::endl;
+  CHECK_EXIT_SUCCESS(CheckQueries(locator, random, 20));
+
+  // Moving a few points only updates the affected leaves
+  for (vtkIdType i = numberOfPoints / 2; i < numberOfPoints / 2 + 5; ++i)
+    {
+    points->SetPoint(i, 55.0, 55.0, 55.0 + i);
+    }
+  points->Modified();
+  timer->StartTimer();
+  locator->Update();
+  timer->StopTimer();
+  std::cout << "Update locator after moving 5 points: " << timer->GetElapsedTime() << " s" << std::endl;
+  CHECK_BOOL(locator->GetNumberOfUpdatedLeaves() >= 1 && locator->GetNumberOfUpdatedLeaves() <= 2, true);
+  CHECK_INT(locator->FindClosestPoint(points->GetPoint(numberOfPoints / 2 + 3)), numberOfPoints / 2 + 3);
+  CHECK_EXIT_SUCCESS(CheckQueries(locator, random, 20));
+
+  // Queries do not update the locator if the points are not modified
+  const int numberOfQueries = 1000;
+  timer->StartTimer();
+  for (int i = 0; i < numberOfQueries; ++i)
+    {
+    double closestPosition[3] = { 0.0, 0.0, 0.0 };
+    locator->FindClosestPointOnCurve(points->GetPoint((i * 7919) % numberOfPoints), closestPosition);
+    }
+  timer->StopTimer();
+  std::cout << "Average closest point on curve query time: " << timer->GetElapsedTime() / numberOfQueries * 1e6 << " us" << std::endl;
+  CHECK_INT(locator->GetNumberOfUpdatedLeaves(), 0);
+
+  // Changing the number of points rebuilds the locator
+  points->SetNumberOfPoints(1);
+  points->Modified();
+  CHECK_INT(locator->FindClosestPoint(position), 0);
+  double closestPosition[3] = { 0.0, 0.0, 0.0 };
+  CHECK_INT(locator->FindClosestPointOnCurve(position, closestPosition), -1);
+  locator->SetPoints(nullptr);
+  CHECK_INT(locator->FindClosestPoint(position), -1);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestCurveNode()
+{
+  vtkNew<vtkDMMLMarkupsCurveNode> curveNode;
+  curveNode->SetCurveTypeToLinear();
+  curveNode->AddControlPoint(vtkVector3d(0.0, 0.0, 0.0));
+  curveNode->AddControlPoint(vtkVector3d(10.0, 0.0, 0.0));
+  curveNode->AddControlPoint(vtkVector3d(10.0, 10.0, 0.0));
+
+  double closestPosWorld[3] = { 0.0, 0.0, 0.0 };
+  double posWorld[3] = { 9.0, 5.0, 3.0 };
+  vtkIdType lineIndex = curveNode->GetClosestPointPositionAlongCurveWorld(posWorld, closestPosWorld);
+  CHECK_BOOL(lineIndex >= 0, true);
+  CHECK_DOUBLE_TOLERANCE(closestPosWorld[0], 10.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(closestPosWorld[1], 5.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(closestPosWorld[2], 0.0, 1e-6);
+
+  // Locator is updated when control points are moved
+  curveNode->SetNthControlPointPosition(2, 20.0, 0.0, 0.0);
+  curveNode->GetClosestPointPositionAlongCurveWorld(posWorld, closestPosWorld);
+  CHECK_DOUBLE_TOLERANCE(closestPosWorld[0], 9.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(closestPosWorld[1], 0.0, 1e-6);
+
+  vtkIdType curvePointIndex = curveNode->GetClosestCurvePointIndexToPositionWorld(posWorld);
+  CHECK_BOOL(curvePointIndex >= 0, true);
+  double curvePoint[3] = { 0.0, 0.0, 0.0 };
+  curveNode->GetCurvePointsWorld()->GetPoint(curvePointIndex, curvePoint);
+  CHECK_BOOL(vtkMath::Distance2BetweenPoints(curvePoint, closestPosWorld) <= 1.0, true);
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkCurveSegmentLocatorTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  CHECK_EXIT_SUCCESS(TestLocator(100000));
+  CHECK_EXIT_SUCCESS(TestCurveNode());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,220 @@
+/*==============================================================================
+
+  Program: 3D Cjyx
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// DMML includes
+#include "vtkDMMLCoreTestingMacros.h"
+#include "vtkDMMLLinearTransformNode.h"
+#include "vtkDMMLMarkupsFiducialNode.h"
+#include "vtkDMMLScene.h"
+
+// VTK includes
+#include <vtkIntArray.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkTimerLog.h>
+
+// Test bulk access and lookup of control points of large point lists
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+int TestBulkPositions(vtkDMMLScene* scene, int numberOfPoints)
+{
+  vtkDMMLMarkupsFiducialNode* markupsNode = vtkDMMLMarkupsFiducialNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkDMMLMarkupsFiducialNode"));
+
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  points->SetNumberOfPoints(numberOfPoints);
+  for (int i = 0; i < numberOfPoints; ++i)
+    {
+    points->SetPoint(i, i * 0.1, -i * 0.2, 5.0);
+    }
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  markupsNode->SetControlPointPositionsWorld(points);
+  timer->StopTimer();
+  std::cout << "Set " << numberOfPoints << " control point positions: " << timer->GetElapsedTime() << " s" << std::endl;
+  CHECK_INT(markupsNode->GetNumberOfControlPoints(), numberOfPoints);
+  CHECK_INT(markupsNode->GetNumberOfDefinedControlPoints(), numberOfPoints);
+
+  vtkNew<vtkPoints> retrievedPoints;
+  retrievedPoints->SetDataTypeToDouble();
+  timer->StartTimer();
+  markupsNode->GetControlPointPositions(retrievedPoints);
+  timer->StopTimer();
+  std::cout << "Get " << numberOfPoints << " control point positions: " << timer->GetElapsedTime() << " s" << std::endl;
+  CHECK_INT(retrievedPoints->GetNumberOfPoints(), numberOfPoints);
+  CHECK_DOUBLE(retrievedPoints->GetPoint(numberOfPoints - 1)[0], (numberOfPoints - 1) * 0.1);
+  CHECK_DOUBLE(retrievedPoints->GetPoint(numberOfPoints - 1)[1], -(numberOfPoints - 1) * 0.2);
+
+  // Positions owned by the node are only updated when control points are modified
+  vtkPoints* positions = markupsNode->GetControlPointPositions();
+  CHECK_NOT_NULL(positions);
+  CHECK_INT(positions->GetNumberOfPoints(), numberOfPoints);
+  vtkMTimeType positionsMTime = positions->GetMTime();
+  CHECK_POINTER(markupsNode->GetControlPointPositions(), positions);
+  CHECK_BOOL(positions->GetMTime() == positionsMTime, true);
+  double modifiedPosition[3] = { 7.0, 8.0, 9.0 };
+  markupsNode->SetNthControlPointPosition(1, modifiedPosition);
+  CHECK_POINTER(markupsNode->GetControlPointPositions(), positions);
+  CHECK_DOUBLE(positions->GetPoint(1)[2], 9.0);
+
+  // Update existing points and remove extra points
+  markupsNode->UnsetNthControlPointPosition(3);
+  markupsNode->SetNthControlPointPositionMissing(5);
+  markupsNode->SetNthControlPointAutoCreated(4, true);
+  vtkNew<vtkPoints> fewerPoints;
+  fewerPoints->SetDataTypeToDouble();
+  fewerPoints->InsertNextPoint(1.0, 2.0, 3.0);
+  for (int i = 1; i < 10; ++i)
+    {
+    fewerPoints->InsertNextPoint(i, 0.0, 0.0);
+    }
+  markupsNode->SetControlPointPositions(fewerPoints);
+  CHECK_INT(markupsNode->GetNumberOfControlPoints(), 10);
+  CHECK_DOUBLE(markupsNode->GetNthControlPointPositionVector(0).GetZ(), 3.0);
+  CHECK_DOUBLE(markupsNode->GetControlPointPositions()->GetPoint(0)[2], 3.0);
+  CHECK_BOOL(markupsNode->GetNthControlPointAutoCreated(4), false);
+  vtkNew<vtkIntArray> statuses;
+  markupsNode->GetControlPointPositionStatuses(statuses);
+  CHECK_INT(statuses->GetNumberOfValues(), 10);
+  for (int i = 0; i < 10; ++i)
+    {
+    CHECK_INT(statuses->GetValue(i), vtkDMMLMarkupsNode::PositionDefined);
+    }
+  markupsNode->UnsetNthControlPointPosition(2);
+  markupsNode->GetControlPointPositionStatuses(statuses);
+  CHECK_INT(statuses->GetValue(2), vtkDMMLMarkupsNode::PositionUndefined);
+
+  // World coordinates
+  vtkNew<vtkMatrix4x4> matrix;
+  matrix->SetElement(0, 3, 10.0);
+  matrix->SetElement(1, 1, 2.0);
+  vtkDMMLLinearTransformNode* transformNode = vtkDMMLLinearTransformNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkDMMLLinearTransformNode"));
+  transformNode->SetMatrixTransformToParent(matrix);
+  markupsNode->SetAndObserveTransformNodeID(transformNode->GetID());
+
+  vtkNew<vtkPoints> worldPoints;
+  worldPoints->SetDataTypeToDouble();
+  markupsNode->GetControlPointPositionsWorld(worldPoints);
+  CHECK_INT(worldPoints->GetNumberOfPoints(), 10);
+  for (int i = 0; i < 10; ++i)
+    {
+    double expectedWorld[3] = { 0.0, 0.0, 0.0 };
+    markupsNode->GetNthControlPointPositionWorld(i, expectedWorld);
+    CHECK_DOUBLE(worldPoints->GetPoint(i)[0], expectedWorld[0]);
+    CHECK_DOUBLE(worldPoints->GetPoint(i)[1], expectedWorld[1]);
+    CHECK_DOUBLE(worldPoints->GetPoint(i)[2], expectedWorld[2]);
+    }
+  CHECK_DOUBLE(worldPoints->GetPoint(0)[0], 11.0);
+  CHECK_DOUBLE(worldPoints->GetPoint(0)[1], 4.0);
+
+  markupsNode->SetControlPointPositionsWorld(worldPoints);
+  CHECK_DOUBLE(markupsNode->GetNthControlPointPositionVector(0).GetX(), 1.0);
+  CHECK_DOUBLE(markupsNode->GetNthControlPointPositionVector(0).GetY(), 2.0);
+
+  markupsNode->SetControlPointPositions(nullptr);
+  CHECK_INT(markupsNode->GetNumberOfControlPoints(), 0);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestLookupByID(int numberOfPoints)
+{
+  vtkNew<vtkDMMLMarkupsFiducialNode> markupsNode;
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  points->SetNumberOfPoints(numberOfPoints);
+  for (int i = 0; i < numberOfPoints; ++i)
+    {
+    points->SetPoint(i, i, 0.0, 0.0);
+    }
+  markupsNode->SetControlPointPositions(points);
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  for (int i = 0; i < numberOfPoints; ++i)
+    {
+    std::string id = markupsNode->GetNthControlPointID(i);
+    if (markupsNode->GetNthControlPointIndexByID(id.c_str()) != i)
+      {
+      std::cerr << "Control point lookup by ID failed for control point " << i << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  timer->StopTimer();
+  std::cout << "Look up " << numberOfPoints << " control points by ID: " << timer->GetElapsedTime() << " s" << std::endl;
+
+  // Indices are updated when points are removed, inserted, or reordered
+  std::string firstID = markupsNode->GetNthControlPointID(0);
+  std::string secondID = markupsNode->GetNthControlPointID(1);
+  std::string lastID = markupsNode->GetNthControlPointID(numberOfPoints - 1);
+  markupsNode->RemoveNthControlPoint(0);
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(firstID.c_str()), -1);
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(secondID.c_str()), 0);
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(lastID.c_str()), numberOfPoints - 2);
+
+  double newPoint[3] = { 1.0, 2.0, 3.0 };
+  markupsNode->InsertControlPoint(0, newPoint);
+  std::string insertedID = markupsNode->GetNthControlPointID(0);
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(insertedID.c_str()), 0);
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(secondID.c_str()), 1);
+
+  markupsNode->SwapControlPoints(0, 1);
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(insertedID.c_str()), 1);
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(secondID.c_str()), 0);
+
+  // If IDs are not unique then the first control point is found
+  std::string thirdID = markupsNode->GetNthControlPointID(2);
+  markupsNode->SetNthControlPointID(3, thirdID);
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(thirdID.c_str()), 2);
+  markupsNode->RemoveNthControlPoint(2);
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(thirdID.c_str()), 2);
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(lastID.c_str()), numberOfPoints - 2);
+
+  int addedIndex = markupsNode->AddControlPoint(newPoint);
+  std::string addedID = markupsNode->GetNthControlPointID(addedIndex);
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(addedID.c_str()), addedIndex);
+
+  markupsNode->ResetNthControlPointID(addedIndex);
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(addedID.c_str()), -1);
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(markupsNode->GetNthControlPointID(addedIndex).c_str()), addedIndex);
+
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(nullptr), -1);
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID("nonexistent"), -1);
+
+  markupsNode->RemoveAllControlPoints();
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(secondID.c_str()), -1);
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkDMMLMarkupsNodeTest7(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkDMMLScene> scene;
+  const int numberOfPoints = 100000;
+  CHECK_EXIT_SUCCESS(TestBulkPositions(scene, numberOfPoints));
+  CHECK_EXIT_SUCCESS(TestLookupByID(numberOfPoints));
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,175 @@
+/*==============================================================================
+
+  Program: 3D Cjyx
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// DMML includes
+#include "vtkDMMLCoreTestingMacros.h"
+#include "vtkDMMLMarkupsFiducialNode.h"
+#include "vtkDMMLMarkupsJsonStorageNode.h"
+#include "vtkDMMLScene.h"
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkTimerLog.h>
+#include <vtksys/SystemInformation.hxx>
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+
+// Test reading and writing of markups json files with many control points
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+int TestLargePointList(const std::string& tempFolder, int numberOfPoints, bool compactFormat)
+{
+  vtkNew<vtkDMMLScene> scene;
+  vtkDMMLMarkupsFiducialNode* markupsNode = vtkDMMLMarkupsFiducialNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkDMMLMarkupsFiducialNode"));
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  points->SetNumberOfPoints(numberOfPoints);
+  for (int i = 0; i < numberOfPoints; ++i)
+    {
+    points->SetPoint(i, i * 0.25, -i * 0.5, 12.5);
+    }
+  markupsNode->SetControlPointPositions(points);
+  markupsNode->SetNthControlPointLabel(1, "second \"point\"");
+  markupsNode->SetNthControlPointLocked(1, true);
+  markupsNode->UnsetNthControlPointPosition(2);
+  double orientation[4] = { 90.0, 0.0, 0.0, 1.0 };
+  markupsNode->SetNthControlPointOrientation(3, orientation);
+
+  std::string fileName = tempFolder + (compactFormat ? "/LargePointListCompact.mrk.json" : "/LargePointList.mrk.json");
+  vtkNew<vtkDMMLMarkupsJsonStorageNode> storageNode;
+  storageNode->SetCompactFormat(compactFormat);
+  storageNode->SetFileName(fileName.c_str());
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  CHECK_BOOL(storageNode->WriteData(markupsNode), true);
+  timer->StopTimer();
+  double writeTime = timer->GetElapsedTime();
+
+  vtksys::SystemInformation systemInformation;
+  long long memoryUsedBeforeRead = systemInformation.GetProcMemoryUsed();
+  vtkNew<vtkDMMLMarkupsFiducialNode> readNode;
+  timer->StartTimer();
+  CHECK_BOOL(storageNode->ReadData(readNode), true);
+  timer->StopTimer();
+  double readTime = timer->GetElapsedTime();
+  long long memoryUsedAfterRead = systemInformation.GetProcMemoryUsed();
+
+  std::cout << (compactFormat ? "Compact" : "Indented") << " file with " << numberOfPoints << " control points: "
+    << vtksys::SystemTools::FileLength(fileName) / 1024 << " KiB, write " << writeTime << " s, read " << readTime << " s, "
+    << "memory increase during read " << (memoryUsedAfterRead - memoryUsedBeforeRead) / 1024 << " MiB" << std::endl;
+
+  CHECK_INT(readNode->GetNumberOfControlPoints(), numberOfPoints);
+  CHECK_STD_STRING(readNode->GetNthControlPointLabel(1), "second \"point\"");
+  CHECK_BOOL(readNode->GetNthControlPointLocked(1), true);
+  CHECK_INT(readNode->GetNthControlPointPositionStatus(2), vtkDMMLMarkupsNode::PositionUndefined);
+  for (int i : { 0, 1, 3, numberOfPoints / 2, numberOfPoints - 1 })
+    {
+    CHECK_STD_STRING(readNode->GetNthControlPointID(i), markupsNode->GetNthControlPointID(i));
+    double readPosition[3] = { 0.0, 0.0, 0.0 };
+    readNode->GetNthControlPointPosition(i, readPosition);
+    CHECK_DOUBLE(readPosition[0], i * 0.25);
+    CHECK_DOUBLE(readPosition[1], -i * 0.5);
+    CHECK_DOUBLE(readPosition[2], 12.5);
+    }
+  for (int i = 0; i < 9; ++i)
+    {
+    CHECK_DOUBLE_TOLERANCE(readNode->GetNthControlPointOrientationMatrix(3)[i],
+      markupsNode->GetNthControlPointOrientationMatrix(3)[i], 1e-9);
+    }
+
+  vtksys::SystemTools::RemoveFile(fileName);
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestMultipleMarkups(const std::string& tempFolder)
+{
+  // Control points must be associated with the markup they are listed in
+  std::string fileName = tempFolder + "/MultipleMarkups.mrk.json";
+  {
+  std::ofstream file(fileName);
+  file << "{\"@schema\": \"https://raw.githubusercontent.com/slicer/slicer/master/Modules/Loadable/Markups/Resources/Schema/markups-schema-v1.0.3.json#\",\n"
+    << "\"markups\": [\n"
+    << "  {\"type\": \"Fiducial\", \"coordinateSystem\": \"RAS\", \"controlPoints\": [\n"
+    << "    {\"id\": \"1\", \"label\": \"A-1\", \"position\": [1.0, 2.0, 3.0], \"positionStatus\": \"defined\"}]},\n"
+    << "  {\"type\": \"Fiducial\", \"coordinateSystem\": \"LPS\", \"controlPoints\": [\n"
+    << "    {\"id\": \"1\", \"label\": \"B-1\", \"position\": [1.0, 2.0, 3.0], \"selected\": false},\n"
+    << "    {\"id\": \"2\", \"label\": \"B-2\", \"position\": \"\", \"positionStatus\": \"undefined\", \"description\": \"undefined\"}]}\n"
+    << "]}\n";
+  }
+
+  vtkNew<vtkDMMLScene> scene;
+  vtkNew<vtkDMMLMarkupsJsonStorageNode> storageNode;
+  scene->AddNode(storageNode);
+
+  std::vector<std::string> markupsTypes;
+  storageNode->GetMarkupsTypesInFile(fileName.c_str(), markupsTypes);
+  CHECK_INT(markupsTypes.size(), 2);
+
+  vtkDMMLMarkupsNode* markupsNode = storageNode->AddNewMarkupsNodeFromFile(fileName.c_str(), "B", 1);
+  CHECK_NOT_NULL(markupsNode);
+  CHECK_INT(markupsNode->GetNumberOfControlPoints(), 2);
+  CHECK_STD_STRING(markupsNode->GetNthControlPointLabel(0), "B-1");
+  CHECK_BOOL(markupsNode->GetNthControlPointSelected(0), false);
+  CHECK_DOUBLE(markupsNode->GetNthControlPointPositionVector(0).GetX(), -1.0);
+  CHECK_DOUBLE(markupsNode->GetNthControlPointPositionVector(0).GetY(), -2.0);
+  CHECK_DOUBLE(markupsNode->GetNthControlPointPositionVector(0).GetZ(), 3.0);
+  CHECK_STD_STRING(markupsNode->GetNthControlPointDescription(1), "undefined");
+  CHECK_INT(markupsNode->GetNthControlPointPositionStatus(1), vtkDMMLMarkupsNode::PositionUndefined);
+
+  vtkNew<vtkDMMLMarkupsFiducialNode> firstMarkupsNode;
+  storageNode->SetFileName(fileName.c_str());
+  CHECK_BOOL(storageNode->ReadData(firstMarkupsNode), true);
+  CHECK_INT(firstMarkupsNode->GetNumberOfControlPoints(), 1);
+  CHECK_STD_STRING(firstMarkupsNode->GetNthControlPointLabel(0), "A-1");
+  CHECK_DOUBLE(firstMarkupsNode->GetNthControlPointPositionVector(0).GetX(), 1.0);
+
+  vtksys::SystemTools::RemoveFile(fileName);
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkDMMLMarkupsStorageNodeTest3(int argc, char* argv[])
+{
+  if (argc < 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp [numberOfPoints]" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string tempFolder = argv[1];
+  // Number of points can be increased for benchmarking (e.g., 1000000)
+  int numberOfPoints = 100000;
+  if (argc > 2)
+    {
+    numberOfPoints = atoi(argv[2]);
+    }
+
+  CHECK_EXIT_SUCCESS(TestLargePointList(tempFolder, numberOfPoints, false));
+  CHECK_EXIT_SUCCESS(TestLargePointList(tempFolder, numberOfPoints, true));
+  CHECK_EXIT_SUCCESS(TestMultipleMarkups(tempFolder));
+  return EXIT_SUCCESS;
+}
@@ -328,11 +328,18 @@ Fill inside and outside operation creates a binary labelmap volume as output, wi
             cjyx.dmmlScene.RemoveNode(maskVolumeNode)
             return False
 
-        if maskExtent:
+        # If only voxels inside the mask are filled in the input volume then they are modified in place,
+        # so that automatic window/level computation only needs to process the modified region.
+        modifyInPlace = (operationMode == "FILL_INSIDE" and outputVolumeNode == inputVolumeNode)
+
+        if maskExtent or modifyInPlace:
             img = cjyx.modules.segmentations.logic().CreateOrientedImageDataFromVolumeNode(maskVolumeNode)
             img.UnRegister(None)
             import vtkSegmentationCorePython as vtkSegmentationCore
-            vtkSegmentationCore.vtkOrientedImageDataResample.CalculateEffectiveExtent(img, maskExtent, 0)
+            effectiveMaskExtent = [0, -1, 0, -1, 0, -1]
+            vtkSegmentationCore.vtkOrientedImageDataResample.CalculateEffectiveExtent(img, effectiveMaskExtent, 0)
+            if maskExtent:
+                maskExtent[:] = effectiveMaskExtent
 
         maskToStencil = vtk.vtkImageToImageStencil()
         maskToStencil.ThresholdByLower(0)
@@ -358,7 +365,18 @@ Fill inside and outside operation creates a binary labelmap volume as output, wi
         stencil.SetBackgroundValue(fillValues[0])
         stencil.Update()
 
-        outputVolumeNode.SetAndObserveImageData(stencil.GetOutput())
+        if modifyInPlace:
+            if effectiveMaskExtent[0] <= effectiveMaskExtent[1] and effectiveMaskExtent[2] <= effectiveMaskExtent[3] \
+                    and effectiveMaskExtent[4] <= effectiveMaskExtent[5]:
+                for displayNodeIndex in range(outputVolumeNode.GetNumberOfDisplayNodes()):
+                    displayNode = outputVolumeNode.GetNthDisplayNode(displayNodeIndex)
+                    if displayNode and displayNode.IsA("vtkDMMLScalarVolumeDisplayNode"):
+                        displayNode.AddImageDataModifiedExtent(effectiveMaskExtent)
+                outputImageData = outputVolumeNode.GetImageData()
+                outputImageData.CopyAndCastFrom(stencil.GetOutput(), effectiveMaskExtent)
+                outputImageData.Modified()
+        else:
+            outputVolumeNode.SetAndObserveImageData(stencil.GetOutput())
 
         # Set the same geometry and parent transform as the input volume
         ijkToRas = vtk.vtkMatrix4x4()
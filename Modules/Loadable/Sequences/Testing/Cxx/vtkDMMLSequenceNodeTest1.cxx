@@ -28,6 +28,7 @@
 // VTK includes
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
+#include <vtkTimerLog.h>
 
 #include "vtkDMMLCoreTestingMacros.h"
 #include "vtkTestingOutputWindow.h"
@@ -53,6 +54,83 @@ bool SequenceSortedByIndex(vtkDMMLSequenceNode* seqNode)
   return true;
 }
 
+//-----------------------------------------------------------------------------
+int testIndexLookup()
+{
+  // Numeric index: values 0, 0.5, 1.0, ... appended in increasing order
+  vtkNew<vtkDMMLSequenceNode> seqNode;
+  seqNode->SetIndexType(vtkDMMLSequenceNode::NumericIndex);
+  seqNode->SetNumericIndexValueTolerance(0.01);
+  vtkNew<vtkDMMLTransformNode> dataNode;
+  const int numberOfDataNodes = 20000;
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  for (int i = 0; i < numberOfDataNodes; i++)
+    {
+    std::ostringstream indexStr;
+    indexStr << i * 0.5;
+    seqNode->SetDataNodeAtValue(dataNode.GetPointer(), indexStr.str());
+    }
+  timer->StopTimer();
+  std::cout << "Appended " << numberOfDataNodes << " numeric index values in " << timer->GetElapsedTime() << "s" << std::endl;
+  CHECK_INT(seqNode->GetNumberOfDataNodes(), numberOfDataNodes);
+
+  timer->StartTimer();
+  for (int i = 0; i < numberOfDataNodes; i++)
+    {
+    std::ostringstream indexStr;
+    indexStr << i * 0.5 + 0.005;
+    CHECK_INT(seqNode->GetItemNumberFromIndexValue(indexStr.str()), i);
+    }
+  timer->StopTimer();
+  std::cout << "Looked up " << numberOfDataNodes << " numeric index values in " << timer->GetElapsedTime() << "s" << std::endl;
+
+  // Values within tolerance of the next item are matched to that item
+  CHECK_INT(seqNode->GetItemNumberFromIndexValue("10.495"), 21);
+  // Non-exact match uses the item before the index value
+  CHECK_INT(seqNode->GetItemNumberFromIndexValue("10.25"), -1);
+  CHECK_INT(seqNode->GetItemNumberFromIndexValue("10.25", false), 20);
+  CHECK_INT(seqNode->GetItemNumberFromIndexValue("-5", false), 0);
+  CHECK_INT(seqNode->GetItemNumberFromIndexValue("1e9", false), numberOfDataNodes - 1);
+
+  // Inserting and removing items keeps lookup consistent
+  seqNode->SetDataNodeAtValue(dataNode.GetPointer(), "10.25");
+  CHECK_INT(seqNode->GetItemNumberFromIndexValue("10.25"), 21);
+  CHECK_INT(seqNode->GetItemNumberFromIndexValue("10.5"), 22);
+  seqNode->RemoveDataNodeAtValue("10.25");
+  CHECK_INT(seqNode->GetItemNumberFromIndexValue("10.5"), 21);
+
+  // Text index
+  vtkNew<vtkDMMLSequenceNode> textSeqNode;
+  textSeqNode->SetIndexType(vtkDMMLSequenceNode::TextIndex);
+  for (int i = 0; i < numberOfDataNodes; i++)
+    {
+    std::ostringstream indexStr;
+    indexStr << "frame" << i;
+    textSeqNode->SetDataNodeAtValue(dataNode.GetPointer(), indexStr.str());
+    }
+  CHECK_INT(textSeqNode->GetNumberOfDataNodes(), numberOfDataNodes);
+  timer->StartTimer();
+  for (int i = numberOfDataNodes - 1; i >= 0; i--)
+    {
+    std::ostringstream indexStr;
+    indexStr << "frame" << i;
+    CHECK_INT(textSeqNode->GetItemNumberFromIndexValue(indexStr.str()), i);
+    }
+  timer->StopTimer();
+  std::cout << "Looked up " << numberOfDataNodes << " text index values in " << timer->GetElapsedTime() << "s" << std::endl;
+  CHECK_INT(textSeqNode->GetItemNumberFromIndexValue("frame"), -1);
+
+  CHECK_BOOL(textSeqNode->UpdateIndexValue("frame5", "renamed"), true);
+  CHECK_INT(textSeqNode->GetItemNumberFromIndexValue("frame5"), -1);
+  CHECK_INT(textSeqNode->GetItemNumberFromIndexValue("renamed"), 5);
+  textSeqNode->RemoveDataNodeAtValue("frame0");
+  CHECK_INT(textSeqNode->GetItemNumberFromIndexValue("renamed"), 4);
+  CHECK_INT(textSeqNode->GetItemNumberFromIndexValue("frame1"), 0);
+
+  return EXIT_SUCCESS;
+}
+
 //-----------------------------------------------------------------------------
 int vtkDMMLSequenceNodeTest1( int, char * [] )
 {
@@ -113,6 +191,8 @@ int vtkDMMLSequenceNodeTest1( int, char * [] )
   seqNode->UpdateIndexValue("96", "32");
   CHECK_BOOL(SequenceSortedByIndex(seqNode.GetPointer()), true);
 
+  CHECK_EXIT_SUCCESS(testIndexLookup());
+
   /*
   bool res = true;
   TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
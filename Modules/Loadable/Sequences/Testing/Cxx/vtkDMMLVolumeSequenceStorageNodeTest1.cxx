@@ -0,0 +1,277 @@
+/*==============================================================================
+
+  Program: 3D Cjyx
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// DMML includes
+#include <vtkDMMLScalarVolumeNode.h>
+#include <vtkDMMLScene.h>
+#include <vtkDMMLSequenceNode.h>
+#include <vtkDMMLVolumeSequenceStorageNode.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#include "vtkDMMLCoreTestingMacros.h"
+
+namespace
+{
+
+const int NumberOfFrames = 6;
+const int FrameDimensions[3] = { 7, 6, 5 };
+
+//-----------------------------------------------------------------------------
+vtkSmartPointer<vtkImageData> CreateFrameImage(int frameIndex)
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(FrameDimensions[0], FrameDimensions[1], FrameDimensions[2]);
+  image->AllocateScalars(VTK_SHORT, 1);
+  short* voxels = static_cast<short*>(image->GetScalarPointer());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+    voxels[i] = static_cast<short>(frameIndex * 1000 + i);
+    }
+  return image;
+}
+
+//-----------------------------------------------------------------------------
+bool IsFrameImageValid(vtkDMMLNode* node, int frameIndex)
+{
+  vtkDMMLScalarVolumeNode* volumeNode = vtkDMMLScalarVolumeNode::SafeDownCast(node);
+  if (!volumeNode || !volumeNode->GetImageData())
+    {
+    return false;
+    }
+  vtkSmartPointer<vtkImageData> expectedImage = CreateFrameImage(frameIndex);
+  vtkImageData* image = volumeNode->GetImageData();
+  int* dimensions = image->GetDimensions();
+  if (dimensions[0] != FrameDimensions[0] || dimensions[1] != FrameDimensions[1] || dimensions[2] != FrameDimensions[2]
+    || image->GetScalarType() != VTK_SHORT || image->GetNumberOfScalarComponents() != 1)
+    {
+    return false;
+    }
+  return memcmp(image->GetScalarPointer(), expectedImage->GetScalarPointer(),
+    expectedImage->GetNumberOfPoints() * sizeof(short)) == 0;
+}
+
+//-----------------------------------------------------------------------------
+// Write a file that stores voxels of each frame in a contiguous block
+bool WriteFrameContiguousFile(const std::string& fileName)
+{
+  std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary);
+  file << "NRRD0004\n"
+    << "type: short\n"
+    << "dimension: 4\n"
+    << "space: left-posterior-superior\n"
+    << "sizes: " << FrameDimensions[0] << " " << FrameDimensions[1] << " " << FrameDimensions[2] << " " << NumberOfFrames << "\n"
+    << "space directions: (1,0,0) (0,1,0) (0,0,1) none\n"
+    << "kinds: domain domain domain list\n"
+#ifdef VTK_WORDS_BIGENDIAN
+    << "endian: big\n"
+#else
+    << "endian: little\n"
+#endif
+    << "encoding: raw\n"
+    << "space origin: (0,0,0)\n"
+    << "\n";
+  for (int frameIndex = 0; frameIndex < NumberOfFrames; ++frameIndex)
+    {
+    vtkSmartPointer<vtkImageData> image = CreateFrameImage(frameIndex);
+    file.write(static_cast<char*>(image->GetScalarPointer()), image->GetNumberOfPoints() * sizeof(short));
+    }
+  return file.good();
+}
+
+//-----------------------------------------------------------------------------
+// Write a file using the storage node (voxels of frames are interleaved)
+bool WriteSequenceFile(vtkDMMLScene* scene, const std::string& fileName, bool useCompression)
+{
+  vtkDMMLSequenceNode* sequenceNode = vtkDMMLSequenceNode::SafeDownCast(scene->AddNewNodeByClass("vtkDMMLSequenceNode"));
+  for (int frameIndex = 0; frameIndex < NumberOfFrames; ++frameIndex)
+    {
+    vtkNew<vtkDMMLScalarVolumeNode> volumeNode;
+    volumeNode->SetAndObserveImageData(CreateFrameImage(frameIndex));
+    std::stringstream indexValue;
+    indexValue << frameIndex;
+    sequenceNode->SetDataNodeAtValue(volumeNode, indexValue.str());
+    }
+  vtkNew<vtkDMMLVolumeSequenceStorageNode> storageNode;
+  scene->AddNode(storageNode);
+  storageNode->SetUseCompression(useCompression);
+  storageNode->SetFileName(fileName.c_str());
+  bool success = (storageNode->WriteData(sequenceNode) != 0);
+  scene->RemoveNode(storageNode);
+  scene->RemoveNode(sequenceNode);
+  return success;
+}
+
+//-----------------------------------------------------------------------------
+int TestReadSequence(vtkDMMLScene* scene, const std::string& fileName, bool readOnDemandExpected)
+{
+  const vtkTypeInt64 frameSize = FrameDimensions[0] * FrameDimensions[1] * FrameDimensions[2] * sizeof(short);
+
+  // All frames fit into the cache
+  {
+    vtkDMMLSequenceNode* sequenceNode = vtkDMMLSequenceNode::SafeDownCast(scene->AddNewNodeByClass("vtkDMMLSequenceNode"));
+    vtkNew<vtkDMMLVolumeSequenceStorageNode> storageNode;
+    scene->AddNode(storageNode);
+    storageNode->SetFileName(fileName.c_str());
+    CHECK_BOOL(storageNode->ReadData(sequenceNode) != 0, true);
+    CHECK_INT(sequenceNode->GetNumberOfDataNodes(), NumberOfFrames);
+    CHECK_INT(storageNode->GetNumberOfPendingFrames(), 0);
+    CHECK_NULL(sequenceNode->GetDataNodeLoader());
+    for (int frameIndex = 0; frameIndex < NumberOfFrames; ++frameIndex)
+      {
+      CHECK_BOOL(IsFrameImageValid(sequenceNode->GetNthDataNode(frameIndex, false), frameIndex), true);
+      }
+    scene->RemoveNode(storageNode);
+    scene->RemoveNode(sequenceNode);
+  }
+
+  // Only a few frames fit into the cache
+  vtkDMMLSequenceNode* sequenceNode = vtkDMMLSequenceNode::SafeDownCast(scene->AddNewNodeByClass("vtkDMMLSequenceNode"));
+  vtkNew<vtkDMMLVolumeSequenceStorageNode> storageNode;
+  scene->AddNode(storageNode);
+  storageNode->SetFileName(fileName.c_str());
+  storageNode->SetFrameCacheSize(frameSize * 5 / 2);
+  CHECK_BOOL(storageNode->ReadData(sequenceNode) != 0, true);
+  CHECK_INT(sequenceNode->GetNumberOfDataNodes(), NumberOfFrames);
+  if (!readOnDemandExpected)
+    {
+    // Frames cannot be read individually, all of them are read at once
+    CHECK_INT(storageNode->GetNumberOfPendingFrames(), 0);
+    CHECK_BOOL(IsFrameImageValid(sequenceNode->GetNthDataNode(NumberOfFrames - 1), NumberOfFrames - 1), true);
+    scene->RemoveNode(storageNode);
+    scene->RemoveNode(sequenceNode);
+    return EXIT_SUCCESS;
+    }
+
+  // Only the first frame is read
+  CHECK_POINTER(sequenceNode->GetDataNodeLoader(), storageNode.GetPointer());
+  CHECK_INT(storageNode->GetNumberOfPendingFrames(), NumberOfFrames - 1);
+  CHECK_BOOL(storageNode->IsFrameLoadPending(sequenceNode->GetNthDataNode(1, false)), true);
+  CHECK_NULL(vtkDMMLScalarVolumeNode::SafeDownCast(sequenceNode->GetNthDataNode(1, false))->GetImageData());
+
+  // Voxel values of pending frames can be read without reading the frames
+  std::map<vtkDMMLNode*, double> pendingFrameValues;
+  const int voxelIJK[3] = { 2, 3, 4 };
+  const int voxelIndex = voxelIJK[0] + FrameDimensions[0] * (voxelIJK[1] + FrameDimensions[1] * voxelIJK[2]);
+  CHECK_BOOL(storageNode->ReadPendingFrameVoxelValues(voxelIJK, pendingFrameValues), true);
+  CHECK_INT(static_cast<int>(pendingFrameValues.size()), NumberOfFrames - 1);
+  for (int frameIndex = 1; frameIndex < NumberOfFrames; ++frameIndex)
+    {
+    CHECK_DOUBLE(pendingFrameValues[sequenceNode->GetNthDataNode(frameIndex, false)], frameIndex * 1000 + voxelIndex);
+    }
+  CHECK_INT(storageNode->GetNumberOfPendingFrames(), NumberOfFrames - 1);
+  const int outsideIJK[3] = { FrameDimensions[0], 0, 0 };
+  CHECK_BOOL(storageNode->ReadPendingFrameVoxelValues(outsideIJK, pendingFrameValues), false);
+
+  // Frames are read when accessed and least recently used frames are released
+  for (int frameIndex = 0; frameIndex < NumberOfFrames; ++frameIndex)
+    {
+    CHECK_BOOL(IsFrameImageValid(sequenceNode->GetNthDataNode(frameIndex), frameIndex), true);
+    CHECK_BOOL(storageNode->GetLoadedFramesSize() <= storageNode->GetFrameCacheSize(), true);
+    }
+  CHECK_INT(storageNode->GetNumberOfPendingFrames(), NumberOfFrames - 2);
+  CHECK_BOOL(storageNode->IsFrameLoadPending(sequenceNode->GetNthDataNode(0, false)), true);
+  CHECK_BOOL(IsFrameImageValid(sequenceNode->GetDataNodeAtValue("0"), 0), true);
+
+  // Modified frames are not released
+  vtkDMMLScalarVolumeNode* modifiedFrame = vtkDMMLScalarVolumeNode::SafeDownCast(sequenceNode->GetNthDataNode(1));
+  modifiedFrame->GetImageData()->SetScalarComponentFromDouble(0, 0, 0, 0, -5.0);
+  modifiedFrame->GetImageData()->Modified();
+  for (int frameIndex = 2; frameIndex < NumberOfFrames; ++frameIndex)
+    {
+    CHECK_BOOL(IsFrameImageValid(sequenceNode->GetNthDataNode(frameIndex), frameIndex), true);
+    }
+  CHECK_BOOL(storageNode->IsFrameLoadPending(modifiedFrame), false);
+  CHECK_NOT_NULL(modifiedFrame->GetImageData());
+  CHECK_DOUBLE(modifiedFrame->GetImageData()->GetScalarComponentAsDouble(0, 0, 0, 0), -5.0);
+
+  // Reading of all frames stops reading on demand
+  CHECK_BOOL(storageNode->LoadAllFrames(), true);
+  CHECK_INT(storageNode->GetNumberOfPendingFrames(), 0);
+  CHECK_NULL(sequenceNode->GetDataNodeLoader());
+  for (int frameIndex = 2; frameIndex < NumberOfFrames; ++frameIndex)
+    {
+    CHECK_BOOL(IsFrameImageValid(sequenceNode->GetNthDataNode(frameIndex, false), frameIndex), true);
+    }
+
+  scene->RemoveNode(storageNode);
+  scene->RemoveNode(sequenceNode);
+  return EXIT_SUCCESS;
+}
+
+//-----------------------------------------------------------------------------
+int TestReadAhead(vtkDMMLScene* scene, const std::string& fileName, bool interleaved)
+{
+  const vtkTypeInt64 frameSize = FrameDimensions[0] * FrameDimensions[1] * FrameDimensions[2] * sizeof(short);
+  vtkDMMLSequenceNode* sequenceNode = vtkDMMLSequenceNode::SafeDownCast(scene->AddNewNodeByClass("vtkDMMLSequenceNode"));
+  vtkNew<vtkDMMLVolumeSequenceStorageNode> storageNode;
+  scene->AddNode(storageNode);
+  storageNode->SetFileName(fileName.c_str());
+  // Half of the cache can hold 2 frames
+  storageNode->SetFrameCacheSize(frameSize * 9 / 2);
+  CHECK_BOOL(storageNode->ReadData(sequenceNode) != 0, true);
+
+  // Interleaved files: nearest pending frame is read in the same pass,
+  // frame contiguous files: only the accessed frame is read
+  CHECK_INT(storageNode->GetNumberOfPendingFrames(), interleaved ? NumberOfFrames - 2 : NumberOfFrames - 1);
+  CHECK_BOOL(IsFrameImageValid(sequenceNode->GetNthDataNode(3), 3), true);
+  CHECK_INT(storageNode->GetNumberOfPendingFrames(), interleaved ? NumberOfFrames - 4 : NumberOfFrames - 2);
+  CHECK_BOOL(storageNode->IsFrameLoadPending(sequenceNode->GetNthDataNode(4, false)), !interleaved);
+  CHECK_BOOL(IsFrameImageValid(sequenceNode->GetNthDataNode(4, false), 4), interleaved);
+  CHECK_BOOL(storageNode->GetLoadedFramesSize() <= storageNode->GetFrameCacheSize(), true);
+
+  scene->RemoveNode(storageNode);
+  scene->RemoveNode(sequenceNode);
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int vtkDMMLVolumeSequenceStorageNodeTest1( int argc, char * argv[] )
+{
+  std::string tempDir = ".";
+  if (argc > 1)
+    {
+    tempDir = argv[1];
+    }
+
+  vtkNew<vtkDMMLScene> scene;
+
+  std::string frameContiguousFileName = tempDir + "/TestVolumeSequenceFrameContiguous.seq.nrrd";
+  CHECK_BOOL(WriteFrameContiguousFile(frameContiguousFileName), true);
+  CHECK_EXIT_SUCCESS(TestReadSequence(scene, frameContiguousFileName, true));
+  CHECK_EXIT_SUCCESS(TestReadAhead(scene, frameContiguousFileName, false));
+
+  std::string interleavedFileName = tempDir + "/TestVolumeSequenceInterleaved.seq.nrrd";
+  CHECK_BOOL(WriteSequenceFile(scene, interleavedFileName, false), true);
+  CHECK_EXIT_SUCCESS(TestReadSequence(scene, interleavedFileName, true));
+  CHECK_EXIT_SUCCESS(TestReadAhead(scene, interleavedFileName, true));
+
+  std::string compressedFileName = tempDir + "/TestVolumeSequenceCompressed.seq.nrrd";
+  CHECK_BOOL(WriteSequenceFile(scene, compressedFileName, true), true);
+  CHECK_EXIT_SUCCESS(TestReadSequence(scene, compressedFileName, false));
+
+  return EXIT_SUCCESS;
+}
@@ -39,6 +39,7 @@
 #include "vtkCjyxSequencesLogic.h"
 #include "vtkDMMLSequenceNode.h"
 #include "vtkDMMLSequenceBrowserNode.h"
+#include "vtkDMMLVolumeSequenceStorageNode.h"
 
 // VTK includes
 #include <vtkAbstractTransform.h>
@@ -327,10 +328,16 @@ void qCjyxSequencesModuleWidgetPrivate::updateInteractiveCharting()
       transformNode->GetTransformFromWorld(worldTransform.GetPointer());
       }
 
+    // Voxel values of frames that are not in memory are read directly from the file
+    // (reading all the frames would be slow and might not fit into memory)
+    vtkDMMLVolumeSequenceStorageNode* frameLoader = sequenceNode->GetDataNodeLoader();
+    std::map<vtkDMMLNode*, double> pendingFrameValues;
+    bool pendingFrameValuesRead = false;
+
     int numberOfValidPoints = 0;
     for (int i = 0; i<numberOfDataNodes; i++)
       {
-      vNode = vtkDMMLScalarVolumeNode::SafeDownCast(sequenceNode->GetNthDataNode(i));
+      vNode = vtkDMMLScalarVolumeNode::SafeDownCast(sequenceNode->GetNthDataNode(i, false));
       this->ChartTable->SetValue(i, 0, i);
 
       vtkNew<vtkGeneralTransform> worldToIjkTransform;
@@ -344,18 +351,37 @@ void qCjyxSequencesModuleWidgetPrivate::updateInteractiveCharting()
       double *crosshairPositionDouble_IJK = worldToIjkTransform->TransformDoublePoint(croshairPosition_RAS);
       int croshairPosition_IJK[3]={vtkMath::Round(crosshairPositionDouble_IJK[0]),
         vtkMath::Round(crosshairPositionDouble_IJK[1]), vtkMath::Round(crosshairPositionDouble_IJK[2])};
-      int* imageExtent = vNode->GetImageData()->GetExtent();
-      bool isCrosshairInsideImage = imageExtent[0]<=croshairPosition_IJK[0] && croshairPosition_IJK[0]<=imageExtent[1]
+      bool framePending = frameLoader && frameLoader->IsFrameLoadPending(vNode);
+      bool isCrosshairInsideImage = false;
+      if (framePending)
+        {
+        // All frames in the file have the same geometry, therefore values can be read for all pending frames at once
+        if (!pendingFrameValuesRead)
+          {
+          frameLoader->ReadPendingFrameVoxelValues(croshairPosition_IJK, pendingFrameValues);
+          pendingFrameValuesRead = true;
+          }
+        isCrosshairInsideImage = (pendingFrameValues.find(vNode) != pendingFrameValues.end());
+        }
+      else
+        {
+        int* imageExtent = vNode->GetImageData()->GetExtent();
+        isCrosshairInsideImage = imageExtent[0]<=croshairPosition_IJK[0] && croshairPosition_IJK[0]<=imageExtent[1]
           && imageExtent[2]<=croshairPosition_IJK[1] && croshairPosition_IJK[1]<=imageExtent[3]
           && imageExtent[4]<=croshairPosition_IJK[2] && croshairPosition_IJK[2]<=imageExtent[5];
+        }
       if (isCrosshairInsideImage)
         {
         numberOfValidPoints++;
         }
       for (int c = 0; c<numOfScalarComponents; c++)
         {
-        double val = isCrosshairInsideImage ? vNode->GetImageData()->GetScalarComponentAsDouble(croshairPosition_IJK[0],
-          croshairPosition_IJK[1], croshairPosition_IJK[2], c) : 0;
+        double val = 0;
+        if (isCrosshairInsideImage)
+          {
+          val = framePending ? pendingFrameValues[vNode] : vNode->GetImageData()->GetScalarComponentAsDouble(croshairPosition_IJK[0],
+            croshairPosition_IJK[1], croshairPosition_IJK[2], c);
+          }
         this->ChartTable->SetValue(i, c+1, val);
         }
       }
@@ -382,7 +408,7 @@ void qCjyxSequencesModuleWidgetPrivate::updateInteractiveCharting()
     {
     for (int i = 0; i<numberOfDataNodes; i++)
       {
-      tNode = vtkDMMLTransformNode::SafeDownCast(sequenceNode->GetNthDataNode(i));
+      tNode = vtkDMMLTransformNode::SafeDownCast(sequenceNode->GetNthDataNode(i, false));
       vtkAbstractTransform* trans2Parent = tNode->GetTransformToParent();
 
       double* transformedcroshairPosition_RAS = trans2Parent->TransformDoublePoint(croshairPosition_RAS);
@@ -923,7 +949,8 @@ void qCjyxSequencesModuleWidget::updateSequenceItemWidgetFromDMML()
   for ( int dataNodeIndex = 0; dataNodeIndex < numberOfDataNodes; dataNodeIndex++ )
     {
     std::string currentValue = currentSequence->GetNthIndexValue( dataNodeIndex );
-    vtkDMMLNode* currentDataNode = currentSequence->GetNthDataNode( dataNodeIndex );
+    // Only the node name is needed, do not read data of the node
+    vtkDMMLNode* currentDataNode = currentSequence->GetNthDataNode( dataNodeIndex, false );
 
     if (currentDataNode==nullptr)
       {
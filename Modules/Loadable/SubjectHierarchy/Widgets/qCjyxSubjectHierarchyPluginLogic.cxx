@@ -55,6 +55,9 @@
 #include <QString>
 #include <QVariantMap>
 
+// VTK includes
+#include <vtkCollection.h>
+
 //-----------------------------------------------------------------------------
 /// \ingroup Cjyx_QtModules_SubjectHierarchy
 class qCjyxSubjectHierarchyPluginLogicPrivate
@@ -179,6 +182,7 @@ void qCjyxSubjectHierarchyPluginLogic::setDMMLScene(vtkDMMLScene* scene)
 
   // Connect scene node added event so that the new subject hierarchy items can be claimed by a plugin
   qvtkReconnect( scene, vtkDMMLScene::NodeAddedEvent, this, SLOT( onNodeAdded(vtkObject*,vtkObject*) ) );
+  qvtkReconnect( scene, vtkDMMLScene::NodesAddedEvent, this, SLOT( onNodesAdded(vtkObject*,vtkObject*) ) );
   // Connect scene node about to be removed event so that the associated subject hierarchy node can be deleted too
   qvtkReconnect( scene, vtkDMMLScene::NodeAboutToBeRemovedEvent, this, SLOT( onNodeAboutToBeRemoved(vtkObject*,vtkObject*) ) );
   // Connect scene node removed event so if the subject hierarchy node is removed, it is re-created and the hierarchy rebuilt
@@ -295,6 +299,29 @@ void qCjyxSubjectHierarchyPluginLogic::onNodeAdded(vtkObject* sceneObject, vtkOb
     }
 }
 
+//-----------------------------------------------------------------------------
+void qCjyxSubjectHierarchyPluginLogic::onNodesAdded(vtkObject* sceneObject, vtkObject* nodesObject)
+{
+  vtkCollection* nodes = vtkCollection::SafeDownCast(nodesObject);
+  if (!nodes || nodes->GetNumberOfItems() == 0)
+    {
+    return;
+    }
+  // All nodes in the collection are of the same class. Subject hierarchy nodes are all merged
+  // by resolving the subject hierarchy once.
+  if (vtkDMMLSubjectHierarchyNode::SafeDownCast(nodes->GetItemAsObject(0)))
+    {
+    this->onNodeAdded(sceneObject, nodes->GetItemAsObject(0));
+    return;
+    }
+  vtkCollectionSimpleIterator it;
+  vtkObject* nodeObject = nullptr;
+  for (nodes->InitTraversal(it); (nodeObject = nodes->GetNextItemAsObject(it));)
+    {
+    this->onNodeAdded(sceneObject, nodeObject);
+    }
+}
+
 //-----------------------------------------------------------------------------
 void qCjyxSubjectHierarchyPluginLogic::onNodeAboutToBeRemoved(vtkObject* sceneObject, vtkObject* nodeObject)
 {
@@ -131,6 +131,9 @@ protected:
 protected slots:
   /// Called when a node is added to the scene so that a plugin can create an item for it
   void onNodeAdded(vtkObject* scene, vtkObject* nodeObject);
+  /// Called when nodes are added by a scene import in bulk import mode
+  /// \sa vtkDMMLScene::NodesAddedEvent
+  void onNodesAdded(vtkObject* scene, vtkObject* nodesObject);
   /// Called when a node is removed from the scene so that the associated
   /// subject hierarchy item can be deleted too
   void onNodeAboutToBeRemoved(vtkObject* scene, vtkObject* nodeObject);
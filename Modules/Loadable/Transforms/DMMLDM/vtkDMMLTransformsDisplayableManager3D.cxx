@@ -321,7 +321,7 @@ void vtkDMMLTransformsDisplayableManager3D::vtkInternal::UpdateDisplayNodePipeli
 
   if (!vtkCjyxTransformLogic::GetVisualization3d(pipeline->InputPolyData, displayNode, regionNode))
   {
-    vtkWarningWithObjectMacro(displayNode, "Failed to show transform in 3D: unsupported ROI type");
+    vtkWarningWithObjectMacro(displayNode, "Failed to show transform in 3D: invalid transform or unsupported ROI type");
     pipeline->Actor->SetVisibility(false);
     return;
   }
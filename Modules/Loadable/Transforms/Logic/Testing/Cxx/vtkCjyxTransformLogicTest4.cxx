@@ -0,0 +1,258 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Cjyx
+
+=========================================================================auto=*/
+
+// Logic includes
+#include "vtkCjyxTransformLogic.h"
+#include "vtkCjyxTransformSamplingCancelToken.h"
+
+// DMML includes
+#include "vtkDMMLCoreTestingMacros.h"
+#include "vtkDMMLScalarVolumeNode.h"
+#include "vtkDMMLScene.h"
+#include "vtkDMMLTransformDisplayNode.h"
+#include "vtkDMMLTransformNode.h"
+
+// VTK includes
+#include <vtkGeneralTransform.h>
+#include <vtkImageData.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkOrientedGridTransform.h>
+#include <vtkPolyData.h>
+#include <vtkTimerLog.h>
+#include <vtkTransform.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+// Benchmark of sampling a composite (linear + grid) transform chain.
+// The first optional argument specifies the size of the sampled volume (default: 64).
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+// Create a parent linear transform and a child grid transform (stored as transform from parent,
+// so that its inverse has to be computed iteratively when transform to world is sampled)
+vtkDMMLTransformNode* CreateCompositeTransform(vtkDMMLScene* scene)
+{
+  vtkNew<vtkTransform> linearTransform;
+  linearTransform->Translate(5.0, -3.0, 10.0);
+  linearTransform->RotateZ(15.0);
+  linearTransform->Scale(1.1, 0.9, 1.0);
+  vtkNew<vtkDMMLTransformNode> linearTransformNode;
+  linearTransformNode->SetAndObserveTransformToParent(linearTransform.GetPointer());
+  scene->AddNode(linearTransformNode.GetPointer());
+
+  const int gridSize = 16;
+  const double gridSpacing = 10.0;
+  vtkNew<vtkImageData> displacementGrid;
+  displacementGrid->SetDimensions(gridSize, gridSize, gridSize);
+  displacementGrid->SetOrigin(-75.0, -75.0, -75.0);
+  displacementGrid->SetSpacing(gridSpacing, gridSpacing, gridSpacing);
+  displacementGrid->AllocateScalars(VTK_DOUBLE, 3);
+  double* displacement = static_cast<double*>(displacementGrid->GetScalarPointer());
+  for (int k = 0; k < gridSize; ++k)
+    {
+    for (int j = 0; j < gridSize; ++j)
+      {
+      for (int i = 0; i < gridSize; ++i)
+        {
+        *(displacement++) = 4.0 * sin(j * 0.5);
+        *(displacement++) = 3.0 * cos(i * 0.4);
+        *(displacement++) = 2.0 * sin(k * 0.3);
+        }
+      }
+    }
+  vtkNew<vtkOrientedGridTransform> gridTransform;
+  gridTransform->SetDisplacementGridData(displacementGrid.GetPointer());
+  vtkNew<vtkDMMLTransformNode> gridTransformNode;
+  gridTransformNode->SetAndObserveTransformFromParent(gridTransform.GetPointer());
+  scene->AddNode(gridTransformNode.GetPointer());
+  gridTransformNode->SetAndObserveTransformNodeID(linearTransformNode->GetID());
+
+  return gridTransformNode.GetPointer();
+}
+
+//-----------------------------------------------------------------------------
+// Compute displacement magnitude image by transforming one point at a time
+void ComputeReferenceMagnitudeImage(vtkImageData* image, vtkDMMLTransformNode* transformNode, vtkMatrix4x4* ijkToRAS)
+{
+  vtkNew<vtkGeneralTransform> transformToWorld;
+  transformNode->GetTransformToWorld(transformToWorld.GetPointer());
+  image->AllocateScalars(VTK_FLOAT, 1);
+  float* voxelPtr = static_cast<float*>(image->GetScalarPointer());
+  int* extent = image->GetExtent();
+  double point_IJK[4] = { 0, 0, 0, 1 };
+  double point_RAS[4] = { 0, 0, 0, 1 };
+  double transformedPoint_RAS[3] = { 0, 0, 0 };
+  for (point_IJK[2] = extent[4]; point_IJK[2] <= extent[5]; point_IJK[2]++)
+    {
+    for (point_IJK[1] = extent[2]; point_IJK[1] <= extent[3]; point_IJK[1]++)
+      {
+      for (point_IJK[0] = extent[0]; point_IJK[0] <= extent[1]; point_IJK[0]++)
+        {
+        ijkToRAS->MultiplyPoint(point_IJK, point_RAS);
+        transformToWorld->TransformPoint(point_RAS, transformedPoint_RAS);
+        *(voxelPtr++) = static_cast<float>(sqrt(vtkMath::Distance2BetweenPoints(point_RAS, transformedPoint_RAS)));
+        }
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+double GetMaximumDifference(vtkImageData* image1, vtkImageData* image2)
+{
+  float* voxels1 = static_cast<float*>(image1->GetScalarPointer());
+  float* voxels2 = static_cast<float*>(image2->GetScalarPointer());
+  vtkIdType numberOfValues = image1->GetNumberOfPoints() * image1->GetNumberOfScalarComponents();
+  double maximumDifference = 0.0;
+  for (vtkIdType i = 0; i < numberOfValues; ++i)
+    {
+    maximumDifference = std::max(maximumDifference, static_cast<double>(fabs(voxels1[i] - voxels2[i])));
+    }
+  return maximumDifference;
+}
+
+//-----------------------------------------------------------------------------
+int TestCancelledVisualization(vtkDMMLScene* scene, vtkDMMLTransformNode* transformNode)
+{
+  vtkNew<vtkDMMLTransformDisplayNode> displayNode;
+  scene->AddNode(displayNode.GetPointer());
+  transformNode->SetAndObserveDisplayNodeID(displayNode->GetID());
+
+  vtkNew<vtkMatrix4x4> sliceToRAS;
+  double fieldOfViewOrigin[3] = { 0.0, 0.0, 0.0 };
+  double fieldOfViewSize[3] = { 140.0, 140.0, 1.0 };
+  vtkNew<vtkMatrix4x4> roiToRAS;
+  for (int i = 0; i < 3; ++i)
+    {
+    roiToRAS->SetElement(i, i, 10.0);
+    roiToRAS->SetElement(i, 3, -70.0);
+    }
+  int roiSize[3] = { 14, 14, 14 };
+
+  vtkNew<vtkCjyxTransformSamplingCancelToken> cancelToken;
+  const int visualizationModes[3] = { vtkDMMLTransformDisplayNode::VIS_MODE_GLYPH,
+    vtkDMMLTransformDisplayNode::VIS_MODE_GRID, vtkDMMLTransformDisplayNode::VIS_MODE_CONTOUR };
+  for (int visualizationMode : visualizationModes)
+    {
+    displayNode->SetVisualizationMode(visualizationMode);
+
+    // Output is not modified if cancelled
+    cancelToken->Cancel();
+    vtkNew<vtkPolyData> visualization2d;
+    CHECK_BOOL(vtkCjyxTransformLogic::GetVisualization2d(visualization2d.GetPointer(), displayNode.GetPointer(),
+      sliceToRAS.GetPointer(), fieldOfViewOrigin, fieldOfViewSize, nullptr, cancelToken.GetPointer()), false);
+    CHECK_INT(visualization2d->GetNumberOfPoints(), 0);
+    vtkNew<vtkPolyData> visualization3d;
+    CHECK_BOOL(vtkCjyxTransformLogic::GetVisualization3d(visualization3d.GetPointer(), displayNode.GetPointer(),
+      roiToRAS.GetPointer(), roiSize, nullptr, cancelToken.GetPointer()), false);
+    CHECK_INT(visualization3d->GetNumberOfPoints(), 0);
+
+    cancelToken->Reset();
+    CHECK_BOOL(vtkCjyxTransformLogic::GetVisualization2d(visualization2d.GetPointer(), displayNode.GetPointer(),
+      sliceToRAS.GetPointer(), fieldOfViewOrigin, fieldOfViewSize, nullptr, cancelToken.GetPointer()), true);
+    CHECK_BOOL(vtkCjyxTransformLogic::GetVisualization3d(visualization3d.GetPointer(), displayNode.GetPointer(),
+      roiToRAS.GetPointer(), roiSize, nullptr, cancelToken.GetPointer()), true);
+    if (visualizationMode == vtkDMMLTransformDisplayNode::VIS_MODE_GRID)
+      {
+      CHECK_BOOL(visualization2d->GetNumberOfPoints() > 0, true);
+      CHECK_BOOL(visualization3d->GetNumberOfPoints() > 0, true);
+      }
+    }
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int vtkCjyxTransformLogicTest4(int argc, char * argv [])
+{
+  int volumeSize = 64;
+  if (argc > 1)
+    {
+    volumeSize = atoi(argv[1]);
+    }
+
+  vtkNew<vtkDMMLScene> scene;
+  vtkNew<vtkCjyxTransformLogic> logic;
+  logic->SetDMMLScene(scene.GetPointer());
+  vtkDMMLTransformNode* transformNode = CreateCompositeTransform(scene.GetPointer());
+
+  vtkNew<vtkMatrix4x4> ijkToRAS;
+  double spacing = 140.0 / volumeSize;
+  for (int i = 0; i < 3; ++i)
+    {
+    ijkToRAS->SetElement(i, i, spacing);
+    ijkToRAS->SetElement(i, 3, -70.0);
+    }
+
+  // Sequential reference
+  vtkNew<vtkTimerLog> timer;
+  vtkNew<vtkImageData> referenceImage;
+  referenceImage->SetExtent(0, volumeSize - 1, 0, volumeSize - 1, 0, volumeSize - 1);
+  timer->StartTimer();
+  ComputeReferenceMagnitudeImage(referenceImage.GetPointer(), transformNode, ijkToRAS.GetPointer());
+  timer->StopTimer();
+  double sequentialTime = timer->GetElapsedTime();
+
+  // Parallel sampling
+  vtkNew<vtkImageData> magnitudeImage;
+  magnitudeImage->SetExtent(referenceImage->GetExtent());
+  timer->StartTimer();
+  CHECK_BOOL(vtkCjyxTransformLogic::GetTransformedPointSamplesAsMagnitudeImage(
+    magnitudeImage.GetPointer(), transformNode, ijkToRAS.GetPointer()), true);
+  timer->StopTimer();
+  double parallelTime = timer->GetElapsedTime();
+  std::cout << "Magnitude image of " << volumeSize << "^3 voxels: sequential " << sequentialTime
+    << "s, parallel " << parallelTime << "s" << std::endl;
+  CHECK_BOOL(GetMaximumDifference(magnitudeImage.GetPointer(), referenceImage.GetPointer()) < 1e-4, true);
+
+  // Displacement vector volume
+  vtkNew<vtkDMMLScalarVolumeNode> referenceVolumeNode;
+  referenceVolumeNode->SetIJKToRASMatrix(ijkToRAS.GetPointer());
+  referenceVolumeNode->SetAndObserveImageData(referenceImage.GetPointer());
+  scene->AddNode(referenceVolumeNode.GetPointer());
+  timer->StartTimer();
+  vtkDMMLVolumeNode* vectorVolumeNode = logic->CreateDisplacementVolumeFromTransform(transformNode, referenceVolumeNode.GetPointer(), false);
+  timer->StopTimer();
+  std::cout << "Displacement vector volume: " << timer->GetElapsedTime() << "s" << std::endl;
+  CHECK_NOT_NULL(vectorVolumeNode);
+  CHECK_INT(vectorVolumeNode->GetImageData()->GetNumberOfScalarComponents(), 3);
+  float* displacement = static_cast<float*>(vectorVolumeNode->GetImageData()->GetScalarPointer(3, 5, 7));
+  float* expectedMagnitude = static_cast<float*>(referenceImage->GetScalarPointer(3, 5, 7));
+  CHECK_DOUBLE_TOLERANCE(sqrt(displacement[0] * displacement[0] + displacement[1] * displacement[1]
+    + displacement[2] * displacement[2]), *expectedMagnitude, 1e-4);
+
+  // Cancelled sampling
+  vtkNew<vtkCjyxTransformSamplingCancelToken> cancelToken;
+  cancelToken->Cancel();
+  CHECK_BOOL(vtkCjyxTransformLogic::GetTransformedPointSamplesAsMagnitudeImage(
+    magnitudeImage.GetPointer(), transformNode, ijkToRAS.GetPointer(), true, cancelToken.GetPointer()), false);
+  int numberOfVolumeNodes = scene->GetNumberOfNodesByClass("vtkDMMLVolumeNode");
+  CHECK_NULL(logic->CreateDisplacementVolumeFromTransform(transformNode, referenceVolumeNode.GetPointer(),
+    true, nullptr, cancelToken.GetPointer()));
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkDMMLVolumeNode"), numberOfVolumeNodes);
+
+  // Token can be reused after reset
+  cancelToken->Reset();
+  CHECK_BOOL(vtkCjyxTransformLogic::GetTransformedPointSamplesAsMagnitudeImage(
+    magnitudeImage.GetPointer(), transformNode, ijkToRAS.GetPointer(), true, cancelToken.GetPointer()), true);
+  CHECK_BOOL(GetMaximumDifference(magnitudeImage.GetPointer(), referenceImage.GetPointer()) < 1e-4, true);
+
+  CHECK_EXIT_SUCCESS(TestCancelledVisualization(scene.GetPointer(), transformNode));
+
+  return EXIT_SUCCESS;
+}
@@ -8,6 +8,7 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 =========================================================================auto=*/
 
 #include "vtkCjyxTransformLogic.h"
+#include "vtkCjyxTransformSamplingCancelToken.h"
 
 #include "vtkTransformVisualizerGlyph3D.h"
 
@@ -38,6 +39,7 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 #include <vtkContourFilter.h>
 #include <vtkCellArray.h>
 #include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
 #include <vtkGeneralTransform.h>
 #include <vtkGlyphSource2D.h>
 #include <vtkImageData.h>
@@ -52,13 +54,13 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 #include <vtkPoints.h>
 #include <vtkPointSet.h>
 #include <vtkPointData.h>
+#include <vtkSMPTools.h>
 #include <vtkSphereSource.h>
 #include <vtkThinPlateSplineTransform.h>
 #include <vtkTransform.h>
 #include <vtkTransformPolyDataFilter.h>
 #include <vtkTubeFilter.h>
 #include <vtkUnstructuredGrid.h>
-#include <vtkVectorNorm.h>
 #include <vtkWarpVector.h>
 
 // ITK includes
@@ -79,6 +81,99 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 
 vtkStandardNewMacro(vtkCjyxTransformLogic);
 
+namespace
+{
+
+// Number of points that are transformed together. Cancel requests are checked before each block.
+const vtkIdType TRANSFORM_SAMPLING_BLOCK_SIZE = 1024;
+
+//----------------------------------------------------------------------------
+// Get transform to world or from world of the input transform node
+void GetTransformToWorldOrFromWorld(vtkDMMLTransformNode* inputTransformNode, bool transformToWorld,
+  vtkGeneralTransform* inputTransform)
+{
+  if (transformToWorld)
+  {
+    inputTransformNode->GetTransformToWorld(inputTransform);
+  }
+  else
+  {
+    inputTransformNode->GetTransformFromWorld(inputTransform);
+  }
+}
+
+//----------------------------------------------------------------------------
+// Compute displacement (transformed point position - point position) at numberOfSamples points.
+// Blocks of points are processed in parallel, each point is transformed by the whole transform chain.
+// getSamplePoint(sampleIndex, point_RAS) computes the position of the sample point,
+// setDisplacement(sampleIndex, displacement_RAS) stores the computed displacement.
+// Returns false if sampling was cancelled.
+template <class SamplePointGetter, class DisplacementSetter>
+bool SampleTransformDisplacements(vtkAbstractTransform* transform, vtkIdType numberOfSamples,
+  SamplePointGetter getSamplePoint, DisplacementSetter setDisplacement,
+  vtkCjyxTransformSamplingCancelToken* cancelToken)
+{
+  // Update() is not thread-safe, therefore it is called here once and then only
+  // InternalTransformPoint() is used, which does not modify the transform.
+  transform->Update();
+  vtkSMPTools::For(0, numberOfSamples, TRANSFORM_SAMPLING_BLOCK_SIZE, [&](vtkIdType begin, vtkIdType end)
+    {
+    if (cancelToken && cancelToken->GetCancelRequested())
+      {
+      return;
+      }
+    double point_RAS[3] = { 0, 0, 0 };
+    double transformedPoint_RAS[3] = { 0, 0, 0 };
+    double displacement_RAS[3] = { 0, 0, 0 };
+    for (vtkIdType sampleIndex = begin; sampleIndex < end; ++sampleIndex)
+      {
+      getSamplePoint(sampleIndex, point_RAS);
+      transform->InternalTransformPoint(point_RAS, transformedPoint_RAS);
+      displacement_RAS[0] = transformedPoint_RAS[0] - point_RAS[0];
+      displacement_RAS[1] = transformedPoint_RAS[1] - point_RAS[1];
+      displacement_RAS[2] = transformedPoint_RAS[2] - point_RAS[2];
+      setDisplacement(sampleIndex, displacement_RAS);
+      }
+    });
+  return !(cancelToken && cancelToken->GetCancelRequested());
+}
+
+//----------------------------------------------------------------------------
+// Compute displacement at each voxel of the image. Image scalars must be already allocated.
+// setDisplacement(voxelIndex, displacement_RAS) stores the computed displacement.
+template <class DisplacementSetter>
+bool SampleTransformDisplacementsInImage(vtkAbstractTransform* transform, vtkImageData* image, vtkMatrix4x4* ijkToRAS,
+  DisplacementSetter setDisplacement, vtkCjyxTransformSamplingCancelToken* cancelToken)
+{
+  int* extent = image->GetExtent();
+  vtkIdType dimensions[3] = { extent[1] - extent[0] + 1, extent[3] - extent[2] + 1, extent[5] - extent[4] + 1 };
+  if (dimensions[0] <= 0 || dimensions[1] <= 0 || dimensions[2] <= 0)
+  {
+    return true;
+  }
+  double ijkToRASElements[16] = { 0 };
+  vtkMatrix4x4::DeepCopy(ijkToRASElements, ijkToRAS);
+  auto getSamplePoint = [&](vtkIdType voxelIndex, double point_RAS[3])
+    {
+    double point_IJK[4] =
+      {
+      static_cast<double>(extent[0] + voxelIndex % dimensions[0]),
+      static_cast<double>(extent[2] + (voxelIndex / dimensions[0]) % dimensions[1]),
+      static_cast<double>(extent[4] + voxelIndex / (dimensions[0] * dimensions[1])),
+      1.0
+      };
+    double pointHomogeneous_RAS[4] = { 0, 0, 0, 1 };
+    vtkMatrix4x4::MultiplyPoint(ijkToRASElements, point_IJK, pointHomogeneous_RAS);
+    point_RAS[0] = pointHomogeneous_RAS[0];
+    point_RAS[1] = pointHomogeneous_RAS[1];
+    point_RAS[2] = pointHomogeneous_RAS[2];
+    };
+  return SampleTransformDisplacements(transform, dimensions[0] * dimensions[1] * dimensions[2],
+    getSamplePoint, setDisplacement, cancelToken);
+}
+
+} // end of anonymous namespace
+
 //----------------------------------------------------------------------------
 vtkCjyxTransformLogic::vtkCjyxTransformLogic() = default;
 
@@ -201,27 +296,17 @@ const char* vtkCjyxTransformLogic::GetVisualizationDisplacementMagnitudeScalarNa
 }
 
 //----------------------------------------------------------------------------
-void vtkCjyxTransformLogic::GetTransformedPointSamples(vtkPointSet* outputPointSet,
+bool vtkCjyxTransformLogic::GetTransformedPointSamples(vtkPointSet* outputPointSet,
   vtkDMMLTransformNode* inputTransformNode, vtkMatrix4x4* gridToRAS, int* gridSize,
-  bool transformToWorld /* = true */)
+  bool transformToWorld /* = true */, vtkCjyxTransformSamplingCancelToken* cancelToken /* = nullptr */)
 {
-  vtkNew<vtkGeneralTransform> inputTransform;
-  if (transformToWorld)
-  {
-    inputTransformNode->GetTransformToWorld(inputTransform.GetPointer());
-  }
-  else
-  {
-    inputTransformNode->GetTransformFromWorld(inputTransform.GetPointer());
-  }
-  // Generate sample point set on a grid
+  // Generate sample point set on a grid (the points are transformed in GetTransformedPointSamples)
   vtkNew<vtkPoints> samplePositions_RAS;
-  int numOfSamples = gridSize[0] * gridSize[1] * gridSize[2];
+  vtkIdType numOfSamples = static_cast<vtkIdType>(gridSize[0]) * gridSize[1] * gridSize[2];
   samplePositions_RAS->SetNumberOfPoints(numOfSamples);
   double point_RAS[4] = { 0, 0, 0, 1 };
-  double transformedPoint_RAS[4] = { 0, 0, 0, 1 };
   double point_Grid[4] = { 0, 0, 0, 1 };
-  int sampleIndex = 0;
+  vtkIdType sampleIndex = 0;
   for (point_Grid[2] = 0; point_Grid[2]<gridSize[2]; point_Grid[2]++)
     {
     for (point_Grid[1] = 0; point_Grid[1]<gridSize[1]; point_Grid[1]++)
@@ -229,80 +314,76 @@ void vtkCjyxTransformLogic::GetTransformedPointSamples(vtkPointSet* outputPointS
       for (point_Grid[0] = 0; point_Grid[0]<gridSize[0]; point_Grid[0]++)
         {
         gridToRAS->MultiplyPoint(point_Grid, point_RAS);
-        inputTransform->TransformPoint(point_RAS, transformedPoint_RAS);
         samplePositions_RAS->SetPoint(sampleIndex, point_RAS[0], point_RAS[1], point_RAS[2]);
         sampleIndex++;
         }
       }
    }
 
-  vtkCjyxTransformLogic::GetTransformedPointSamples(outputPointSet, inputTransformNode, samplePositions_RAS.GetPointer(), transformToWorld);
+  return vtkCjyxTransformLogic::GetTransformedPointSamples(outputPointSet, inputTransformNode, samplePositions_RAS.GetPointer(),
+    transformToWorld, cancelToken);
 }
 
 //----------------------------------------------------------------------------
-void vtkCjyxTransformLogic::GetTransformedPointSamples(vtkPointSet* outputPointSet,
+bool vtkCjyxTransformLogic::GetTransformedPointSamples(vtkPointSet* outputPointSet,
   vtkDMMLTransformNode* inputTransformNode, vtkPoints* samplePositions_RAS,
-  bool transformToWorld /* = true */)
+  bool transformToWorld /* = true */, vtkCjyxTransformSamplingCancelToken* cancelToken /* = nullptr */)
 {
   if (!inputTransformNode)
     {
-    return;
+    return false;
     }
 
-  //Will contain the corresponding vectors for outputPointSet
-  int numOfSamples = samplePositions_RAS->GetNumberOfPoints();
+  //Will contain the corresponding vectors and their magnitude for outputPointSet
+  vtkIdType numOfSamples = samplePositions_RAS->GetNumberOfPoints();
   vtkNew<vtkDoubleArray> sampleVectors_RAS;
-  sampleVectors_RAS->Initialize();
   sampleVectors_RAS->SetNumberOfComponents(3);
   sampleVectors_RAS->SetNumberOfTuples(numOfSamples);
   sampleVectors_RAS->SetName("DisplacementVector");
+  vtkNew<vtkFloatArray> vectorMagnitude;
+  vectorMagnitude->SetNumberOfTuples(numOfSamples);
+  vectorMagnitude->SetName(GetVisualizationDisplacementMagnitudeScalarName());
 
   vtkNew<vtkGeneralTransform> inputTransform;
-  if (transformToWorld)
+  GetTransformToWorldOrFromWorld(inputTransformNode, transformToWorld, inputTransform.GetPointer());
+
+  double* sampleVectorsPtr = sampleVectors_RAS->GetPointer(0);
+  float* vectorMagnitudePtr = vectorMagnitude->GetPointer(0);
+  bool completed = SampleTransformDisplacements(inputTransform.GetPointer(), numOfSamples,
+    [&](vtkIdType sampleIndex, double point_RAS[3])
     {
-    inputTransformNode->GetTransformToWorld(inputTransform.GetPointer());
-    }
-  else
+    samplePositions_RAS->GetPoint(sampleIndex, point_RAS);
+    },
+    [&](vtkIdType sampleIndex, const double displacement_RAS[3])
     {
-    inputTransformNode->GetTransformFromWorld(inputTransform.GetPointer());
-    }
-
-  double transformedPoint_RAS[4] = { 0, 0, 0, 1 };
-  double pointDislocationVector_RAS[4] = { 0, 0, 0, 1 };
-  for (int sampleIndex = 0; sampleIndex < numOfSamples; sampleIndex++)
+    double* sampleVector = sampleVectorsPtr + 3 * sampleIndex;
+    sampleVector[0] = displacement_RAS[0];
+    sampleVector[1] = displacement_RAS[1];
+    sampleVector[2] = displacement_RAS[2];
+    vectorMagnitudePtr[sampleIndex] = static_cast<float>(vtkMath::Norm(displacement_RAS));
+    },
+    cancelToken);
+  if (!completed)
     {
-    double* point_RAS = samplePositions_RAS->GetPoint(sampleIndex);
-
-    inputTransform->TransformPoint(point_RAS, transformedPoint_RAS);
-
-    pointDislocationVector_RAS[0] = transformedPoint_RAS[0] - point_RAS[0];
-    pointDislocationVector_RAS[1] = transformedPoint_RAS[1] - point_RAS[1];
-    pointDislocationVector_RAS[2] = transformedPoint_RAS[2] - point_RAS[2];
-
-    sampleVectors_RAS->SetTuple3(sampleIndex, pointDislocationVector_RAS[0], pointDislocationVector_RAS[1], pointDislocationVector_RAS[2]);
+    return false;
     }
 
   outputPointSet->SetPoints(samplePositions_RAS);
   vtkPointData* pointData = outputPointSet->GetPointData();
   pointData->SetVectors(sampleVectors_RAS.GetPointer());
-
-  // Compute vector magnitude and add to the data set
-  vtkNew<vtkVectorNorm> norm;
-  norm->SetInputData(outputPointSet);
-  norm->Update();
-  vtkDataArray* vectorMagnitude = norm->GetOutput()->GetPointData()->GetScalars();
-  vectorMagnitude->SetName(GetVisualizationDisplacementMagnitudeScalarName());
   int idx = pointData->AddArray(vectorMagnitude);
   pointData->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
+  return true;
 }
 
 /// Takes samples from the displacement field specified by the transformation on a slice
 /// and stores it in an unstructured grid.
 /// pointGroupSize: the number of points will be N*pointGroupSize (the actual number will be returned in numGridPoints[3])
 //----------------------------------------------------------------------------
-void vtkCjyxTransformLogic::GetTransformedPointSamplesOnSlice(vtkPointSet* outputPointSet, vtkDMMLTransformNode* inputTransformNode,
+bool vtkCjyxTransformLogic::GetTransformedPointSamplesOnSlice(vtkPointSet* outputPointSet, vtkDMMLTransformNode* inputTransformNode,
   vtkMatrix4x4* sliceToRAS, double* fieldOfViewOrigin, double* fieldOfViewSize,
-  double pointSpacing, int pointGroupSize/*=1*/, int* numGridPoints/*=0*/, vtkPoints* samplePositions_RAS /*=nullptr*/)
+  double pointSpacing, int pointGroupSize/*=1*/, int* numGridPoints/*=0*/, vtkPoints* samplePositions_RAS /*=nullptr*/,
+  vtkCjyxTransformSamplingCancelToken* cancelToken /*=nullptr*/)
 {
   if (samplePositions_RAS)
     {
@@ -323,7 +404,11 @@ void vtkCjyxTransformLogic::GetTransformedPointSamplesOnSlice(vtkPointSet* outpu
         samplePositionsOnSlice_RAS->InsertNextPoint(markup_RAS);
         }
       }
-    GetTransformedPointSamples(outputPointSet, inputTransformNode, samplePositionsOnSlice_RAS.GetPointer());
+    if (!GetTransformedPointSamples(outputPointSet, inputTransformNode, samplePositionsOnSlice_RAS.GetPointer(),
+      true /* transformToWorld */, cancelToken))
+      {
+      return false;
+      }
     }
   else
     {
@@ -353,7 +438,11 @@ void vtkCjyxTransformLogic::GetTransformedPointSamplesOnSlice(vtkPointSet* outpu
       numGridPoints[2] = 1;
       }
 
-    GetTransformedPointSamples(outputPointSet, inputTransformNode, gridToRAS.GetPointer(), gridSize);
+    if (!GetTransformedPointSamples(outputPointSet, inputTransformNode, gridToRAS.GetPointer(), gridSize,
+      true /* transformToWorld */, cancelToken))
+      {
+      return false;
+      }
     }
 
   float sliceNormal_RAS[3] = { 0, 0, 0 };
@@ -377,11 +466,13 @@ void vtkCjyxTransformLogic::GetTransformedPointSamplesOnSlice(vtkPointSet* outpu
   }
   projectedVectors->SetName("ProjectedDisplacementVector");
   outputPointSet->GetPointData()->SetActiveAttribute(GetVisualizationDisplacementMagnitudeScalarName(), vtkDataSetAttributes::SCALARS);
+  return true;
 }
 
 //----------------------------------------------------------------------------
 bool vtkCjyxTransformLogic::GetTransformedPointSamplesAsMagnitudeImage(vtkImageData* magnitudeImage,
-  vtkDMMLTransformNode* inputTransformNode, vtkMatrix4x4* ijkToRAS, bool transformToWorld /* = true */)
+  vtkDMMLTransformNode* inputTransformNode, vtkMatrix4x4* ijkToRAS, bool transformToWorld /* = true */,
+  vtkCjyxTransformSamplingCancelToken* cancelToken /* = nullptr */)
 {
   if (!magnitudeImage || !inputTransformNode || !ijkToRAS)
   {
@@ -390,56 +481,26 @@ bool vtkCjyxTransformLogic::GetTransformedPointSamplesAsMagnitudeImage(vtkImageD
   }
 
   vtkNew<vtkGeneralTransform> inputTransform;
-  if (transformToWorld)
-  {
-    inputTransformNode->GetTransformToWorld(inputTransform.GetPointer());
-  }
-  else
-  {
-    inputTransformNode->GetTransformFromWorld(inputTransform.GetPointer());
-  }
+  GetTransformToWorldOrFromWorld(inputTransformNode, transformToWorld, inputTransform.GetPointer());
 
   // The orientation of the volume cannot be set in the image
   // therefore the volume will not appear in the correct position
   // if the direction matrix is not identity.
   magnitudeImage->AllocateScalars(VTK_FLOAT, 1);
 
-  double point_RAS[4] = { 0, 0, 0, 1 };
-  double transformedPoint_RAS[4] = { 0, 0, 0, 1 };
-  double pointDislocationVector_RAS[4] = { 0, 0, 0, 1 };
-  double point_IJK[4] = { 0, 0, 0, 1 };
   float* voxelPtr = static_cast<float*>(magnitudeImage->GetScalarPointer());
-  int* extent = magnitudeImage->GetExtent();
-  for (point_IJK[2] = extent[4]; point_IJK[2] <= extent[5]; point_IJK[2]++)
-  {
-    for (point_IJK[1] = extent[2]; point_IJK[1] <= extent[3]; point_IJK[1]++)
+  return SampleTransformDisplacementsInImage(inputTransform.GetPointer(), magnitudeImage, ijkToRAS,
+    [&](vtkIdType voxelIndex, const double displacement_RAS[3])
     {
-      for (point_IJK[0] = extent[0]; point_IJK[0] <= extent[1]; point_IJK[0]++)
-      {
-        ijkToRAS->MultiplyPoint(point_IJK, point_RAS);
-
-        inputTransform->TransformPoint(point_RAS, transformedPoint_RAS);
-
-        pointDislocationVector_RAS[0] = transformedPoint_RAS[0] - point_RAS[0];
-        pointDislocationVector_RAS[1] = transformedPoint_RAS[1] - point_RAS[1];
-        pointDislocationVector_RAS[2] = transformedPoint_RAS[2] - point_RAS[2];
-
-        float mag = sqrt(
-          pointDislocationVector_RAS[0] * pointDislocationVector_RAS[0] +
-          pointDislocationVector_RAS[1] * pointDislocationVector_RAS[1] +
-          pointDislocationVector_RAS[2] * pointDislocationVector_RAS[2]);
-
-        *(voxelPtr++) = mag;
-      }
-    }
-  }
-
-  return true;
+    voxelPtr[voxelIndex] = static_cast<float>(vtkMath::Norm(displacement_RAS));
+    },
+    cancelToken);
 }
 
 //----------------------------------------------------------------------------
 vtkDMMLVolumeNode* vtkCjyxTransformLogic::CreateDisplacementVolumeFromTransform(vtkDMMLTransformNode* inputTransformNode,
-  vtkDMMLVolumeNode* referenceVolumeNode, bool magnitude/*=true*/, vtkDMMLVolumeNode* existingOutputVolumeNode /* = nullptr */)
+  vtkDMMLVolumeNode* referenceVolumeNode, bool magnitude/*=true*/, vtkDMMLVolumeNode* existingOutputVolumeNode /* = nullptr */,
+  vtkCjyxTransformSamplingCancelToken* cancelToken /* = nullptr */)
 {
   if (inputTransformNode == nullptr)
   {
@@ -522,17 +583,29 @@ vtkDMMLVolumeNode* vtkCjyxTransformLogic::CreateDisplacementVolumeFromTransform(
   }
 
   // Fill the volume
+  bool completed = false;
   if (magnitude)
   {
-    vtkCjyxTransformLogic::GetTransformedPointSamplesAsMagnitudeImage(outputVolume, inputTransformNode, ijkToRas.GetPointer());
+    completed = vtkCjyxTransformLogic::GetTransformedPointSamplesAsMagnitudeImage(outputVolume, inputTransformNode, ijkToRas.GetPointer(),
+      true /* transformToWorld */, cancelToken);
     outputVolumeNode->SetVoxelVectorType(vtkDMMLVolumeNode::VoxelVectorTypeUndefined);
   }
   else
   {
-    vtkCjyxTransformLogic::GetTransformedPointSamplesAsVectorImage(outputVolume, inputTransformNode, ijkToRas.GetPointer());
+    completed = vtkCjyxTransformLogic::GetTransformedPointSamplesAsVectorImage(outputVolume, inputTransformNode, ijkToRas.GetPointer(),
+      true /* transformToWorld */, cancelToken);
     // This indicates that the voxel values should be transformed to LPS when written to file
     outputVolumeNode->SetVoxelVectorType(vtkDMMLVolumeNode::VoxelVectorTypeSpatial);
   }
+  if (!completed)
+  {
+    // cancelled
+    if (outputVolumeNode != existingOutputVolumeNode)
+      {
+      scene->RemoveNode(outputVolumeNode);
+      }
+    return nullptr;
+  }
 
   if (outputVolumeNode->GetDisplayNode() == nullptr)
   {
@@ -689,7 +762,8 @@ vtkDMMLTransformNode* vtkCjyxTransformLogic::ConvertToGridTransform(vtkDMMLTrans
 
 //----------------------------------------------------------------------------
 bool vtkCjyxTransformLogic::GetTransformedPointSamplesAsVectorImage(vtkImageData* vectorImage,
-  vtkDMMLTransformNode* inputTransformNode, vtkMatrix4x4* ijkToRAS, bool transformToWorld /* = true */)
+  vtkDMMLTransformNode* inputTransformNode, vtkMatrix4x4* ijkToRAS, bool transformToWorld /* = true */,
+  vtkCjyxTransformSamplingCancelToken* cancelToken /* = nullptr */)
 {
   if (!vectorImage || !inputTransformNode || !ijkToRAS)
   {
@@ -697,50 +771,31 @@ bool vtkCjyxTransformLogic::GetTransformedPointSamplesAsVectorImage(vtkImageData
     return false;
   }
   vtkNew<vtkGeneralTransform> inputTransform;
-  if (transformToWorld)
-  {
-    inputTransformNode->GetTransformToWorld(inputTransform.GetPointer());
-  }
-  else
-  {
-    inputTransformNode->GetTransformFromWorld(inputTransform.GetPointer());
-  }
+  GetTransformToWorldOrFromWorld(inputTransformNode, transformToWorld, inputTransform.GetPointer());
 
   // The orientation of the volume cannot be set in the image
   // therefore the volume will not appear in the correct position
   // if the direction matrix is not identity.
   vectorImage->AllocateScalars(VTK_FLOAT, 3);
 
-  double point_RAS[4] = { 0, 0, 0, 1 };
-  double transformedPoint_RAS[4] = { 0, 0, 0, 1 };
-  double point_IJK[4] = { 0, 0, 0, 1 };
   float* voxelPtr = static_cast<float*>(vectorImage->GetScalarPointer());
-  int* extent = vectorImage->GetExtent();
-  for (point_IJK[2] = extent[4]; point_IJK[2] <= extent[5]; point_IJK[2]++)
-  {
-    for (point_IJK[1] = extent[2]; point_IJK[1] <= extent[3]; point_IJK[1]++)
+  return SampleTransformDisplacementsInImage(inputTransform.GetPointer(), vectorImage, ijkToRAS,
+    [&](vtkIdType voxelIndex, const double displacement_RAS[3])
     {
-      for (point_IJK[0] = extent[0]; point_IJK[0] <= extent[1]; point_IJK[0]++)
-      {
-        ijkToRAS->MultiplyPoint(point_IJK, point_RAS);
-
-        inputTransform->TransformPoint(point_RAS, transformedPoint_RAS);
-
-        // store the pointDislocationVector_RAS components in the image
-        *(voxelPtr++) = static_cast<float>(transformedPoint_RAS[0] - point_RAS[0]);
-        *(voxelPtr++) = static_cast<float>(transformedPoint_RAS[1] - point_RAS[1]);
-        *(voxelPtr++) = static_cast<float>(transformedPoint_RAS[2] - point_RAS[2]);
-      }
-    }
-  }
-
-  return true;
+    // store the pointDislocationVector_RAS components in the image
+    float* voxel = voxelPtr + 3 * voxelIndex;
+    voxel[0] = static_cast<float>(displacement_RAS[0]);
+    voxel[1] = static_cast<float>(displacement_RAS[1]);
+    voxel[2] = static_cast<float>(displacement_RAS[2]);
+    },
+    cancelToken);
 }
 
 //----------------------------------------------------------------------------
-void vtkCjyxTransformLogic::GetTransformedPointSamplesOnRoi(vtkPointSet* pointSet,
+bool vtkCjyxTransformLogic::GetTransformedPointSamplesOnRoi(vtkPointSet* pointSet,
   vtkDMMLTransformNode* inputTransformNode, vtkMatrix4x4* roiToRAS,
-  int* roiSize, double pointSpacingMm, int pointGroupSize/*=1*/, int* numGridPoints/*=0*/)
+  int* roiSize, double pointSpacingMm, int pointGroupSize/*=1*/, int* numGridPoints/*=0*/,
+  vtkCjyxTransformSamplingCancelToken* cancelToken /*=nullptr*/)
 {
   double roiSpacing[3] =
   {
@@ -781,7 +836,11 @@ void vtkCjyxTransformLogic::GetTransformedPointSamplesOnRoi(vtkPointSet* pointSe
   // we could have one more or one less grid size when the roiSpacing does not match exactly the
   // glyph spacing.
 
-  GetTransformedPointSamples(pointSet, inputTransformNode, gridToRAS.GetPointer(), gridSize);
+  if (!GetTransformedPointSamples(pointSet, inputTransformNode, gridToRAS.GetPointer(), gridSize,
+    true /* transformToWorld */, cancelToken))
+  {
+    return false;
+  }
 
   if (numGridPoints != nullptr)
   {
@@ -789,22 +848,30 @@ void vtkCjyxTransformLogic::GetTransformedPointSamplesOnRoi(vtkPointSet* pointSe
     numGridPoints[1] = gridSize[1];
     numGridPoints[2] = gridSize[2];
   }
+  return true;
 }
 
 //----------------------------------------------------------------------------
-void vtkCjyxTransformLogic::GetGlyphVisualization3d(vtkPolyData* output,
+bool vtkCjyxTransformLogic::GetGlyphVisualization3d(vtkPolyData* output,
   vtkDMMLTransformDisplayNode* displayNode, vtkMatrix4x4* roiToRAS, int* roiSize,
-  vtkPoints* samplePositions_RAS)
+  vtkPoints* samplePositions_RAS, vtkCjyxTransformSamplingCancelToken* cancelToken)
 {
   vtkNew<vtkUnstructuredGrid> pointSet;
   vtkDMMLTransformNode* inputTransformNode = vtkDMMLTransformNode::SafeDownCast(displayNode->GetDisplayableNode());
+  bool completed = false;
   if (samplePositions_RAS)
     {
-    GetTransformedPointSamples(pointSet.GetPointer(), inputTransformNode, samplePositions_RAS);
+    completed = GetTransformedPointSamples(pointSet.GetPointer(), inputTransformNode, samplePositions_RAS,
+      true /* transformToWorld */, cancelToken);
     }
   else
     {
-    GetTransformedPointSamplesOnRoi(pointSet.GetPointer(), inputTransformNode, roiToRAS, roiSize, displayNode->GetGlyphSpacingMm());
+    completed = GetTransformedPointSamplesOnRoi(pointSet.GetPointer(), inputTransformNode, roiToRAS, roiSize,
+      displayNode->GetGlyphSpacingMm(), 1, nullptr, cancelToken);
+    }
+  if (!completed)
+    {
+    return false;
     }
 
   vtkNew<vtkTransformVisualizerGlyph3D> glyphFilter;
@@ -863,20 +930,25 @@ void vtkCjyxTransformLogic::GetGlyphVisualization3d(vtkPolyData* output,
 
   glyphFilter->Update();
   output->ShallowCopy(glyphFilter->GetOutput());
+  return true;
 }
 
 //----------------------------------------------------------------------------
-void vtkCjyxTransformLogic::GetGlyphVisualization2d(vtkPolyData* output,
+bool vtkCjyxTransformLogic::GetGlyphVisualization2d(vtkPolyData* output,
   vtkDMMLTransformDisplayNode* displayNode, vtkMatrix4x4* sliceToRAS,
-  double* fieldOfViewOrigin, double* fieldOfViewSize, vtkPoints* samplePositions_RAS)
+  double* fieldOfViewOrigin, double* fieldOfViewSize, vtkPoints* samplePositions_RAS,
+  vtkCjyxTransformSamplingCancelToken* cancelToken)
 {
   //Pre-processing
   vtkNew<vtkUnstructuredGrid> pointSet;
   pointSet->Initialize();
 
   vtkDMMLTransformNode* inputTransformNode = vtkDMMLTransformNode::SafeDownCast(displayNode->GetDisplayableNode());
-  vtkCjyxTransformLogic::GetTransformedPointSamplesOnSlice(pointSet.GetPointer(), inputTransformNode, sliceToRAS,
-    fieldOfViewOrigin, fieldOfViewSize, displayNode->GetGlyphSpacingMm(), 1, nullptr, samplePositions_RAS);
+  if (!vtkCjyxTransformLogic::GetTransformedPointSamplesOnSlice(pointSet.GetPointer(), inputTransformNode, sliceToRAS,
+    fieldOfViewOrigin, fieldOfViewSize, displayNode->GetGlyphSpacingMm(), 1, nullptr, samplePositions_RAS, cancelToken))
+    {
+    return false;
+    }
 
   vtkNew<vtkTransformVisualizerGlyph3D> glyphFilter;
   vtkNew<vtkTransform> rotateArrow;
@@ -945,6 +1017,7 @@ void vtkCjyxTransformLogic::GetGlyphVisualization2d(vtkPolyData* output,
   glyphFilter->Update();
 
   output->ShallowCopy(glyphFilter->GetOutput());
+  return true;
 }
 
 //----------------------------------------------------------------------------
@@ -1028,18 +1101,21 @@ void vtkCjyxTransformLogic::CreateGrid(vtkPolyData* gridPolyData,
 }
 
 //----------------------------------------------------------------------------
-void vtkCjyxTransformLogic::GetGridVisualization2d(vtkPolyData* output,
+bool vtkCjyxTransformLogic::GetGridVisualization2d(vtkPolyData* output,
   vtkDMMLTransformDisplayNode* displayNode, vtkMatrix4x4* sliceToRAS,
-  double* fieldOfViewOrigin, double* fieldOfViewSize)
+  double* fieldOfViewOrigin, double* fieldOfViewSize, vtkCjyxTransformSamplingCancelToken* cancelToken)
 {
   double pointSpacing = displayNode->GetGridSpacingMm() / GetGridSubdivision(displayNode);
   int numGridPoints[3] = { 0 };
 
   vtkNew<vtkPolyData> gridPolyData;
   vtkDMMLTransformNode* transformNode = vtkDMMLTransformNode::SafeDownCast(displayNode->GetDisplayableNode());
-  GetTransformedPointSamplesOnSlice(gridPolyData.GetPointer(), transformNode,
+  if (!GetTransformedPointSamplesOnSlice(gridPolyData.GetPointer(), transformNode,
     sliceToRAS, fieldOfViewOrigin, fieldOfViewSize, pointSpacing,
-    GetGridSubdivision(displayNode), numGridPoints);
+    GetGridSubdivision(displayNode), numGridPoints, nullptr, cancelToken))
+  {
+    return false;
+  }
 
   if (displayNode->GetGridShowNonWarped())
   {
@@ -1076,18 +1152,23 @@ void vtkCjyxTransformLogic::GetGridVisualization2d(vtkPolyData* output,
     // The output is the warped grid
     CreateGrid(gridPolyData.GetPointer(), displayNode, numGridPoints, output);
   }
+  return true;
 }
 
 //----------------------------------------------------------------------------
-void vtkCjyxTransformLogic::GetGridVisualization3d(vtkPolyData* output, vtkDMMLTransformDisplayNode* displayNode, vtkMatrix4x4* roiToRAS, int* roiSize)
+bool vtkCjyxTransformLogic::GetGridVisualization3d(vtkPolyData* output, vtkDMMLTransformDisplayNode* displayNode, vtkMatrix4x4* roiToRAS, int* roiSize,
+  vtkCjyxTransformSamplingCancelToken* cancelToken)
 {
   double pointSpacing = displayNode->GetGridSpacingMm() / GetGridSubdivision(displayNode);
   int numGridPoints[3] = { 0 };
 
   vtkNew<vtkPolyData> gridPolyData;
   vtkDMMLTransformNode* inputTransformNode = vtkDMMLTransformNode::SafeDownCast(displayNode->GetDisplayableNode());
-  GetTransformedPointSamplesOnRoi(gridPolyData.GetPointer(), inputTransformNode,
-    roiToRAS, roiSize, pointSpacing, GetGridSubdivision(displayNode), numGridPoints);
+  if (!GetTransformedPointSamplesOnRoi(gridPolyData.GetPointer(), inputTransformNode,
+    roiToRAS, roiSize, pointSpacing, GetGridSubdivision(displayNode), numGridPoints, cancelToken))
+  {
+    return false;
+  }
 
   vtkNew<vtkPolyData> warpedGridPolyData;
   CreateGrid(gridPolyData.GetPointer(), displayNode, numGridPoints, warpedGridPolyData.GetPointer());
@@ -1098,12 +1179,13 @@ void vtkCjyxTransformLogic::GetGridVisualization3d(vtkPolyData* output, vtkDMMLT
   tubeFilter->SetNumberOfSides(8);
   tubeFilter->Update();
   output->ShallowCopy(tubeFilter->GetOutput());
+  return true;
 }
 
 //----------------------------------------------------------------------------
-void vtkCjyxTransformLogic::GetContourVisualization2d(vtkPolyData* output,
+bool vtkCjyxTransformLogic::GetContourVisualization2d(vtkPolyData* output,
   vtkDMMLTransformDisplayNode* displayNode, vtkMatrix4x4* sliceToRAS,
-  double* fieldOfViewOrigin, double* fieldOfViewSize)
+  double* fieldOfViewOrigin, double* fieldOfViewSize, vtkCjyxTransformSamplingCancelToken* cancelToken)
 {
   vtkNew<vtkImageData> magnitudeImage;
   double pointSpacing = displayNode->GetContourResolutionMm();
@@ -1130,7 +1212,11 @@ void vtkCjyxTransformLogic::GetContourVisualization2d(vtkPolyData* output,
 
   vtkDMMLTransformNode* inputTransformNode = vtkDMMLTransformNode::SafeDownCast(displayNode->GetDisplayableNode());
   magnitudeImage->SetExtent(0, imageSize[0] - 1, 0, imageSize[1] - 1, 0, imageSize[2] - 1);
-  GetTransformedPointSamplesAsMagnitudeImage(magnitudeImage.GetPointer(), inputTransformNode, ijkToRAS.GetPointer());
+  if (!GetTransformedPointSamplesAsMagnitudeImage(magnitudeImage.GetPointer(), inputTransformNode, ijkToRAS.GetPointer(),
+    true /* transformToWorld */, cancelToken))
+  {
+    return false;
+  }
 
   vtkNew<vtkContourFilter> contourFilter;
   double* levels = displayNode->GetContourLevelsMm();
@@ -1148,10 +1234,12 @@ void vtkCjyxTransformLogic::GetContourVisualization2d(vtkPolyData* output,
   transformSliceToRas->SetInputConnection(contourFilter->GetOutputPort());
   transformSliceToRas->Update();
   output->ShallowCopy(transformSliceToRas->GetOutput());
+  return true;
 }
 
 //----------------------------------------------------------------------------
-void vtkCjyxTransformLogic::GetContourVisualization3d(vtkPolyData* output, vtkDMMLTransformDisplayNode* displayNode, vtkMatrix4x4* roiToRAS, int* roiSize)
+bool vtkCjyxTransformLogic::GetContourVisualization3d(vtkPolyData* output, vtkDMMLTransformDisplayNode* displayNode, vtkMatrix4x4* roiToRAS, int* roiSize,
+  vtkCjyxTransformSamplingCancelToken* cancelToken)
 {
   // Compute the sampling image grid position, orientation, and spacing
   double pointSpacingMm = displayNode->GetContourResolutionMm();
@@ -1196,7 +1284,11 @@ void vtkCjyxTransformLogic::GetContourVisualization3d(vtkPolyData* output, vtkDM
   int imageSize[3] = { numOfPointsX, numOfPointsY, numOfPointsZ };
   vtkDMMLTransformNode* transformNode = vtkDMMLTransformNode::SafeDownCast(displayNode->GetDisplayableNode());
   magnitudeImage->SetExtent(0, imageSize[0] - 1, 0, imageSize[1] - 1, 0, imageSize[2] - 1);
-  GetTransformedPointSamplesAsMagnitudeImage(magnitudeImage.GetPointer(), transformNode, ijkToRAS.GetPointer());
+  if (!GetTransformedPointSamplesAsMagnitudeImage(magnitudeImage.GetPointer(), transformNode, ijkToRAS.GetPointer(),
+    true /* transformToWorld */, cancelToken))
+  {
+    return false;
+  }
 
   // Contput contours
   vtkNew<vtkContourFilter> contourFilter;
@@ -1216,12 +1308,13 @@ void vtkCjyxTransformLogic::GetContourVisualization3d(vtkPolyData* output, vtkDM
   transformSliceToRas->SetInputConnection(contourFilter->GetOutputPort());
   transformSliceToRas->Update();
   output->ShallowCopy(transformSliceToRas->GetOutput());
+  return true;
 }
 
 //----------------------------------------------------------------------------
 bool vtkCjyxTransformLogic::GetVisualization2d(vtkPolyData* output_RAS,
   vtkDMMLTransformDisplayNode* displayNode, vtkDMMLSliceNode* sliceNode,
-  vtkDMMLMarkupsNode* glyphPointsNode /*=nullptr*/)
+  vtkDMMLMarkupsNode* glyphPointsNode /*=nullptr*/, vtkCjyxTransformSamplingCancelToken* cancelToken /*=nullptr*/)
 {
   if (displayNode == nullptr || output_RAS == nullptr || sliceNode == nullptr)
   {
@@ -1238,14 +1331,14 @@ bool vtkCjyxTransformLogic::GetVisualization2d(vtkPolyData* output_RAS,
     samplePoints_RAS = vtkSmartPointer<vtkPoints>::New();
     vtkCjyxTransformLogic::GetMarkupsAsPoints(glyphPointsNode, samplePoints_RAS);
   }
-  GetVisualization2d(output_RAS, displayNode, sliceToRAS, fieldOfViewOrigin, fieldOfViewSize, samplePoints_RAS);
-
-  return true;
+  return GetVisualization2d(output_RAS, displayNode, sliceToRAS, fieldOfViewOrigin, fieldOfViewSize, samplePoints_RAS,
+    cancelToken);
 }
 
 //----------------------------------------------------------------------------
 bool vtkCjyxTransformLogic::GetVisualization2d(vtkPolyData* output, vtkDMMLTransformDisplayNode* displayNode,
-  vtkMatrix4x4* sliceToRAS, double* fieldOfViewOrigin, double* fieldOfViewSize, vtkPoints* samplePositions_RAS /*=nullptr*/)
+  vtkMatrix4x4* sliceToRAS, double* fieldOfViewOrigin, double* fieldOfViewSize, vtkPoints* samplePositions_RAS /*=nullptr*/,
+  vtkCjyxTransformSamplingCancelToken* cancelToken /*=nullptr*/)
 {
   if (displayNode == nullptr || output == nullptr || sliceToRAS == nullptr || fieldOfViewOrigin == nullptr || fieldOfViewSize == nullptr)
   {
@@ -1260,24 +1353,26 @@ bool vtkCjyxTransformLogic::GetVisualization2d(vtkPolyData* output, vtkDMMLTrans
     displayNode->SetScalarRange(range[0], range[1]);
   }
 
+  bool completed = true;
   switch (displayNode->GetVisualizationMode())
   {
   case vtkDMMLTransformDisplayNode::VIS_MODE_GLYPH:
-    GetGlyphVisualization2d(output, displayNode, sliceToRAS, fieldOfViewOrigin, fieldOfViewSize, samplePositions_RAS);
+    completed = GetGlyphVisualization2d(output, displayNode, sliceToRAS, fieldOfViewOrigin, fieldOfViewSize, samplePositions_RAS, cancelToken);
     break;
   case vtkDMMLTransformDisplayNode::VIS_MODE_GRID:
-    GetGridVisualization2d(output, displayNode, sliceToRAS, fieldOfViewOrigin, fieldOfViewSize);
+    completed = GetGridVisualization2d(output, displayNode, sliceToRAS, fieldOfViewOrigin, fieldOfViewSize, cancelToken);
     break;
   case vtkDMMLTransformDisplayNode::VIS_MODE_CONTOUR:
-    GetContourVisualization2d(output, displayNode, sliceToRAS, fieldOfViewOrigin, fieldOfViewSize);
+    completed = GetContourVisualization2d(output, displayNode, sliceToRAS, fieldOfViewOrigin, fieldOfViewSize, cancelToken);
     break;
   }
 
-  return true;
+  return completed;
 }
 
 //----------------------------------------------------------------------------
-bool vtkCjyxTransformLogic::GetVisualization3d(vtkPolyData* output, vtkDMMLTransformDisplayNode* displayNode, vtkDMMLNode* regionNode)
+bool vtkCjyxTransformLogic::GetVisualization3d(vtkPolyData* output, vtkDMMLTransformDisplayNode* displayNode, vtkDMMLNode* regionNode,
+  vtkCjyxTransformSamplingCancelToken* cancelToken /*=nullptr*/)
 {
   if (displayNode == nullptr || output == nullptr || regionNode == nullptr)
     {
@@ -1339,13 +1434,14 @@ bool vtkCjyxTransformLogic::GetVisualization3d(vtkPolyData* output, vtkDMMLTrans
     samplePoints_RAS = vtkSmartPointer<vtkPoints>::New();
     vtkCjyxTransformLogic::GetMarkupsAsPoints(glyphPointsNode, samplePoints_RAS);
     }
-  vtkCjyxTransformLogic::GetVisualization3d(output, displayNode, ijkToRAS.GetPointer(), regionSize_IJK, samplePoints_RAS);
-  return true;
+  return vtkCjyxTransformLogic::GetVisualization3d(output, displayNode, ijkToRAS.GetPointer(), regionSize_IJK, samplePoints_RAS,
+    cancelToken);
 }
 
 //----------------------------------------------------------------------------
 bool vtkCjyxTransformLogic::GetVisualization3d(vtkPolyData* output, vtkDMMLTransformDisplayNode* displayNode,
-  vtkMatrix4x4* roiToRAS, int* roiSize, vtkPoints* samplePositions_RAS /*=nullptr*/)
+  vtkMatrix4x4* roiToRAS, int* roiSize, vtkPoints* samplePositions_RAS /*=nullptr*/,
+  vtkCjyxTransformSamplingCancelToken* cancelToken /*=nullptr*/)
 {
   if (displayNode == nullptr || output == nullptr || roiToRAS == nullptr || roiSize == nullptr)
   {
@@ -1363,28 +1459,29 @@ bool vtkCjyxTransformLogic::GetVisualization3d(vtkPolyData* output, vtkDMMLTrans
   }
 
   displayNode->SetScalarVisibility(1);
+  bool completed = true;
   switch (displayNode->GetVisualizationMode())
   {
   case vtkDMMLTransformDisplayNode::VIS_MODE_GLYPH:
     displayNode->SetBackfaceCulling(1);
     displayNode->SetOpacity(1);
-    GetGlyphVisualization3d(output, displayNode, roiToRAS, roiSize, samplePositions_RAS);
+    completed = GetGlyphVisualization3d(output, displayNode, roiToRAS, roiSize, samplePositions_RAS, cancelToken);
     break;
   case vtkDMMLTransformDisplayNode::VIS_MODE_GRID:
     displayNode->SetBackfaceCulling(1);
     displayNode->SetOpacity(1);
-    GetGridVisualization3d(output, displayNode, roiToRAS, roiSize);
+    completed = GetGridVisualization3d(output, displayNode, roiToRAS, roiSize, cancelToken);
     break;
   case vtkDMMLTransformDisplayNode::VIS_MODE_CONTOUR:
     displayNode->SetBackfaceCulling(0);
     displayNode->SetOpacity(displayNode->GetContourOpacity());
-    GetContourVisualization3d(output, displayNode, roiToRAS, roiSize);
+    completed = GetContourVisualization3d(output, displayNode, roiToRAS, roiSize, cancelToken);
     break;
   }
 
   displayNode->EndModify(oldModify);
 
-  return true;
+  return completed;
 }
 
 //----------------------------------------------------------------------------
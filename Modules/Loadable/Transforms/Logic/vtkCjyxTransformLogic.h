@@ -41,6 +41,9 @@ class vtkDMMLTransformDisplayNode;
 class vtkDMMLTransformNode;
 class vtkDMMLVolumeNode;
 
+// Transforms logic includes
+class vtkCjyxTransformSamplingCancelToken;
+
 // VTK includes
 class vtkImageData;
 class vtkMatrix4x4;
@@ -73,26 +76,38 @@ class VTK_CJYX_TRANSFORMS_MODULE_LOGIC_EXPORT vtkCjyxTransformLogic : public vtk
   int SaveTransform (const char* filename, vtkDMMLTransformNode *transformNode);
 
   /// Generate polydata for 2D transform visualization
-  /// Return true on success.
+  /// If cancelToken is specified then the computation can be cancelled.
+  /// Return true on success, false if the input is invalid or the computation was cancelled
+  /// (output_RAS is not modified then).
   static bool GetVisualization2d(vtkPolyData* output_RAS, vtkDMMLTransformDisplayNode* displayNode,
-    vtkDMMLSliceNode* sliceNode, vtkDMMLMarkupsNode* glyphPointsNode = nullptr);
+    vtkDMMLSliceNode* sliceNode, vtkDMMLMarkupsNode* glyphPointsNode = nullptr,
+    vtkCjyxTransformSamplingCancelToken* cancelToken = nullptr);
 
   /// Generate polydata for 2D transform visualization
-  /// Return true on success.
+  /// If cancelToken is specified then the computation can be cancelled.
+  /// Return true on success, false if the input is invalid or the computation was cancelled
+  /// (output_RAS is not modified then).
   static bool GetVisualization2d(vtkPolyData* output_RAS, vtkDMMLTransformDisplayNode* displayNode,
-    vtkMatrix4x4* sliceToRAS, double* fieldOfViewOrigin, double* fieldOfViewSize, vtkPoints* samplePositions_RAS = nullptr);
+    vtkMatrix4x4* sliceToRAS, double* fieldOfViewOrigin, double* fieldOfViewSize, vtkPoints* samplePositions_RAS = nullptr,
+    vtkCjyxTransformSamplingCancelToken* cancelToken = nullptr);
 
   /// Generate polydata for 3D transform visualization
   /// roiToRAS defines the ROI origin and direction.
   /// roiSize defines the ROI size (in the ROI coordinate system spacing)  .
-  /// Return true on success.
+  /// If cancelToken is specified then the computation can be cancelled.
+  /// Return true on success, false if the input is invalid or the computation was cancelled
+  /// (output_RAS is not modified then).
   static bool GetVisualization3d(vtkPolyData* output_RAS, vtkDMMLTransformDisplayNode* displayNode,
-    vtkMatrix4x4* roiToRAS, int* roiSize, vtkPoints* samplePositions_RAS = nullptr);
+    vtkMatrix4x4* roiToRAS, int* roiSize, vtkPoints* samplePositions_RAS = nullptr,
+    vtkCjyxTransformSamplingCancelToken* cancelToken = nullptr);
 
   /// Generate polydata for 3D transform visualization
   /// Region node can be slice (vtkDMMLSliceNode), volume (vtkDMMLVolumeNode), region of interest (vtkDMMLAnnotationROINode), or model (vtkDMMLModelNode).
-  /// Return true on success.
-  static bool GetVisualization3d(vtkPolyData* output_RAS, vtkDMMLTransformDisplayNode* displayNode, vtkDMMLNode* regionNode);
+  /// If cancelToken is specified then the computation can be cancelled.
+  /// Return true on success, false if the input is invalid or the computation was cancelled
+  /// (output_RAS is not modified then).
+  static bool GetVisualization3d(vtkPolyData* output_RAS, vtkDMMLTransformDisplayNode* displayNode, vtkDMMLNode* regionNode,
+    vtkCjyxTransformSamplingCancelToken* cancelToken = nullptr);
 
   /// Name of the scalar array that stores the displacement magnitude values
   /// in polydata returned by GetVisualization2d and GetVisualization3d.
@@ -103,8 +118,12 @@ class VTK_CJYX_TRANSFORMS_MODULE_LOGIC_EXPORT vtkCjyxTransformLogic : public vtk
   /// If magnitude is false then a 3-component scalar volume is created, each voxel containing the displacement vector.
   /// referenceVolumeNode specifies the volume origin, spacing, extent, and orientation.
   /// If existingOutputVolumeNode is specified then instead of creating a new volume node, that existing node will be updated.
+  /// The displacement is computed in parallel. If cancelToken is specified and cancel is requested during computation
+  /// then nullptr is returned (a newly created volume node is removed from the scene,
+  /// voxels of existingOutputVolumeNode are only partially updated).
   vtkDMMLVolumeNode* CreateDisplacementVolumeFromTransform(vtkDMMLTransformNode* inputTransformNode, vtkDMMLVolumeNode* referenceVolumeNode = nullptr,
-    bool magnitude = true, vtkDMMLVolumeNode* existingOutputVolumeNode = nullptr);
+    bool magnitude = true, vtkDMMLVolumeNode* existingOutputVolumeNode = nullptr,
+    vtkCjyxTransformSamplingCancelToken* cancelToken = nullptr);
 
   /// Convert the input transform to a grid transform.
   /// If referenceVolumeNode is specified then it will determine the origin, spacing, extent, and orientation of the displacement field.
@@ -117,18 +136,20 @@ class VTK_CJYX_TRANSFORMS_MODULE_LOGIC_EXPORT vtkCjyxTransformLogic : public vtk
   /// The origin and spacing attributes of the output image are ignored (origin, spacing, and axis directions
   /// are all specified by ijkToRAS).
   /// If transformToWorld is true then transform to world is returned, otherwise transform from world is returned.
-  /// Returns true on success.
+  /// Voxels are computed in parallel. If cancelToken is specified then the computation can be cancelled.
+  /// Returns true on success, false if the input is invalid or the computation was cancelled.
   static bool GetTransformedPointSamplesAsMagnitudeImage(vtkImageData* outputMagnitudeImage, vtkDMMLTransformNode* inputTransformNode,
-    vtkMatrix4x4* ijkToRAS, bool transformToWorld = true);
+    vtkMatrix4x4* ijkToRAS, bool transformToWorld = true, vtkCjyxTransformSamplingCancelToken* cancelToken = nullptr);
 
   /// Take samples from the displacement field and store the vector components in an image volume
   /// The extents of the output image must be set before calling this method.
   /// The origin and spacing attributes of the output image are ignored (origin, spacing, and axis directions
   /// are all specified by ijkToRAS).
   /// If transformToWorld is true then transform to world is returned, otherwise transform from world is returned.
-  /// Returns true on success.
+  /// Voxels are computed in parallel. If cancelToken is specified then the computation can be cancelled.
+  /// Returns true on success, false if the input is invalid or the computation was cancelled.
   static bool GetTransformedPointSamplesAsVectorImage(vtkImageData* outputVectorImage, vtkDMMLTransformNode* inputTransformNode,
-    vtkMatrix4x4* ijkToRAS, bool transformToWorld = true);
+    vtkMatrix4x4* ijkToRAS, bool transformToWorld = true, vtkCjyxTransformSamplingCancelToken* cancelToken = nullptr);
 
   /// Return the list of nodes that are transformed by the given node.
   /// If recursive is True, this be recursively called on any transform node
@@ -179,30 +200,39 @@ protected:
 
   /// Generate glyph for 2D transform visualization
   /// If samplePositions_RAS is specified then those samples will be used as glyph starting points instead of a regular grid.
+  /// Returns false if the computation was cancelled.
   /// \sa GetVisualization2d
-  static void GetGlyphVisualization2d(vtkPolyData* output_RAS, vtkDMMLTransformDisplayNode* displayNode, vtkMatrix4x4* sliceToRAS,
-    double* fieldOfViewOrigin, double* fieldOfViewSize, vtkPoints* samplePositions_RAS = nullptr);
+  static bool GetGlyphVisualization2d(vtkPolyData* output_RAS, vtkDMMLTransformDisplayNode* displayNode, vtkMatrix4x4* sliceToRAS,
+    double* fieldOfViewOrigin, double* fieldOfViewSize, vtkPoints* samplePositions_RAS = nullptr,
+    vtkCjyxTransformSamplingCancelToken* cancelToken = nullptr);
   /// Generate glyph for 3D transform visualization
   /// If samplePositions_RAS is specified then those samples will be used as glyph starting points instead of a regular grid.
+  /// Returns false if the computation was cancelled.
   /// \sa GetVisualization3d
-  static void GetGlyphVisualization3d(vtkPolyData* output_RAS, vtkDMMLTransformDisplayNode* displayNode, vtkMatrix4x4* roiToRAS,
-    int* roiSize, vtkPoints* samplePositions_RAS = nullptr);
+  static bool GetGlyphVisualization3d(vtkPolyData* output_RAS, vtkDMMLTransformDisplayNode* displayNode, vtkMatrix4x4* roiToRAS,
+    int* roiSize, vtkPoints* samplePositions_RAS = nullptr, vtkCjyxTransformSamplingCancelToken* cancelToken = nullptr);
 
   /// Generate grid for 2D transform visualization
+  /// Returns false if the computation was cancelled.
   /// \sa GetVisualization2d
-  static void GetGridVisualization2d(vtkPolyData* output_RAS, vtkDMMLTransformDisplayNode* displayNode, vtkMatrix4x4* sliceToRAS,
-    double* fieldOfViewOrigin, double* fieldOfViewSize);
+  static bool GetGridVisualization2d(vtkPolyData* output_RAS, vtkDMMLTransformDisplayNode* displayNode, vtkMatrix4x4* sliceToRAS,
+    double* fieldOfViewOrigin, double* fieldOfViewSize, vtkCjyxTransformSamplingCancelToken* cancelToken = nullptr);
   /// Generate grid for 3D transform visualization
+  /// Returns false if the computation was cancelled.
   /// \sa GetVisualization3d
-  static void GetGridVisualization3d(vtkPolyData* output_RAS, vtkDMMLTransformDisplayNode* displayNode, vtkMatrix4x4* roiToRAS, int* roiSize);
+  static bool GetGridVisualization3d(vtkPolyData* output_RAS, vtkDMMLTransformDisplayNode* displayNode, vtkMatrix4x4* roiToRAS, int* roiSize,
+    vtkCjyxTransformSamplingCancelToken* cancelToken = nullptr);
 
   /// Generate contours for 2D transform visualization
+  /// Returns false if the computation was cancelled.
   /// \sa GetVisualization2d
-  static void GetContourVisualization2d(vtkPolyData* output_RAS, vtkDMMLTransformDisplayNode* displayNode, vtkMatrix4x4* sliceToRAS,
-    double* fieldOfViewOrigin, double* fieldOfViewSize);
+  static bool GetContourVisualization2d(vtkPolyData* output_RAS, vtkDMMLTransformDisplayNode* displayNode, vtkMatrix4x4* sliceToRAS,
+    double* fieldOfViewOrigin, double* fieldOfViewSize, vtkCjyxTransformSamplingCancelToken* cancelToken = nullptr);
   /// Generate contours for 3D transform visualization
+  /// Returns false if the computation was cancelled.
   /// \sa GetVisualization3d
-  static void GetContourVisualization3d(vtkPolyData* output_RAS, vtkDMMLTransformDisplayNode* displayNode, vtkMatrix4x4* roiToRAS, int* roiSize);
+  static bool GetContourVisualization3d(vtkPolyData* output_RAS, vtkDMMLTransformDisplayNode* displayNode, vtkMatrix4x4* roiToRAS, int* roiSize,
+    vtkCjyxTransformSamplingCancelToken* cancelToken = nullptr);
 
   /// Return the number of samples in each grid
   static int GetGridSubdivision(vtkDMMLTransformDisplayNode* displayNode);
@@ -213,31 +243,38 @@ protected:
   /// Takes samples from the displacement field specified by a point set
   /// and stores it in an unstructured grid.
   /// If transformToWorld is true then transform to world is returned, otherwise transform from world is returned.
-  static void GetTransformedPointSamples(vtkPointSet* outputPointSet,
+  /// Samples are computed in parallel. If cancelToken is specified then the computation can be cancelled.
+  /// Returns true on success, false if the input is invalid or the computation was cancelled
+  /// (outputPointSet is not modified then).
+  static bool GetTransformedPointSamples(vtkPointSet* outputPointSet,
     vtkDMMLTransformNode* inputTransformNode, vtkPoints* samplePositions_RAS,
-    bool transformToWorld = true);
+    bool transformToWorld = true, vtkCjyxTransformSamplingCancelToken* cancelToken = nullptr);
 
   /// Takes samples from the displacement field specified by the transformation on a uniform grid
   /// and stores it in an unstructured grid.
   /// gridToRAS specifies the grid origin, direction, and spacing
   /// gridSize is a 3-component int array specifying the dimension of the grid
   /// If transformToWorld is true then transform to world is returned, otherwise transform from world is returned.
-  static void GetTransformedPointSamples(vtkPointSet* outputPointSet_RAS, vtkDMMLTransformNode* inputTransformNode,
-    vtkMatrix4x4* gridToRAS, int* gridSize, bool transformToWorld = true);
+  /// Returns true on success, false if the input is invalid or the computation was cancelled.
+  static bool GetTransformedPointSamples(vtkPointSet* outputPointSet_RAS, vtkDMMLTransformNode* inputTransformNode,
+    vtkMatrix4x4* gridToRAS, int* gridSize, bool transformToWorld = true, vtkCjyxTransformSamplingCancelToken* cancelToken = nullptr);
 
   /// Takes samples from the displacement field specified by the transformation on a slice
   /// and stores it in an unstructured grid.
   /// pointGroupSize: the number of points will be N*pointGroupSize (the actual number will be returned in numGridPoints[3])
   /// samplePositions_RAS: if specified then instead of a regular grid, sample points on the slice will be used
-  static void GetTransformedPointSamplesOnSlice(vtkPointSet* outputPointSet_RAS, vtkDMMLTransformNode* inputTransformNode,
+  /// Returns true on success, false if the input is invalid or the computation was cancelled.
+  static bool GetTransformedPointSamplesOnSlice(vtkPointSet* outputPointSet_RAS, vtkDMMLTransformNode* inputTransformNode,
     vtkMatrix4x4* sliceToRAS, double* fieldOfViewOrigin, double* fieldOfViewSize, double pointSpacing, int pointGroupSize = 1, int* numGridPoints = nullptr,
-    vtkPoints* samplePositions_RAS = nullptr);
+    vtkPoints* samplePositions_RAS = nullptr, vtkCjyxTransformSamplingCancelToken* cancelToken = nullptr);
 
   /// Takes samples from the displacement field specified by the transformation on a 3D ROI
   /// and stores it in an unstructured grid.
   /// pointGroupSize: the number of points will be N*pointGroupSize (the actual number will be returned in numGridPoints[3])
-  static void GetTransformedPointSamplesOnRoi(vtkPointSet* outputPointSet_RAS, vtkDMMLTransformNode* inputTransformNode,
-    vtkMatrix4x4* roiToRAS, int* roiSize, double pointSpacingMm, int pointGroupSize=1, int* numGridPoints=nullptr);
+  /// Returns true on success, false if the input is invalid or the computation was cancelled.
+  static bool GetTransformedPointSamplesOnRoi(vtkPointSet* outputPointSet_RAS, vtkDMMLTransformNode* inputTransformNode,
+    vtkMatrix4x4* roiToRAS, int* roiSize, double pointSpacingMm, int pointGroupSize=1, int* numGridPoints=nullptr,
+    vtkCjyxTransformSamplingCancelToken* cancelToken = nullptr);
 
   /// Get markup points as vtkPoints in RAS coordinate system.
   static void  GetMarkupsAsPoints(vtkDMMLMarkupsNode* markupsNode, vtkPoints* samplePoints_RAS);
@@ -0,0 +1,50 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#include "vtkCjyxTransformSamplingCancelToken.h"
+
+// VTK includes
+#include <vtkObjectFactory.h>
+
+vtkStandardNewMacro(vtkCjyxTransformSamplingCancelToken);
+
+//----------------------------------------------------------------------------
+vtkCjyxTransformSamplingCancelToken::vtkCjyxTransformSamplingCancelToken()
+  : CancelRequested(false)
+{
+}
+
+//----------------------------------------------------------------------------
+vtkCjyxTransformSamplingCancelToken::~vtkCjyxTransformSamplingCancelToken() = default;
+
+//----------------------------------------------------------------------------
+void vtkCjyxTransformSamplingCancelToken::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "CancelRequested: " << (this->GetCancelRequested() ? "true" : "false") << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkCjyxTransformSamplingCancelToken::Cancel()
+{
+  // Modified() is not called, as this method may be called from any thread
+  this->CancelRequested = true;
+}
+
+//----------------------------------------------------------------------------
+void vtkCjyxTransformSamplingCancelToken::Reset()
+{
+  this->CancelRequested = false;
+}
+
+//----------------------------------------------------------------------------
+bool vtkCjyxTransformSamplingCancelToken::GetCancelRequested() const
+{
+  return this->CancelRequested;
+}
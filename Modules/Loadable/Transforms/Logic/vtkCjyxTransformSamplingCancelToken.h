@@ -0,0 +1,55 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#ifndef __vtkCjyxTransformSamplingCancelToken_h
+#define __vtkCjyxTransformSamplingCancelToken_h
+
+#include "vtkCjyxTransformsModuleLogicExport.h"
+
+// VTK includes
+#include <vtkObject.h>
+
+// STD includes
+#include <atomic>
+
+/// \brief Allows cancelling transform sampling that is in progress.
+///
+/// Sampling and visualization methods of vtkCjyxTransformLogic evaluate the transform in
+/// blocks of points (in parallel) and check the token before processing each block.
+/// Sampling methods block the calling thread and do not invoke events, therefore Cancel()
+/// must be called from another thread while sampling is in progress.
+/// \sa vtkCjyxTransformLogic
+class VTK_CJYX_TRANSFORMS_MODULE_LOGIC_EXPORT vtkCjyxTransformSamplingCancelToken : public vtkObject
+{
+public:
+  static vtkCjyxTransformSamplingCancelToken *New();
+  vtkTypeMacro(vtkCjyxTransformSamplingCancelToken, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Request cancellation. Sampling stops after the blocks that are currently processed.
+  void Cancel();
+
+  /// Clear the cancel request so that the token can be used again.
+  void Reset();
+
+  /// Returns true if cancellation has been requested.
+  bool GetCancelRequested() const;
+
+protected:
+  vtkCjyxTransformSamplingCancelToken();
+  ~vtkCjyxTransformSamplingCancelToken() override;
+
+  std::atomic<bool> CancelRequested;
+
+private:
+  vtkCjyxTransformSamplingCancelToken(const vtkCjyxTransformSamplingCancelToken&) = delete;
+  void operator=(const vtkCjyxTransformSamplingCancelToken&) = delete;
+};
+
+#endif